@@ -469,11 +469,7 @@ byte *MidiParser_QT::readWholeTrack(Common::QuickTimeParser::Track *track, uint3
 	for (uint i = 0; i < track->chunkCount; i++) {
 		_fd->seek(track->chunkOffsets[i]);
 
-		uint32 sampleCount = 0;
-
-		for (uint32 j = 0; j < track->sampleToChunkCount; j++)
-			if (i >= track->sampleToChunk[j].first)
-				sampleCount = track->sampleToChunk[j].count;
+		uint32 sampleCount = track->getChunkSampleCount(i);
 
 		for (uint32 j = 0; j < sampleCount; j++, curSample++) {
 			uint32 size = (track->sampleSize != 0) ? track->sampleSize : track->sampleSizes[curSample];
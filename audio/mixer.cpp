@@ -22,6 +22,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/atomic.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -33,6 +34,18 @@
 
 namespace Audio {
 
+// Whether the current thread is running MixerImpl::mixCallback()
+#if __cplusplus >= 201103L
+static thread_local bool s_inMixCallback = false;
+#elif defined(__GNUC__)
+static __thread bool s_inMixCallback = false;
+#elif defined(_MSC_VER)
+static __declspec(thread) bool s_inMixCallback = false;
+#else
+// Platforms without thread local storage mix on the only thread there is
+static bool s_inMixCallback = false;
+#endif
+
 #pragma mark -
 #pragma mark --- Channel classes ---
 #pragma mark -
@@ -85,7 +98,7 @@ public:
 	/**
 	 * Queries whether the channel is currently paused.
 	 */
-	bool isPaused() const { return (_pauseLevel != 0); }
+	bool isPaused() const { return (Common::atomicLoad(&_pauseLevel) != 0); }
 
 	/**
 	 * Sets the channel's own volume.
@@ -116,10 +129,12 @@ public:
 	int8 getBalance();
 
 	/**
-	 * Notifies the channel that the global sound type
-	 * volume settings changed.
+	 * Sets the volume of the channel's sound type, which is 0
+	 * while the sound type is muted.
+	 *
+	 * @param volume new sound type volume
 	 */
-	void notifyGlobalVolChange() { updateChannelVolumes(); }
+	void setSoundTypeVolume(int volume);
 
 	/**
 	 * Queries how long the channel has been playing.
@@ -152,12 +167,14 @@ private:
 
 	byte _volume;
 	int8 _balance;
+	int _soundTypeVolume;
 
 	void updateChannelVolumes();
 	st_volume_t _volL, _volR;
 
 	Mixer *_mixer;
 
+	// Written by the audio thread, read by getElapsedTime()
 	uint32 _samplesConsumed;
 	uint32 _samplesDecoded;
 	uint32 _mixerTimeStamp;
@@ -173,7 +190,8 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _commandSerial(0), _retiredChannels(MAX_LIVE_CHANNELS), _liveChannels(0), _commandsProcessed(0), _mixSerial(0) {
 
 	assert(sampleRate > 0);
 
@@ -182,24 +200,101 @@ MixerImpl::MixerImpl(uint sampleRate)
 }
 
 MixerImpl::~MixerImpl() {
+	// The audio thread is gone by now, so we can take over its part
+	processCommands();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+
+	Channel *chan;
+	while (_retiredChannels.pop(chan))
+		delete chan;
 }
 
-void MixerImpl::setReady(bool ready) {
-	Common::StackLock lock(_mutex);
+bool MixerImpl::isReady() const {
+	return Common::atomicLoad(&_mixerReady);
+}
 
-	_mixerReady = ready;
+void MixerImpl::setReady(bool ready) {
+	Common::atomicStore(&_mixerReady, ready);
 }
 
 uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
 
-void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
+int MixerImpl::effectiveSoundTypeVolume(SoundType type) const {
+	return _soundTypeSettings[type].mute ? 0 : _soundTypeSettings[type].volume;
+}
+
+void MixerImpl::queueCommand(Command::Type type, const SoundHandle &handle, int value, Channel *chan) {
+	Command cmd;
+	cmd.type = type;
+	cmd.serial = ++_commandSerial;
+	cmd.chan = chan;
+	cmd.handle = handle;
+	cmd.soundType = kPlainSoundType;
+	cmd.value = value;
+	_commands.push(cmd);
+}
+
+void MixerImpl::queueSoundTypeVolume(SoundType type) {
+	Command cmd;
+	cmd.type = Command::kSetSoundTypeVolume;
+	cmd.serial = ++_commandSerial;
+	cmd.chan = nullptr;
+	cmd.soundType = type;
+	cmd.value = effectiveSoundTypeVolume(type);
+	_commands.push(cmd);
+}
+
+void MixerImpl::stopChannel(int index, bool &needsSync) {
+	ChannelSlot &slot = _slots[index];
+	assert(slot.chan);
+
+	queueCommand(Command::kStopChannel, slot.handle);
+
+	// The audio thread hands the channel back once it processed the command
+	if (!slot.ownsStream)
+		needsSync = true;
+	slot.chan = nullptr;
+}
+
+void MixerImpl::waitForMixCallback() {
+	// Callers may delete streams they own right after stopping them, so we
+	// have to make sure the audio thread does not touch them anymore. Stop
+	// commands are processed before anything gets mixed, so we only need to
+	// wait for a callback which is currently running.
+	const uint32 serial = Common::atomicLoad(&_mixSerial);
+	if (!(serial & 1))
+		return;
+
+	// We may get called from inside the callback, e.g. by a stream's
+	// readBuffer(). The callback can not finish then, so it is up to such
+	// streams not to delete what is still being mixed.
+	if (s_inMixCallback)
+		return;
+
+	while (Common::atomicLoad(&_mixSerial) == serial &&
+	       (int32)(Common::atomicLoad(&_commandsProcessed) - _commandSerial) < 0)
+		g_system->delayMillis(1);
+}
+
+void MixerImpl::collectRetiredChannels() {
+	Channel *chan;
+	while (_retiredChannels.pop(chan)) {
+		ChannelSlot &slot = _slots[chan->getHandle()._val % NUM_CHANNELS];
+		if (slot.chan == chan)
+			slot.chan = nullptr;
+		delete chan;
+		_liveChannels--;
+	}
+}
+
+bool MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == 0) {
+		if (_slots[i].chan == 0) {
 			index = i;
 			break;
 		}
@@ -207,10 +302,16 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	if (index == -1) {
 		warning("MixerImpl::out of mixer slots");
 		delete chan;
-		return;
+		return false;
 	}
 
-	_channels[index] = chan;
+	// Stopped channels which the audio thread did not retire yet still count
+	if (_liveChannels >= MAX_LIVE_CHANNELS) {
+		warning("MixerImpl::too many stopped channels waiting to be retired");
+		delete chan;
+		return false;
+	}
+	_liveChannels++;
 
 	SoundHandle chanHandle;
 	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
@@ -219,6 +320,13 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	_slots[index].chan = chan;
+	_slots[index].handle = chanHandle;
+
+	// Hand the channel over to the audio thread
+	queueCommand(Command::kAddChannel, chanHandle, 0, chan);
+	return true;
 }
 
 void MixerImpl::playStream(
@@ -237,12 +345,14 @@ void MixerImpl::playStream(
 	}
 
 
-	assert(_mixerReady);
+	assert(isReady());
+
+	collectRetiredChannels();
 
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != 0 && _channels[i]->getId() == id) {
+			if (_slots[i].chan != 0 && _slots[i].id == id) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
@@ -261,15 +371,94 @@ void MixerImpl::playStream(
 
 	// Create the channel
 	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	chan->setSoundTypeVolume(effectiveSoundTypeVolume(type));
 	chan->setVolume(volume);
 	chan->setBalance(balance);
-	insertChannel(handle, chan);
+
+	SoundHandle chanHandle;
+	if (!insertChannel(&chanHandle, chan))
+		return;
+
+	// Remember what the engine side queries need to know
+	ChannelSlot &slot = _slots[chanHandle._val % NUM_CHANNELS];
+	slot.id = id;
+	slot.type = type;
+	slot.permanent = permanent;
+	slot.ownsStream = (autofreeStream == DisposeAfterUse::YES);
+	slot.volume = volume;
+	slot.balance = balance;
+
+	if (handle)
+		*handle = chanHandle;
+}
+
+void MixerImpl::processCommands() {
+	Command cmd;
+	uint32 lastSerial = 0;
+	bool processed = false;
+
+	while (_commands.pop(cmd)) {
+		processed = true;
+		lastSerial = cmd.serial;
+
+		if (cmd.type == Command::kSetSoundTypeVolume) {
+			for (int i = 0; i != NUM_CHANNELS; ++i) {
+				if (_channels[i] && _channels[i]->getType() == cmd.soundType)
+					_channels[i]->setSoundTypeVolume(cmd.value);
+			}
+			continue;
+		}
+
+		const int index = cmd.handle._val % NUM_CHANNELS;
+
+		if (cmd.type == Command::kAddChannel) {
+			assert(!_channels[index]);
+			_channels[index] = cmd.chan;
+			continue;
+		}
+
+		// Simply ignore requests for channels which already finished
+		Channel *chan = _channels[index];
+		if (!chan || chan->getHandle()._val != cmd.handle._val)
+			continue;
+
+		switch (cmd.type) {
+		case Command::kStopChannel:
+			retireChannel(index);
+			break;
+		case Command::kPauseChannel:
+			chan->pause(cmd.value != 0);
+			break;
+		case Command::kSetChannelVolume:
+			chan->setVolume(cmd.value);
+			break;
+		case Command::kSetChannelBalance:
+			chan->setBalance(cmd.value);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (processed)
+		Common::atomicStore(&_commandsProcessed, lastSerial);
+}
+
+void MixerImpl::retireChannel(int index) {
+	_retiredChannels.push(_channels[index]);
+	_channels[index] = 0;
 }
 
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
+	const bool wasInMixCallback = s_inMixCallback;
+	s_inMixCallback = true;
+
+	const uint32 serial = _mixSerial;
+	Common::atomicStore(&_mixSerial, serial + 1);
+
+	processCommands();
 
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
@@ -277,7 +466,7 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	len >>= 2;
 
 	// Since the mixer callback has been called, the mixer must be ready...
-	_mixerReady = true;
+	Common::atomicStore(&_mixerReady, true);
 
 	//  zero the buf
 	memset(buf, 0, 2 * len * sizeof(int16));
@@ -287,8 +476,7 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = 0;
+				retireChannel(i);
 			} else if (!_channels[i]->isPaused()) {
 				tmp = _channels[i]->mix(buf, len);
 
@@ -297,27 +485,36 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 			}
 		}
 
+	Common::atomicStore(&_mixSerial, serial + 2);
+	s_inMixCallback = wasInMixCallback;
+
 	return res;
 }
 
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
+	bool needsSync = false;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+		if (_slots[i].chan != 0 && !_slots[i].permanent)
+			stopChannel(i, needsSync);
 	}
+
+	if (needsSync)
+		waitForMixCallback();
+	collectRetiredChannels();
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
+	bool needsSync = false;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+		if (_slots[i].chan != 0 && _slots[i].id == id)
+			stopChannel(i, needsSync);
 	}
+
+	if (needsSync)
+		waitForMixCallback();
+	collectRetiredChannels();
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
@@ -325,21 +522,24 @@ void MixerImpl::stopHandle(SoundHandle handle) {
 
 	// Simply ignore stop requests for handles of sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!_slots[index].chan || _slots[index].handle._val != handle._val)
 		return;
 
-	delete _channels[index];
-	_channels[index] = 0;
+	bool needsSync = false;
+	stopChannel(index, needsSync);
+
+	if (needsSync)
+		waitForMixCallback();
+	collectRetiredChannels();
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
+
+	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	queueSoundTypeVolume(type);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
@@ -351,36 +551,42 @@ void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 	Common::StackLock lock(_mutex);
 
 	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!_slots[index].chan || _slots[index].handle._val != handle._val)
 		return;
 
-	_channels[index]->setVolume(volume);
+	_slots[index].volume = volume;
+	queueCommand(Command::kSetChannelVolume, handle, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
+	Common::StackLock lock(_mutex);
+
 	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!_slots[index].chan || _slots[index].handle._val != handle._val)
 		return 0;
 
-	return _channels[index]->getVolume();
+	return _slots[index].volume;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 	Common::StackLock lock(_mutex);
 
 	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!_slots[index].chan || _slots[index].handle._val != handle._val)
 		return;
 
-	_channels[index]->setBalance(balance);
+	_slots[index].balance = balance;
+	queueCommand(Command::kSetChannelBalance, handle, balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
+	Common::StackLock lock(_mutex);
+
 	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!_slots[index].chan || _slots[index].handle._val != handle._val)
 		return 0;
 
-	return _channels[index]->getBalance();
+	return _slots[index].balance;
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -390,18 +596,21 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
+	collectRetiredChannels();
+
 	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!_slots[index].chan || _slots[index].handle._val != handle._val)
 		return Timestamp(0, _sampleRate);
 
-	return _channels[index]->getElapsedTime();
+	// Safe, the channel is only deleted after the audio thread retired it
+	return _slots[index].chan->getElapsedTime();
 }
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0) {
-			_channels[i]->pause(paused);
+		if (_slots[i].chan != 0) {
+			queueCommand(Command::kPauseChannel, _slots[i].handle, paused);
 		}
 	}
 }
@@ -409,8 +618,8 @@ void MixerImpl::pauseAll(bool paused) {
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
+		if (_slots[i].chan != 0 && _slots[i].id == id) {
+			queueCommand(Command::kPauseChannel, _slots[i].handle, paused);
 			return;
 		}
 	}
@@ -421,10 +630,10 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 
 	// Simply ignore (un)pause requests for sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!_slots[index].chan || _slots[index].handle._val != handle._val)
 		return;
 
-	_channels[index]->pause(paused);
+	queueCommand(Command::kPauseChannel, handle, paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
@@ -434,17 +643,20 @@ bool MixerImpl::isSoundIDActive(int id) {
 	g_eventRec.updateSubsystems();
 #endif
 
+	collectRetiredChannels();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (_slots[i].chan && _slots[i].id == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	collectRetiredChannels();
 	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	if (_slots[index].chan && _slots[index].handle._val == handle._val)
+		return _slots[index].id;
 	return 0;
 }
 
@@ -455,14 +667,17 @@ bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	g_eventRec.updateSubsystems();
 #endif
 
+	collectRetiredChannels();
+
 	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return _slots[index].chan && _slots[index].handle._val == handle._val;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
+	collectRetiredChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (_slots[i].chan && _slots[i].type == type)
 			return true;
 	return false;
 }
@@ -479,10 +694,7 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].volume = volume;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	queueSoundTypeVolume(type);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
@@ -499,7 +711,7 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
                  DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-      _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
+      _balance(0), _soundTypeVolume(Mixer::kMaxMixerVolume), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
       _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
       _stream(stream, autofreeStream) {
 	assert(mixer);
@@ -531,6 +743,11 @@ int8 Channel::getBalance() {
 	return _balance;
 }
 
+void Channel::setSoundTypeVolume(int volume) {
+	_soundTypeVolume = volume;
+	updateChannelVolumes();
+}
+
 void Channel::updateChannelVolumes() {
 	// From the channel balance/volume and the global volume, we compute
 	// the effective volume for the left and right channel. Note the
@@ -540,21 +757,17 @@ void Channel::updateChannelVolumes() {
 	// volume is in the range 0 - kMaxMixerVolume.
 	// Hence, the vol_l/vol_r values will be in that range, too
 
-	if (!_mixer->isSoundTypeMuted(_type)) {
-		int vol = _mixer->getVolumeForSoundType(_type) * _volume;
-
-		if (_balance == 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = vol / Mixer::kMaxChannelVolume;
-		} else if (_balance < 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = ((127 + _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
-		} else {
-			_volL = ((127 - _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
-			_volR = vol / Mixer::kMaxChannelVolume;
-		}
+	int vol = _soundTypeVolume * _volume;
+
+	if (_balance == 0) {
+		_volL = vol / Mixer::kMaxChannelVolume;
+		_volR = vol / Mixer::kMaxChannelVolume;
+	} else if (_balance < 0) {
+		_volL = vol / Mixer::kMaxChannelVolume;
+		_volR = ((127 + _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
 	} else {
-		_volL = _volR = 0;
+		_volL = ((127 - _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
+		_volR = vol / Mixer::kMaxChannelVolume;
 	}
 }
 
@@ -562,16 +775,16 @@ void Channel::pause(bool paused) {
 	//assert((paused && _pauseLevel >= 0) || (!paused && _pauseLevel));
 
 	if (paused) {
-		_pauseLevel++;
+		if (_pauseLevel == 0)
+			Common::atomicStore(&_pauseStartTime, g_system->getMillis(true));
 
-		if (_pauseLevel == 1)
-			_pauseStartTime = g_system->getMillis(true);
+		Common::atomicStore(&_pauseLevel, _pauseLevel + 1);
 	} else if (_pauseLevel > 0) {
-		_pauseLevel--;
+		Common::atomicStore(&_pauseLevel, _pauseLevel - 1);
 
 		if (!_pauseLevel) {
-			_pauseTime = (g_system->getMillis(true) - _pauseStartTime);
-			_pauseStartTime = 0;
+			Common::atomicStore(&_pauseTime, g_system->getMillis(true) - _pauseStartTime);
+			Common::atomicStore(&_pauseStartTime, (uint32)0);
 		}
 	}
 }
@@ -582,17 +795,18 @@ Timestamp Channel::getElapsedTime() {
 
 	Audio::Timestamp ts(0, rate);
 
-	if (_mixerTimeStamp == 0)
+	const uint32 mixerTimeStamp = Common::atomicLoad(&_mixerTimeStamp);
+	if (mixerTimeStamp == 0)
 		return ts;
 
 	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
+		delta = Common::atomicLoad(&_pauseStartTime) - mixerTimeStamp;
 	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
+		delta = g_system->getMillis(true) - mixerTimeStamp - Common::atomicLoad(&_pauseTime);
 
 	// Convert the number of samples into a time duration.
 
-	ts = ts.addFrames(_samplesConsumed);
+	ts = ts.addFrames(Common::atomicLoad(&_samplesConsumed));
 	ts = ts.addMsecs(delta);
 
 	// In theory it would seem like a good idea to limit the approximation
@@ -612,9 +826,9 @@ int Channel::mix(int16 *data, uint len) {
 		// TODO: call drain method
 	} else {
 		assert(_converter);
-		_samplesConsumed = _samplesDecoded;
-		_mixerTimeStamp = g_system->getMillis(true);
-		_pauseTime = 0;
+		Common::atomicStore(&_samplesConsumed, _samplesDecoded);
+		Common::atomicStore(&_mixerTimeStamp, g_system->getMillis(true));
+		Common::atomicStore(&_pauseTime, (uint32)0);
 		res = _converter->flow(*_stream, data, len, _volL, _volR);
 		_samplesDecoded += res;
 	}
@@ -24,6 +24,7 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/lockfree-queue.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
 
@@ -54,14 +55,27 @@ namespace Audio {
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
  *
+ * mixCallback() never takes a lock. Engine calls only update an engine side
+ * view of the channels and pass the actual changes as commands to the audio
+ * thread through a lock-free queue, which is drained at the start of every
+ * callback. Channels which finished playing or got stopped travel back the
+ * same way and are deleted on the engine side.
+ *
  * @see OSystem::getMixer()
  */
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32
+		NUM_CHANNELS = 32,
+		/**
+		 * Channels which may exist at once, including stopped ones the
+		 * engine side did not delete yet. The audio thread can retire
+		 * all of them without allocating memory.
+		 */
+		MAX_LIVE_CHANNELS = 2 * NUM_CHANNELS
 	};
 
+	/** Serializes the engine side calls, never taken by mixCallback(). */
 	Common::Mutex _mutex;
 
 	const uint _sampleRate;
@@ -76,15 +90,74 @@ private:
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
+
+	/** Engine side state of a channel slot. */
+	struct ChannelSlot {
+		ChannelSlot() : chan(nullptr), id(-1), type(kPlainSoundType), permanent(false), ownsStream(true), volume(kMaxChannelVolume), balance(0) {}
+
+		/** The channel, which is only deleted after the audio thread retired it. */
+		Channel *chan;
+		SoundHandle handle;
+		int id;
+		SoundType type;
+		bool permanent;
+		bool ownsStream;
+		byte volume;
+		int8 balance;
+	};
+
+	ChannelSlot _slots[NUM_CHANNELS];
+
+	struct Command {
+		enum Type {
+			kAddChannel,
+			kStopChannel,
+			kPauseChannel,
+			kSetChannelVolume,
+			kSetChannelBalance,
+			kSetSoundTypeVolume
+		};
+
+		Type type;
+		uint32 serial;
+		Channel *chan;
+		SoundHandle handle;
+		SoundType soundType;
+		int value;
+	};
+
+	/** Commands from the engine side, producers are serialized by _mutex. */
+	Common::LockFreeQueue<Command> _commands;
+	uint32 _commandSerial;
+
+	/** Finished or stopped channels handed back from the audio thread. */
+	Common::LockFreeQueue<Channel *> _retiredChannels;
+	/** Channels created and not deleted yet, at most MAX_LIVE_CHANNELS. */
+	uint _liveChannels;
+
+	// State owned by the audio thread
 	Channel *_channels[NUM_CHANNELS];
+	uint32 _commandsProcessed;
+	/** Incremented at the start and the end of each mixCallback(). */
+	uint32 _mixSerial;
+
+	int effectiveSoundTypeVolume(SoundType type) const;
+
+	void queueCommand(Command::Type type, const SoundHandle &handle, int value = 0, Channel *chan = nullptr);
+	void queueSoundTypeVolume(SoundType type);
+	void stopChannel(int index, bool &needsSync);
+	void waitForMixCallback();
+	void collectRetiredChannels();
 
+	void processCommands();
+	void retireChannel(int index);
 
 public:
 
 	MixerImpl(uint sampleRate);
 	~MixerImpl();
 
-	virtual bool isReady() const { Common::StackLock lock(_mutex); return _mixerReady; }
+	virtual bool isReady() const;
 
 	virtual void playStream(
 		SoundType type,
@@ -127,7 +200,7 @@ public:
 	virtual uint getOutputRate() const;
 
 protected:
-	void insertChannel(SoundHandle *handle, Channel *chan);
+	bool insertChannel(SoundHandle *handle, Channel *chan);
 
 public:
 	/**
@@ -98,6 +98,23 @@ endif
 ifndef USE_ARM_SOUND_ASM
 MODULE_OBJS += \
 	rate.o
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	rate_sse2.o
+$(MODULE)/rate_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	rate_avx2.o
+$(MODULE)/rate_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	rate_neon.o
+endif
 else
 MODULE_OBJS += \
 	rate_arm.o \
@@ -30,7 +30,9 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/mixer.h"
+#include "common/cpudetect.h"
 #include "common/frac.h"
 #include "common/textconsole.h"
 #include "common/util.h"
@@ -57,6 +59,87 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+void rateMixStereo(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1) {
+	for (; frames > 0; --frames) {
+		rateMixSample(obuf[0], ibuf[0], vol0);
+		rateMixSample(obuf[1], ibuf[1], vol1);
+		ibuf += 2;
+		obuf += 2;
+	}
+}
+
+void rateMixMono(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1) {
+	for (; frames > 0; --frames) {
+		rateMixSample(obuf[0], *ibuf, vol0);
+		rateMixSample(obuf[1], *ibuf, vol1);
+		ibuf++;
+		obuf += 2;
+	}
+}
+
+RateMixProcs getGenericRateMixProcs() {
+	RateMixProcs procs;
+	procs.stereo = rateMixStereo;
+	procs.mono = rateMixMono;
+	return procs;
+}
+
+RateMixProcs getRateMixProcs() {
+	RateMixProcs procs = getGenericRateMixProcs();
+
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#ifdef SCUMMVM_AVX2
+	if (Common::hasCpuFeature(Common::kCpuFeatureAVX2)) {
+		procs.stereo = rateMixStereoAVX2;
+		procs.mono = rateMixMonoAVX2;
+		return procs;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (Common::hasCpuFeature(Common::kCpuFeatureSSE2)) {
+		procs.stereo = rateMixStereoSSE2;
+		procs.mono = rateMixMonoSSE2;
+		return procs;
+	}
+#endif
+#ifdef SCUMMVM_NEON
+	if (Common::hasCpuFeature(Common::kCpuFeatureNEON)) {
+		procs.stereo = rateMixStereoNEON;
+		procs.mono = rateMixMonoNEON;
+		return procs;
+	}
+#endif
+#endif
+
+	return procs;
+}
+
+/**
+ * Common base of the rate converters: holds the mix procs selected for
+ * the host CPU and applies the channel order and volumes to them.
+ */
+template<bool reverseStereo>
+class MixingRateConverter : public RateConverter {
+protected:
+	RateMixProcs _mixProcs;
+	RateMixProcs _genericMixProcs;
+
+	MixingRateConverter() : _mixProcs(getRateMixProcs()), _genericMixProcs(getGenericRateMixProcs()) {}
+
+	/**
+	 * Mix samples into obuf. For stereo input the frames must already
+	 * be in output channel order, i.e. swapped for reverseStereo.
+	 */
+	void mix(bool stereoInput, st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+		const st_volume_t vol0 = reverseStereo ? vol_r : vol_l;
+		const st_volume_t vol1 = reverseStereo ? vol_l : vol_r;
+		const bool simd = (vol0 <= Audio::Mixer::kMaxMixerVolume && vol1 <= Audio::Mixer::kMaxMixerVolume);
+		const RateMixProcs &procs = simd ? _mixProcs : _genericMixProcs;
+
+		(stereoInput ? procs.stereo : procs.mono)(obuf, ibuf, frames, vol0, vol1);
+	}
+};
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -64,9 +147,11 @@ enum {
  * Limited to sampling frequency <= 65535 Hz.
  */
 template<bool stereo, bool reverseStereo>
-class SimpleRateConverter : public RateConverter {
+class SimpleRateConverter : public MixingRateConverter<reverseStereo> {
 protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+	/** resampled stereo frames waiting to be mixed into the output */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
 	int inLen;
 
@@ -114,42 +199,53 @@ SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate
 template<bool stereo, bool reverseStereo>
 int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 	st_sample_t *ostart, *oend;
+	bool endOfInput = false;
 
 	ostart = obuf;
 	oend = obuf + osamp * 2;
 
-	while (obuf < oend) {
-
-		// read enough input samples so that opos >= 0
-		do {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
-			}
-			inLen -= (stereo ? 2 : 1);
-			opos--;
-			if (opos >= 0) {
-				inPtr += (stereo ? 2 : 1);
-			}
-		} while (opos >= 0);
-
-		st_sample_t out0, out1;
-		out0 = *inPtr++;
-		out1 = (stereo ? *inPtr++ : out0);
+	while (obuf < oend && !endOfInput) {
+		st_sample_t *out = outBuf;
+		st_sample_t *outEnd = outBuf + MIN<st_size_t>(oend - obuf, ARRAYSIZE(outBuf));
+
+		while (out < outEnd) {
+
+			// read enough input samples so that opos >= 0
+			do {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				opos--;
+				if (opos >= 0) {
+					inPtr += (stereo ? 2 : 1);
+				}
+			} while (opos >= 0);
+
+			if (endOfInput)
+				break;
 
-		// Increment output position
-		opos += opos_inc;
+			st_sample_t out0, out1;
+			out0 = *inPtr++;
+			out1 = (stereo ? *inPtr++ : out0);
 
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+			// Increment output position
+			opos += opos_inc;
 
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+			out[reverseStereo    ] = out0;
+			out[reverseStereo ^ 1] = out1;
+			out += 2;
+		}
 
-		obuf += 2;
+		// Mix the resampled frames into the output buffer
+		this->mix(true, obuf, outBuf, (out - outBuf) / 2, vol_l, vol_r);
+		obuf += out - outBuf;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -166,9 +262,11 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
  */
 
 template<bool stereo, bool reverseStereo>
-class LinearRateConverter : public RateConverter {
+class LinearRateConverter : public MixingRateConverter<reverseStereo> {
 protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+	/** interpolated stereo frames waiting to be mixed into the output */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
 	int inLen;
 
@@ -223,52 +321,63 @@ LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate
 template<bool stereo, bool reverseStereo>
 int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 	st_sample_t *ostart, *oend;
+	bool endOfInput = false;
 
 	ostart = obuf;
 	oend = obuf + osamp * 2;
 
-	while (obuf < oend) {
-
-		// read enough input samples so that opos < 0
-		while ((frac_t)FRAC_ONE_LOW <= opos) {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+	while (obuf < oend && !endOfInput) {
+		st_sample_t *out = outBuf;
+		st_sample_t *outEnd = outBuf + MIN<st_size_t>(oend - obuf, ARRAYSIZE(outBuf));
+
+		while (out < outEnd) {
+
+			// read enough input samples so that opos < 0
+			while ((frac_t)FRAC_ONE_LOW <= opos) {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				ilast0 = icur0;
+				icur0 = *inPtr++;
+				if (stereo) {
+					ilast1 = icur1;
+					icur1 = *inPtr++;
+				}
+				opos -= FRAC_ONE_LOW;
 			}
-			inLen -= (stereo ? 2 : 1);
-			ilast0 = icur0;
-			icur0 = *inPtr++;
-			if (stereo) {
-				ilast1 = icur1;
-				icur1 = *inPtr++;
+
+			if (endOfInput)
+				break;
+
+			// Loop as long as the outpos trails behind, and as long as there is
+			// still space in the output buffer.
+			while (opos < (frac_t)FRAC_ONE_LOW && out < outEnd) {
+				// interpolate
+				st_sample_t out0, out1;
+				out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+				out1 = (stereo ?
+							  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
+							  out0);
+
+				out[reverseStereo    ] = out0;
+				out[reverseStereo ^ 1] = out1;
+				out += 2;
+
+				// Increment output position
+				opos += opos_inc;
 			}
-			opos -= FRAC_ONE_LOW;
 		}
 
-		// Loop as long as the outpos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (opos < (frac_t)FRAC_ONE_LOW && obuf < oend) {
-			// interpolate
-			st_sample_t out0, out1;
-			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			out1 = (stereo ?
-						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						  out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
-
-			// Increment output position
-			opos += opos_inc;
-		}
+		// Mix the interpolated frames into the output buffer
+		this->mix(true, obuf, outBuf, (out - outBuf) / 2, vol_l, vol_r);
+		obuf += out - outBuf;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -281,7 +390,7 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
  * Simple audio rate converter for the case that the inrate equals the outrate.
  */
 template<bool stereo, bool reverseStereo>
-class CopyRateConverter : public RateConverter {
+class CopyRateConverter : public MixingRateConverter<reverseStereo> {
 	st_sample_t *_buffer;
 	st_size_t _bufferSize;
 public:
@@ -314,21 +423,18 @@ public:
 		// Read up to 'osamp' samples into our temporary buffer
 		len = input.readBuffer(_buffer, osamp);
 
-		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		// Swap the channels in place, the mix procs expect output order
+		if (stereo && reverseStereo) {
+			ptr = _buffer;
+			for (st_size_t i = 0; i + 1 < len; i += 2, ptr += 2)
+				SWAP(ptr[0], ptr[1]);
+		}
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		// Mix the data into the output buffer
+		const st_size_t frames = (stereo ? len / 2 : len);
+		this->mix(stereo, obuf, _buffer, frames, vol_l, vol_r);
+		obuf += frames * 2;
 
-			obuf += 2;
-		}
 		return (obuf - ostart) / 2;
 	}
 
@@ -0,0 +1,94 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/rate_intern.h"
+
+#include <immintrin.h>
+
+namespace Audio {
+
+/**
+ * Compute (x * vol) / 256 for the 32 bit lanes of a madd result, rounding
+ * towards zero like the C division in rateMixSample().
+ */
+static inline __m256i divideByMaxVolume(__m256i x) {
+	const __m256i bias = _mm256_and_si256(_mm256_srai_epi32(x, 31), _mm256_set1_epi32(255));
+	return _mm256_srai_epi32(_mm256_add_epi32(x, bias), 8);
+}
+
+/**
+ * Scale 8 interleaved stereo frames and add them to obuf with saturation.
+ * The unpack and pack instructions work within each 128 bit lane, so the
+ * sample order is preserved.
+ */
+static inline void mixFrames8(st_sample_t *obuf, __m256i in, __m256i vol) {
+	const __m256i zero = _mm256_setzero_si256();
+
+	const __m256i lo = divideByMaxVolume(_mm256_madd_epi16(_mm256_unpacklo_epi16(in, zero), vol));
+	const __m256i hi = divideByMaxVolume(_mm256_madd_epi16(_mm256_unpackhi_epi16(in, zero), vol));
+
+	const __m256i out = _mm256_loadu_si256((const __m256i *)obuf);
+	_mm256_storeu_si256((__m256i *)obuf, _mm256_adds_epi16(out, _mm256_packs_epi32(lo, hi)));
+}
+
+static inline __m256i makeVolume(st_volume_t vol0, st_volume_t vol1) {
+	return _mm256_set_epi16(0, vol1, 0, vol0, 0, vol1, 0, vol0, 0, vol1, 0, vol0, 0, vol1, 0, vol0);
+}
+
+void rateMixStereoAVX2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1) {
+	const __m256i vol = makeVolume(vol0, vol1);
+
+	for (; frames >= 8; frames -= 8) {
+		mixFrames8(obuf, _mm256_loadu_si256((const __m256i *)ibuf), vol);
+		ibuf += 16;
+		obuf += 16;
+	}
+
+	for (; frames > 0; --frames) {
+		rateMixSample(obuf[0], ibuf[0], vol0);
+		rateMixSample(obuf[1], ibuf[1], vol1);
+		ibuf += 2;
+		obuf += 2;
+	}
+}
+
+void rateMixMonoAVX2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1) {
+	const __m256i vol = makeVolume(vol0, vol1);
+
+	for (; frames >= 8; frames -= 8) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)ibuf);
+		const __m128i lo = _mm_unpacklo_epi16(in, in);
+		const __m128i hi = _mm_unpackhi_epi16(in, in);
+		mixFrames8(obuf, _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), vol);
+		ibuf += 8;
+		obuf += 16;
+	}
+
+	for (; frames > 0; --frames) {
+		rateMixSample(obuf[0], *ibuf, vol0);
+		rateMixSample(obuf[1], *ibuf, vol1);
+		ibuf++;
+		obuf += 2;
+	}
+}
+
+} // End of namespace Audio
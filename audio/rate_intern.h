@@ -0,0 +1,86 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * Accumulate a block of samples into the interleaved stereo output
+ * buffer of the mixer, scaling them by the given volumes. vol0 is applied
+ * to the first sample of each output pair and vol1 to the second one.
+ *
+ * Stereo procs expect interleaved input frames which are already in output
+ * channel order, mono procs duplicate each input sample into both output
+ * channels. The result is identical to calling clampedAdd() on each output
+ * sample with (sample * vol) / Mixer::kMaxMixerVolume.
+ */
+typedef void (*RateMixProc)(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1);
+
+struct RateMixProcs {
+	RateMixProc stereo;
+	RateMixProc mono;
+};
+
+/** Mix a single output sample, the reference for all RateMixProcs. */
+static inline void rateMixSample(st_sample_t &out, st_sample_t in, st_volume_t vol) {
+	clampedAdd(out, (in * (int)vol) / Mixer::kMaxMixerVolume);
+}
+
+void rateMixStereo(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1);
+void rateMixMono(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1);
+
+#ifdef SCUMMVM_SSE2
+void rateMixStereoSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1);
+void rateMixMonoSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void rateMixStereoAVX2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1);
+void rateMixMonoAVX2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1);
+#endif
+
+#ifdef SCUMMVM_NEON
+void rateMixStereoNEON(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1);
+void rateMixMonoNEON(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1);
+#endif
+
+/**
+ * Return the fastest mix procs supported by the host CPU. The generic
+ * procs are returned when no SIMD extension is available.
+ *
+ * The SIMD procs only handle volumes up to Mixer::kMaxMixerVolume: higher
+ * volumes can push the scaled sample out of the 16 bit range, which only
+ * the generic procs clamp exactly like clampedAdd() does.
+ */
+RateMixProcs getRateMixProcs();
+
+/** Return the generic, scalar mix procs. */
+RateMixProcs getGenericRateMixProcs();
+
+} // End of namespace Audio
+
+#endif
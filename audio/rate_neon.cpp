@@ -0,0 +1,88 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/rate_intern.h"
+
+#include <arm_neon.h>
+
+namespace Audio {
+
+/**
+ * Compute x / 256, rounding towards zero like the C division in
+ * rateMixSample(). The result always fits into 16 bits.
+ */
+static inline int16x4_t divideByMaxVolume(int32x4_t x) {
+	const int32x4_t bias = vandq_s32(vshrq_n_s32(x, 31), vdupq_n_s32(255));
+	return vmovn_s32(vshrq_n_s32(vaddq_s32(x, bias), 8));
+}
+
+/** Scale 4 interleaved stereo frames and add them to obuf with saturation. */
+static inline void mixFrames4(st_sample_t *obuf, int16x8_t in, int16x4_t vol) {
+	const int16x4_t lo = divideByMaxVolume(vmull_s16(vget_low_s16(in), vol));
+	const int16x4_t hi = divideByMaxVolume(vmull_s16(vget_high_s16(in), vol));
+
+	vst1q_s16(obuf, vqaddq_s16(vld1q_s16(obuf), vcombine_s16(lo, hi)));
+}
+
+static inline int16x4_t makeVolume(st_volume_t vol0, st_volume_t vol1) {
+	const int16_t vol[4] = { (int16_t)vol0, (int16_t)vol1, (int16_t)vol0, (int16_t)vol1 };
+	return vld1_s16(vol);
+}
+
+void rateMixStereoNEON(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1) {
+	const int16x4_t vol = makeVolume(vol0, vol1);
+
+	for (; frames >= 4; frames -= 4) {
+		mixFrames4(obuf, vld1q_s16(ibuf), vol);
+		ibuf += 8;
+		obuf += 8;
+	}
+
+	for (; frames > 0; --frames) {
+		rateMixSample(obuf[0], ibuf[0], vol0);
+		rateMixSample(obuf[1], ibuf[1], vol1);
+		ibuf += 2;
+		obuf += 2;
+	}
+}
+
+void rateMixMonoNEON(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1) {
+	const int16x4_t vol = makeVolume(vol0, vol1);
+
+	for (; frames >= 8; frames -= 8) {
+		const int16x8_t in = vld1q_s16(ibuf);
+		const int16x8x2_t dup = vzipq_s16(in, in);
+		mixFrames4(obuf, dup.val[0], vol);
+		mixFrames4(obuf + 8, dup.val[1], vol);
+		ibuf += 8;
+		obuf += 16;
+	}
+
+	for (; frames > 0; --frames) {
+		rateMixSample(obuf[0], *ibuf, vol0);
+		rateMixSample(obuf[1], *ibuf, vol1);
+		ibuf++;
+		obuf += 2;
+	}
+}
+
+} // End of namespace Audio
@@ -0,0 +1,86 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/rate_intern.h"
+
+#include <emmintrin.h>
+
+namespace Audio {
+
+/**
+ * Compute (x * vol) / 256 for the 32 bit lanes of a madd result, rounding
+ * towards zero like the C division in rateMixSample().
+ */
+static inline __m128i divideByMaxVolume(__m128i x) {
+	const __m128i bias = _mm_and_si128(_mm_srai_epi32(x, 31), _mm_set1_epi32(255));
+	return _mm_srai_epi32(_mm_add_epi32(x, bias), 8);
+}
+
+/** Scale 4 interleaved stereo frames and add them to obuf with saturation. */
+static inline void mixFrames4(st_sample_t *obuf, __m128i in, __m128i vol) {
+	const __m128i zero = _mm_setzero_si128();
+
+	// Every 32 bit lane holds (sample, 0), which madd multiplies with (vol, 0)
+	const __m128i lo = divideByMaxVolume(_mm_madd_epi16(_mm_unpacklo_epi16(in, zero), vol));
+	const __m128i hi = divideByMaxVolume(_mm_madd_epi16(_mm_unpackhi_epi16(in, zero), vol));
+
+	const __m128i out = _mm_loadu_si128((const __m128i *)obuf);
+	_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(out, _mm_packs_epi32(lo, hi)));
+}
+
+void rateMixStereoSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1) {
+	const __m128i vol = _mm_set_epi16(0, vol1, 0, vol0, 0, vol1, 0, vol0);
+
+	for (; frames >= 4; frames -= 4) {
+		mixFrames4(obuf, _mm_loadu_si128((const __m128i *)ibuf), vol);
+		ibuf += 8;
+		obuf += 8;
+	}
+
+	for (; frames > 0; --frames) {
+		rateMixSample(obuf[0], ibuf[0], vol0);
+		rateMixSample(obuf[1], ibuf[1], vol1);
+		ibuf += 2;
+		obuf += 2;
+	}
+}
+
+void rateMixMonoSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol0, st_volume_t vol1) {
+	const __m128i vol = _mm_set_epi16(0, vol1, 0, vol0, 0, vol1, 0, vol0);
+
+	for (; frames >= 8; frames -= 8) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)ibuf);
+		mixFrames4(obuf, _mm_unpacklo_epi16(in, in), vol);
+		mixFrames4(obuf + 8, _mm_unpackhi_epi16(in, in), vol);
+		ibuf += 8;
+		obuf += 16;
+	}
+
+	for (; frames > 0; --frames) {
+		rateMixSample(obuf[0], *ibuf, vol0);
+		rateMixSample(obuf[1], *ibuf, vol1);
+		ibuf++;
+		obuf += 2;
+	}
+}
+
+} // End of namespace Audio
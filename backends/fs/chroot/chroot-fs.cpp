@@ -96,6 +96,10 @@ Common::SeekableReadStream *ChRootFilesystemNode::createReadStream() {
 	return _realNode->createReadStream();
 }
 
+Common::SeekableReadStream *ChRootFilesystemNode::createMappedReadStream() {
+	return _realNode->createMappedReadStream();
+}
+
 Common::WriteStream *ChRootFilesystemNode::createWriteStream() {
 	return _realNode->createWriteStream();
 }
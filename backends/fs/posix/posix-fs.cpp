@@ -34,6 +34,7 @@
 
 #include "backends/fs/posix/posix-fs.h"
 #include "backends/fs/posix/posix-iostream.h"
+#include "backends/fs/posix/posix-mmapstream.h"
 #include "common/algorithm.h"
 
 #include <sys/param.h>
@@ -290,6 +291,16 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
 	return PosixIoStream::makeFromPath(getPath(), false);
 }
 
+Common::SeekableReadStream *POSIXFilesystemNode::createMappedReadStream() {
+#ifdef HAS_MMAP
+	// Map big files into memory, engines often do lots of small seeks and
+	// reads in their archives
+	return PosixMmapStream::makeFromPath(getPath());
+#else
+	return createReadStream();
+#endif
+}
+
 Common::WriteStream *POSIXFilesystemNode::createWriteStream() {
 	return PosixIoStream::makeFromPath(getPath(), true);
 }
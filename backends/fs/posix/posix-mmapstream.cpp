@@ -0,0 +1,88 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/scummsys.h"
+
+#ifdef HAS_MMAP
+
+#include "backends/fs/posix/posix-iostream.h"
+#include "backends/fs/posix/posix-mmapstream.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Smaller files are read as fast through stdio, without the cost of
+// setting up a mapping
+enum {
+	kMinMappedFileSize = 64 * 1024
+};
+
+struct MappingDeleter {
+	size_t size;
+
+	explicit MappingDeleter(size_t s) : size(s) {}
+
+	void operator()(const byte *data) {
+		munmap(const_cast<byte *>(data), size);
+	}
+};
+
+} // End of anonymous namespace
+
+Common::SeekableReadStream *PosixMmapStream::makeFromPath(const Common::String &path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	struct stat st;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= kMinMappedFileSize && st.st_size <= 0x7FFFFFFF) {
+		const size_t size = st.st_size;
+		void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED) {
+			// The mapping stays valid after closing the file
+			close(fd);
+
+			Common::SharedPtr<const byte> mapping((const byte *)data, MappingDeleter(size));
+			return new PosixMmapStream(mapping, size);
+		}
+	}
+
+	FILE *handle = fdopen(fd, "rb");
+	if (!handle) {
+		close(fd);
+		return nullptr;
+	}
+
+	return new PosixIoStream(handle);
+}
+
+PosixMmapStream::PosixMmapStream(const Common::SharedPtr<const byte> &mapping, uint32 size) :
+		SharedMemoryReadStream(mapping, mapping.get(), size) {
+}
+
+#endif
@@ -0,0 +1,54 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_FS_POSIX_POSIXMMAPSTREAM_H
+#define BACKENDS_FS_POSIX_POSIXMMAPSTREAM_H
+
+#include "common/memstream.h"
+#include "common/str.h"
+
+/**
+ * A read stream on a file which is mapped into memory with mmap().
+ *
+ * Reads are plain copies from the mapping, and readStream() returns
+ * streams pointing straight into it, so substreams of archives do not
+ * copy their data. The mapping is kept alive until the last of these
+ * streams is destroyed.
+ */
+class PosixMmapStream : public Common::SharedMemoryReadStream {
+public:
+	/**
+	 * Open the file at the given path for reading. Big files are mapped,
+	 * other ones and files which can not be mapped are read through a
+	 * PosixIoStream on the same file descriptor. Returns nullptr when the
+	 * file can not be opened.
+	 *
+	 * The file must not be written while the stream is in use, so this is
+	 * only meant for game data.
+	 */
+	static Common::SeekableReadStream *makeFromPath(const Common::String &path);
+
+private:
+	PosixMmapStream(const Common::SharedPtr<const byte> &mapping, uint32 size);
+};
+
+#endif
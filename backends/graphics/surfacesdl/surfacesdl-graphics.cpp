@@ -26,6 +26,7 @@
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #include "backends/events/sdl/sdl-events.h"
 #include "common/config-manager.h"
+#include "common/debug.h"
 #include "common/mutex.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
@@ -156,7 +157,8 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_screenFormat(Graphics::PixelFormat::createFormatCLUT8()),
 	_cursorFormat(Graphics::PixelFormat::createFormatCLUT8()),
 	_overlayscreen(0), _tmpscreen2(0),
-	_scalerProc(0), _screenChangeCount(0),
+	_scalerProc(0), _scalerWorkers(nullptr), _threadedScaling(false), _scalerTiming(false),
+	_screenChangeCount(0),
 	_mouseData(nullptr), _mouseSurface(nullptr),
 	_mouseOrigSurface(nullptr), _cursorDontScale(false), _cursorPaletteDisabled(true),
 	_currentShakeXOffset(0), _currentShakeYOffset(0),
@@ -179,6 +181,11 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 		_enableFocusRectDebugCode = ConfMan.getBool("use_sdl_debug_focusrect");
 #endif
 
+	if (ConfMan.hasKey("threaded_scaling"))
+		_threadedScaling = ConfMan.getBool("threaded_scaling");
+	if (ConfMan.hasKey("scaler_timing"))
+		_scalerTiming = ConfMan.getBool("scaler_timing");
+
 #if !defined(__SYMBIAN32__) && defined(USE_SCALERS)
 	_videoMode.mode = GFX_DOUBLESIZE;
 	_videoMode.scaleFactor = 2;
@@ -214,6 +221,7 @@ SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
 	free(_currentPalette);
 	free(_cursorPalette);
 	delete[] _mouseData;
+	delete _scalerWorkers;
 }
 
 bool SurfaceSdlGraphicsManager::hasFeature(OSystem::Feature f) const {
@@ -1136,6 +1144,85 @@ void SurfaceSdlGraphicsManager::updateScreen() {
 	internUpdateScreen();
 }
 
+/** Timestamps for the scaler timing mode. */
+static uint64 getScalerTicks() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	return SDL_GetPerformanceCounter();
+#else
+	return SDL_GetTicks();
+#endif
+}
+
+static uint32 scalerTicksToMicroseconds(uint64 ticks) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	return (uint32)(ticks * 1000000 / SDL_GetPerformanceFrequency());
+#else
+	return (uint32)(ticks * 1000);
+#endif
+}
+
+namespace {
+
+// Smallest band of source rows worth handing to a worker thread
+enum {
+	kMinScalerBandRows = 16
+};
+
+struct ScalerBands {
+	ScalerProc *proc;
+	const byte *src;
+	uint32 srcPitch;
+	byte *dst;
+	uint32 dstPitch;
+	int width, height;
+	int scaleFactor;
+	uint count;
+};
+
+/**
+ * Band boundaries are kept on even rows, so that scalers which use the
+ * row parity (like DotMatrix) draw the same pattern as for the whole rect.
+ */
+int scalerBandTop(const ScalerBands &bands, uint band) {
+	if (band == bands.count)
+		return bands.height;
+	return (bands.height * band / bands.count) & ~1;
+}
+
+void scaleBand(void *param, uint band) {
+	const ScalerBands &bands = *(const ScalerBands *)param;
+	const int top = scalerBandTop(bands, band);
+	const int bottom = scalerBandTop(bands, band + 1);
+	bands.proc(bands.src + top * bands.srcPitch, bands.srcPitch,
+	           bands.dst + top * bands.scaleFactor * bands.dstPitch, bands.dstPitch, bands.width, bottom - top);
+}
+
+} // End of anonymous namespace
+
+void SurfaceSdlGraphicsManager::scaleRect(ScalerProc *scalerProc, const byte *src, uint32 srcPitch, byte *dst, uint32 dstPitch, int width, int height, int scaleFactor) {
+	if (_threadedScaling && !_scalerWorkers)
+		_scalerWorkers = new Common::WorkerPool();
+
+	// The scalers read the rows around each band straight from the source
+	// surface, which stays untouched while scaling, and every band writes
+	// its own rows of the destination. So the bands need no extra overlap
+	// rows, and no synchronization besides waiting for all of them.
+	uint count = _scalerWorkers ? MIN<uint>(_scalerWorkers->getThreadCount(), height / kMinScalerBandRows) : 1;
+#if defined(USE_HQ_SCALERS) && defined(USE_NASM)
+	// The assembly HQ scalers keep their state in static variables, so
+	// they can only scale one band at a time
+	if (scalerProc == HQ2x || scalerProc == HQ3x)
+		count = 1;
+#endif
+	if (count <= 1) {
+		scalerProc(src, srcPitch, dst, dstPitch, width, height);
+		return;
+	}
+
+	ScalerBands bands = { scalerProc, src, srcPitch, dst, dstPitch, width, height, scaleFactor, count };
+	_scalerWorkers->run(scaleBand, &bands, count);
+}
+
 void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	SDL_Surface *srcSurf, *origSurf;
 	int height, width;
@@ -1250,6 +1337,9 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		srcPitch = srcSurf->pitch;
 		dstPitch = _hwScreen->pitch;
 
+		const uint64 scaleStart = _scalerTiming ? getScalerTicks() : 0;
+		int scaledPixels = 0;
+
 		for (r = _dirtyRectList; r != lastRect; ++r) {
 			int dst_x = r->x + _currentShakeXOffset;
 			int dst_y = r->y + _currentShakeYOffset;
@@ -1278,8 +1368,9 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 					dst_y = real2Aspect(dst_y);
 
 				assert(scalerProc != NULL);
-				scalerProc((byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
-					(byte *)_hwScreen->pixels + dst_x * 2 + dst_y * dstPitch, dstPitch, dst_w, dst_h);
+				scaleRect(scalerProc, (byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
+					(byte *)_hwScreen->pixels + dst_x * 2 + dst_y * dstPitch, dstPitch, dst_w, dst_h, scale1);
+				scaledPixels += dst_w * dst_h;
 			}
 
 			r->x = dst_x;
@@ -1295,6 +1386,11 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		SDL_UnlockSurface(srcSurf);
 		SDL_UnlockSurface(_hwScreen);
 
+		if (_scalerTiming) {
+			debug("Scaled %d dirty rects of %d pixels in %u us using %u threads", (int)(lastRect - _dirtyRectList), scaledPixels,
+			      scalerTicksToMicroseconds(getScalerTicks() - scaleStart), _scalerWorkers ? _scalerWorkers->getThreadCount() : 1);
+		}
+
 		// Readjust the dirty rect list in case we are doing a full update.
 		// This is necessary if shaking is active.
 		if (_forceRedraw) {
@@ -29,6 +29,7 @@
 #include "graphics/scaler.h"
 #include "common/events.h"
 #include "common/mutex.h"
+#include "common/workerpool.h"
 
 #include "backends/events/sdl/sdl-events.h"
 
@@ -326,6 +327,16 @@ protected:
 	int _scalerType;
 	int _transactionMode;
 
+	/**
+	 * Worker threads which scale the dirty rects in bands of rows, only
+	 * created when the "threaded_scaling" option is set.
+	 */
+	Common::WorkerPool *_scalerWorkers;
+	bool _threadedScaling;
+
+	/** Whether to log how long scaling the dirty rects takes each frame. */
+	bool _scalerTiming;
+
 	// Indicates whether it is needed to free _hwSurface in destructor
 	bool _displayDisabled;
 
@@ -412,6 +423,12 @@ protected:
 
 	virtual void internUpdateScreen();
 
+	/**
+	 * Scale a block of the screen with the given scaler, splitting it into
+	 * bands of rows for the scaler worker threads when it is big enough.
+	 */
+	void scaleRect(ScalerProc *scalerProc, const byte *src, uint32 srcPitch, byte *dst, uint32 dstPitch, int width, int height, int scaleFactor);
+
 	virtual bool loadGFXMode();
 	virtual void unloadGFXMode();
 	virtual bool hotswapGFXMode();
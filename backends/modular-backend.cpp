@@ -27,6 +27,7 @@
 #include "backends/graphics3d/graphics3d.h"
 #include "backends/mixer/mixer.h"
 #include "backends/mutex/mutex.h"
+#include "backends/threads/threads.h"
 #include "gui/EventRecorder.h"
 
 #include "common/timer.h"
@@ -289,7 +290,8 @@ Audio::Mixer *ModularMixerBackend::getMixer() {
 
 ModularMutexBackend::ModularMutexBackend()
 	:
-	_mutexManager(0) {
+	_mutexManager(0),
+	_threadManager(0) {
 
 }
 
@@ -299,6 +301,8 @@ ModularMutexBackend::~ModularMutexBackend() {
 	_timerManager = 0;
 	delete _mutexManager;
 	_mutexManager = 0;
+	delete _threadManager;
+	_threadManager = 0;
 }
 
 OSystem::MutexRef ModularMutexBackend::createMutex() {
@@ -320,3 +324,35 @@ void ModularMutexBackend::deleteMutex(MutexRef mutex) {
 	assert(_mutexManager);
 	_mutexManager->deleteMutex(mutex);
 }
+
+uint ModularMutexBackend::getCpuCount() {
+	return _threadManager ? _threadManager->getCpuCount() : 1;
+}
+
+OSystem::ThreadRef ModularMutexBackend::createThread(ThreadProc proc, void *param) {
+	return _threadManager ? _threadManager->createThread(proc, param) : 0;
+}
+
+void ModularMutexBackend::joinThread(ThreadRef thread) {
+	assert(_threadManager);
+	_threadManager->joinThread(thread);
+}
+
+OSystem::SemaphoreRef ModularMutexBackend::createSemaphore(uint initialCount) {
+	return _threadManager ? _threadManager->createSemaphore(initialCount) : 0;
+}
+
+void ModularMutexBackend::waitSemaphore(SemaphoreRef sem) {
+	assert(_threadManager);
+	_threadManager->waitSemaphore(sem);
+}
+
+void ModularMutexBackend::postSemaphore(SemaphoreRef sem) {
+	assert(_threadManager);
+	_threadManager->postSemaphore(sem);
+}
+
+void ModularMutexBackend::deleteSemaphore(SemaphoreRef sem) {
+	assert(_threadManager);
+	_threadManager->deleteSemaphore(sem);
+}
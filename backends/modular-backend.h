@@ -28,6 +28,7 @@
 class GraphicsManager;
 class MixerManager;
 class MutexManager;
+class ThreadManager;
 
 /**
  * Base classes for modular backends.
@@ -173,11 +174,25 @@ public:
 
 	//@}
 
+	/** @name Worker threads */
+	//@{
+
+	virtual uint getCpuCount() override final;
+	virtual ThreadRef createThread(ThreadProc proc, void *param) override final;
+	virtual void joinThread(ThreadRef thread) override final;
+	virtual SemaphoreRef createSemaphore(uint initialCount) override final;
+	virtual void waitSemaphore(SemaphoreRef sem) override final;
+	virtual void postSemaphore(SemaphoreRef sem) override final;
+	virtual void deleteSemaphore(SemaphoreRef sem) override final;
+
+	//@}
+
 protected:
 	/** @name Managers variables */
 	//@{
 
 	MutexManager *_mutexManager;
+	ThreadManager *_threadManager;
 
 	//@}
 };
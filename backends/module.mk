@@ -148,6 +148,7 @@ MODULE_OBJS += \
 	mixer/sdl/sdl-mixer.o \
 	mutex/sdl/sdl-mutex.o \
 	plugins/sdl/sdl-provider.o \
+	threads/sdl/sdl-threads.o \
 	timer/sdl/sdl-timer.o
 
 # SDL 2 removed audio CD support
@@ -172,6 +173,7 @@ MODULE_OBJS += \
 	fs/posix/posix-fs.o \
 	fs/posix/posix-fs-factory.o \
 	fs/posix/posix-iostream.o \
+	fs/posix/posix-mmapstream.o \
 	fs/posix-drives/posix-drives-fs.o \
 	fs/posix-drives/posix-drives-fs-factory.o \
 	fs/chroot/chroot-fs-factory.o \
@@ -181,6 +183,11 @@ MODULE_OBJS += \
 	taskbar/unity/unity-taskbar.o \
 	dialogs/gtk/gtk-dialogs.o
 
+ifdef HAS_PTHREADS
+MODULE_OBJS += \
+	threads/pthread/pthread-threads.o
+endif
+
 ifdef USE_SPEECH_DISPATCHER
 ifdef USE_TTS
 MODULE_OBJS += \
@@ -269,6 +276,7 @@ MODULE_OBJS += \
 	fs/posix/posix-fs.o \
 	fs/posix/posix-fs-factory.o \
 	fs/posix/posix-iostream.o \
+	fs/posix/posix-mmapstream.o \
 	fs/ps3/ps3-fs-factory.o \
 	events/ps3sdl/ps3sdl-events.o
 endif
@@ -289,6 +297,7 @@ MODULE_OBJS += \
 	fs/posix/posix-fs.o \
 	fs/posix/posix-fs-factory.o \
 	fs/posix/posix-iostream.o \
+	fs/posix/posix-mmapstream.o \
 	fs/posix-drives/posix-drives-fs.o \
 	fs/posix-drives/posix-drives-fs-factory.o \
 	fs/devoptab/devoptab-fs-factory.o \
@@ -330,6 +339,10 @@ endif
 ifeq ($(BACKEND),null)
 MODULE_OBJS += \
 	mixer/null/null-mixer.o
+ifdef HAS_PTHREADS
+MODULE_OBJS += \
+	mutex/pthread/pthread-mutex.o
+endif
 endif
 
 ifeq ($(BACKEND),openpandora)
@@ -351,6 +364,7 @@ ifeq ($(BACKEND),psp2)
 MODULE_OBJS += \
 	fs/posix/posix-fs.o \
 	fs/posix/posix-iostream.o \
+	fs/posix/posix-mmapstream.o \
 	fs/posix-drives/posix-drives-fs.o \
 	fs/posix-drives/posix-drives-fs-factory.o \
 	events/psp2sdl/psp2sdl-events.o \
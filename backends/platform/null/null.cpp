@@ -49,6 +49,12 @@ typedef void (*sighandler_t)(int);
 
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
+#include "backends/mutex/null/null-mutex.h"
+#ifdef HAS_PTHREADS
+#include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/threads/pthread/pthread-threads.h"
+#endif
+#include "backends/graphics/null/null-graphics.h"
 #include "base/main.h"
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
@@ -56,8 +62,6 @@ typedef void (*sighandler_t)(int);
 #include "backends/timer/default/default-timer.h"
 #include "backends/events/default/default-events.h"
 #include "backends/mixer/null/null-mixer.h"
-#include "backends/mutex/null/null-mutex.h"
-#include "backends/graphics/null/null-graphics.h"
 #include "gui/debugger.h"
 #endif
 
@@ -117,6 +121,24 @@ OSystem_NULL::OSystem_NULL() {
 	#else
 		#error Unknown and unsupported FS backend
 	#endif
+
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	// Unit tests never call initBackend(), but some tested code needs
+	// timing, mutexes and the screen format
+#ifdef POSIX
+	gettimeofday(&_startTime, 0);
+#elif defined(WIN32)
+	_startTime = GetTickCount();
+#endif
+	_graphicsManager = new NullGraphicsManager();
+#ifdef HAS_PTHREADS
+	// Tested code runs worker threads, which need real locking
+	_mutexManager = new PthreadMutexManager();
+	_threadManager = new PthreadThreadManager();
+#else
+	_mutexManager = new NullMutexManager();
+#endif
+#endif
 }
 
 OSystem_NULL::~OSystem_NULL() {
@@ -145,7 +167,13 @@ void OSystem_NULL::initBackend() {
 	last_handler = signal(SIGINT, intHandler);
 #endif
 
+#ifdef HAS_PTHREADS
+	// Worker threads need real locking
+	_mutexManager = new PthreadMutexManager();
+	_threadManager = new PthreadThreadManager();
+#else
 	_mutexManager = new NullMutexManager();
+#endif
 	_timerManager = new DefaultTimerManager();
 	_eventManager = new DefaultEventManager(this);
 	_savefileManager = new DefaultSaveFileManager();
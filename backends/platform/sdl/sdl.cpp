@@ -45,6 +45,7 @@
 #include "backends/events/sdl/legacy-sdl-events.h"
 #include "backends/keymapper/hardware-input.h"
 #include "backends/mutex/sdl/sdl-mutex.h"
+#include "backends/threads/sdl/sdl-threads.h"
 #include "backends/timer/sdl/sdl-timer.h"
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #include "backends/graphics3d/sdl/sdl-graphics3d.h"
@@ -169,6 +170,9 @@ void OSystem_SDL::init() {
 	if (_mutexManager == 0)
 		_mutexManager = new SdlMutexManager();
 
+	if (_threadManager == 0)
+		_threadManager = new SdlThreadManager();
+
 	if (_window == 0)
 		_window = new SdlWindow();
 
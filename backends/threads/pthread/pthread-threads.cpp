@@ -0,0 +1,137 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "common/scummsys.h"
+
+#if defined(POSIX) && defined(HAS_PTHREADS)
+
+#include "backends/threads/pthread/pthread-threads.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+namespace {
+
+struct PthreadThread {
+	pthread_t thread;
+	OSystem::ThreadProc proc;
+	void *param;
+};
+
+struct PthreadSemaphore {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	uint count;
+};
+
+void *threadEntry(void *arg) {
+	PthreadThread *t = (PthreadThread *)arg;
+	t->proc(t->param);
+	return nullptr;
+}
+
+} // End of anonymous namespace
+
+uint PthreadThreadManager::getCpuCount() {
+#ifdef _SC_NPROCESSORS_ONLN
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	if (count > 0)
+		return (uint)count;
+#endif
+	return 1;
+}
+
+OSystem::ThreadRef PthreadThreadManager::createThread(OSystem::ThreadProc proc, void *param) {
+	PthreadThread *t = new PthreadThread;
+	t->proc = proc;
+	t->param = param;
+
+	if (pthread_create(&t->thread, nullptr, threadEntry, t) != 0) {
+		warning("pthread_create() failed");
+		delete t;
+		return nullptr;
+	}
+
+	return (OSystem::ThreadRef)t;
+}
+
+void PthreadThreadManager::joinThread(OSystem::ThreadRef thread) {
+	PthreadThread *t = (PthreadThread *)thread;
+
+	if (pthread_join(t->thread, nullptr) != 0)
+		warning("pthread_join() failed");
+	delete t;
+}
+
+OSystem::SemaphoreRef PthreadThreadManager::createSemaphore(uint initialCount) {
+	// Unnamed POSIX semaphores are missing on macOS, so build them from a
+	// mutex and a condition variable instead.
+	PthreadSemaphore *sem = new PthreadSemaphore;
+	sem->count = initialCount;
+
+	if (pthread_mutex_init(&sem->mutex, nullptr) != 0) {
+		warning("pthread_mutex_init() failed");
+		delete sem;
+		return nullptr;
+	}
+
+	if (pthread_cond_init(&sem->cond, nullptr) != 0) {
+		warning("pthread_cond_init() failed");
+		pthread_mutex_destroy(&sem->mutex);
+		delete sem;
+		return nullptr;
+	}
+
+	return (OSystem::SemaphoreRef)sem;
+}
+
+void PthreadThreadManager::waitSemaphore(OSystem::SemaphoreRef semaphore) {
+	PthreadSemaphore *sem = (PthreadSemaphore *)semaphore;
+
+	pthread_mutex_lock(&sem->mutex);
+	while (sem->count == 0)
+		pthread_cond_wait(&sem->cond, &sem->mutex);
+	sem->count--;
+	pthread_mutex_unlock(&sem->mutex);
+}
+
+void PthreadThreadManager::postSemaphore(OSystem::SemaphoreRef semaphore) {
+	PthreadSemaphore *sem = (PthreadSemaphore *)semaphore;
+
+	pthread_mutex_lock(&sem->mutex);
+	sem->count++;
+	pthread_cond_signal(&sem->cond);
+	pthread_mutex_unlock(&sem->mutex);
+}
+
+void PthreadThreadManager::deleteSemaphore(OSystem::SemaphoreRef semaphore) {
+	PthreadSemaphore *sem = (PthreadSemaphore *)semaphore;
+
+	pthread_cond_destroy(&sem->cond);
+	pthread_mutex_destroy(&sem->mutex);
+	delete sem;
+}
+
+#endif
@@ -0,0 +1,96 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/threads/sdl/sdl-threads.h"
+#include "backends/platform/sdl/sdl-sys.h"
+
+namespace {
+
+struct SdlThread {
+	SDL_Thread *thread;
+	OSystem::ThreadProc proc;
+	void *param;
+};
+
+int SDLCALL threadEntry(void *arg) {
+	SdlThread *t = (SdlThread *)arg;
+	t->proc(t->param);
+	return 0;
+}
+
+} // End of anonymous namespace
+
+uint SdlThreadManager::getCpuCount() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	int count = SDL_GetCPUCount();
+	if (count > 0)
+		return (uint)count;
+#endif
+	return 1;
+}
+
+OSystem::ThreadRef SdlThreadManager::createThread(OSystem::ThreadProc proc, void *param) {
+	SdlThread *t = new SdlThread;
+	t->proc = proc;
+	t->param = param;
+
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	t->thread = SDL_CreateThread(threadEntry, "ScummVM worker", t);
+#else
+	t->thread = SDL_CreateThread(threadEntry, t);
+#endif
+	if (!t->thread) {
+		warning("SDL_CreateThread() failed: %s", SDL_GetError());
+		delete t;
+		return nullptr;
+	}
+
+	return (OSystem::ThreadRef)t;
+}
+
+void SdlThreadManager::joinThread(OSystem::ThreadRef thread) {
+	SdlThread *t = (SdlThread *)thread;
+	SDL_WaitThread(t->thread, nullptr);
+	delete t;
+}
+
+OSystem::SemaphoreRef SdlThreadManager::createSemaphore(uint initialCount) {
+	return (OSystem::SemaphoreRef)SDL_CreateSemaphore(initialCount);
+}
+
+void SdlThreadManager::waitSemaphore(OSystem::SemaphoreRef sem) {
+	SDL_SemWait((SDL_sem *)sem);
+}
+
+void SdlThreadManager::postSemaphore(OSystem::SemaphoreRef sem) {
+	SDL_SemPost((SDL_sem *)sem);
+}
+
+void SdlThreadManager::deleteSemaphore(OSystem::SemaphoreRef sem) {
+	SDL_DestroySemaphore((SDL_sem *)sem);
+}
+
+#endif
@@ -266,7 +266,9 @@ static Common::Error runGame(const Plugin *plugin, OSystem &system, const Common
 	}
 
 	// On creation the engine should have set up all debug levels so we can use
-	// the command line arguments here
+	// the command line arguments here. The video decoders are shared by the
+	// engines, so their channel is added for every game.
+	DebugMan.addDebugChannel(kDebugLevelVideoDecoder, "VideoDecoder", "Video decoding queue and timing");
 	Common::StringTokenizer tokenizer(edebuglevels, " ,");
 	while (!tokenizer.empty()) {
 		Common::String token = tokenizer.nextToken();
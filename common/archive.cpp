@@ -106,16 +106,18 @@ void SearchSet::add(const String &name, Archive *archive, int priority, bool aut
 
 }
 
-void SearchSet::addDirectory(const String &name, const String &directory, int priority, int depth, bool flat) {
+void SearchSet::addDirectory(const String &name, const String &directory, int priority, int depth, bool flat, bool mapFiles) {
 	FSNode dir(directory);
-	addDirectory(name, dir, priority, depth, flat);
+	addDirectory(name, dir, priority, depth, flat, mapFiles);
 }
 
-void SearchSet::addDirectory(const String &name, const FSNode &dir, int priority, int depth, bool flat) {
+void SearchSet::addDirectory(const String &name, const FSNode &dir, int priority, int depth, bool flat, bool mapFiles) {
 	if (!dir.exists() || !dir.isDirectory())
 		return;
 
-	add(name, new FSDirectory(dir, depth, flat, _ignoreClashes), priority);
+	FSDirectory *directory = new FSDirectory(dir, depth, flat, _ignoreClashes);
+	directory->setMapFiles(mapFiles);
+	add(name, directory, priority);
 }
 
 void SearchSet::addSubDirectoriesMatching(const FSNode &directory, String origPattern, bool ignoreCase, int priority, int depth, bool flat) {
@@ -179,13 +179,17 @@ public:
 
 	/**
 	 * Create and add an FSDirectory by name.
+	 *
+	 * @see FSDirectory::setMapFiles() for mapFiles.
 	 */
-	void addDirectory(const String &name, const String &directory, int priority = 0, int depth = 1, bool flat = false);
+	void addDirectory(const String &name, const String &directory, int priority = 0, int depth = 1, bool flat = false, bool mapFiles = false);
 
 	/**
 	 * Create and add an FSDirectory by FSNode.
+	 *
+	 * @see FSDirectory::setMapFiles() for mapFiles.
 	 */
-	void addDirectory(const String &name, const FSNode &directory, int priority = 0, int depth = 1, bool flat = false);
+	void addDirectory(const String &name, const FSNode &directory, int priority = 0, int depth = 1, bool flat = false, bool mapFiles = false);
 
 	/**
 	 * Create and add a subdirectory by name (caseless).
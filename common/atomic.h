@@ -0,0 +1,159 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_atomic Atomic operations
+ * @ingroup common
+ *
+ * @brief Minimal set of atomic operations for sharing data between threads
+ *        without a mutex.
+ *
+ * All operations are sequentially consistent. They are meant for naturally
+ * aligned integers, bools and pointers; compare-and-swap and add are only
+ * available for 32 bit values and pointers.
+ *
+ * @{
+ */
+
+#if defined(__GNUC__) && defined(__ATOMIC_SEQ_CST)
+
+template<typename T>
+inline T atomicLoad(const T *ptr) {
+	return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+}
+
+template<typename T>
+inline void atomicStore(T *ptr, T value) {
+	__atomic_store_n(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+template<typename T>
+inline bool atomicCompareExchange(T *ptr, T expected, T desired) {
+	return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+template<typename T>
+inline T atomicAdd(T *ptr, T value) {
+	return __atomic_add_fetch(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+#elif defined(__GNUC__)
+
+// Older GCC versions only have the full barrier __sync builtins
+template<typename T>
+inline T atomicLoad(const T *ptr) {
+	__sync_synchronize();
+	T value = *(const volatile T *)ptr;
+	__sync_synchronize();
+	return value;
+}
+
+template<typename T>
+inline void atomicStore(T *ptr, T value) {
+	__sync_synchronize();
+	*(volatile T *)ptr = value;
+	__sync_synchronize();
+}
+
+template<typename T>
+inline bool atomicCompareExchange(T *ptr, T expected, T desired) {
+	return __sync_bool_compare_and_swap(ptr, expected, desired);
+}
+
+template<typename T>
+inline T atomicAdd(T *ptr, T value) {
+	return __sync_add_and_fetch(ptr, value);
+}
+
+#elif defined(_MSC_VER)
+
+template<typename T>
+inline T atomicLoad(const T *ptr) {
+	T value = *(const volatile T *)ptr;
+	_ReadWriteBarrier();
+	return value;
+}
+
+template<typename T>
+inline void atomicStore(T *ptr, T value) {
+	_ReadWriteBarrier();
+	*(volatile T *)ptr = value;
+	MemoryBarrier();
+}
+
+template<typename T>
+inline bool atomicCompareExchange(T *ptr, T expected, T desired) {
+	if (sizeof(T) == sizeof(long))
+		return _InterlockedCompareExchange((volatile long *)ptr, (long)desired, (long)expected) == (long)expected;
+	return _InterlockedCompareExchangePointer((void *volatile *)ptr, (void *)desired, (void *)expected) == (void *)expected;
+}
+
+template<typename T>
+inline T atomicAdd(T *ptr, T value) {
+	STATIC_ASSERT(sizeof(T) == sizeof(long), atomicAdd_only_supports_32bit_values);
+	return (T)(_InterlockedExchangeAdd((volatile long *)ptr, (long)value) + (long)value);
+}
+
+#else
+
+// Platforms without threads or compiler support for atomics
+template<typename T>
+inline T atomicLoad(const T *ptr) {
+	return *(const volatile T *)ptr;
+}
+
+template<typename T>
+inline void atomicStore(T *ptr, T value) {
+	*(volatile T *)ptr = value;
+}
+
+template<typename T>
+inline bool atomicCompareExchange(T *ptr, T expected, T desired) {
+	if (*ptr != expected)
+		return false;
+	*ptr = desired;
+	return true;
+}
+
+template<typename T>
+inline T atomicAdd(T *ptr, T value) {
+	return *ptr += value;
+}
+
+#endif
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -333,6 +333,11 @@ public:
 		return _size;
 	}
 
+	/** Return the start of the memory buffer. */
+	const byte *getData() const {
+		return _ptrOrig;
+	}
+
 	bool seek(uint32 offset) {
 		assert(offset <= _size);
 
@@ -382,7 +387,7 @@ public:
 			}
 		}
 
-		uint16 val = READ_LE_UINT16(_ptr);
+		uint16 val = READ_BE_UINT16(_ptr);
 
 		_pos += 2;
 		_ptr += 2;
@@ -428,6 +433,205 @@ public:
 
 };
 
+/**
+ * A bit stream over a memory buffer, for the same memory layouts.
+ *
+ * Instead of refilling a bit container value by value, every peek loads
+ * the 64 bits around the stream position straight from the buffer, so
+ * the bits are read without calls into the data stream and without
+ * checking for refills. Only peeks in the last 8 bytes of the buffer take
+ * a slower path, which reads 0 bits past the end like the generic
+ * implementation does.
+ */
+template<int valueBits, bool isLE, bool MSB2LSB>
+class BitStreamImpl<BitStreamMemoryStream, valueBits, isLE, MSB2LSB> {
+private:
+	BitStreamMemoryStream *_stream;         //!< The input stream.
+	DisposeAfterUse::Flag _disposeAfterUse; //!< Whether to delete the stream on destruction.
+
+	const byte *_data;                      //!< The data, starting at the stream position on creation.
+	uint32 _dataSize;                       //!< Size of the data in whole values (in bytes).
+	uint32 _size;                           //!< Total bit stream size (in bits).
+	uint32 _pos;                            //!< Current bit stream position (in bits).
+
+	/** Read 64 bits worth of data values, with the first bit on the side it is read from. */
+	inline static uint64 readData(const byte *ptr) {
+		if (valueBits == 8)
+			return MSB2LSB ? READ_BE_UINT64(ptr) : READ_LE_UINT64(ptr);
+
+		uint64 data = 0;
+		for (int i = 0; i < 64 / valueBits; i++) {
+			uint64 value;
+			if (valueBits == 16)
+				value = isLE ? READ_LE_UINT16(ptr + i * 2) : READ_BE_UINT16(ptr + i * 2);
+			else
+				value = isLE ? READ_LE_UINT32(ptr + i * 4) : READ_BE_UINT32(ptr + i * 4);
+
+			if (MSB2LSB)
+				data |= value << (64 - valueBits * (i + 1));
+			else
+				data |= value << (valueBits * i);
+		}
+
+		return data;
+	}
+
+	/** Load at least 33 bits, starting with the bit at the stream position. */
+	inline uint64 load() const {
+		const uint32 offset = (_pos / valueBits) * (valueBits / 8);
+
+		uint64 data;
+		if (offset + 8 <= _dataSize) {
+			data = readData(_data + offset);
+		} else {
+			byte tail[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+			if (offset < _dataSize)
+				memcpy(tail, _data + offset, _dataSize - offset);
+			data = readData(tail);
+		}
+
+		if (MSB2LSB)
+			return data << (_pos % valueBits);
+		else
+			return data >> (_pos % valueBits);
+	}
+
+	/** Get @p n bits from loaded data. */
+	inline static uint32 getNBits(uint64 value, size_t n) {
+		if (n == 0)
+			return 0;
+
+		const size_t toShift = 64 - n;
+
+		if (MSB2LSB)
+			return value >> toShift;
+		else
+			return (value << toShift) >> toShift;
+	}
+
+	void init() {
+		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32))
+			error("BitStreamImpl: Invalid memory layout %d, %d, %d", valueBits, isLE, MSB2LSB);
+
+		_data = _stream->getData() + _stream->pos();
+		_dataSize = (_stream->size() - _stream->pos()) & ~((uint32) ((valueBits >> 3) - 1));
+		_size = _dataSize * 8;
+		_pos = 0;
+	}
+
+public:
+	/** Create a bit stream using this input data stream and optionally delete it on destruction. */
+	BitStreamImpl(BitStreamMemoryStream *stream, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::NO) :
+	    _stream(stream), _disposeAfterUse(disposeAfterUse) {
+		init();
+	}
+
+	/** Create a bit stream using this input data stream. */
+	BitStreamImpl(BitStreamMemoryStream &stream) :
+	    _stream(&stream), _disposeAfterUse(DisposeAfterUse::NO) {
+		init();
+	}
+
+	~BitStreamImpl() {
+		if (_disposeAfterUse == DisposeAfterUse::YES)
+			delete _stream;
+	}
+
+	/** Read a bit from the bit stream, without changing the stream's position. */
+	uint peekBit() {
+		return getNBits(load(), 1);
+	}
+
+	/** Read a bit from the bit stream. */
+	uint getBit() {
+		const uint b = peekBit();
+
+		_pos++;
+
+		return b;
+	}
+
+	/**
+	 * Read a multi-bit value from the bit stream, without changing the stream's position.
+	 *
+	 * The bit order is the same as in @ref getBits().
+	 */
+	uint32 peekBits(size_t n) {
+		if (n > 32)
+			error("BitStreamImpl::peekBits(): Too many bits requested to be peeked");
+
+		return getNBits(load(), n);
+	}
+
+	/**
+	 * Read a multi-bit value from the bit stream.
+	 *
+	 * The value is read as if just taken as a whole from the bit stream.
+	 */
+	uint32 getBits(size_t n) {
+		if (n > 32)
+			error("BitStreamImpl::getBits(): Too many bits requested to be read");
+
+		const uint32 b = getNBits(load(), n);
+
+		_pos += n;
+
+		return b;
+	}
+
+	/**
+	 * Add a bit to the value x, making it an n+1-bit value.
+	 *
+	 * The current value is shifted and the bit is added to the
+	 * appropriate place, depending on the stream's bit order.
+	 */
+	void addBit(uint32 &x, uint32 n) {
+		if (n >= 32)
+			error("BitStreamImpl::addBit(): Too many bits requested to be read");
+
+		if (MSB2LSB)
+			x = (x << 1) | getBit();
+		else
+			x = (x & ~(1 << n)) | (getBit() << n);
+	}
+
+	/** Rewind the bit stream back to the start. */
+	void rewind() {
+		_pos = 0;
+	}
+
+	/** Skip the specified number of bits. */
+	void skip(uint32 n) {
+		_pos += n;
+	}
+
+	/** Skip the bits to closest data value border. */
+	void align() {
+		uint32 bitsAfterBoundary = _pos % valueBits;
+		if (bitsAfterBoundary) {
+			skip(valueBits - bitsAfterBoundary);
+		}
+	}
+
+	/** Return the stream position in bits. */
+	uint32 pos() const {
+		return _pos;
+	}
+
+	/** Return the stream size in bits. */
+	uint32 size() const {
+		return _size;
+	}
+
+	bool eos() const {
+		return _pos >= _size;
+	}
+
+	static bool isMSB2LSB() {
+		return MSB2LSB;
+	}
+};
+
 /**
  * @name Typedefs for various memory layouts
  * @{
@@ -67,6 +67,29 @@ ReadStream *wrapBufferedReadStream(ReadStream *parentStream, uint32 bufSize, Dis
  */
 SeekableReadStream *wrapBufferedSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream);
 
+/**
+ * Take an arbitrary SeekableReadStream and wrap it in a custom stream that
+ * reads it ahead on a worker thread. The wrapper uses two buffers: while
+ * the current block is read from one, the next block of the parent stream
+ * is read into the other one. This hides the latency of slow storage from
+ * sequential readers like video and speech decoders.
+ *
+ * Seeking outside of the current buffer discards it, and the data at the
+ * new position is read once the prefetched block turns out not to match.
+ *
+ * The parent stream is read from the worker thread, so it must not be used
+ * by anything else while it is wrapped. When the backend does not support
+ * threads, the wrapper reads the parent stream synchronously.
+ *
+ * It is safe to call this with a NULL parameter (in this case, NULL is
+ * returned).
+ *
+ * @param parentStream        The SeekableReadStream to wrap in a custom stream.
+ * @param bufSize             Size of each of the two buffers.
+ * @param disposeParentStream Flag indicating whether to dispose of the wrapped stream.
+ */
+SeekableReadStream *wrapPrefetchingSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream);
+
 /**
  * Take an arbitrary WriteStream and wrap it in a custom stream that
  * transparently provides buffering.
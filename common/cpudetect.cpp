@@ -0,0 +1,88 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/cpudetect.h"
+
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_AVX2)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace Common {
+
+static uint32 detectCpuFeatures() {
+	uint32 features = 0;
+
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_AVX2)
+#if defined(__GNUC__)
+	__builtin_cpu_init();
+#ifdef SCUMMVM_SSE2
+	if (__builtin_cpu_supports("sse2"))
+		features |= kCpuFeatureSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		features |= kCpuFeatureAVX2;
+#endif
+#elif defined(_MSC_VER)
+	int regs[4];
+	__cpuid(regs, 0);
+	const int maxLeaf = regs[0];
+
+	__cpuid(regs, 1);
+#ifdef SCUMMVM_SSE2
+	if (regs[3] & (1 << 26))
+		features |= kCpuFeatureSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	// AVX2 also needs the OS to save the YMM registers on context switches
+	const bool osxsave = (regs[2] & (1 << 27)) != 0;
+	if (maxLeaf >= 7 && osxsave && (_xgetbv(0) & 6) == 6) {
+		__cpuidex(regs, 7, 0);
+		if (regs[1] & (1 << 5))
+			features |= kCpuFeatureAVX2;
+	}
+#endif
+#endif
+#endif
+
+#ifdef SCUMMVM_NEON
+	// configure only enables NEON when the target baseline includes it
+	features |= kCpuFeatureNEON;
+#endif
+
+	return features;
+}
+
+static uint32 s_cpuFeatureMask = kCpuFeatureAll;
+
+bool hasCpuFeature(CpuFeature feature) {
+	static const uint32 detected = detectCpuFeatures();
+	return (detected & s_cpuFeatureMask & feature) != 0;
+}
+
+void setCpuFeatureMask(uint32 mask) {
+	s_cpuFeatureMask = mask;
+}
+
+} // End of namespace Common
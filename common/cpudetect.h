@@ -0,0 +1,73 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_CPUDETECT_H
+#define COMMON_CPUDETECT_H
+
+#include "common/scummsys.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_cpudetect CPU feature detection
+ * @ingroup common
+ *
+ * @brief API for selecting SIMD code paths at runtime.
+ *
+ * @{
+ */
+
+/**
+ * Instruction set extensions for which ScummVM carries optimized code
+ * paths. Code using them lives in separate translation units which are
+ * only built when configure detected compiler support (SCUMMVM_SSE2,
+ * SCUMMVM_AVX2, SCUMMVM_NEON).
+ */
+enum CpuFeature {
+	kCpuFeatureSSE2 = 1 << 0,
+	kCpuFeatureAVX2 = 1 << 1,
+	kCpuFeatureNEON = 1 << 2,
+
+	kCpuFeatureAll  = kCpuFeatureSSE2 | kCpuFeatureAVX2 | kCpuFeatureNEON
+};
+
+/**
+ * Check whether the given extension can be used: the code for it must
+ * have been compiled in, the host CPU has to support it and it must not
+ * have been masked out with setCpuFeatureMask().
+ */
+bool hasCpuFeature(CpuFeature feature);
+
+/**
+ * Restrict the reported CPU features to the given mask. This is mostly
+ * useful for forcing the generic code paths when debugging or comparing
+ * results. Code which already picked its implementation is not affected.
+ *
+ * @param mask  Combination of CpuFeature values, kCpuFeatureAll to reset.
+ */
+void setCpuFeatureMask(uint32 mask);
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
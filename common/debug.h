@@ -158,8 +158,9 @@ extern int gDebugLevel;
  */
 extern bool gDebugChannelsOnly;
 
-/** Global constant for EventRecorder debug channel. */
+/** Global constants for the debug channels of the EventRecorder and the video decoders. */
 enum GlobalDebugLevels {
+	kDebugLevelVideoDecoder = 1 << 29,
 	kDebugLevelEventRec = 1 << 30
 };
 
@@ -0,0 +1,621 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// The open addressing scheme in this file follows the control byte layout
+// popularized by the SwissTable hash tables, using plain linear probing.
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/endian.h"
+#include "common/hashmap.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_flathashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on an open addressing hash table.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in replacement for HashMap<Key,Val> which
+ * stores its nodes inline in a single array instead of allocating every node
+ * separately. Next to the node array, a control byte is kept for each slot,
+ * which either marks the slot as empty or erased, or holds seven bits of the
+ * hash of the key stored in it. Lookups scan the control bytes first and only
+ * compare keys whose hash fragment matches, so a probe rarely touches more
+ * than one cache line and never follows a pointer.
+ *
+ * The API is identical to the one of HashMap, including the same hash and
+ * equality functors, so users can switch between both by changing the type.
+ * As with HashMap, erasing an entry does not invalidate iterators pointing to
+ * other entries. However, any insertion of a new key may move all entries,
+ * so contrary to HashMap, neither iterators nor references to values may be
+ * kept across an insertion.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> FHM_t;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+	};
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// internal storage, including erased slots, may fill up before
+		// being rebuilt. Linear probing degrades quickly above 3/4.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 3,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 4
+	};
+
+	enum {
+		kCtrlEmpty = 0x80,   ///< Slot has never been used since the last rebuild.
+		kCtrlDeleted = 0xFE  ///< Slot held an entry that has been erased.
+		// Any value below 0x80 marks a used slot and holds the hash fragment.
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	byte *_ctrl;		///< Control byte for every slot.
+	Node *_storage;		///< Uninitialized memory for capacity nodes.
+	size_type _mask;	///< Capacity of the FlatHashMap minus one; capacity must be a power of two
+	size_type _size;
+	size_type _deleted;	///< Number of erased slots
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	/**
+	 * Spread the bits of the user supplied hash. Many hash functions used in
+	 * ScummVM return the key itself, which would leave the fragment stored in
+	 * the control byte all zeroes.
+	 */
+	static size_type mixHash(size_type hash) {
+		hash *= 0x9E3779B1;
+		return hash ^ (hash >> 15);
+	}
+
+	static byte hashFragment(size_type hash) {
+		return (byte)(hash >> 25);
+	}
+
+	static bool isUsed(byte ctrl) {
+		return (ctrl & 0x80) == 0;
+	}
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const FHM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	size_type findFreeSlot(size_type hash) const;
+	void expandStorage(size_type newCapacity);
+
+	template<class T> friend class IteratorImpl;
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(isUsed(_hashmap->_ctrl[_idx]));
+			return &_hashmap->_storage[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			_idx = _hashmap->nextUsed(_idx + 1);
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+	/**
+	 * Return the position of the lowest set bit in @p used, which has one
+	 * bit set at the top of every byte whose control byte marks a used slot.
+	 */
+	static size_type firstUsedInGroup(uint64 used) {
+#if defined(__GNUC__)
+		return __builtin_ctzll(used) >> 3;
+#else
+		size_type pos = 0;
+		while (!(used & 0x80)) {
+			used >>= 8;
+			pos++;
+		}
+		return pos;
+#endif
+	}
+
+	/** Return the index of the first used slot starting at @p idx, or -1 if there is none. */
+	size_type nextUsed(size_type idx) const {
+		// Look at the control bytes eight at a time. Used slots are rarely
+		// contiguous, so testing them one by one mostly mispredicts.
+		while (idx <= _mask) {
+			const size_type group = idx & ~7;
+			const uint64 used = (~READ_LE_UINT64(_ctrl + group) & 0x8080808080808080ULL) >> ((idx - group) * 8);
+			if (used)
+				return idx + firstUsedInGroup(used);
+			idx = group + 8;
+		}
+		return (size_type)-1;
+	}
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const FHM_t &map);
+	~FlatHashMap();
+
+	FHM_t &operator=(const FHM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		clear();
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const {
+		return lookup(key) != (size_type)-1;
+	}
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		return iterator(nextUsed(0), this);
+	}
+	iterator	end() {
+		return iterator((size_type)-1, this);
+	}
+
+	const_iterator	begin() const {
+		return const_iterator(nextUsed(0), this);
+	}
+	const_iterator	end() const {
+		return const_iterator((size_type)-1, this);
+	}
+
+	iterator	find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator	find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const FHM_t &map) :
+	_defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	clear();
+	freeStorage();
+}
+
+/**
+ * Internal method for allocating empty storage for @p capacity nodes.
+ *
+ * @note The previous storage is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	assert(capacity >= FLATHASHMAP_MIN_CAPACITY && (capacity & (capacity - 1)) == 0);
+	_mask = capacity - 1;
+	_ctrl = (byte *)malloc(capacity);
+	_storage = (Node *)malloc(capacity * sizeof(Node));
+	if (!_ctrl || !_storage)
+		::error("Common::FlatHashMap: failure to allocate %u bytes", capacity * (uint)(sizeof(Node) + 1));
+	memset(_ctrl, kCtrlEmpty, capacity);
+}
+
+/**
+ * Internal method for releasing the storage. All nodes must already have
+ * been destroyed.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	free(_storage);
+	free(_ctrl);
+	_storage = nullptr;
+	_ctrl = nullptr;
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note The previous storage is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const FHM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// The slot layout only depends on the hashes, so the other map can be
+	// copied slot by slot, including its erased slots.
+	memcpy(_ctrl, map._ctrl, _mask + 1);
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isUsed(_ctrl[ctr]))
+			new ((void *)&_storage[ctr]) Node(map._storage[ctr]);
+	}
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+/**
+ * Clear the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isUsed(_ctrl[ctr]))
+			_storage[ctr].~Node();
+	}
+
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	} else {
+		memset(_ctrl, kCtrlEmpty, _mask + 1);
+	}
+
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Internal method for finding an empty slot for a key with the given
+ * (mixed) @p hash. The key must not be in the map yet.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::findFreeSlot(size_type hash) const {
+	size_type ctr = hash & _mask;
+	while (isUsed(_ctrl[ctr]))
+		ctr = (ctr + 1) & _mask;
+	return ctr;
+}
+
+/**
+ * Internal method for rebuilding the storage with @p newCapacity slots.
+ * This also drops all erased slots.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::expandStorage(size_type newCapacity) {
+	assert(newCapacity > _size);
+
+	byte *oldCtrl = _ctrl;
+	Node *oldStorage = _storage;
+	const size_type oldMask = _mask;
+
+	allocStorage(newCapacity);
+
+	for (size_type ctr = 0; ctr <= oldMask; ++ctr) {
+		if (!isUsed(oldCtrl[ctr]))
+			continue;
+
+		const size_type hash = mixHash(_hash(oldStorage[ctr]._key));
+		const size_type idx = findFreeSlot(hash);
+		new ((void *)&_storage[idx]) Node(oldStorage[ctr]);
+		_ctrl[idx] = hashFragment(hash);
+		oldStorage[ctr].~Node();
+	}
+
+	_deleted = 0;
+
+	free(oldStorage);
+	free(oldCtrl);
+}
+
+/**
+ * Internal method for looking up a key. Returns the slot holding the key or
+ * -1 if the key is not contained in the map.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const size_type hash = mixHash(_hash(key));
+	const byte fragment = hashFragment(hash);
+	size_type ctr = hash & _mask;
+
+	// The load factor guarantees that there is always an empty slot
+	// terminating the probe sequence.
+	for (;;) {
+		const byte ctrl = _ctrl[ctr];
+		if (ctrl == kCtrlEmpty)
+			return (size_type)-1;
+		if (ctrl == fragment && _equal(_storage[ctr]._key, key))
+			return ctr;
+		ctr = (ctr + 1) & _mask;
+	}
+}
+
+/**
+ * Internal method for looking up a key and creating a default constructed
+ * value for it if it is not contained in the map yet.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	const size_type hash = mixHash(_hash(key));
+	const byte fragment = hashFragment(hash);
+	size_type ctr = hash & _mask;
+	size_type firstDeleted = (size_type)-1;
+
+	for (;;) {
+		const byte ctrl = _ctrl[ctr];
+		if (ctrl == kCtrlEmpty)
+			break;
+		if (ctrl == kCtrlDeleted) {
+			if (firstDeleted == (size_type)-1)
+				firstDeleted = ctr;
+		} else if (ctrl == fragment && _equal(_storage[ctr]._key, key)) {
+			return ctr;
+		}
+		ctr = (ctr + 1) & _mask;
+	}
+
+	if (firstDeleted != (size_type)-1) {
+		// Reusing an erased slot never lengthens a probe sequence.
+		ctr = firstDeleted;
+		_deleted--;
+	} else {
+		const size_type capacity = _mask + 1;
+		if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+			// Grow if the map is at least half full with live entries,
+			// otherwise rebuild in place to get rid of the erased slots.
+			expandStorage((_size + 1) * 2 > capacity ? capacity * 2 : capacity);
+			ctr = findFreeSlot(hash);
+		}
+	}
+
+	new ((void *)&_storage[ctr]) Node(key);
+	_ctrl[ctr] = fragment;
+	_size++;
+
+	return ctr;
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	// The lookup may reallocate the storage, so it has to happen first.
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return _storage[ctr]._value;
+}
+
+/**
+ * @overload
+ */
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _storage[ctr]._value;
+	else
+		unknownKeyError(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _storage[ctr]._value;
+	else
+		unknownKeyError(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _storage[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1) {
+		out = _storage[ctr]._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	_storage[ctr]._value = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	const size_type ctr = entry._idx;
+	assert(ctr <= _mask);
+	assert(isUsed(_ctrl[ctr]));
+
+	_storage[ctr].~Node();
+	_size--;
+
+	// If the next slot is empty, no probe sequence can continue past this
+	// slot, so it can be marked empty right away instead of erased.
+	if (_ctrl[(ctr + 1) & _mask] == kCtrlEmpty) {
+		_ctrl[ctr] = kCtrlEmpty;
+	} else {
+		_ctrl[ctr] = kCtrlDeleted;
+		_deleted++;
+	}
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		erase(iterator(ctr, this));
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
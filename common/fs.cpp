@@ -140,6 +140,21 @@ SeekableReadStream *FSNode::createReadStream() const {
 	return _realNode->createReadStream();
 }
 
+SeekableReadStream *FSNode::createMappedReadStream() const {
+	if (_realNode == nullptr)
+		return nullptr;
+
+	if (!_realNode->exists()) {
+		warning("FSNode::createMappedReadStream: '%s' does not exist", getName().c_str());
+		return nullptr;
+	} else if (_realNode->isDirectory()) {
+		warning("FSNode::createMappedReadStream: '%s' is a directory", getName().c_str());
+		return nullptr;
+	}
+
+	return _realNode->createMappedReadStream();
+}
+
 WriteStream *FSNode::createWriteStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -170,26 +185,26 @@ bool FSNode::createDirectory() const {
 
 FSDirectory::FSDirectory(const FSNode &node, int depth, bool flat, bool ignoreClashes, bool includeDirectories)
   : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-	_includeDirectories(includeDirectories) {
+	_includeDirectories(includeDirectories), _mapFiles(false) {
 }
 
 FSDirectory::FSDirectory(const String &prefix, const FSNode &node, int depth, bool flat,
                          bool ignoreClashes, bool includeDirectories)
   : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-    _includeDirectories(includeDirectories) {
+    _includeDirectories(includeDirectories), _mapFiles(false) {
 
 	setPrefix(prefix);
 }
 
 FSDirectory::FSDirectory(const String &name, int depth, bool flat, bool ignoreClashes, bool includeDirectories)
   : _node(name), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-    _includeDirectories(includeDirectories) {
+    _includeDirectories(includeDirectories), _mapFiles(false) {
 }
 
 FSDirectory::FSDirectory(const String &prefix, const String &name, int depth, bool flat,
                          bool ignoreClashes, bool includeDirectories)
   : _node(name), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-    _includeDirectories(includeDirectories) {
+    _includeDirectories(includeDirectories), _mapFiles(false) {
 
 	setPrefix(prefix);
 }
@@ -252,7 +267,7 @@ SeekableReadStream *FSDirectory::createReadStreamForMember(const String &name) c
 	FSNode *node = lookupCache(_fileCache, name);
 	if (!node)
 		return nullptr;
-	SeekableReadStream *stream = node->createReadStream();
+	SeekableReadStream *stream = _mapFiles ? node->createMappedReadStream() : node->createReadStream();
 	if (!stream)
 		warning("FSDirectory::createReadStreamForMember: Can't create stream for file '%s'", name.c_str());
 
@@ -272,7 +287,9 @@ FSDirectory *FSDirectory::getSubDirectory(const String &prefix, const String &na
 	if (!node)
 		return nullptr;
 
-	return new FSDirectory(prefix, *node, depth, flat, ignoreClashes);
+	FSDirectory *dir = new FSDirectory(prefix, *node, depth, flat, ignoreClashes);
+	dir->setMapFiles(_mapFiles);
+	return dir;
 }
 
 void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const String& prefix) const {
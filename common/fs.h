@@ -231,6 +231,15 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStream() const;
 
+	/**
+	 * Create a SeekableReadStream instance like createReadStream(), which
+	 * may be backed by a memory mapping of the file. Only use this for files
+	 * which are not written while the stream is in use, like game data.
+	 *
+	 * @return Pointer to the stream object, 0 in case of a failure.
+	 */
+	SeekableReadStream *createMappedReadStream() const;
+
 	/**
 	 * Create a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -299,6 +308,7 @@ class FSDirectory : public Archive {
 	bool _flat;
 	bool _ignoreClashes;
 	bool _includeDirectories;
+	bool _mapFiles;
 
 	String	_prefix; // string that is prepended to each cache item key
 	void setPrefix(const String &prefix);
@@ -351,6 +361,13 @@ public:
 	 */
 	FSNode getFSNode() const;
 
+	/**
+	 * Open files through FSNode::createMappedReadStream(), for directories
+	 * of files which are only read, like game data. Subdirectories inherit
+	 * this. Off by default.
+	 */
+	void setMapFiles(bool mapFiles) { _mapFiles = mapFiles; }
+
 	/**
 	 * Create a new FSDirectory pointing to a subdirectory of the instance.
 	 * @return A new FSDirectory instance.
@@ -26,7 +26,6 @@
 #define COMMON_HUFFMAN_H
 
 #include "common/array.h"
-#include "common/list.h"
 #include "common/types.h"
 
 namespace Common {
@@ -55,6 +54,9 @@ inline uint32 REVERSEBITS(uint32 x) {
 /**
  * Huffman bit stream decoding.
  *
+ * Codes are looked up in a table indexed by the next bits of the stream.
+ * Codes longer than the table continue in subtables indexed by the bits
+ * that follow, so that every symbol is found in a few table lookups.
  */
 template<class BITSTREAM>
 class Huffman {
@@ -72,30 +74,64 @@ public:
 	/** Return the next symbol in the bit stream. */
 	uint32 getSymbol(BITSTREAM &bits) const;
 
+	/**
+	 * Read count symbols from the bit stream, like calling getSymbol()
+	 * count times. The codes are looked up in 32 bits peeked at once,
+	 * which spares the bit stream most of its work.
+	 */
+	template<typename T>
+	void getSymbols(BITSTREAM &bits, T *symbols, uint32 count) const;
+
 private:
-	struct Symbol {
+	/** A code with its bits in the order they are read, from MSB to LSB. */
+	struct Code {
 		uint32 code;
 		uint32 symbol;
+		uint8  length;
 
-		Symbol(uint32 c, uint32 s) : code(c), symbol(s) {}
+		Code(uint32 c, uint32 s, uint8 l) : code(c), symbol(s), length(l) {}
 	};
 
-	typedef List<Symbol> CodeList;
-	typedef Array<CodeList> CodeLists;
+	typedef Array<Code> CodeArray;
 
-	/** Lists of codes and their symbols, sorted by code length. */
-	CodeLists _codes;
+	/** A code ending at this level of the tables, or the subtable of the codes continuing. */
+	struct TableEntry {
+		uint32 symbol;       ///< The symbol, or the index of the subtable.
+		uint8  length;       ///< Bits to skip at this level, 0xFF for unknown codes.
+		uint8  subtableBits; ///< Index size of the subtable, 0 for symbols.
 
-	/** Prefix lookup table used to speed up the decoding of short codes. */
-	struct PrefixEntry {
-		uint32 symbol;
-		uint8  length;
-
-		PrefixEntry() : length(0xFF) {}
+		TableEntry() : symbol(0), length(0xFF), subtableBits(0) {}
 	};
 
-	static const uint8 _prefixTableBits = 8;
-	PrefixEntry _prefixTable[1 << _prefixTableBits];
+	/** Index sizes of the main table and of the largest subtables. */
+	static const uint8 _mainTableBits = 9;
+	static const uint8 _subtableBits = 6;
+
+	/** The main table, followed by all subtables. */
+	Array<TableEntry> _table;
+
+	/** Fill the table at offset with codes, of which prefixLength bits lead to this table. */
+	void buildTable(uint32 offset, uint8 tableBits, const CodeArray &codes, uint8 prefixLength);
+
+	/** Return the table index for the bits, in the stream's bit order. */
+	static uint32 tableIndex(uint32 bits, uint8 length) {
+		return BITSTREAM::isMSB2LSB() ? bits : REVERSEBITS(bits) >> (32 - length);
+	}
+
+	/** Return the last count bits of a code. */
+	static uint32 lowBits(uint32 code, uint8 count) {
+		return count >= 32 ? code : code & ((1U << count) - 1);
+	}
+
+	/** Return the next n bits of a window filled by getSymbols(). */
+	static uint32 peekWindow(uint64 window, uint8 n) {
+		return BITSTREAM::isMSB2LSB() ? (uint32)(window >> (64 - n)) : (uint32)window & ((1U << n) - 1);
+	}
+
+	/** Drop the next n bits of a window filled by getSymbols(). */
+	static uint64 skipWindow(uint64 window, uint8 n) {
+		return BITSTREAM::isMSB2LSB() ? window << n : window >> n;
+	}
 };
 
 template <class BITSTREAM>
@@ -111,62 +147,132 @@ Huffman<BITSTREAM>::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *cod
 
 	assert(maxLength <= 32);
 
-	// Codes that do not fit in the prefix table are stored in the _codes array.
-	_codes.resize(MAX(maxLength - _prefixTableBits, 0));
+	CodeArray codeArray;
+	codeArray.reserve(codeCount);
 
 	for (uint i = 0; i < codeCount; i++) {
 		uint8 length = lengths[i];
+		if (length == 0)
+			continue;
 
 		// The symbol. If none was specified, assume it is identical to the code index.
 		uint32 symbol = symbols ? symbols[i] : i;
 
-		if (length <= _prefixTableBits) {
-			// Short codes go in the prefix lookup table. Set all the entries in the table
-			// with an index starting with the code to the symbol value.
-			uint32 startIndex;
-			if (BITSTREAM::isMSB2LSB()) {
-				startIndex = codes[i] << (_prefixTableBits - length);
-			} else {
-				startIndex = REVERSEBITS(codes[i]) >> (32 - _prefixTableBits);
-			}
+		// LSB2MSB streams hand out the first bit of a code in its LSB
+		uint32 code = BITSTREAM::isMSB2LSB() ? codes[i] : REVERSEBITS(codes[i]) >> (32 - length);
+		codeArray.push_back(Code(code, symbol, length));
+	}
 
-			uint32 endIndex = startIndex | ((1 << (_prefixTableBits - length)) - 1);
+	_table.resize(1 << _mainTableBits);
+	buildTable(0, _mainTableBits, codeArray, 0);
+}
 
-			for (uint32 j = startIndex; j <= endIndex; j++) {
-				uint32 index = BITSTREAM::isMSB2LSB() ? j : REVERSEBITS(j) >> (32 - _prefixTableBits);
-				_prefixTable[index].symbol = symbol;
-				_prefixTable[index].length = length;
+template <class BITSTREAM>
+void Huffman<BITSTREAM>::buildTable(uint32 offset, uint8 tableBits, const CodeArray &codes, uint8 prefixLength) {
+	// The longest rest of the codes continuing in each subtable
+	Array<uint8> subtableLengths(1 << tableBits, 0);
+
+	for (typename CodeArray::const_iterator c = codes.begin(); c != codes.end(); ++c) {
+		const uint8 length = c->length - prefixLength;
+		const uint32 code = lowBits(c->code, length);
+
+		if (length <= tableBits) {
+			// Set all the entries with an index starting with the code
+			const uint32 start = code << (tableBits - length);
+			const uint32 end = start | ((1 << (tableBits - length)) - 1);
+
+			for (uint32 j = start; j <= end; j++) {
+				TableEntry &entry = _table[offset + tableIndex(j, tableBits)];
+				entry.symbol = c->symbol;
+				entry.length = length;
 			}
 		} else {
-			// Put the code and symbol into the correct list for the length.
-			_codes[lengths[i] - 1 - _prefixTableBits].push_back(Symbol(codes[i], symbol));
+			uint8 &subtableLength = subtableLengths[code >> (length - tableBits)];
+			subtableLength = MAX<uint8>(subtableLength, length - tableBits);
 		}
 	}
+
+	for (uint32 j = 0; j < subtableLengths.size(); j++) {
+		if (!subtableLengths[j])
+			continue;
+
+		CodeArray subtableCodes;
+		for (typename CodeArray::const_iterator c = codes.begin(); c != codes.end(); ++c) {
+			const uint8 length = c->length - prefixLength;
+			if (length > tableBits && (lowBits(c->code, length) >> (length - tableBits)) == j)
+				subtableCodes.push_back(*c);
+		}
+
+		const uint8 subtableBits = MIN(subtableLengths[j], _subtableBits);
+		const uint32 subtableOffset = _table.size();
+		_table.resize(subtableOffset + (1 << subtableBits));
+
+		TableEntry &entry = _table[offset + tableIndex(j, tableBits)];
+		entry.symbol = subtableOffset;
+		entry.length = tableBits;
+		entry.subtableBits = subtableBits;
+
+		buildTable(subtableOffset, subtableBits, subtableCodes, prefixLength + tableBits);
+	}
 }
 
 template <class BITSTREAM>
 uint32 Huffman<BITSTREAM>::getSymbol(BITSTREAM &bits) const {
-	uint32 code = bits.peekBits(_prefixTableBits);
+	const TableEntry *table = _table.data();
+	const TableEntry *entry = &table[bits.peekBits(_mainTableBits)];
 
-	uint8 length = _prefixTable[code].length;
+	while (entry->subtableBits) {
+		bits.skip(entry->length);
+		entry = &table[entry->symbol + bits.peekBits(entry->subtableBits)];
+	}
+
+	if (entry->length == 0xFF)
+		error("Unknown Huffman code");
 
-	if (length != 0xFF) {
-		bits.skip(length);
-		return _prefixTable[code].symbol;
-	} else {
-		bits.skip(_prefixTableBits);
+	bits.skip(entry->length);
+	return entry->symbol;
+}
 
-		for (uint32 i = 0; i < _codes.size(); i++) {
-			bits.addBit(code, i + _prefixTableBits);
+template <class BITSTREAM>
+template<typename T>
+void Huffman<BITSTREAM>::getSymbols(BITSTREAM &bits, T *symbols, uint32 count) const {
+	const TableEntry *table = _table.data();
+
+	while (count > 0) {
+		// Indices reaching past the peeked bits see zeros, which does not
+		// matter as long as the entry found ends inside of them
+		uint64 window = bits.peekBits(32);
+		if (BITSTREAM::isMSB2LSB())
+			window <<= 32;
+		uint32 used = 0;
+
+		while (count > 0) {
+			const TableEntry *entry = &table[peekWindow(window, _mainTableBits)];
+			uint32 length = used + entry->length;
+
+			while (entry->subtableBits && length <= 32) {
+				window = skipWindow(window, entry->length);
+				entry = &table[entry->symbol + peekWindow(window, entry->subtableBits)];
+				length += entry->length;
+			}
 
-			for (typename CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-				if (code == cCode->code)
-					return cCode->symbol;
+			if (entry->subtableBits || length > 32)
+				break;
+
+			window = skipWindow(window, entry->length);
+			used = length;
+			*symbols++ = entry->symbol;
+			count--;
 		}
-	}
 
-	error("Unknown Huffman code");
-	return 0;
+		if (used) {
+			bits.skip(used);
+		} else if (count > 0) {
+			// Unknown codes, or the stream ends in the middle of a code
+			*symbols++ = getSymbol(bits);
+			count--;
+		}
+	}
 }
 
 /** @} */
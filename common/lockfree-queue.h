@@ -0,0 +1,140 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_LOCKFREE_QUEUE_H
+#define COMMON_LOCKFREE_QUEUE_H
+
+#include "common/atomic.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_lockfree_queue Lock-free queue
+ * @ingroup common
+ *
+ * @brief Unbounded queue for passing values between two threads.
+ *
+ * @{
+ */
+
+/**
+ * Unbounded single producer, single consumer queue which needs no lock.
+ *
+ * Exactly one thread at a time may push() and exactly one thread at a time
+ * may pop(); callers with several producers have to serialize them. Nodes
+ * which the consumer is done with are recycled by the producer, so after a
+ * warm-up phase neither side allocates memory. A producer which never has
+ * more values queued than were reserved up front never allocates at all.
+ */
+template<class T>
+class LockFreeQueue : NonCopyable {
+private:
+	struct Node {
+		Node *next;
+		T value;
+	};
+
+	// Consumer side: _head is a dummy whose successor is the next value
+	Node *_head;
+
+	// Producer side: _first.._headCopy are nodes ready for reuse
+	Node *_tail;
+	Node *_first;
+	Node *_headCopy;
+
+	Node *allocNode() {
+		if (_first == _headCopy)
+			_headCopy = atomicLoad(&_head);
+
+		if (_first != _headCopy) {
+			Node *node = _first;
+			_first = _first->next;
+			return node;
+		}
+
+		return new Node();
+	}
+
+public:
+	/**
+	 * @param reserved	Number of nodes to allocate up front, ready for
+	 *					the producer to use.
+	 */
+	explicit LockFreeQueue(uint reserved = 0) {
+		Node *node = new Node();
+		node->next = nullptr;
+		_head = _tail = _headCopy = node;
+
+		// Free nodes are the ones in front of the consumer's dummy
+		for (uint i = 0; i < reserved; i++) {
+			Node *free = new Node();
+			free->next = node;
+			node = free;
+		}
+		_first = node;
+	}
+
+	~LockFreeQueue() {
+		Node *node = _first;
+		while (node) {
+			Node *next = node->next;
+			delete node;
+			node = next;
+		}
+	}
+
+	/** Append a value. Must only be called from the producer thread. */
+	void push(const T &value) {
+		Node *node = allocNode();
+		node->next = nullptr;
+		node->value = value;
+		atomicStore(&_tail->next, node);
+		_tail = node;
+	}
+
+	/**
+	 * Remove the oldest value. Must only be called from the consumer thread.
+	 *
+	 * @return false if the queue was empty.
+	 */
+	bool pop(T &value) {
+		Node *next = atomicLoad(&_head->next);
+		if (!next)
+			return false;
+
+		value = next->value;
+		atomicStore(&_head, next);
+		return true;
+	}
+
+	/** Check for pending values. Must only be called from the consumer thread. */
+	bool empty() const {
+		return atomicLoad(&_head->next) == nullptr;
+	}
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
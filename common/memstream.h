@@ -23,6 +23,7 @@
 #ifndef COMMON_MEMSTREAM_H
 #define COMMON_MEMSTREAM_H
 
+#include "common/ptr.h"
 #include "common/stream.h"
 #include "common/types.h"
 #include "common/util.h"
@@ -42,7 +43,7 @@ namespace Common {
  * a plain memory block.
  */
 class MemoryReadStream : virtual public SeekableReadStream {
-private:
+protected:
 	const byte * const _ptrOrig;
 	const byte *_ptr;
 	const uint32 _size;
@@ -81,6 +82,31 @@ public:
 	bool seek(int32 offs, int whence = SEEK_SET);
 };
 
+/**
+ * A MemoryReadStream over a block of memory which is shared with other
+ * streams, for example a file mapped into memory. The block is released
+ * through the deleter of the shared pointer when the last stream using it
+ * is destroyed.
+ *
+ * readStream() does not copy any data, the returned streams point into
+ * the same block.
+ */
+class SharedMemoryReadStream : public MemoryReadStream {
+private:
+	SharedPtr<const byte> _memory;
+
+public:
+	/**
+	 * Wrap dataSize bytes at dataPtr, which must lie inside the block
+	 * referenced by memory.
+	 */
+	SharedMemoryReadStream(const SharedPtr<const byte> &memory, const byte *dataPtr, uint32 dataSize) :
+		MemoryReadStream(dataPtr, dataSize),
+		_memory(memory) {}
+
+	SeekableReadStream *readStream(uint32 dataSize) override;
+};
+
 
 /**
  * This is a MemoryReadStream subclass which adds non-endian
@@ -6,6 +6,7 @@ MODULE_OBJS := \
 	base-str.o \
 	config-manager.o \
 	coroutines.o \
+	cpudetect.o \
 	dcl.o \
 	debug.o \
 	error.o \
@@ -51,6 +52,7 @@ MODULE_OBJS := \
 	winexe.o \
 	winexe_ne.o \
 	winexe_pe.o \
+	workerpool.o \
 	xmlparser.o \
 	zlib.o
 
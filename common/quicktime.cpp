@@ -172,6 +172,16 @@ void QuickTimeParser::initParseTable() {
 	_parseTable = p;
 }
 
+void QuickTimeParser::readUint32BETable(uint32 *table, uint32 count) {
+	// Sample tables can have an entry for each frame, read them in one go
+	// rather than value by value
+	const uint32 bytes = _fd->read(table, count * sizeof(uint32));
+	memset((byte *)table + bytes, 0, count * sizeof(uint32) - bytes);
+
+	for (uint32 i = 0; i < count; i++)
+		table[i] = FROM_BE_32(table[i]);
+}
+
 int QuickTimeParser::readDefault(Atom atom) {
 	uint32 total_size = 0;
 	Atom a;
@@ -575,13 +585,24 @@ int QuickTimeParser::readSTSC(Atom atom) {
 	if (!track->sampleToChunk)
 		return -1;
 
+	uint32 *table = new uint32[track->sampleToChunkCount * 3];
+	readUint32BETable(table, track->sampleToChunkCount * 3);
+
+	uint32 firstSample = 0;
 	for (uint32 i = 0; i < track->sampleToChunkCount; i++) {
-		track->sampleToChunk[i].first = _fd->readUint32BE() - 1;
-		track->sampleToChunk[i].count = _fd->readUint32BE();
-		track->sampleToChunk[i].id = _fd->readUint32BE();
+		track->sampleToChunk[i].first = table[i * 3] - 1;
+		track->sampleToChunk[i].count = table[i * 3 + 1];
+		track->sampleToChunk[i].id = table[i * 3 + 2];
+
+		// Index the samples, so that chunks can be found without counting
+		// the samples of the chunks before them
+		if (i > 0)
+			firstSample += (track->sampleToChunk[i].first - track->sampleToChunk[i - 1].first) * track->sampleToChunk[i - 1].count;
+		track->sampleToChunk[i].firstSample = firstSample;
 		//warning("Sample to Chunk[%d]: First = %d, Count = %d", i, track->sampleToChunk[i].first, track->sampleToChunk[i].count);
 	}
 
+	delete[] table;
 	return 0;
 }
 
@@ -600,11 +621,10 @@ int QuickTimeParser::readSTSS(Atom atom) {
 	if (!track->keyframes)
 		return -1;
 
-	for (uint32 i = 0; i < track->keyframeCount; i++) {
-		track->keyframes[i] = _fd->readUint32BE() - 1; // Adjust here, the frames are based on 1
-		debug(6, "keyframes[%d] = %d", i, track->keyframes[i]);
+	readUint32BETable(track->keyframes, track->keyframeCount);
+	for (uint32 i = 0; i < track->keyframeCount; i++)
+		track->keyframes[i]--; // Adjust here, the frames are based on 1
 
-	}
 	return 0;
 }
 
@@ -627,11 +647,7 @@ int QuickTimeParser::readSTSZ(Atom atom) {
 	if (!track->sampleSizes)
 		return -1;
 
-	for(uint32 i = 0; i < track->sampleCount; i++) {
-		track->sampleSizes[i] = _fd->readUint32BE();
-		debug(6, "sampleSizes[%d] = %d", i, track->sampleSizes[i]);
-	}
-
+	readUint32BETable(track->sampleSizes, track->sampleCount);
 	return 0;
 }
 
@@ -647,15 +663,23 @@ int QuickTimeParser::readSTTS(Atom atom) {
 
 	debug(0, "track[%d].stts.entries = %d", _tracks.size() - 1, track->timeToSampleCount);
 
+	uint32 *table = new uint32[track->timeToSampleCount * 2];
+	readUint32BETable(table, track->timeToSampleCount * 2);
+
+	uint32 totalDuration = 0;
 	for (int32 i = 0; i < track->timeToSampleCount; i++) {
-		track->timeToSample[i].count = _fd->readUint32BE();
-		track->timeToSample[i].duration = _fd->readUint32BE();
+		track->timeToSample[i].count = table[i * 2];
+		track->timeToSample[i].duration = table[i * 2 + 1];
+		track->timeToSample[i].firstSample = totalSampleCount;
+		track->timeToSample[i].startTime = totalDuration;
 
 		debug(1, "\tCount = %d, Duration = %d", track->timeToSample[i].count, track->timeToSample[i].duration);
 
 		totalSampleCount += track->timeToSample[i].count;
+		totalDuration += track->timeToSample[i].count * track->timeToSample[i].duration;
 	}
 
+	delete[] table;
 	track->frameCount = totalSampleCount;
 	return 0;
 }
@@ -672,11 +696,12 @@ int QuickTimeParser::readSTCO(Atom atom) {
 	if (!track->chunkOffsets)
 		return -1;
 
+	readUint32BETable(track->chunkOffsets, track->chunkCount);
 	for (uint32 i = 0; i < track->chunkCount; i++) {
 		// WORKAROUND/HACK: The offsets in Riven videos (ones inside the Mohawk archives themselves)
 		// have offsets relative to the archive and not the video. This is quite nasty. We subtract
 		// the initial offset of the stream to get the correct value inside of the stream.
-		track->chunkOffsets[i] = _fd->readUint32BE() - _beginOffset;
+		track->chunkOffsets[i] -= _beginOffset;
 	}
 
 	return 0;
@@ -852,4 +877,119 @@ QuickTimeParser::Track::~Track() {
 		delete sampleDescs[i];
 }
 
+uint32 QuickTimeParser::Track::getChunkSampleCount(uint32 chunk) const {
+	return getChunkFirstSample(chunk + 1) - getChunkFirstSample(chunk);
+}
+
+uint32 QuickTimeParser::Track::getChunkFirstSample(uint32 chunk) const {
+	// Find the last entry starting at or before the chunk
+	uint32 low = 0, high = sampleToChunkCount;
+	while (low < high) {
+		const uint32 mid = (low + high) / 2;
+		if (sampleToChunk[mid].first <= chunk)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if (!low)
+		return 0;
+
+	const SampleToChunkEntry &entry = sampleToChunk[low - 1];
+	return entry.firstSample + (chunk - entry.first) * entry.count;
+}
+
+int32 QuickTimeParser::Track::findSampleChunk(uint32 sample, uint32 &sampleInChunk, uint32 &descId) const {
+	// Find the last entry whose first sample is at or before the sample
+	uint32 low = 0, high = sampleToChunkCount;
+	while (low < high) {
+		const uint32 mid = (low + high) / 2;
+		if (sampleToChunk[mid].firstSample <= sample)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if (!low || !sampleToChunk[low - 1].count)
+		return -1;
+
+	const SampleToChunkEntry &entry = sampleToChunk[low - 1];
+	const uint32 chunk = entry.first + (sample - entry.firstSample) / entry.count;
+	if (chunk >= chunkCount)
+		return -1;
+
+	sampleInChunk = (sample - entry.firstSample) % entry.count;
+	descId = entry.id;
+	return chunk;
+}
+
+int32 QuickTimeParser::Track::findTimeToSample(uint32 sample) const {
+	uint32 low = 0, high = timeToSampleCount;
+	while (low < high) {
+		const uint32 mid = (low + high) / 2;
+		if (timeToSample[mid].firstSample <= sample)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if (!low || sample >= timeToSample[low - 1].firstSample + timeToSample[low - 1].count)
+		return -1;
+
+	return low - 1;
+}
+
+uint32 QuickTimeParser::Track::getSampleTime(uint32 sample) const {
+	const int32 index = findTimeToSample(sample);
+
+	if (index < 0) {
+		if (!timeToSampleCount)
+			return 0;
+
+		const TimeToSampleEntry &last = timeToSample[timeToSampleCount - 1];
+		return last.startTime + last.count * last.duration;
+	}
+
+	const TimeToSampleEntry &entry = timeToSample[index];
+	return entry.startTime + (sample - entry.firstSample) * entry.duration;
+}
+
+uint32 QuickTimeParser::Track::findSampleAtTime(uint32 time, uint32 &sampleTime) const {
+	// Find the first entry ending after the time
+	uint32 low = 0, high = timeToSampleCount;
+	while (low < high) {
+		const uint32 mid = (low + high) / 2;
+		if (timeToSample[mid].startTime + timeToSample[mid].count * timeToSample[mid].duration <= time)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if (low == (uint32)timeToSampleCount) {
+		sampleTime = getSampleTime(frameCount);
+		return frameCount;
+	}
+
+	// An entry ending after the time has a non-zero duration
+	const TimeToSampleEntry &entry = timeToSample[low];
+	const uint32 offset = (time - entry.startTime) / entry.duration;
+	sampleTime = entry.startTime + offset * entry.duration;
+	return entry.firstSample + offset;
+}
+
+uint32 QuickTimeParser::Track::findKeyframe(uint32 sample) const {
+	// Find the last keyframe at or before the sample
+	uint32 low = 0, high = keyframeCount;
+	while (low < high) {
+		const uint32 mid = (low + high) / 2;
+		if (keyframes[mid] <= sample)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	// If none found, we'll assume the requested sample is a keyframe
+	return low ? keyframes[low - 1] : sample;
+}
+
 } // End of namespace Video
@@ -93,12 +93,15 @@ protected:
 	struct TimeToSampleEntry {
 		int count;
 		int duration;
+		uint32 firstSample; ///< Index of the first sample of the entry
+		uint32 startTime;   ///< Media time of the first sample of the entry
 	};
 
 	struct SampleToChunkEntry {
 		uint32 first;
 		uint32 count;
 		uint32 id;
+		uint32 firstSample; ///< Index of the first sample in chunk 'first'
 	};
 
 	struct EditListEntry {
@@ -163,6 +166,41 @@ protected:
 		uint32 startTime;
 		Rational scaleFactorX;
 		Rational scaleFactorY;
+
+		// The lookups below binary search the run-length coded sample
+		// tables, without expanding them to one entry per sample.
+
+		/** Get the number of samples in a chunk. */
+		uint32 getChunkSampleCount(uint32 chunk) const;
+
+		/** Get the index of the first sample of a chunk. */
+		uint32 getChunkFirstSample(uint32 chunk) const;
+
+		/**
+		 * Find the chunk holding a sample.
+		 * @param sample        the sample to look for
+		 * @param sampleInChunk set to the position of the sample in the chunk
+		 * @param descId        set to the sample description of the chunk
+		 * @return the chunk, or -1 if the sample is not in any chunk
+		 */
+		int32 findSampleChunk(uint32 sample, uint32 &sampleInChunk, uint32 &descId) const;
+
+		/** Find the time-to-sample entry holding a sample, or -1 past the last one. */
+		int32 findTimeToSample(uint32 sample) const;
+
+		/** Get the media time at which a sample starts, or the media duration past the last sample. */
+		uint32 getSampleTime(uint32 sample) const;
+
+		/**
+		 * Find the sample playing at a media time.
+		 * @param time       the media time
+		 * @param sampleTime set to the media time at which the sample starts
+		 * @return the sample, or the sample count past the last sample
+		 */
+		uint32 findSampleAtTime(uint32 time, uint32 &sampleTime) const;
+
+		/** Find the last keyframe up to a sample, the sample itself if there is none. */
+		uint32 findKeyframe(uint32 sample) const;
 	};
 
 	virtual SampleDesc *readSampleDesc(Track *track, uint32 format, uint32 descSize) = 0;
@@ -194,6 +232,7 @@ private:
 	bool _foundMOOV;
 
 	void initParseTable();
+	void readUint32BETable(uint32 *table, uint32 count);
 
 	int readDefault(Atom atom);
 	int readLeaf(Atom atom);
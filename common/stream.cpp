@@ -25,6 +25,7 @@
 #include "common/memstream.h"
 #include "common/substream.h"
 #include "common/str.h"
+#include "common/system.h"
 
 namespace Common {
 
@@ -127,6 +128,19 @@ bool MemoryReadStream::seek(int32 offs, int whence) {
 	return true; // FIXME: STREAM REWRITE
 }
 
+SeekableReadStream *SharedMemoryReadStream::readStream(uint32 dataSize) {
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	SeekableReadStream *stream = new SharedMemoryReadStream(_memory, _ptr, dataSize);
+	_ptr += dataSize;
+	_pos += dataSize;
+
+	return stream;
+}
+
 #pragma mark -
 
 enum {
@@ -225,6 +239,20 @@ uint32 SubReadStream::read(void *dataPtr, uint32 dataSize) {
 	return dataSize;
 }
 
+SeekableReadStream *SubReadStream::readStream(uint32 dataSize) {
+	if (dataSize > _end - _pos) {
+		dataSize = _end - _pos;
+		_eos = true;
+	}
+
+	// Let the parent stream create the stream, so that it can avoid copying
+	// data it already has in memory
+	SeekableReadStream *stream = _parentStream->readStream(dataSize);
+	_pos += stream->size();
+
+	return stream;
+}
+
 SeekableSubReadStream::SeekableSubReadStream(SeekableReadStream *parentStream, uint32 begin, uint32 end, DisposeAfterUse::Flag disposeParentStream)
 	: SubReadStream(parentStream, end, disposeParentStream),
 	_parentStream(parentStream),
@@ -268,6 +296,13 @@ uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	return SeekableSubReadStream::read(dataPtr, dataSize);
 }
 
+SeekableReadStream *SafeSeekableSubReadStream::readStream(uint32 dataSize) {
+	// Make sure the parent stream is at the right position
+	seek(0, SEEK_CUR);
+
+	return SeekableSubReadStream::readStream(dataSize);
+}
+
 void SeekableReadStream::hexdump(int len, int bytesPerLine, int startOffset) {
 	uint pos_ = pos();
 	uint size_ = size();
@@ -473,6 +508,245 @@ SeekableReadStream *wrapBufferedSeekableReadStream(SeekableReadStream *parentStr
 
 namespace {
 
+/**
+ * Wrapper class which reads a SeekableReadStream ahead on a worker thread.
+ * While the reader consumes one buffer, the worker fills the other one with
+ * the following block of the parent stream.
+ *
+ * Only one thread uses the parent stream at a time: the worker while a block
+ * is pending, the reader otherwise. The semaphores order the accesses.
+ */
+class PrefetchingSeekableReadStream : public SeekableReadStream {
+protected:
+	DisposablePtr<SeekableReadStream> _parentStream;
+	const uint32 _realBufSize;
+	const int32 _size;
+
+	// The block being read
+	byte *_buf;
+	int32 _bufStart;
+	uint32 _bufSize;
+	uint32 _pos;
+	bool _eos;
+	bool _err;
+
+	// The block read ahead, _nextStart is -1 when there is none
+	byte *_nextBuf;
+	int32 _nextStart;
+	uint32 _nextSize;
+	bool _nextErr;
+	bool _pending;
+
+	OSystem::ThreadRef _thread;
+	OSystem::SemaphoreRef _request;
+	OSystem::SemaphoreRef _ready;
+	bool _quit;
+
+	static void workerEntry(void *param);
+	void readBlock(byte *buf, int32 start, uint32 &size, bool &err);
+	void requestBlock(int32 start);
+	void waitBlock();
+	bool fillBuffer();
+
+public:
+	PrefetchingSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream);
+	virtual ~PrefetchingSeekableReadStream();
+
+	virtual bool eos() const { return _eos; }
+	virtual bool err() const { return _err; }
+	virtual void clearErr();
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize);
+
+	virtual int32 pos() const { return _bufStart + _pos; }
+	virtual int32 size() const { return _size; }
+	virtual bool seek(int32 offset, int whence = SEEK_SET);
+};
+
+PrefetchingSeekableReadStream::PrefetchingSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream)
+	: _parentStream(parentStream, disposeParentStream),
+	_realBufSize(bufSize),
+	_size(parentStream->size()),
+	_bufStart(parentStream->pos()),
+	_bufSize(0),
+	_pos(0),
+	_eos(false),
+	_err(false),
+	_nextStart(-1),
+	_nextSize(0),
+	_nextErr(false),
+	_pending(false),
+	_thread(nullptr),
+	_request(nullptr),
+	_ready(nullptr),
+	_quit(false) {
+
+	_buf = new byte[bufSize];
+	_nextBuf = new byte[bufSize];
+
+	if (g_system) {
+		_request = g_system->createSemaphore(0);
+		_ready = g_system->createSemaphore(0);
+		if (_request && _ready)
+			_thread = g_system->createThread(workerEntry, this);
+	}
+
+	requestBlock(_bufStart);
+}
+
+PrefetchingSeekableReadStream::~PrefetchingSeekableReadStream() {
+	waitBlock();
+
+	if (_thread) {
+		_quit = true;
+		g_system->postSemaphore(_request);
+		g_system->joinThread(_thread);
+	}
+	if (_request)
+		g_system->deleteSemaphore(_request);
+	if (_ready)
+		g_system->deleteSemaphore(_ready);
+
+	delete[] _buf;
+	delete[] _nextBuf;
+}
+
+void PrefetchingSeekableReadStream::workerEntry(void *param) {
+	PrefetchingSeekableReadStream *stream = (PrefetchingSeekableReadStream *)param;
+
+	while (true) {
+		g_system->waitSemaphore(stream->_request);
+		if (stream->_quit)
+			break;
+		stream->readBlock(stream->_nextBuf, stream->_nextStart, stream->_nextSize, stream->_nextErr);
+		g_system->postSemaphore(stream->_ready);
+	}
+}
+
+void PrefetchingSeekableReadStream::readBlock(byte *buf, int32 start, uint32 &size, bool &err) {
+	if (_parentStream->pos() != start)
+		_parentStream->seek(start);
+	size = _parentStream->read(buf, _realBufSize);
+	err = _parentStream->err();
+}
+
+void PrefetchingSeekableReadStream::requestBlock(int32 start) {
+	if (!_thread || start >= _size)
+		return;
+
+	_nextStart = start;
+	_pending = true;
+	g_system->postSemaphore(_request);
+}
+
+void PrefetchingSeekableReadStream::waitBlock() {
+	if (_pending) {
+		g_system->waitSemaphore(_ready);
+		_pending = false;
+	}
+}
+
+bool PrefetchingSeekableReadStream::fillBuffer() {
+	const int32 start = _bufStart + _bufSize;
+	if (start >= _size)
+		return false;
+
+	waitBlock();
+
+	if (_nextStart == start) {
+		SWAP(_buf, _nextBuf);
+		_bufSize = _nextSize;
+		_err |= _nextErr;
+		_nextStart = -1;
+	} else {
+		// There was a seek, or the reader is faster than the worker
+		bool err;
+		readBlock(_buf, start, _bufSize, err);
+		_err |= err;
+	}
+
+	_bufStart = start;
+	_pos = 0;
+
+	// A short block means the end of the parent stream, or an error
+	if (_bufSize == _realBufSize)
+		requestBlock(start + _bufSize);
+
+	return _bufSize > 0;
+}
+
+void PrefetchingSeekableReadStream::clearErr() {
+	waitBlock();
+	_parentStream->clearErr();
+	_eos = false;
+	_err = false;
+}
+
+uint32 PrefetchingSeekableReadStream::read(void *dataPtr, uint32 dataSize) {
+	uint32 alreadyRead = 0;
+
+	while (dataSize > 0) {
+		if (_pos == _bufSize && !fillBuffer()) {
+			_eos = true;
+			break;
+		}
+
+		const uint32 n = MIN(dataSize, _bufSize - _pos);
+		memcpy(dataPtr, _buf + _pos, n);
+		_pos += n;
+		alreadyRead += n;
+		dataPtr = (byte *)dataPtr + n;
+		dataSize -= n;
+	}
+
+	return alreadyRead;
+}
+
+bool PrefetchingSeekableReadStream::seek(int32 offset, int whence) {
+	int32 newPos;
+	switch (whence) {
+	case SEEK_END:
+		newPos = _size + offset;
+		break;
+	case SEEK_CUR:
+		newPos = pos() + offset;
+		break;
+	case SEEK_SET:
+	default:
+		newPos = offset;
+		break;
+	}
+
+	if (newPos < 0 || newPos > _size)
+		return false;
+
+	_eos = false;
+
+	if (newPos >= _bufStart && newPos <= _bufStart + (int32)_bufSize) {
+		_pos = newPos - _bufStart;
+	} else {
+		// Drop the buffer. The block read ahead is kept, in case it
+		// happens to start at the new position.
+		_bufStart = newPos;
+		_bufSize = 0;
+		_pos = 0;
+	}
+
+	return true;
+}
+
+} // End of anonymous namespace
+
+SeekableReadStream *wrapPrefetchingSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream) {
+	if (parentStream)
+		return new PrefetchingSeekableReadStream(parentStream, bufSize, disposeParentStream);
+	return nullptr;
+}
+
+#pragma mark -
+
+namespace {
+
 /**
  * Wrapper class which adds buffering to any WriteStream.
  */
@@ -634,8 +634,11 @@ public:
 	 * if reading more data failed. This is because of an I/O error or because
 	 * the end of the stream was reached. It can be determined by
 	 * calling err() and eos().
+	 *
+	 * Streams which already hold their data in memory may return a stream
+	 * pointing to that memory instead of copying it.
 	 */
-	SeekableReadStream *readStream(uint32 dataSize);
+	virtual SeekableReadStream *readStream(uint32 dataSize);
 
 	/**
 	 * Reads in a terminated string. Upon successful completion,
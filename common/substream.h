@@ -45,6 +45,9 @@ namespace Common {
  * Manipulating the parent stream directly /will/ mess up a substream.
  * Likewise, manipulating two substreams of a parent stream will cause them to
  * step on each others toes.
+ *
+ * readStream() is forwarded to the parent stream rather than implemented with
+ * read(), so subclasses which override read() must also override readStream().
  */
 class SubReadStream : virtual public ReadStream {
 protected:
@@ -65,6 +68,7 @@ public:
 	virtual bool err() const { return _parentStream->err(); }
 	virtual void clearErr() { _eos = false; _parentStream->clearErr(); }
 	virtual uint32 read(void *dataPtr, uint32 dataSize);
+	virtual SeekableReadStream *readStream(uint32 dataSize);
 };
 
 /*
@@ -123,6 +127,10 @@ public:
  *
  * Note that this stream is *not* threading safe. Calling read from the audio
  * thread and from the main thread might mess up the data retrieved.
+ *
+ * readStream() does not go through read(), it lets the parent stream create
+ * the stream. Subclasses which override read(), for example to take a lock,
+ * must override readStream() the same way.
  */
 class SafeSeekableSubReadStream : public SeekableSubReadStream {
 public:
@@ -131,6 +139,7 @@ public:
 	}
 
 	virtual uint32 read(void *dataPtr, uint32 dataSize);
+	virtual SeekableReadStream *readStream(uint32 dataSize);
 };
 
 /** @} */
@@ -1417,6 +1417,66 @@ public:
 
 	/** @} */
 
+	/**
+	 * @defgroup common_system_thread Worker threads
+	 * @ingroup common_system
+	 * @{
+	 *
+	 * Engines and subsystems must keep working when no threads are
+	 * available, so these methods are optional: the defaults report a
+	 * single CPU and fail to create threads and semaphores. Code using
+	 * them (see Common::WorkerPool) then falls back to doing the work on
+	 * the calling thread.
+	 *
+	 * Worker threads must not call into OSystem other than through the
+	 * mutex and semaphore methods.
+	 */
+
+	typedef struct OpaqueThread *ThreadRef;
+	typedef struct OpaqueSemaphore *SemaphoreRef;
+	typedef void (*ThreadProc)(void *param);
+
+	/**
+	 * Return the number of CPUs available to run worker threads.
+	 */
+	virtual uint getCpuCount() { return 1; }
+
+	/**
+	 * Start a new thread running @p proc.
+	 *
+	 * @return The new thread, or 0 if threads are not supported.
+	 */
+	virtual ThreadRef createThread(ThreadProc proc, void *param) { return nullptr; }
+
+	/**
+	 * Wait for the given thread to finish and release it.
+	 */
+	virtual void joinThread(ThreadRef thread) {}
+
+	/**
+	 * Create a counting semaphore.
+	 *
+	 * @return The newly created semaphore, or 0 if an error occurred.
+	 */
+	virtual SemaphoreRef createSemaphore(uint initialCount) { return nullptr; }
+
+	/**
+	 * Decrement the semaphore, blocking while its count is zero.
+	 */
+	virtual void waitSemaphore(SemaphoreRef sem) {}
+
+	/**
+	 * Increment the semaphore, waking up one waiting thread.
+	 */
+	virtual void postSemaphore(SemaphoreRef sem) {}
+
+	/**
+	 * Delete the given semaphore. No thread may be waiting on it.
+	 */
+	virtual void deleteSemaphore(SemaphoreRef sem) {}
+
+	/** @} */
+
 
 
 	/** @defgroup common_system_sound Sound
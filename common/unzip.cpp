@@ -103,12 +103,17 @@ typedef struct {
 
 #endif  // !USE_ZLIB
 
+#include "common/endian.h"
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/substream.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
 
 #if defined(STRICTUNZIP) || defined(STRICTZIPUNZIP)
 /* like the STRICT of WIN32, we define a pointer that cannot be converted
@@ -373,6 +378,11 @@ typedef struct {
 	uLong current_file_ok;			/* flag about the usability of the current file*/
 	unz_file_info cur_file_info;					/* public info about the current file in zip*/
 	unz_file_info_internal cur_file_info_internal;	/* private info about it*/
+
+	uLong local_header_ok;			/* flag set once the local header was checked */
+	uInt size_local_var;			/* size of the file name and extra field in the local header */
+	uLong offset_local_extrafield;	/* offset of the local extra field */
+	uInt size_local_extrafield;		/* size of the local extra field */
 } cached_file_in_zip;
 
 typedef Common::HashMap<Common::String, cached_file_in_zip, Common::IgnoreCase_Hash,
@@ -382,6 +392,10 @@ typedef Common::HashMap<Common::String, cached_file_in_zip, Common::IgnoreCase_H
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _sharedStream;	/* owner of _stream, shared with the
+																	   streams of big files */
+	Common::SharedPtr<Common::Mutex> _streamMutex;	/* held while _stream is seeked and read,
+													   since big files may be read on other threads */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -397,6 +411,10 @@ typedef struct {
 	unz_file_info_internal cur_file_info_internal;	/* private info about it*/
 	file_in_zip_read_info_s* pfile_in_zip_read;		/* structure about the current
 													file if we are decompressing it */
+	file_in_zip_read_info_s* free_read_info;		/* buffers and inflate state of the
+													previous file, reused by the next one */
+	cached_file_in_zip *cur_file_cache;				/* hash entry of the current file, if it
+													was located through the hash */
 	ZipHash _hash;
 } unz_s;
 
@@ -526,6 +544,76 @@ static uLong unzlocal_SearchCentralDir(Common::SeekableReadStream &fin) {
      Else, the return value is a unzFile Handle, usable with other function
 	   of this unzip package.
 */
+static void unzlocal_DosDateToTmuDate(uLong ulDosDate, tm_unz* ptm);
+
+/*
+  Read the whole central directory at once, and store the details of every
+  file into the hash, so that files are located without reading it again.
+  Stops at the first invalid entry.
+*/
+static void unzlocal_BuildIndex(unz_s *s) {
+	byte *centralDir = (byte *)malloc(s->size_central_dir);
+	if (centralDir == nullptr)
+		return;
+
+	s->_stream->seek(s->offset_central_dir + s->byte_before_the_zipfile, SEEK_SET);
+	const uLong size = s->_stream->read(centralDir, s->size_central_dir);
+
+	uLong pos = 0;
+	for (uLong i = 0; i < s->gi.number_entry; ++i) {
+		const byte *entry = centralDir + pos;
+		if (pos + SIZECENTRALDIRITEM > size || READ_LE_UINT32(entry) != 0x02014b50)
+			break;
+
+		cached_file_in_zip fe;
+		unz_file_info &info = fe.cur_file_info;
+		info.version = READ_LE_UINT16(entry + 4);
+		info.version_needed = READ_LE_UINT16(entry + 6);
+		info.flag = READ_LE_UINT16(entry + 8);
+		info.compression_method = READ_LE_UINT16(entry + 10);
+		info.dosDate = READ_LE_UINT32(entry + 12);
+		unzlocal_DosDateToTmuDate(info.dosDate, &info.tmu_date);
+		info.crc = READ_LE_UINT32(entry + 16);
+		info.compressed_size = READ_LE_UINT32(entry + 20);
+		info.uncompressed_size = READ_LE_UINT32(entry + 24);
+		info.size_filename = READ_LE_UINT16(entry + 28);
+		info.size_file_extra = READ_LE_UINT16(entry + 30);
+		info.size_file_comment = READ_LE_UINT16(entry + 32);
+		info.disk_num_start = READ_LE_UINT16(entry + 34);
+		info.internal_fa = READ_LE_UINT16(entry + 36);
+		info.external_fa = READ_LE_UINT32(entry + 38);
+		fe.cur_file_info_internal.offset_curfile = READ_LE_UINT32(entry + 42);
+
+		if (pos + SIZECENTRALDIRITEM + info.size_filename > size)
+			break;
+
+		fe.num_file = i;
+		fe.pos_in_central_dir = s->offset_central_dir + pos;
+		fe.current_file_ok = 1;
+		fe.local_header_ok = 0;
+		fe.size_local_var = 0;
+		fe.offset_local_extrafield = 0;
+		fe.size_local_extrafield = 0;
+
+		const char *name = (const char *)entry + SIZECENTRALDIRITEM;
+		s->_hash[Common::String(name, MIN<uLong>(info.size_filename, UNZ_MAXFILENAMEINZIP))] = fe;
+
+		pos += SIZECENTRALDIRITEM + info.size_filename + info.size_file_extra + info.size_file_comment;
+	}
+
+	free(centralDir);
+}
+
+static void unzlocal_FreeReadInfo(file_in_zip_read_info_s *pfile_in_zip_read_info) {
+#ifdef USE_ZLIB
+	if (pfile_in_zip_read_info->stream_initialized)
+		inflateEnd(&pfile_in_zip_read_info->stream);
+#endif
+
+	free(pfile_in_zip_read_info->read_buffer);
+	free(pfile_in_zip_read_info);
+}
+
 unzFile unzOpen(Common::SeekableReadStream *stream) {
 	if (!stream)
 		return nullptr;
@@ -544,6 +632,8 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 	int err=UNZ_OK;
 
 	us->_stream = stream;
+	us->_sharedStream = Common::SharedPtr<Common::SeekableReadStream>(stream);
+	us->_streamMutex = Common::SharedPtr<Common::Mutex>(new Common::Mutex());
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos==0)
@@ -595,7 +685,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		err=UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -604,28 +693,13 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		                    (us->offset_central_dir+us->size_central_dir);
 	us->central_pos = central_pos;
 	us->pfile_in_zip_read = nullptr;
+	us->free_read_info = nullptr;
+	us->cur_file_cache = nullptr;
 
 	err = unzGoToFirstFile((unzFile)us);
+	if (err == UNZ_OK)
+		unzlocal_BuildIndex(us);
 
-	while (err == UNZ_OK) {
-		// Get the file details
-		char szCurrentFileName[UNZ_MAXFILENAMEINZIP+1];
-		unzGetCurrentFileInfo(us, nullptr, szCurrentFileName, sizeof(szCurrentFileName) - 1,
-							nullptr, 0, nullptr, 0);
-
-		// Save details into the hash
-		cached_file_in_zip fe;
-		fe.num_file = us->num_file;
-		fe.pos_in_central_dir = us->pos_in_central_dir;
-		fe.current_file_ok = us->current_file_ok;
-		fe.cur_file_info = us->cur_file_info;
-		fe.cur_file_info_internal = us->cur_file_info_internal;
-
-		us->_hash[Common::String(szCurrentFileName)] = fe;
-
-		// Move to the next file
-		err = unzGoToNextFile((unzFile)us);
-	}
 	return (unzFile)us;
 }
 
@@ -644,7 +718,9 @@ int unzClose(unzFile file) {
 	if (s->pfile_in_zip_read != nullptr)
 		unzCloseCurrentFile(file);
 
-	delete s->_stream;
+	if (s->free_read_info != nullptr)
+		unzlocal_FreeReadInfo(s->free_read_info);
+
 	delete s;
 	return UNZ_OK;
 }
@@ -871,6 +947,7 @@ int unzGoToFirstFile(unzFile file) {
 	s=(unz_s*)file;
 	s->pos_in_central_dir=s->offset_central_dir;
 	s->num_file=0;
+	s->cur_file_cache=nullptr;
 	err=unzlocal_GetCurrentFileInfoInternal(file,&s->cur_file_info,
 											 &s->cur_file_info_internal,
 											 nullptr,0,nullptr,0,nullptr,0);
@@ -899,6 +976,7 @@ int unzGoToNextFile(unzFile file) {
 	s->pos_in_central_dir += SIZECENTRALDIRITEM + s->cur_file_info.size_filename +
 			s->cur_file_info.size_file_extra + s->cur_file_info.size_file_comment;
 	s->num_file++;
+	s->cur_file_cache=nullptr;
 	err = unzlocal_GetCurrentFileInfoInternal(file,&s->cur_file_info,
 											   &s->cur_file_info_internal,
 											   nullptr,0,nullptr,0,nullptr,0);
@@ -939,6 +1017,7 @@ int unzLocateFile(unzFile file, const char *szFileName, int iCaseSensitivity) {
 	s->current_file_ok = fe.current_file_ok;
 	s->cur_file_info = fe.cur_file_info;
 	s->cur_file_info_internal = fe.cur_file_info_internal;
+	s->cur_file_cache = &fe;
 
 	return UNZ_OK;
 }
@@ -1056,27 +1135,49 @@ int unzOpenCurrentFile (unzFile file) {
 	if (s->pfile_in_zip_read != nullptr)
 		unzCloseCurrentFile(file);
 
-	if (unzlocal_CheckCurrentFileCoherencyHeader(s,&iSizeVar,
-				&offset_local_extrafield,&size_local_extrafield)!=UNZ_OK)
-		return UNZ_BADZIPFILE;
+	// The local header only needs to be checked the first time a file is opened
+	cached_file_in_zip *fe = s->cur_file_cache;
+	if (fe != nullptr && fe->local_header_ok) {
+		iSizeVar = fe->size_local_var;
+		offset_local_extrafield = fe->offset_local_extrafield;
+		size_local_extrafield = fe->size_local_extrafield;
+	} else {
+		if (unzlocal_CheckCurrentFileCoherencyHeader(s,&iSizeVar,
+					&offset_local_extrafield,&size_local_extrafield)!=UNZ_OK)
+			return UNZ_BADZIPFILE;
+
+		if (fe != nullptr) {
+			fe->local_header_ok = 1;
+			fe->size_local_var = iSizeVar;
+			fe->offset_local_extrafield = offset_local_extrafield;
+			fe->size_local_extrafield = size_local_extrafield;
+		}
+	}
+
+	if (s->free_read_info != nullptr) {
+		// Reuse the buffer and the inflate state of the previous file
+		pfile_in_zip_read_info = s->free_read_info;
+		s->free_read_info = nullptr;
+	} else {
+		pfile_in_zip_read_info = (file_in_zip_read_info_s*) malloc(sizeof(file_in_zip_read_info_s));
 
-	pfile_in_zip_read_info = (file_in_zip_read_info_s*) malloc(sizeof(file_in_zip_read_info_s));
+		if (pfile_in_zip_read_info==nullptr)
+			return UNZ_INTERNALERROR;
 
-	if (pfile_in_zip_read_info==nullptr)
-		return UNZ_INTERNALERROR;
+		pfile_in_zip_read_info->read_buffer=(char *)malloc(UNZ_BUFSIZE);
 
-	pfile_in_zip_read_info->read_buffer=(char *)malloc(UNZ_BUFSIZE);
-	pfile_in_zip_read_info->offset_local_extrafield = offset_local_extrafield;
-	pfile_in_zip_read_info->size_local_extrafield = size_local_extrafield;
-	pfile_in_zip_read_info->pos_local_extrafield=0;
+		if (pfile_in_zip_read_info->read_buffer==nullptr)
+		{
+			free(pfile_in_zip_read_info);
+			return UNZ_INTERNALERROR;
+		}
 
-	if (pfile_in_zip_read_info->read_buffer==nullptr)
-	{
-		free(pfile_in_zip_read_info);
-		return UNZ_INTERNALERROR;
+		pfile_in_zip_read_info->stream_initialized=0;
 	}
 
-	pfile_in_zip_read_info->stream_initialized=0;
+	pfile_in_zip_read_info->offset_local_extrafield = offset_local_extrafield;
+	pfile_in_zip_read_info->size_local_extrafield = size_local_extrafield;
+	pfile_in_zip_read_info->pos_local_extrafield=0;
 
 	if ((s->cur_file_info.compression_method!=0) &&
 	    (s->cur_file_info.compression_method!=Z_DEFLATED))
@@ -1093,13 +1194,17 @@ int unzOpenCurrentFile (unzFile file) {
 
 	if (!Store) {
 #ifdef USE_ZLIB
-		pfile_in_zip_read_info->stream.zalloc = (alloc_func)nullptr;
-		pfile_in_zip_read_info->stream.zfree = (free_func)nullptr;
-		pfile_in_zip_read_info->stream.opaque = (voidpf)nullptr;
+		if (pfile_in_zip_read_info->stream_initialized) {
+			err=inflateReset(&pfile_in_zip_read_info->stream);
+		} else {
+			pfile_in_zip_read_info->stream.zalloc = (alloc_func)nullptr;
+			pfile_in_zip_read_info->stream.zfree = (free_func)nullptr;
+			pfile_in_zip_read_info->stream.opaque = (voidpf)nullptr;
 
-		err=inflateInit2(&pfile_in_zip_read_info->stream, -MAX_WBITS);
-		if (err == Z_OK)
-			pfile_in_zip_read_info->stream_initialized = 1;
+			err=inflateInit2(&pfile_in_zip_read_info->stream, -MAX_WBITS);
+			if (err == Z_OK)
+				pfile_in_zip_read_info->stream_initialized = 1;
+		}
 	/* windowBits is passed < 0 to tell that there is no zlib header.
 	 * Note that in this case inflate *requires* an extra "dummy" byte
 	 * after the compressed stream in order to complete decompression and
@@ -1368,16 +1473,13 @@ int unzCloseCurrentFile(unzFile file) {
 		if (pfile_in_zip_read_info->crc32_data != pfile_in_zip_read_info->crc32_wait)
 			err=UNZ_CRCERROR;
 	}
-	if (pfile_in_zip_read_info->stream_initialized)
-		inflateEnd(&pfile_in_zip_read_info->stream);
 #endif
 
-
-	free(pfile_in_zip_read_info->read_buffer);
-	pfile_in_zip_read_info->read_buffer = nullptr;
-
-	pfile_in_zip_read_info->stream_initialized = 0;
-	free(pfile_in_zip_read_info);
+	// Keep the buffer and the inflate state around for the next file
+	if (s->free_read_info == nullptr)
+		s->free_read_info = pfile_in_zip_read_info;
+	else
+		unzlocal_FreeReadInfo(pfile_in_zip_read_info);
 
 	s->pfile_in_zip_read=nullptr;
 
@@ -1419,12 +1521,223 @@ int unzGetGlobalComment(unzFile file, char *szComment, uLong uSizeBuf) {
 
 namespace Common {
 
+namespace {
+
+/**
+ * A stream on a file of a zip archive, which reads and decompresses the
+ * data on demand instead of holding all of it in memory. It shares the
+ * stream of the archive, and so can outlive the ZipArchive. The archive
+ * stream is only used with its mutex held, so these streams can be read on
+ * other threads while the archive opens more files.
+ */
+class ZipStream : public SeekableReadStream {
+protected:
+	enum {
+		BUFSIZE = UNZ_BUFSIZE
+	};
+
+	byte _buf[BUFSIZE];
+
+	SharedPtr<SeekableReadStream> _archiveStream;
+	SharedPtr<Mutex> _archiveMutex;
+	SafeSeekableSubReadStream _wrapped;
+	bool _deflated;
+	z_stream _stream;
+	int _zlibErr;
+	uint32 _pos;
+	uint32 _size;
+	bool _eos;
+
+	// The CRC of the data is checked when it was all read in order
+	uint32 _crc;
+	uint32 _expectedCrc;
+	bool _checkCrc;
+	bool _crcErr;
+
+	uint32 readArchive(void *dataPtr, uint32 dataSize) {
+		StackLock lock(*_archiveMutex);
+		return _wrapped.read(dataPtr, dataSize);
+	}
+
+	bool seekArchive(uint32 offset) {
+		StackLock lock(*_archiveMutex);
+		return _wrapped.seek(offset);
+	}
+
+	void resetCrc() {
+		_crc = 0;
+		_checkCrc = true;
+	}
+
+public:
+	ZipStream(const SharedPtr<SeekableReadStream> &archiveStream, const SharedPtr<Mutex> &archiveMutex, uint32 begin, uint32 compressedSize, uint32 size, bool deflated, uint32 crc) :
+			_archiveStream(archiveStream),
+			_archiveMutex(archiveMutex),
+			_wrapped(archiveStream.get(), begin, begin + compressedSize),
+			_deflated(deflated),
+			_stream(),
+			_zlibErr(Z_OK),
+			_pos(0),
+			_size(size),
+			_eos(false),
+			_crc(0),
+			_expectedCrc(crc),
+			_checkCrc(true),
+			_crcErr(false) {
+#ifdef USE_ZLIB
+		if (_deflated) {
+			_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+			_stream.next_in = _buf;
+			_stream.avail_in = 0;
+		}
+#endif
+	}
+
+	~ZipStream() {
+#ifdef USE_ZLIB
+		if (_deflated)
+			inflateEnd(&_stream);
+#endif
+	}
+
+	bool err() const { return _zlibErr != Z_OK || _crcErr || _wrapped.err(); }
+	void clearErr() {
+		// only reset _eos; I/O errors are not recoverable
+		_eos = false;
+	}
+
+	uint32 read(void *dataPtr, uint32 dataSize) {
+		if (dataSize > _size - _pos) {
+			dataSize = _size - _pos;
+			_eos = true;
+		}
+
+		uint32 readSize = 0;
+		if (!_deflated) {
+			readSize = readArchive(dataPtr, dataSize);
+		} else {
+#ifdef USE_ZLIB
+			_stream.next_out = (byte *)dataPtr;
+			_stream.avail_out = dataSize;
+
+			while (_zlibErr == Z_OK && _stream.avail_out) {
+				// The archive stream is shared, so its eos flag can not be relied on
+				if (_stream.avail_in == 0 && _wrapped.pos() < _wrapped.size()) {
+					_stream.next_in = _buf;
+					_stream.avail_in = readArchive(_buf, BUFSIZE);
+				}
+				_zlibErr = inflate(&_stream, Z_NO_FLUSH);
+			}
+
+			// The end of the data is known from the size of the file
+			if (_zlibErr == Z_STREAM_END)
+				_zlibErr = Z_OK;
+
+			readSize = dataSize - _stream.avail_out;
+#endif
+		}
+
+#ifdef USE_ZLIB
+		if (_checkCrc) {
+			_crc = crc32(_crc, (const byte *)dataPtr, readSize);
+			if (_pos + readSize == _size && _crc != _expectedCrc) {
+				warning("ZipStream: CRC mismatch");
+				_crcErr = true;
+			}
+		}
+#endif
+
+		_pos += readSize;
+		return readSize;
+	}
+
+	bool eos() const { return _eos; }
+	int32 pos() const { return _pos; }
+	int32 size() const { return _size; }
+
+	bool seek(int32 offset, int whence = SEEK_SET) {
+		int32 newPos = 0;
+		switch (whence) {
+		default:
+			// fallthrough intended
+		case SEEK_SET:
+			newPos = offset;
+			break;
+		case SEEK_CUR:
+			newPos = _pos + offset;
+			break;
+		case SEEK_END:
+			newPos = _size + offset;
+			break;
+		}
+
+		if (newPos < 0 || (uint32)newPos > _size)
+			return false;
+
+		_eos = false;
+
+		if (!_deflated) {
+			// Skipped data can not be checked
+			if (newPos == 0)
+				resetCrc();
+			else if ((uint32)newPos != _pos)
+				_checkCrc = false;
+
+			_pos = newPos;
+			return seekArchive(newPos);
+		}
+
+#ifdef USE_ZLIB
+		if ((uint32)newPos < _pos) {
+			// Searching backward restarts the decompression from the start
+			_pos = 0;
+			seekArchive(0);
+			_zlibErr = inflateReset(&_stream);
+			_stream.next_in = _buf;
+			_stream.avail_in = 0;
+			resetCrc();
+		}
+
+		byte tmpBuf[1024];
+		while (!err() && _pos < (uint32)newPos) {
+			if (read(tmpBuf, MIN<uint32>(sizeof(tmpBuf), newPos - _pos)) == 0)
+				break;
+		}
+#endif
+
+		return !err() && _pos == (uint32)newPos;
+	}
+};
+
+struct FreeDeleter {
+	void operator()(const byte *ptr) { free(const_cast<byte *>(ptr)); }
+};
+
+} // End of anonymous namespace
 
 class ZipArchive : public Archive {
 	unzFile _zipFile;
 
+	// Files of this size or bigger are not loaded into memory at once
+	enum {
+		kStreamedFileSize = 256 * 1024
+	};
+
+	struct CachedFile {
+		String name;
+		SharedPtr<const byte> data;
+		uint32 size;
+	};
+
+	typedef List<CachedFile> FileCache;
+
+	/** Recently opened files, the most recent one first. Guarded by the archive stream mutex. */
+	mutable FileCache _cache;
+	mutable uint32 _cachedSize;
+	uint32 _cacheSize;
+
 public:
-	ZipArchive(unzFile zipFile);
+	ZipArchive(unzFile zipFile, uint32 cacheSize);
 
 
 	~ZipArchive();
@@ -1453,7 +1766,7 @@ public:
 };
 */
 
-ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile) {
+ZipArchive::ZipArchive(unzFile zipFile, uint32 cacheSize) : _zipFile(zipFile), _cachedSize(0), _cacheSize(cacheSize) {
 	assert(_zipFile);
 }
 
@@ -1486,20 +1799,52 @@ const ArchiveMemberPtr ZipArchive::getMember(const String &name) const {
 }
 
 SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) const {
+	const unz_s *const archive = (const unz_s *)_zipFile;
+
+	// Streams of big files may be reading the archive on other threads
+	StackLock lock(*archive->_streamMutex);
+
+	for (FileCache::iterator i = _cache.begin(); i != _cache.end(); ++i) {
+		if (i->name.equalsIgnoreCase(name)) {
+			const CachedFile file = *i;
+			_cache.erase(i);
+			_cache.push_front(file);
+			return new SharedMemoryReadStream(file.data, file.data.get(), file.size);
+		}
+	}
+
 	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
 		return nullptr;
 
-	unz_file_info fileInfo;
 	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
 		return nullptr;
 
-	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
-		return nullptr;
+	const unz_file_info &fileInfo = archive->cur_file_info;
+
+	// Big files are decompressed on demand, and can be read independently
+	// of other files of the archive
+	if (fileInfo.uncompressed_size >= kStreamedFileSize) {
+#ifndef USE_ZLIB
+		if (fileInfo.compression_method == Z_DEFLATED) {
+			unzCloseCurrentFile(_zipFile);
+			return nullptr;
+		}
+#endif
+
+		const file_in_zip_read_info_s *const readInfo = archive->pfile_in_zip_read;
+		SeekableReadStream *stream = new ZipStream(archive->_sharedStream, archive->_streamMutex,
+			readInfo->pos_in_zipfile + readInfo->byte_before_the_zipfile,
+			fileInfo.compressed_size, fileInfo.uncompressed_size,
+			fileInfo.compression_method == Z_DEFLATED, fileInfo.crc);
+		unzCloseCurrentFile(_zipFile);
+		return stream;
+	}
 
 	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
 	assert(buffer);
 
 	if (unzReadCurrentFile(_zipFile, buffer, fileInfo.uncompressed_size) != (int)fileInfo.uncompressed_size) {
+		unzCloseCurrentFile(_zipFile);
 		free(buffer);
 		return nullptr;
 	}
@@ -1509,23 +1854,34 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 		return nullptr;
 	}
 
-	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
+	// Only cache files which leave room for a few others
+	if (!_cacheSize || fileInfo.uncompressed_size > _cacheSize / 4)
+		return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
+
+	while (!_cache.empty() && _cachedSize + fileInfo.uncompressed_size > _cacheSize) {
+		_cachedSize -= _cache.back().size;
+		_cache.pop_back();
+	}
+
+	CachedFile file;
+	file.name = name;
+	file.data = SharedPtr<const byte>(buffer, FreeDeleter());
+	file.size = fileInfo.uncompressed_size;
+	_cache.push_front(file);
+	_cachedSize += file.size;
 
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
+	return new SharedMemoryReadStream(file.data, buffer, file.size);
 }
 
-Archive *makeZipArchive(const String &name) {
-	return makeZipArchive(SearchMan.createReadStreamForMember(name));
+Archive *makeZipArchive(const String &name, uint32 cacheSize) {
+	return makeZipArchive(SearchMan.createReadStreamForMember(name), cacheSize);
 }
 
-Archive *makeZipArchive(const FSNode &node) {
-	return makeZipArchive(node.createReadStream());
+Archive *makeZipArchive(const FSNode &node, uint32 cacheSize) {
+	return makeZipArchive(node.createReadStream(), cacheSize);
 }
 
-Archive *makeZipArchive(SeekableReadStream *stream) {
+Archive *makeZipArchive(SeekableReadStream *stream, uint32 cacheSize) {
 	if (!stream)
 		return nullptr;
 	unzFile zipFile = unzOpen(stream);
@@ -1534,7 +1890,7 @@ Archive *makeZipArchive(SeekableReadStream *stream) {
 		// goes wrong.
 		return nullptr;
 	}
-	return new ZipArchive(zipFile);
+	return new ZipArchive(zipFile, cacheSize);
 }
 
 } // End of namespace Common
@@ -44,27 +44,36 @@ class SeekableReadStream;
  * This factory method creates an Archive instance corresponding to the content
  * of the ZIP compressed file with the given name.
  *
+ * Small files of the archive are decompressed into memory when they are
+ * opened, and up to cacheSize bytes of them are kept there to open them
+ * again quickly. Big files are decompressed while they are read, and their
+ * streams may be read on other threads.
+ *
  * May return 0 in case of a failure.
  */
-Archive *makeZipArchive(const String &name);
+Archive *makeZipArchive(const String &name, uint32 cacheSize = 0);
 
 /**
  * This factory method creates an Archive instance corresponding to the content
  * of the ZIP compressed file with the given name.
  *
+ * @see makeZipArchive(const String &, uint32)
+ *
  * May return 0 in case of a failure.
  */
-Archive *makeZipArchive(const FSNode &node);
+Archive *makeZipArchive(const FSNode &node, uint32 cacheSize = 0);
 
 /**
  * This factory method creates an Archive instance corresponding to the content
  * of the given ZIP compressed datastream.
  * This takes ownership of the stream,  in particular, it is deleted when the
- * ZipArchive is deleted.
+ * ZipArchive and all the streams of its files are deleted.
+ *
+ * @see makeZipArchive(const String &, uint32)
  *
  * May return 0 in case of a failure. In this case stream will still be deleted.
  */
-Archive *makeZipArchive(SeekableReadStream *stream);
+Archive *makeZipArchive(SeekableReadStream *stream, uint32 cacheSize = 0);
 
 /** @} */
 
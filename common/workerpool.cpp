@@ -0,0 +1,100 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/workerpool.h"
+#include "common/atomic.h"
+
+namespace Common {
+
+WorkerPool::WorkerPool(uint threadCount) : _start(nullptr), _done(nullptr), _proc(nullptr), _param(nullptr), _jobCount(0), _nextJob(0), _quit(false) {
+	const uint count = threadCount ? threadCount : g_system->getCpuCount();
+	if (count <= 1)
+		return;
+
+	_start = g_system->createSemaphore(0);
+	_done = g_system->createSemaphore(0);
+	if (!_start || !_done)
+		return;
+
+	for (uint i = 1; i < count; ++i) {
+		OSystem::ThreadRef thread = g_system->createThread(workerEntry, this);
+		if (!thread)
+			break;
+		_threads.push_back(thread);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	_quit = true;
+	for (uint i = 0; i < _threads.size(); ++i)
+		g_system->postSemaphore(_start);
+	for (uint i = 0; i < _threads.size(); ++i)
+		g_system->joinThread(_threads[i]);
+
+	if (_start)
+		g_system->deleteSemaphore(_start);
+	if (_done)
+		g_system->deleteSemaphore(_done);
+}
+
+void WorkerPool::run(JobProc proc, void *param, uint jobCount) {
+	if (_threads.empty() || jobCount <= 1) {
+		for (uint i = 0; i < jobCount; ++i)
+			proc(param, i);
+		return;
+	}
+
+	_proc = proc;
+	_param = param;
+	_jobCount = jobCount;
+	_nextJob = 0;
+
+	// Don't wake up more workers than there are jobs for
+	const uint workers = MIN<uint>(_threads.size(), jobCount - 1);
+	for (uint i = 0; i < workers; ++i)
+		g_system->postSemaphore(_start);
+
+	processJobs();
+
+	for (uint i = 0; i < workers; ++i)
+		g_system->waitSemaphore(_done);
+}
+
+void WorkerPool::workerEntry(void *param) {
+	WorkerPool *pool = (WorkerPool *)param;
+
+	while (true) {
+		g_system->waitSemaphore(pool->_start);
+		if (pool->_quit)
+			break;
+		pool->processJobs();
+		g_system->postSemaphore(pool->_done);
+	}
+}
+
+void WorkerPool::processJobs() {
+	int32 job;
+	while ((job = atomicAdd(&_nextJob, 1) - 1) < _jobCount)
+		_proc(_param, job);
+}
+
+} // End of namespace Common
@@ -0,0 +1,98 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_WORKERPOOL_H
+#define COMMON_WORKERPOOL_H
+
+#include "common/array.h"
+#include "common/noncopyable.h"
+#include "common/system.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_workerpool Worker pool
+ * @ingroup common
+ *
+ * @brief Fork/join helper for spreading independent jobs over several CPUs.
+ *
+ * @{
+ */
+
+/**
+ * A fixed set of worker threads which run batches of jobs.
+ *
+ * run() hands out the job indices 0 to jobCount - 1 to the workers and the
+ * calling thread, and only returns once all of them have been processed.
+ * Jobs are claimed one at a time, so uneven jobs balance out.
+ *
+ * When the backend cannot create threads, or only one CPU is available,
+ * the pool has no workers and run() simply processes all jobs in order on
+ * the calling thread.
+ *
+ * A pool must only be used from one thread at a time, and jobs must not
+ * call run() on the pool which is running them.
+ */
+class WorkerPool : NonCopyable {
+public:
+	typedef void (*JobProc)(void *param, uint job);
+
+	/**
+	 * Create a pool.
+	 *
+	 * @param threadCount Number of threads working on a batch, including
+	 *                    the caller of run(). 0 means one per CPU.
+	 */
+	explicit WorkerPool(uint threadCount = 0);
+	~WorkerPool();
+
+	/**
+	 * Return how many threads work on a batch, including the caller.
+	 */
+	uint getThreadCount() const { return _threads.size() + 1; }
+
+	/**
+	 * Call proc(param, job) for every job in [0, jobCount) and wait for all
+	 * of them to finish.
+	 */
+	void run(JobProc proc, void *param, uint jobCount);
+
+private:
+	static void workerEntry(void *param);
+	void processJobs();
+
+	Array<OSystem::ThreadRef> _threads;
+	OSystem::SemaphoreRef _start;
+	OSystem::SemaphoreRef _done;
+
+	JobProc _proc;
+	void *_param;
+	int32 _jobCount;
+	int32 _nextJob;
+	bool _quit;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -195,7 +195,8 @@ Engine::~Engine() {
 }
 
 void Engine::initializePath(const Common::FSNode &gamePath) {
-	SearchMan.addDirectory(gamePath.getPath(), gamePath, 0, 4);
+	// Game data is only read, so big files of it may be mapped into memory
+	SearchMan.addDirectory(gamePath.getPath(), gamePath, 0, 4, false, true);
 }
 
 void initCommonGFX() {
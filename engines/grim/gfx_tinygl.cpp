@@ -90,6 +90,8 @@ void GfxTinyGL::setupScreen(int screenW, int screenH) {
 	_zb = new TinyGL::FrameBuffer(screenW, screenH, _pixelFormat);
 	TinyGL::glInit(_zb, 256);
 	tglEnableDirtyRects(ConfMan.getBool("dirtyrects"));
+	// Tiles only pay off when they can be rasterized in parallel
+	tglEnableTiledRendering(g_system->getCpuCount() > 1);
 
 	_storedDisplay.create(_pixelFormat, _gameWidth * _gameHeight, DisposeAfterUse::YES);
 	_storedDisplay.clear(_gameWidth * _gameHeight);
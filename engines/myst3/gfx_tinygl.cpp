@@ -22,6 +22,7 @@
 
 #include "common/config-manager.h"
 #include "common/rect.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 
 #include "graphics/colormasks.h"
@@ -66,6 +67,8 @@ void TinyGLRenderer::init() {
 	_fb = new TinyGL::FrameBuffer(kOriginalWidth, kOriginalHeight, g_system->getScreenFormat());
 	TinyGL::glInit(_fb, 512);
 	tglEnableDirtyRects(ConfMan.getBool("dirtyrects"));
+	// Tiles only pay off when they can be rasterized in parallel
+	tglEnableTiledRendering(g_system->getCpuCount() > 1);
 
 	tglMatrixMode(TGL_PROJECTION);
 	tglLoadIdentity();
@@ -39,6 +39,7 @@ public:
 		: SafeSeekableSubReadStream(parentStream, begin, end, disposeParentStream), _mutex(mutex) {
 	}
 	uint32 read(void *dataPtr, uint32 dataSize) override;
+	SeekableReadStream *readStream(uint32 dataSize) override;
 protected:
 	Common::Mutex &_mutex;
 };
@@ -48,6 +49,11 @@ uint32 SafeMutexedSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	return Common::SafeSeekableSubReadStream::read(dataPtr, dataSize);
 }
 
+Common::SeekableReadStream *SafeMutexedSeekableSubReadStream::readStream(uint32 dataSize) {
+	Common::StackLock lock(_mutex);
+	return Common::SafeSeekableSubReadStream::readStream(dataSize);
+}
+
 BlbArchive::BlbArchive() : _extData(NULL) {
 }
 
@@ -23,6 +23,7 @@
 // Console module
 
 #include "common/md5.h"
+#include "common/random.h"
 #include "sci/sci.h"
 #include "sci/console.h"
 #include "sci/debug.h"
@@ -53,10 +54,14 @@
 #include "video/avi_decoder.h"
 #include "sci/video/seq_decoder.h"
 #ifdef ENABLE_SCI32
+#include "common/cpudetect.h"
 #include "common/memstream.h"
+#include "sci/graphics/celobj32.h"
 #include "sci/graphics/frameout.h"
 #include "sci/graphics/paint32.h"
 #include "sci/graphics/palette32.h"
+#include "sci/graphics/plane32.h"
+#include "sci/graphics/screen_item32.h"
 #include "sci/sound/decoders/sol.h"
 #include "video/coktel_decoder.h"
 #endif
@@ -150,6 +155,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("vpi",                WRAP_METHOD(Console, cmdVisiblePlaneItemList));	// alias
 	registerCmd("saved_bits",         WRAP_METHOD(Console, cmdSavedBits));
 	registerCmd("show_saved_bits",    WRAP_METHOD(Console, cmdShowSavedBits));
+	registerCmd("draw_benchmark",     WRAP_METHOD(Console, cmdDrawBenchmark));
+	registerCmd("cel_cache",          WRAP_METHOD(Console, cmdCelCache));
 	// Segments
 	registerCmd("segment_table",		WRAP_METHOD(Console, cmdPrintSegmentTable));
 	registerCmd("segtable",			WRAP_METHOD(Console, cmdPrintSegmentTable));	// alias
@@ -163,6 +170,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
+	registerCmd("gc_benchmark",		WRAP_METHOD(Console, cmdGCBenchmark));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -226,6 +235,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	registerCmd("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	registerCmd("selector_cache",   WRAP_METHOD(Console, cmdSelectorLookupCache));
 	registerCmd("script_objects",   WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("scro",             WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("script_strings",   WRAP_METHOD(Console, cmdScriptStrings));
@@ -376,6 +386,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" visible_plane_items / vpi - Shows a list of all items for a plane in the visible draw list (SCI2+)\n");
 	debugPrintf(" saved_bits - List saved bits on the hunk\n");
 	debugPrintf(" show_saved_bits - Display saved bits\n");
+	debugPrintf(" draw_benchmark - Compares the cel renderers by redrawing the visible screen items (SCI2+)\n");
+	debugPrintf(" cel_cache - Shows the size and hit rate of the cel cache (SCI2+)\n");
 	debugPrintf("\n");
 	debugPrintf("Segments:\n");
 	debugPrintf(" segment_table / segtable - Lists all segments\n");
@@ -388,6 +400,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_stats - Shows the pause times of the garbage collector\n");
+	debugPrintf(" gc_benchmark - Compares the pause times of full and incremental collections on a simulated heap\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -433,6 +447,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("\n");
 	debugPrintf("VM:\n");
 	debugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	debugPrintf(" selector_cache - Shows the hit and miss counts of the selector lookup caches\n");
 	debugPrintf(" script_objects / scro - Shows all objects inside a specified script\n");
 	debugPrintf(" script_strings / scrs - Shows all strings inside a specified script\n");
 	debugPrintf(" script_said - Shows all said - strings inside a specified script\n");
@@ -2312,6 +2327,125 @@ bool Console::cmdShowSavedBits(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdDrawBenchmark(int argc, const char **argv) {
+#ifdef ENABLE_SCI32
+	if (!_engine->_gfxFrameout) {
+		debugPrintf("This SCI version does not have a list of planes\n");
+		return true;
+	}
+
+	int frames = 100;
+	if (argc > 2 || (argc == 2 && !parseInteger(argv[1], frames)) || frames < 1) {
+		debugPrintf("Redraws the screen items of the visible planes to a scratch buffer with\n");
+		debugPrintf("the pixel renderer, the generic row renderer and the SIMD row renderer\n");
+		debugPrintf("Usage: %s [frames]\n", argv[0]);
+		return true;
+	}
+
+	struct Item {
+		ScreenItem *screenItem;
+		Common::Rect rect;
+	};
+	Common::Array<Item> items;
+	const PlaneList &planes = _engine->_gfxFrameout->getVisiblePlanes();
+	for (PlaneList::size_type i = 0; i < planes.size(); ++i) {
+		const Plane *plane = planes[i];
+		if (plane == nullptr) {
+			continue;
+		}
+
+		const ScreenItemList &screenItems = plane->_screenItemList;
+		for (ScreenItemList::size_type j = 0; j < screenItems.size(); ++j) {
+			ScreenItem *screenItem = screenItems[j];
+			if (screenItem == nullptr || !screenItem->_celObj) {
+				continue;
+			}
+
+			Item item;
+			item.screenItem = screenItem;
+			item.rect = screenItem->_screenRect.findIntersectingRect(plane->_screenRect);
+			if (!item.rect.isEmpty()) {
+				items.push_back(item);
+			}
+		}
+	}
+
+	if (items.empty()) {
+		debugPrintf("There are no screen items to draw\n");
+		return true;
+	}
+
+	const Buffer &screen = _engine->_gfxFrameout->getCurrentBuffer();
+	Buffer buffers[3];
+	const char *const names[] = { "pixels", "rows", "SIMD rows" };
+	for (int mode = 0; mode < 3; ++mode) {
+		CelObj::_drawRows = mode != 0;
+		Common::setCpuFeatureMask(mode == 2 ? Common::kCpuFeatureAll : 0);
+
+		Buffer &buffer = buffers[mode];
+		buffer.create(screen.w, screen.h, Graphics::PixelFormat::createFormatCLUT8());
+		buffer.fillRect(Common::Rect(screen.w, screen.h), 0);
+
+		const uint32 start = g_system->getMillis();
+		for (int frame = 0; frame < frames; ++frame) {
+			for (uint i = 0; i < items.size(); ++i) {
+				ScreenItem &screenItem = *items[i].screenItem;
+				CelObj &celObj = *screenItem._celObj;
+				celObj.draw(buffer, screenItem, items[i].rect, screenItem._mirrorX ^ celObj._mirrorX);
+			}
+		}
+		const uint32 time = MAX<uint32>(g_system->getMillis() - start, 1);
+
+		debugPrintf("%s: %u ms, %u frames per second\n", names[mode], time, frames * 1000 / time);
+	}
+
+	CelObj::_drawRows = true;
+	Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+
+	debugPrintf("%u screen items, output %s\n", items.size(),
+		memcmp(buffers[0].getPixels(), buffers[1].getPixels(), screen.w * screen.h) == 0 &&
+		memcmp(buffers[0].getPixels(), buffers[2].getPixels(), screen.w * screen.h) == 0 ? "identical" : "DIFFERS");
+
+	for (int mode = 0; mode < 3; ++mode) {
+		buffers[mode].free();
+	}
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
+bool Console::cmdCelCache(int argc, const char **argv) {
+#ifdef ENABLE_SCI32
+	CelCache *cache = CelObj::getCache();
+	if (!cache) {
+		debugPrintf("This SCI version does not have a cel cache\n");
+		return true;
+	}
+
+	if (argc > 1) {
+		if (strcmp(argv[1], "reset") != 0) {
+			debugPrintf("Shows the size and hit rate of the cel cache.\n");
+			debugPrintf("Usage: %s [reset]\n", argv[0]);
+			return true;
+		}
+
+		cache->resetCounters();
+		debugPrintf("Cel cache counters reset\n");
+		return true;
+	}
+
+	const uint32 lookups = cache->getHits() + cache->getMisses();
+	debugPrintf("%d cels cached, %d of %d KB used\n", cache->getSize(), cache->getMemory() / 1024, cache->getMaxMemory() / 1024);
+	debugPrintf("%d hits, %d misses (%d%% hits), %d evictions\n", cache->getHits(), cache->getMisses(),
+	            lookups ? (int)((uint64)cache->getHits() * 100 / lookups) : 0, cache->getEvictions());
+	debugPrintf("%d cels prefetched, %d of them used, %d of %d KB of unused ones\n", cache->getPrefetches(), cache->getPrefetchHits(),
+	            cache->getPrefetchMemory() / 1024, cache->getMaxPrefetchMemory() / 1024);
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
 
 bool Console::cmdParseGrammar(int argc, const char **argv) {
 	debugPrintf("Parse grammar, in strict GNF:\n");
@@ -2839,6 +2973,198 @@ bool Console::cmdGCNormalize(int argc, const char **argv) {
 	return true;
 }
 
+static void printGCPauseStats(Console *con, const char *name, const GarbageCollector::PauseStats &stats) {
+	if (!stats.count) {
+		con->debugPrintf("%s: none\n", name);
+		return;
+	}
+
+	con->debugPrintf("%s: %d, %d ms total, %d ms max, %d references or entries avg, %d max\n", name, stats.count,
+	                 stats.totalTime, stats.maxTime, stats.totalWork / stats.count, stats.maxWork);
+	con->debugPrintf("  0 ms: %d, 1 ms: %d, 2-3 ms: %d, 4-7 ms: %d, 8-15 ms: %d, 16-31 ms: %d, 32+ ms: %d\n",
+	                 stats.histogram[0], stats.histogram[1], stats.histogram[2], stats.histogram[3],
+	                 stats.histogram[4], stats.histogram[5], stats.histogram[6]);
+}
+
+static void printGCStats(Console *con, const GarbageCollector &gc) {
+	printGCPauseStats(con, "Marking slices", gc.getPauseStats(GarbageCollector::kPauseSlice));
+	printGCPauseStats(con, "Minor collections", gc.getPauseStats(GarbageCollector::kPauseMinor));
+	printGCPauseStats(con, "Final phases", gc.getPauseStats(GarbageCollector::kPauseFinal));
+	printGCPauseStats(con, "Sweeping slices", gc.getPauseStats(GarbageCollector::kPauseSweep));
+	printGCPauseStats(con, "Full collections", gc.getPauseStats(GarbageCollector::kPauseFull));
+	con->debugPrintf("%d entries freed, %d promoted\n", gc.getFreedCount(), gc.getPromotedCount());
+}
+
+bool Console::cmdGCStats(int argc, const char **argv) {
+	GarbageCollector *gc = _engine->_gamestate->_segMan->getGarbageCollector();
+
+	if (argc > 1) {
+		if (strcmp(argv[1], "reset") != 0) {
+			debugPrintf("Shows the pause times of the garbage collector.\n");
+			debugPrintf("Usage: %s [reset]\n", argv[0]);
+			return true;
+		}
+
+		gc->resetPauseStats();
+		debugPrintf("Garbage collector statistics reset\n");
+		return true;
+	}
+
+	printGCStats(this, *gc);
+	if (gc->isMarking() || gc->isSweeping())
+		debugPrintf("A major collection is in progress\n");
+	return true;
+}
+
+/**
+ * Simulates game cycles which replace list nodes on a private heap, the
+ * SegManager of the game is not touched.
+ * @return the time taken, in milliseconds
+ */
+static uint32 runGCBenchmark(Console *con, uint listCount, int cycles, bool incremental, bool printStats,
+                             GarbageCollector::PauseStats &finalStats, GarbageCollector::PauseStats &fullStats) {
+	const uint kNodesPerList = 1024;
+	// Node replacements per game cycle
+	const uint kChurn = 256;
+	// Game cycles between two major collections
+	const int kMajorInterval = 64;
+	// Marking or sweeping slices per game cycle
+	const int kSlices = 4;
+
+	Common::RandomSource rnd("sciGCBenchmark");
+	Common::Array<SegmentObj *> heap;
+	heap.push_back(nullptr);
+	ListTable *lists = new ListTable();
+	heap.push_back(lists);
+	NodeTable *nodes = new NodeTable();
+	heap.push_back(nodes);
+
+	GarbageCollector gc(heap, nullptr);
+	Common::Array<reg_t> roots;
+	rnd.setSeed(1);
+
+	for (uint i = 0; i < listCount * (kNodesPerList + 1); i++) {
+		const uint list = i / (kNodesPerList + 1);
+		if (i % (kNodesPerList + 1) == 0) {
+			const reg_t listRef = make_reg32(1, lists->allocEntry());
+			gc.registerAllocation(lists, listRef);
+			lists->at(listRef.getOffset()).first = lists->at(listRef.getOffset()).last = NULL_REG;
+			roots.push_back(listRef);
+			continue;
+		}
+
+		List &l = lists->at(roots[list].getOffset());
+		const reg_t nodeRef = make_reg32(2, nodes->allocEntry());
+		gc.registerAllocation(nodes, nodeRef);
+		Node &n = nodes->at(nodeRef.getOffset());
+		n.pred = l.last;
+		n.succ = NULL_REG;
+		n.key = n.value = make_reg(0, i);
+		if (l.last.isNull())
+			l.first = nodeRef;
+		else
+			nodes->at(l.last.getOffset()).succ = nodeRef;
+		l.last = nodeRef;
+	}
+
+	gc.collectFull(roots);
+	gc.resetPauseStats();
+
+	const uint32 startTime = g_system->getMillis();
+	for (int cycle = 1; cycle <= cycles; cycle++) {
+		for (uint i = 0; i < kChurn; i++) {
+			const reg_t listRef = roots[rnd.getRandomNumber(listCount - 1)];
+			List &l = lists->at(listRef.getOffset());
+			gc.writeBarrier(listRef);
+
+			// Unlink the first node, which becomes garbage
+			const reg_t second = nodes->at(l.first.getOffset()).succ;
+			gc.writeBarrier(second);
+			nodes->at(second.getOffset()).pred = NULL_REG;
+			l.first = second;
+
+			// and append a new one
+			const reg_t nodeRef = make_reg32(2, nodes->allocEntry());
+			gc.registerAllocation(nodes, nodeRef);
+			Node &n = nodes->at(nodeRef.getOffset());
+			n.pred = l.last;
+			n.succ = NULL_REG;
+			n.key = n.value = make_reg(0, i);
+			gc.writeBarrier(l.last);
+			nodes->at(l.last.getOffset()).succ = nodeRef;
+			l.last = nodeRef;
+		}
+
+		if (!incremental) {
+			if (cycle % kMajorInterval == 0)
+				gc.collectFull(roots);
+		} else if (gc.isMarking() || gc.isSweeping()) {
+			for (int i = 0; i < kSlices; i++) {
+				if (gc.isSweeping()) {
+					if (gc.sweepSlice(GarbageCollector::kSweepBudget))
+						break;
+				} else if (gc.markSlice(GarbageCollector::kSliceBudget)) {
+					gc.finishMajor(roots);
+				}
+			}
+		} else if (cycle % kMajorInterval == 0) {
+			gc.startMajor(roots);
+		} else if (gc.needsMinorCollection()) {
+			gc.collectMinor(roots);
+		}
+	}
+	const uint32 time = g_system->getMillis() - startTime;
+
+	if (printStats)
+		printGCStats(con, gc);
+	finalStats = gc.getPauseStats(GarbageCollector::kPauseFinal);
+	fullStats = gc.getPauseStats(GarbageCollector::kPauseFull);
+
+	for (uint i = 1; i < heap.size(); i++)
+		delete heap[i];
+
+	return time;
+}
+
+bool Console::cmdGCBenchmark(int argc, const char **argv) {
+	int cycles = 256;
+
+	if (argc > 1) {
+		cycles = atoi(argv[1]);
+		if (cycles <= 0) {
+			debugPrintf("Simulates game cycles which replace list nodes, and compares the pause times\n");
+			debugPrintf("of full collections with those of incremental and minor ones. Then compares\n");
+			debugPrintf("the final phases of incremental collections with full collections on heaps\n");
+			debugPrintf("of growing size.\n");
+			debugPrintf("Usage: %s [cycles]\n", argv[0]);
+			return true;
+		}
+	}
+
+	// The node table must stay below 64K entries, live and garbage ones
+	const uint kLists = 32;
+	GarbageCollector::PauseStats finalStats, fullStats;
+
+	for (int incremental = 0; incremental < 2; incremental++) {
+		debugPrintf("%s:\n", incremental ? "Incremental" : "Stop-the-world");
+		const uint32 time = runGCBenchmark(this, kLists, cycles, incremental, true, finalStats, fullStats);
+		debugPrintf("%d cycles in %d ms\n", cycles, time);
+	}
+
+	// The final phase only rescans what was modified since the last marking
+	// slice, its pauses do not grow with the heap
+	debugPrintf("Lists of 1024 nodes: full collection max; final phase max\n");
+	for (uint lists = kLists / 8; lists <= kLists; lists *= 2) {
+		runGCBenchmark(this, lists, cycles, false, false, finalStats, fullStats);
+		const GarbageCollector::PauseStats full = fullStats;
+		runGCBenchmark(this, lists, cycles, true, false, finalStats, fullStats);
+		debugPrintf("%2d lists: %d ms, %d references; %d ms, %d references (budget %d)\n", lists,
+		            full.maxTime, full.maxWork, finalStats.maxTime, finalStats.maxWork, GarbageCollector::kSliceBudget);
+	}
+
+	return true;
+}
+
 bool Console::cmdVMVarlist(int argc, const char **argv) {
 	EngineState *s = _engine->_gamestate;
 	const char *varnames[] = {"global", "local", "temp", "param"};
@@ -3268,6 +3594,28 @@ bool Console::cmdScriptSteps(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSelectorLookupCache(int argc, const char **argv) {
+	SelectorLookupCache &cache = _engine->_gamestate->_segMan->getSelectorLookupCache();
+
+	if (argc > 1) {
+		if (strcmp(argv[1], "reset") != 0) {
+			debugPrintf("Shows how often the selector lookups of send instructions were cached.\n");
+			debugPrintf("Usage: %s [reset]\n", argv[0]);
+			return true;
+		}
+
+		cache.resetCounters();
+		debugPrintf("Selector lookup counters reset\n");
+		return true;
+	}
+
+	const uint32 lookups = cache.getHits() + cache.getMisses();
+	debugPrintf("%d send sites cached\n", cache.getSiteCount());
+	debugPrintf("%d hits, %d misses (%d%% hits)\n", cache.getHits(), cache.getMisses(),
+	            lookups ? (int)((uint64)cache.getHits() * 100 / lookups) : 0);
+	return true;
+}
+
 bool Console::cmdScriptObjects(int argc, const char **argv) {
 	int curScriptNr = -1;
 
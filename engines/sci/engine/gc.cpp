@@ -22,6 +22,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 #ifdef ENABLE_SCI32
@@ -30,25 +31,7 @@
 
 namespace Sci {
 
-//#define GC_DEBUG_CODE
-
-#ifdef GC_DEBUG_CODE
-const char *segmentTypeNames[] = {
-	"invalid",   // 0
-	"script",    // 1
-	"clones",    // 2
-	"locals",    // 3
-	"stack",     // 4
-	"obsolete",  // 5: obsolete system strings
-	"lists",     // 6
-	"nodes",     // 7
-	"hunk",      // 8
-	"dynmem",    // 9
-	"obsolete",  // 10: obsolete string fragments
-	"array",     // 11: SCI32 arrays
-	"obsolete"   // 12: obsolete SCI32 strings
-};
-#endif
+static const uint kUnlimitedBudget = 0xFFFFFFFF;
 
 void WorklistManager::push(reg_t reg) {
 	if (!reg.getSegment()) // No numbers
@@ -99,14 +82,12 @@ static void processWorkList(SegManager *segMan, WorklistManager &wm, const Commo
 	}
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
+void listRoots(EngineState *s, Common::Array<reg_t> &roots) {
 	assert(!s->_executionStack.empty());
 
-	WorklistManager wm;
-
 	// Initialize registers
-	wm.push(s->r_acc);
-	wm.push(s->r_prev);
+	roots.push_back(s->r_acc);
+	roots.push_back(s->r_prev);
 
 	// Initialize value stack
 	// We do this one by hand since the stack doesn't know the current execution stack
@@ -121,7 +102,7 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	const StackPtr sp = iter->sp;
 
 	for (reg_t *pos = s->stack_base; pos < sp; pos++)
-		wm.push(*pos);
+		roots.push_back(*pos);
 
 	debugC(kDebugLevelGC, "[GC] -- Finished adding value stack");
 
@@ -131,41 +112,56 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 		const ExecStack &es = *iter;
 
 		if (es.type != EXEC_STACK_TYPE_KERNEL) {
-			wm.push(es.objp);
-			wm.push(es.sendp);
+			roots.push_back(es.objp);
+			roots.push_back(es.sendp);
 			if (es.type == EXEC_STACK_TYPE_VARSELECTOR)
-				wm.push(*(es.getVarPointer(s->_segMan)));
+				roots.push_back(*(es.getVarPointer(s->_segMan)));
 		}
 	}
 
 	debugC(kDebugLevelGC, "[GC] -- Finished adding execution stack");
 
-	const Common::Array<SegmentObj *> &heap = s->_segMan->getSegments();
-	uint heapSize = heap.size();
+	if (g_sci->_gfxPorts) {
+		WorklistManager wm;
+		g_sci->_gfxPorts->processEngineHunkList(wm);
+		roots.push_back(wm._worklist);
+	}
 
-	for (uint i = 1; i < heapSize; i++) {
-		if (heap[i]) {
-			// Init: Explicitly loaded scripts
-			if (heap[i]->getType() == SEG_TYPE_SCRIPT) {
-				Script *script = (Script *)heap[i];
+#ifdef ENABLE_SCI32
+	// Init: Explicitly opted-out bitmaps
+	const Common::Array<SegmentObj *> &heap = s->_segMan->getSegments();
+	for (uint i = 1; i < heap.size(); i++) {
+		if (heap[i] && heap[i]->getType() == SEG_TYPE_BITMAP) {
+			BitmapTable *bt = static_cast<BitmapTable *>(heap[i]);
 
-				if (script->getLockers()) { // Explicitly loaded?
-					wm.pushArray(script->listObjectReferences());
+			for (uint j = 0; j < bt->_table.size(); j++) {
+				if (bt->_table[j].data && bt->_table[j].data->getShouldGC() == false) {
+					roots.push_back(make_reg(i, j));
 				}
 			}
+		}
+	}
+#endif
+}
 
-#ifdef ENABLE_SCI32
-			// Init: Explicitly opted-out bitmaps
-			else if (heap[i]->getType() == SEG_TYPE_BITMAP) {
-				BitmapTable *bt = static_cast<BitmapTable *>(heap[i]);
-
-				for (uint j = 0; j < bt->_table.size(); j++) {
-					if (bt->_table[j].data && bt->_table[j].data->getShouldGC() == false) {
-						wm.push(make_reg(i, j));
-					}
-				}
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
+
+	Common::Array<reg_t> roots;
+	listRoots(s, roots);
+	wm.pushArray(roots);
+
+	const Common::Array<SegmentObj *> &heap = s->_segMan->getSegments();
+	uint heapSize = heap.size();
+
+	for (uint i = 1; i < heapSize; i++) {
+		// Init: Explicitly loaded scripts
+		if (heap[i] && heap[i]->getType() == SEG_TYPE_SCRIPT) {
+			Script *script = (Script *)heap[i];
+
+			if (script->getLockers()) { // Explicitly loaded?
+				wm.pushArray(script->listObjectReferences());
 			}
-#endif
 		}
 	}
 
@@ -173,66 +169,488 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 
 	processWorkList(s->_segMan, wm, heap);
 
-	if (g_sci->_gfxPorts)
-		g_sci->_gfxPorts->processEngineHunkList(wm);
-
 	return normalizeAddresses(s->_segMan, wm._map);
 }
 
 void run_gc(EngineState *s) {
-	SegManager *segMan = s->_segMan;
-
-	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
-#ifdef GC_DEBUG_CODE
-	const char *segnames[SEG_TYPE_MAX + 1];
-	int segcount[SEG_TYPE_MAX + 1];
-	memset(segnames, 0, sizeof(segnames));
-	memset(segcount, 0, sizeof(segcount));
-#endif
 
-	// Compute the set of all segments references currently in use.
-	AddrSet *activeRefs = findAllActiveReferences(s);
+	Common::Array<reg_t> roots;
+	listRoots(s, roots);
+	s->_segMan->getGarbageCollector()->collectFull(roots);
+}
 
-	// Iterate over all segments, and check for each whether it
-	// contains stuff that can be collected.
-	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
-	for (uint seg = 1; seg < heap.size(); seg++) {
-		SegmentObj *mobj = heap[seg];
+void run_gc_step(EngineState *s) {
+	// Kernel functions may hold pointers to entries, or entries which are
+	// not referenced from anywhere yet, while they run scripts. Only the
+	// outermost VM collects.
+	if (s->executionStackBase)
+		return;
 
-		if (mobj != NULL) {
-#ifdef GC_DEBUG_CODE
-			const SegmentType type = mobj->getType();
-			segnames[type] = segmentTypeNames[type];
-#endif
+	GarbageCollector *gc = s->_segMan->getGarbageCollector();
+	Common::Array<reg_t> roots;
+
+	if (gc->isMarking() || gc->isSweeping()) {
+		if (!gc->isSliceDue())
+			return;
+		if (gc->isSweeping()) {
+			gc->sweepSlice(GarbageCollector::kSweepBudget);
+		} else if (gc->markSlice(GarbageCollector::kSliceBudget)) {
+			listRoots(s, roots);
+			gc->finishMajor(roots);
+		}
+	} else if (s->gcCountDown <= 0) {
+		s->gcCountDown = s->scriptGCInterval;
+		listRoots(s, roots);
+		gc->startMajor(roots);
+	} else if (gc->needsMinorCollection()) {
+		listRoots(s, roots);
+		gc->collectMinor(roots);
+	}
+}
 
-			// Get a list of all deallocatable objects in this segment,
-			// then free any which are not referenced from somewhere.
-			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
-			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
-				const reg_t addr = *it;
-				if (!activeRefs->contains(addr)) {
-					// Not found -> we can free it
-					mobj->freeAtAddress(segMan, addr);
-					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
-#ifdef GC_DEBUG_CODE
-					segcount[type]++;
-#endif
-				}
+GarbageCollector::GarbageCollector(const Common::Array<SegmentObj *> &heap, SegManager *segMan) :
+	_heap(heap), _segMan(segMan) {
+	reset();
+	resetPauseStats();
+}
+
+void GarbageCollector::reset() {
+	_marking = false;
+	_minor = false;
+	_sweeping = false;
+	_sliceCountDown = kSliceInterval;
+	_youngEntries.clear();
+	_rememberedEntries.clear();
+	_rememberedSegments.clear();
+	_segmentRemembered.clear();
+	_grayEntries.clear();
+	_grayScripts.clear();
+	_scriptMarks.clear();
+}
+
+void GarbageCollector::resetPauseStats() {
+	memset(_pauseStats, 0, sizeof(_pauseStats));
+	_work = 0;
+	_freedCount = 0;
+	_promotedCount = 0;
+}
+
+void GarbageCollector::rememberHeap() {
+	for (uint seg = 1; seg < _heap.size(); seg++) {
+		SegmentObj *mobj = _heap[seg];
+		if (!mobj)
+			continue;
+
+		if (mobj->getType() == SEG_TYPE_SCRIPT || mobj->getType() == SEG_TYPE_LOCALS) {
+			writeBarrier(make_reg(seg, 0));
+			continue;
+		}
+
+		const uint entryCount = mobj->getGCEntryCount();
+		for (uint i = 0; i < entryCount; i++) {
+			byte *flags = mobj->getGCFlags(i);
+			if (flags) {
+				*flags = kGCEntryOld;
+				_rememberedEntries.push_back(make_reg32(seg, i));
 			}
+		}
+	}
+}
+
+void GarbageCollector::registerAllocation(SegmentObj *mobj, reg_t addr) {
+	byte *flags = mobj->getGCFlags(addr.getOffset());
+
+	if (_marking) {
+		// The collection in progress may already have scanned the entries
+		// which will refer to this one, so it survives, and its own
+		// references are scanned like those of the reached entries
+		*flags = kGCEntryMarked;
+		_grayEntries.push_back(addr);
+	} else if (_sweeping) {
+		// There are no young entries while sweeping, and the sweeping slices
+		// must not free the entry if they have yet to reach it
+		*flags = kGCEntryOld | kGCEntryScanned;
+		if (addr.getSegment() > _sweepSegment || (addr.getSegment() == _sweepSegment && addr.getOffset() >= _sweepOffset))
+			*flags |= kGCEntryMarked;
+	} else {
+		_youngEntries.push_back(addr);
+	}
+}
 
+void GarbageCollector::writeBarrier(reg_t addr) {
+	const SegmentId segment = addr.getSegment();
+	if (!segment || segment >= _heap.size() || !_heap[segment])
+		return;
+
+	SegmentObj *mobj = _heap[segment];
+	if (mobj->getType() == SEG_TYPE_SCRIPT || mobj->getType() == SEG_TYPE_LOCALS) {
+		if (segment >= _segmentRemembered.size())
+			_segmentRemembered.resize(segment + 1);
+
+		if (!_segmentRemembered[segment]) {
+			_segmentRemembered[segment] = 1;
+			_rememberedSegments.push_back(segment);
 		}
+		return;
 	}
 
-	delete activeRefs;
+	// Entries which were not scanned yet are remembered already, or are
+	// young and traced by the next minor collection anyway
+	byte *flags = mobj->getGCFlags(addr.getOffset());
+	if (flags && (*flags & kGCEntryScanned)) {
+		*flags &= ~kGCEntryScanned;
+		_rememberedEntries.push_back(addr);
+	}
+}
 
-#ifdef GC_DEBUG_CODE
-	// Output debug summary of garbage collection
-	debugC(kDebugLevelGC, "[GC] Summary:");
-	for (int i = 0; i <= SEG_TYPE_MAX; i++)
-		if (segcount[i])
-			debugC(kDebugLevelGC, "\t%d\t* %s", segcount[i], segnames[i]);
-#endif
+bool GarbageCollector::isSliceDue() {
+	if (--_sliceCountDown)
+		return false;
+
+	_sliceCountDown = kSliceInterval;
+	return true;
+}
+
+void GarbageCollector::visit(reg_t reg) {
+	_work++;
+
+	const SegmentId segment = reg.getSegment();
+	if (!segment || segment >= _heap.size() || !_heap[segment])
+		return; // No numbers
+
+	SegmentObj *mobj = _heap[segment];
+	switch (mobj->getType()) {
+	case SEG_TYPE_SCRIPT:
+		markScript(segment);
+		return;
+	case SEG_TYPE_LOCALS:
+		if (!_minor)
+			markScript(mobj->findCanonicAddress(_segMan, reg).getSegment());
+		return;
+	default:
+		break;
+	}
+
+	byte *flags = mobj->getGCFlags(reg.getOffset());
+	if (!flags || (*flags & kGCEntryMarked))
+		return;
+
+	// Minor collections leave the old generation alone
+	if (_minor && (*flags & kGCEntryOld))
+		return;
+
+	*flags |= kGCEntryMarked;
+	_grayEntries.push_back(reg);
+}
+
+void GarbageCollector::visitArray(const Common::Array<reg_t> &refs) {
+	for (Common::Array<reg_t>::const_iterator it = refs.begin(); it != refs.end(); ++it)
+		visit(*it);
+}
+
+void GarbageCollector::markScript(SegmentId segment) {
+	// Scripts are not collected by minor collections
+	if (_minor)
+		return;
+
+	if (segment >= _scriptMarks.size())
+		_scriptMarks.resize(segment + 1);
+
+	if (_scriptMarks[segment])
+		return;
+
+	_scriptMarks[segment] = 1;
+	_grayScripts.push_back(segment);
+}
+
+void GarbageCollector::scanScript(SegmentId segment) {
+	if (segment >= _heap.size() || !_heap[segment] || _heap[segment]->getType() != SEG_TYPE_SCRIPT)
+		return;
+
+	// The objects of the script, and its local variables
+	const Common::Array<reg_t> refs = static_cast<Script *>(_heap[segment])->listObjectReferences();
+	for (Common::Array<reg_t>::const_iterator it = refs.begin(); it != refs.end(); ++it)
+		visitArray(_heap[it->getSegment()]->listAllOutgoingReferences(*it));
+}
+
+void GarbageCollector::scanEntry(reg_t addr) {
+	const SegmentId segment = addr.getSegment();
+	SegmentObj *mobj = segment < _heap.size() ? _heap[segment] : NULL;
+	byte *flags = mobj ? mobj->getGCFlags(addr.getOffset()) : NULL;
+
+	// The entry may have been freed since it was reached
+	if (!flags)
+		return;
+
+	*flags |= kGCEntryScanned;
+	visitArray(mobj->listAllOutgoingReferences(addr));
+}
+
+bool GarbageCollector::drain(uint budget) {
+	const uint32 startWork = _work;
+	while (_work - startWork < budget) {
+		if (!_grayScripts.empty()) {
+			const SegmentId segment = _grayScripts.back();
+			_grayScripts.pop_back();
+			scanScript(segment);
+		} else if (!_grayEntries.empty()) {
+			const reg_t addr = _grayEntries.back();
+			_grayEntries.pop_back();
+			scanEntry(addr);
+		} else {
+			return true;
+		}
+	}
+
+	return _grayScripts.empty() && _grayEntries.empty();
+}
+
+SegmentId GarbageCollector::getScriptSegment(SegmentId segment) const {
+	if (segment >= _heap.size() || !_heap[segment])
+		return 0;
+
+	switch (_heap[segment]->getType()) {
+	case SEG_TYPE_SCRIPT:
+		return segment;
+	case SEG_TYPE_LOCALS:
+		return _heap[segment]->findCanonicAddress(_segMan, make_reg(segment, 0)).getSegment();
+	default:
+		return 0;
+	}
+}
+
+void GarbageCollector::clearRememberedSet() {
+	for (Common::Array<SegmentId>::const_iterator it = _rememberedSegments.begin(); it != _rememberedSegments.end(); ++it)
+		_segmentRemembered[*it] = 0;
+	_rememberedSegments.clear();
+	_rememberedEntries.clear();
+}
+
+void GarbageCollector::collectMinor(const Common::Array<reg_t> &roots) {
+	const uint32 startTime = g_system->getMillis();
+	const uint32 startWork = _work;
+
+	_minor = true;
+	visitArray(roots);
+
+	// Young entries are only referenced from the roots, from other young
+	// entries, and from what was modified since the last collection
+	for (Common::Array<SegmentId>::const_iterator it = _rememberedSegments.begin(); it != _rememberedSegments.end(); ++it) {
+		const SegmentId script = getScriptSegment(*it);
+		if (script)
+			scanScript(script);
+	}
+
+	for (Common::Array<reg_t>::const_iterator it = _rememberedEntries.begin(); it != _rememberedEntries.end(); ++it) {
+		SegmentObj *mobj = it->getSegment() < _heap.size() ? _heap[it->getSegment()] : NULL;
+		const byte *flags = mobj ? mobj->getGCFlags(it->getOffset()) : NULL;
+		if (flags && (*flags & (kGCEntryOld | kGCEntryScanned)) == kGCEntryOld)
+			_grayEntries.push_back(*it);
+	}
+
+	clearRememberedSet();
+	drain(kUnlimitedBudget);
+	_minor = false;
+
+	for (Common::Array<reg_t>::const_iterator it = _youngEntries.begin(); it != _youngEntries.end(); ++it) {
+		SegmentObj *mobj = it->getSegment() < _heap.size() ? _heap[it->getSegment()] : NULL;
+		byte *flags = mobj ? mobj->getGCFlags(it->getOffset()) : NULL;
+
+		// Freed since, or listed twice because its slot was reused
+		if (!flags || (*flags & kGCEntryOld))
+			continue;
+
+		if (*flags & kGCEntryMarked) {
+			*flags = kGCEntryOld | kGCEntryScanned;
+			_promotedCount++;
+		} else {
+			freeEntry(mobj, *it);
+		}
+	}
+
+	_youngEntries.clear();
+	recordPause(kPauseMinor, startTime, startWork);
+}
+
+void GarbageCollector::beginMajor(const Common::Array<reg_t> &roots) {
+	// No entry is marked outside of major collections
+	_marking = true;
+	_sliceCountDown = kSliceInterval;
+	_grayEntries.clear();
+	_grayScripts.clear();
+	_scriptMarks.clear();
+	_scriptMarks.resize(_heap.size());
+
+	// Explicitly loaded scripts
+	for (uint seg = 1; seg < _heap.size(); seg++) {
+		SegmentObj *mobj = _heap[seg];
+		if (mobj && mobj->getType() == SEG_TYPE_SCRIPT && static_cast<Script *>(mobj)->getLockers())
+			markScript(seg);
+	}
+
+	visitArray(roots);
+}
+
+bool GarbageCollector::remark(const Common::Array<reg_t> &roots, uint budget) {
+	visitArray(roots);
+
+	// Scripts loaded since the collection started
+	for (uint seg = 1; seg < _heap.size(); seg++) {
+		SegmentObj *mobj = _heap[seg];
+		if (mobj && mobj->getType() == SEG_TYPE_SCRIPT && static_cast<Script *>(mobj)->getLockers())
+			markScript(seg);
+	}
+
+	// Reached scripts and entries modified since they were scanned
+	for (Common::Array<SegmentId>::const_iterator it = _rememberedSegments.begin(); it != _rememberedSegments.end(); ++it) {
+		const SegmentId script = getScriptSegment(*it);
+		if (script && script < _scriptMarks.size() && _scriptMarks[script])
+			_grayScripts.push_back(script);
+	}
+
+	for (Common::Array<reg_t>::const_iterator it = _rememberedEntries.begin(); it != _rememberedEntries.end(); ++it) {
+		SegmentObj *mobj = it->getSegment() < _heap.size() ? _heap[it->getSegment()] : NULL;
+		const byte *flags = mobj ? mobj->getGCFlags(it->getOffset()) : NULL;
+		if (flags && (*flags & (kGCEntryMarked | kGCEntryScanned)) == kGCEntryMarked)
+			_grayEntries.push_back(*it);
+	}
+
+	clearRememberedSet();
+	return drain(budget);
+}
+
+void GarbageCollector::beginSweep() {
+	_marking = false;
+	_sweeping = true;
+	_sweepSegment = 1;
+	_sweepOffset = 0;
+
+	// Scripts are few, they are swept at once. This frees the unreached
+	// ones which were marked as deleted.
+	for (uint seg = 1; seg < _heap.size(); seg++) {
+		SegmentObj *mobj = _heap[seg];
+		if (mobj && mobj->getType() == SEG_TYPE_SCRIPT && (seg >= _scriptMarks.size() || !_scriptMarks[seg]))
+			mobj->freeAtAddress(_segMan, make_reg(seg, 0));
+	}
+
+	_scriptMarks.clear();
+	// The young entries are swept with the others
+	_youngEntries.clear();
+}
+
+bool GarbageCollector::sweep(uint budget) {
+	uint swept = 0;
+
+	for (; _sweepSegment < _heap.size(); _sweepSegment++, _sweepOffset = 0) {
+		SegmentObj *mobj = _heap[_sweepSegment];
+		if (!mobj)
+			continue;
+
+		const uint entryCount = mobj->getGCEntryCount();
+		for (; _sweepOffset < entryCount; _sweepOffset++) {
+			if (swept == budget)
+				return false;
+			swept++;
+			_work++;
+
+			byte *flags = mobj->getGCFlags(_sweepOffset);
+			if (!flags)
+				continue;
+
+			if (*flags & kGCEntryMarked) {
+				if (!(*flags & kGCEntryOld))
+					_promotedCount++;
+				// Entries modified since the final phase stay remembered
+				*flags = (*flags & ~kGCEntryMarked) | kGCEntryOld;
+			} else {
+				freeEntry(mobj, make_reg32(_sweepSegment, _sweepOffset));
+			}
+		}
+	}
+
+	_sweeping = false;
+	return true;
+}
+
+void GarbageCollector::freeEntry(SegmentObj *mobj, reg_t addr) {
+	mobj->freeAtAddress(_segMan, addr);
+
+	byte *flags = mobj->getGCFlags(addr.getOffset());
+	if (flags) {
+		// Arrays and bitmaps are only freed explicitly. They stay in the
+		// old generation, and the next minor collection scans them.
+		*flags = kGCEntryOld;
+		_rememberedEntries.push_back(addr);
+	} else {
+		debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+		_freedCount++;
+	}
+}
+
+void GarbageCollector::startMajor(const Common::Array<reg_t> &roots) {
+	const uint32 startTime = g_system->getMillis();
+	const uint32 startWork = _work;
+	beginMajor(roots);
+	recordPause(kPauseSlice, startTime, startWork);
+}
+
+bool GarbageCollector::markSlice(uint budget) {
+	const uint32 startTime = g_system->getMillis();
+	const uint32 startWork = _work;
+	const bool done = drain(budget);
+	recordPause(kPauseSlice, startTime, startWork);
+	return done;
+}
+
+bool GarbageCollector::finishMajor(const Common::Array<reg_t> &roots) {
+	const uint32 startTime = g_system->getMillis();
+	const uint32 startWork = _work;
+	// The marking slices go on if the modifications since the last one
+	// lead to too much work
+	const bool done = remark(roots, kSliceBudget);
+	if (done)
+		beginSweep();
+	recordPause(kPauseFinal, startTime, startWork);
+	return done;
+}
+
+bool GarbageCollector::sweepSlice(uint budget) {
+	const uint32 startTime = g_system->getMillis();
+	const uint32 startWork = _work;
+	const bool done = sweep(budget);
+	recordPause(kPauseSweep, startTime, startWork);
+	return done;
+}
+
+void GarbageCollector::collectFull(const Common::Array<reg_t> &roots) {
+	const uint32 startTime = g_system->getMillis();
+	const uint32 startWork = _work;
+	if (_sweeping)
+		sweep(kUnlimitedBudget);
+	if (!_marking)
+		beginMajor(roots);
+	remark(roots, kUnlimitedBudget);
+	beginSweep();
+	sweep(kUnlimitedBudget);
+	recordPause(kPauseFull, startTime, startWork);
+}
+
+void GarbageCollector::recordPause(PauseType type, uint32 startTime, uint32 startWork) {
+	const uint32 time = g_system->getMillis() - startTime;
+	const uint32 work = _work - startWork;
+
+	PauseStats &stats = _pauseStats[type];
+	stats.count++;
+	stats.totalTime += time;
+	stats.maxTime = MAX(stats.maxTime, time);
+	stats.totalWork += work;
+	stats.maxWork = MAX(stats.maxWork, work);
+
+	uint bucket = 0;
+	for (uint32 t = time; t && bucket < kPauseBuckets - 1; t >>= 1)
+		bucket++;
+	stats.histogram[bucket]++;
 }
 
 } // End of namespace Sci
@@ -55,6 +55,24 @@ AddrSet *findAllActiveReferences(EngineState *s);
  */
 void run_gc(EngineState *s);
 
+/**
+ * Does a bounded amount of garbage collection work, called by the VM before
+ * each kernel call. Depending on the state of the collector, this runs a
+ * minor collection, starts a major one, or does a marking slice of the
+ * major collection in progress.
+ * @param s The state in which we should gc
+ */
+void run_gc_step(EngineState *s);
+
+/**
+ * Lists the references which the engine keeps outside of the heap: the
+ * registers, the value and execution stacks, the window hunks and the
+ * bitmaps which are excluded from garbage collection.
+ * @param s The state to gather all information from
+ * @param roots The array to append the references to
+ */
+void listRoots(EngineState *s, Common::Array<reg_t> &roots);
+
 struct WorklistManager {
 	Common::Array<reg_t> _worklist;
 	AddrSet _map;	// used for 2 contains() calls, inside push() and run_gc()
@@ -63,6 +81,175 @@ struct WorklistManager {
 	void pushArray(const Common::Array<reg_t> &tmp);
 };
 
+/**
+ * Incremental, generational mark and sweep collector for the entries of the
+ * segment tables (clones, lists, nodes, hunks, arrays and bitmaps) and for
+ * the scripts marked as deleted.
+ *
+ * Entries start out young. A minor collection traces the young entries
+ * reachable from the roots and from the remembered set: the scripts, locals
+ * and old entries modified since they were last scanned. It frees the
+ * unreachable young entries and promotes the others. A major collection
+ * traces the whole heap in bounded slices. Its final phase rescans the
+ * roots and the remembered set within a budget, and goes back to marking
+ * slices if that is not enough. Unreached entries are then freed by bounded
+ * sweeping slices.
+ *
+ * Both rely on the write barrier, writeBarrier(). The segment manager calls
+ * it whenever it hands out an entry, an object or a pointer into a segment,
+ * and the VM calls it when it writes to global or local variables or to
+ * the properties of the current object.
+ */
+class GarbageCollector {
+public:
+	enum PauseType {
+		kPauseSlice,	///< Marking slice of a major collection
+		kPauseMinor,	///< Minor collection
+		kPauseFinal,	///< Final phase of a major collection
+		kPauseSweep,	///< Sweeping slice of a major collection
+		kPauseFull,		///< Complete collection, e.g. on room changes
+		kPauseTypeCount
+	};
+
+	enum {
+		/** Pause time buckets: 0, 1, 2-3, 4-7, 8-15, 16-31 and 32+ ms */
+		kPauseBuckets = 7,
+		/** Young entries allocated before a minor collection is due */
+		kMinorThreshold = 4096,
+		/** Kernel calls between two marking or sweeping slices */
+		kSliceInterval = 64,
+		/** References visited by a marking slice, or by the final phase */
+		kSliceBudget = 2048,
+		/** Entries checked by a sweeping slice */
+		kSweepBudget = 8192
+	};
+
+	struct PauseStats {
+		uint32 count;
+		uint32 totalTime;	///< In milliseconds
+		uint32 maxTime;		///< In milliseconds
+		uint32 totalWork;	///< References visited and entries swept
+		uint32 maxWork;
+		uint32 histogram[kPauseBuckets];
+	};
+
+	GarbageCollector(const Common::Array<SegmentObj *> &heap, SegManager *segMan);
+
+	/** Abandons the collection in progress, when the heap is emptied. */
+	void reset();
+
+	/**
+	 * Treats all scripts and entries as old and modified, after the heap
+	 * was replaced by a restored game.
+	 */
+	void rememberHeap();
+
+	/**
+	 * Must be called for each entry allocated in a segment table. Entries
+	 * allocated during a major collection survive it.
+	 */
+	void registerAllocation(SegmentObj *mobj, reg_t addr);
+
+	/**
+	 * Write barrier: must be called whenever the entry, script or local
+	 * variables at an address may be modified, so that the collector scans
+	 * them again.
+	 * @param addr	address of the modified entry, script or variables
+	 */
+	void writeBarrier(reg_t addr);
+
+	bool isMarking() const { return _marking; }
+	bool isSweeping() const { return _sweeping; }
+
+	/**
+	 * Counts down the kernel calls between two marking or sweeping slices.
+	 * @return true if a slice is due
+	 */
+	bool isSliceDue();
+
+	bool needsMinorCollection() const { return !_marking && !_sweeping && _youngEntries.size() >= kMinorThreshold; }
+
+	void collectMinor(const Common::Array<reg_t> &roots);
+	void startMajor(const Common::Array<reg_t> &roots);
+
+	/**
+	 * Does about budget references worth of marking.
+	 * @return true if only the final phase is left
+	 */
+	bool markSlice(uint budget);
+
+	/**
+	 * Rescans the roots and the remembered set, and starts sweeping if this
+	 * completes the marking within kSliceBudget references.
+	 * @return true if the marking is complete
+	 */
+	bool finishMajor(const Common::Array<reg_t> &roots);
+
+	/**
+	 * Sweeps about budget entries.
+	 * @return true if the major collection is complete
+	 */
+	bool sweepSlice(uint budget);
+
+	/** Runs a complete major collection, finishing the one in progress. */
+	void collectFull(const Common::Array<reg_t> &roots);
+
+	const PauseStats &getPauseStats(PauseType type) const { return _pauseStats[type]; }
+	void resetPauseStats();
+	uint32 getFreedCount() const { return _freedCount; }
+	uint32 getPromotedCount() const { return _promotedCount; }
+
+private:
+	void visit(reg_t reg);
+	void visitArray(const Common::Array<reg_t> &refs);
+	void markScript(SegmentId segment);
+	void scanScript(SegmentId segment);
+	void scanEntry(reg_t addr);
+	bool drain(uint budget);
+	void freeEntry(SegmentObj *mobj, reg_t addr);
+	SegmentId getScriptSegment(SegmentId segment) const;
+	void clearRememberedSet();
+
+	void beginMajor(const Common::Array<reg_t> &roots);
+	bool remark(const Common::Array<reg_t> &roots, uint budget);
+	void beginSweep();
+	bool sweep(uint budget);
+
+	void recordPause(PauseType type, uint32 startTime, uint32 startWork);
+
+	const Common::Array<SegmentObj *> &_heap;
+	SegManager *_segMan;
+
+	bool _marking;
+	bool _minor;
+	bool _sweeping;
+	uint _sliceCountDown;
+
+	/** Entries allocated since the last collection */
+	Common::Array<reg_t> _youngEntries;
+
+	/** Old entries modified since they were scanned */
+	Common::Array<reg_t> _rememberedEntries;
+	/** Script and locals segments modified since they were scanned */
+	Common::Array<SegmentId> _rememberedSegments;
+	/** Whether a segment is in _rememberedSegments, by segment */
+	Common::Array<byte> _segmentRemembered;
+
+	Common::Array<reg_t> _grayEntries;
+	Common::Array<SegmentId> _grayScripts;
+	/** Whether a script was reached, by segment */
+	Common::Array<byte> _scriptMarks;
+
+	/** Position of the sweeping slices */
+	uint _sweepSegment;
+	uint _sweepOffset;
+
+	uint32 _work;
+	uint32 _freedCount;
+	uint32 _promotedCount;
+	PauseStats _pauseStats[kPauseTypeCount];
+};
+
 
 } // End of namespace Sci
 
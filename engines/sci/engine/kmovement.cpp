@@ -363,6 +363,7 @@ reg_t kDoBresen(EngineState *s, int argc, reg_t *argv) {
 
 		if (collision) {
 			// We restore the backup of the client variables
+			segMan->writeBarrier(client);
 			for (uint i = 0; i < clientVarNum; ++i)
 				clientObject->getVariableRef(i) = clientBackup[i];
 
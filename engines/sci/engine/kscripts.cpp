@@ -29,6 +29,7 @@
 #include "sci/engine/kernel.h"
 #ifdef ENABLE_SCI32
 #include "sci/engine/features.h"
+#include "sci/graphics/celobj32.h"
 #include "sci/sound/audio32.h"
 #endif
 
@@ -46,6 +47,13 @@ reg_t kLoad(EngineState *s, int argc, reg_t *argv) {
 	if (restype == kResourceTypeMemory)
 		return s->_segMan->allocateHunkEntry("kLoad()", resnr);
 
+#ifdef ENABLE_SCI32
+	// Scripts load the views and pics of a room before drawing them, so
+	// decompress their cels now instead of during the first frames
+	if (restype == kResourceTypeView || restype == kResourceTypePic)
+		CelObj::prefetch(restype, resnr);
+#endif
+
 	return make_reg(0, ((restype << 11) | resnr)); // Return the resource identifier as handle
 }
 
@@ -32,6 +32,7 @@
 #include "sci/event.h"
 
 #include "sci/engine/features.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/state.h"
 #include "sci/engine/message.h"
@@ -337,6 +338,9 @@ void SegManager::saveLoadWithSerializer(Common::Serializer &s) {
 #endif
 			}
 		}
+
+		// The collector knows nothing about the restored entries
+		_garbageCollector->rememberHeap();
 	}
 }
 
@@ -23,6 +23,7 @@
 #include "sci/sci.h"
 #include "sci/engine/seg_manager.h"
 #include "sci/engine/state.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/script.h"
 #ifdef ENABLE_SCI32
 #include "sci/engine/guest_additions.h"
@@ -34,6 +35,7 @@ namespace Sci {
 SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
 	: _resMan(resMan), _scriptPatcher(scriptPatcher) {
 	_heap.push_back(0);
+	_garbageCollector = new GarbageCollector(_heap, this);
 
 	_clonesSegId = 0;
 	_listsSegId = 0;
@@ -53,6 +55,7 @@ SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
 
 SegManager::~SegManager() {
 	resetSegMan();
+	delete _garbageCollector;
 }
 
 void SegManager::resetSegMan() {
@@ -63,6 +66,7 @@ void SegManager::resetSegMan() {
 	}
 
 	_heap.clear();
+	_garbageCollector->reset();
 
 	// And reinitialize
 	_heap.push_back(0);
@@ -167,6 +171,7 @@ void SegManager::deallocate(SegmentId seg) {
 	if (mobj->getType() == SEG_TYPE_SCRIPT) {
 		Script *scr = (Script *)mobj;
 		_scriptSegMap.erase(scr->getScriptNumber());
+		_selectorLookupCache.clear();
 		if (scr->getLocalsSegment()) {
 			// Check if the locals segment has already been deallocated.
 			// If the locals block has been stored in a segment with an ID
@@ -250,9 +255,10 @@ Object *SegManager::getObject(reg_t pos) const {
 	if (mobj != NULL) {
 		if (mobj->getType() == SEG_TYPE_CLONES) {
 			CloneTable &ct = *(CloneTable *)mobj;
-			if (ct.isValidEntry(pos.getOffset()))
+			if (ct.isValidEntry(pos.getOffset())) {
+				_garbageCollector->writeBarrier(pos);
 				obj = &(ct[pos.getOffset()]);
-			else
+			} else
 				warning("getObject(): Trying to get an invalid object");
 		} else if (mobj->getType() == SEG_TYPE_SCRIPT) {
 			Script *scr = (Script *)mobj;
@@ -405,6 +411,7 @@ reg_t SegManager::allocateHunkEntry(const char *hunk_type, int size) {
 	offset = table->allocEntry();
 
 	reg_t addr = make_reg(_hunksSegId, offset);
+	_garbageCollector->registerAllocation(table, addr);
 	Hunk *h = &table->at(offset);
 
 	if (!h)
@@ -440,6 +447,7 @@ Clone *SegManager::allocateClone(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_clonesSegId, offset);
+	_garbageCollector->registerAllocation(table, *addr);
 	return &table->at(offset);
 }
 
@@ -454,6 +462,7 @@ List *SegManager::allocateList(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_listsSegId, offset);
+	_garbageCollector->registerAllocation(table, *addr);
 	return &table->at(offset);
 }
 
@@ -468,6 +477,7 @@ Node *SegManager::allocateNode(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_nodesSegId, offset);
+	_garbageCollector->registerAllocation(table, *addr);
 	return &table->at(offset);
 }
 
@@ -494,6 +504,7 @@ List *SegManager::lookupList(reg_t addr) {
 		return NULL;
 	}
 
+	_garbageCollector->writeBarrier(addr);
 	return &(lt[addr.getOffset()]);
 }
 
@@ -518,6 +529,7 @@ Node *SegManager::lookupNode(reg_t addr, bool stopOnDiscarded) {
 		return NULL;
 	}
 
+	_garbageCollector->writeBarrier(addr);
 	return &(nt[addr.getOffset()]);
 }
 
@@ -531,9 +543,14 @@ SegmentRef SegManager::dereference(reg_t pointer) {
 	}
 
 	SegmentObj *mobj = _heap[pointer.getSegment()];
+	writeBarrier(pointer);
 	return mobj->dereference(pointer);
 }
 
+void SegManager::writeBarrier(reg_t addr) {
+	_garbageCollector->writeBarrier(addr);
+}
+
 static void *derefPtr(SegManager *segMan, reg_t pointer, int entries, bool wantRaw) {
 	SegmentRef ret = segMan->dereference(pointer);
 
@@ -895,6 +912,7 @@ SciArray *SegManager::allocateArray(SciArrayType type, uint16 size, reg_t *addr)
 	offset = table->allocEntry();
 
 	*addr = make_reg(_arraysSegId, offset);
+	_garbageCollector->registerAllocation(table, *addr);
 
 	SciArray *array = &table->at(offset);
 	array->setType(type);
@@ -911,6 +929,7 @@ SciArray *SegManager::lookupArray(reg_t addr) {
 	if (!arrayTable.isValidEntry(addr.getOffset()))
 		error("Attempt to use non-array %04x:%04x as array", PRINT_REG(addr));
 
+	_garbageCollector->writeBarrier(addr);
 	return &(arrayTable[addr.getOffset()]);
 }
 
@@ -951,6 +970,7 @@ SciBitmap *SegManager::allocateBitmap(reg_t *addr, const int16 width, const int1
 	offset = table->allocEntry();
 
 	*addr = make_reg(_bitmapSegId, offset);
+	_garbageCollector->registerAllocation(table, *addr);
 	SciBitmap &bitmap = table->at(offset);
 
 	bitmap.create(width, height, skipColor, originX, originY, xResolution, yResolution, paletteSize, remap, gc);
@@ -1042,6 +1062,7 @@ int SegManager::instantiateScript(int scriptNum, bool applyScriptPatches) {
 		scr = allocateScript(scriptNum, &segmentId);
 	}
 
+	_selectorLookupCache.clear();
 	scr->load(scriptNum, _resMan, _scriptPatcher, applyScriptPatches);
 	scr->initializeLocals(this);
 	scr->initializeClasses(this);
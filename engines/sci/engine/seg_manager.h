@@ -24,11 +24,13 @@
 #define SCI_ENGINE_SEGMAN_H
 
 #include "common/scummsys.h"
+#include "common/flathashmap.h"
 #include "common/serializer.h"
 #include "sci/engine/script.h"
 #include "sci/engine/vm.h"
 #include "sci/engine/vm_types.h"
 #include "sci/engine/segment.h"
+#include "sci/engine/selector.h"
 #ifdef ENABLE_SCI32
 #include "sci/graphics/celobj32.h" // kLowResX, kLowResY
 #endif
@@ -45,6 +47,7 @@ enum ScriptLoadType {
 };
 
 class Script;
+class GarbageCollector;
 
 class SegManager : public Common::Serializable {
 	friend class Console;
@@ -458,15 +461,35 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/**
+	 * The inline caches of the selector lookups of send instructions. They
+	 * are cleared whenever a script is loaded or freed.
+	 */
+	SelectorLookupCache &getSelectorLookupCache() { return _selectorLookupCache; }
+
+	GarbageCollector *getGarbageCollector() { return _garbageCollector; }
+
+	/**
+	 * Write barrier for the garbage collector: must be called when the
+	 * engine modifies an entry of a segment table, a script or local
+	 * variables through a pointer which it did not just obtain from the
+	 * segment manager.
+	 * @param addr	address of the modified entry, script or variables
+	 */
+	void writeBarrier(reg_t addr);
+
 private:
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
 	/** Map script ids to segment ids. */
-	Common::HashMap<int, SegmentId> _scriptSegMap;
+	Common::FlatHashMap<int, SegmentId> _scriptSegMap;
 
 	ResourceManager *_resMan;
 	ScriptPatcher *_scriptPatcher;
 
+	SelectorLookupCache _selectorLookupCache;
+	GarbageCollector *_garbageCollector;
+
 	SegmentId _clonesSegId; ///< ID of the (a) clones segment
 	SegmentId _listsSegId; ///< ID of the (a) list segment
 	SegmentId _nodesSegId; ///< ID of the (a) node segment
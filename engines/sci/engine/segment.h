@@ -80,6 +80,16 @@ enum SegmentType {
 	SEG_TYPE_MAX // For sanity checking
 };
 
+/**
+ * Flags kept by the garbage collector for each entry of a SegmentObjTable.
+ * See GarbageCollector for how they are used.
+ */
+enum GCEntryFlags {
+	kGCEntryOld = 1 << 0,		///< The entry survived a collection
+	kGCEntryMarked = 1 << 1,	///< The entry was reached by the collection in progress
+	kGCEntryScanned = 1 << 2	///< The references of the entry were scanned, and it was not modified since
+};
+
 struct SegmentObj : public Common::Serializable {
 	SegmentType _type;
 
@@ -143,6 +153,22 @@ public:
 	virtual Common::Array<reg_t> listAllOutgoingReferences(reg_t object) const {
 		return Common::Array<reg_t>();
 	}
+
+	/**
+	 * Returns the garbage collector flags of an entry, for segments whose
+	 * entries are collected one by one.
+	 * Used by the garbage collector.
+	 * @param offset	offset of the entry
+	 * @return the GCEntryFlags of the entry, or NULL if the segment has no
+	 *         separately collected entries or the entry is free
+	 */
+	virtual byte *getGCFlags(uint32 offset) { return NULL; }
+
+	/**
+	 * Returns the number of entries which getGCFlags() may be asked for.
+	 * Used by the garbage collector.
+	 */
+	virtual uint getGCEntryCount() const { return 0; }
 };
 
 struct LocalVariables : public SegmentObj {
@@ -232,6 +258,7 @@ struct SegmentObjTable : public SegmentObj {
 	struct Entry {
 		T *data;
 		int next_free; /* Only used for free entries */
+		byte gcFlags; /**< GCEntryFlags */
 	};
 	enum { HEAPENTRY_INVALID = -1 };
 
@@ -267,6 +294,7 @@ public:
 			first_free = _table[oldff].next_free;
 
 			_table[oldff].next_free = oldff;
+			_table[oldff].gcFlags = 0;
 			assert(_table[oldff].data == nullptr);
 			_table[oldff].data = new T;
 			return oldff;
@@ -274,11 +302,20 @@ public:
 			uint newIdx = _table.size();
 			_table.push_back(Entry());
 			_table.back().data = new T;
+			_table.back().gcFlags = 0;
 			_table[newIdx].next_free = newIdx;	// Tag as 'valid'
 			return newIdx;
 		}
 	}
 
+	byte *getGCFlags(uint32 offset) override {
+		return isValidEntry(offset) ? &_table[offset].gcFlags : NULL;
+	}
+
+	uint getGCEntryCount() const override {
+		return _table.size();
+	}
+
 	bool isValidOffset(uint32 offset) const override {
 		return isValidEntry(offset);
 	}
@@ -371,4 +371,64 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 //	return _lookupSelector_function(segMan, obj, selectorId, fptr);
 }
 
+SelectorType SelectorLookupCache::lookup(SegManager *segMan, reg_t callSite, reg_t obj, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
+	const Object *object = segMan->getObject(obj);
+	if (!object)
+		return lookupSelector(segMan, obj, selectorId, varp, fptr);
+
+	const reg_t pos = object->getPos();
+	const reg_t species = object->getSpeciesSelector();
+	const reg_t superClass = object->getSuperClassSelector();
+
+	const uint64 key = ((uint64)callSite.getSegment() << 48) | ((uint64)callSite.getOffset() << 16) | (selectorId & 0xffff);
+	Site &site = _sites.getOrCreateVal(key);
+
+	for (uint i = 0; i < site.count; i++) {
+		const Entry &entry = site.entries[i];
+		if (entry.pos == pos && entry.species == species && entry.superClass == superClass) {
+			_hits++;
+			if (entry.type == kSelectorVariable) {
+				if (varp) {
+					varp->obj = obj;
+					varp->varindex = entry.varIndex;
+				}
+			} else if (fptr) {
+				*fptr = entry.method;
+			}
+			return entry.type;
+		}
+	}
+
+	_misses++;
+
+	ObjVarRef var;
+	var.varindex = -1;
+	reg_t method = NULL_REG;
+	const SelectorType type = lookupSelector(segMan, obj, selectorId, &var, &method);
+	if (type == kSelectorNone)
+		return type;
+
+	Entry *entry;
+	if (site.count < kEntriesPerSite) {
+		entry = &site.entries[site.count++];
+	} else {
+		entry = &site.entries[site.next];
+		site.next = (site.next + 1) % kEntriesPerSite;
+	}
+	entry->pos = pos;
+	entry->species = species;
+	entry->superClass = superClass;
+	entry->type = type;
+	entry->varIndex = var.varindex;
+	entry->method = method;
+
+	if (type == kSelectorVariable) {
+		if (varp)
+			*varp = var;
+	} else if (fptr) {
+		*fptr = method;
+	}
+	return type;
+}
+
 } // End of namespace Sci
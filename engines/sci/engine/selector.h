@@ -24,6 +24,7 @@
 #define SCI_ENGINE_SELECTOR_H
 
 #include "common/scummsys.h"
+#include "common/flathashmap.h"
 
 #include "sci/engine/vm_types.h"	// for reg_t
 #include "sci/engine/vm.h"
@@ -236,6 +237,67 @@ void writeSelector(SegManager *segMan, reg_t object, Selector selectorId, reg_t
 void invokeSelector(EngineState *s, reg_t object, int selectorId,
 	int k_argc, StackPtr k_argp, int argc = 0, const reg_t *argv = 0);
 
+/**
+ * Inline caches for the selector lookups of send instructions. Each send
+ * site remembers the results of lookupSelector() for the last few kinds of
+ * objects it sent the selector to, so that the variable and method tables of
+ * the object and its superclasses are only searched once per kind.
+ *
+ * An object is identified by its position, species and superclass. Clones
+ * keep the position of the object they were cloned from, so all clones of a
+ * class share the entries of that class. The caches refer to script objects
+ * and code, so they must be cleared whenever a script is loaded or freed.
+ */
+class SelectorLookupCache {
+public:
+	SelectorLookupCache() : _hits(0), _misses(0) {}
+
+	/**
+	 * Looks up a selector like lookupSelector() does, through the cache of
+	 * the send instruction at callSite.
+	 */
+	SelectorType lookup(SegManager *segMan, reg_t callSite, reg_t obj, Selector selectorId, ObjVarRef *varp, reg_t *fptr);
+
+	/** Forgets all cached lookups, but keeps the counters */
+	void clear() { _sites.clear(); }
+
+	void resetCounters() { _hits = _misses = 0; }
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+	uint getSiteCount() const { return _sites.size(); }
+
+private:
+	/** Number of kinds of objects kept per site before replacing the oldest */
+	static const uint kEntriesPerSite = 4;
+
+	struct Entry {
+		reg_t pos;
+		reg_t species;
+		reg_t superClass;
+		SelectorType type;
+		int varIndex;
+		reg_t method;
+	};
+
+	struct Site {
+		Site() : count(0), next(0) {}
+
+		uint count;
+		uint next;
+		Entry entries[kEntriesPerSite];
+	};
+
+	struct SiteHash {
+		uint operator()(uint64 key) const { return (uint)(key ^ (key >> 32)); }
+	};
+
+	/** Sites are keyed by the address of the send instruction and the selector */
+	Common::FlatHashMap<uint64, Site, SiteHash> _sites;
+
+	uint32 _hits;
+	uint32 _misses;
+};
+
 #ifdef ENABLE_SCI32
 /**
  * SCI32 set kInfoFlagViewVisible in the -info- selector if a certain
@@ -201,6 +201,8 @@ static void write_var(EngineState *s, int type, int index, reg_t value) {
 			value.setSegment(0);
 
 		s->variables[type][index] = value;
+		if (type == VAR_GLOBAL || type == VAR_LOCAL)
+			s->_segMan->writeBarrier(make_reg(s->variablesSegment[type], 0));
 
 		g_sci->_guestAdditions->writeVarHook(type, index, value);
 	}
@@ -263,7 +265,7 @@ static void _exec_varselectors(EngineState *s) {
 }
 
 
-ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPtr sp, int framesize, StackPtr argp) {
+ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPtr sp, int framesize, StackPtr argp, reg_t callSite) {
 	// send_obj and work_obj are equal for anything but 'super'
 	// Returns a pointer to the TOS exec_stack element
 	assert(s);
@@ -289,7 +291,11 @@ ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPt
 		g_sci->_guestAdditions->sendSelectorHook(send_obj, selector, argp);
 #endif
 
-		SelectorType selectorType = lookupSelector(s->_segMan, send_obj, selector, &varp, &funcp);
+		SelectorType selectorType;
+		if (callSite.isNull())
+			selectorType = lookupSelector(s->_segMan, send_obj, selector, &varp, &funcp);
+		else
+			selectorType = s->_segMan->getSelectorLookupCache().lookup(s->_segMan, callSite, send_obj, selector, &varp, &funcp);
 		if (selectorType == kSelectorNone)
 			error("Send to invalid selector 0x%x (%s) of object at %04x:%04x", 0xffff & selector, g_sci->getKernel()->getSelectorName(0xffff & selector).c_str(), PRINT_REG(send_obj));
 
@@ -664,8 +670,13 @@ void run_vm(EngineState *s) {
 
 		// Get opcode
 		byte extOpcode;
-		if (!vmHooks.isActive(s))
-			s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		const uint32 instructionOffset = s->xs->addr.pc.getOffset();
+		const bool hookedInstruction = vmHooks.isActive(s);
+		// Sends from hooked instructions are not cached, since their
+		// bytecode does not live at the program counter
+		const reg_t callSite = hookedInstruction ? NULL_REG : make_reg32(s->xs->addr.pc.getSegment(), instructionOffset);
+		if (!hookedInstruction)
+			s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(instructionOffset), extOpcode, opparams));
 		else {
 			int offset = readPMachineInstruction(vmHooks.data(), extOpcode, opparams);
 			vmHooks.advance(offset);
@@ -907,10 +918,8 @@ void run_vm(EngineState *s) {
 
 		case op_callk: { // 0x21 (33)
 			// Run the garbage collector, if needed
-			if (s->gcCountDown-- <= 0) {
-				s->gcCountDown = s->scriptGCInterval;
-				run_gc(s);
-			}
+			s->gcCountDown--;
+			run_gc_step(s);
 
 			// Call kernel function
 			s->xs->sp -= (opparams[1] >> 1) + 1;
@@ -1024,7 +1033,7 @@ void run_vm(EngineState *s) {
 
 			s->xs->sp[1].incOffset(s->r_rest);
 			xs_new = send_selector(s, s->r_acc, s->r_acc, s_temp,
-									(int)(opparams[0] >> 1) + (uint16)s->r_rest, s->xs->sp);
+									(int)(opparams[0] >> 1) + (uint16)s->r_rest, s->xs->sp, callSite);
 
 			if (xs_new && xs_new != s->xs)
 				s->_executionStackPosChanged = true;
@@ -1071,7 +1080,7 @@ void run_vm(EngineState *s) {
 			s->xs->sp[1].incOffset(s->r_rest);
 			xs_new = send_selector(s, s->xs->objp, s->xs->objp,
 									s_temp, (int)(opparams[0] >> 1) + (uint16)s->r_rest,
-									s->xs->sp);
+									s->xs->sp, callSite);
 
 			if (xs_new && xs_new != s->xs)
 				s->_executionStackPosChanged = true;
@@ -1100,7 +1109,7 @@ void run_vm(EngineState *s) {
 				s->xs->sp[1].incOffset(s->r_rest);
 				xs_new = send_selector(s, r_temp, s->xs->objp, s_temp,
 										(int)(opparams[1] >> 1) + (uint16)s->r_rest,
-										s->xs->sp);
+										s->xs->sp, callSite);
 
 				if (xs_new && xs_new != s->xs)
 					s->_executionStackPosChanged = true;
@@ -1177,6 +1186,7 @@ void run_vm(EngineState *s) {
 			}
 
 			opProperty = s->r_acc;
+			s->_segMan->writeBarrier(s->xs->objp);
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
 #endif
@@ -1207,6 +1217,7 @@ void run_vm(EngineState *s) {
 				                    s->_segMan, BREAK_SELECTORWRITE);
 			}
 			opProperty = newValue;
+			s->_segMan->writeBarrier(s->xs->objp);
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
 #endif
@@ -1233,6 +1244,7 @@ void run_vm(EngineState *s) {
 				opProperty += 1;
 			else
 				opProperty -= 1;
+			s->_segMan->writeBarrier(s->xs->objp);
 
 			if (g_sci->_debugState._activeBreakpointTypes & BREAK_SELECTORWRITE) {
 				debugPropertyAccess(obj, s->xs->objp, opparams[0], NULL_SELECTOR,
@@ -1457,6 +1469,8 @@ void run_vm(EngineState *s) {
 
 reg_t *ObjVarRef::getPointer(SegManager *segMan) const {
 	Object *o = segMan->getObject(obj);
+	// The variable may be written through the pointer
+	segMan->writeBarrier(obj);
 	return o ? &o->getVariableRef(varindex) : 0;
 }
 
@@ -358,10 +358,12 @@ ExecStack *execute_method(EngineState *s, uint16 script, uint16 pubfunct,
  * 						[selector_number][argument_counter] and then
  * 						"argument_counter" word entries with the
  * 						parameter values.
+ * @param[in] callSite	Address of the send instruction, used to cache the
+ * 						selector lookups, or NULL_REG not to cache them
  * @return				A pointer to the new execution stack TOS entry
  */
 ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj,
-	StackPtr sp, int framesize, StackPtr argp);
+	StackPtr sp, int framesize, StackPtr argp, reg_t callSite = NULL_REG);
 
 
 /**
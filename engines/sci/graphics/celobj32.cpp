@@ -25,6 +25,7 @@
 #include "sci/engine/seg_manager.h"
 #include "sci/engine/state.h"
 #include "sci/graphics/celobj32.h"
+#include "sci/graphics/celobj32_simd.h"
 #include "sci/graphics/frameout.h"
 #include "sci/graphics/palette32.h"
 #include "sci/graphics/remap32.h"
@@ -33,6 +34,7 @@
 #include "sci/util.h"
 #include "graphics/larryScale.h"
 #include "common/config-manager.h"
+#include "common/cpudetect.h"
 #include "common/gui_options.h"
 
 namespace Sci {
@@ -85,13 +87,15 @@ const CelScalerTable &CelScaler::getScalerTable(const Ratio &scaleX, const Ratio
 #pragma mark -
 #pragma mark CelObj
 bool CelObj::_drawBlackLines = false;
+bool CelObj::_drawRows = true;
 
 void CelObj::init() {
 	CelObj::deinit();
 	_drawBlackLines = false;
-	_nextCacheId = 1;
+	_drawRows = true;
+	_prefetching = false;
 	_scaler.reset(new CelScaler());
-	_cache.reset(new CelCache(100));
+	_cache.reset(new CelCache(kCacheMemory, kPrefetchMemory));
 }
 
 void CelObj::deinit() {
@@ -345,6 +349,16 @@ public:
 		assert(y >= 0 && y < _sourceHeight);
 		return _pixels + y * _sourceWidth;
 	}
+
+	/**
+	 * Gets the part of a row which may hold opaque pixels. Uncompressed cels
+	 * are not analysed, so this is always the whole row.
+	 */
+	inline void getOpaqueSpan(const int16, int16 &left, int16 &right, bool &solid) const {
+		left = 0;
+		right = _sourceWidth;
+		solid = false;
+	}
 };
 
 struct READER_Compressed {
@@ -355,82 +369,152 @@ private:
 	uint32 _dataOffset;
 	uint32 _uncompressedDataOffset;
 	int16 _y;
+	const int16 _sourceWidth;
 	const int16 _sourceHeight;
 	const uint8 _skipColor;
 	const int16 _maxWidth;
+	const CelDecodedPixels *_decoded;
+
+	/**
+	 * Decompresses the first `width` pixels of a row into _buffer.
+	 */
+	void decodeRow(const int16 y, const int16 width) {
+		// compressed data segment for row
+		const uint32 rowOffset = _resource.getUint32SEAt(_controlOffset + y * sizeof(uint32));
+
+		uint32 rowCompressedSize;
+		if (y + 1 < _sourceHeight) {
+			rowCompressedSize = _resource.getUint32SEAt(_controlOffset + (y + 1) * sizeof(uint32)) - rowOffset;
+		} else {
+			rowCompressedSize = _resource.size() - rowOffset - _dataOffset;
+		}
+
+		const byte *row = _resource.getUnsafeDataAt(_dataOffset + rowOffset, rowCompressedSize);
+
+		// uncompressed data segment for row
+		const uint32 literalOffset = _resource.getUint32SEAt(_controlOffset + _sourceHeight * sizeof(uint32) + y * sizeof(uint32));
+
+		uint32 literalRowSize;
+		if (y + 1 < _sourceHeight) {
+			literalRowSize = _resource.getUint32SEAt(_controlOffset + _sourceHeight * sizeof(uint32) + (y + 1) * sizeof(uint32)) - literalOffset;
+		} else {
+			literalRowSize = _resource.size() - literalOffset - _uncompressedDataOffset;
+		}
+
+		const byte *literal = _resource.getUnsafeDataAt(_uncompressedDataOffset + literalOffset, literalRowSize);
+
+		uint8 length;
+		for (int16 i = 0; i < width; i += length) {
+			const byte controlByte = *row++;
+			length = controlByte;
+
+			// Run-length encoded
+			if (controlByte & 0x80) {
+				length &= 0x3F;
+				assert(i + length < (int)sizeof(_buffer));
+
+				// Fill with skip color
+				if (controlByte & 0x40) {
+					memset(_buffer + i, _skipColor, length);
+				// Next value is fill color
+				} else {
+					memset(_buffer + i, *literal, length);
+					++literal;
+				}
+			// Uncompressed
+			} else {
+				assert(i + length < (int)sizeof(_buffer));
+				memcpy(_buffer + i, literal, length);
+				literal += length;
+			}
+		}
+	}
+
+	/**
+	 * Decompresses every row of the cel into the shared pixels of the cel,
+	 * and finds the opaque part of each row.
+	 */
+	void decodeAll(CelDecodedPixels &decoded) {
+		decoded.pixels.resize(_sourceWidth * _sourceHeight);
+		decoded.rows.resize(_sourceHeight);
+
+		for (int16 y = 0; y < _sourceHeight; ++y) {
+			decodeRow(y, _sourceWidth);
+			memcpy(&decoded.pixels[y * _sourceWidth], _buffer, _sourceWidth);
+
+			CelDecodedPixels::Row &row = decoded.rows[y];
+			int16 left = 0, right = _sourceWidth;
+			while (left < right && _buffer[left] == _skipColor) {
+				++left;
+			}
+			while (right > left && _buffer[right - 1] == _skipColor) {
+				--right;
+			}
+			if (left == right) {
+				left = right = 0;
+			}
+			row.left = left;
+			row.right = right;
+			row.solid = memchr(_buffer + left, _skipColor, right - left) == nullptr;
+		}
+	}
 
 public:
 	READER_Compressed(const CelObj &celObj, const int16 maxWidth) :
 	_resource(celObj.getResPointer()),
 	_y(-1),
+	_sourceWidth(celObj._width),
 	_sourceHeight(celObj._height),
 	_skipColor(celObj._skipColor),
-	_maxWidth(maxWidth) {
+	_maxWidth(maxWidth),
+	_decoded(celObj._decodedPixels.get()) {
 		assert(maxWidth <= celObj._width);
 
 		const SciSpan<const byte> celHeader = _resource.subspan(celObj._celHeaderOffset);
 		_dataOffset = celHeader.getUint32SEAt(24);
 		_uncompressedDataOffset = celHeader.getUint32SEAt(28);
 		_controlOffset = celHeader.getUint32SEAt(32);
+
+		if (_decoded && !_decoded->isDecoded() && _sourceWidth && _sourceHeight) {
+			decodeAll(*celObj._decodedPixels);
+		}
+		if (_decoded && !_decoded->isDecoded()) {
+			_decoded = nullptr;
+		}
 	}
 
 	inline const byte *getRow(const int16 y) {
 		assert(y >= 0 && y < _sourceHeight);
-		if (y != _y) {
-			// compressed data segment for row
-			const uint32 rowOffset = _resource.getUint32SEAt(_controlOffset + y * sizeof(uint32));
-
-			uint32 rowCompressedSize;
-			if (y + 1 < _sourceHeight) {
-				rowCompressedSize = _resource.getUint32SEAt(_controlOffset + (y + 1) * sizeof(uint32)) - rowOffset;
-			} else {
-				rowCompressedSize = _resource.size() - rowOffset - _dataOffset;
-			}
-
-			const byte *row = _resource.getUnsafeDataAt(_dataOffset + rowOffset, rowCompressedSize);
-
-			// uncompressed data segment for row
-			const uint32 literalOffset = _resource.getUint32SEAt(_controlOffset + _sourceHeight * sizeof(uint32) + y * sizeof(uint32));
-
-			uint32 literalRowSize;
-			if (y + 1 < _sourceHeight) {
-				literalRowSize = _resource.getUint32SEAt(_controlOffset + _sourceHeight * sizeof(uint32) + (y + 1) * sizeof(uint32)) - literalOffset;
-			} else {
-				literalRowSize = _resource.size() - literalOffset - _uncompressedDataOffset;
-			}
-
-			const byte *literal = _resource.getUnsafeDataAt(_uncompressedDataOffset + literalOffset, literalRowSize);
-
-			uint8 length;
-			for (int16 i = 0; i < _maxWidth; i += length) {
-				const byte controlByte = *row++;
-				length = controlByte;
-
-				// Run-length encoded
-				if (controlByte & 0x80) {
-					length &= 0x3F;
-					assert(i + length < (int)sizeof(_buffer));
+		if (_decoded) {
+			return &_decoded->pixels[y * _sourceWidth];
+		}
 
-					// Fill with skip color
-					if (controlByte & 0x40) {
-						memset(_buffer + i, _skipColor, length);
-					// Next value is fill color
-					} else {
-						memset(_buffer + i, *literal, length);
-						++literal;
-					}
-				// Uncompressed
-				} else {
-					assert(i + length < (int)sizeof(_buffer));
-					memcpy(_buffer + i, literal, length);
-					literal += length;
-				}
-			}
+		if (y != _y) {
+			decodeRow(y, _maxWidth);
 			_y = y;
 		}
 
 		return _buffer;
 	}
+
+	/**
+	 * Gets the part of a row which may hold opaque pixels, and whether it
+	 * has no transparent pixels at all. Only decoded cels know this, other
+	 * cels report the whole decompressed width.
+	 */
+	inline void getOpaqueSpan(const int16 y, int16 &left, int16 &right, bool &solid) const {
+		assert(y >= 0 && y < _sourceHeight);
+		if (_decoded) {
+			const CelDecodedPixels::Row &row = _decoded->rows[y];
+			left = row.left;
+			right = row.right;
+			solid = row.solid;
+		} else {
+			left = 0;
+			right = _maxWidth;
+			solid = false;
+		}
+	}
 };
 
 #pragma mark -
@@ -685,50 +769,221 @@ void CelObj::submitPalette() const {
 #pragma mark -
 #pragma mark CelObj - Caching
 
-int CelObj::_nextCacheId = 1;
 Common::ScopedPtr<CelCache> CelObj::_cache;
+bool CelObj::_prefetching = false;
+
+CelCache::CelCache(const uint32 maxMemory, const uint32 maxPrefetchMemory) :
+	_memory(0),
+	_maxMemory(maxMemory),
+	_prefetchMemory(0),
+	_maxPrefetchMemory(maxPrefetchMemory),
+	_prefetchGeneration(0) {
+	resetCounters();
+}
+
+const CelObj *CelCache::find(const CelInfo32 &celInfo) {
+	EntryMap::iterator it = _entries.find(celInfo);
+	if (it == _entries.end()) {
+		++_misses;
+		return nullptr;
+	}
 
-int CelObj::searchCache(const CelInfo32 &celInfo, int *const nextInsertIndex) const {
-	*nextInsertIndex = -1;
-	int oldestId = _nextCacheId + 1;
-	int oldestIndex = 0;
+	Entry &entry = it->_value;
+	++_hits;
+	if (entry.prefetched) {
+		// The cel moves over to the budget of the used cels
+		++_prefetchHits;
+		entry.prefetched = false;
+		_prefetched.erase(entry.lru);
+		_prefetchMemory -= entry.memory;
+		_lru.push_front(celInfo);
+		entry.lru = _lru.begin();
+		_memory += entry.memory;
 
-	for (int i = 0, len = _cache->size(); i < len; ++i) {
-		CelCacheEntry &entry = (*_cache)[i];
+		const CelObj *celObj = entry.celObj.get();
+		evict();
+		return celObj;
+	}
 
-		if (entry.celObj == nullptr) {
-			if (*nextInsertIndex == -1) {
-				*nextInsertIndex = i;
-			}
-		} else if (entry.celObj->_info == celInfo) {
-			entry.id = ++_nextCacheId;
-			return i;
-		} else if (oldestId > entry.id) {
-			oldestId = entry.id;
-			oldestIndex = i;
+	if (entry.lru != _lru.begin()) {
+		_lru.erase(entry.lru);
+		_lru.push_front(celInfo);
+		entry.lru = _lru.begin();
+	}
+
+	return entry.celObj.get();
+}
+
+void CelCache::add(const CelObj &celObj, const uint32 memory) {
+	EntryMap::iterator it = _entries.find(celObj._info);
+	if (it != _entries.end()) {
+		remove(it);
+	}
+
+	_lru.push_front(celObj._info);
+
+	Entry &entry = _entries[celObj._info];
+	entry.celObj.reset(celObj.duplicate());
+	entry.memory = memory;
+	entry.lru = _lru.begin();
+	entry.prefetched = false;
+	entry.prefetchGeneration = 0;
+	_memory += entry.memory;
+
+	evict();
+}
+
+bool CelCache::addPrefetched(const CelObj &celObj, const uint32 memory) {
+	// Unused cels of earlier prefetches make room first, the oldest first
+	while (_prefetchMemory + memory > _maxPrefetchMemory && !_prefetched.empty()) {
+		EntryMap::iterator oldest = _entries.find(_prefetched.back());
+		if (oldest->_value.prefetchGeneration == _prefetchGeneration) {
+			break;
 		}
+		remove(oldest);
+		++_evictions;
+	}
+
+	if (_prefetchMemory + memory > _maxPrefetchMemory) {
+		return false;
 	}
 
-	if (*nextInsertIndex == -1) {
-		*nextInsertIndex = oldestIndex;
+	if (_entries.contains(celObj._info)) {
+		return true;
 	}
 
-	return -1;
+	_prefetched.push_front(celObj._info);
+
+	Entry &entry = _entries[celObj._info];
+	entry.celObj.reset(celObj.duplicate());
+	entry.memory = memory;
+	entry.lru = _prefetched.begin();
+	entry.prefetched = true;
+	entry.prefetchGeneration = _prefetchGeneration;
+	_prefetchMemory += entry.memory;
+	++_prefetches;
+	return true;
 }
 
-void CelObj::putCopyInCache(const int cacheIndex) const {
-	if (cacheIndex == -1) {
-		error("Invalid cache index");
+void CelCache::evict() {
+	while (_memory > _maxMemory && _lru.size() > 1) {
+		remove(_entries.find(_lru.back()));
+		++_evictions;
 	}
+}
 
-	CelCacheEntry &entry = (*_cache)[cacheIndex];
-	entry.celObj.reset(duplicate());
-	entry.id = ++_nextCacheId;
+void CelCache::remove(EntryMap::iterator entry) {
+	assert(entry != _entries.end());
+	if (entry->_value.prefetched) {
+		_prefetchMemory -= entry->_value.memory;
+		_prefetched.erase(entry->_value.lru);
+	} else {
+		_memory -= entry->_value.memory;
+		_lru.erase(entry->_value.lru);
+	}
+	_entries.erase(entry);
+}
+
+const CelObj *CelObj::searchCache(const CelInfo32 &celInfo) const {
+	// Only cels which are not in the cache are prefetched
+	if (_prefetching) {
+		return nullptr;
+	}
+
+	return _cache->find(celInfo);
+}
+
+void CelObj::putCopyInCache() const {
+	if (_decodedPixels && !_decodedPixels->isDecoded()) {
+		READER_Compressed reader(*this, _width);
+	}
+
+	if (!_prefetching) {
+		_cache->add(*this, getCacheMemory());
+	} else if (!_cache->addPrefetched(*this, getCacheMemory())) {
+		// The prefetch budget is full, so the remaining cels of the
+		// resource are left for when they are drawn
+		_prefetching = false;
+	}
+}
+
+uint32 CelObj::getCacheMemory() const {
+	uint32 memory = _info.type == kCelTypePic ? sizeof(CelObjPic) : sizeof(CelObjView);
+	if (_decodedPixels) {
+		memory += sizeof(CelDecodedPixels) + _decodedPixels->pixels.size() + _decodedPixels->rows.size() * sizeof(CelDecodedPixels::Row);
+	}
+	return memory;
+}
+
+void CelObj::prefetch(const ResourceType type, const GuiResourceId resourceId) {
+	if (!_cache) {
+		return;
+	}
+
+	_prefetching = true;
+	_cache->startPrefetch();
+
+	// _prefetching is cleared when the next cel does not fit anymore
+	if (type == kResourceTypeView) {
+		const int16 numLoops = CelObjView::getNumLoops(resourceId);
+		for (int16 loopNo = 0; _prefetching && loopNo < numLoops; ++loopNo) {
+			const int16 numCels = CelObjView::getNumCels(resourceId, loopNo);
+			for (int16 celNo = 0; _prefetching && celNo < numCels; ++celNo) {
+				CelInfo32 celInfo;
+				celInfo.type = kCelTypeView;
+				celInfo.resourceId = resourceId;
+				celInfo.loopNo = loopNo;
+				celInfo.celNo = celNo;
+				if (!_cache->contains(celInfo)) {
+					CelObjView celObj(resourceId, loopNo, celNo);
+				}
+			}
+		}
+	} else if (type == kResourceTypePic) {
+		const Resource *const resource = g_sci->getResMan()->findResource(ResourceId(kResourceTypePic, resourceId), false);
+		const int16 numCels = resource ? resource->getUint8At(2) : 0;
+		for (int16 celNo = 0; _prefetching && celNo < numCels; ++celNo) {
+			CelInfo32 celInfo;
+			celInfo.type = kCelTypePic;
+			celInfo.resourceId = resourceId;
+			celInfo.celNo = celNo;
+			if (!_cache->contains(celInfo)) {
+				CelObjPic celObj(resourceId, celNo);
+			}
+		}
+	}
+
+	_prefetching = false;
 }
 
 #pragma mark -
 #pragma mark CelObj - Drawing
 
+bool getCelSIMDProcs(CelSIMDProcs &procs) {
+	memset(&procs, 0, sizeof(procs));
+
+#ifdef SCUMMVM_AVX2
+	if (Common::hasCpuFeature(Common::kCpuFeatureAVX2)) {
+		getCelProcsAVX2(procs);
+		return true;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (Common::hasCpuFeature(Common::kCpuFeatureSSE2)) {
+		getCelProcsSSE2(procs);
+		return true;
+	}
+#endif
+#ifdef SCUMMVM_NEON
+	if (Common::hasCpuFeature(Common::kCpuFeatureNEON)) {
+		getCelProcsNEON(procs);
+		return true;
+	}
+#endif
+
+	return false;
+}
+
 template<typename MAPPER, typename SCALER, bool DRAW_BLACK_LINES>
 struct RENDERER {
 	MAPPER &_mapper;
@@ -789,6 +1044,71 @@ void CelObj::render(Buffer &target, const Common::Rect &targetRect, const Common
 	}
 }
 
+template<bool FLIP, bool SKIP, typename READER>
+void CelObj::renderRows(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const {
+	CelSIMDProcs procs;
+	const bool simd = getCelSIMDProcs(procs);
+
+	READER reader(*this, FLIP ? _width : targetRect.left - scaledPosition.x + targetRect.width());
+	byte *targetRow = (byte *)target.getPixels() + target.w * targetRect.top;
+	for (int16 y = targetRect.top; y < targetRect.bottom; ++y, targetRow += target.w) {
+		const int16 sourceY = y - scaledPosition.y;
+
+		int16 left, right;
+		bool solid;
+		reader.getOpaqueSpan(sourceY, left, right, solid);
+		solid = solid || !SKIP;
+
+		// The opaque part of the row, in target coordinates
+		int16 targetLeft, targetRight;
+		if (FLIP) {
+			targetLeft = scaledPosition.x + _width - right;
+			targetRight = scaledPosition.x + _width - left;
+		} else {
+			targetLeft = scaledPosition.x + left;
+			targetRight = scaledPosition.x + right;
+		}
+		targetLeft = MAX(targetLeft, targetRect.left);
+		targetRight = MIN(targetRight, targetRect.right);
+		if (targetLeft >= targetRight) {
+			continue;
+		}
+
+		const int width = targetRight - targetLeft;
+		byte *out = targetRow + targetLeft;
+		const byte *row = reader.getRow(sourceY);
+
+		if (FLIP) {
+			const byte *in = row + _width - 1 - (targetLeft - scaledPosition.x);
+			if (solid) {
+				int x = simd ? procs.copyRowFlip(out, in, width) : 0;
+				for (; x < width; ++x) {
+					out[x] = in[-x];
+				}
+			} else {
+				int x = simd ? procs.skipRowFlip(out, in, width, _skipColor) : 0;
+				for (; x < width; ++x) {
+					if (in[-x] != _skipColor) {
+						out[x] = in[-x];
+					}
+				}
+			}
+		} else {
+			const byte *in = row + (targetLeft - scaledPosition.x);
+			if (solid) {
+				memcpy(out, in, width);
+			} else {
+				int x = simd ? procs.skipRow(out, in, width, _skipColor) : 0;
+				for (; x < width; ++x) {
+					if (in[x] != _skipColor) {
+						out[x] = in[x];
+					}
+				}
+			}
+		}
+	}
+}
+
 void CelObj::drawHzFlip(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const {
 	render<MAPPER_NoMap, SCALER_NoScale<true, READER_Compressed> >(target, targetRect, scaledPosition);
 }
@@ -854,27 +1174,51 @@ void CelObj::scaleDrawUncompMap(Buffer &target, const Ratio &scaleX, const Ratio
 }
 
 void CelObj::drawNoFlipNoMD(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const {
-	render<MAPPER_NoMD, SCALER_NoScale<false, READER_Compressed> >(target, targetRect, scaledPosition);
+	if (_drawRows && !_isMacSource) {
+		renderRows<false, true, READER_Compressed>(target, targetRect, scaledPosition);
+	} else {
+		render<MAPPER_NoMD, SCALER_NoScale<false, READER_Compressed> >(target, targetRect, scaledPosition);
+	}
 }
 
 void CelObj::drawHzFlipNoMD(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const {
-	render<MAPPER_NoMD, SCALER_NoScale<true, READER_Compressed> >(target, targetRect, scaledPosition);
+	if (_drawRows && !_isMacSource) {
+		renderRows<true, true, READER_Compressed>(target, targetRect, scaledPosition);
+	} else {
+		render<MAPPER_NoMD, SCALER_NoScale<true, READER_Compressed> >(target, targetRect, scaledPosition);
+	}
 }
 
 void CelObj::drawUncompNoFlipNoMD(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const {
-	render<MAPPER_NoMD, SCALER_NoScale<false, READER_Uncompressed> >(target, targetRect, scaledPosition);
+	if (_drawRows && !_isMacSource) {
+		renderRows<false, true, READER_Uncompressed>(target, targetRect, scaledPosition);
+	} else {
+		render<MAPPER_NoMD, SCALER_NoScale<false, READER_Uncompressed> >(target, targetRect, scaledPosition);
+	}
 }
 
 void CelObj::drawUncompNoFlipNoMDNoSkip(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const {
-	render<MAPPER_NoMDNoSkip, SCALER_NoScale<false, READER_Uncompressed> >(target, targetRect, scaledPosition);
+	if (_drawRows && !_isMacSource) {
+		renderRows<false, false, READER_Uncompressed>(target, targetRect, scaledPosition);
+	} else {
+		render<MAPPER_NoMDNoSkip, SCALER_NoScale<false, READER_Uncompressed> >(target, targetRect, scaledPosition);
+	}
 }
 
 void CelObj::drawUncompHzFlipNoMD(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const {
-	render<MAPPER_NoMD, SCALER_NoScale<true, READER_Uncompressed> >(target, targetRect, scaledPosition);
+	if (_drawRows && !_isMacSource) {
+		renderRows<true, true, READER_Uncompressed>(target, targetRect, scaledPosition);
+	} else {
+		render<MAPPER_NoMD, SCALER_NoScale<true, READER_Uncompressed> >(target, targetRect, scaledPosition);
+	}
 }
 
 void CelObj::drawUncompHzFlipNoMDNoSkip(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const {
-	render<MAPPER_NoMDNoSkip, SCALER_NoScale<true, READER_Uncompressed> >(target, targetRect, scaledPosition);
+	if (_drawRows && !_isMacSource) {
+		renderRows<true, false, READER_Uncompressed>(target, targetRect, scaledPosition);
+	} else {
+		render<MAPPER_NoMDNoSkip, SCALER_NoScale<true, READER_Uncompressed> >(target, targetRect, scaledPosition);
+	}
 }
 
 void CelObj::scaleDrawNoMD(Buffer &target, const Ratio &scaleX, const Ratio &scaleY, const Common::Rect &targetRect, const Common::Point &scaledPosition) const {
@@ -970,16 +1314,13 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 	_compressionType = kCelCompressionInvalid;
 	_transparent = true;
 
-	int cacheInsertIndex;
-	const int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjView *const cachedCelObj = dynamic_cast<CelObjView *>(entry.celObj.get());
+	const CelObj *const cachedEntry = searchCache(_info);
+	if (cachedEntry != nullptr) {
+		const CelObjView *const cachedCelObj = dynamic_cast<const CelObjView *>(cachedEntry);
 		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjView in cache slot %d", cacheIndex);
+			error("Expected a CelObjView in the cache for %s", _info.toString().c_str());
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -1067,6 +1408,10 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 		error("Compression type not supported - V: %d  L: %d  C: %d", _info.resourceId, _info.loopNo, _info.celNo);
 	}
 
+	if (_compressionType == kCelCompressionRLE) {
+		_decodedPixels.reset(new CelDecodedPixels());
+	}
+
 	const uint16 flags = celHeader.getUint16SEAt(10);
 	if (flags & 0x80) {
 		_transparent = flags & 1 ? true : false;
@@ -1077,7 +1422,7 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 		_remap = analyzeForRemap();
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	putCopyInCache();
 }
 
 bool CelObjView::analyzeUncompressedForRemap() const {
@@ -1178,16 +1523,13 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 	_transparent = true;
 	_remap = false;
 
-	int cacheInsertIndex;
-	const int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjPic *const cachedCelObj = dynamic_cast<CelObjPic *>(entry.celObj.get());
+	const CelObj *const cachedEntry = searchCache(_info);
+	if (cachedEntry != nullptr) {
+		const CelObjPic *const cachedCelObj = dynamic_cast<const CelObjPic *>(cachedEntry);
 		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjPic in cache slot %d", cacheIndex);
+			error("Expected a CelObjPic in the cache for %s", _info.toString().c_str());
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -1251,7 +1593,11 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 		}
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	if (_compressionType == kCelCompressionRLE) {
+		_decodedPixels.reset(new CelDecodedPixels());
+	}
+
+	putCopyInCache();
 }
 
 bool CelObjPic::analyzeUncompressedForSkip() const {
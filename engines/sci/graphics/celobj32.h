@@ -23,6 +23,9 @@
 #ifndef SCI_GRAPHICS_CELOBJ32_H
 #define SCI_GRAPHICS_CELOBJ32_H
 
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/ptr.h"
 #include "common/rational.h"
 #include "common/rect.h"
 #include "sci/resource/resource.h"
@@ -106,7 +109,7 @@ struct CelInfo32 {
 
 	// This is the equivalence criteria used by CelObj::searchCache in at least
 	// SSCI SQ6. Notably, it does not check the color field.
-	inline bool operator==(const CelInfo32 &other) {
+	inline bool operator==(const CelInfo32 &other) const {
 		return (
 			type == other.type &&
 			resourceId == other.resourceId &&
@@ -116,7 +119,7 @@ struct CelInfo32 {
 		);
 	}
 
-	inline bool operator!=(const CelInfo32 &other) {
+	inline bool operator!=(const CelInfo32 &other) const {
 		return !(*this == other);
 	}
 
@@ -139,18 +142,146 @@ struct CelInfo32 {
 	}
 };
 
+/**
+ * The pixels of a RLE compressed cel, decompressed the first time the cel is
+ * drawn without scaling. Copies of a cel object share the same pixels, so
+ * they live as long as the cel stays in the cel cache.
+ */
+struct CelDecodedPixels {
+	struct Row {
+		/**
+		 * The first and one past the last pixels of the row which are not the
+		 * skip color. Both are 0 for rows which are fully transparent.
+		 */
+		int16 left, right;
+
+		/**
+		 * Whether there are no skip color pixels between `left` and `right`.
+		 */
+		bool solid;
+	};
+
+	Common::Array<byte> pixels;
+	Common::Array<Row> rows;
+
+	bool isDecoded() const { return !rows.empty(); }
+};
+
+// Only view and pic cels are cached, so the bitmap is left out of the hash
+struct CelInfo32_Hash {
+	uint operator()(const CelInfo32 &info) const {
+		return (info.type << 28) ^ (info.resourceId << 12) ^ ((uint16)info.loopNo << 6) ^ (uint16)info.celNo;
+	}
+};
+
 class CelObj;
-struct CelCacheEntry {
+
+/**
+ * A cache of cel objects used to avoid reinitialisation overhead for cels
+ * with the same CelInfo32. SSCI kept the last 100 cels; this cache keeps as
+ * many as fit in a memory budget instead, counting the decompressed pixels
+ * of each cel, and drops the least recently used cels first.
+ *
+ * Prefetched cels which have not been used yet have a separate, smaller
+ * budget, so prefetching never pushes out cels which are being drawn. They
+ * join the cels in the main budget once they are used.
+ */
+class CelCache {
+public:
+	CelCache(const uint32 maxMemory, const uint32 maxPrefetchMemory);
+
 	/**
-	 * A monotonically increasing cache ID used to identify the least recently
-	 * used item in the cache for replacement.
+	 * Gets the cached cel object matching the given CelInfo32 and makes it
+	 * the most recently used one, or returns null.
 	 */
-	int id;
-	Common::ScopedPtr<CelObj> celObj;
-	CelCacheEntry() : id(0) {}
-};
+	const CelObj *find(const CelInfo32 &celInfo);
+
+	/**
+	 * Whether there is a cel object for the given CelInfo32, without
+	 * counting a hit or a miss.
+	 */
+	bool contains(const CelInfo32 &celInfo) const { return _entries.contains(celInfo); }
+
+	/**
+	 * Puts a copy of the given cel object, which takes `memory` bytes, into
+	 * the cache, replacing any older copy, then frees the least recently used
+	 * cels until the cache fits in its budget again.
+	 */
+	void add(const CelObj &celObj, const uint32 memory);
+
+	/**
+	 * Starts prefetching the cels of another resource. Unused cels from
+	 * earlier prefetches may be freed to make room for its cels.
+	 */
+	void startPrefetch() { ++_prefetchGeneration; }
+
+	/**
+	 * Puts a copy of the given prefetched cel object, which takes `memory`
+	 * bytes, into the prefetch budget. Returns false without adding it when
+	 * it only fits by freeing cels of the current prefetch.
+	 */
+	bool addPrefetched(const CelObj &celObj, const uint32 memory);
+
+	void resetCounters() { _hits = _misses = _evictions = _prefetches = _prefetchHits = 0; }
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+	uint32 getEvictions() const { return _evictions; }
+	uint32 getPrefetches() const { return _prefetches; }
+	uint32 getPrefetchHits() const { return _prefetchHits; }
+	uint getSize() const { return _entries.size(); }
+	uint32 getMemory() const { return _memory; }
+	uint32 getMaxMemory() const { return _maxMemory; }
+	uint32 getPrefetchMemory() const { return _prefetchMemory; }
+	uint32 getMaxPrefetchMemory() const { return _maxPrefetchMemory; }
+
+private:
+	typedef Common::List<CelInfo32> LRUList;
+
+	struct Entry {
+		Common::SharedPtr<CelObj> celObj;
+		uint32 memory;
+		/** The position of the cel in _lru or _prefetched */
+		LRUList::iterator lru;
+		/** Whether the cel was prefetched and has not been used yet */
+		bool prefetched;
+		/** The prefetch which added the cel, if it was prefetched */
+		uint32 prefetchGeneration;
+	};
+
+	typedef Common::HashMap<CelInfo32, Entry, CelInfo32_Hash> EntryMap;
+
+	EntryMap _entries;
+
+	/** The cached cels which have been used, most recently used first */
+	LRUList _lru;
 
-typedef Common::Array<CelCacheEntry> CelCache;
+	/** The prefetched cels which have not been used yet, newest first */
+	LRUList _prefetched;
+
+	/** The memory of the cels in _lru */
+	uint32 _memory;
+	const uint32 _maxMemory;
+
+	/** The memory of the cels in _prefetched */
+	uint32 _prefetchMemory;
+	const uint32 _maxPrefetchMemory;
+
+	uint32 _prefetchGeneration;
+
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _evictions;
+	uint32 _prefetches;
+	uint32 _prefetchHits;
+
+	void remove(EntryMap::iterator entry);
+
+	/**
+	 * Frees the least recently used cels until the used cels fit in their
+	 * budget again, keeping at least the most recent one.
+	 */
+	void evict();
+};
 
 #pragma mark -
 #pragma mark CelScaler
@@ -342,6 +473,31 @@ public:
 	 */
 	bool _isMacSource;
 
+	/**
+	 * The decompressed pixels of RLE compressed view and pic cels, shared with
+	 * the copies of this cel. Empty for other cels.
+	 */
+	Common::SharedPtr<CelDecodedPixels> _decodedPixels;
+
+	/**
+	 * When false, unscaled cels are drawn a pixel at a time like in SSCI
+	 * instead of a row at a time. Only the debugger changes this, to compare
+	 * the two renderers.
+	 */
+	static bool _drawRows;
+
+	/**
+	 * Loads the cels of a view or pic resource into the cel cache and
+	 * decompresses them, so they are ready before they are first drawn. Stops
+	 * at the first cel which does not fit in the prefetch budget.
+	 */
+	static void prefetch(const ResourceType type, const GuiResourceId resourceId);
+
+	/**
+	 * Gets the cel cache, which is null when SCI32 graphics are not running.
+	 */
+	static CelCache *getCache() { return _cache.get(); }
+
 	/**
 	 * Initialises static CelObj members.
 	 */
@@ -424,6 +580,14 @@ private:
 	template<typename MAPPER, typename SCALER>
 	void render(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, const Ratio &scaleX, const Ratio &scaleY) const;
 
+	/**
+	 * Draws an unscaled cel without remapping a row at a time, skipping the
+	 * transparent ends of each row and copying the rest with the SIMD row
+	 * kernels when the CPU has them.
+	 */
+	template<bool FLIP, bool SKIP, typename READER>
+	void renderRows(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const;
+
 	void drawHzFlip(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const;
 	void drawNoFlip(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const;
 	void drawUncompNoFlip(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const;
@@ -455,10 +619,15 @@ private:
 #pragma mark CelObj - Caching
 protected:
 	/**
-	 * A monotonically increasing cache ID used to identify the least recently
-	 * used item in the cache for replacement.
+	 * The memory budget of the cel cache, in bytes.
+	 */
+	static const uint32 kCacheMemory = 8 * 1024 * 1024;
+
+	/**
+	 * The memory budget of prefetched cels which have not been used yet, in
+	 * bytes.
 	 */
-	static int _nextCacheId;
+	static const uint32 kPrefetchMemory = 2 * 1024 * 1024;
 
 	/**
 	 * A cache of cel objects used to avoid reinitialisation overhead for cels
@@ -467,17 +636,26 @@ protected:
 	static Common::ScopedPtr<CelCache> _cache;
 
 	/**
-	 * Searches the cel cache for a CelObj matching the provided CelInfo32. If
-	 * not found, -1 is returned. `nextInsertIndex` will receive the index of
-	 * the oldest item in the cache, which can be used to replace the oldest
-	 * item with a newer item.
+	 * Whether the cel being constructed is being prefetched rather than drawn.
+	 */
+	static bool _prefetching;
+
+	/**
+	 * Searches the cel cache for a CelObj matching the provided CelInfo32.
+	 * If not found, null is returned.
+	 */
+	const CelObj *searchCache(const CelInfo32 &celInfo) const;
+
+	/**
+	 * Decompresses the pixels of this CelObj if it has not been drawn yet,
+	 * and puts a copy of it into the cache.
 	 */
-	int searchCache(const CelInfo32 &celInfo, int *nextInsertIndex) const;
+	void putCopyInCache() const;
 
 	/**
-	 * Puts a copy of this CelObj into the cache at the given cache index.
+	 * Gets the number of bytes this CelObj takes in the cel cache.
 	 */
-	void putCopyInCache(int index) const;
+	uint32 getCacheMemory() const;
 };
 
 #pragma mark -
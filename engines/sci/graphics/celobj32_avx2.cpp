@@ -0,0 +1,57 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "sci/graphics/celobj32_simd.h"
+
+#include <immintrin.h>
+
+namespace {
+
+struct AVX2Ops {
+	typedef __m256i V;
+	enum { kBytes = 32 };
+
+	static FORCEINLINE V load(const byte *p) { return _mm256_loadu_si256((const __m256i *)p); }
+	static FORCEINLINE void store(byte *p, V v) { _mm256_storeu_si256((__m256i *)p, v); }
+	static FORCEINLINE V set1(uint8 x) { return _mm256_set1_epi8((char)x); }
+	static FORCEINLINE V cmpeq(V a, V b) { return _mm256_cmpeq_epi8(a, b); }
+	static FORCEINLINE V select(V mask, V a, V b) { return _mm256_blendv_epi8(b, a, mask); }
+
+	static FORCEINLINE V reverse(V v) {
+		// The byte shuffle works within each 128 bit lane, swap the lanes too
+		const V indices = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+		                                   15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+		return _mm256_permute2x128_si256(_mm256_shuffle_epi8(v, indices), v, 0x01);
+	}
+};
+
+} // End of anonymous namespace
+
+#include "sci/graphics/celobj32_simd_impl.h"
+
+namespace Sci {
+
+void getCelProcsAVX2(CelSIMDProcs &procs) {
+	CelKernels<AVX2Ops>::getProcs(procs);
+}
+
+} // End of namespace Sci
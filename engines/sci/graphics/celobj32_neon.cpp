@@ -0,0 +1,55 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "sci/graphics/celobj32_simd.h"
+
+#include <arm_neon.h>
+
+namespace {
+
+struct NEONOps {
+	typedef uint8x16_t V;
+	enum { kBytes = 16 };
+
+	static FORCEINLINE V load(const byte *p) { return vld1q_u8(p); }
+	static FORCEINLINE void store(byte *p, V v) { vst1q_u8(p, v); }
+	static FORCEINLINE V set1(uint8 x) { return vdupq_n_u8(x); }
+	static FORCEINLINE V cmpeq(V a, V b) { return vceqq_u8(a, b); }
+	static FORCEINLINE V select(V mask, V a, V b) { return vbslq_u8(mask, a, b); }
+
+	static FORCEINLINE V reverse(V v) {
+		const V halves = vrev64q_u8(v);
+		return vcombine_u8(vget_high_u8(halves), vget_low_u8(halves));
+	}
+};
+
+} // End of anonymous namespace
+
+#include "sci/graphics/celobj32_simd_impl.h"
+
+namespace Sci {
+
+void getCelProcsNEON(CelSIMDProcs &procs) {
+	CelKernels<NEONOps>::getProcs(procs);
+}
+
+} // End of namespace Sci
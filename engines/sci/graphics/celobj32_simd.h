@@ -0,0 +1,70 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCI_GRAPHICS_CELOBJ32_SIMD_H
+#define SCI_GRAPHICS_CELOBJ32_SIMD_H
+
+#include "common/scummsys.h"
+
+namespace Sci {
+
+/**
+ * Row kernels for drawing unscaled cels without remapping. They work on
+ * whole vectors, so they return how many of the leading pixels of the row
+ * they drew and leave the rest to the generic code.
+ *
+ * The flipped kernels read the source backwards: target[i] comes from
+ * source[-i].
+ */
+
+/** Copy a row backwards. */
+typedef int (*CelCopyRowProc)(byte *target, const byte *source, int width);
+
+/** Copy the pixels of a row which differ from skipColor. */
+typedef int (*CelSkipRowProc)(byte *target, const byte *source, int width, uint8 skipColor);
+
+struct CelSIMDProcs {
+	CelCopyRowProc copyRowFlip;
+	CelSkipRowProc skipRow;
+	CelSkipRowProc skipRowFlip;
+};
+
+/**
+ * Get the row kernels for the CPU, returns false if there are none.
+ */
+bool getCelSIMDProcs(CelSIMDProcs &procs);
+
+#ifdef SCUMMVM_SSE2
+void getCelProcsSSE2(CelSIMDProcs &procs);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void getCelProcsAVX2(CelSIMDProcs &procs);
+#endif
+
+#ifdef SCUMMVM_NEON
+void getCelProcsNEON(CelSIMDProcs &procs);
+#endif
+
+} // End of namespace Sci
+
+#endif
@@ -0,0 +1,88 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * The cel row kernels, written once against a small set of vector
+ * operations. Each celobj32_*.cpp file defines those operations for its
+ * instruction set and includes this file, which must not be included
+ * anywhere else: it is compiled with different code generation flags
+ * every time.
+ *
+ * An Ops class provides, for vectors V of kBytes bytes: load() and store()
+ * which need no alignment, set1(), cmpeq(), select() which picks the bytes
+ * of a where the mask is set and those of b elsewhere, and reverse() which
+ * reverses the order of the bytes.
+ */
+
+#ifndef SCI_GRAPHICS_CELOBJ32_SIMD_IMPL_H
+#define SCI_GRAPHICS_CELOBJ32_SIMD_IMPL_H
+
+#include "sci/graphics/celobj32_simd.h"
+
+namespace Sci {
+
+template<class Ops>
+struct CelKernels {
+	typedef typename Ops::V V;
+	enum { kBytes = Ops::kBytes };
+
+	static FORCEINLINE V loadFlipped(const byte *source, int x) {
+		return Ops::reverse(Ops::load(source - x - (kBytes - 1)));
+	}
+
+	static int copyRowFlip(byte *target, const byte *source, int width) {
+		int x = 0;
+		for (; x + kBytes <= width; x += kBytes)
+			Ops::store(target + x, loadFlipped(source, x));
+		return x;
+	}
+
+	static int skipRow(byte *target, const byte *source, int width, uint8 skipColor) {
+		const V skip = Ops::set1(skipColor);
+		int x = 0;
+		for (; x + kBytes <= width; x += kBytes) {
+			const V pixels = Ops::load(source + x);
+			Ops::store(target + x, Ops::select(Ops::cmpeq(pixels, skip), Ops::load(target + x), pixels));
+		}
+		return x;
+	}
+
+	static int skipRowFlip(byte *target, const byte *source, int width, uint8 skipColor) {
+		const V skip = Ops::set1(skipColor);
+		int x = 0;
+		for (; x + kBytes <= width; x += kBytes) {
+			const V pixels = loadFlipped(source, x);
+			Ops::store(target + x, Ops::select(Ops::cmpeq(pixels, skip), Ops::load(target + x), pixels));
+		}
+		return x;
+	}
+
+	static void getProcs(CelSIMDProcs &procs) {
+		procs.copyRowFlip = copyRowFlip;
+		procs.skipRow = skipRow;
+		procs.skipRowFlip = skipRowFlip;
+	}
+};
+
+} // End of namespace Sci
+
+#endif
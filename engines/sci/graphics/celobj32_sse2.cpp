@@ -0,0 +1,58 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "sci/graphics/celobj32_simd.h"
+
+#include <emmintrin.h>
+
+namespace {
+
+struct SSE2Ops {
+	typedef __m128i V;
+	enum { kBytes = 16 };
+
+	static FORCEINLINE V load(const byte *p) { return _mm_loadu_si128((const __m128i *)p); }
+	static FORCEINLINE void store(byte *p, V v) { _mm_storeu_si128((__m128i *)p, v); }
+	static FORCEINLINE V set1(uint8 x) { return _mm_set1_epi8((char)x); }
+	static FORCEINLINE V cmpeq(V a, V b) { return _mm_cmpeq_epi8(a, b); }
+	static FORCEINLINE V select(V mask, V a, V b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+
+	static FORCEINLINE V reverse(V v) {
+		// There is no byte shuffle before SSSE3: reverse the dwords, then
+		// the words within them, then the bytes within those
+		v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+		v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+		return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+	}
+};
+
+} // End of anonymous namespace
+
+#include "sci/graphics/celobj32_simd_impl.h"
+
+namespace Sci {
+
+void getCelProcsSSE2(CelSIMDProcs &procs) {
+	CelKernels<SSE2Ops>::getProcs(procs);
+}
+
+} // End of namespace Sci
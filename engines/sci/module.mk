@@ -108,6 +108,25 @@ MODULE_OBJS += \
 	video/robot_decoder.o
 endif
 
+ifdef ENABLE_SCI32
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	graphics/celobj32_sse2.o
+$(MODULE)/graphics/celobj32_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	graphics/celobj32_avx2.o
+$(MODULE)/graphics/celobj32_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	graphics/celobj32_neon.o
+endif
+endif
+
 # This module can be built as a plugin
 ifeq ($(ENABLE_SCI), DYNAMIC_PLUGIN)
 PLUGIN := 1
@@ -33,6 +33,7 @@
 #include "engines/wintermute/base/base.h"
 #include "engines/wintermute/persistent.h"
 #include "engines/wintermute/base/scriptables/dcscript.h"   // Added by ClassView
+#include "common/flathashmap.h"
 #include "common/str.h"
 
 namespace Wintermute {
@@ -98,8 +99,8 @@ public:
 	ScValue(BaseGame *inGame, double Val);
 	ScValue(BaseGame *inGame, const char *Val);
 	~ScValue() override;
-	Common::HashMap<Common::String, ScValue *> _valObject;
-	Common::HashMap<Common::String, ScValue *>::iterator _valIter;
+	Common::FlatHashMap<Common::String, ScValue *> _valObject;
+	Common::FlatHashMap<Common::String, ScValue *>::iterator _valIter;
 
 	bool setProperty(const char *propName, int32 value);
 	bool setProperty(const char *propName, const char *value);
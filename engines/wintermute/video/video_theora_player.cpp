@@ -126,6 +126,7 @@ bool VideoTheoraPlayer::initialize(const Common::String &filename, const Common:
 
 #if defined (USE_THEORADEC)
 	_theoraDecoder = new Video::TheoraDecoder();
+	_theoraDecoder->setDecodeAhead(kDecodeAheadFrames);
 #else
 	warning("VideoTheoraPlayer::initialize - Theora support not compiled in, video will be skipped: %s", filename.c_str());
 	return STATUS_FAILED;
@@ -169,6 +170,7 @@ bool VideoTheoraPlayer::resetStream() {
 
 #if defined (USE_THEORADEC)
 	_theoraDecoder = new Video::TheoraDecoder();
+	_theoraDecoder->setDecodeAhead(kDecodeAheadFrames);
 #else
 	return STATUS_FAILED;
 #endif
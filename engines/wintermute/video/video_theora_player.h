@@ -47,6 +47,9 @@ private:
 		THEORA_STATE_PAUSED = 2,
 		THEORA_STATE_FINISHED = 3
 	};
+	// Frames decoded ahead of playback. Enough to ride out a few expensive
+	// frames of the high resolution videos, each one holds a full RGB frame
+	static const uint kDecodeAheadFrames = 3;
 	Video::VideoDecoder *_theoraDecoder;
 	Graphics::Surface _surface;
 public:
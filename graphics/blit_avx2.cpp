@@ -0,0 +1,88 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/blit_simd.h"
+
+#include <immintrin.h>
+
+namespace {
+
+struct AVX2Ops {
+	typedef __m256i V;
+	typedef __m256d D;
+	enum { kPixels = 8 };
+
+	static FORCEINLINE V load16(const uint16 *p) { return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)p)); }
+	static FORCEINLINE V loadBytes(const byte *p) { return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)p)); }
+	static FORCEINLINE V load32(const uint32 *p) { return _mm256_loadu_si256((const __m256i *)p); }
+
+	static FORCEINLINE void store16(uint16 *p, V v) {
+		// The packing works within each 128 bit lane, bring the halves together
+		const V packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(v, v), _MM_SHUFFLE(3, 1, 2, 0));
+		_mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(packed));
+	}
+
+	static FORCEINLINE void store32(uint32 *p, V v) { _mm256_storeu_si256((__m256i *)p, v); }
+
+	static FORCEINLINE V set1(uint32 x) { return _mm256_set1_epi32((int)x); }
+	static FORCEINLINE V and_(V a, V b) { return _mm256_and_si256(a, b); }
+	static FORCEINLINE V or_(V a, V b) { return _mm256_or_si256(a, b); }
+	static FORCEINLINE V add(V a, V b) { return _mm256_add_epi32(a, b); }
+	static FORCEINLINE V mul16(V a, V b) { return _mm256_mullo_epi16(a, b); }
+	static FORCEINLINE V cmpeq(V a, V b) { return _mm256_cmpeq_epi32(a, b); }
+	static FORCEINLINE V select(V mask, V a, V b) { return _mm256_blendv_epi8(b, a, mask); }
+	static FORCEINLINE bool all(V mask) { return (uint32)_mm256_movemask_epi8(mask) == 0xFFFFFFFF; }
+	static FORCEINLINE V sll(V a, int n) { return _mm256_sll_epi32(a, _mm_cvtsi32_si128(n)); }
+	static FORCEINLINE V srl(V a, int n) { return _mm256_srl_epi32(a, _mm_cvtsi32_si128(n)); }
+
+	static FORCEINLINE V gather(const uint32 *table, const byte *p) {
+		return _mm256_i32gather_epi32((const int *)table, loadBytes(p), 4);
+	}
+
+	static FORCEINLINE D dset1(double x) { return _mm256_set1_pd(x); }
+	static FORCEINLINE D dadd(D a, D b) { return _mm256_add_pd(a, b); }
+	static FORCEINLINE D dsub(D a, D b) { return _mm256_sub_pd(a, b); }
+	static FORCEINLINE D dmul(D a, D b) { return _mm256_mul_pd(a, b); }
+	static FORCEINLINE D ddiv(D a, D b) { return _mm256_div_pd(a, b); }
+
+	static FORCEINLINE void toDoubles(V v, D &low, D &high) {
+		low = _mm256_cvtepi32_pd(_mm256_castsi256_si128(v));
+		high = _mm256_cvtepi32_pd(_mm256_extracti128_si256(v, 1));
+	}
+
+	static FORCEINLINE V fromDoubles(D low, D high) {
+		return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvttpd_epi32(low)), _mm256_cvttpd_epi32(high), 1);
+	}
+};
+
+} // End of anonymous namespace
+
+#include "graphics/blit_simd_impl.h"
+
+namespace Graphics {
+
+void getBlitProcsAVX2(BlitSIMDProcs &procs) {
+	BlitKernels<AVX2Ops>::getProcs(procs);
+	BlitKernels<AVX2Ops>::getAlphaProcs(procs);
+}
+
+} // End of namespace Graphics
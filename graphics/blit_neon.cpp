@@ -0,0 +1,72 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/blit_simd.h"
+
+#include <arm_neon.h>
+#include <string.h>
+
+namespace {
+
+struct NEONOps {
+	typedef uint32x4_t V;
+	enum { kPixels = 4 };
+
+	static FORCEINLINE V load16(const uint16 *p) { return vmovl_u16(vld1_u16(p)); }
+
+	static FORCEINLINE V loadBytes(const byte *p) {
+		uint32 bytes;
+		memcpy(&bytes, p, sizeof(bytes));
+		return vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(bytes)))));
+	}
+
+	static FORCEINLINE V load32(const uint32 *p) { return vld1q_u32(p); }
+	static FORCEINLINE void store16(uint16 *p, V v) { vst1_u16(p, vmovn_u32(v)); }
+	static FORCEINLINE void store32(uint32 *p, V v) { vst1q_u32(p, v); }
+
+	static FORCEINLINE V set1(uint32 x) { return vdupq_n_u32(x); }
+	static FORCEINLINE V and_(V a, V b) { return vandq_u32(a, b); }
+	static FORCEINLINE V or_(V a, V b) { return vorrq_u32(a, b); }
+	static FORCEINLINE V cmpeq(V a, V b) { return vceqq_u32(a, b); }
+	static FORCEINLINE V select(V mask, V a, V b) { return vbslq_u32(mask, a, b); }
+	static FORCEINLINE V sll(V a, int n) { return vshlq_u32(a, vdupq_n_s32(n)); }
+	static FORCEINLINE V srl(V a, int n) { return vshlq_u32(a, vdupq_n_s32(-n)); }
+
+	static FORCEINLINE V gather(const uint32 *table, const byte *p) {
+		const uint32 values[4] = { table[p[0]], table[p[1]], table[p[2]], table[p[3]] };
+		return vld1q_u32(values);
+	}
+};
+
+} // End of anonymous namespace
+
+#include "graphics/blit_simd_impl.h"
+
+namespace Graphics {
+
+// The alpha blender is left to the generic code: ARM compilers contract
+// its double expressions into fused multiply-adds, which round differently
+void getBlitProcsNEON(BlitSIMDProcs &procs) {
+	BlitKernels<NEONOps>::getProcs(procs);
+}
+
+} // End of namespace Graphics
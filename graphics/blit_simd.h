@@ -0,0 +1,131 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_BLIT_SIMD_H
+#define GRAPHICS_BLIT_SIMD_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+struct PixelFormat;
+
+/**
+ * A pixel format conversion for the SIMD blitters. Each destination
+ * channel is computed like PixelFormat::colorToARGB() followed by
+ * PixelFormat::ARGBToColor() do: the source bits of the channel,
+ * ((color >> srcShift) & srcMask), are expanded to 8 bits as
+ * ((c << expandLeft) | (c >> expandRight)) and stored as
+ * ((value >> dstLoss) << dstShift).
+ */
+struct BlitSIMDFormat {
+	int srcBytesPerPixel;
+	int dstBytesPerPixel;
+	int channels;          ///< The number of entries used in the arrays below
+	uint32 srcMask[4];
+	int srcShift[4];
+	int expandLeft[4];
+	int expandRight[4];
+	int dstLoss[4];
+	int dstShift[4];
+	uint32 constant;       ///< Set in every destination pixel, the alpha of sources without alpha
+
+	/**
+	 * Set up the conversion from src to dst. Returns false if the SIMD
+	 * blitters do not support the formats: pixels must have 2 or 4 bytes
+	 * and source channels 0 or 4 to 8 bits.
+	 */
+	bool set(const PixelFormat &src, const PixelFormat &dst);
+};
+
+/**
+ * The alpha blending of 32 bit pixels with 8 bit channels, with the same
+ * format on both sides. Source pixels equal to key under keyMask are
+ * skipped when useKey is set, and the alpha of the source is scaled by
+ * srcAlpha like ManagedSurface::transBlitFrom() does.
+ */
+struct BlitSIMDAlpha {
+	int shift[4];          ///< Red, green, blue and alpha
+	bool hasAlpha;         ///< Otherwise pixels are opaque and have no alpha bits
+	uint32 srcAlpha;
+	bool useKey;
+	uint32 key;
+	uint32 keyMask;
+
+	/**
+	 * Set up opaque blending without a key for format. Returns false if the
+	 * SIMD blitters do not support it.
+	 */
+	bool set(const PixelFormat &format);
+};
+
+/**
+ * Row blitters. They work on whole vectors, so they return how many of
+ * the leading pixels of the row they processed and leave the rest to the
+ * generic code.
+ */
+
+/**
+ * Convert a row of pixels. When the destination pixels are larger than the
+ * source ones the row is processed from right to left, otherwise from left
+ * to right, so that rows can be converted in place.
+ */
+typedef int (*BlitConvertProc)(byte *dst, const byte *src, int width, const BlitSIMDFormat &format);
+
+/** Copy the pixels which differ from key, masked with colorMask. */
+typedef int (*BlitColorKeyProc)(byte *dst, const byte *src, int width, int bytesPerPixel, uint32 key, uint32 colorMask);
+
+/** Look up 8 bit pixels in a table of destination colors, skipping key unless it is -1. */
+typedef int (*BlitPaletteProc)(byte *dst, const byte *src, int width, int dstBytesPerPixel, const uint32 *table, int key);
+
+/** Alpha blend a row, with the same results as the double precision code of ManagedSurface. */
+typedef int (*BlitAlphaProc)(uint32 *dst, const uint32 *src, int width, const BlitSIMDAlpha &alpha);
+
+struct BlitSIMDProcs {
+	int vectorPixels;      ///< The blitters process multiples of this many pixels
+	BlitConvertProc convert;
+	BlitColorKeyProc colorKey;
+	BlitPaletteProc expandPalette;
+	BlitAlphaProc blendAlpha;
+};
+
+/**
+ * Get the SIMD blitters for the CPU, returns false if there are none.
+ * Blitters without a SIMD version are nullptr.
+ */
+bool getBlitSIMDProcs(BlitSIMDProcs &procs);
+
+#ifdef SCUMMVM_SSE2
+void getBlitProcsSSE2(BlitSIMDProcs &procs);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void getBlitProcsAVX2(BlitSIMDProcs &procs);
+#endif
+
+#ifdef SCUMMVM_NEON
+void getBlitProcsNEON(BlitSIMDProcs &procs);
+#endif
+
+} // End of namespace Graphics
+
+#endif
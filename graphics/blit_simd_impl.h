@@ -0,0 +1,225 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * The SIMD blitters, written once against a small set of vector
+ * operations. Each blit_*.cpp file defines those operations for its
+ * instruction set and includes this file, which must not be included
+ * anywhere else: it is compiled with different code generation flags
+ * every time.
+ *
+ * An Ops class provides, for vectors V of kPixels unsigned 32 bit lanes:
+ *   load16() and loadBytes() which zero extend 16 bit resp. 8 bit values,
+ *   load32(), store16() which stores the low halves of the lanes,
+ *   store32(), set1(), and_(), or_(), cmpeq(), select() which picks the
+ *   lanes of a where the mask is set and those of b elsewhere, sll() and
+ *   srl() (shift by a count which is not a constant, counts of 32 and
+ *   more give 0), and gather() which looks up kPixels bytes in a table.
+ *
+ * The alpha blender additionally needs mul16() for products below 2^16,
+ * add(), all() which tells whether every lane of a mask is set, and
+ * vectors D of kPixels / 2 doubles with dset1(), dadd(), dsub(), dmul(),
+ * ddiv(), toDoubles() which converts both halves of a V, and fromDoubles()
+ * which truncates two D back into a V. The blender performs the same
+ * double operations in the same order as ManagedSurface does, so that it
+ * gives the same pixels.
+ */
+
+#ifndef GRAPHICS_BLIT_SIMD_IMPL_H
+#define GRAPHICS_BLIT_SIMD_IMPL_H
+
+#include "graphics/blit_simd.h"
+
+namespace Graphics {
+
+template<class Ops>
+struct BlitKernels {
+	typedef typename Ops::V V;
+
+	static FORCEINLINE V load(const uint16 *p) { return Ops::load16(p); }
+	static FORCEINLINE V load(const uint32 *p) { return Ops::load32(p); }
+	static FORCEINLINE void store(uint16 *p, V v) { Ops::store16(p, v); }
+	static FORCEINLINE void store(uint32 *p, V v) { Ops::store32(p, v); }
+
+	template<typename SrcInt, typename DstInt>
+	static int convertRow(byte *dstPtr, const byte *srcPtr, int width, const BlitSIMDFormat &format) {
+		const int count = width & ~(Ops::kPixels - 1);
+		DstInt *dst = (DstInt *)dstPtr;
+		const SrcInt *src = (const SrcInt *)srcPtr;
+
+		V srcMask[4];
+		for (int i = 0; i < format.channels; i++)
+			srcMask[i] = Ops::set1(format.srcMask[i]);
+		const V constant = Ops::set1(format.constant);
+
+		// In place, larger destination pixels overwrite the source pixels
+		// right of the current ones, smaller ones those to the left of them
+		const bool backward = sizeof(DstInt) > sizeof(SrcInt);
+		for (int i = 0; i < count; i += Ops::kPixels) {
+			const int x = backward ? count - Ops::kPixels - i : i;
+			const V pixels = load(src + x);
+
+			V result = constant;
+			for (int c = 0; c < format.channels; c++) {
+				const V value = Ops::and_(Ops::srl(pixels, format.srcShift[c]), srcMask[c]);
+				const V expanded = Ops::or_(Ops::sll(value, format.expandLeft[c]), Ops::srl(value, format.expandRight[c]));
+				result = Ops::or_(result, Ops::sll(Ops::srl(expanded, format.dstLoss[c]), format.dstShift[c]));
+			}
+			store(dst + x, result);
+		}
+
+		return count;
+	}
+
+	static int convert(byte *dst, const byte *src, int width, const BlitSIMDFormat &format) {
+		if (format.srcBytesPerPixel == 2)
+			return format.dstBytesPerPixel == 2 ? convertRow<uint16, uint16>(dst, src, width, format)
+			                                    : convertRow<uint16, uint32>(dst, src, width, format);
+		return format.dstBytesPerPixel == 2 ? convertRow<uint32, uint16>(dst, src, width, format)
+		                                    : convertRow<uint32, uint32>(dst, src, width, format);
+	}
+
+	template<typename PixelInt>
+	static int colorKeyRow(PixelInt *dst, const PixelInt *src, int width, uint32 key, uint32 colorMask) {
+		const int count = width & ~(Ops::kPixels - 1);
+		const V keyV = Ops::set1(key);
+		const V mask = Ops::set1(colorMask);
+
+		for (int x = 0; x < count; x += Ops::kPixels) {
+			const V pixels = load(src + x);
+			store(dst + x, Ops::select(Ops::cmpeq(pixels, keyV), load(dst + x), Ops::and_(pixels, mask)));
+		}
+
+		return count;
+	}
+
+	static int colorKey(byte *dst, const byte *src, int width, int bytesPerPixel, uint32 key, uint32 colorMask) {
+		if (bytesPerPixel == 2)
+			return colorKeyRow<uint16>((uint16 *)dst, (const uint16 *)src, width, key, colorMask);
+		return colorKeyRow<uint32>((uint32 *)dst, (const uint32 *)src, width, key, colorMask);
+	}
+
+	template<typename DstInt>
+	static int paletteRow(DstInt *dst, const byte *src, int width, const uint32 *table, int key) {
+		const int count = width & ~(Ops::kPixels - 1);
+		const V keyV = Ops::set1(key);
+
+		for (int x = 0; x < count; x += Ops::kPixels) {
+			V pixels = Ops::gather(table, src + x);
+			if (key != -1)
+				pixels = Ops::select(Ops::cmpeq(Ops::loadBytes(src + x), keyV), load(dst + x), pixels);
+			store(dst + x, pixels);
+		}
+
+		return count;
+	}
+
+	static int expandPalette(byte *dst, const byte *src, int width, int dstBytesPerPixel, const uint32 *table, int key) {
+		if (dstBytesPerPixel == 2)
+			return paletteRow<uint16>((uint16 *)dst, src, width, table, key);
+		return paletteRow<uint32>((uint32 *)dst, src, width, table, key);
+	}
+
+	static int blendAlpha(uint32 *dst, const uint32 *src, int width, const BlitSIMDAlpha &alpha) {
+		typedef typename Ops::D D;
+
+		const int count = width & ~(Ops::kPixels - 1);
+		const V byteMask = Ops::set1(0xFF);
+		const V zero = Ops::set1(0);
+		const uint32 alphaBits = alpha.hasAlpha ? 0xFFu << alpha.shift[3] : 0;
+		const V opaqueBits = Ops::set1(alphaBits);
+		const V rgbMask = Ops::set1((0xFFu << alpha.shift[0]) | (0xFFu << alpha.shift[1]) | (0xFFu << alpha.shift[2]));
+		const V keyMask = Ops::set1(alpha.keyMask);
+		const V key = Ops::set1(alpha.key);
+		const V srcAlpha = Ops::set1(alpha.srcAlpha);
+		const D one = Ops::dset1(1.0);
+		const D d255 = Ops::dset1(255.0);
+
+		for (int x = 0; x < count; x += Ops::kPixels) {
+			const V s = Ops::load32(src + x);
+			const V d = Ops::load32(dst + x);
+
+			V aSrc = alpha.hasAlpha ? Ops::and_(Ops::srl(s, alpha.shift[3]), byteMask) : byteMask;
+			if (alpha.srcAlpha != 0xFF) {
+				// aSrc * srcAlpha / 255
+				const V product = Ops::mul16(aSrc, srcAlpha);
+				aSrc = Ops::srl(Ops::add(Ops::add(product, Ops::set1(1)), Ops::srl(product, 8)), 8);
+			}
+
+			V skip = Ops::cmpeq(aSrc, zero);
+			if (alpha.useKey)
+				skip = Ops::or_(skip, Ops::cmpeq(Ops::and_(s, keyMask), key));
+			const V opaque = Ops::cmpeq(aSrc, byteMask);
+
+			V result = Ops::select(opaque, Ops::or_(Ops::and_(s, rgbMask), opaqueBits), d);
+
+			if (!Ops::all(Ops::or_(skip, opaque))) {
+				const V aDest = alpha.hasAlpha ? Ops::and_(Ops::srl(d, alpha.shift[3]), byteMask) : byteMask;
+
+				D sAlpha[2], dAlpha[2], sum[2];
+				Ops::toDoubles(aSrc, sAlpha[0], sAlpha[1]);
+				Ops::toDoubles(aDest, dAlpha[0], dAlpha[1]);
+				for (int h = 0; h < 2; h++) {
+					sAlpha[h] = Ops::ddiv(sAlpha[h], d255);
+					dAlpha[h] = Ops::dmul(Ops::ddiv(dAlpha[h], d255), Ops::dsub(one, sAlpha[h]));
+					sum[h] = Ops::dadd(sAlpha[h], dAlpha[h]);
+				}
+
+				V blended = zero;
+				for (int c = 0; c < 3; c++) {
+					D cSrc[2], cDest[2];
+					Ops::toDoubles(Ops::and_(Ops::srl(s, alpha.shift[c]), byteMask), cSrc[0], cSrc[1]);
+					Ops::toDoubles(Ops::and_(Ops::srl(d, alpha.shift[c]), byteMask), cDest[0], cDest[1]);
+					for (int h = 0; h < 2; h++)
+						cSrc[h] = Ops::ddiv(Ops::dadd(Ops::dmul(cSrc[h], sAlpha[h]), Ops::dmul(cDest[h], dAlpha[h])), sum[h]);
+					blended = Ops::or_(blended, Ops::sll(Ops::fromDoubles(cSrc[0], cSrc[1]), alpha.shift[c]));
+				}
+				if (alpha.hasAlpha) {
+					const V aOut = Ops::fromDoubles(Ops::dmul(d255, sum[0]), Ops::dmul(d255, sum[1]));
+					blended = Ops::or_(blended, Ops::sll(aOut, alpha.shift[3]));
+				}
+
+				result = Ops::select(Ops::or_(skip, opaque), result, blended);
+			}
+
+			Ops::store32(dst + x, Ops::select(skip, d, result));
+		}
+
+		return count;
+	}
+
+	static void getProcs(BlitSIMDProcs &procs) {
+		procs.vectorPixels = Ops::kPixels;
+		procs.convert = convert;
+		procs.colorKey = colorKey;
+		procs.expandPalette = expandPalette;
+	}
+
+	/** Only for instruction sets whose Ops support the alpha blender. */
+	static void getAlphaProcs(BlitSIMDProcs &procs) {
+		procs.blendAlpha = blendAlpha;
+	}
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -0,0 +1,96 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/endian.h"
+#include "graphics/blit_simd.h"
+
+#include <emmintrin.h>
+
+namespace {
+
+struct SSE2Ops {
+	typedef __m128i V;
+	typedef __m128d D;
+	enum { kPixels = 4 };
+
+	static FORCEINLINE V load16(const uint16 *p) {
+		return _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)p), _mm_setzero_si128());
+	}
+
+	static FORCEINLINE V loadBytes(const byte *p) {
+		const V v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(READ_UINT32(p)), _mm_setzero_si128());
+		return _mm_unpacklo_epi16(v, _mm_setzero_si128());
+	}
+
+	static FORCEINLINE V load32(const uint32 *p) { return _mm_loadu_si128((const __m128i *)p); }
+
+	static FORCEINLINE void store16(uint16 *p, V v) {
+		// Sign extend the low halves, so that the signed saturation keeps them
+		v = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+		_mm_storel_epi64((__m128i *)p, _mm_packs_epi32(v, v));
+	}
+
+	static FORCEINLINE void store32(uint32 *p, V v) { _mm_storeu_si128((__m128i *)p, v); }
+
+	static FORCEINLINE V set1(uint32 x) { return _mm_set1_epi32((int)x); }
+	static FORCEINLINE V and_(V a, V b) { return _mm_and_si128(a, b); }
+	static FORCEINLINE V or_(V a, V b) { return _mm_or_si128(a, b); }
+	static FORCEINLINE V add(V a, V b) { return _mm_add_epi32(a, b); }
+	static FORCEINLINE V mul16(V a, V b) { return _mm_mullo_epi16(a, b); }
+	static FORCEINLINE V cmpeq(V a, V b) { return _mm_cmpeq_epi32(a, b); }
+	static FORCEINLINE V select(V mask, V a, V b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+	static FORCEINLINE bool all(V mask) { return _mm_movemask_epi8(mask) == 0xFFFF; }
+	static FORCEINLINE V sll(V a, int n) { return _mm_sll_epi32(a, _mm_cvtsi32_si128(n)); }
+	static FORCEINLINE V srl(V a, int n) { return _mm_srl_epi32(a, _mm_cvtsi32_si128(n)); }
+
+	static FORCEINLINE V gather(const uint32 *table, const byte *p) {
+		return _mm_set_epi32((int)table[p[3]], (int)table[p[2]], (int)table[p[1]], (int)table[p[0]]);
+	}
+
+	static FORCEINLINE D dset1(double x) { return _mm_set1_pd(x); }
+	static FORCEINLINE D dadd(D a, D b) { return _mm_add_pd(a, b); }
+	static FORCEINLINE D dsub(D a, D b) { return _mm_sub_pd(a, b); }
+	static FORCEINLINE D dmul(D a, D b) { return _mm_mul_pd(a, b); }
+	static FORCEINLINE D ddiv(D a, D b) { return _mm_div_pd(a, b); }
+
+	static FORCEINLINE void toDoubles(V v, D &low, D &high) {
+		low = _mm_cvtepi32_pd(v);
+		high = _mm_cvtepi32_pd(_mm_shuffle_epi32(v, _MM_SHUFFLE(3, 2, 3, 2)));
+	}
+
+	static FORCEINLINE V fromDoubles(D low, D high) {
+		return _mm_unpacklo_epi64(_mm_cvttpd_epi32(low), _mm_cvttpd_epi32(high));
+	}
+};
+
+} // End of anonymous namespace
+
+#include "graphics/blit_simd_impl.h"
+
+namespace Graphics {
+
+void getBlitProcsSSE2(BlitSIMDProcs &procs) {
+	BlitKernels<SSE2Ops>::getProcs(procs);
+	BlitKernels<SSE2Ops>::getAlphaProcs(procs);
+}
+
+} // End of namespace Graphics
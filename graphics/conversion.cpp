@@ -21,14 +21,98 @@
  */
 
 #include "graphics/conversion.h"
+#include "graphics/blit_simd.h"
 #include "graphics/pixelformat.h"
 
+#include "common/cpudetect.h"
 #include "common/endian.h"
 
 namespace Graphics {
 
 // TODO: YUV to RGB conversion function
 
+bool getBlitSIMDProcs(BlitSIMDProcs &procs) {
+	memset(&procs, 0, sizeof(procs));
+
+#ifdef SCUMMVM_AVX2
+	if (Common::hasCpuFeature(Common::kCpuFeatureAVX2)) {
+		getBlitProcsAVX2(procs);
+		return true;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (Common::hasCpuFeature(Common::kCpuFeatureSSE2)) {
+		getBlitProcsSSE2(procs);
+		return true;
+	}
+#endif
+#ifdef SCUMMVM_NEON
+	if (Common::hasCpuFeature(Common::kCpuFeatureNEON)) {
+		getBlitProcsNEON(procs);
+		return true;
+	}
+#endif
+
+	return false;
+}
+
+bool BlitSIMDFormat::set(const PixelFormat &src, const PixelFormat &dst) {
+	if ((src.bytesPerPixel != 2 && src.bytesPerPixel != 4) || (dst.bytesPerPixel != 2 && dst.bytesPerPixel != 4))
+		return false;
+
+	const int srcBits[4] = { src.rBits(), src.gBits(), src.bBits(), src.aBits() };
+	const int srcShifts[4] = { src.rShift, src.gShift, src.bShift, src.aShift };
+	const int dstLosses[4] = { dst.rLoss, dst.gLoss, dst.bLoss, dst.aLoss };
+	const int dstShifts[4] = { dst.rShift, dst.gShift, dst.bShift, dst.aShift };
+
+	srcBytesPerPixel = src.bytesPerPixel;
+	dstBytesPerPixel = dst.bytesPerPixel;
+	channels = 0;
+	constant = 0;
+
+	for (int i = 0; i < 4; i++) {
+		if (dstLosses[i] >= 8)
+			continue;
+
+		const int bits = srcBits[i];
+		if (bits == 0) {
+			// Missing colors are black, missing alpha is opaque
+			if (i == 3)
+				constant |= (0xFF >> dstLosses[i]) << dstShifts[i];
+			continue;
+		}
+		if (bits < 4)
+			return false;
+
+		srcMask[channels] = (1 << bits) - 1;
+		srcShift[channels] = srcShifts[i];
+		expandLeft[channels] = 8 - bits;
+		expandRight[channels] = 2 * bits - 8;
+		dstLoss[channels] = dstLosses[i];
+		dstShift[channels] = dstShifts[i];
+		channels++;
+	}
+
+	return true;
+}
+
+bool BlitSIMDAlpha::set(const PixelFormat &format) {
+	if (format.bytesPerPixel != 4 || format.rBits() != 8 || format.gBits() != 8 || format.bBits() != 8
+			|| (format.aBits() != 8 && format.aBits() != 0))
+		return false;
+
+	shift[0] = format.rShift;
+	shift[1] = format.gShift;
+	shift[2] = format.bShift;
+	shift[3] = format.aShift;
+	hasAlpha = format.aBits() != 0;
+	srcAlpha = 0xFF;
+	useKey = false;
+	key = 0;
+	keyMask = 0;
+	return true;
+}
+
 // Function to blit a rect
 void copyBlit(byte *dst, const byte *src,
                const uint dstPitch, const uint srcPitch,
@@ -118,6 +202,60 @@ inline void crossBlitLogic3BppSource(byte *dst, const byte *src, const uint w, c
 } // End of anonymous namespace
 
 // Function to blit a rect from one color format to another
+namespace {
+
+/** Convert the pixels [begin, end) of a row one at a time, from right to left if backward. */
+void crossBlitPixels(byte *dst, const byte *src, int begin, int end, bool backward,
+                     const Graphics::PixelFormat &srcFmt, const Graphics::PixelFormat &dstFmt) {
+	for (int i = begin; i < end; i++) {
+		const int x = backward ? begin + end - 1 - i : i;
+		const uint32 color = srcFmt.bytesPerPixel == 2 ? *(const uint16 *)(src + x * 2) : *(const uint32 *)(src + x * 4);
+
+		byte a, r, g, b;
+		srcFmt.colorToARGB(color, a, r, g, b);
+		if (dstFmt.bytesPerPixel == 2)
+			*(uint16 *)(dst + x * 2) = dstFmt.ARGBToColor(a, r, g, b);
+		else
+			*(uint32 *)(dst + x * 4) = dstFmt.ARGBToColor(a, r, g, b);
+	}
+}
+
+/**
+ * Convert with the SIMD blitter, returns false if there is none for the
+ * formats. Like the generic code, this works from the bottom right when
+ * the destination pixels are larger, so that surfaces can be converted
+ * in place.
+ */
+bool crossBlitSIMD(byte *dst, const byte *src,
+                   const uint dstPitch, const uint srcPitch,
+                   const uint w, const uint h,
+                   const Graphics::PixelFormat &dstFmt, const Graphics::PixelFormat &srcFmt) {
+	BlitSIMDProcs procs;
+	BlitSIMDFormat format;
+	if (!getBlitSIMDProcs(procs) || !procs.convert || !format.set(srcFmt, dstFmt))
+		return false;
+
+	const bool backward = dstFmt.bytesPerPixel > srcFmt.bytesPerPixel;
+	const int width = w & ~(procs.vectorPixels - 1);
+	for (uint i = 0; i < h; i++) {
+		const uint y = backward ? h - 1 - i : i;
+		byte *dstRow = dst + y * dstPitch;
+		const byte *srcRow = src + y * srcPitch;
+
+		if (backward) {
+			crossBlitPixels(dstRow, srcRow, width, w, true, srcFmt, dstFmt);
+			procs.convert(dstRow, srcRow, width, format);
+		} else {
+			procs.convert(dstRow, srcRow, width, format);
+			crossBlitPixels(dstRow, srcRow, width, w, false, srcFmt, dstFmt);
+		}
+	}
+
+	return true;
+}
+
+} // End of anonymous namespace
+
 bool crossBlit(byte *dst, const byte *src,
                const uint dstPitch, const uint srcPitch,
                const uint w, const uint h,
@@ -134,6 +272,9 @@ bool crossBlit(byte *dst, const byte *src,
 		return true;
 	}
 
+	if (srcFmt.bytesPerPixel != 3 && crossBlitSIMD(dst, src, dstPitch, srcPitch, w, h, dstFmt, srcFmt))
+		return true;
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w * srcFmt.bytesPerPixel);
 	const uint dstDelta = (dstPitch - w * dstFmt.bytesPerPixel);
@@ -21,6 +21,7 @@
  */
 
 #include "graphics/managed_surface.h"
+#include "graphics/blit_simd.h"
 #include "common/algorithm.h"
 #include "common/textconsole.h"
 
@@ -28,6 +29,104 @@ namespace Graphics {
 
 const int SCALE_THRESHOLD = 0x100;
 
+namespace {
+
+/**
+ * The SIMD blitter for the rows of an unscaled blit, if there is one for
+ * the surfaces. It handles the leading pixels of each row, the generic
+ * code the remaining ones.
+ */
+struct RowBlitter {
+	enum Mode {
+		kModeNone,
+		kModeConvert,   ///< Opaque pixels, converted to the destination format
+		kModeColorKey,  ///< Opaque pixels of the destination format, with a transparent color
+		kModePalette,   ///< Opaque palette colors, with an optional transparent color
+		kModeAlpha      ///< 32 bit pixels, alpha blended
+	};
+
+	Mode mode;
+	BlitSIMDProcs procs;
+	BlitSIMDFormat format;
+	BlitSIMDAlpha alpha;
+	int srcBytesPerPixel, dstBytesPerPixel;
+	uint32 key, colorMask;
+	int paletteKey;
+	uint32 table[256];
+
+	RowBlitter(const PixelFormat &srcFormat, const PixelFormat &dstFormat) : mode(kModeNone),
+			srcBytesPerPixel(srcFormat.bytesPerPixel), dstBytesPerPixel(dstFormat.bytesPerPixel),
+			key(0), colorMask(0), paletteKey(-1) {
+		getBlitSIMDProcs(procs);
+	}
+
+	bool setConvert(const PixelFormat &srcFormat, const PixelFormat &dstFormat) {
+		if (!procs.convert || srcFormat.aBits() != 0 || !format.set(srcFormat, dstFormat))
+			return false;
+		mode = kModeConvert;
+		return true;
+	}
+
+	bool setColorKey(const PixelFormat &pixelFormat, uint32 transColor) {
+		if (!procs.colorKey || pixelFormat.aBits() != 0 || (pixelFormat.bytesPerPixel != 2 && pixelFormat.bytesPerPixel != 4))
+			return false;
+		key = transColor;
+		colorMask = pixelFormat.ARGBToColor(0, 0xff, 0xff, 0xff);
+		mode = kModeColorKey;
+		return true;
+	}
+
+	bool setPalette(const uint32 *palette, const PixelFormat &dstFormat, int transColor) {
+		if (!procs.expandPalette || !palette || (dstFormat.bytesPerPixel != 2 && dstFormat.bytesPerPixel != 4))
+			return false;
+		for (int i = 0; i < 256; i++) {
+			const uint32 col = palette[i];
+			if ((col >> 24) != 0xff)
+				return false;
+			table[i] = dstFormat.ARGBToColor(0xff, col & 0xff, (col >> 8) & 0xff, (col >> 16) & 0xff);
+		}
+		paletteKey = transColor;
+		mode = kModePalette;
+		return true;
+	}
+
+	bool setAlpha(const PixelFormat &srcFormat, const PixelFormat &dstFormat) {
+		if (!procs.blendAlpha || srcFormat != dstFormat || !alpha.set(srcFormat))
+			return false;
+		mode = kModeAlpha;
+		return true;
+	}
+
+	/**
+	 * Blit the leading pixels of a row, where destP and srcP point to the
+	 * first pixel of destRect and its source, and return the index of the
+	 * first pixel left to the generic code.
+	 */
+	int blitRow(byte *destP, const byte *srcP, const Common::Rect &destRect, int surfaceWidth) const {
+		const int offset = MAX<int>(-destRect.left, 0);
+		const int width = MIN<int>(destRect.right, surfaceWidth) - destRect.left - offset;
+		if (mode == kModeNone || width <= 0)
+			return 0;
+
+		byte *dst = destP + offset * dstBytesPerPixel;
+		const byte *src = srcP + offset * srcBytesPerPixel;
+		switch (mode) {
+		case kModeConvert:
+			return offset + procs.convert(dst, src, width, format);
+		case kModeColorKey:
+			return offset + procs.colorKey(dst, src, width, dstBytesPerPixel, key, colorMask);
+		case kModePalette:
+			return offset + procs.expandPalette(dst, src, width, dstBytesPerPixel, table, paletteKey);
+		case kModeAlpha:
+			return offset + procs.blendAlpha((uint32 *)dst, (const uint32 *)src, width, alpha);
+		default:
+			return 0;
+		}
+	}
+};
+
+} // End of anonymous namespace
+
 ManagedSurface::ManagedSurface() :
 		w(_innerSurface.w), h(_innerSurface.h), pitch(_innerSurface.pitch), format(_innerSurface.format),
 		_disposeAfterUse(DisposeAfterUse::NO), _owner(nullptr),
@@ -269,6 +368,15 @@ void ManagedSurface::blitFromInner(const Surface &src, const Common::Rect &srcRe
 	}
 
 	const bool noScale = scaleX == SCALE_THRESHOLD && scaleY == SCALE_THRESHOLD;
+
+	RowBlitter blitter(src.format, format);
+	if (noScale && (format.bytesPerPixel == 2 || format.bytesPerPixel == 4)) {
+		if (src.format.bytesPerPixel == 1)
+			blitter.setPalette(srcPalette, format, -1);
+		else if (!blitter.setConvert(src.format, format))
+			blitter.setAlpha(src.format, format);
+	}
+
 	for (int destY = destRect.top, scaleYCtr = 0; destY < destRect.bottom; ++destY, scaleYCtr += scaleY) {
 		if (destY < 0 || destY >= h)
 			continue;
@@ -283,7 +391,8 @@ void ManagedSurface::blitFromInner(const Surface &src, const Common::Rect &srcRe
 		}
 
 		// Loop through drawing the pixels of the row
-		for (int destX = destRect.left, xCtr = 0, scaleXCtr = 0; destX < destRect.right; ++destX, ++xCtr, scaleXCtr += scaleX) {
+		const int startX = blitter.blitRow(destP, srcP, destRect, w);
+		for (int destX = destRect.left + startX, xCtr = startX, scaleXCtr = startX * scaleX; destX < destRect.right; ++destX, ++xCtr, scaleXCtr += scaleX) {
 			if (destX < 0 || destX >= w)
 				continue;
 
@@ -550,6 +659,26 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, ManagedSurface &
 	if (isSrcTrans32) {
 		src.format.colorToRGB(transColor, rst, gst, bst);
 	}
+
+	RowBlitter blitter(src.format, dest.format);
+	if (scaleX == SCALE_THRESHOLD && scaleY == SCALE_THRESHOLD && !flipped && !mask && sizeof(TDEST) != 1) {
+		if (sizeof(TSRC) == 1) {
+			if (srcAlpha == 0xff)
+				blitter.setPalette(srcPalette, dest.format, maskOnly ? -1 : (int)transColor);
+		} else if (src.format == dest.format && srcAlpha == 0xff && src.format.aBits() == 0) {
+			if (maskOnly)
+				blitter.setConvert(src.format, dest.format);
+			else
+				blitter.setColorKey(src.format, transColor);
+		} else if (!dest.hasTransparentColor() && blitter.setAlpha(src.format, dest.format)) {
+			blitter.alpha.srcAlpha = srcAlpha;
+			if (!maskOnly) {
+				blitter.alpha.useKey = true;
+				blitter.alpha.keyMask = isSrcTrans32 ? src.format.ARGBToColor(0, 0xff, 0xff, 0xff) : 0xffffffff;
+				blitter.alpha.key = transColor & blitter.alpha.keyMask;
+			}
+		}
+	}
 	bool isDestTrans32 = dest.format.aBits() != 0 && dest.hasTransparentColor();
 	if (isDestTrans32) {
 		dest.format.colorToRGB(dest.getTransparentColor(), rdt, gdt, bdt);
@@ -568,7 +697,8 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, ManagedSurface &
 		TDEST *destLine = (TDEST *)dest.getBasePtr(destRect.left, destY);
 
 		// Loop through drawing the pixels of the row
-		for (int destX = destRect.left, xCtr = 0, scaleXCtr = 0; destX < destRect.right; ++destX, ++xCtr, scaleXCtr += scaleX) {
+		const int startX = blitter.blitRow((byte *)destLine, (const byte *)srcLine, destRect, dest.w);
+		for (int destX = destRect.left + startX, xCtr = startX, scaleXCtr = startX * scaleX; destX < destRect.right; ++destX, ++xCtr, scaleXCtr += scaleX) {
 			if (destX < 0 || destX >= dest.w)
 				continue;
 
@@ -54,6 +54,33 @@ MODULE_OBJS := \
 	opengl/control_shaders.o \
 	opengl/compat_shaders.o
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	blit_sse2.o \
+	transparent_surface_sse2.o \
+	yuv_to_rgb_sse2.o
+$(MODULE)/blit_sse2.o: CXXFLAGS += -msse2
+$(MODULE)/transparent_surface_sse2.o: CXXFLAGS += -msse2
+$(MODULE)/yuv_to_rgb_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	blit_avx2.o \
+	transparent_surface_avx2.o \
+	yuv_to_rgb_avx2.o
+$(MODULE)/blit_avx2.o: CXXFLAGS += -mavx2
+$(MODULE)/transparent_surface_avx2.o: CXXFLAGS += -mavx2
+$(MODULE)/yuv_to_rgb_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	blit_neon.o \
+	transparent_surface_neon.o \
+	yuv_to_rgb_neon.o
+endif
+
 ifdef USE_TINYGL
 MODULE_OBJS += \
 	tinygl/api.o \
@@ -79,6 +106,18 @@ MODULE_OBJS += \
 	tinygl/ztriangle.o \
 	tinygl/zblit.o \
 	tinygl/zdirtyrect.o
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	tinygl/zspan_sse2.o
+$(MODULE)/tinygl/zspan_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	tinygl/zspan_avx2.o
+$(MODULE)/tinygl/zspan_avx2.o: CXXFLAGS += -mavx2
+endif
 endif
 
 ifdef USE_SCALERS
@@ -90,6 +129,23 @@ MODULE_OBJS += \
 	scaler/scale3x.o \
 	scaler/scalebit.o
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	scaler/simd_sse2.o
+$(MODULE)/scaler/simd_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	scaler/simd_avx2.o
+$(MODULE)/scaler/simd_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	scaler/simd_neon.o
+endif
+
 ifdef USE_ARM_SCALER_ASM
 MODULE_OBJS += \
 	scaler/downscalerARM.o \
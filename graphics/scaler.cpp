@@ -22,6 +22,8 @@
 
 #include "graphics/scaler/intern.h"
 #include "graphics/scaler/scalebit.h"
+#include "graphics/scaler/simd.h"
+#include "common/cpudetect.h"
 #include "common/util.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -123,6 +125,34 @@ void InitLUT(Graphics::PixelFormat format) {
 /** Lookup table for the DotMatrix scaler. */
 uint16 g_dotmatrix[16] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
 
+/** The SIMD kernels used by the scalers, setup by InitSIMDScalers(). */
+SIMDScalerProcs g_simdScalers;
+
+static void InitSIMDScalers(int bitFormat) {
+	memset(&g_simdScalers, 0, sizeof(g_simdScalers));
+
+#ifdef USE_SCALERS
+#ifdef SCUMMVM_AVX2
+	if (Common::hasCpuFeature(Common::kCpuFeatureAVX2)) {
+		getSIMDScalerProcsAVX2(g_simdScalers, bitFormat);
+		return;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (Common::hasCpuFeature(Common::kCpuFeatureSSE2)) {
+		getSIMDScalerProcsSSE2(g_simdScalers, bitFormat);
+		return;
+	}
+#endif
+#ifdef SCUMMVM_NEON
+	if (Common::hasCpuFeature(Common::kCpuFeatureNEON)) {
+		getSIMDScalerProcsNEON(g_simdScalers, bitFormat);
+		return;
+	}
+#endif
+#endif
+}
+
 /** Init the scaler subsystem. */
 void InitScalers(uint32 BitFormat) {
 	gBitFormat = BitFormat;
@@ -144,6 +174,8 @@ void InitScalers(uint32 BitFormat) {
 	InitLUT(format);
 #endif
 
+	InitSIMDScalers(gBitFormat);
+
 	// Build dotmatrix lookup table for the DotMatrix scaler.
 	g_dotmatrix[0] = g_dotmatrix[10] = format.RGBToColor( 0, 63,  0);
 	g_dotmatrix[1] = g_dotmatrix[11] = format.RGBToColor( 0,  0, 63);
@@ -153,6 +185,8 @@ void InitScalers(uint32 BitFormat) {
 }
 
 void DestroyScalers() {
+	memset(&g_simdScalers, 0, sizeof(g_simdScalers));
+
 #ifdef USE_HQ_SCALERS
 	free(RGBtoYUV);
 	RGBtoYUV = 0;
@@ -206,6 +240,15 @@ void Normal2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 							int width, int height) {
 	uint8 *r;
 
+	if (g_simdScalers.normal2x) {
+		const int columns = g_simdScalers.normal2x(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		srcPtr += columns * sizeof(uint16);
+		dstPtr += columns * 2 * sizeof(uint16);
+		width -= columns;
+		if (!width)
+			return;
+	}
+
 	assert(IS_ALIGNED(dstPtr, 4));
 	while (height--) {
 		r = dstPtr;
@@ -232,6 +275,15 @@ void Normal3x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 	const uint32 dstPitch2 = dstPitch * 2;
 	const uint32 dstPitch3 = dstPitch * 3;
 
+	if (g_simdScalers.normal3x) {
+		const int columns = g_simdScalers.normal3x(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		srcPtr += columns * sizeof(uint16);
+		dstPtr += columns * 3 * sizeof(uint16);
+		width -= columns;
+		if (!width)
+			return;
+	}
+
 	assert(IS_ALIGNED(dstPtr, 2));
 	while (height--) {
 		r = dstPtr;
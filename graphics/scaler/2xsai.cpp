@@ -21,6 +21,7 @@
  */
 
 #include "graphics/scaler/intern.h"
+#include "graphics/scaler/simd.h"
 
 
 
@@ -264,6 +265,15 @@ void SuperEagleTemplate(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uin
 
 void SuperEagle(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	extern int gBitFormat;
+	if (g_simdScalers.superEagle) {
+		const int columns = g_simdScalers.superEagle(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		srcPtr += columns * sizeof(uint16);
+		dstPtr += columns * 2 * sizeof(uint16);
+		width -= columns;
+		if (!width)
+			return;
+	}
+
 	if (gBitFormat == 565)
 		SuperEagleTemplate<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 	else
@@ -405,6 +415,15 @@ void _2xSaITemplate(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32
 
 void _2xSaI(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	extern int gBitFormat;
+	if (g_simdScalers._2xSaI) {
+		const int columns = g_simdScalers._2xSaI(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		srcPtr += columns * sizeof(uint16);
+		dstPtr += columns * 2 * sizeof(uint16);
+		width -= columns;
+		if (!width)
+			return;
+	}
+
 	if (gBitFormat == 565)
 		_2xSaITemplate<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 	else
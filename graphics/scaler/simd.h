@@ -0,0 +1,81 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_SCALER_SIMD_H
+#define GRAPHICS_SCALER_SIMD_H
+
+#include "common/scummsys.h"
+
+/**
+ * Scale the leading columns of a block of 16 bit pixels, with the
+ * arguments of a ScalerProc. SIMD kernels work on whole vectors, so they
+ * return how many columns they handled and leave the rest of each row to
+ * the generic code of the scaler.
+ */
+typedef int (*SIMDScalerProc)(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
+
+/** Row kernels with the semantics of scale2x_16_def() and scale3x_16_def(). */
+typedef void (*SIMDScale2xProc)(uint16 *dst0, uint16 *dst1, const uint16 *src0, const uint16 *src1, const uint16 *src2, unsigned count);
+typedef void (*SIMDScale3xProc)(uint16 *dst0, uint16 *dst1, uint16 *dst2, const uint16 *src0, const uint16 *src1, const uint16 *src2, unsigned count);
+
+/**
+ * Compute the neighbour patterns of the hq scalers for count pixels,
+ * starting at src. Bit n is set where the pixel differs from neighbour
+ * n + 1 (n + 2 after the center), exactly like the diffYUV() tests do.
+ */
+typedef void (*SIMDHQPatternProc)(uint8 *patterns, const uint16 *src, uint32 nextlineSrc, int count);
+
+/**
+ * The SIMD kernels picked by InitScalers() for the current bit format.
+ * Entries are nullptr when no kernel can be used, the format dependent
+ * ones only exist for the 565 and 555 formats.
+ */
+struct SIMDScalerProcs {
+	SIMDScalerProc normal2x;
+	SIMDScalerProc normal3x;
+	SIMDScale2xProc scale2x;
+	SIMDScale3xProc scale3x;
+	SIMDScalerProc _2xSaI;
+	SIMDScalerProc superEagle;
+	SIMDHQPatternProc hqPattern;
+};
+
+extern SIMDScalerProcs g_simdScalers;
+
+#ifdef SCUMMVM_SSE2
+void getSIMDScalerProcsSSE2(SIMDScalerProcs &procs, int bitFormat);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void getSIMDScalerProcsAVX2(SIMDScalerProcs &procs, int bitFormat);
+#endif
+
+#ifdef SCUMMVM_NEON
+void getSIMDScalerProcsNEON(SIMDScalerProcs &procs, int bitFormat);
+#endif
+
+/** Number of pixels for which the hq scalers compute patterns at once. */
+enum {
+	kHQPatternChunk = 64
+};
+
+#endif
@@ -0,0 +1,88 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/scaler/simd.h"
+
+#include <immintrin.h>
+
+struct AVX2Ops {
+	typedef __m256i V;
+	enum { kPixels = 16 };
+
+	static FORCEINLINE V load(const uint16 *p) { return _mm256_loadu_si256((const __m256i *)p); }
+	static FORCEINLINE void store(uint16 *p, V v) { _mm256_storeu_si256((__m256i *)p, v); }
+	static FORCEINLINE V set1(int x) { return _mm256_set1_epi16((short)x); }
+	static FORCEINLINE V and_(V a, V b) { return _mm256_and_si256(a, b); }
+	static FORCEINLINE V or_(V a, V b) { return _mm256_or_si256(a, b); }
+	static FORCEINLINE V andnot(V a, V b) { return _mm256_andnot_si256(a, b); }
+	static FORCEINLINE V eq(V a, V b) { return _mm256_cmpeq_epi16(a, b); }
+	static FORCEINLINE V gt(V a, V b) { return _mm256_cmpgt_epi16(a, b); }
+	static FORCEINLINE V add(V a, V b) { return _mm256_add_epi16(a, b); }
+	static FORCEINLINE V sub(V a, V b) { return _mm256_sub_epi16(a, b); }
+	static FORCEINLINE V srli(V a, int n) { return _mm256_srli_epi16(a, n); }
+	static FORCEINLINE V slli(V a, int n) { return _mm256_slli_epi16(a, n); }
+	static FORCEINLINE V srai(V a, int n) { return _mm256_srai_epi16(a, n); }
+
+	static FORCEINLINE void store2(uint16 *p, V a, V b) {
+		// The unpacks work within the 128 bit halves
+		const V lo = _mm256_unpacklo_epi16(a, b);
+		const V hi = _mm256_unpackhi_epi16(a, b);
+		store(p, _mm256_permute2x128_si256(lo, hi, 0x20));
+		store(p + 16, _mm256_permute2x128_si256(lo, hi, 0x31));
+	}
+
+	static FORCEINLINE void store3(uint16 *p, V a, V b, V c) {
+		uint16 lanes[3][16];
+		store(lanes[0], a);
+		store(lanes[1], b);
+		store(lanes[2], c);
+		for (int i = 0; i < 16; ++i) {
+			p[3 * i + 0] = lanes[0][i];
+			p[3 * i + 1] = lanes[1][i];
+			p[3 * i + 2] = lanes[2][i];
+		}
+	}
+
+	static FORCEINLINE void storeTriple(uint16 *p, __m128i v) {
+		const __m128i low = _mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 2));
+		const __m128i high = _mm_shufflehi_epi16(v, _MM_SHUFFLE(1, 0, 0, 0));
+		_mm_storeu_si128((__m128i *)p, _mm_unpacklo_epi64(_mm_shufflelo_epi16(v, _MM_SHUFFLE(1, 0, 0, 0)), _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 2, 1, 1))));
+		_mm_storeu_si128((__m128i *)(p + 8), _mm_blend_epi32(low, high, 0x0C));
+		_mm_storeu_si128((__m128i *)(p + 16), _mm_unpackhi_epi64(_mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shufflehi_epi16(v, _MM_SHUFFLE(3, 3, 3, 2))));
+	}
+
+	static FORCEINLINE void storeTriple(uint16 *p, V v) {
+		storeTriple(p, _mm256_castsi256_si128(v));
+		storeTriple(p + 24, _mm256_extracti128_si256(v, 1));
+	}
+
+	static FORCEINLINE void storeBytes(uint8 *p, V v) {
+		const V packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), _MM_SHUFFLE(3, 1, 2, 0));
+		_mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(packed));
+	}
+};
+
+#include "graphics/scaler/simd_impl.h"
+
+void getSIMDScalerProcsAVX2(SIMDScalerProcs &procs, int bitFormat) {
+	getSIMDScalerProcs<AVX2Ops>(procs, bitFormat);
+}
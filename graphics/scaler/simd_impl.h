@@ -0,0 +1,493 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * The SIMD scaler kernels, written once against a small set of vector
+ * operations. Each simd_*.cpp file defines those operations for its
+ * instruction set and includes this file, which must not be included
+ * anywhere else: it is compiled with different code generation flags
+ * every time.
+ *
+ * An Ops class provides, for vectors V of kPixels 16 bit lanes:
+ *   load(), store(), set1(), and_(), or_(), andnot() (~a & b), eq(), gt()
+ *   (signed), add(), sub(), srli(), slli(), srai(), store2() and store3()
+ *   which interleave two resp. three vectors, storeTriple() which stores
+ *   every lane three times and storeBytes() which stores the low byte of
+ *   each lane.
+ *
+ * All kernels produce exactly the same pixels as the generic code.
+ */
+
+#ifndef GRAPHICS_SCALER_SIMD_IMPL_H
+#define GRAPHICS_SCALER_SIMD_IMPL_H
+
+#include "common/util.h"
+#include "graphics/colormasks.h"
+#include "graphics/scaler/scale2x.h"
+#include "graphics/scaler/scale3x.h"
+#include "graphics/scaler/simd.h"
+
+template<class Ops>
+static FORCEINLINE typename Ops::V selectLanes(typename Ops::V mask, typename Ops::V a, typename Ops::V b) {
+	return Ops::or_(Ops::and_(mask, a), Ops::andnot(mask, b));
+}
+
+template<class Ops>
+static FORCEINLINE typename Ops::V notEqual(typename Ops::V a, typename Ops::V b) {
+	return Ops::andnot(Ops::eq(a, b), Ops::set1(0xFFFF));
+}
+
+/*
+ * The interpolate16_* functions compute per channel averages rounded
+ * down. The versions below split the channels into their high and low
+ * bits first, so that no intermediate result needs more than 16 bits.
+ */
+
+template<class Ops, class ColorMask>
+static FORCEINLINE typename Ops::V interpolate_1_1(typename Ops::V p1, typename Ops::V p2) {
+	const typename Ops::V high = Ops::set1(ColorMask::kHighBitsMask & 0xFFFF);
+	return Ops::add(Ops::add(Ops::srli(Ops::and_(p1, high), 1), Ops::srli(Ops::and_(p2, high), 1)),
+	                Ops::and_(Ops::and_(p1, p2), Ops::set1(ColorMask::kLowBits)));
+}
+
+template<class Ops, class ColorMask>
+static FORCEINLINE typename Ops::V interpolate_3_1(typename Ops::V p1, typename Ops::V p2) {
+	typedef typename Ops::V V;
+	const V high = Ops::set1(ColorMask::qhighBits & 0xFFFF);
+	const V low = Ops::set1(ColorMask::kLow2Bits);
+	const V h1 = Ops::srli(Ops::and_(p1, high), 2);
+	const V l1 = Ops::and_(p1, low);
+	const V x = Ops::add(Ops::add(Ops::add(h1, h1), h1), Ops::srli(Ops::and_(p2, high), 2));
+	const V y = Ops::srli(Ops::add(Ops::add(Ops::add(l1, l1), l1), Ops::and_(p2, low)), 2);
+	return Ops::add(x, Ops::and_(y, low));
+}
+
+/** (6 * p1 + p2 + p3) / 8 rounded down equals interpolate_3_1(p1, interpolate_1_1(p2, p3)). */
+template<class Ops, class ColorMask>
+static FORCEINLINE typename Ops::V interpolate_6_1_1(typename Ops::V p1, typename Ops::V p2, typename Ops::V p3) {
+	return interpolate_3_1<Ops, ColorMask>(p1, interpolate_1_1<Ops, ColorMask>(p2, p3));
+}
+
+template<class Ops, class ColorMask>
+static FORCEINLINE typename Ops::V interpolate_1_1_1_1(typename Ops::V p1, typename Ops::V p2, typename Ops::V p3, typename Ops::V p4) {
+	typedef typename Ops::V V;
+	const V high = Ops::set1(ColorMask::qhighBits & 0xFFFF);
+	const V low = Ops::set1(ColorMask::kLow2Bits);
+	const V x = Ops::add(Ops::add(Ops::srli(Ops::and_(p1, high), 2), Ops::srli(Ops::and_(p2, high), 2)),
+	                     Ops::add(Ops::srli(Ops::and_(p3, high), 2), Ops::srli(Ops::and_(p4, high), 2)));
+	const V y = Ops::add(Ops::add(Ops::and_(p1, low), Ops::and_(p2, low)), Ops::add(Ops::and_(p3, low), Ops::and_(p4, low)));
+	return Ops::add(x, Ops::and_(Ops::srli(y, 2), low));
+}
+
+/** Accumulate GetResult(a, b, c, d) of 2xsai.cpp into r. */
+template<class Ops>
+static FORCEINLINE typename Ops::V addResult(typename Ops::V r, typename Ops::V a, typename Ops::V b, typename Ops::V c, typename Ops::V d) {
+	typedef typename Ops::V V;
+	const V ac = Ops::eq(a, c);
+	const V ad = Ops::eq(a, d);
+	const V bothA = Ops::and_(ac, ad);
+	const V bothB = Ops::andnot(Ops::or_(ac, ad), Ops::and_(Ops::eq(b, c), Ops::eq(b, d)));
+	// The masks are -1 where set
+	return Ops::add(Ops::sub(r, bothB), bothA);
+}
+
+template<class Ops>
+static int normal2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+	const int columns = width - width % Ops::kPixels;
+
+	while (height--) {
+		const uint16 *s = (const uint16 *)srcPtr;
+		uint16 *d0 = (uint16 *)dstPtr;
+		uint16 *d1 = (uint16 *)(dstPtr + dstPitch);
+		for (int i = 0; i < columns; i += Ops::kPixels) {
+			const typename Ops::V v = Ops::load(s + i);
+			Ops::store2(d0 + 2 * i, v, v);
+			Ops::store2(d1 + 2 * i, v, v);
+		}
+		srcPtr += srcPitch;
+		dstPtr += dstPitch << 1;
+	}
+
+	return columns;
+}
+
+template<class Ops>
+static int normal3x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+	const int columns = width - width % Ops::kPixels;
+
+	while (height--) {
+		const uint16 *s = (const uint16 *)srcPtr;
+		uint16 *d0 = (uint16 *)dstPtr;
+		uint16 *d1 = (uint16 *)(dstPtr + dstPitch);
+		uint16 *d2 = (uint16 *)(dstPtr + dstPitch * 2);
+		for (int i = 0; i < columns; i += Ops::kPixels) {
+			const typename Ops::V v = Ops::load(s + i);
+			Ops::storeTriple(d0 + 3 * i, v);
+			Ops::storeTriple(d1 + 3 * i, v);
+			Ops::storeTriple(d2 + 3 * i, v);
+		}
+		srcPtr += srcPitch;
+		dstPtr += dstPitch * 3;
+	}
+
+	return columns;
+}
+
+template<class Ops>
+static void scale2xRow(uint16 *dst0, uint16 *dst1, const uint16 *src0, const uint16 *src1, const uint16 *src2, unsigned count) {
+	typedef typename Ops::V V;
+	const unsigned columns = count - count % Ops::kPixels;
+
+	for (unsigned i = 0; i < columns; i += Ops::kPixels) {
+		const V b = Ops::load(src0 + i);
+		const V d = Ops::load(src1 + i - 1);
+		const V e = Ops::load(src1 + i);
+		const V f = Ops::load(src1 + i + 1);
+		const V h = Ops::load(src2 + i);
+		const V cond = Ops::andnot(Ops::or_(Ops::eq(b, h), Ops::eq(d, f)), Ops::set1(0xFFFF));
+
+		Ops::store2(dst0 + 2 * i, selectLanes<Ops>(Ops::and_(cond, Ops::eq(d, b)), b, e), selectLanes<Ops>(Ops::and_(cond, Ops::eq(f, b)), b, e));
+		Ops::store2(dst1 + 2 * i, selectLanes<Ops>(Ops::and_(cond, Ops::eq(d, h)), h, e), selectLanes<Ops>(Ops::and_(cond, Ops::eq(f, h)), h, e));
+	}
+
+	if (columns < count)
+		scale2x_16_def(dst0 + 2 * columns, dst1 + 2 * columns, src0 + columns, src1 + columns, src2 + columns, count - columns);
+}
+
+template<class Ops>
+static void scale3xRow(uint16 *dst0, uint16 *dst1, uint16 *dst2, const uint16 *src0, const uint16 *src1, const uint16 *src2, unsigned count) {
+	typedef typename Ops::V V;
+	const unsigned columns = count - count % Ops::kPixels;
+
+	//   A B C
+	//   D E F
+	//   G H I
+	for (unsigned i = 0; i < columns; i += Ops::kPixels) {
+		const V a = Ops::load(src0 + i - 1);
+		const V b = Ops::load(src0 + i);
+		const V c = Ops::load(src0 + i + 1);
+		const V d = Ops::load(src1 + i - 1);
+		const V e = Ops::load(src1 + i);
+		const V f = Ops::load(src1 + i + 1);
+		const V g = Ops::load(src2 + i - 1);
+		const V h = Ops::load(src2 + i);
+		const V k = Ops::load(src2 + i + 1);
+		const V cond = Ops::andnot(Ops::or_(Ops::eq(b, h), Ops::eq(d, f)), Ops::set1(0xFFFF));
+
+		const V db = Ops::and_(cond, Ops::eq(d, b));
+		const V fb = Ops::and_(cond, Ops::eq(f, b));
+		const V dh = Ops::and_(cond, Ops::eq(d, h));
+		const V fh = Ops::and_(cond, Ops::eq(f, h));
+		const V ea = notEqual<Ops>(e, a);
+		const V ec = notEqual<Ops>(e, c);
+		const V eg = notEqual<Ops>(e, g);
+		const V ek = notEqual<Ops>(e, k);
+
+		Ops::store3(dst0 + 3 * i,
+		            selectLanes<Ops>(db, d, e),
+		            selectLanes<Ops>(Ops::or_(Ops::and_(db, ec), Ops::and_(fb, ea)), b, e),
+		            selectLanes<Ops>(fb, f, e));
+		Ops::store3(dst1 + 3 * i,
+		            selectLanes<Ops>(Ops::or_(Ops::and_(db, eg), Ops::and_(dh, ea)), d, e),
+		            e,
+		            selectLanes<Ops>(Ops::or_(Ops::and_(fb, ek), Ops::and_(fh, ec)), f, e));
+		Ops::store3(dst2 + 3 * i,
+		            selectLanes<Ops>(dh, d, e),
+		            selectLanes<Ops>(Ops::or_(Ops::and_(dh, ek), Ops::and_(fh, eg)), h, e),
+		            selectLanes<Ops>(fh, f, e));
+	}
+
+	if (columns < count)
+		scale3x_16_def(dst0 + 3 * columns, dst1 + 3 * columns, dst2 + 3 * columns, src0 + columns, src1 + columns, src2 + columns, count - columns);
+}
+
+/** Branch free version of _2xSaITemplate(), see 2xsai.cpp for the pixel map. */
+template<class Ops, class ColorMask>
+static int scale2xSaI(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+	typedef typename Ops::V V;
+	const int columns = width - width % Ops::kPixels;
+	const uint32 nextlineSrc = srcPitch >> 1;
+
+	while (height--) {
+		const uint16 *bP = (const uint16 *)srcPtr;
+		uint16 *dP = (uint16 *)dstPtr;
+
+		for (int i = 0; i < columns; i += Ops::kPixels, bP += Ops::kPixels, dP += 2 * Ops::kPixels) {
+			const V colorI = Ops::load(bP - nextlineSrc - 1);
+			const V colorE = Ops::load(bP - nextlineSrc);
+			const V colorF = Ops::load(bP - nextlineSrc + 1);
+			const V colorJ = Ops::load(bP - nextlineSrc + 2);
+
+			const V colorG = Ops::load(bP - 1);
+			const V colorA = Ops::load(bP);
+			const V colorB = Ops::load(bP + 1);
+			const V colorK = Ops::load(bP + 2);
+
+			const V colorH = Ops::load(bP + nextlineSrc - 1);
+			const V colorC = Ops::load(bP + nextlineSrc);
+			const V colorD = Ops::load(bP + nextlineSrc + 1);
+			const V colorL = Ops::load(bP + nextlineSrc + 2);
+
+			const V colorM = Ops::load(bP + 2 * nextlineSrc - 1);
+			const V colorN = Ops::load(bP + 2 * nextlineSrc);
+			const V colorO = Ops::load(bP + 2 * nextlineSrc + 1);
+
+			const V ad = Ops::eq(colorA, colorD);
+			const V bc = Ops::eq(colorB, colorC);
+			const V case1 = Ops::andnot(bc, ad);
+			const V case2 = Ops::andnot(ad, bc);
+			const V case3 = Ops::and_(ad, bc);
+			const V case4 = Ops::andnot(Ops::or_(ad, bc), Ops::set1(0xFFFF));
+
+			// The conditions shared by the first and the last case
+			const V q1 = Ops::and_(Ops::and_(Ops::eq(colorA, colorC), Ops::eq(colorA, colorF)),
+			                       Ops::andnot(Ops::eq(colorB, colorE), Ops::eq(colorB, colorJ)));
+			const V q2 = Ops::and_(Ops::and_(Ops::eq(colorB, colorE), Ops::eq(colorB, colorD)),
+			                       Ops::andnot(Ops::eq(colorA, colorF), Ops::eq(colorA, colorI)));
+			const V s1 = Ops::and_(Ops::and_(Ops::eq(colorA, colorB), Ops::eq(colorA, colorH)),
+			                       Ops::andnot(Ops::eq(colorG, colorC), Ops::eq(colorC, colorM)));
+			const V s2 = Ops::and_(Ops::and_(Ops::eq(colorC, colorG), Ops::eq(colorC, colorD)),
+			                       Ops::andnot(Ops::eq(colorA, colorH), Ops::eq(colorA, colorI)));
+
+			const V productA = Ops::or_(Ops::and_(case1, Ops::or_(Ops::and_(Ops::eq(colorA, colorE), Ops::eq(colorB, colorL)), q1)),
+			                            Ops::and_(case4, q1));
+			const V productB = Ops::or_(Ops::and_(case2, Ops::or_(Ops::and_(Ops::eq(colorB, colorF), Ops::eq(colorA, colorH)), q2)),
+			                            Ops::and_(case4, Ops::andnot(q1, q2)));
+			const V product = selectLanes<Ops>(productA, colorA, selectLanes<Ops>(productB, colorB, interpolate_1_1<Ops, ColorMask>(colorA, colorB)));
+
+			const V product1A = Ops::or_(Ops::and_(case1, Ops::or_(Ops::and_(Ops::eq(colorA, colorG), Ops::eq(colorC, colorO)), s1)),
+			                             Ops::and_(case4, s1));
+			const V product1C = Ops::or_(Ops::and_(case2, Ops::or_(Ops::and_(Ops::eq(colorC, colorH), Ops::eq(colorA, colorF)), s2)),
+			                             Ops::and_(case4, Ops::andnot(s1, s2)));
+			const V product1 = selectLanes<Ops>(product1A, colorA, selectLanes<Ops>(product1C, colorC, interpolate_1_1<Ops, ColorMask>(colorA, colorC)));
+
+			// r = GetResult(A, B, G, E) - GetResult(B, A, K, F) - GetResult(B, A, H, N) + GetResult(A, B, L, O)
+			V r = addResult<Ops>(Ops::set1(0), colorA, colorB, colorG, colorE);
+			r = addResult<Ops>(r, colorA, colorB, colorL, colorO);
+			V subtracted = addResult<Ops>(Ops::set1(0), colorB, colorA, colorK, colorF);
+			subtracted = addResult<Ops>(subtracted, colorB, colorA, colorH, colorN);
+			r = Ops::sub(r, subtracted);
+			const V product2A = Ops::or_(case1, Ops::and_(case3, Ops::gt(r, Ops::set1(0))));
+			const V product2B = Ops::or_(case2, Ops::and_(case3, Ops::gt(Ops::set1(0), r)));
+			const V product2 = selectLanes<Ops>(product2A, colorA, selectLanes<Ops>(product2B, colorB,
+			                               interpolate_1_1_1_1<Ops, ColorMask>(colorA, colorB, colorC, colorD)));
+
+			Ops::store2(dP, colorA, product);
+			Ops::store2(dP + dstPitch / 2, product1, product2);
+		}
+
+		srcPtr += srcPitch;
+		dstPtr += dstPitch * 2;
+	}
+
+	return columns;
+}
+
+/** Branch free version of SuperEagleTemplate(), see 2xsai.cpp for the pixel map. */
+template<class Ops, class ColorMask>
+static int superEagle(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+	typedef typename Ops::V V;
+	const int columns = width - width % Ops::kPixels;
+	const uint32 nextlineSrc = srcPitch >> 1;
+
+	while (height--) {
+		const uint16 *bP = (const uint16 *)srcPtr;
+		uint16 *dP = (uint16 *)dstPtr;
+
+		for (int i = 0; i < columns; i += Ops::kPixels, bP += Ops::kPixels, dP += 2 * Ops::kPixels) {
+			const V colorB1 = Ops::load(bP - nextlineSrc);
+			const V colorB2 = Ops::load(bP - nextlineSrc + 1);
+
+			const V color4 = Ops::load(bP - 1);
+			const V color5 = Ops::load(bP);
+			const V color6 = Ops::load(bP + 1);
+			const V colorS2 = Ops::load(bP + 2);
+
+			const V color1 = Ops::load(bP + nextlineSrc - 1);
+			const V color2 = Ops::load(bP + nextlineSrc);
+			const V color3 = Ops::load(bP + nextlineSrc + 1);
+			const V colorS1 = Ops::load(bP + nextlineSrc + 2);
+
+			const V colorA1 = Ops::load(bP + 2 * nextlineSrc);
+			const V colorA2 = Ops::load(bP + 2 * nextlineSrc + 1);
+
+			const V same53 = Ops::eq(color5, color3);
+			const V same26 = Ops::eq(color2, color6);
+			const V i56 = interpolate_1_1<Ops, ColorMask>(color5, color6);
+			const V i23 = interpolate_1_1<Ops, ColorMask>(color2, color3);
+
+			// color5 != color3, color2 == color6 unless overridden below
+			V p1a = selectLanes<Ops>(Ops::or_(Ops::eq(color1, color2), Ops::eq(color6, colorB2)),
+			                    interpolate_3_1<Ops, ColorMask>(color2, color5), i56);
+			V p2b = selectLanes<Ops>(Ops::or_(Ops::eq(color6, colorS2), Ops::eq(color2, colorA1)),
+			                    interpolate_3_1<Ops, ColorMask>(color2, color3), i23);
+			V p1b = color2;
+			V p2a = color2;
+
+			// color5 != color3, color2 != color6
+			const V case2 = Ops::andnot(Ops::or_(same53, same26), Ops::set1(0xFFFF));
+			p2b = selectLanes<Ops>(case2, interpolate_6_1_1<Ops, ColorMask>(color3, color2, color6), p2b);
+			p1a = selectLanes<Ops>(case2, interpolate_6_1_1<Ops, ColorMask>(color5, color2, color6), p1a);
+			p2a = selectLanes<Ops>(case2, interpolate_6_1_1<Ops, ColorMask>(color2, color5, color3), p2a);
+			p1b = selectLanes<Ops>(case2, interpolate_6_1_1<Ops, ColorMask>(color6, color5, color3), p1b);
+
+			// color5 == color3, color2 != color6
+			const V case3 = Ops::andnot(same26, same53);
+			p2b = selectLanes<Ops>(case3, color5, p2b);
+			p1a = selectLanes<Ops>(case3, color5, p1a);
+			p1b = selectLanes<Ops>(case3, selectLanes<Ops>(Ops::or_(Ops::eq(colorB1, color5), Ops::eq(color3, colorS1)),
+			                                     interpolate_3_1<Ops, ColorMask>(color5, color6), i56), p1b);
+			p2a = selectLanes<Ops>(case3, selectLanes<Ops>(Ops::or_(Ops::eq(color3, colorA2), Ops::eq(color4, color5)),
+			                                     interpolate_3_1<Ops, ColorMask>(color5, color2), i23), p2a);
+
+			// color5 == color3, color2 == color6
+			const V case4 = Ops::and_(same53, same26);
+			V r = Ops::set1(0);
+			r = addResult<Ops>(r, color6, color5, color1, colorA1);
+			r = addResult<Ops>(r, color6, color5, color4, colorB1);
+			r = addResult<Ops>(r, color6, color5, colorA2, colorS1);
+			r = addResult<Ops>(r, color6, color5, colorB2, colorS2);
+			const V positive = Ops::and_(case4, Ops::gt(r, Ops::set1(0)));
+			const V negative = Ops::and_(case4, Ops::gt(Ops::set1(0), r));
+			const V zero = Ops::andnot(Ops::or_(positive, negative), case4);
+			p1b = selectLanes<Ops>(Ops::or_(positive, zero), color2, selectLanes<Ops>(negative, i56, p1b));
+			p2a = selectLanes<Ops>(Ops::or_(positive, zero), color2, selectLanes<Ops>(negative, i56, p2a));
+			p1a = selectLanes<Ops>(positive, i56, selectLanes<Ops>(Ops::or_(negative, zero), color5, p1a));
+			p2b = selectLanes<Ops>(positive, i56, selectLanes<Ops>(Ops::or_(negative, zero), color5, p2b));
+
+			Ops::store2(dP, p1a, p1b);
+			Ops::store2(dP + dstPitch / 2, p2a, p2b);
+		}
+
+		srcPtr += srcPitch;
+		dstPtr += dstPitch * 2;
+	}
+
+	return columns;
+}
+
+/**
+ * The luminance and chrominance of InitLUT(), computed on the fly: the
+ * offsets of u and v cancel out in the comparisons.
+ */
+template<class Ops, int bitFormat>
+static FORCEINLINE void convertToYUV(typename Ops::V c, typename Ops::V &y, typename Ops::V &u, typename Ops::V &v) {
+	typedef typename Ops::V V;
+	const V mask5 = Ops::set1(0x1F);
+	V r, g;
+	if (bitFormat == 565) {
+		r = Ops::srli(c, 11);
+		g = Ops::and_(Ops::srli(c, 5), Ops::set1(0x3F));
+		g = Ops::or_(Ops::slli(g, 2), Ops::srli(g, 4));
+	} else {
+		r = Ops::and_(Ops::srli(c, 10), mask5);
+		g = Ops::and_(Ops::srli(c, 5), mask5);
+		g = Ops::or_(Ops::slli(g, 3), Ops::srli(g, 2));
+	}
+	V b = Ops::and_(c, mask5);
+	r = Ops::or_(Ops::slli(r, 3), Ops::srli(r, 2));
+	b = Ops::or_(Ops::slli(b, 3), Ops::srli(b, 2));
+
+	y = Ops::srli(Ops::add(Ops::add(r, g), b), 2);
+	u = Ops::srai(Ops::sub(r, b), 2);
+	v = Ops::srai(Ops::sub(Ops::sub(Ops::add(g, g), r), b), 3);
+}
+
+/** Lanes where |a - b| > threshold. */
+template<class Ops>
+static FORCEINLINE typename Ops::V differs(typename Ops::V a, typename Ops::V b, int threshold) {
+	const typename Ops::V d = Ops::sub(a, b);
+	return Ops::or_(Ops::gt(d, Ops::set1(threshold)), Ops::gt(Ops::set1(-threshold), d));
+}
+
+template<class Ops, int bitFormat>
+static FORCEINLINE void hqPatternBlock(uint8 *patterns, const uint16 *src, uint32 nextlineSrc) {
+	typedef typename Ops::V V;
+	const V w5 = Ops::load(src);
+	V y5, u5, v5;
+	convertToYUV<Ops, bitFormat>(w5, y5, u5, v5);
+
+	//   w1 w2 w3
+	//   w4 w5 w6
+	//   w7 w8 w9
+	const uint16 *const neighbours[8] = {
+		src - nextlineSrc - 1, src - nextlineSrc, src - nextlineSrc + 1,
+		src - 1, src + 1,
+		src + nextlineSrc - 1, src + nextlineSrc, src + nextlineSrc + 1
+	};
+
+	V pattern = Ops::set1(0);
+	for (int n = 0; n < 8; ++n) {
+		const V w = Ops::load(neighbours[n]);
+		V y, u, v;
+		convertToYUV<Ops, bitFormat>(w, y, u, v);
+		const V diff = Ops::or_(Ops::or_(differs<Ops>(u5, u, 7), differs<Ops>(v5, v, 6)), differs<Ops>(y5, y, 48));
+		pattern = Ops::or_(pattern, Ops::and_(Ops::andnot(Ops::eq(w5, w), diff), Ops::set1(1 << n)));
+	}
+
+	Ops::storeBytes(patterns, pattern);
+}
+
+template<class Ops, int bitFormat>
+static void hqPattern(uint8 *patterns, const uint16 *src, uint32 nextlineSrc, int count) {
+	if (count < Ops::kPixels) {
+		// Work on a copy of the neighbourhood, padded to a whole vector
+		uint16 rows[3][Ops::kPixels + 2];
+		uint8 block[Ops::kPixels];
+		memset(rows, 0, sizeof(rows));
+		for (int row = 0; row < 3; ++row)
+			memcpy(rows[row], src + (row - 1) * (int)nextlineSrc - 1, (count + 2) * sizeof(uint16));
+		hqPatternBlock<Ops, bitFormat>(block, rows[1] + 1, Ops::kPixels + 2);
+		memcpy(patterns, block, count);
+		return;
+	}
+
+	// Patterns only depend on the source, so the last block may overlap
+	for (int i = 0; i < count; i += Ops::kPixels) {
+		const int x = MIN<int>(i, count - Ops::kPixels);
+		hqPatternBlock<Ops, bitFormat>(patterns + x, src + x, nextlineSrc);
+	}
+}
+
+template<class Ops>
+static void getSIMDScalerProcs(SIMDScalerProcs &procs, int bitFormat) {
+	procs.normal2x = normal2x<Ops>;
+	procs.normal3x = normal3x<Ops>;
+	procs.scale2x = scale2xRow<Ops>;
+	procs.scale3x = scale3xRow<Ops>;
+
+	if (bitFormat == 565) {
+		procs._2xSaI = scale2xSaI<Ops, Graphics::ColorMasks<565> >;
+		procs.superEagle = superEagle<Ops, Graphics::ColorMasks<565> >;
+		procs.hqPattern = hqPattern<Ops, 565>;
+	} else if (bitFormat == 555) {
+		procs._2xSaI = scale2xSaI<Ops, Graphics::ColorMasks<555> >;
+		procs.superEagle = superEagle<Ops, Graphics::ColorMasks<555> >;
+		procs.hqPattern = hqPattern<Ops, 555>;
+	} else {
+		procs._2xSaI = nullptr;
+		procs.superEagle = nullptr;
+		procs.hqPattern = nullptr;
+	}
+}
+
+#endif
@@ -0,0 +1,70 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/scaler/simd.h"
+
+#include <arm_neon.h>
+
+struct NEONOps {
+	typedef uint16x8_t V;
+	enum { kPixels = 8 };
+
+	static FORCEINLINE V load(const uint16 *p) { return vld1q_u16(p); }
+	static FORCEINLINE void store(uint16 *p, V v) { vst1q_u16(p, v); }
+	static FORCEINLINE V set1(int x) { return vdupq_n_u16((uint16)x); }
+	static FORCEINLINE V and_(V a, V b) { return vandq_u16(a, b); }
+	static FORCEINLINE V or_(V a, V b) { return vorrq_u16(a, b); }
+	static FORCEINLINE V andnot(V a, V b) { return vbicq_u16(b, a); }
+	static FORCEINLINE V eq(V a, V b) { return vceqq_u16(a, b); }
+	static FORCEINLINE V gt(V a, V b) { return vcgtq_s16(vreinterpretq_s16_u16(a), vreinterpretq_s16_u16(b)); }
+	static FORCEINLINE V add(V a, V b) { return vaddq_u16(a, b); }
+	static FORCEINLINE V sub(V a, V b) { return vsubq_u16(a, b); }
+	// Shifts by a register, the immediate forms need constants
+	static FORCEINLINE V srli(V a, int n) { return vshlq_u16(a, vdupq_n_s16((int16)-n)); }
+	static FORCEINLINE V slli(V a, int n) { return vshlq_u16(a, vdupq_n_s16((int16)n)); }
+	static FORCEINLINE V srai(V a, int n) { return vreinterpretq_u16_s16(vshlq_s16(vreinterpretq_s16_u16(a), vdupq_n_s16((int16)-n))); }
+
+	static FORCEINLINE void store2(uint16 *p, V a, V b) {
+		uint16x8x2_t v;
+		v.val[0] = a;
+		v.val[1] = b;
+		vst2q_u16(p, v);
+	}
+
+	static FORCEINLINE void store3(uint16 *p, V a, V b, V c) {
+		uint16x8x3_t v;
+		v.val[0] = a;
+		v.val[1] = b;
+		v.val[2] = c;
+		vst3q_u16(p, v);
+	}
+
+	static FORCEINLINE void storeTriple(uint16 *p, V v) { store3(p, v, v, v); }
+
+	static FORCEINLINE void storeBytes(uint8 *p, V v) { vst1_u8(p, vmovn_u16(v)); }
+};
+
+#include "graphics/scaler/simd_impl.h"
+
+void getSIMDScalerProcsNEON(SIMDScalerProcs &procs, int bitFormat) {
+	getSIMDScalerProcs<NEONOps>(procs, bitFormat);
+}
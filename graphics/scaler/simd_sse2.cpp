@@ -0,0 +1,81 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/scaler/simd.h"
+
+#include <emmintrin.h>
+
+struct SSE2Ops {
+	typedef __m128i V;
+	enum { kPixels = 8 };
+
+	static FORCEINLINE V load(const uint16 *p) { return _mm_loadu_si128((const __m128i *)p); }
+	static FORCEINLINE void store(uint16 *p, V v) { _mm_storeu_si128((__m128i *)p, v); }
+	static FORCEINLINE V set1(int x) { return _mm_set1_epi16((short)x); }
+	static FORCEINLINE V and_(V a, V b) { return _mm_and_si128(a, b); }
+	static FORCEINLINE V or_(V a, V b) { return _mm_or_si128(a, b); }
+	static FORCEINLINE V andnot(V a, V b) { return _mm_andnot_si128(a, b); }
+	static FORCEINLINE V eq(V a, V b) { return _mm_cmpeq_epi16(a, b); }
+	static FORCEINLINE V gt(V a, V b) { return _mm_cmpgt_epi16(a, b); }
+	static FORCEINLINE V add(V a, V b) { return _mm_add_epi16(a, b); }
+	static FORCEINLINE V sub(V a, V b) { return _mm_sub_epi16(a, b); }
+	static FORCEINLINE V srli(V a, int n) { return _mm_srli_epi16(a, n); }
+	static FORCEINLINE V slli(V a, int n) { return _mm_slli_epi16(a, n); }
+	static FORCEINLINE V srai(V a, int n) { return _mm_srai_epi16(a, n); }
+
+	static FORCEINLINE void store2(uint16 *p, V a, V b) {
+		store(p, _mm_unpacklo_epi16(a, b));
+		store(p + 8, _mm_unpackhi_epi16(a, b));
+	}
+
+	static FORCEINLINE void store3(uint16 *p, V a, V b, V c) {
+		// SSE2 has no word shuffle across the halves, go through memory
+		uint16 lanes[3][8];
+		store(lanes[0], a);
+		store(lanes[1], b);
+		store(lanes[2], c);
+		for (int i = 0; i < 8; ++i) {
+			p[3 * i + 0] = lanes[0][i];
+			p[3 * i + 1] = lanes[1][i];
+			p[3 * i + 2] = lanes[2][i];
+		}
+	}
+
+	static FORCEINLINE void storeTriple(uint16 *p, V v) {
+		// p0 p0 p0 p1 p1 p1 p2 p2 | p2 p3 p3 p3 p4 p4 p4 p5 | p5 p5 p6 p6 p6 p7 p7 p7
+		const V low = _mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 2));
+		const V high = _mm_shufflehi_epi16(v, _MM_SHUFFLE(1, 0, 0, 0));
+		store(p, _mm_unpacklo_epi64(_mm_shufflelo_epi16(v, _MM_SHUFFLE(1, 0, 0, 0)), _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 2, 1, 1))));
+		store(p + 8, _mm_castpd_si128(_mm_move_sd(_mm_castsi128_pd(high), _mm_castsi128_pd(low))));
+		store(p + 16, _mm_unpackhi_epi64(_mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shufflehi_epi16(v, _MM_SHUFFLE(3, 3, 3, 2))));
+	}
+
+	static FORCEINLINE void storeBytes(uint8 *p, V v) {
+		_mm_storel_epi64((__m128i *)p, _mm_packus_epi16(v, v));
+	}
+};
+
+#include "graphics/scaler/simd_impl.h"
+
+void getSIMDScalerProcsSSE2(SIMDScalerProcs &procs, int bitFormat) {
+	getSIMDScalerProcs<SSE2Ops>(procs, bitFormat);
+}
@@ -26,6 +26,8 @@
  * It also has modifications by the ResidualVM-team, which are covered under the GPLv2 (or later).
  */
 
+#include "common/workerpool.h"
+
 #include "graphics/tinygl/zgl.h"
 
 // glVertex
@@ -690,3 +692,13 @@ void tglEnableDirtyRects(bool enable) {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	c->_enableDirtyRectangles = enable;
 }
+
+void tglEnableTiledRendering(bool enable, int threadCount) {
+	TinyGL::GLContext *c = TinyGL::gl_get_context();
+	c->_enableTiledRendering = enable;
+	if (c->_tileThreadCount != threadCount) {
+		delete c->_tileWorkers;
+		c->_tileWorkers = nullptr;
+		c->_tileThreadCount = threadCount;
+	}
+}
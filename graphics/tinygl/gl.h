@@ -850,6 +850,9 @@ void tglTexCoordPointer(TGLint size, TGLenum type, TGLsizei stride, const TGLvoi
 void tglPolygonOffset(TGLfloat factor, TGLfloat units);
 
 void tglEnableDirtyRects(bool enable);
+// Replay the draw calls of a frame in bands on several threads, when available.
+// threadCount 0 uses one thread per CPU. Toggle this between frames only.
+void tglEnableTiledRendering(bool enable, int threadCount = 0);
 
 void tglDebug(int mode);
 
@@ -234,8 +234,12 @@ void glInit(void *zbuffer1, int textureSize) {
 	c->_drawCallAllocator[0].initialize(kDrawCallMemory);
 	c->_drawCallAllocator[1].initialize(kDrawCallMemory);
 	c->_enableDirtyRectangles = true;
+	c->_enableTiledRendering = false;
+	c->_isTileContext = false;
+	c->_tileThreadCount = 0;
+	c->_tileWorkers = nullptr;
 
-	Graphics::Internal::tglBlitResetScissorRect();
+	Graphics::Internal::tglBlitResetScissorRect(c);
 }
 
 void glClose() {
@@ -243,6 +247,7 @@ void glClose() {
 
 	tglDisposeDrawCallLists(c);
 	tglDisposeResources(c);
+	tglDisposeTileContexts(c);
 
 	specbuf_cleanup(c);
 	for (int i = 0; i < 3; i++)
@@ -177,9 +177,7 @@ public:
 
 	// Blits an image to the z buffer.
 	// The function only supports clipped blitting without any type of transformation or tinting.
-	void tglBlitZBuffer(int dstX, int dstY) {
-		TinyGL::GLContext *c = TinyGL::gl_get_context();
-
+	void tglBlitZBuffer(TinyGL::GLContext *c, int dstX, int dstY) {
 		int clampWidth, clampHeight;
 		int width = _surface.w, height = _surface.h;
 		int srcWidth = 0, srcHeight = 0;
@@ -201,41 +199,41 @@ public:
 	}
 
 	template <bool kDisableColoring, bool kDisableBlending, bool kEnableAlphaBlending>
-	FORCEINLINE void tglBlitRLE(int dstX, int dstY, int srcX, int srcY, int srcWidth, int srcHeight, float aTint, float rTint, float gTint, float bTint);
+	FORCEINLINE void tglBlitRLE(TinyGL::GLContext *c, int dstX, int dstY, int srcX, int srcY, int srcWidth, int srcHeight, float aTint, float rTint, float gTint, float bTint);
 
 	template <bool kDisableBlending, bool kDisableColoring, bool kFlipVertical, bool kFlipHorizontal>
-	FORCEINLINE void tglBlitSimple(int dstX, int dstY, int srcX, int srcY, int srcWidth, int srcHeight, float aTint, float rTint, float gTint, float bTint);
+	FORCEINLINE void tglBlitSimple(TinyGL::GLContext *c, int dstX, int dstY, int srcX, int srcY, int srcWidth, int srcHeight, float aTint, float rTint, float gTint, float bTint);
 
 	template <bool kDisableBlending, bool kDisableColoring, bool kFlipVertical, bool kFlipHorizontal>
-	FORCEINLINE void tglBlitScale(int dstX, int dstY, int width, int height, int srcX, int srcY, int srcWidth, int srcHeight, float aTint, float rTint, float gTint, float bTint);
+	FORCEINLINE void tglBlitScale(TinyGL::GLContext *c, int dstX, int dstY, int width, int height, int srcX, int srcY, int srcWidth, int srcHeight, float aTint, float rTint, float gTint, float bTint);
 
 	template <bool kDisableBlending, bool kDisableColoring, bool kFlipVertical, bool kFlipHorizontal>
-	FORCEINLINE void tglBlitRotoScale(int dstX, int dstY, int width, int height, int srcX, int srcY, int srcWidth, int srcHeight, int rotation,
+	FORCEINLINE void tglBlitRotoScale(TinyGL::GLContext *c, int dstX, int dstY, int width, int height, int srcX, int srcY, int srcWidth, int srcHeight, int rotation,
 		int originX, int originY, float aTint, float rTint, float gTint, float bTint);
 
 	//Utility function that calls the correct blitting function.
 	template <bool kDisableBlending, bool kDisableColoring, bool kDisableTransform, bool kFlipVertical, bool kFlipHorizontal, bool kEnableAlphaBlending>
-	FORCEINLINE void tglBlitGeneric(const BlitTransform &transform) {
+	FORCEINLINE void tglBlitGeneric(TinyGL::GLContext *c, const BlitTransform &transform) {
 		if (kDisableTransform) {
 			if ((kDisableBlending || kEnableAlphaBlending) && kFlipVertical == false && kFlipHorizontal == false) {
-				tglBlitRLE<kDisableColoring, kDisableBlending, kEnableAlphaBlending>(transform._destinationRectangle.left,
+				tglBlitRLE<kDisableColoring, kDisableBlending, kEnableAlphaBlending>(c, transform._destinationRectangle.left,
 					transform._destinationRectangle.top, transform._sourceRectangle.left, transform._sourceRectangle.top, 
 					transform._sourceRectangle.width() , transform._sourceRectangle.height(), transform._aTint,
 					transform._rTint, transform._gTint, transform._bTint);
 			} else {
-				tglBlitSimple<kDisableBlending, kDisableColoring, kFlipVertical, kFlipHorizontal>(transform._destinationRectangle.left, 
+				tglBlitSimple<kDisableBlending, kDisableColoring, kFlipVertical, kFlipHorizontal>(c, transform._destinationRectangle.left, 
 					transform._destinationRectangle.top, transform._sourceRectangle.left, transform._sourceRectangle.top, 
 					transform._sourceRectangle.width() , transform._sourceRectangle.height(),
 					transform._aTint, transform._rTint, transform._gTint, transform._bTint);
 			}
 		} else {
 			if (transform._rotation == 0) {
-				tglBlitScale<kDisableBlending, kDisableColoring, kFlipVertical, kFlipHorizontal>(transform._destinationRectangle.left,
+				tglBlitScale<kDisableBlending, kDisableColoring, kFlipVertical, kFlipHorizontal>(c, transform._destinationRectangle.left,
 					transform._destinationRectangle.top, transform._destinationRectangle.width(), transform._destinationRectangle.height(),
 					transform._sourceRectangle.left, transform._sourceRectangle.top, transform._sourceRectangle.width(), transform._sourceRectangle.height(),
 					transform._aTint, transform._rTint, transform._gTint, transform._bTint);
 			} else {
-				tglBlitRotoScale<kDisableBlending, kDisableColoring, kFlipVertical, kFlipHorizontal>(transform._destinationRectangle.left,
+				tglBlitRotoScale<kDisableBlending, kDisableColoring, kFlipVertical, kFlipHorizontal>(c, transform._destinationRectangle.left,
 					transform._destinationRectangle.top, transform._destinationRectangle.width(), transform._destinationRectangle.height(),
 					transform._sourceRectangle.left, transform._sourceRectangle.top, transform._sourceRectangle.width(),
 					transform._sourceRectangle.height(), transform._rotation, transform._originX, transform._originY, transform._aTint,
@@ -294,9 +292,7 @@ void tglDeleteBlitImage(BlitImage *blitImage) {
 // This blit only supports tinting but it will fall back to simpleBlit
 // if flipping is required (or anything more complex than that, including rotationd and scaling).
 template <bool kDisableColoring, bool kDisableBlending, bool kEnableAlphaBlending>
-FORCEINLINE void BlitImage::tglBlitRLE(int dstX, int dstY, int srcX, int srcY, int srcWidth, int srcHeight, float aTint, float rTint, float gTint, float bTint) {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
-
+FORCEINLINE void BlitImage::tglBlitRLE(TinyGL::GLContext *c, int dstX, int dstY, int srcX, int srcY, int srcWidth, int srcHeight, float aTint, float rTint, float gTint, float bTint) {
 	int clampWidth, clampHeight;
 	int width = srcWidth, height = srcHeight;
 	if (clipBlitImage(c, srcX, srcY, srcWidth, srcHeight, width, height, dstX, dstY, clampWidth, clampHeight) == false)
@@ -384,9 +380,7 @@ FORCEINLINE void BlitImage::tglBlitRLE(int dstX, int dstY, int srcX, int srcY, i
 
 // This blit function is called when flipping is needed but transformation isn't.
 template <bool kDisableBlending, bool kDisableColoring, bool kFlipVertical, bool kFlipHorizontal>
-FORCEINLINE void BlitImage::tglBlitSimple(int dstX, int dstY, int srcX, int srcY, int srcWidth, int srcHeight, float aTint, float rTint, float gTint, float bTint) {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
-
+FORCEINLINE void BlitImage::tglBlitSimple(TinyGL::GLContext *c, int dstX, int dstY, int srcX, int srcY, int srcWidth, int srcHeight, float aTint, float rTint, float gTint, float bTint) {
 	int clampWidth, clampHeight;
 	int width = srcWidth, height = srcHeight;
 	if (clipBlitImage(c, srcX, srcY, srcWidth, srcHeight, width, height, dstX, dstY, clampWidth, clampHeight) == false)
@@ -437,10 +431,8 @@ FORCEINLINE void BlitImage::tglBlitSimple(int dstX, int dstY, int srcX, int srcY
 // This function is called when scale is needed: it uses a simple nearest
 // filter to scale the blit image before copying it to the screen.
 template <bool kDisableBlending, bool kDisableColoring, bool kFlipVertical, bool kFlipHorizontal>
-FORCEINLINE void BlitImage::tglBlitScale(int dstX, int dstY, int width, int height, int srcX, int srcY, int srcWidth, int srcHeight,
+FORCEINLINE void BlitImage::tglBlitScale(TinyGL::GLContext *c, int dstX, int dstY, int width, int height, int srcX, int srcY, int srcWidth, int srcHeight,
 					 float aTint, float rTint, float gTint, float bTint) {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
-
 	int clampWidth, clampHeight;
 	if (clipBlitImage(c, srcX, srcY, srcWidth, srcHeight, width, height, dstX, dstY, clampWidth, clampHeight) == false)
 		return;
@@ -526,10 +518,8 @@ systems.
 */
 
 template <bool kDisableBlending, bool kDisableColoring, bool kFlipVertical, bool kFlipHorizontal>
-FORCEINLINE void BlitImage::tglBlitRotoScale(int dstX, int dstY, int width, int height, int srcX, int srcY, int srcWidth, int srcHeight, int rotation,
+FORCEINLINE void BlitImage::tglBlitRotoScale(TinyGL::GLContext *c, int dstX, int dstY, int width, int height, int srcX, int srcY, int srcWidth, int srcHeight, int rotation,
 							 int originX, int originY, float aTint, float rTint, float gTint, float bTint) {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
-	
 	int clampWidth, clampHeight;
 	if (clipBlitImage(c, srcX, srcY, srcWidth, srcHeight, width, height, dstX, dstY, clampWidth, clampHeight) == false)
 		return;
@@ -637,78 +627,77 @@ void tglBlitZBuffer(BlitImage *blitImage, int x, int y) {
 namespace Internal {
 
 template <bool kEnableAlphaBlending, bool kDisableColor, bool kDisableTransform, bool kDisableBlend>
-void tglBlit(BlitImage *blitImage, const BlitTransform &transform) {
+void tglBlit(TinyGL::GLContext *c, BlitImage *blitImage, const BlitTransform &transform) {
 	if (transform._flipHorizontally) {
 		if (transform._flipVertically) {
-			blitImage->tglBlitGeneric<kDisableBlend, kDisableColor, kDisableTransform, true, true, kEnableAlphaBlending>(transform);
+			blitImage->tglBlitGeneric<kDisableBlend, kDisableColor, kDisableTransform, true, true, kEnableAlphaBlending>(c, transform);
 		} else {
-			blitImage->tglBlitGeneric<kDisableBlend, kDisableColor, kDisableTransform, false, true, kEnableAlphaBlending>(transform);
+			blitImage->tglBlitGeneric<kDisableBlend, kDisableColor, kDisableTransform, false, true, kEnableAlphaBlending>(c, transform);
 		}
 	} else if (transform._flipVertically) {
-		blitImage->tglBlitGeneric<kDisableBlend, kDisableColor, kDisableTransform, true, false, kEnableAlphaBlending>(transform);
+		blitImage->tglBlitGeneric<kDisableBlend, kDisableColor, kDisableTransform, true, false, kEnableAlphaBlending>(c, transform);
 	} else {
-		blitImage->tglBlitGeneric<kDisableBlend, kDisableColor, kDisableTransform, false, false, kEnableAlphaBlending>(transform);
+		blitImage->tglBlitGeneric<kDisableBlend, kDisableColor, kDisableTransform, false, false, kEnableAlphaBlending>(c, transform);
 	}
 }
 
 template <bool kEnableAlphaBlending, bool kDisableColor, bool kDisableTransform>
-void tglBlit(BlitImage *blitImage, const BlitTransform &transform, bool disableBlend) {
+void tglBlit(TinyGL::GLContext *c, BlitImage *blitImage, const BlitTransform &transform, bool disableBlend) {
 	if (disableBlend) {
-		tglBlit<kEnableAlphaBlending, kDisableColor, kDisableTransform, true>(blitImage, transform);
+		tglBlit<kEnableAlphaBlending, kDisableColor, kDisableTransform, true>(c, blitImage, transform);
 	} else {
-		tglBlit<kEnableAlphaBlending, kDisableColor, kDisableTransform, false>(blitImage, transform);
+		tglBlit<kEnableAlphaBlending, kDisableColor, kDisableTransform, false>(c, blitImage, transform);
 	}
 }
 
 template <bool kEnableAlphaBlending, bool kDisableColor>
-void tglBlit(BlitImage *blitImage, const BlitTransform &transform, bool disableTransform, bool disableBlend) {
+void tglBlit(TinyGL::GLContext *c, BlitImage *blitImage, const BlitTransform &transform, bool disableTransform, bool disableBlend) {
 	if (disableTransform) {
-		tglBlit<kEnableAlphaBlending, kDisableColor, true>(blitImage, transform, disableBlend);
+		tglBlit<kEnableAlphaBlending, kDisableColor, true>(c, blitImage, transform, disableBlend);
 	} else {
-		tglBlit<kEnableAlphaBlending, kDisableColor, false>(blitImage, transform, disableBlend);
+		tglBlit<kEnableAlphaBlending, kDisableColor, false>(c, blitImage, transform, disableBlend);
 	}
 }
 
 template <bool kEnableAlphaBlending>
-void tglBlit(BlitImage *blitImage, const BlitTransform &transform, bool disableColor, bool disableTransform, bool disableBlend) {
+void tglBlit(TinyGL::GLContext *c, BlitImage *blitImage, const BlitTransform &transform, bool disableColor, bool disableTransform, bool disableBlend) {
 	if (disableColor) {
-		tglBlit<kEnableAlphaBlending, true>(blitImage, transform, disableTransform, disableBlend);
+		tglBlit<kEnableAlphaBlending, true>(c, blitImage, transform, disableTransform, disableBlend);
 	} else {
-		tglBlit<kEnableAlphaBlending, false>(blitImage, transform, disableTransform, disableBlend);
+		tglBlit<kEnableAlphaBlending, false>(c, blitImage, transform, disableTransform, disableBlend);
 	}
 }
 
-void tglBlit(BlitImage *blitImage, const BlitTransform &transform) {
-	TinyGL::GLContext *c =TinyGL::gl_get_context();
+void tglBlit(TinyGL::GLContext *c, BlitImage *blitImage, const BlitTransform &transform) {
 	bool disableColor = transform._aTint == 1.0f && transform._bTint == 1.0f && transform._gTint == 1.0f && transform._rTint == 1.0f;
 	bool disableTransform = transform._destinationRectangle.width() == 0 && transform._destinationRectangle.height() == 0 && transform._rotation == 0;
 	bool disableBlend = c->fb->isBlendingEnabled() == false;
 	bool enableAlphaBlending = c->fb->isAlphaBlendingEnabled();
 
 	if (enableAlphaBlending) {
-		tglBlit<true>(blitImage, transform, disableColor, disableTransform, disableBlend);
+		tglBlit<true>(c, blitImage, transform, disableColor, disableTransform, disableBlend);
 	} else {
-		tglBlit<false>(blitImage, transform, disableColor, disableTransform, disableBlend);
+		tglBlit<false>(c, blitImage, transform, disableColor, disableTransform, disableBlend);
 	}
 }
 
-void tglBlitNoBlend(BlitImage *blitImage, const BlitTransform &transform) {
+void tglBlitNoBlend(TinyGL::GLContext *c, BlitImage *blitImage, const BlitTransform &transform) {
 	if (transform._flipHorizontally == false && transform._flipVertically == false) {
-		blitImage->tglBlitGeneric<true, false, false, false, false, false>(transform);
+		blitImage->tglBlitGeneric<true, false, false, false, false, false>(c, transform);
 	} else if(transform._flipHorizontally == false) {
-		blitImage->tglBlitGeneric<true, false, false, true, false, false>(transform);
+		blitImage->tglBlitGeneric<true, false, false, true, false, false>(c, transform);
 	} else {
-		blitImage->tglBlitGeneric<true, false, false, false, true, false>(transform);
+		blitImage->tglBlitGeneric<true, false, false, false, true, false>(c, transform);
 	}
 }
 
-void tglBlitFast(BlitImage *blitImage, int x, int y) {
+void tglBlitFast(TinyGL::GLContext *c, BlitImage *blitImage, int x, int y) {
 	BlitTransform transform(x, y);
-	blitImage->tglBlitGeneric<true, true, true, false, false, false>(transform);
+	blitImage->tglBlitGeneric<true, true, true, false, false, false>(c, transform);
 }
 
-void tglBlitZBuffer(BlitImage *blitImage, int x, int y) {
-	blitImage->tglBlitZBuffer(x, y);
+void tglBlitZBuffer(TinyGL::GLContext *c, BlitImage *blitImage, int x, int y) {
+	blitImage->tglBlitZBuffer(c, x, y);
 }
 
 void tglCleanupImages() {
@@ -724,12 +713,11 @@ void tglCleanupImages() {
 	}
 }
 
-void tglBlitSetScissorRect(const Common::Rect &rect) {
-	TinyGL::gl_get_context()->_scissorRect = rect;
+void tglBlitSetScissorRect(TinyGL::GLContext *c, const Common::Rect &rect) {
+	c->_scissorRect = rect;
 }
 
-void tglBlitResetScissorRect(void) {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+void tglBlitResetScissorRect(TinyGL::GLContext *c) {
 	c->_scissorRect = c->renderRect;
 }
 
@@ -29,6 +29,7 @@
 // Z buffer: 16,32 bits Z / 16 bits color
 
 #include "common/scummsys.h"
+#include "common/cpudetect.h"
 #include "common/endian.h"
 
 #include "graphics/tinygl/zbuffer.h"
@@ -80,7 +81,7 @@ void memset_l(void *adr, int val, int count) {
 		*p++ = val;
 }
 
-FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &frame_buffer) : _depthWrite(true), _enableScissor(false) {
+FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &frame_buffer) : _isView(false), _depthWrite(true), _enableScissor(false) {
 	this->xsize = width;
 	this->ysize = height;
 	this->cmode = frame_buffer.getFormat();
@@ -104,9 +105,10 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &fra
 	_alphaTestEnabled = false;
 	_depthTestEnabled = false;
 	_depthFunc = TGL_LESS;
+	_drawSpan = getSpanProc(cmode);
 }
 
-FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &format) : _depthWrite(true), _enableScissor(false) {
+FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &format) : _isView(false), _depthWrite(true), _enableScissor(false) {
 	this->xsize = width;
 	this->ysize = height;
 	this->cmode = format;
@@ -131,9 +133,58 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_alphaTestEnabled = false;
 	_depthTestEnabled = false;
 	_depthFunc = TGL_LESS;
+	_drawSpan = getSpanProc(cmode);
+}
+
+FrameBuffer::FrameBuffer(const FrameBuffer *parent) {
+	syncView(parent);
+}
+
+void FrameBuffer::syncView(const FrameBuffer *parent) {
+	*this = *parent;
+	frame_buffer_allocated = 0;
+	_isView = true;
+}
+
+bool FrameBuffer::getSpanState(ZSpanState &state, bool colorWrite, bool alphaTest, bool blending, bool depthWrite) const {
+	if (!_drawSpan)
+		return false;
+	if (blending && !isAlphaBlendingEnabled())
+		return false;
+
+	state.depthFunc = _depthTestEnabled ? _depthFunc : TGL_ALWAYS;
+	state.alphaFunc = alphaTest ? _alphaTestFunc : TGL_ALWAYS;
+	state.alphaRef = _alphaTestRefVal;
+	state.depthWrite = depthWrite;
+	state.colorWrite = colorWrite;
+	state.blending = blending;
+	state.aShift = cmode.aShift;
+	state.rShift = cmode.rShift;
+	state.gShift = cmode.gShift;
+	state.bShift = cmode.bShift;
+	state.aMask = cmode.aLoss == 0 ? 0xFFu << cmode.aShift : 0;
+	return true;
+}
+
+ZSpanProc getSpanProc(const Graphics::PixelFormat &format) {
+	// The kernels only deal with 8 bits per channel and an optional alpha channel
+	if (format.bytesPerPixel != 4 || format.rLoss || format.gLoss || format.bLoss || (format.aLoss != 0 && format.aLoss != 8))
+		return nullptr;
+
+#ifdef SCUMMVM_AVX2
+	if (Common::hasCpuFeature(Common::kCpuFeatureAVX2))
+		return drawSpanAVX2;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (Common::hasCpuFeature(Common::kCpuFeatureSSE2))
+		return drawSpanSSE2;
+#endif
+	return nullptr;
 }
 
 FrameBuffer::~FrameBuffer() {
+	if (_isView)
+		return;
 	if (frame_buffer_allocated)
 		pbuf.free();
 	gl_free(_zbuf);
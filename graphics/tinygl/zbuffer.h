@@ -32,6 +32,7 @@
 #include "graphics/pixelbuffer.h"
 #include "graphics/tinygl/texelbuffer.h"
 #include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
 #include "common/rect.h"
 
 namespace TinyGL {
@@ -103,8 +104,13 @@ struct ZBufferPoint {
 struct FrameBuffer {
 	FrameBuffer(int xsize, int ysize, const Graphics::PixelBuffer &frame_buffer);
 	FrameBuffer(int xsize, int ysize, const Graphics::PixelFormat &format);
+	// A view draws to the pixel and z buffers of its parent, but keeps its own state.
+	explicit FrameBuffer(const FrameBuffer *parent);
 	~FrameBuffer();
 
+	// Copies the parent state and buffers into a view.
+	void syncView(const FrameBuffer *parent);
+
 	Buffer *genOffscreenBuffer();
 	void delOffscreenBuffer(Buffer *buffer);
 	void clear(int clear_z, int z, int clear_color, int r, int g, int b);
@@ -515,7 +521,11 @@ private:
 	template <bool kInterpRGB, bool kInterpZ, bool kDepthWrite, bool kEnableScissor>
 	void drawLine(const ZBufferPoint *p1, const ZBufferPoint *p2);
 
+	// Fills in the state of the SIMD span kernel, returns false if the scalar code has to be used
+	bool getSpanState(ZSpanState &state, bool colorWrite, bool alphaTest, bool blending, bool depthWrite) const;
+
 	unsigned int *_zbuf;
+	bool _isView;
 	bool _depthWrite;
 	Graphics::PixelBuffer pbuf;
 	bool _blendingEnabled;
@@ -526,6 +536,7 @@ private:
 	int _alphaTestFunc;
 	int _alphaTestRefVal;
 	int _depthFunc;
+	ZSpanProc _drawSpan;
 };
 
 // memory.c
@@ -31,6 +31,7 @@
 #include "graphics/tinygl/gl.h"
 #include "common/debug.h"
 #include "common/math.h"
+#include "common/workerpool.h"
 
 namespace TinyGL {
 
@@ -113,6 +114,157 @@ void tglDisposeDrawCallLists(TinyGL::GLContext *c) {
 	c->_drawCallsQueue.clear();
 }
 
+// Bands lower than this are not worth the per draw call overhead.
+static const int kMinTileHeight = 16;
+
+void tglDisposeTileContexts(GLContext *c) {
+	for (uint i = 0; i < c->_tileContexts.size(); i++) {
+		GLContext *tile = c->_tileContexts[i];
+		delete tile->fb;
+		gl_free(tile->vertex);
+		delete tile;
+	}
+	c->_tileContexts.clear();
+
+	delete c->_tileWorkers;
+	c->_tileWorkers = nullptr;
+}
+
+// Copies the state that draw calls rely on without capturing it themselves.
+static void tglSyncTileContext(GLContext *tile, const GLContext *c) {
+	if (!tile->fb)
+		tile->fb = new FrameBuffer(c->fb);
+	else
+		tile->fb->syncView(c->fb);
+
+	tile->renderRect = c->renderRect;
+	tile->_textureSize = c->_textureSize;
+	tile->viewport = c->viewport;
+	tile->current_cull_face = c->current_cull_face;
+	tile->render_mode = c->render_mode;
+	tile->vertex_n = c->vertex_n;
+	tile->_scissorRect = c->_scissorRect;
+	tile->_enableDirtyRectangles = c->_enableDirtyRectangles;
+
+	// State restored after each draw call, so it has to be initialized
+	tile->lighting_enabled = c->lighting_enabled;
+	tile->cull_face_enabled = c->cull_face_enabled;
+	tile->begin_type = c->begin_type;
+	tile->color_mask = c->color_mask;
+	tile->current_front_face = c->current_front_face;
+	tile->current_shade_model = c->current_shade_model;
+	tile->depth_test = c->depth_test;
+	tile->polygon_mode_back = c->polygon_mode_back;
+	tile->polygon_mode_front = c->polygon_mode_front;
+	tile->shadow_mode = c->shadow_mode;
+	tile->texture_2d_enabled = c->texture_2d_enabled;
+	tile->current_texture = c->current_texture;
+	tile->texture_wrap_s = c->texture_wrap_s;
+	tile->texture_wrap_t = c->texture_wrap_t;
+	tile->draw_triangle_front = c->draw_triangle_front;
+	tile->draw_triangle_back = c->draw_triangle_back;
+}
+
+// Returns the number of bands to split the frame into, or 0 to draw it on the calling thread.
+static uint tglPrepareTiles(GLContext *c) {
+	if (!c->_enableTiledRendering || c->render_mode == TGL_SELECT)
+		return 0;
+
+	if (!c->_tileWorkers)
+		c->_tileWorkers = new Common::WorkerPool(c->_tileThreadCount);
+	const uint threads = c->_tileWorkers->getThreadCount();
+	if (threads <= 1)
+		return 0;
+
+	// A few bands per thread even out unevenly loaded parts of the screen
+	const uint tileCount = MIN<uint>(threads * 4, c->renderRect.height() / kMinTileHeight);
+	if (tileCount <= 1)
+		return 0;
+
+	while (c->_tileContexts.size() < tileCount) {
+		GLContext *tile = new GLContext();
+		tile->_isTileContext = true;
+		tile->vertex_max = POLYGON_MAX_VERTEX;
+		tile->vertex = (GLVertex *)gl_malloc(POLYGON_MAX_VERTEX * sizeof(GLVertex));
+		c->_tileContexts.push_back(tile);
+	}
+	for (uint i = 0; i < tileCount; i++)
+		tglSyncTileContext(c->_tileContexts[i], c);
+
+	return tileCount;
+}
+
+struct TileJob {
+	GLContext *c;
+	const Common::Array<Graphics::DrawCall *> *drawCalls;
+	const Common::Array<Common::Rect> *regions;
+	uint firstCall, lastCall;
+	uint tileCount;
+};
+
+static void tglDrawTile(void *param, uint tileIndex) {
+	const TileJob &job = *(const TileJob *)param;
+	GLContext *tile = job.c->_tileContexts[tileIndex];
+	const Common::Rect &renderRect = job.c->renderRect;
+
+	const int top = renderRect.top + renderRect.height() * tileIndex / job.tileCount;
+	const int bottom = renderRect.top + renderRect.height() * (tileIndex + 1) / job.tileCount;
+	const Common::Rect band(renderRect.left, top, renderRect.right, bottom);
+
+	for (uint i = job.firstCall; i < job.lastCall; i++) {
+		const Graphics::DrawCall *drawCall = (*job.drawCalls)[i];
+		const Common::Rect drawCallRegion = drawCall->getDirtyRegion();
+		for (uint j = 0; j < job.regions->size(); j++) {
+			const Common::Rect &region = (*job.regions)[j];
+			// Same test as when drawing on a single thread, so the same pixels get drawn
+			if (!region.intersects(drawCallRegion))
+				continue;
+			Common::Rect clip = region.findIntersectingRect(band);
+			if (!clip.isEmpty())
+				drawCall->execute(tile, clip, true);
+		}
+	}
+}
+
+// Draws the queued draw calls clipped to each of the regions. Runs of draw calls
+// which can be clipped exactly are split into bands drawn in parallel, the
+// others are drawn in between on the calling thread.
+static void tglDrawCallsTiled(GLContext *c, const Common::Array<Common::Rect> &regions, uint tileCount) {
+	Common::Array<Graphics::DrawCall *> drawCalls;
+	drawCalls.reserve(c->_drawCallsQueue.size());
+	for (Common::List<Graphics::DrawCall *>::const_iterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it)
+		drawCalls.push_back(*it);
+
+	TileJob job;
+	job.c = c;
+	job.drawCalls = &drawCalls;
+	job.regions = &regions;
+	job.tileCount = tileCount;
+
+	uint first = 0;
+	while (first < drawCalls.size()) {
+		uint last = first;
+		while (last < drawCalls.size() && drawCalls[last]->isClipExact())
+			last++;
+
+		if (last > first) {
+			job.firstCall = first;
+			job.lastCall = last;
+			c->_tileWorkers->run(tglDrawTile, &job, tileCount);
+		}
+
+		if (last < drawCalls.size()) {
+			const Common::Rect drawCallRegion = drawCalls[last]->getDirtyRegion();
+			for (uint j = 0; j < regions.size(); j++) {
+				if (regions[j].intersects(drawCallRegion))
+					drawCalls[last]->execute(c, regions[j], true);
+			}
+			last++;
+		}
+		first = last;
+	}
+}
+
 static inline void _appendDirtyRectangle(const Graphics::DrawCall &call, Common::List<DirtyRectangle> &rectangles, int r, int g, int b) {
 	Common::Rect dirty_region = call.getDirtyRegion();
 	if (rectangles.empty() || dirty_region != rectangles.back().rectangle)
@@ -195,12 +347,21 @@ static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 
 	if (!rectangles.empty()) {
 		// Execute draw calls.
-		for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+		uint tileCount = tglPrepareTiles(c);
+		if (tileCount) {
+			Common::Array<Common::Rect> regions;
 			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
+				regions.push_back((*itRect).rectangle);
+			}
+			tglDrawCallsTiled(c, regions, tileCount);
+		} else {
+			for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
+				Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+				for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
+					Common::Rect dirtyRegion = (*itRect).rectangle;
+					if (dirtyRegion.intersects(drawCallRegion)) {
+						(*it)->execute(c, dirtyRegion, true);
+					}
 				}
 			}
 		}
@@ -242,8 +403,16 @@ static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 static void tglPresentBufferSimple(TinyGL::GLContext *c) {
 	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
 
+	uint tileCount = tglPrepareTiles(c);
+	if (tileCount) {
+		Common::Array<Common::Rect> regions;
+		regions.push_back(c->renderRect);
+		tglDrawCallsTiled(c, regions, tileCount);
+	}
+
 	for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
-		(*it)->execute(true);
+		if (!tileCount)
+			(*it)->execute(c, true);
 		delete *it;
 	}
 
@@ -294,8 +463,8 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	_drawTriangleFront = c->draw_triangle_front;
 	_drawTriangleBack = c->draw_triangle_back;
 	memcpy(_vertex, c->vertex, sizeof(TinyGL::GLVertex) * _vertexCount);
-	_state = captureState();
-	if (c->_enableDirtyRectangles) {
+	_state = captureState(c);
+	if (c->_enableDirtyRectangles || c->_enableTiledRendering) {
 		computeDirtyRegion();
 	}
 }
@@ -333,19 +502,29 @@ void RasterizationDrawCall::computeDirtyRegion() {
 	}
 }
 
-void RasterizationDrawCall::execute(bool restoreState) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
-
+void RasterizationDrawCall::execute(TinyGL::GLContext *c, bool restoreState) const {
 	RasterizationDrawCall::RasterizationState backupState;
 	if (restoreState) {
-		backupState = captureState();
+		backupState = captureState(c);
 	}
-	applyState(_state);
+	applyState(c, _state);
 
 	TinyGL::GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
 
-	c->vertex = _vertex;
+	if (c->_isTileContext) {
+		// Drawing modifies the vertices and other tiles draw the same call
+		// at the same time, so draw from a private copy.
+		if (_vertexCount > c->vertex_max) {
+			TinyGL::gl_free(c->vertex);
+			c->vertex_max = _vertexCount;
+			c->vertex = (TinyGL::GLVertex *)TinyGL::gl_malloc(c->vertex_max * sizeof(TinyGL::GLVertex));
+			prevVertex = c->vertex;
+		}
+		memcpy(c->vertex, _vertex, _vertexCount * sizeof(TinyGL::GLVertex));
+	} else {
+		c->vertex = _vertex;
+	}
 	c->vertex_cnt = _vertexCount;
 	c->draw_triangle_front = (TinyGL::gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (TinyGL::gl_draw_triangle_func)_drawTriangleBack;
@@ -429,13 +608,12 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	c->vertex_cnt = prevVertexCount;
 
 	if (restoreState) {
-		applyState(backupState);
+		applyState(c, backupState);
 	}
 }
 
-RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState() const {
+RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState(TinyGL::GLContext *c) const {
 	RasterizationState state;
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	state.alphaTest = c->fb->isAlphaTestEnabled();
 	c->fb->getBlendingFactors(state.sfactor, state.dfactor);
 	state.enableBlending = c->fb->isBlendingEnabled();
@@ -469,8 +647,7 @@ RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState()
 	return state;
 }
 
-void RasterizationDrawCall::applyState(const RasterizationDrawCall::RasterizationState &state) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+void RasterizationDrawCall::applyState(TinyGL::GLContext *c, const RasterizationDrawCall::RasterizationState &state) const {
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->enableAlphaTest(state.alphaTest);
@@ -499,10 +676,9 @@ void RasterizationDrawCall::applyState(const RasterizationDrawCall::Rasterizatio
 	memcpy(c->viewport.trans._v, state.viewportTranslation, sizeof(c->viewport.trans._v));
 }
 
-void RasterizationDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+void RasterizationDrawCall::execute(TinyGL::GLContext *c, const Common::Rect &clippingRectangle, bool restoreState) const {
 	c->fb->setScissorRectangle(clippingRectangle);
-	execute(restoreState);
+	execute(c, restoreState);
 	c->fb->resetScissorRectangle();
 }
 
@@ -522,10 +698,11 @@ bool RasterizationDrawCall::operator==(const RasterizationDrawCall &other) const
 }
 
 BlittingDrawCall::BlittingDrawCall(Graphics::BlitImage *image, const BlitTransform &transform, BlittingMode blittingMode) : DrawCall(DrawCall_Blitting), _transform(transform), _mode(blittingMode), _image(image) {
+	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	tglIncBlitImageRef(image);
-	_blitState = captureState();
+	_blitState = captureState(c);
 	_imageVersion = tglGetBlitImageVersion(image);
-	if (TinyGL::gl_get_context()->_enableDirtyRectangles) {
+	if (c->_enableDirtyRectangles || c->_enableTiledRendering) {
 		computeDirtyRegion();
 	}
 }
@@ -534,43 +711,62 @@ BlittingDrawCall::~BlittingDrawCall() {
 	tglDeleteBlitImage(_image);
 }
 
-void BlittingDrawCall::execute(bool restoreState) const {
+void BlittingDrawCall::execute(TinyGL::GLContext *c, bool restoreState) const {
 	BlittingState backupState;
 	if (restoreState) {
-		backupState = captureState();
+		backupState = captureState(c);
 	}
-	applyState(_blitState);
+	applyState(c, _blitState);
 
 	switch (_mode) {
 	case Graphics::BlittingDrawCall::BlitMode_Regular:
-		Graphics::Internal::tglBlit(_image, _transform);
+		Graphics::Internal::tglBlit(c, _image, _transform);
 		break;
 	case Graphics::BlittingDrawCall::BlitMode_NoBlend:
-		Graphics::Internal::tglBlitNoBlend(_image, _transform);
+		Graphics::Internal::tglBlitNoBlend(c, _image, _transform);
 		break;
 	case Graphics::BlittingDrawCall::BlitMode_Fast:
-		Graphics::Internal::tglBlitFast(_image, _transform._destinationRectangle.left, _transform._destinationRectangle.top);
+		Graphics::Internal::tglBlitFast(c, _image, _transform._destinationRectangle.left, _transform._destinationRectangle.top);
 		break;
 	case Graphics::BlittingDrawCall::BlitMode_ZBuffer:
-		Graphics::Internal::tglBlitZBuffer(_image, _transform._destinationRectangle.left, _transform._destinationRectangle.top);
+		Graphics::Internal::tglBlitZBuffer(c, _image, _transform._destinationRectangle.left, _transform._destinationRectangle.top);
 		break;
 	default:
 		break;
 	}
 	if (restoreState) {
-		applyState(backupState);
+		applyState(c, backupState);
 	}
 }
 
-void BlittingDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
-	Graphics::Internal::tglBlitSetScissorRect(clippingRectangle);
-	execute(restoreState);
-	Graphics::Internal::tglBlitResetScissorRect();
+void BlittingDrawCall::execute(TinyGL::GLContext *c, const Common::Rect &clippingRectangle, bool restoreState) const {
+	Graphics::Internal::tglBlitSetScissorRect(c, clippingRectangle);
+	execute(c, restoreState);
+	Graphics::Internal::tglBlitResetScissorRect(c);
 }
 
-BlittingDrawCall::BlittingState BlittingDrawCall::captureState() const {
+bool BlittingDrawCall::isClipExact() const {
+	// Scaled, rotated and flipped blits compute their source coordinates
+	// from the clipped destination, so splitting them shifts the image.
+	if (_mode == BlitMode_Fast || _mode == BlitMode_ZBuffer)
+		return true;
+	if (_transform._rotation != 0 || _transform._flipHorizontally || _transform._flipVertically)
+		return false;
+
+	int width = _transform._destinationRectangle.width();
+	int height = _transform._destinationRectangle.height();
+	if (width == 0 && height == 0)
+		return true;
+
+	int sourceWidth = _transform._sourceRectangle.width();
+	int sourceHeight = _transform._sourceRectangle.height();
+	if (sourceWidth == 0 || sourceHeight == 0)
+		tglGetBlitImageSize(_image, sourceWidth, sourceHeight);
+	return width == sourceWidth && height == sourceHeight;
+}
+
+BlittingDrawCall::BlittingState BlittingDrawCall::captureState(TinyGL::GLContext *c) const {
 	BlittingState state;
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	state.alphaTest = c->fb->isAlphaTestEnabled();
 	c->fb->getBlendingFactors(state.sfactor, state.dfactor);
 	state.enableBlending = c->fb->isBlendingEnabled();
@@ -580,8 +776,7 @@ BlittingDrawCall::BlittingState BlittingDrawCall::captureState() const {
 	return state;
 }
 
-void BlittingDrawCall::applyState(const BlittingState &state) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+void BlittingDrawCall::applyState(TinyGL::GLContext *c, const BlittingState &state) const {
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->enableAlphaTest(state.alphaTest);
@@ -630,18 +825,16 @@ bool BlittingDrawCall::operator==(const BlittingDrawCall &other) const {
 ClearBufferDrawCall::ClearBufferDrawCall(bool clearZBuffer, int zValue, bool clearColorBuffer, int rValue, int gValue, int bValue) 
 	: _clearZBuffer(clearZBuffer), _clearColorBuffer(clearColorBuffer), _zValue(zValue), _rValue(rValue), _gValue(gValue), _bValue(bValue), DrawCall(DrawCall_Clear) {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
-	if (c->_enableDirtyRectangles) {
+	if (c->_enableDirtyRectangles || c->_enableTiledRendering) {
 		_dirtyRegion = c->renderRect;
 	}
 }
 
-void ClearBufferDrawCall::execute(bool restoreState) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+void ClearBufferDrawCall::execute(TinyGL::GLContext *c, bool restoreState) const {
 	c->fb->clear(_clearZBuffer, _zValue, _clearColorBuffer, _rValue, _gValue, _bValue);
 }
 
-void ClearBufferDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+void ClearBufferDrawCall::execute(TinyGL::GLContext *c, const Common::Rect &clippingRectangle, bool restoreState) const {
 	Common::Rect clearRect = clippingRectangle.findIntersectingRect(getDirtyRegion());
 	c->fb->clearRegion(clearRect.left, clearRect.top, clearRect.width(), clearRect.height(), _clearZBuffer, _zValue, _clearColorBuffer, _rValue, _gValue, _bValue);
 }
@@ -42,6 +42,10 @@
 #include "graphics/tinygl/zdirtyrect.h"
 #include "graphics/tinygl/texelbuffer.h"
 
+namespace Common {
+class WorkerPool;
+}
+
 namespace TinyGL {
 
 enum {
@@ -388,6 +392,14 @@ struct GLContext {
 
 	bool _enableDirtyRectangles;
 
+	// Tiled rendering: draw calls are replayed in horizontal bands, each
+	// on its own context and worker thread.
+	bool _enableTiledRendering;
+	bool _isTileContext;
+	int _tileThreadCount;
+	Common::WorkerPool *_tileWorkers;
+	Common::Array<GLContext *> _tileContexts;
+
 	// blit test
 	Common::List<Graphics::BlitImage *> _blitImages;
 
@@ -438,6 +450,7 @@ void tglIssueDrawCall(Graphics::DrawCall *drawCall);
 // zdirtyrect.cpp
 void tglDisposeResources(GLContext *c);
 void tglDisposeDrawCallLists(TinyGL::GLContext *c);
+void tglDisposeTileContexts(GLContext *c);
 
 GLContext *gl_get_context();
 
@@ -0,0 +1,86 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_TINYGL_ZSPAN_H_
+#define GRAPHICS_TINYGL_ZSPAN_H_
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+struct PixelFormat;
+}
+
+namespace TinyGL {
+
+/**
+ * Per triangle state of the SIMD span kernels. Only the states which the
+ * kernels handle can be expressed here: everything else is drawn by the
+ * scalar templates of ztriangle.cpp, which stay the reference.
+ */
+struct ZSpanState {
+	int depthFunc;     // TGL_ALWAYS when depth testing is disabled
+	int alphaFunc;     // TGL_ALWAYS when alpha testing is disabled
+	int alphaRef;
+	bool depthWrite;
+	bool colorWrite;   // false when drawing to the depth buffer only
+	bool blending;     // TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA blending
+
+	// Layout of the 32 bits per pixel frame buffer
+	int aShift, rShift, gShift, bShift;
+	uint32 aMask;      // 0 when the frame buffer has no alpha channel
+};
+
+/**
+ * One scan line of a triangle. Colors and depth use the fixed point
+ * formats of ZBufferPoint and are stepped once per pixel, exactly like
+ * the scalar code does.
+ */
+struct ZSpan {
+	uint32 *pixels;
+	unsigned int *zbuf;
+	const byte *mask;      // Pixels are only drawn where the shadow mask is set, unless nullptr
+	const uint32 *texels;  // 0xAARRGGBB texture colors modulated by the color, unless nullptr
+	int x, count;
+	int clipLeft, clipRight;
+	unsigned int z, r, g, b, a;
+	int dzdx, drdx, dgdx, dbdx, dadx;
+};
+
+typedef void (*ZSpanProc)(const ZSpanState &state, const ZSpan &span);
+
+#ifdef SCUMMVM_SSE2
+void drawSpanSSE2(const ZSpanState &state, const ZSpan &span);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void drawSpanAVX2(const ZSpanState &state, const ZSpan &span);
+#endif
+
+/**
+ * Return the fastest span kernel supported by the host CPU for frame
+ * buffers of the given format, or nullptr if the scalar code has to be used.
+ */
+ZSpanProc getSpanProc(const Graphics::PixelFormat &format);
+
+} // end of namespace TinyGL
+
+#endif
@@ -0,0 +1,199 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/util.h"
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <immintrin.h>
+
+namespace TinyGL {
+
+/** Lanes where "a func b" holds, for the functions of glDepthFunc() and glAlphaFunc(). */
+static FORCEINLINE __m256i testLanes(int func, __m256i a, __m256i b) {
+	const __m256i ones = _mm256_set1_epi32(-1);
+	switch (func) {
+	case TGL_LESS:
+		return _mm256_cmpgt_epi32(b, a);
+	case TGL_EQUAL:
+		return _mm256_cmpeq_epi32(a, b);
+	case TGL_LEQUAL:
+		return _mm256_xor_si256(_mm256_cmpgt_epi32(a, b), ones);
+	case TGL_GREATER:
+		return _mm256_cmpgt_epi32(a, b);
+	case TGL_NOTEQUAL:
+		return _mm256_xor_si256(_mm256_cmpeq_epi32(a, b), ones);
+	case TGL_GEQUAL:
+		return _mm256_xor_si256(_mm256_cmpgt_epi32(b, a), ones);
+	case TGL_ALWAYS:
+		return ones;
+	default:
+		return _mm256_setzero_si256();
+	}
+}
+
+static inline __m256i rampLanes(unsigned int start, int step) {
+	const unsigned int d = (unsigned int)step;
+	return _mm256_set_epi32((int)(start + 7 * d), (int)(start + 6 * d), (int)(start + 5 * d), (int)(start + 4 * d),
+	                        (int)(start + 3 * d), (int)(start + 2 * d), (int)(start + d), (int)start);
+}
+
+/** Compute the 8 bit channel (c * (l >> 8)) >> 8, truncated like the scalar code. */
+static inline __m256i modulate(__m256i c, __m256i l) {
+	const __m256i l16 = _mm256_and_si256(_mm256_srli_epi32(l, 8), _mm256_set1_epi32(0xFFFF));
+	return _mm256_srli_epi32(_mm256_mullo_epi16(c, l16), 8);
+}
+
+static inline __m256i select(__m256i mask, __m256i a, __m256i b) {
+	return _mm256_blendv_epi8(b, a, mask);
+}
+
+/** Draw 8 pixels, pass holds the lanes inside the span and the scissor rectangle. */
+static FORCEINLINE void drawPixels8(const ZSpanState &state, uint32 *pixels, unsigned int *zbuf, const byte *mask, const uint32 *texels,
+                               __m256i pass, __m256i z, __m256i r, __m256i g, __m256i b, __m256i a) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i byteMask = _mm256_set1_epi32(0xFF);
+	const __m256i signBit = _mm256_set1_epi32((int)0x80000000);
+
+	if (mask) {
+		const __m256i m = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)mask));
+		pass = _mm256_andnot_si256(_mm256_cmpeq_epi32(m, zero), pass);
+	}
+
+	// Depth values are unsigned, flip their sign bits for the signed compares
+	const __m256i zDst = _mm256_loadu_si256((const __m256i *)zbuf);
+	pass = _mm256_and_si256(pass, testLanes(state.depthFunc, _mm256_xor_si256(zDst, signBit), _mm256_xor_si256(z, signBit)));
+	if (!_mm256_movemask_epi8(pass))
+		return;
+
+	if (!state.colorWrite) {
+		if (state.depthWrite)
+			_mm256_storeu_si256((__m256i *)zbuf, select(pass, z, zDst));
+		return;
+	}
+
+	__m256i cr, cg, cb, ca;
+	if (texels) {
+		const __m256i t = _mm256_loadu_si256((const __m256i *)texels);
+		ca = modulate(_mm256_srli_epi32(t, 24), a);
+		cr = modulate(_mm256_and_si256(_mm256_srli_epi32(t, 16), byteMask), r);
+		cg = modulate(_mm256_and_si256(_mm256_srli_epi32(t, 8), byteMask), g);
+		cb = modulate(_mm256_and_si256(t, byteMask), b);
+	} else {
+		ca = _mm256_and_si256(_mm256_srli_epi32(a, 8), byteMask);
+		cr = _mm256_and_si256(_mm256_srli_epi32(r, 8), byteMask);
+		cg = _mm256_and_si256(_mm256_srli_epi32(g, 8), byteMask);
+		cb = _mm256_and_si256(_mm256_srli_epi32(b, 8), byteMask);
+	}
+
+	pass = _mm256_and_si256(pass, testLanes(state.alphaFunc, ca, _mm256_set1_epi32(state.alphaRef)));
+	if (!_mm256_movemask_epi8(pass))
+		return;
+
+	if (state.depthWrite)
+		_mm256_storeu_si256((__m256i *)zbuf, select(pass, z, zDst));
+
+	const __m128i aShift = _mm_cvtsi32_si128(state.aShift);
+	const __m128i rShift = _mm_cvtsi32_si128(state.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(state.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(state.bShift);
+	const __m256i dst = _mm256_loadu_si256((const __m256i *)pixels);
+
+	if (state.blending) {
+		// Products of 8 bit values fit the low 16 bits of each lane
+		const __m256i ia = _mm256_sub_epi32(byteMask, ca);
+		const __m256i dr = _mm256_and_si256(_mm256_srl_epi32(dst, rShift), byteMask);
+		const __m256i dg = _mm256_and_si256(_mm256_srl_epi32(dst, gShift), byteMask);
+		const __m256i db = _mm256_and_si256(_mm256_srl_epi32(dst, bShift), byteMask);
+		cr = _mm256_add_epi32(_mm256_srli_epi32(_mm256_mullo_epi16(cr, ca), 8), _mm256_srli_epi32(_mm256_mullo_epi16(dr, ia), 8));
+		cg = _mm256_add_epi32(_mm256_srli_epi32(_mm256_mullo_epi16(cg, ca), 8), _mm256_srli_epi32(_mm256_mullo_epi16(dg, ia), 8));
+		cb = _mm256_add_epi32(_mm256_srli_epi32(_mm256_mullo_epi16(cb, ca), 8), _mm256_srli_epi32(_mm256_mullo_epi16(db, ia), 8));
+		cr = _mm256_min_epi16(cr, byteMask);
+		cg = _mm256_min_epi16(cg, byteMask);
+		cb = _mm256_min_epi16(cb, byteMask);
+		ca = byteMask;
+	}
+
+	__m256i color = _mm256_and_si256(_mm256_sll_epi32(ca, aShift), _mm256_set1_epi32((int)state.aMask));
+	color = _mm256_or_si256(color, _mm256_sll_epi32(cr, rShift));
+	color = _mm256_or_si256(color, _mm256_sll_epi32(cg, gShift));
+	color = _mm256_or_si256(color, _mm256_sll_epi32(cb, bShift));
+	_mm256_storeu_si256((__m256i *)pixels, select(pass, color, dst));
+}
+
+void drawSpanAVX2(const ZSpanState &state, const ZSpan &span) {
+	const int left = MAX(span.clipLeft, span.x);
+	const int right = MIN(span.clipRight, span.x + span.count);
+	if (left >= right)
+		return;
+
+	const __m256i clipLeft = _mm256_set1_epi32(left - 1);
+	const __m256i clipRight = _mm256_set1_epi32(right);
+	const __m256i eight = _mm256_set1_epi32(8);
+	__m256i x = rampLanes(span.x, 1);
+	__m256i z = rampLanes(span.z, span.dzdx);
+	__m256i r = rampLanes(span.r, span.drdx);
+	__m256i g = rampLanes(span.g, span.dgdx);
+	__m256i b = rampLanes(span.b, span.dbdx);
+	__m256i a = rampLanes(span.a, span.dadx);
+	const __m256i dz = _mm256_set1_epi32((int)(8u * span.dzdx));
+	const __m256i dr = _mm256_set1_epi32((int)(8u * span.drdx));
+	const __m256i dg = _mm256_set1_epi32((int)(8u * span.dgdx));
+	const __m256i db = _mm256_set1_epi32((int)(8u * span.dbdx));
+	const __m256i da = _mm256_set1_epi32((int)(8u * span.dadx));
+
+	int i = 0;
+	for (; i + 8 <= span.count; i += 8) {
+		const __m256i pass = _mm256_and_si256(_mm256_cmpgt_epi32(x, clipLeft), _mm256_cmpgt_epi32(clipRight, x));
+		drawPixels8(state, span.pixels + i, span.zbuf + i, span.mask ? span.mask + i : nullptr, span.texels ? span.texels + i : nullptr,
+		            pass, z, r, g, b, a);
+		x = _mm256_add_epi32(x, eight);
+		z = _mm256_add_epi32(z, dz);
+		r = _mm256_add_epi32(r, dr);
+		g = _mm256_add_epi32(g, dg);
+		b = _mm256_add_epi32(b, db);
+		a = _mm256_add_epi32(a, da);
+	}
+
+	// The last pixels go through a copy so that nothing past the span is touched
+	const int n = span.count - i;
+	if (n > 0) {
+		uint32 pixels[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+		unsigned int zbuf[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+		byte mask[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+		uint32 texels[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+		memcpy(pixels, span.pixels + i, n * sizeof(uint32));
+		memcpy(zbuf, span.zbuf + i, n * sizeof(unsigned int));
+		if (span.mask)
+			memcpy(mask, span.mask + i, n);
+		if (span.texels)
+			memcpy(texels, span.texels + i, n * sizeof(uint32));
+
+		const __m256i pass = _mm256_and_si256(_mm256_cmpgt_epi32(x, clipLeft), _mm256_cmpgt_epi32(clipRight, x));
+		drawPixels8(state, pixels, zbuf, span.mask ? mask : nullptr, span.texels ? texels : nullptr, pass, z, r, g, b, a);
+
+		memcpy(span.pixels + i, pixels, n * sizeof(uint32));
+		memcpy(span.zbuf + i, zbuf, n * sizeof(unsigned int));
+	}
+}
+
+} // end of namespace TinyGL
@@ -0,0 +1,200 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/endian.h"
+#include "common/util.h"
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <emmintrin.h>
+
+namespace TinyGL {
+
+/** Lanes where "a func b" holds, for the functions of glDepthFunc() and glAlphaFunc(). */
+static FORCEINLINE __m128i testLanes(int func, __m128i a, __m128i b) {
+	const __m128i ones = _mm_set1_epi32(-1);
+	switch (func) {
+	case TGL_LESS:
+		return _mm_cmplt_epi32(a, b);
+	case TGL_EQUAL:
+		return _mm_cmpeq_epi32(a, b);
+	case TGL_LEQUAL:
+		return _mm_xor_si128(_mm_cmpgt_epi32(a, b), ones);
+	case TGL_GREATER:
+		return _mm_cmpgt_epi32(a, b);
+	case TGL_NOTEQUAL:
+		return _mm_xor_si128(_mm_cmpeq_epi32(a, b), ones);
+	case TGL_GEQUAL:
+		return _mm_xor_si128(_mm_cmplt_epi32(a, b), ones);
+	case TGL_ALWAYS:
+		return ones;
+	default:
+		return _mm_setzero_si128();
+	}
+}
+
+static inline __m128i rampLanes(unsigned int start, int step) {
+	const unsigned int d = (unsigned int)step;
+	return _mm_set_epi32((int)(start + 3 * d), (int)(start + 2 * d), (int)(start + d), (int)start);
+}
+
+/** Compute the 8 bit channel (c * (l >> 8)) >> 8, truncated like the scalar code. */
+static inline __m128i modulate(__m128i c, __m128i l) {
+	const __m128i l16 = _mm_and_si128(_mm_srli_epi32(l, 8), _mm_set1_epi32(0xFFFF));
+	return _mm_srli_epi32(_mm_mullo_epi16(c, l16), 8);
+}
+
+static inline __m128i select(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/** Draw 4 pixels, pass holds the lanes inside the span and the scissor rectangle. */
+static FORCEINLINE void drawPixels4(const ZSpanState &state, uint32 *pixels, unsigned int *zbuf, const byte *mask, const uint32 *texels,
+                               __m128i pass, __m128i z, __m128i r, __m128i g, __m128i b, __m128i a) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+	const __m128i signBit = _mm_set1_epi32((int)0x80000000);
+
+	if (mask) {
+		__m128i m = _mm_cvtsi32_si128(READ_UINT32(mask));
+		m = _mm_unpacklo_epi16(_mm_unpacklo_epi8(m, zero), zero);
+		pass = _mm_andnot_si128(_mm_cmpeq_epi32(m, zero), pass);
+	}
+
+	// Depth values are unsigned, flip their sign bits for the signed compares
+	const __m128i zDst = _mm_loadu_si128((const __m128i *)zbuf);
+	pass = _mm_and_si128(pass, testLanes(state.depthFunc, _mm_xor_si128(zDst, signBit), _mm_xor_si128(z, signBit)));
+	if (!_mm_movemask_epi8(pass))
+		return;
+
+	if (!state.colorWrite) {
+		if (state.depthWrite)
+			_mm_storeu_si128((__m128i *)zbuf, select(pass, z, zDst));
+		return;
+	}
+
+	__m128i cr, cg, cb, ca;
+	if (texels) {
+		const __m128i t = _mm_loadu_si128((const __m128i *)texels);
+		ca = modulate(_mm_srli_epi32(t, 24), a);
+		cr = modulate(_mm_and_si128(_mm_srli_epi32(t, 16), byteMask), r);
+		cg = modulate(_mm_and_si128(_mm_srli_epi32(t, 8), byteMask), g);
+		cb = modulate(_mm_and_si128(t, byteMask), b);
+	} else {
+		ca = _mm_and_si128(_mm_srli_epi32(a, 8), byteMask);
+		cr = _mm_and_si128(_mm_srli_epi32(r, 8), byteMask);
+		cg = _mm_and_si128(_mm_srli_epi32(g, 8), byteMask);
+		cb = _mm_and_si128(_mm_srli_epi32(b, 8), byteMask);
+	}
+
+	pass = _mm_and_si128(pass, testLanes(state.alphaFunc, ca, _mm_set1_epi32(state.alphaRef)));
+	if (!_mm_movemask_epi8(pass))
+		return;
+
+	if (state.depthWrite)
+		_mm_storeu_si128((__m128i *)zbuf, select(pass, z, zDst));
+
+	const __m128i aShift = _mm_cvtsi32_si128(state.aShift);
+	const __m128i rShift = _mm_cvtsi32_si128(state.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(state.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(state.bShift);
+	const __m128i dst = _mm_loadu_si128((const __m128i *)pixels);
+
+	if (state.blending) {
+		// Products of 8 bit values fit the low 16 bits of each lane
+		const __m128i ia = _mm_sub_epi32(byteMask, ca);
+		const __m128i dr = _mm_and_si128(_mm_srl_epi32(dst, rShift), byteMask);
+		const __m128i dg = _mm_and_si128(_mm_srl_epi32(dst, gShift), byteMask);
+		const __m128i db = _mm_and_si128(_mm_srl_epi32(dst, bShift), byteMask);
+		cr = _mm_add_epi32(_mm_srli_epi32(_mm_mullo_epi16(cr, ca), 8), _mm_srli_epi32(_mm_mullo_epi16(dr, ia), 8));
+		cg = _mm_add_epi32(_mm_srli_epi32(_mm_mullo_epi16(cg, ca), 8), _mm_srli_epi32(_mm_mullo_epi16(dg, ia), 8));
+		cb = _mm_add_epi32(_mm_srli_epi32(_mm_mullo_epi16(cb, ca), 8), _mm_srli_epi32(_mm_mullo_epi16(db, ia), 8));
+		cr = _mm_min_epi16(cr, byteMask);
+		cg = _mm_min_epi16(cg, byteMask);
+		cb = _mm_min_epi16(cb, byteMask);
+		ca = byteMask;
+	}
+
+	__m128i color = _mm_and_si128(_mm_sll_epi32(ca, aShift), _mm_set1_epi32((int)state.aMask));
+	color = _mm_or_si128(color, _mm_sll_epi32(cr, rShift));
+	color = _mm_or_si128(color, _mm_sll_epi32(cg, gShift));
+	color = _mm_or_si128(color, _mm_sll_epi32(cb, bShift));
+	_mm_storeu_si128((__m128i *)pixels, select(pass, color, dst));
+}
+
+void drawSpanSSE2(const ZSpanState &state, const ZSpan &span) {
+	const int left = MAX(span.clipLeft, span.x);
+	const int right = MIN(span.clipRight, span.x + span.count);
+	if (left >= right)
+		return;
+
+	const __m128i clipLeft = _mm_set1_epi32(left - 1);
+	const __m128i clipRight = _mm_set1_epi32(right);
+	const __m128i four = _mm_set1_epi32(4);
+	__m128i x = rampLanes(span.x, 1);
+	__m128i z = rampLanes(span.z, span.dzdx);
+	__m128i r = rampLanes(span.r, span.drdx);
+	__m128i g = rampLanes(span.g, span.dgdx);
+	__m128i b = rampLanes(span.b, span.dbdx);
+	__m128i a = rampLanes(span.a, span.dadx);
+	const __m128i dz = _mm_set1_epi32((int)(4u * span.dzdx));
+	const __m128i dr = _mm_set1_epi32((int)(4u * span.drdx));
+	const __m128i dg = _mm_set1_epi32((int)(4u * span.dgdx));
+	const __m128i db = _mm_set1_epi32((int)(4u * span.dbdx));
+	const __m128i da = _mm_set1_epi32((int)(4u * span.dadx));
+
+	int i = 0;
+	for (; i + 4 <= span.count; i += 4) {
+		const __m128i pass = _mm_and_si128(_mm_cmpgt_epi32(x, clipLeft), _mm_cmplt_epi32(x, clipRight));
+		drawPixels4(state, span.pixels + i, span.zbuf + i, span.mask ? span.mask + i : nullptr, span.texels ? span.texels + i : nullptr,
+		            pass, z, r, g, b, a);
+		x = _mm_add_epi32(x, four);
+		z = _mm_add_epi32(z, dz);
+		r = _mm_add_epi32(r, dr);
+		g = _mm_add_epi32(g, dg);
+		b = _mm_add_epi32(b, db);
+		a = _mm_add_epi32(a, da);
+	}
+
+	// The last pixels go through a copy so that nothing past the span is touched
+	const int n = span.count - i;
+	if (n > 0) {
+		uint32 pixels[4] = { 0, 0, 0, 0 };
+		unsigned int zbuf[4] = { 0, 0, 0, 0 };
+		byte mask[4] = { 0, 0, 0, 0 };
+		uint32 texels[4] = { 0, 0, 0, 0 };
+		memcpy(pixels, span.pixels + i, n * sizeof(uint32));
+		memcpy(zbuf, span.zbuf + i, n * sizeof(unsigned int));
+		if (span.mask)
+			memcpy(mask, span.mask + i, n);
+		if (span.texels)
+			memcpy(texels, span.texels + i, n * sizeof(uint32));
+
+		const __m128i pass = _mm_and_si128(_mm_cmpgt_epi32(x, clipLeft), _mm_cmplt_epi32(x, clipRight));
+		drawPixels4(state, pixels, zbuf, span.mask ? mask : nullptr, span.texels ? texels : nullptr, pass, z, r, g, b, a);
+
+		memcpy(span.pixels + i, pixels, n * sizeof(uint32));
+		memcpy(span.zbuf + i, zbuf, n * sizeof(unsigned int));
+	}
+}
+
+} // end of namespace TinyGL
@@ -35,6 +35,9 @@ namespace TinyGL {
 
 static const int NB_INTERP = 8;
 
+// Number of texels fetched ahead of the SIMD span kernels
+static const int kSpanChunk = 64;
+
 template <bool kDepthWrite, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending>
 FORCEINLINE static void putPixelFlat(FrameBuffer *buffer, int buf, unsigned int *pz, int _a,
                                      int x, int y, unsigned int &z, unsigned int &r, unsigned int &g, unsigned int &b, unsigned int &a, int &dzdx) {
@@ -268,6 +271,12 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		ndtzdx = NB_INTERP * dtzdx;
 	}
 
+	// The SIMD kernels take over the spans when they support the current state
+	ZSpanState spanState;
+	const bool simdSpans = kInterpZ && kDrawLogic != DRAW_SHADOW_MASK &&
+		getSpanState(spanState, kDrawLogic != DRAW_DEPTH_ONLY, kAlphaTestEnabled && kDrawLogic != DRAW_DEPTH_ONLY,
+		             kBlendingEnabled && kDrawLogic != DRAW_DEPTH_ONLY, kDepthWrite);
+
 	if (fz0 > 0) {
 		l1 = p0;
 		l2 = p2;
@@ -361,8 +370,89 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
 			int x = x1;
-			{
-				if (kDrawLogic == DRAW_DEPTH_ONLY ||
+			// Scan lines outside of the scissor rectangle only need their edges to be stepped
+			if (!kEnableScissor || (y >= _clipRectangle.top && y < _clipRectangle.bottom)) {
+				if (simdSpans) {
+					const bool smooth = kDrawLogic == DRAW_SMOOTH;
+					ZSpan span;
+					span.pixels = (uint32 *)pbuf.getRawBuffer(pp1 + x1);
+					span.zbuf = pz1 + x1;
+					span.mask = kDrawLogic == DRAW_SHADOW ? pm1 + x1 : nullptr;
+					span.texels = nullptr;
+					span.x = x1;
+					span.count = (x2 >> 16) - x1 + 1;
+					span.clipLeft = kEnableScissor ? _clipRectangle.left : x1;
+					span.clipRight = kEnableScissor ? _clipRectangle.right : x1 + span.count;
+					span.z = z1;
+					span.r = r1;
+					span.g = g1;
+					span.b = b1;
+					span.a = kDrawLogic == DRAW_SHADOW ? 255 << (ZB_POINT_ALPHA_BITS - 8) : a1;
+					span.dzdx = dzdx;
+					span.drdx = smooth ? drdx : 0;
+					span.dgdx = smooth ? dgdx : 0;
+					span.dbdx = smooth ? dbdx : 0;
+					span.dadx = smooth ? dadx : 0;
+
+					if (kInterpST || kInterpSTZ) {
+						// Fetch the texels with the same steps as the scalar loop, a chunk at a time
+						uint32 texels[kSpanChunk];
+						float sz = sz1, tz = tz1, fz = (float)z1;
+						float zinv = (float)(1.0 / fz);
+						int s = 0, t = 0, dsdx = 0, dtdx = 0, group = 0;
+						int remaining = span.count;
+						span.texels = texels;
+						while (remaining > 0) {
+							const int chunk = MIN(remaining, kSpanChunk);
+							for (int i = 0; i < chunk; i++) {
+								if (group == 0) {
+									float ss, tt;
+									ss = sz * zinv;
+									tt = tz * zinv;
+									s = (int)ss;
+									t = (int)tt;
+									dsdx = (int)((dszdx - ss * fdzdx) * zinv);
+									dtdx = (int)((dtzdx - tt * fdzdx) * zinv);
+									if (remaining - i >= NB_INTERP) {
+										fz += fndzdx;
+										zinv = (float)(1.0 / fz);
+										sz += ndszdx;
+										tz += ndtzdx;
+										group = NB_INTERP;
+									} else {
+										group = remaining - i;
+									}
+								}
+								// Texels of hidden pixels are never used, skip their lookups
+								unsigned int z = span.z + i * (unsigned int)span.dzdx;
+								if (compareDepth(z, span.zbuf[i])) {
+									uint8 c_a, c_r, c_g, c_b;
+									texture->getARGBAt(wrapS, wrapT, s, t, c_a, c_r, c_g, c_b);
+									texels[i] = ((uint32)c_a << 24) | (c_r << 16) | (c_g << 8) | c_b;
+								} else {
+									texels[i] = 0;
+								}
+								s += dsdx;
+								t += dtdx;
+								group--;
+							}
+							span.count = chunk;
+							_drawSpan(spanState, span);
+
+							span.pixels += chunk;
+							span.zbuf += chunk;
+							span.x += chunk;
+							span.z += chunk * (unsigned int)span.dzdx;
+							span.r += chunk * (unsigned int)span.drdx;
+							span.g += chunk * (unsigned int)span.dgdx;
+							span.b += chunk * (unsigned int)span.dbdx;
+							span.a += chunk * (unsigned int)span.dadx;
+							remaining -= chunk;
+						}
+					} else if (span.count > 0) {
+						_drawSpan(spanState, span);
+					}
+				} else if (kDrawLogic == DRAW_DEPTH_ONLY ||
 						(kDrawLogic == DRAW_FLAT && !(kInterpST || kInterpSTZ))) {
 					int pp;
 					int n;
@@ -392,7 +482,7 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						if (kDrawLogic == DRAW_FLAT) {
 							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 0, x, y, z, r, g, b, a, dzdx);
 							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 1, x, y, z, r, g, b, a, dzdx);
-							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 2, x, y, z, r, g, g, a, dzdx);
+							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 2, x, y, z, r, g, b, a, dzdx);
 							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 3, x, y, z, r, g, b, a, dzdx);
 						}
 						if (kInterpZ) {
@@ -28,6 +28,7 @@
 
 
 #include "common/algorithm.h"
+#include "common/cpudetect.h"
 #include "common/endian.h"
 #include "common/util.h"
 #include "common/rect.h"
@@ -36,6 +37,7 @@
 #include "graphics/conversion.h"
 #include "graphics/primitives.h"
 #include "graphics/transparent_surface.h"
+#include "graphics/transparent_surface_simd.h"
 #include "graphics/transform_tools.h"
 
 namespace Graphics {
@@ -65,6 +67,33 @@ void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
 void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
 
+/** Get the SIMD version of a blitter for the CPU, or nullptr if there is none. */
+static TransparentSurfaceSIMDProc getSIMDProc(TransparentSurfaceSIMDProc TransparentSurfaceSIMDProcs::*proc) {
+	TransparentSurfaceSIMDProcs procs;
+	memset(&procs, 0, sizeof(procs));
+
+#ifdef SCUMMVM_AVX2
+	if (Common::hasCpuFeature(Common::kCpuFeatureAVX2)) {
+		getTransparentSurfaceProcsAVX2(procs);
+		return procs.*proc;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (Common::hasCpuFeature(Common::kCpuFeatureSSE2)) {
+		getTransparentSurfaceProcsSSE2(procs);
+		return procs.*proc;
+	}
+#endif
+#ifdef SCUMMVM_NEON
+	if (Common::hasCpuFeature(Common::kCpuFeatureNEON)) {
+		getTransparentSurfaceProcsNEON(procs);
+		return procs.*proc;
+	}
+#endif
+
+	return procs.*proc;
+}
+
 TransparentSurface::TransparentSurface() : Surface(), _alphaMode(ALPHA_FULL) {}
 
 TransparentSurface::TransparentSurface(const Surface &surf, bool copyData) : Surface(), _alphaMode(ALPHA_FULL) {
@@ -86,17 +115,20 @@ TransparentSurface::TransparentSurface(const Surface &surf, bool copyData) : Sur
  * Optimized version of doBlit to be used w/opaque blitting (no alpha).
  */
 void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+	const TransparentSurfaceSIMDProc simd = getSIMDProc(&TransparentSurfaceSIMDProcs::opaque);
 
 	byte *in;
 	byte *out;
 
 	for (uint32 i = 0; i < height; i++) {
-		out = outo;
-		in = ino;
-		memcpy(out, in, width * 4);
-		for (uint32 j = 0; j < width; j++) {
+		const uint32 done = simd ? simd(outo, ino, width, inStep, 0xffffffff) : 0;
+		out = outo + done * 4;
+		in = ino + (int32)done * inStep;
+		for (uint32 j = done; j < width; j++) {
+			*(uint32 *)out = *(uint32 *)in;
 			out[kAIndex] = 0xFF;
 			out += 4;
+			in += inStep;
 		}
 		outo += pitch;
 		ino += inoStep;
@@ -107,14 +139,16 @@ void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
  * Optimized version of doBlit to be used w/binary blitting (blit or no-blit, no blending).
  */
 void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+	const TransparentSurfaceSIMDProc simd = getSIMDProc(&TransparentSurfaceSIMDProcs::binary);
 
 	byte *in;
 	byte *out;
 
 	for (uint32 i = 0; i < height; i++) {
-		out = outo;
-		in = ino;
-		for (uint32 j = 0; j < width; j++) {
+		const uint32 done = simd ? simd(outo, ino, width, inStep, 0xffffffff) : 0;
+		out = outo + done * 4;
+		in = ino + (int32)done * inStep;
+		for (uint32 j = done; j < width; j++) {
 			uint32 pix = *(uint32 *)in;
 			int a = in[kAIndex];
 
@@ -142,15 +176,18 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
  * @color colormod in 0xAARRGGBB format - 0xFFFFFFFF for no colormod
  */
 void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	const TransparentSurfaceSIMDProc simd = getSIMDProc(&TransparentSurfaceSIMDProcs::alphaBlend);
+
 	byte *in;
 	byte *out;
 
 	if (color == 0xffffffff) {
 
 		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			const uint32 done = simd ? simd(outo, ino, width, inStep, color) : 0;
+			out = outo + done * 4;
+			in = ino + (int32)done * inStep;
+			for (uint32 j = done; j < width; j++) {
 
 				if (in[kAIndex] != 0) {
 					out[kAIndex] = 255;
@@ -173,9 +210,10 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 		byte cb = (color >> kBModShift) & 0xFF;
 
 		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			const uint32 done = simd ? simd(outo, ino, width, inStep, color) : 0;
+			out = outo + done * 4;
+			in = ino + (int32)done * inStep;
+			for (uint32 j = done; j < width; j++) {
 
 				uint32 ina = in[kAIndex] * ca >> 8;
 
@@ -203,15 +241,18 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
  * Optimized version of doBlit to be used with additive blended blitting
  */
 void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	const TransparentSurfaceSIMDProc simd = getSIMDProc(&TransparentSurfaceSIMDProcs::additiveBlend);
+
 	byte *in;
 	byte *out;
 
 	if (color == 0xffffffff) {
 
 		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			const uint32 done = simd ? simd(outo, ino, width, inStep, color) : 0;
+			out = outo + done * 4;
+			in = ino + (int32)done * inStep;
+			for (uint32 j = done; j < width; j++) {
 
 				if (in[kAIndex] != 0) {
 					out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) + out[kRIndex], 255);
@@ -233,9 +274,10 @@ void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 		byte cb = (color >> kBModShift) & 0xFF;
 
 		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			const uint32 done = simd ? simd(outo, ino, width, inStep, color) : 0;
+			out = outo + done * 4;
+			in = ino + (int32)done * inStep;
+			for (uint32 j = done; j < width; j++) {
 
 				uint32 ina = in[kAIndex] * ca >> 8;
 
@@ -270,15 +312,18 @@ void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
  * Optimized version of doBlit to be used with subtractive blended blitting
  */
 void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	const TransparentSurfaceSIMDProc simd = getSIMDProc(&TransparentSurfaceSIMDProcs::subtractiveBlend);
+
 	byte *in;
 	byte *out;
 
 	if (color == 0xffffffff) {
 
 		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			const uint32 done = simd ? simd(outo, ino, width, inStep, color) : 0;
+			out = outo + done * 4;
+			in = ino + (int32)done * inStep;
+			for (uint32 j = done; j < width; j++) {
 
 				if (in[kAIndex] != 0) {
 					out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * out[kRIndex]) * in[kAIndex] >> 16), 0);
@@ -299,25 +344,26 @@ void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height,
 		byte cb = (color >> kBModShift) & 0xFF;
 
 		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			const uint32 done = simd ? simd(outo, ino, width, inStep, color) : 0;
+			out = outo + done * 4;
+			in = ino + (int32)done * inStep;
+			for (uint32 j = done; j < width; j++) {
 
 				out[kAIndex] = 255;
 				if (cb != 255) {
-					out[kBIndex] = MAX(out[kBIndex] - ((in[kBIndex] * cb  * (out[kBIndex]) * in[kAIndex]) >> 24), 0);
+					out[kBIndex] = MAX(out[kBIndex] - (int)(((uint32)in[kBIndex] * cb * out[kBIndex] * in[kAIndex]) >> 24), 0);
 				} else {
 					out[kBIndex] = MAX(out[kBIndex] - (in[kBIndex] * (out[kBIndex]) * in[kAIndex] >> 16), 0);
 				}
 
 				if (cg != 255) {
-					out[kGIndex] = MAX(out[kGIndex] - ((in[kGIndex] * cg  * (out[kGIndex]) * in[kAIndex]) >> 24), 0);
+					out[kGIndex] = MAX(out[kGIndex] - (int)(((uint32)in[kGIndex] * cg * out[kGIndex] * in[kAIndex]) >> 24), 0);
 				} else {
 					out[kGIndex] = MAX(out[kGIndex] - (in[kGIndex] * (out[kGIndex]) * in[kAIndex] >> 16), 0);
 				}
 
 				if (cr != 255) {
-					out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * cr * (out[kRIndex]) * in[kAIndex]) >> 24), 0);
+					out[kRIndex] = MAX(out[kRIndex] - (int)(((uint32)in[kRIndex] * cr * out[kRIndex] * in[kAIndex]) >> 24), 0);
 				} else {
 					out[kRIndex] = MAX(out[kRIndex] - (in[kRIndex] * (out[kRIndex]) * in[kAIndex] >> 16), 0);
 				}
@@ -335,14 +381,17 @@ void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height,
  * Optimized version of doBlit to be used with multiply blended blitting
  */
 void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	const TransparentSurfaceSIMDProc simd = getSIMDProc(&TransparentSurfaceSIMDProcs::multiplyBlend);
+
 	byte *in;
 	byte *out;
 
 	if (color == 0xffffffff) {
 		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			const uint32 done = simd ? simd(outo, ino, width, inStep, color) : 0;
+			out = outo + done * 4;
+			in = ino + (int32)done * inStep;
+			for (uint32 j = done; j < width; j++) {
 
 				if (in[kAIndex] != 0) {
 					out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) * out[kRIndex] >> 8, 255);
@@ -363,9 +412,10 @@ void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 		byte cb = (color >> kBModShift) & 0xFF;
 
 		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			const uint32 done = simd ? simd(outo, ino, width, inStep, color) : 0;
+			out = outo + done * 4;
+			in = ino + (int32)done * inStep;
+			for (uint32 j = done; j < width; j++) {
 
 				uint32 ina = in[kAIndex] * ca >> 8;
 
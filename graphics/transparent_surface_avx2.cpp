@@ -0,0 +1,77 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/transparent_surface_simd.h"
+
+#include <immintrin.h>
+
+namespace {
+
+struct AVX2Ops {
+	typedef __m256i P;
+	typedef __m256i W;
+	enum { kPixels = 8 };
+
+	static FORCEINLINE P load(const byte *p) { return _mm256_loadu_si256((const __m256i *)p); }
+
+	static FORCEINLINE P loadReversed(const byte *p) {
+		return _mm256_permutevar8x32_epi32(load(p), _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+	}
+
+	static FORCEINLINE void store(byte *p, P v) { _mm256_storeu_si256((__m256i *)p, v); }
+
+	static FORCEINLINE P set1(uint32 x) { return _mm256_set1_epi32((int)x); }
+	static FORCEINLINE P and_(P a, P b) { return _mm256_and_si256(a, b); }
+	static FORCEINLINE P or_(P a, P b) { return _mm256_or_si256(a, b); }
+	static FORCEINLINE P select(P mask, P a, P b) { return _mm256_blendv_epi8(b, a, mask); }
+	static FORCEINLINE P cmpeq32(P a, P b) { return _mm256_cmpeq_epi32(a, b); }
+	static FORCEINLINE bool all(P mask) { return (uint32)_mm256_movemask_epi8(mask) == 0xFFFFFFFF; }
+	static FORCEINLINE P sll32(P a, int n) { return _mm256_slli_epi32(a, n); }
+	static FORCEINLINE P subs8(P a, P b) { return _mm256_subs_epu8(a, b); }
+
+	// Widening and narrowing both work within 128 bit lanes, which keeps the pixel order
+	static FORCEINLINE W widenLo(P v) { return _mm256_unpacklo_epi8(v, _mm256_setzero_si256()); }
+	static FORCEINLINE W widenHi(P v) { return _mm256_unpackhi_epi8(v, _mm256_setzero_si256()); }
+	static FORCEINLINE P narrow(W low, W high) { return _mm256_packus_epi16(low, high); }
+
+	static FORCEINLINE W set1_16(int x) { return _mm256_set1_epi16((short)x); }
+	static FORCEINLINE W select16(W mask, W a, W b) { return select(mask, a, b); }
+	static FORCEINLINE W cmpeq16(W a, W b) { return _mm256_cmpeq_epi16(a, b); }
+	static FORCEINLINE W add16(W a, W b) { return _mm256_add_epi16(a, b); }
+	static FORCEINLINE W sub16(W a, W b) { return _mm256_sub_epi16(a, b); }
+	static FORCEINLINE W mul16(W a, W b) { return _mm256_mullo_epi16(a, b); }
+	static FORCEINLINE W mulhi16(W a, W b) { return _mm256_mulhi_epu16(a, b); }
+	static FORCEINLINE W srl16(W a, int n) { return _mm256_srli_epi16(a, n); }
+	static FORCEINLINE W min16(W a, W b) { return _mm256_min_epi16(a, b); }
+};
+
+} // End of anonymous namespace
+
+#include "graphics/transparent_surface_simd_impl.h"
+
+namespace Graphics {
+
+void getTransparentSurfaceProcsAVX2(TransparentSurfaceSIMDProcs &procs) {
+	TransparentSurfaceKernels<AVX2Ops>::getProcs(procs);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,88 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/transparent_surface_simd.h"
+
+#include <arm_neon.h>
+
+namespace {
+
+struct NEONOps {
+	typedef uint32x4_t P;
+	typedef uint16x8_t W;
+	enum { kPixels = 4 };
+
+	static FORCEINLINE P load(const byte *p) { return vreinterpretq_u32_u8(vld1q_u8(p)); }
+
+	static FORCEINLINE P loadReversed(const byte *p) {
+		const P v = vrev64q_u32(load(p));
+		return vcombine_u32(vget_high_u32(v), vget_low_u32(v));
+	}
+
+	static FORCEINLINE void store(byte *p, P v) { vst1q_u8(p, vreinterpretq_u8_u32(v)); }
+
+	static FORCEINLINE P set1(uint32 x) { return vdupq_n_u32(x); }
+	static FORCEINLINE P and_(P a, P b) { return vandq_u32(a, b); }
+	static FORCEINLINE P or_(P a, P b) { return vorrq_u32(a, b); }
+	static FORCEINLINE P select(P mask, P a, P b) { return vbslq_u32(mask, a, b); }
+	static FORCEINLINE P cmpeq32(P a, P b) { return vceqq_u32(a, b); }
+
+	static FORCEINLINE bool all(P mask) {
+		const uint32x2_t m = vand_u32(vget_low_u32(mask), vget_high_u32(mask));
+		return vget_lane_u32(vpmin_u32(m, m), 0) == 0xFFFFFFFF;
+	}
+
+	static FORCEINLINE P sll32(P a, int n) { return vshlq_u32(a, vdupq_n_s32(n)); }
+	static FORCEINLINE P subs8(P a, P b) { return vreinterpretq_u32_u8(vqsubq_u8(vreinterpretq_u8_u32(a), vreinterpretq_u8_u32(b))); }
+
+	static FORCEINLINE W widenLo(P v) { return vmovl_u8(vget_low_u8(vreinterpretq_u8_u32(v))); }
+	static FORCEINLINE W widenHi(P v) { return vmovl_u8(vget_high_u8(vreinterpretq_u8_u32(v))); }
+	static FORCEINLINE P narrow(W low, W high) { return vreinterpretq_u32_u8(vcombine_u8(vqmovn_u16(low), vqmovn_u16(high))); }
+
+	static FORCEINLINE W set1_16(int x) { return vdupq_n_u16((uint16)x); }
+	static FORCEINLINE W select16(W mask, W a, W b) { return vbslq_u16(mask, a, b); }
+	static FORCEINLINE W cmpeq16(W a, W b) { return vceqq_u16(a, b); }
+	static FORCEINLINE W add16(W a, W b) { return vaddq_u16(a, b); }
+	static FORCEINLINE W sub16(W a, W b) { return vsubq_u16(a, b); }
+	static FORCEINLINE W mul16(W a, W b) { return vmulq_u16(a, b); }
+
+	static FORCEINLINE W mulhi16(W a, W b) {
+		const uint32x4_t low = vmull_u16(vget_low_u16(a), vget_low_u16(b));
+		const uint32x4_t high = vmull_u16(vget_high_u16(a), vget_high_u16(b));
+		return vcombine_u16(vshrn_n_u32(low, 16), vshrn_n_u32(high, 16));
+	}
+
+	static FORCEINLINE W srl16(W a, int n) { return vshlq_u16(a, vdupq_n_s16((int16)-n)); }
+	static FORCEINLINE W min16(W a, W b) { return vminq_u16(a, b); }
+};
+
+} // End of anonymous namespace
+
+#include "graphics/transparent_surface_simd_impl.h"
+
+namespace Graphics {
+
+void getTransparentSurfaceProcsNEON(TransparentSurfaceSIMDProcs &procs) {
+	TransparentSurfaceKernels<NEONOps>::getProcs(procs);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,63 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_TRANSPARENT_SURFACE_SIMD_H
+#define GRAPHICS_TRANSPARENT_SURFACE_SIMD_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * Blit the leading pixels of a row of a TransparentSurface, with the
+ * arguments of the doBlit*() functions: inStep is 4, or -4 for rows which
+ * are flipped horizontally, where in points to the rightmost source pixel.
+ * SIMD kernels work on whole vectors, so they return how many pixels they
+ * blitted and leave the rest of the row to the generic code.
+ */
+typedef int (*TransparentSurfaceSIMDProc)(byte *out, const byte *in, int width, int inStep, uint32 color);
+
+/** The blend modes, each giving exactly the same pixels as the generic code. */
+struct TransparentSurfaceSIMDProcs {
+	TransparentSurfaceSIMDProc opaque;
+	TransparentSurfaceSIMDProc binary;
+	TransparentSurfaceSIMDProc alphaBlend;
+	TransparentSurfaceSIMDProc additiveBlend;
+	TransparentSurfaceSIMDProc subtractiveBlend;
+	TransparentSurfaceSIMDProc multiplyBlend;
+};
+
+#ifdef SCUMMVM_SSE2
+void getTransparentSurfaceProcsSSE2(TransparentSurfaceSIMDProcs &procs);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void getTransparentSurfaceProcsAVX2(TransparentSurfaceSIMDProcs &procs);
+#endif
+
+#ifdef SCUMMVM_NEON
+void getTransparentSurfaceProcsNEON(TransparentSurfaceSIMDProcs &procs);
+#endif
+
+} // End of namespace Graphics
+
+#endif
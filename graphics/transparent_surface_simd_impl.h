@@ -0,0 +1,311 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * The SIMD TransparentSurface blitters, written once against a small set
+ * of vector operations. Each transparent_surface_*.cpp file defines those
+ * operations for its instruction set and includes this file, which must
+ * not be included anywhere else: it is compiled with different code
+ * generation flags every time.
+ *
+ * An Ops class provides vectors P of kPixels 32 bit pixels and vectors W
+ * of the same pixels widened to one 16 bit lane per channel:
+ *   load(), loadReversed() which loads kPixels pixels in reverse order,
+ *   store(), set1(), and_(), or_(), select() which picks the lanes of a
+ *   where the mask is set and those of b elsewhere, cmpeq32(), all() which
+ *   tells whether every lane of a mask is set, sll32(), subs8() (unsigned
+ *   saturating subtraction of bytes), widenLo() and widenHi() which widen
+ *   the first resp. second half of the pixels of a P and narrow() which
+ *   packs two W into a P again, and for W set1_16(), select16(),
+ *   cmpeq16(), add16(), sub16(), mul16() (the low half of the product),
+ *   mulhi16() (the high half of the unsigned product), srl16() and min16().
+ *
+ * The pixels have the format of TransparentSurface, alpha is the low byte
+ * of each 32 bit pixel. All the products of the generic code fit in 16
+ * bits, or are shifted right by 16 bits or more afterwards, so the kernels
+ * give exactly the same pixels.
+ */
+
+#ifndef GRAPHICS_TRANSPARENT_SURFACE_SIMD_IMPL_H
+#define GRAPHICS_TRANSPARENT_SURFACE_SIMD_IMPL_H
+
+#include "graphics/transparent_surface_simd.h"
+
+namespace Graphics {
+
+template<class Ops>
+struct TransparentSurfaceKernels {
+	typedef typename Ops::P P;
+	typedef typename Ops::W W;
+
+	/** The alpha of each pixel, repeated in all of its channels. */
+	static FORCEINLINE P alphas(P pixels) {
+		const P a = Ops::and_(pixels, Ops::set1(0xFF));
+		const P a2 = Ops::or_(a, Ops::sll32(a, 8));
+		return Ops::or_(a2, Ops::sll32(a2, 16));
+	}
+
+	/** (alpha * ca) >> 8 for each channel, like the color modulated blend modes do. */
+	static FORCEINLINE P modulateAlpha(P a, W ca) {
+		return Ops::narrow(Ops::srl16(Ops::mul16(Ops::widenLo(a), ca), 8),
+		                   Ops::srl16(Ops::mul16(Ops::widenHi(a), ca), 8));
+	}
+
+	/** Widen the color modulation, 0xAARRGGBB, to the layout of the pixels. */
+	static FORCEINLINE W tint(uint32 color) {
+		const uint32 pixel = ((color >> 16 & 0xFF) << 24) | ((color >> 8 & 0xFF) << 16) | ((color & 0xFF) << 8) | (color >> 24);
+		return Ops::widenLo(Ops::set1(pixel));
+	}
+
+	/** Apply the channels() function of a blender to both halves of the pixels. */
+	template<class Blender>
+	static FORCEINLINE P channels(const Blender &blender, P src, P dst, P a) {
+		return Ops::narrow(blender.channels(Ops::widenLo(src), Ops::widenLo(dst), Ops::widenLo(a)),
+		                   blender.channels(Ops::widenHi(src), Ops::widenHi(dst), Ops::widenHi(a)));
+	}
+
+	/**
+	 * The common part of the blenders. blend() computes the new destination
+	 * pixels and returns false if none of them changes.
+	 */
+	struct Blender {
+		P zero, alphaMask;
+		W c255;
+
+		Blender() : zero(Ops::set1(0)), alphaMask(Ops::set1(0xFF)), c255(Ops::set1_16(255)) {}
+	};
+
+	struct OpaqueBlender : Blender {
+		FORCEINLINE bool blend(P src, P &dst) const {
+			dst = Ops::or_(src, this->alphaMask);
+			return true;
+		}
+	};
+
+	struct BinaryBlender : Blender {
+		FORCEINLINE bool blend(P src, P &dst) const {
+			const P transparent = Ops::cmpeq32(Ops::and_(src, this->alphaMask), this->zero);
+			dst = Ops::select(transparent, dst, Ops::or_(src, this->alphaMask));
+			return true;
+		}
+	};
+
+	struct AlphaBlender : Blender {
+		FORCEINLINE W channels(W in, W out, W a) const {
+			return Ops::srl16(Ops::add16(Ops::mul16(in, a), Ops::mul16(out, Ops::sub16(this->c255, a))), 8);
+		}
+
+		FORCEINLINE bool blend(P src, P &dst) const {
+			const P a = Ops::and_(src, this->alphaMask);
+			const P transparent = Ops::cmpeq32(a, this->zero);
+			if (Ops::all(transparent))
+				return false;
+
+			// Opaque pixels only lose a little brightness: (c * 255) >> 8 is c - 1
+			P result;
+			if (Ops::all(Ops::cmpeq32(a, this->alphaMask)))
+				result = Ops::subs8(src, Ops::set1(0x01010101));
+			else
+				result = TransparentSurfaceKernels::channels(*this, src, dst, alphas(src));
+			dst = Ops::select(transparent, dst, Ops::or_(result, this->alphaMask));
+			return true;
+		}
+	};
+
+	struct AlphaTintBlender : Blender {
+		W ca, color;
+
+		explicit AlphaTintBlender(uint32 c) : ca(Ops::set1_16(c >> 24)), color(tint(c)) {}
+
+		FORCEINLINE W channels(W in, W out, W ina) const {
+			return Ops::add16(Ops::srl16(Ops::mul16(out, Ops::sub16(this->c255, ina)), 8),
+			                  Ops::mulhi16(Ops::mul16(in, ina), color));
+		}
+
+		FORCEINLINE bool blend(P src, P &dst) const {
+			const P ina = modulateAlpha(alphas(src), ca);
+			const P transparent = Ops::cmpeq32(ina, this->zero);
+			if (Ops::all(transparent))
+				return false;
+
+			const P result = TransparentSurfaceKernels::channels(*this, src, dst, ina);
+			dst = Ops::select(transparent, dst, Ops::or_(result, this->alphaMask));
+			return true;
+		}
+	};
+
+	struct AdditiveBlender : Blender {
+		FORCEINLINE W channels(W in, W out, W a) const {
+			return Ops::min16(Ops::add16(Ops::srl16(Ops::mul16(in, a), 8), out), this->c255);
+		}
+
+		FORCEINLINE bool blend(P src, P &dst) const {
+			if (Ops::all(Ops::cmpeq32(Ops::and_(src, this->alphaMask), this->zero)))
+				return false;
+
+			dst = Ops::select(this->alphaMask, dst, TransparentSurfaceKernels::channels(*this, src, dst, alphas(src)));
+			return true;
+		}
+	};
+
+	struct AdditiveTintBlender : Blender {
+		W ca, color, full;
+
+		explicit AdditiveTintBlender(uint32 c) : ca(Ops::set1_16(c >> 24)), color(tint(c)), full(Ops::cmpeq16(color, this->c255)) {}
+
+		FORCEINLINE W channels(W in, W out, W ina) const {
+			const W product = Ops::mul16(in, ina);
+			const W add = Ops::select16(full, Ops::srl16(product, 8), Ops::mulhi16(product, color));
+			return Ops::min16(Ops::add16(out, add), this->c255);
+		}
+
+		FORCEINLINE bool blend(P src, P &dst) const {
+			const P ina = modulateAlpha(alphas(src), ca);
+			dst = Ops::select(this->alphaMask, dst, TransparentSurfaceKernels::channels(*this, src, dst, ina));
+			return true;
+		}
+	};
+
+	struct SubtractiveBlender : Blender {
+		FORCEINLINE W channels(W in, W out, W a) const {
+			return Ops::sub16(out, Ops::mulhi16(Ops::mul16(in, out), a));
+		}
+
+		FORCEINLINE bool blend(P src, P &dst) const {
+			if (Ops::all(Ops::cmpeq32(Ops::and_(src, this->alphaMask), this->zero)))
+				return false;
+
+			dst = Ops::select(this->alphaMask, dst, TransparentSurfaceKernels::channels(*this, src, dst, alphas(src)));
+			return true;
+		}
+	};
+
+	struct SubtractiveTintBlender : Blender {
+		W color, full;
+
+		explicit SubtractiveTintBlender(uint32 c) : color(tint(c)), full(Ops::cmpeq16(color, this->c255)) {}
+
+		FORCEINLINE W channels(W in, W out, W a) const {
+			const W product = Ops::mul16(in, out);
+			const W sub = Ops::select16(full, Ops::mulhi16(product, a), Ops::srl16(Ops::mulhi16(product, Ops::mul16(color, a)), 8));
+			return Ops::sub16(out, sub);
+		}
+
+		FORCEINLINE bool blend(P src, P &dst) const {
+			dst = Ops::or_(TransparentSurfaceKernels::channels(*this, src, dst, alphas(src)), this->alphaMask);
+			return true;
+		}
+	};
+
+	struct MultiplyBlender : Blender {
+		FORCEINLINE W channels(W in, W out, W a) const {
+			return Ops::srl16(Ops::mul16(Ops::srl16(Ops::mul16(in, a), 8), out), 8);
+		}
+
+		FORCEINLINE bool blend(P src, P &dst) const {
+			const P transparent = Ops::cmpeq32(Ops::and_(src, this->alphaMask), this->zero);
+			if (Ops::all(transparent))
+				return false;
+
+			const P result = TransparentSurfaceKernels::channels(*this, src, dst, alphas(src));
+			dst = Ops::select(Ops::or_(transparent, this->alphaMask), dst, result);
+			return true;
+		}
+	};
+
+	struct MultiplyTintBlender : Blender {
+		W ca, color, full;
+
+		explicit MultiplyTintBlender(uint32 c) : ca(Ops::set1_16(c >> 24)), color(tint(c)), full(Ops::cmpeq16(color, this->c255)) {}
+
+		FORCEINLINE W channels(W in, W out, W ina) const {
+			const W product = Ops::mul16(in, ina);
+			const W factor = Ops::select16(full, Ops::srl16(product, 8), Ops::mulhi16(product, color));
+			return Ops::srl16(Ops::mul16(out, factor), 8);
+		}
+
+		FORCEINLINE bool blend(P src, P &dst) const {
+			const P ina = modulateAlpha(alphas(src), ca);
+			dst = Ops::select(this->alphaMask, dst, TransparentSurfaceKernels::channels(*this, src, dst, ina));
+			return true;
+		}
+	};
+
+	template<class B>
+	static int blitRow(byte *out, const byte *in, int width, int inStep, const B &blender) {
+		const int count = width & ~(Ops::kPixels - 1);
+
+		for (int x = 0; x < count; x += Ops::kPixels) {
+			const P src = inStep > 0 ? Ops::load(in + x * 4) : Ops::loadReversed(in - (x + Ops::kPixels - 1) * 4);
+			P dst = Ops::load(out + x * 4);
+			if (blender.blend(src, dst))
+				Ops::store(out + x * 4, dst);
+		}
+
+		return count;
+	}
+
+	static int opaque(byte *out, const byte *in, int width, int inStep, uint32 color) {
+		return blitRow(out, in, width, inStep, OpaqueBlender());
+	}
+
+	static int binary(byte *out, const byte *in, int width, int inStep, uint32 color) {
+		return blitRow(out, in, width, inStep, BinaryBlender());
+	}
+
+	static int alphaBlend(byte *out, const byte *in, int width, int inStep, uint32 color) {
+		if (color == 0xffffffff)
+			return blitRow(out, in, width, inStep, AlphaBlender());
+		return blitRow(out, in, width, inStep, AlphaTintBlender(color));
+	}
+
+	static int additiveBlend(byte *out, const byte *in, int width, int inStep, uint32 color) {
+		if (color == 0xffffffff)
+			return blitRow(out, in, width, inStep, AdditiveBlender());
+		return blitRow(out, in, width, inStep, AdditiveTintBlender(color));
+	}
+
+	static int subtractiveBlend(byte *out, const byte *in, int width, int inStep, uint32 color) {
+		if (color == 0xffffffff)
+			return blitRow(out, in, width, inStep, SubtractiveBlender());
+		return blitRow(out, in, width, inStep, SubtractiveTintBlender(color));
+	}
+
+	static int multiplyBlend(byte *out, const byte *in, int width, int inStep, uint32 color) {
+		if (color == 0xffffffff)
+			return blitRow(out, in, width, inStep, MultiplyBlender());
+		return blitRow(out, in, width, inStep, MultiplyTintBlender(color));
+	}
+
+	static void getProcs(TransparentSurfaceSIMDProcs &procs) {
+		procs.opaque = opaque;
+		procs.binary = binary;
+		procs.alphaBlend = alphaBlend;
+		procs.additiveBlend = additiveBlend;
+		procs.subtractiveBlend = subtractiveBlend;
+		procs.multiplyBlend = multiplyBlend;
+	}
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -83,8 +83,10 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/cpudetect.h"
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_simd.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -203,6 +205,60 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	return _lookup;
 }
 
+void YUVToRGBManager::initLookup(const Graphics::PixelFormat &format, YUVToRGBManager::LuminanceScale scale) {
+	getLookup(format, scale);
+}
+
+/** Get the SIMD conversion functions for the CPU, returns false if there are none. */
+static bool getSIMDProcs(YUVToRGBSIMDProcs &procs) {
+	memset(&procs, 0, sizeof(procs));
+
+#ifdef SCUMMVM_AVX2
+	if (Common::hasCpuFeature(Common::kCpuFeatureAVX2)) {
+		getYUVToRGBProcsAVX2(procs);
+		return true;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (Common::hasCpuFeature(Common::kCpuFeatureSSE2)) {
+		getYUVToRGBProcsSSE2(procs);
+		return true;
+	}
+#endif
+#ifdef SCUMMVM_NEON
+	if (Common::hasCpuFeature(Common::kCpuFeatureNEON)) {
+		getYUVToRGBProcsNEON(procs);
+		return true;
+	}
+#endif
+
+	return false;
+}
+
+/**
+ * Convert the leading columns of an image with the SIMD function for the
+ * CPU, if there is one. Returns the number of columns converted.
+ */
+static int convertSIMD(YUVToRGBSIMDProc YUVToRGBSIMDProcs::*proc, Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	YUVToRGBSIMDProcs procs;
+	if (!getSIMDProcs(procs) || !(procs.*proc))
+		return 0;
+
+	YUVToRGBSIMDFormat format;
+	format.bytesPerPixel = dst->format.bytesPerPixel;
+	format.loss[0] = dst->format.rLoss;
+	format.loss[1] = dst->format.gLoss;
+	format.loss[2] = dst->format.bLoss;
+	format.loss[3] = dst->format.aLoss;
+	format.shift[0] = dst->format.rShift;
+	format.shift[1] = dst->format.gShift;
+	format.shift[2] = dst->format.bShift;
+	format.shift[3] = dst->format.aShift;
+	format.itu = scale == YUVToRGBManager::kScaleITU;
+
+	return (procs.*proc)((byte *)dst->getPixels(), dst->pitch, format, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
 #define PUT_PIXEL(s, d) \
 	L = &rgbToPix[(s)]; \
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
@@ -244,13 +300,22 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
 
+	// The SIMD code converts as many columns as it can, the tables do the rest
+	const int simdWidth = convertSIMD(&YUVToRGBSIMDProcs::convert444, dst, scale, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch);
+	if (simdWidth == yWidth)
+		return;
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	byte *dstPtr = (byte *)dst->getPixels() + simdWidth * dst->format.bytesPerPixel;
+	ySrc += simdWidth;
+	uSrc += simdWidth;
+	vSrc += simdWidth;
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV444ToRGB<uint16>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth - simdWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV444ToRGB<uint32>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth - simdWidth, yHeight, yPitch, uvPitch);
 }
 
 template<typename PixelInt>
@@ -285,7 +350,7 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 			dstPtr += sizeof(PixelInt);
 		}
 
-		dstPtr += dstPitch;
+		dstPtr += (dstPitch << 1) - yWidth * sizeof(PixelInt);
 		ySrc += (yPitch << 1) - yWidth;
 		uSrc += uvPitch - halfWidth;
 		vSrc += uvPitch - halfWidth;
@@ -300,13 +365,22 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
+	// The SIMD code converts as many columns as it can, the tables do the rest
+	const int simdWidth = convertSIMD(&YUVToRGBSIMDProcs::convert420, dst, scale, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch);
+	if (simdWidth == yWidth)
+		return;
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	byte *dstPtr = (byte *)dst->getPixels() + simdWidth * dst->format.bytesPerPixel;
+	ySrc += simdWidth;
+	uSrc += simdWidth / 2;
+	vSrc += simdWidth / 2;
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint16>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth - simdWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint32>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth - simdWidth, yHeight, yPitch, uvPitch);
 }
 
 #define PUT_PIXELA(s, a, d) \
@@ -348,7 +422,7 @@ void convertYUVA420ToRGBA(byte *dstPtr, int dstPitch, const YUVToRGBLookup *look
 			dstPtr += sizeof(PixelInt);
 		}
 
-		dstPtr += dstPitch;
+		dstPtr += (dstPitch << 1) - yWidth * sizeof(PixelInt);
 		ySrc += (yPitch << 1) - yWidth;
 		aSrc += (yPitch << 1) - yWidth;
 		uSrc += uvPitch - halfWidth;
@@ -364,13 +438,23 @@ void YUVToRGBManager::convert420Alpha(Graphics::Surface *dst, YUVToRGBManager::L
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
+	// The SIMD code converts as many columns as it can, the tables do the rest
+	const int simdWidth = convertSIMD(&YUVToRGBSIMDProcs::convert420, dst, scale, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+	if (simdWidth == yWidth)
+		return;
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale, true);
+	byte *dstPtr = (byte *)dst->getPixels() + simdWidth * dst->format.bytesPerPixel;
+	ySrc += simdWidth;
+	aSrc += simdWidth;
+	uSrc += simdWidth / 2;
+	vSrc += simdWidth / 2;
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUVA420ToRGBA<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUVA420ToRGBA<uint16>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth - simdWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUVA420ToRGBA<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUVA420ToRGBA<uint32>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth - simdWidth, yHeight, yPitch, uvPitch);
 }
 
 #define READ_QUAD(ptr, prefix) \
@@ -449,13 +533,22 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 3) == 0);
 	assert((yHeight & 3) == 0);
 
+	// The SIMD code converts as many columns as it can, the tables do the rest
+	const int simdWidth = convertSIMD(&YUVToRGBSIMDProcs::convert410, dst, scale, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch);
+	if (simdWidth == yWidth)
+		return;
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	byte *dstPtr = (byte *)dst->getPixels() + simdWidth * dst->format.bytesPerPixel;
+	ySrc += simdWidth;
+	uSrc += simdWidth / 4;
+	vSrc += simdWidth / 4;
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV410ToRGB<uint16>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth - simdWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV410ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV410ToRGB<uint32>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth - simdWidth, yHeight, yPitch, uvPitch);
 }
 
 } // End of namespace Graphics
@@ -121,6 +121,17 @@ public:
 	 */
 	void convert410(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/**
+	 * Create the lookup table for the given format and scale, which is
+	 * otherwise created by the first conversion. Conversions to this format
+	 * only read the table afterwards, so they may run on another thread as
+	 * long as no conversion to another format runs at the same time.
+	 *
+	 * @param format the format of the destination surfaces
+	 * @param scale  the scale of the luminance values
+	 */
+	void initLookup(const Graphics::PixelFormat &format, LuminanceScale scale);
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
@@ -0,0 +1,94 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/endian.h"
+#include "graphics/yuv_to_rgb_simd.h"
+
+#include <immintrin.h>
+
+namespace {
+
+struct AVX2Ops {
+	typedef __m256i V;
+	enum { kPixels = 16 };
+
+	static FORCEINLINE V combine(__m128i low, __m128i high) {
+		return _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+	}
+
+	static FORCEINLINE V loadBytes(const byte *p) {
+		return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)p));
+	}
+
+	static FORCEINLINE V loadBytesDup2(const byte *p) {
+		const __m128i v = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)p));
+		return combine(_mm_unpacklo_epi16(v, v), _mm_unpackhi_epi16(v, v));
+	}
+
+	static FORCEINLINE V loadBytesDup4(const byte *p) {
+		__m128i v = _mm_cvtepu8_epi16(_mm_cvtsi32_si128(READ_UINT32(p)));
+		v = _mm_unpacklo_epi16(v, v);
+		return combine(_mm_unpacklo_epi32(v, v), _mm_unpackhi_epi32(v, v));
+	}
+
+	static FORCEINLINE V set1(int x) { return _mm256_set1_epi16((short)x); }
+	static FORCEINLINE V xDiffLanes() { return _mm256_set_epi16(3, 2, 1, 0, 3, 2, 1, 0, 3, 2, 1, 0, 3, 2, 1, 0); }
+	static FORCEINLINE V or_(V a, V b) { return _mm256_or_si256(a, b); }
+	static FORCEINLINE V xor_(V a, V b) { return _mm256_xor_si256(a, b); }
+	static FORCEINLINE V add(V a, V b) { return _mm256_add_epi16(a, b); }
+	static FORCEINLINE V sub(V a, V b) { return _mm256_sub_epi16(a, b); }
+	static FORCEINLINE V mullo(V a, V b) { return _mm256_mullo_epi16(a, b); }
+	static FORCEINLINE V mulhi(V a, V b) { return _mm256_mulhi_epi16(a, b); }
+	static FORCEINLINE V min(V a, V b) { return _mm256_min_epi16(a, b); }
+	static FORCEINLINE V max(V a, V b) { return _mm256_max_epi16(a, b); }
+	static FORCEINLINE V slli(V a, int n) { return _mm256_slli_epi16(a, n); }
+	static FORCEINLINE V srli(V a, int n) { return _mm256_srli_epi16(a, n); }
+	static FORCEINLINE V srai(V a, int n) { return _mm256_srai_epi16(a, n); }
+	static FORCEINLINE V sll(V a, int n) { return _mm256_sll_epi16(a, _mm_cvtsi32_si128(n)); }
+	static FORCEINLINE V srl(V a, int n) { return _mm256_srl_epi16(a, _mm_cvtsi32_si128(n)); }
+
+	static FORCEINLINE void store16(uint16 *p, V v) { _mm256_storeu_si256((__m256i *)p, v); }
+
+	static FORCEINLINE void store32(uint32 *p, V r, V g, V b, V a, const int *shift) {
+		const V channels[4] = { r, g, b, a };
+		V low = _mm256_setzero_si256(), high = _mm256_setzero_si256();
+		for (int i = 0; i < 4; i++) {
+			const __m128i count = _mm_cvtsi32_si128(shift[i]);
+			low = _mm256_or_si256(low, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(channels[i])), count));
+			high = _mm256_or_si256(high, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(channels[i], 1)), count));
+		}
+		_mm256_storeu_si256((__m256i *)p, low);
+		_mm256_storeu_si256((__m256i *)(p + 8), high);
+	}
+};
+
+} // End of anonymous namespace
+
+#include "graphics/yuv_to_rgb_simd_impl.h"
+
+namespace Graphics {
+
+void getYUVToRGBProcsAVX2(YUVToRGBSIMDProcs &procs) {
+	YUVToRGBKernels<AVX2Ops>::getProcs(procs);
+}
+
+} // End of namespace Graphics
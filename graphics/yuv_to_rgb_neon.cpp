@@ -0,0 +1,110 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_simd.h"
+
+#include <arm_neon.h>
+#include <string.h>
+
+namespace {
+
+struct NEONOps {
+	typedef int16x8_t V;
+	enum { kPixels = 8 };
+
+	static FORCEINLINE V loadBytes(const byte *p) {
+		return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(p)));
+	}
+
+	static FORCEINLINE V loadBytesDup2(const byte *p) {
+		uint32 bytes;
+		memcpy(&bytes, p, sizeof(bytes));
+		const V v = vreinterpretq_s16_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(bytes))));
+		return vzipq_s16(v, v).val[0];
+	}
+
+	static FORCEINLINE V loadBytesDup4(const byte *p) {
+		uint16 bytes;
+		memcpy(&bytes, p, sizeof(bytes));
+		V v = vreinterpretq_s16_u16(vmovl_u8(vreinterpret_u8_u16(vdup_n_u16(bytes))));
+		v = vzipq_s16(v, v).val[0];
+		return vzipq_s16(v, v).val[0];
+	}
+
+	static FORCEINLINE V set1(int x) { return vdupq_n_s16((int16)x); }
+
+	static FORCEINLINE V xDiffLanes() {
+		static const int16 lanes[8] = { 0, 1, 2, 3, 0, 1, 2, 3 };
+		return vld1q_s16(lanes);
+	}
+
+	static FORCEINLINE V or_(V a, V b) { return vorrq_s16(a, b); }
+	static FORCEINLINE V xor_(V a, V b) { return veorq_s16(a, b); }
+	static FORCEINLINE V add(V a, V b) { return vaddq_s16(a, b); }
+	static FORCEINLINE V sub(V a, V b) { return vsubq_s16(a, b); }
+	static FORCEINLINE V mullo(V a, V b) { return vmulq_s16(a, b); }
+
+	static FORCEINLINE V mulhi(V a, V b) {
+		const int32x4_t low = vmull_s16(vget_low_s16(a), vget_low_s16(b));
+		const int32x4_t high = vmull_s16(vget_high_s16(a), vget_high_s16(b));
+		return vcombine_s16(vshrn_n_s32(low, 16), vshrn_n_s32(high, 16));
+	}
+
+	static FORCEINLINE V min(V a, V b) { return vminq_s16(a, b); }
+	static FORCEINLINE V max(V a, V b) { return vmaxq_s16(a, b); }
+	static FORCEINLINE V slli(V a, int n) { return vshlq_s16(a, vdupq_n_s16((int16)n)); }
+	static FORCEINLINE V srli(V a, int n) { return sll(a, -n); }
+	static FORCEINLINE V srai(V a, int n) { return vshlq_s16(a, vdupq_n_s16((int16)-n)); }
+
+	static FORCEINLINE V sll(V a, int n) {
+		return vreinterpretq_s16_u16(vshlq_u16(vreinterpretq_u16_s16(a), vdupq_n_s16((int16)n)));
+	}
+
+	static FORCEINLINE V srl(V a, int n) { return sll(a, -n); }
+
+	static FORCEINLINE void store16(uint16 *p, V v) { vst1q_u16(p, vreinterpretq_u16_s16(v)); }
+
+	static FORCEINLINE void store32(uint32 *p, V r, V g, V b, V a, const int *shift) {
+		const V channels[4] = { r, g, b, a };
+		uint32x4_t low = vdupq_n_u32(0), high = vdupq_n_u32(0);
+		for (int i = 0; i < 4; i++) {
+			const uint16x8_t c = vreinterpretq_u16_s16(channels[i]);
+			const int32x4_t count = vdupq_n_s32(shift[i]);
+			low = vorrq_u32(low, vshlq_u32(vmovl_u16(vget_low_u16(c)), count));
+			high = vorrq_u32(high, vshlq_u32(vmovl_u16(vget_high_u16(c)), count));
+		}
+		vst1q_u32(p, low);
+		vst1q_u32(p + 4, high);
+	}
+};
+
+} // End of anonymous namespace
+
+#include "graphics/yuv_to_rgb_simd_impl.h"
+
+namespace Graphics {
+
+void getYUVToRGBProcsNEON(YUVToRGBSIMDProcs &procs) {
+	YUVToRGBKernels<NEONOps>::getProcs(procs);
+}
+
+} // End of namespace Graphics
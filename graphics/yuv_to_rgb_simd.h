@@ -0,0 +1,70 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_SIMD_H
+#define GRAPHICS_YUV_TO_RGB_SIMD_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * The destination of a SIMD YUV to RGB conversion. Channels are stored
+ * as ((value >> loss) << shift), in the order red, green, blue, alpha,
+ * like PixelFormat::ARGBToColor() does.
+ */
+struct YUVToRGBSIMDFormat {
+	int bytesPerPixel;
+	int loss[4];
+	int shift[4];
+	bool itu; ///< Luminance values range from [16, 235]
+};
+
+/**
+ * Convert the leading columns of a YUV image, with the arguments of the
+ * convertYUV*ToRGB() functions. SIMD kernels work on whole vectors, so
+ * they return how many columns they converted and leave the rest of each
+ * row to the lookup table code. aSrc is nullptr for opaque images.
+ */
+typedef int (*YUVToRGBSIMDProc)(byte *dstPtr, int dstPitch, const YUVToRGBSIMDFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+
+struct YUVToRGBSIMDProcs {
+	YUVToRGBSIMDProc convert444;
+	YUVToRGBSIMDProc convert420;
+	YUVToRGBSIMDProc convert410;
+};
+
+#ifdef SCUMMVM_SSE2
+void getYUVToRGBProcsSSE2(YUVToRGBSIMDProcs &procs);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void getYUVToRGBProcsAVX2(YUVToRGBSIMDProcs &procs);
+#endif
+
+#ifdef SCUMMVM_NEON
+void getYUVToRGBProcsNEON(YUVToRGBSIMDProcs &procs);
+#endif
+
+} // End of namespace Graphics
+
+#endif
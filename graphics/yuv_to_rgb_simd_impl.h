@@ -0,0 +1,224 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * The SIMD YUV to RGB kernels, written once against a small set of vector
+ * operations. Each yuv_to_rgb_*.cpp file defines those operations for its
+ * instruction set and includes this file, which must not be included
+ * anywhere else: it is compiled with different code generation flags
+ * every time.
+ *
+ * An Ops class provides, for vectors V of kPixels signed 16 bit lanes:
+ *   loadBytes() which zero extends kPixels bytes, loadBytesDup2() and
+ *   loadBytesDup4() which load kPixels / 2 resp. kPixels / 4 bytes and
+ *   repeat each of them 2 resp. 4 times, set1(), xDiffLanes() which holds
+ *   the index of each lane modulo 4, or_(), xor_(), add(), sub(), mullo(),
+ *   mulhi() (the high half of the signed product), min(), max(), slli(),
+ *   srli(), srai(), sll() and srl() (shift by a count which is not a
+ *   constant), store16() and store32() which shifts the channels to their
+ *   places in 32 bit pixels and stores them.
+ *
+ * The lookup tables of YUVToRGBManager add truncated products of the
+ * chroma values to the luminance and clamp the sums. The kernels compute
+ * the products with fixed point constants which give exactly the same
+ * truncated values for all chroma values, so they produce the same pixels
+ * as the lookup table code.
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_SIMD_IMPL_H
+#define GRAPHICS_YUV_TO_RGB_SIMD_IMPL_H
+
+#include "graphics/yuv_to_rgb_simd.h"
+
+namespace Graphics {
+
+template<class Ops>
+struct YUVToRGBKernels {
+	typedef typename Ops::V V;
+
+	/** Compute (int)(k * a) for a in [-128, 127], where k = m / 2^(16 - preShift). */
+	static FORCEINLINE V truncMul(V a, int preShift, int m) {
+		const V sign = Ops::srai(a, 15);
+		const V abs = Ops::sub(Ops::xor_(a, sign), sign);
+		const V product = Ops::mulhi(Ops::slli(abs, preShift), Ops::set1(m));
+		return Ops::sub(Ops::xor_(product, sign), sign);
+	}
+
+	/** The chroma terms of the Cr_r_tab, Cr_g_tab, Cb_g_tab and Cb_b_tab tables. */
+	static FORCEINLINE void chroma(V u, V v, V &dR, V &dG, V &dB) {
+		const V cb = Ops::sub(u, Ops::set1(128));
+		const V cr = Ops::sub(v, Ops::set1(128));
+		dR = truncMul(cr, 7, 717);      // 0.419 / 0.299
+		dG = Ops::sub(Ops::sub(Ops::set1(0), truncMul(cr, 6, 731)),  // 0.299 / 0.419
+		              truncMul(cb, 3, 2821));                         // 0.114 / 0.331
+		dB = truncMul(cb, 2, 29055);    // 0.587 / 0.331
+	}
+
+	/** The 8 bit value of a channel, as stored in the rgbToPix table. */
+	static FORCEINLINE V channel(V y, V d, bool itu) {
+		const V sum = Ops::add(y, d);
+		if (!itu)
+			return Ops::min(Ops::max(sum, Ops::set1(0)), Ops::set1(255));
+
+		// (value - 16) * 255 / 219
+		const V value = Ops::sub(Ops::min(Ops::max(sum, Ops::set1(16)), Ops::set1(235)), Ops::set1(16));
+		return Ops::mulhi(Ops::slli(value, 3), Ops::set1(9539));
+	}
+
+	static FORCEINLINE void putPixels(uint16 *dst, V y, V a, V dR, V dG, V dB, const YUVToRGBSIMDFormat &format) {
+		V pixels = Ops::sll(Ops::srl(channel(y, dR, format.itu), format.loss[0]), format.shift[0]);
+		pixels = Ops::or_(pixels, Ops::sll(Ops::srl(channel(y, dG, format.itu), format.loss[1]), format.shift[1]));
+		pixels = Ops::or_(pixels, Ops::sll(Ops::srl(channel(y, dB, format.itu), format.loss[2]), format.shift[2]));
+		pixels = Ops::or_(pixels, Ops::sll(Ops::srl(a, format.loss[3]), format.shift[3]));
+		Ops::store16(dst, pixels);
+	}
+
+	static FORCEINLINE void putPixels(uint32 *dst, V y, V a, V dR, V dG, V dB, const YUVToRGBSIMDFormat &format) {
+		Ops::store32(dst,
+		             Ops::srl(channel(y, dR, format.itu), format.loss[0]),
+		             Ops::srl(channel(y, dG, format.itu), format.loss[1]),
+		             Ops::srl(channel(y, dB, format.itu), format.loss[2]),
+		             Ops::srl(a, format.loss[3]), format.shift);
+	}
+
+	template<typename PixelInt>
+	static int convert444(byte *dstPtr, int dstPitch, const YUVToRGBSIMDFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+		const int width = yWidth & ~(Ops::kPixels - 1);
+		const V opaque = Ops::set1(255);
+
+		for (int h = 0; h < yHeight; h++) {
+			PixelInt *dst = (PixelInt *)dstPtr;
+
+			for (int x = 0; x < width; x += Ops::kPixels) {
+				V dR, dG, dB;
+				chroma(Ops::loadBytes(uSrc + x), Ops::loadBytes(vSrc + x), dR, dG, dB);
+				putPixels(dst + x, Ops::loadBytes(ySrc + x), opaque, dR, dG, dB, format);
+			}
+
+			dstPtr += dstPitch;
+			ySrc += yPitch;
+			uSrc += uvPitch;
+			vSrc += uvPitch;
+		}
+
+		return width;
+	}
+
+	template<typename PixelInt>
+	static int convert420(byte *dstPtr, int dstPitch, const YUVToRGBSIMDFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+		const int width = yWidth & ~(Ops::kPixels - 1);
+		const V opaque = Ops::set1(255);
+
+		for (int h = 0; h < yHeight / 2; h++) {
+			PixelInt *dst0 = (PixelInt *)dstPtr;
+			PixelInt *dst1 = (PixelInt *)(dstPtr + dstPitch);
+
+			for (int x = 0; x < width; x += Ops::kPixels) {
+				V dR, dG, dB;
+				chroma(Ops::loadBytesDup2(uSrc + x / 2), Ops::loadBytesDup2(vSrc + x / 2), dR, dG, dB);
+
+				const V a0 = aSrc ? Ops::loadBytes(aSrc + x) : opaque;
+				const V a1 = aSrc ? Ops::loadBytes(aSrc + yPitch + x) : opaque;
+				putPixels(dst0 + x, Ops::loadBytes(ySrc + x), a0, dR, dG, dB, format);
+				putPixels(dst1 + x, Ops::loadBytes(ySrc + yPitch + x), a1, dR, dG, dB, format);
+			}
+
+			dstPtr += dstPitch * 2;
+			ySrc += yPitch * 2;
+			if (aSrc)
+				aSrc += yPitch * 2;
+			uSrc += uvPitch;
+			vSrc += uvPitch;
+		}
+
+		return width;
+	}
+
+	/** Bilinear interpolation of the chroma samples around 4 pixels, like DO_INTERPOLATION(). */
+	static FORCEINLINE V interpolate(const byte *src, int uvPitch, V wA, V wB, V wC, V wD) {
+		V sum = Ops::mullo(Ops::loadBytesDup4(src), wA);
+		sum = Ops::add(sum, Ops::mullo(Ops::loadBytesDup4(src + 1), wB));
+		sum = Ops::add(sum, Ops::mullo(Ops::loadBytesDup4(src + uvPitch), wC));
+		sum = Ops::add(sum, Ops::mullo(Ops::loadBytesDup4(src + uvPitch + 1), wD));
+		return Ops::srli(sum, 4);
+	}
+
+	template<typename PixelInt>
+	static int convert410(byte *dstPtr, int dstPitch, const YUVToRGBSIMDFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+		const int width = yWidth & ~(Ops::kPixels - 1);
+		const V opaque = Ops::set1(255);
+		const V xDiff = Ops::xDiffLanes();
+		const V xDiffInv = Ops::sub(Ops::set1(4), xDiff);
+
+		for (int y = 0; y < yHeight; y++) {
+			PixelInt *dst = (PixelInt *)dstPtr;
+			const int yDiff = y & 3;
+			const int index = (y >> 2) * uvPitch;
+			const V wA = Ops::mullo(xDiffInv, Ops::set1(4 - yDiff));
+			const V wB = Ops::mullo(xDiff, Ops::set1(4 - yDiff));
+			const V wC = Ops::mullo(xDiffInv, Ops::set1(yDiff));
+			const V wD = Ops::mullo(xDiff, Ops::set1(yDiff));
+
+			for (int x = 0; x < width; x += Ops::kPixels) {
+				const V u = interpolate(uSrc + index + x / 4, uvPitch, wA, wB, wC, wD);
+				const V v = interpolate(vSrc + index + x / 4, uvPitch, wA, wB, wC, wD);
+
+				V dR, dG, dB;
+				chroma(u, v, dR, dG, dB);
+				putPixels(dst + x, Ops::loadBytes(ySrc + x), opaque, dR, dG, dB, format);
+			}
+
+			dstPtr += dstPitch;
+			ySrc += yPitch;
+		}
+
+		return width;
+	}
+
+	static int convert444Proc(byte *dstPtr, int dstPitch, const YUVToRGBSIMDFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+		if (format.bytesPerPixel == 2)
+			return convert444<uint16>(dstPtr, dstPitch, format, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return convert444<uint32>(dstPtr, dstPitch, format, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	}
+
+	static int convert420Proc(byte *dstPtr, int dstPitch, const YUVToRGBSIMDFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+		if (format.bytesPerPixel == 2)
+			return convert420<uint16>(dstPtr, dstPitch, format, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		return convert420<uint32>(dstPtr, dstPitch, format, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+	}
+
+	static int convert410Proc(byte *dstPtr, int dstPitch, const YUVToRGBSIMDFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+		if (format.bytesPerPixel == 2)
+			return convert410<uint16>(dstPtr, dstPitch, format, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return convert410<uint32>(dstPtr, dstPitch, format, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	}
+
+	static void getProcs(YUVToRGBSIMDProcs &procs) {
+		procs.convert444 = convert444Proc;
+		procs.convert420 = convert420Proc;
+		procs.convert410 = convert410Proc;
+	}
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -30,9 +30,11 @@
 #include "graphics/yuv_to_rgb.h"
 #include "common/system.h"
 #include "common/algorithm.h"
+#include "common/cpudetect.h"
 #include "common/rect.h"
 #include "common/textconsole.h"
 #include "common/util.h"
+#include "common/workerpool.h"
 
 namespace Image {
 namespace Indeo {
@@ -186,7 +188,8 @@ IVIMbInfo::IVIMbInfo() : _xPos(0), _yPos(0), _bufOffs(0), _type(0), _cbp(0),
 /*------------------------------------------------------------------------*/
 
 IVITile::IVITile() : _xPos(0), _yPos(0), _width(0), _height(0), _mbSize(0),
-		_isEmpty(false), _dataSize(0), _numMBs(0), _mbs(nullptr), _refMbs(nullptr) {
+		_isEmpty(false), _dataSize(0), _dataPos(0), _dataEnd(0), _numMBs(0),
+		_mbs(nullptr), _refMbs(nullptr) {
 }
 
 /*------------------------------------------------------------------------*/
@@ -196,8 +199,8 @@ IVIBandDesc::IVIBandDesc() : _plane(0), _bandNum(0), _width(0), _height(0),
 		_refBuf(nullptr), _bRefBuf(nullptr), _pitch(0), _isEmpty(false),
 		_mbSize(0), _blkSize(0), _isHalfpel(false), _inheritMv(false), _bufSize(0),
 		_inheritQDelta(false), _qdeltaPresent(false), _quantMat(0), _globQuant(0),
-		_scan(nullptr), _scanSize(0), _numCorr(0), _rvmapSel(0), _rvMap(nullptr),
-		_numTiles(0), _tiles(nullptr), _invTransform(nullptr), _transformSize(0),
+		_scan(nullptr), _scanSize(0), _numCorr(0), _rvmapSel(0), _numTiles(0),
+		_tiles(nullptr), _invTransform(nullptr), _blockTransform(nullptr), _transformSize(0),
 		_dcTransform(nullptr), _is2dTrans(0), _checksum(0), _checksumPresent(false),
 		_intraBase(nullptr), _interBase(nullptr), _intraScale(nullptr),
 		_interScale(nullptr) {
@@ -464,6 +467,50 @@ IVI45DecContext::IVI45DecContext() : _gb(nullptr), _frameNum(0), _frameType(0),
 
 /*------------------------------------------------------------------------*/
 
+/** Get the SIMD DSP functions for the CPU. */
+static void getSIMDProcs(IndeoSIMDProcs &procs) {
+	memset(&procs, 0, sizeof(procs));
+
+#ifdef SCUMMVM_AVX2
+	if (Common::hasCpuFeature(Common::kCpuFeatureAVX2)) {
+		getIndeoSIMDProcsAVX2(procs);
+		return;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (Common::hasCpuFeature(Common::kCpuFeatureSSE2)) {
+		getIndeoSIMDProcsSSE2(procs);
+		return;
+	}
+#endif
+#ifdef SCUMMVM_NEON
+	if (Common::hasCpuFeature(Common::kCpuFeatureNEON)) {
+		getIndeoSIMDProcsNEON(procs);
+		return;
+	}
+#endif
+}
+
+/** Get the SIMD version of an inverse transform, or the transform itself if there is none. */
+static InvTransformPtr *getSIMDTransform(const IndeoSIMDProcs &procs, InvTransformPtr *transform) {
+	InvTransformPtr *simd = nullptr;
+
+	if (transform == IndeoDSP::ffIviInverseHaar8x8)
+		simd = procs.inverseHaar8x8;
+	else if (transform == IndeoDSP::ffIviRowHaar8)
+		simd = procs.rowHaar8;
+	else if (transform == IndeoDSP::ffIviColHaar8)
+		simd = procs.colHaar8;
+	else if (transform == IndeoDSP::ffIviInverseSlant8x8)
+		simd = procs.inverseSlant8x8;
+	else if (transform == IndeoDSP::ffIviRowSlant8)
+		simd = procs.rowSlant8;
+	else if (transform == IndeoDSP::ffIviColSlant8)
+		simd = procs.colSlant8;
+
+	return simd ? simd : transform;
+}
+
 IndeoDecoderBase::IndeoDecoderBase(uint16 width, uint16 height, uint bitsPerPixel) : Codec() {
 	_pixelFormat = g_system->getScreenFormat();
 
@@ -490,9 +537,13 @@ IndeoDecoderBase::IndeoDecoderBase(uint16 width, uint16 height, uint bitsPerPixe
 	_surface.create(width, height, _pixelFormat);
 	_surface.fillRect(Common::Rect(0, 0, width, height), (bitsPerPixel == 32) ? 0xff : 0);
 	_ctx._bRefBuf = 3; // buffer 2 is used for scalability mode
+
+	_workerPool = new Common::WorkerPool();
+	getSIMDProcs(_simd);
 }
 
 IndeoDecoderBase::~IndeoDecoderBase() {
+	delete _workerPool;
 	_surface.free();
 	IVIPlaneDesc::freeBuffers(_ctx._planes);
 	if (_ctx._mbVlc._custTab._table)
@@ -536,15 +587,9 @@ int IndeoDecoderBase::decodeIndeoFrame() {
 
 	if (isNonNullFrame()) {
 		_ctx._bufInvalid[_ctx._dstBuf] = 1;
-		for (int p = 0; p < 3; p++) {
-			for (int b = 0; b < _ctx._planes[p]._numBands; b++) {
-				result = decode_band(&_ctx._planes[p]._bands[b]);
-				if (result < 0) {
-					warning("Error while decoding band: %d, _plane: %d", b, p);
-					return result;
-				}
-			}
-		}
+		result = decodePlanes();
+		if (result < 0)
+			return result;
 		_ctx._bufInvalid[_ctx._dstBuf] = 0;
 	} else {
 		if (_ctx._isScalable)
@@ -620,6 +665,32 @@ int IndeoDecoderBase::decodeIndeoFrame() {
 	return 0;
 }
 
+int IndeoDecoderBase::decodePlanes() {
+	for (int p = 0; p < 3; p++) {
+		for (int b = 0; b < _ctx._planes[p]._numBands; b++) {
+			int result = decode_band(&_ctx._planes[p]._bands[b]);
+			if (result < 0) {
+				warning("Error while decoding band: %d, _plane: %d", b, p);
+				return result;
+			}
+		}
+	}
+
+	// All other bands may inherit the macroblock info of the first luma band
+	bool parallel = addTileJobs(&_ctx._planes[0]._bands[0]);
+	int result = runTileJobs(parallel);
+	if (result < 0)
+		return result;
+
+	parallel = true;
+	for (int p = 0; p < 3; p++) {
+		for (int b = !p; b < _ctx._planes[p]._numBands; b++)
+			parallel &= addTileJobs(&_ctx._planes[p]._bands[b]);
+	}
+
+	return runTileJobs(parallel);
+}
+
 int IndeoDecoderBase::decode_band(IVIBandDesc *band) {
 	band->_buf = band->_bufs[_ctx._dstBuf];
 	if (!band->_buf) {
@@ -647,21 +718,24 @@ int IndeoDecoderBase::decode_band(IVIBandDesc *band) {
 		return -1;
 	}
 
-	band->_rvMap = &_ctx._rvmapTabs[band->_rvmapSel];
+	band->_blockTransform = getSIMDTransform(_simd, band->_invTransform);
 
-	// apply corrections to the selected rvmap table if present
+	// take a copy of the selected rvmap table, with the corrections
+	// applied if present
+	band->_rvMap = _ctx._rvmapTabs[band->_rvmapSel];
 	for (int i = 0; i < band->_numCorr; i++) {
 		int idx1 = band->_corr[i * 2];
 		int idx2 = band->_corr[i * 2 + 1];
-		SWAP(band->_rvMap->_runtab[idx1], band->_rvMap->_runtab[idx2]);
-		SWAP(band->_rvMap->_valtab[idx1], band->_rvMap->_valtab[idx2]);
-		if (idx1 == band->_rvMap->_eobSym || idx2 == band->_rvMap->_eobSym)
-			band->_rvMap->_eobSym ^= idx1 ^ idx2;
-		if (idx1 == band->_rvMap->_escSym || idx2 == band->_rvMap->_escSym)
-			band->_rvMap->_escSym ^= idx1 ^ idx2;
+		SWAP(band->_rvMap._runtab[idx1], band->_rvMap._runtab[idx2]);
+		SWAP(band->_rvMap._valtab[idx1], band->_rvMap._valtab[idx2]);
+		if (idx1 == band->_rvMap._eobSym || idx2 == band->_rvMap._eobSym)
+			band->_rvMap._eobSym ^= idx1 ^ idx2;
+		if (idx1 == band->_rvMap._escSym || idx2 == band->_rvMap._escSym)
+			band->_rvMap._escSym ^= idx1 ^ idx2;
 	}
 
-	int pos = _ctx._gb->pos();
+	// locate the data of the tiles, they are decoded later on
+	uint32 pos = _ctx._gb->pos();
 
 	for (int t = 0; t < band->_numTiles; t++) {
 		IVITile *tile = &band->_tiles[t];
@@ -673,10 +747,6 @@ int IndeoDecoderBase::decode_band(IVIBandDesc *band) {
 		}
 		tile->_isEmpty = _ctx._gb->getBit();
 		if (tile->_isEmpty) {
-			result = processEmptyTile(band, tile,
-				(_ctx._planes[0]._bands[0]._mbSize >> 3) - (band->_mbSize >> 3));
-			if (result < 0)
-				break;
 			warning("Empty tile encountered!");
 		} else {
 			tile->_dataSize = decodeTileDataSize(_ctx._gb);
@@ -686,44 +756,99 @@ int IndeoDecoderBase::decode_band(IVIBandDesc *band) {
 				break;
 			}
 
-			result = decodeMbInfo(band, tile);
-			if (result < 0)
-				break;
-
-			result = decodeBlocks(_ctx._gb, band, tile);
-			if (result < 0) {
-				warning("Corrupted tile data encountered!");
-				break;
-			}
-
-			if ((((int)_ctx._gb->pos() - pos) >> 3) != tile->_dataSize) {
+			tile->_dataPos = _ctx._gb->pos();
+			tile->_dataEnd = pos + (tile->_dataSize << 3);
+			if (tile->_dataEnd < tile->_dataPos) {
 				warning("Tile _dataSize mismatch!");
 				result = -1;
 				break;
 			}
 
-			pos += tile->_dataSize << 3; // skip to next tile
+			_ctx._gb->skip(tile->_dataEnd - tile->_dataPos); // skip to next tile
+			pos = tile->_dataEnd;
 		}
 	}
 
-	// restore the selected rvmap table by applying its corrections in
-	// reverse order
-	for (int i = band->_numCorr - 1; i >= 0; i--) {
-		int idx1 = band->_corr[i * 2];
-		int idx2 = band->_corr[i * 2 + 1];
-		SWAP(band->_rvMap->_runtab[idx1], band->_rvMap->_runtab[idx2]);
-		SWAP(band->_rvMap->_valtab[idx1], band->_rvMap->_valtab[idx2]);
-		if (idx1 == band->_rvMap->_eobSym || idx2 == band->_rvMap->_eobSym)
-			band->_rvMap->_eobSym ^= idx1 ^ idx2;
-		if (idx1 == band->_rvMap->_escSym || idx2 == band->_rvMap->_escSym)
-			band->_rvMap->_escSym ^= idx1 ^ idx2;
+	_ctx._gb->align();
+
+	return result;
+}
+
+bool IndeoDecoderBase::addTileJobs(IVIBandDesc *band) {
+	bool independent = true;
+
+	for (int t = 0; t < band->_numTiles; t++) {
+		TileJob job;
+		job.band = band;
+		job.tile = &band->_tiles[t];
+		job.result = 0;
+		_tileJobs.push_back(job);
+
+		// the last macroblocks of a tile overlap the next tile unless it
+		// starts on a macroblock boundary
+		if (job.tile->_xPos % band->_mbSize || job.tile->_yPos % band->_mbSize)
+			independent = false;
 	}
 
-	_ctx._gb->align();
+	return independent;
+}
 
+int IndeoDecoderBase::runTileJobs(bool parallel) {
+	if (parallel) {
+		_workerPool->run(decodeTileJob, this, _tileJobs.size());
+	} else {
+		for (uint i = 0; i < _tileJobs.size(); i++)
+			decodeTileJob(this, i);
+	}
+
+	int result = 0;
+	for (uint i = 0; i < _tileJobs.size(); i++) {
+		if (_tileJobs[i].result < 0) {
+			warning("Error while decoding band: %d, _plane: %d",
+				_tileJobs[i].band->_bandNum, _tileJobs[i].band->_plane);
+			result = _tileJobs[i].result;
+			break;
+		}
+	}
+
+	_tileJobs.clear();
 	return result;
 }
 
+void IndeoDecoderBase::decodeTileJob(void *param, uint job) {
+	IndeoDecoderBase *decoder = (IndeoDecoderBase *)param;
+	TileJob &tileJob = decoder->_tileJobs[job];
+
+	tileJob.result = decoder->decodeTile(tileJob.band, tileJob.tile);
+}
+
+int IndeoDecoderBase::decodeTile(IVIBandDesc *band, IVITile *tile) {
+	if (tile->_isEmpty) {
+		return processEmptyTile(band, tile,
+			(_ctx._planes[0]._bands[0]._mbSize >> 3) - (band->_mbSize >> 3));
+	}
+
+	GetBits gb(_ctx._frameData, _ctx._frameSize);
+	gb.skip(tile->_dataPos);
+
+	int result = decodeMbInfo(&gb, band, tile);
+	if (result < 0)
+		return result;
+
+	result = decodeBlocks(&gb, band, tile);
+	if (result < 0) {
+		warning("Corrupted tile data encountered!");
+		return result;
+	}
+
+	if (gb.pos() != tile->_dataEnd) {
+		warning("Tile _dataSize mismatch!");
+		return -1;
+	}
+
+	return 0;
+}
+
 void IndeoDecoderBase::recomposeHaar(const IVIPlaneDesc *_plane,
 		uint8 *dst, const int dstPitch) {
 
@@ -927,8 +1052,12 @@ void IndeoDecoderBase::outputPlane(IVIPlaneDesc *_plane, uint8 *dst, int dstPitc
 		return;
 
 	for (int y = 0; y < _plane->_height; y++) {
-		for (int x = 0; x < _plane->_width; x++)
-			dst[x] = avClipUint8(src[x] + 128);
+		if (_simd.outputRow) {
+			_simd.outputRow(src, dst, _plane->_width);
+		} else {
+			for (int x = 0; x < _plane->_width; x++)
+				dst[x] = avClipUint8(src[x] + 128);
+		}
 		src += pitch;
 		dst += dstPitch;
 	}
@@ -1008,6 +1137,10 @@ int IndeoDecoderBase::processEmptyTile(IVIBandDesc *band,
 		int numBlocks = (band->_mbSize != band->_blkSize) ? 4 : 1; // number of blocks per mb
 		IviMCFunc mcNoDeltaFunc = (band->_blkSize == 8) ? IndeoDSP::ffIviMc8x8NoDelta
 			: IndeoDSP::ffIviMc4x4NoDelta;
+		if (band->_blkSize == 8 && _simd.mc8x8NoDelta)
+			mcNoDeltaFunc = _simd.mc8x8NoDelta;
+		else if (band->_blkSize != 8 && _simd.mc4x4NoDelta)
+			mcNoDeltaFunc = _simd.mc4x4NoDelta;
 
 		int mbn;
 		for (mbn = 0, mb = tile->_mbs; mbn < tile->_numMBs; mb++, mbn++) {
@@ -1073,11 +1206,21 @@ int IndeoDecoderBase::decodeBlocks(GetBits *_gb, IVIBandDesc *band, IVITile *til
 	IviMCFunc mcWithDeltaFunc, mcNoDeltaFunc;
 	IviMCAvgFunc mcAvgWithDeltaFunc, mcAvgNoDeltaFunc;
 
-	if (blkSize == 8) {
+	if (blkSize == 8 && _simd.mc8x8Delta) {
+		mcWithDeltaFunc     = _simd.mc8x8Delta;
+		mcNoDeltaFunc       = _simd.mc8x8NoDelta;
+		mcAvgWithDeltaFunc = _simd.mcAvg8x8Delta;
+		mcAvgNoDeltaFunc   = _simd.mcAvg8x8NoDelta;
+	} else if (blkSize == 8) {
 		mcWithDeltaFunc     = IndeoDSP::ffIviMc8x8Delta;
 		mcNoDeltaFunc       = IndeoDSP::ffIviMc8x8NoDelta;
 		mcAvgWithDeltaFunc = IndeoDSP::ffIviMcAvg8x8Delta;
 		mcAvgNoDeltaFunc   = IndeoDSP::ffIviMcAvg8x8NoDelta;
+	} else if (_simd.mc4x4Delta) {
+		mcWithDeltaFunc     = _simd.mc4x4Delta;
+		mcNoDeltaFunc       = _simd.mc4x4NoDelta;
+		mcAvgWithDeltaFunc = _simd.mcAvg4x4Delta;
+		mcAvgNoDeltaFunc   = _simd.mcAvg4x4NoDelta;
 	} else {
 		mcWithDeltaFunc     = IndeoDSP::ffIviMc4x4Delta;
 		mcNoDeltaFunc       = IndeoDSP::ffIviMc4x4NoDelta;
@@ -1240,7 +1383,7 @@ int IndeoDecoderBase::decodeCodedBlocks(GetBits *gb, IVIBandDesc *band,
 		int mvX2, int mvY2, int32 *prevDc, int isIntra,
 		int mcType, int mcType2, uint32 quant, int offs) {
 	const uint16 *baseTab = isIntra ? band->_intraBase : band->_interBase;
-	RVMapDesc *rvmap = band->_rvMap;
+	const RVMapDesc *rvmap = &band->_rvMap;
 	uint8 colFlags[8];
 	int32 trvec[64];
 	uint32 sym = 0, q;
@@ -1320,7 +1463,7 @@ int IndeoDecoderBase::decodeCodedBlocks(GetBits *gb, IVIBandDesc *band,
 	}
 
 	// apply inverse transform
-	band->_invTransform(trvec, band->_buf + offs,
+	band->_blockTransform(trvec, band->_buf + offs,
 		band->_pitch, colFlags);
 
 	// apply motion compensation
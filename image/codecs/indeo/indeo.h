@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/array.h"
 #include "common/scummsys.h"
 #include "graphics/surface.h"
 #include "image/codecs/codec.h"
@@ -37,8 +38,13 @@
 #define IMAGE_CODECS_INDEO_INDEO_H
 
 #include "image/codecs/indeo/get_bits.h"
+#include "image/codecs/indeo/indeo_simd.h"
 #include "image/codecs/indeo/vlc.h"
 
+namespace Common {
+class WorkerPool;
+}
+
 namespace Image {
 namespace Indeo {
 
@@ -189,6 +195,8 @@ struct IVITile {
 	int			_mbSize;
 	bool		_isEmpty;
 	int			_dataSize;	///< size of the data in bytes
+	uint32		_dataPos;	///< bit position of the data in the frame
+	uint32		_dataEnd;	///< bit position of the end of the data in the frame
 	int			_numMBs;	///< number of macroblocks in this tile
 	IVIMbInfo *	_mbs;		///< array of macroblock descriptors
 	IVIMbInfo *	_refMbs;	///< ptr to the macroblock descriptors of the reference tile
@@ -229,10 +237,11 @@ struct IVIBandDesc {
 	int				_numCorr;		///< number of correction entries
 	uint8			_corr[61 * 2];	///< rvmap correction pairs
 	int				_rvmapSel;		///< rvmap table selector
-	RVMapDesc *		_rvMap;			///< ptr to the RLE table for this band
+	RVMapDesc		_rvMap;			///< corrected copy of the RLE table for this band
 	int				_numTiles;		///< number of tiles in this band
 	IVITile *		_tiles;			///< array of tile descriptors
 	InvTransformPtr *_invTransform;
+	InvTransformPtr *_blockTransform;	///< _invTransform, or a SIMD version of it
 	int				_transformSize;
 	DCTransformPtr *_dcTransform;
 	bool			_is2dTrans;
@@ -436,13 +445,64 @@ private:
 class IndeoDecoderBase : public Codec {
 private:
 	/**
-	 *  Decode an Indeo 4 or 5 band.
+	 *  A tile to decode, and the result of decoding it
+	 */
+	struct TileJob {
+		IVIBandDesc *	band;
+		IVITile *		tile;
+		int				result;
+	};
+
+	/**
+	 *  Decode the bands of all planes.
+	 *
+	 *  The band headers are parsed and the tiles located in bitstream
+	 *  order first. The tiles of the first luma band are decoded next,
+	 *  since all other bands may inherit its macroblock info, and then
+	 *  the tiles of all other bands. Tiles within each of these two
+	 *  batches are independent, and are spread over the worker pool.
+	 *
+	 *  @returns        result code: 0 = OK, -1 = error
+	 */
+	int decodePlanes();
+
+	/**
+	 *  Decode the header of an Indeo 4 or 5 band, and locate the data of
+	 *  its tiles.
 	 *
 	 *  @param[in,out]  band   ptr to the band descriptor
 	 *  @returns        result code: 0 = OK, -1 = error
 	 */
 	int decode_band(IVIBandDesc *band);
 
+	/**
+	 *  Queue the tiles of a band for decoding.
+	 *
+	 *  @param[in]  band   ptr to the band descriptor
+	 *  @returns    true if the tiles don't share any macroblocks, so they
+	 *              can be decoded in parallel
+	 */
+	bool addTileJobs(IVIBandDesc *band);
+
+	/**
+	 *  Decode the queued tiles and clear the queue.
+	 *
+	 *  @param[in]  parallel   whether to spread the tiles over the worker pool
+	 *  @returns    result code: 0 = OK, -1 = error
+	 */
+	int runTileJobs(bool parallel);
+
+	static void decodeTileJob(void *param, uint job);
+
+	/**
+	 *  Decode a tile located by decode_band(), with its own bit reader.
+	 *
+	 *  @param[in]      band   ptr to the band descriptor
+	 *  @param[in,out]  tile   ptr to the tile descriptor
+	 *  @returns        result code: 0 = OK, -1 = error
+	 */
+	int decodeTile(IVIBandDesc *band, IVITile *tile);
+
 	/**
 	 *  Haar wavelet recomposition filter for Indeo 4
 	 *
@@ -517,6 +577,10 @@ private:
 
 	int iviDcTransform(IVIBandDesc *band, int32 *prevDc, int bufOffs,
 		int blkSize);
+
+	Common::WorkerPool *_workerPool;
+	Common::Array<TileJob> _tileJobs;
+	IndeoSIMDProcs _simd;	///< SIMD DSP functions, nullptr where there are none
 protected:
 	IVI45DecContext _ctx;
 	Graphics::PixelFormat _pixelFormat;
@@ -559,11 +623,15 @@ protected:
 	*  Decode information (block type, _cbp, quant delta, motion vector)
 	*  for all macroblocks in the current tile.
 	*
+	*  This is called for several tiles at once from different threads,
+	*  so it must only write to the tile's macroblocks.
+	*
+	*  @param[in,out] gb		The GetBit context, at the start of the tile data
 	*  @param[in,out] band		Pointer to the band descriptor
 	*  @param[in,out] tile		Pointer to the tile descriptor
 	*  @returns		Result code: 0 = OK, negative number = error
 	*/
-	virtual int decodeMbInfo(IVIBandDesc *band, IVITile *tile) = 0;
+	virtual int decodeMbInfo(GetBits *gb, IVIBandDesc *band, IVITile *tile) = 0;
 
 	/**
 	 * Decodes optional transparency data within Indeo frames
@@ -0,0 +1,93 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "image/codecs/indeo/indeo_simd.h"
+
+#include <immintrin.h>
+
+namespace {
+
+struct AVX2Ops {
+	typedef __m256i V;
+
+	/** 8 lanes of 16 bits are only half a register, so they stay 128 bit wide. */
+	typedef __m128i W;
+
+	static FORCEINLINE V load(const int32 *p) { return _mm256_loadu_si256((const __m256i *)p); }
+	static FORCEINLINE V set1(int x) { return _mm256_set1_epi32(x); }
+	static FORCEINLINE V add(V a, V b) { return _mm256_add_epi32(a, b); }
+	static FORCEINLINE V sub(V a, V b) { return _mm256_sub_epi32(a, b); }
+	static FORCEINLINE V srai(V a, int n) { return _mm256_srai_epi32(a, n); }
+	static FORCEINLINE V andv(V a, V b) { return _mm256_and_si256(a, b); }
+
+	static FORCEINLINE void transpose(V *rows) {
+		V t[8], u[8];
+		for (int i = 0; i < 8; i += 2) {
+			t[i] = _mm256_unpacklo_epi32(rows[i], rows[i + 1]);
+			t[i + 1] = _mm256_unpackhi_epi32(rows[i], rows[i + 1]);
+		}
+		for (int i = 0; i < 8; i += 4) {
+			u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+			u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+			u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+			u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+		}
+		for (int i = 0; i < 4; i++) {
+			rows[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+			rows[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+		}
+	}
+
+	static FORCEINLINE void storeWords(int16 *p, V v) {
+		// Sign extend the low halves, so that packing can't saturate
+		const V truncated = _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+		_mm_storeu_si128((__m128i *)p, _mm_packs_epi32(_mm256_castsi256_si128(truncated), _mm256_extracti128_si256(truncated, 1)));
+	}
+
+	static FORCEINLINE W load16(const int16 *p) { return _mm_loadu_si128((const __m128i *)p); }
+	static FORCEINLINE W load16x4(const int16 *p) { return _mm_loadl_epi64((const __m128i *)p); }
+	static FORCEINLINE void store16(int16 *p, W w) { _mm_storeu_si128((__m128i *)p, w); }
+	static FORCEINLINE void store16x4(int16 *p, W w) { _mm_storel_epi64((__m128i *)p, w); }
+	static FORCEINLINE W add16(W a, W b) { return _mm_add_epi16(a, b); }
+	static FORCEINLINE W srai16(W a, int n) { return _mm_srai_epi16(a, n); }
+	static FORCEINLINE W and16(W a, W b) { return _mm_and_si128(a, b); }
+	static FORCEINLINE W set16(int x) { return _mm_set1_epi16(x); }
+
+	static FORCEINLINE void storeBiased(uint8 *p, W w) {
+		const __m128i biased = _mm_adds_epi16(w, _mm_set1_epi16(128));
+		_mm_storel_epi64((__m128i *)p, _mm_packus_epi16(biased, biased));
+	}
+};
+
+} // End of anonymous namespace
+
+#include "image/codecs/indeo/indeo_simd_impl.h"
+
+namespace Image {
+namespace Indeo {
+
+void getIndeoSIMDProcsAVX2(IndeoSIMDProcs &procs) {
+	IndeoKernels<AVX2Ops>::getProcs(procs);
+}
+
+} // End of namespace Indeo
+} // End of namespace Image
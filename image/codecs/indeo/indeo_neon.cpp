@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "image/codecs/indeo/indeo_simd.h"
+
+#include <arm_neon.h>
+
+namespace {
+
+struct NEONOps {
+	/** 8 lanes in two halves. */
+	struct V {
+		int32x4_t lo, hi;
+	};
+
+	typedef int16x8_t W;
+
+	static FORCEINLINE V make(int32x4_t lo, int32x4_t hi) {
+		V v;
+		v.lo = lo;
+		v.hi = hi;
+		return v;
+	}
+
+	static FORCEINLINE void transpose4(int32x4_t &r0, int32x4_t &r1, int32x4_t &r2, int32x4_t &r3) {
+		const int32x4x2_t t0 = vtrnq_s32(r0, r1);
+		const int32x4x2_t t1 = vtrnq_s32(r2, r3);
+		r0 = vcombine_s32(vget_low_s32(t0.val[0]), vget_low_s32(t1.val[0]));
+		r1 = vcombine_s32(vget_low_s32(t0.val[1]), vget_low_s32(t1.val[1]));
+		r2 = vcombine_s32(vget_high_s32(t0.val[0]), vget_high_s32(t1.val[0]));
+		r3 = vcombine_s32(vget_high_s32(t0.val[1]), vget_high_s32(t1.val[1]));
+	}
+
+	static FORCEINLINE V load(const int32 *p) { return make(vld1q_s32(p), vld1q_s32(p + 4)); }
+	static FORCEINLINE V set1(int x) { return make(vdupq_n_s32(x), vdupq_n_s32(x)); }
+	static FORCEINLINE V add(V a, V b) { return make(vaddq_s32(a.lo, b.lo), vaddq_s32(a.hi, b.hi)); }
+	static FORCEINLINE V sub(V a, V b) { return make(vsubq_s32(a.lo, b.lo), vsubq_s32(a.hi, b.hi)); }
+	static FORCEINLINE V andv(V a, V b) { return make(vandq_s32(a.lo, b.lo), vandq_s32(a.hi, b.hi)); }
+
+	static FORCEINLINE V srai(V a, int n) {
+		const int32x4_t count = vdupq_n_s32(-n);
+		return make(vshlq_s32(a.lo, count), vshlq_s32(a.hi, count));
+	}
+
+	static FORCEINLINE void transpose(V *rows) {
+		transpose4(rows[0].lo, rows[1].lo, rows[2].lo, rows[3].lo);
+		transpose4(rows[0].hi, rows[1].hi, rows[2].hi, rows[3].hi);
+		transpose4(rows[4].lo, rows[5].lo, rows[6].lo, rows[7].lo);
+		transpose4(rows[4].hi, rows[5].hi, rows[6].hi, rows[7].hi);
+		for (int i = 0; i < 4; i++) {
+			const int32x4_t t = rows[i].hi;
+			rows[i].hi = rows[i + 4].lo;
+			rows[i + 4].lo = t;
+		}
+	}
+
+	/** Narrowing truncates, like the generic code. */
+	static FORCEINLINE void storeWords(int16 *p, V v) {
+		vst1q_s16(p, vcombine_s16(vmovn_s32(v.lo), vmovn_s32(v.hi)));
+	}
+
+	static FORCEINLINE W load16(const int16 *p) { return vld1q_s16(p); }
+	static FORCEINLINE W load16x4(const int16 *p) { return vcombine_s16(vld1_s16(p), vdup_n_s16(0)); }
+	static FORCEINLINE void store16(int16 *p, W w) { vst1q_s16(p, w); }
+	static FORCEINLINE void store16x4(int16 *p, W w) { vst1_s16(p, vget_low_s16(w)); }
+	static FORCEINLINE W add16(W a, W b) { return vaddq_s16(a, b); }
+	static FORCEINLINE W srai16(W a, int n) { return vshlq_s16(a, vdupq_n_s16(-n)); }
+	static FORCEINLINE W and16(W a, W b) { return vandq_s16(a, b); }
+	static FORCEINLINE W set16(int x) { return vdupq_n_s16(x); }
+
+	static FORCEINLINE void storeBiased(uint8 *p, W w) {
+		vst1_u8(p, vqmovun_s16(vqaddq_s16(w, vdupq_n_s16(128))));
+	}
+};
+
+} // End of anonymous namespace
+
+#include "image/codecs/indeo/indeo_simd_impl.h"
+
+namespace Image {
+namespace Indeo {
+
+void getIndeoSIMDProcsNEON(IndeoSIMDProcs &procs) {
+	IndeoKernels<NEONOps>::getProcs(procs);
+}
+
+} // End of namespace Indeo
+} // End of namespace Image
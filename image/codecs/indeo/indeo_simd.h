@@ -0,0 +1,74 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef IMAGE_CODECS_INDEO_INDEO_SIMD_H
+#define IMAGE_CODECS_INDEO_INDEO_SIMD_H
+
+#include "common/scummsys.h"
+
+namespace Image {
+namespace Indeo {
+
+/**
+ * DSP functions of the Indeo decoders. Each one has the same result as
+ * the IndeoDSP function it replaces, including the truncation of the
+ * transform output to 16 bits.
+ */
+struct IndeoSIMDProcs {
+	/** Inverse transforms, like the IndeoDSP functions of the same names. */
+	void (*inverseHaar8x8)(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags);
+	void (*rowHaar8)(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags);
+	void (*colHaar8)(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags);
+	void (*inverseSlant8x8)(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags);
+	void (*rowSlant8)(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags);
+	void (*colSlant8)(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags);
+
+	/** Motion compensation, like the IndeoDSP functions of the same names. */
+	void (*mc8x8Delta)(int16 *buf, const int16 *refBuf, uint32 pitch, int mcType);
+	void (*mc8x8NoDelta)(int16 *buf, const int16 *refBuf, uint32 pitch, int mcType);
+	void (*mc4x4Delta)(int16 *buf, const int16 *refBuf, uint32 pitch, int mcType);
+	void (*mc4x4NoDelta)(int16 *buf, const int16 *refBuf, uint32 pitch, int mcType);
+	void (*mcAvg8x8Delta)(int16 *buf, const int16 *refBuf1, const int16 *refBuf2, uint32 pitch, int mcType, int mcType2);
+	void (*mcAvg8x8NoDelta)(int16 *buf, const int16 *refBuf1, const int16 *refBuf2, uint32 pitch, int mcType, int mcType2);
+	void (*mcAvg4x4Delta)(int16 *buf, const int16 *refBuf1, const int16 *refBuf2, uint32 pitch, int mcType, int mcType2);
+	void (*mcAvg4x4NoDelta)(int16 *buf, const int16 *refBuf1, const int16 *refBuf2, uint32 pitch, int mcType, int mcType2);
+
+	/** Add the bias of 128 to a row of a plane and clip it to bytes, like outputPlane(). */
+	void (*outputRow)(const int16 *src, uint8 *dst, int width);
+};
+
+#ifdef SCUMMVM_SSE2
+void getIndeoSIMDProcsSSE2(IndeoSIMDProcs &procs);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void getIndeoSIMDProcsAVX2(IndeoSIMDProcs &procs);
+#endif
+
+#ifdef SCUMMVM_NEON
+void getIndeoSIMDProcsNEON(IndeoSIMDProcs &procs);
+#endif
+
+} // End of namespace Indeo
+} // End of namespace Image
+
+#endif
@@ -0,0 +1,338 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * The SIMD DSP functions of the Indeo decoders, written once against a
+ * small set of vector operations. Each indeo_*.cpp file defines those
+ * operations for its instruction set and includes this file, which must
+ * not be included anywhere else: it is compiled with different code
+ * generation flags every time.
+ *
+ * An Ops class provides, for vectors V of 8 signed 32 bit lanes:
+ *   load(), set1(), add(), sub(), srai(), andv(), transpose() which
+ *   transposes 8 vectors as an 8x8 matrix, and storeWords() which stores
+ *   the lanes truncated to 16 bits.
+ * And for vectors W of 8 signed 16 bit lanes:
+ *   load16() and load16x4() which load 8 resp. 4 values, store16() and
+ *   store16x4(), add16(), srai16(), and16(), set16(), and storeBiased()
+ *   which stores the lanes plus 128, clipped to bytes.
+ *
+ * The transforms work on 32 bit lanes, like the generic code. Motion
+ * compensation works on 16 bit lanes, with the interpolating averages
+ * split so that they can't overflow, and so gives the same results.
+ */
+
+#ifndef IMAGE_CODECS_INDEO_INDEO_SIMD_IMPL_H
+#define IMAGE_CODECS_INDEO_INDEO_SIMD_IMPL_H
+
+#include "common/util.h"
+#include "image/codecs/indeo/indeo_simd.h"
+
+namespace Image {
+namespace Indeo {
+
+template<class Ops>
+struct IndeoKernels {
+	typedef typename Ops::V V;
+	typedef typename Ops::W W;
+
+	/** The lanes of the columns with a non-zero flag. */
+	static FORCEINLINE V flagMask(const uint8 *flags) {
+		int32 mask[8];
+		for (int i = 0; i < 8; i++)
+			mask[i] = flags[i] ? -1 : 0;
+		return Ops::load(mask);
+	}
+
+	/** (x + 1) >> 1, the compensation of the second slant pass. */
+	static FORCEINLINE V halve(V x) {
+		return Ops::srai(Ops::add(x, Ops::set1(1)), 1);
+	}
+
+	static FORCEINLINE void haarBfly(V s1, V s2, V &o1, V &o2) {
+		const V t = Ops::srai(Ops::sub(s1, s2), 1);
+		o1 = Ops::srai(Ops::add(s1, s2), 1);
+		o2 = t;
+	}
+
+	/** INV_HAAR8 on 8 columns or rows at once, with the same argument order. */
+	static FORCEINLINE void invHaar8(V s1, V s5, V s3, V s7, V s2, V s4, V s6, V s8, V *d) {
+		V t1 = Ops::add(s1, s1);
+		V t5 = Ops::add(s5, s5);
+		V t2, t3, t4, t6, t7, t8;
+		haarBfly(t1, t5, t1, t5);
+		haarBfly(t1, s3, t1, t3);
+		haarBfly(t5, s7, t5, t7);
+		haarBfly(t1, s2, t1, t2);
+		haarBfly(t3, s4, t3, t4);
+		haarBfly(t5, s6, t5, t6);
+		haarBfly(t7, s8, t7, t8);
+		d[0] = t1;
+		d[1] = t2;
+		d[2] = t3;
+		d[3] = t4;
+		d[4] = t5;
+		d[5] = t6;
+		d[6] = t7;
+		d[7] = t8;
+	}
+
+	static FORCEINLINE void slantBfly(V s1, V s2, V &o1, V &o2) {
+		const V t = Ops::sub(s1, s2);
+		o1 = Ops::add(s1, s2);
+		o2 = t;
+	}
+
+	static FORCEINLINE void iReflect(V s1, V s2, V &o1, V &o2) {
+		const V two = Ops::set1(2);
+		const V t = Ops::add(Ops::srai(Ops::add(Ops::add(s1, Ops::add(s2, s2)), two), 2), s1);
+		o2 = Ops::sub(Ops::srai(Ops::add(Ops::sub(Ops::add(s1, s1), s2), two), 2), s2);
+		o1 = t;
+	}
+
+	static FORCEINLINE void slantPart4(V s1, V s2, V &o1, V &o2) {
+		const V four = Ops::set1(4);
+		const V s1x4 = Ops::add(Ops::add(s1, s1), Ops::add(s1, s1));
+		const V s2x4 = Ops::add(Ops::add(s2, s2), Ops::add(s2, s2));
+		const V t = Ops::add(s2, Ops::srai(Ops::add(Ops::sub(s1x4, s2), four), 3));
+		o2 = Ops::add(s1, Ops::srai(Ops::sub(Ops::sub(four, s1), s2x4), 3));
+		o1 = t;
+	}
+
+	/** IVI_INV_SLANT8 on 8 columns or rows at once, with the same argument order. */
+	static FORCEINLINE void invSlant8(V s1, V s4, V s8, V s5, V s2, V s6, V s3, V s7, V *d) {
+		V t1, t2, t3, t4, t5, t6, t7, t8;
+		slantPart4(s4, s5, t4, t5);
+
+		slantBfly(s1, t5, t1, t5);
+		slantBfly(s2, s6, t2, t6);
+		slantBfly(s7, s3, t7, t3);
+		slantBfly(t4, s8, t4, t8);
+
+		slantBfly(t1, t2, t1, t2);
+		iReflect(t4, t3, t4, t3);
+		slantBfly(t5, t6, t5, t6);
+		iReflect(t8, t7, t8, t7);
+		slantBfly(t1, t4, t1, t4);
+		slantBfly(t2, t3, t2, t3);
+		slantBfly(t5, t8, t5, t8);
+		slantBfly(t6, t7, t6, t7);
+		d[0] = t1;
+		d[1] = t2;
+		d[2] = t3;
+		d[3] = t4;
+		d[4] = t5;
+		d[5] = t6;
+		d[6] = t7;
+		d[7] = t8;
+	}
+
+	/**
+	 * The row transforms skip rows which are all zero, and the column
+	 * transforms clear the columns without flag. A transform of zeros
+	 * is zero, so only the flags need to be applied here.
+	 */
+	static FORCEINLINE void loadRows(const int32 *in, V *rows) {
+		for (int i = 0; i < 8; i++)
+			rows[i] = Ops::load(in + i * 8);
+	}
+
+	static FORCEINLINE void storeRows(int16 *out, uint32 pitch, const V *rows) {
+		for (int i = 0; i < 8; i++, out += pitch)
+			Ops::storeWords(out, rows[i]);
+	}
+
+	static FORCEINLINE void applyFlags(V *rows, const uint8 *flags) {
+		const V mask = flagMask(flags);
+		for (int i = 0; i < 8; i++)
+			rows[i] = Ops::andv(rows[i], mask);
+	}
+
+	static void inverseHaar8x8(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+		static const int32 firstColumns[8] = { -1, -1, -1, -1, 0, 0, 0, 0 };
+		V rows[8], temp[8];
+		loadRows(in, rows);
+
+		// The first 4 rows of the first 4 columns are pre-scaled
+		const V scale = Ops::load(firstColumns);
+		for (int i = 0; i < 4; i++)
+			rows[i] = Ops::add(rows[i], Ops::andv(rows[i], scale));
+
+		invHaar8(rows[0], rows[1], rows[2], rows[3], rows[4], rows[5], rows[6], rows[7], temp);
+		applyFlags(temp, flags);
+		Ops::transpose(temp);
+		invHaar8(temp[0], temp[1], temp[2], temp[3], temp[4], temp[5], temp[6], temp[7], rows);
+		Ops::transpose(rows);
+		storeRows(out, pitch, rows);
+	}
+
+	static void rowHaar8(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+		V rows[8], temp[8];
+		loadRows(in, temp);
+		Ops::transpose(temp);
+		invHaar8(temp[0], temp[1], temp[2], temp[3], temp[4], temp[5], temp[6], temp[7], rows);
+		Ops::transpose(rows);
+		storeRows(out, pitch, rows);
+	}
+
+	static void colHaar8(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+		V rows[8], temp[8];
+		loadRows(in, temp);
+		invHaar8(temp[0], temp[1], temp[2], temp[3], temp[4], temp[5], temp[6], temp[7], rows);
+		applyFlags(rows, flags);
+		storeRows(out, pitch, rows);
+	}
+
+	static void inverseSlant8x8(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+		V rows[8], temp[8];
+		loadRows(in, rows);
+		invSlant8(rows[0], rows[1], rows[2], rows[3], rows[4], rows[5], rows[6], rows[7], temp);
+		applyFlags(temp, flags);
+		Ops::transpose(temp);
+		invSlant8(temp[0], temp[1], temp[2], temp[3], temp[4], temp[5], temp[6], temp[7], rows);
+		for (int i = 0; i < 8; i++)
+			rows[i] = halve(rows[i]);
+		Ops::transpose(rows);
+		storeRows(out, pitch, rows);
+	}
+
+	static void rowSlant8(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+		V rows[8], temp[8];
+		loadRows(in, temp);
+		Ops::transpose(temp);
+		invSlant8(temp[0], temp[1], temp[2], temp[3], temp[4], temp[5], temp[6], temp[7], rows);
+		for (int i = 0; i < 8; i++)
+			rows[i] = halve(rows[i]);
+		Ops::transpose(rows);
+		storeRows(out, pitch, rows);
+	}
+
+	static void colSlant8(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+		V rows[8], temp[8];
+		loadRows(in, temp);
+		invSlant8(temp[0], temp[1], temp[2], temp[3], temp[4], temp[5], temp[6], temp[7], rows);
+		for (int i = 0; i < 8; i++)
+			rows[i] = halve(rows[i]);
+		applyFlags(rows, flags);
+		storeRows(out, pitch, rows);
+	}
+
+	template<int size>
+	static FORCEINLINE W loadRow(const int16 *p) {
+		return size == 8 ? Ops::load16(p) : Ops::load16x4(p);
+	}
+
+	template<int size>
+	static FORCEINLINE void storeRow(int16 *p, W w) {
+		if (size == 8)
+			Ops::store16(p, w);
+		else
+			Ops::store16x4(p, w);
+	}
+
+	/** (a + b) >> 1 without overflowing 16 bits. */
+	static FORCEINLINE W average2(W a, W b) {
+		const W odd = Ops::and16(Ops::and16(a, b), Ops::set16(1));
+		return Ops::add16(Ops::add16(Ops::srai16(a, 1), Ops::srai16(b, 1)), odd);
+	}
+
+	/** (a + b + c + d) >> 2 without overflowing 16 bits. */
+	static FORCEINLINE W average4(W a, W b, W c, W d) {
+		const W three = Ops::set16(3);
+		const W low = Ops::add16(Ops::add16(Ops::and16(a, three), Ops::and16(b, three)),
+		                         Ops::add16(Ops::and16(c, three), Ops::and16(d, three)));
+		const W high = Ops::add16(Ops::add16(Ops::srai16(a, 2), Ops::srai16(b, 2)),
+		                          Ops::add16(Ops::srai16(c, 2), Ops::srai16(d, 2)));
+		return Ops::add16(high, Ops::srai16(low, 2));
+	}
+
+	/** A row of the (interpolated) reference block, like iviMc*(). */
+	template<int size>
+	static FORCEINLINE W predict(const int16 *refBuf, uint32 pitch, int mcType) {
+		switch (mcType) {
+		case 1: // horizontal halfpel interpolation
+			return average2(loadRow<size>(refBuf), loadRow<size>(refBuf + 1));
+		case 2: // vertical halfpel interpolation
+			return average2(loadRow<size>(refBuf), loadRow<size>(refBuf + pitch));
+		case 3: // vertical and horizontal halfpel interpolation
+			return average4(loadRow<size>(refBuf), loadRow<size>(refBuf + 1),
+			                loadRow<size>(refBuf + pitch), loadRow<size>(refBuf + pitch + 1));
+		default: // fullpel (no interpolation)
+			return loadRow<size>(refBuf);
+		}
+	}
+
+	template<int size, bool delta>
+	static void mc(int16 *buf, const int16 *refBuf, uint32 pitch, int mcType) {
+		if (mcType < 0 || mcType > 3)
+			return;
+
+		for (int i = 0; i < size; i++, buf += pitch, refBuf += pitch) {
+			W w = predict<size>(refBuf, pitch, mcType);
+			if (delta)
+				w = Ops::add16(loadRow<size>(buf), w);
+			storeRow<size>(buf, w);
+		}
+	}
+
+	template<int size, bool delta>
+	static void mcAvg(int16 *buf, const int16 *refBuf1, const int16 *refBuf2, uint32 pitch, int mcType, int mcType2) {
+		for (int i = 0; i < size; i++, buf += pitch, refBuf1 += pitch, refBuf2 += pitch) {
+			// The generic code sums both predictions in 16 bits, then halves them
+			W w = Ops::srai16(Ops::add16(predict<size>(refBuf1, pitch, mcType), predict<size>(refBuf2, pitch, mcType2)), 1);
+			if (delta)
+				w = Ops::add16(loadRow<size>(buf), w);
+			storeRow<size>(buf, w);
+		}
+	}
+
+	static void outputRow(const int16 *src, uint8 *dst, int width) {
+		int x = 0;
+		for (; x + 8 <= width; x += 8)
+			Ops::storeBiased(dst + x, Ops::load16(src + x));
+		for (; x < width; x++)
+			dst[x] = CLIP(src[x] + 128, 0, 255);
+	}
+
+	static void getProcs(IndeoSIMDProcs &procs) {
+		procs.inverseHaar8x8 = inverseHaar8x8;
+		procs.rowHaar8 = rowHaar8;
+		procs.colHaar8 = colHaar8;
+		procs.inverseSlant8x8 = inverseSlant8x8;
+		procs.rowSlant8 = rowSlant8;
+		procs.colSlant8 = colSlant8;
+		procs.mc8x8Delta = mc<8, true>;
+		procs.mc8x8NoDelta = mc<8, false>;
+		procs.mc4x4Delta = mc<4, true>;
+		procs.mc4x4NoDelta = mc<4, false>;
+		procs.mcAvg8x8Delta = mcAvg<8, true>;
+		procs.mcAvg8x8NoDelta = mcAvg<8, false>;
+		procs.mcAvg4x4Delta = mcAvg<4, true>;
+		procs.mcAvg4x4NoDelta = mcAvg<4, false>;
+		procs.outputRow = outputRow;
+	}
+};
+
+} // End of namespace Indeo
+} // End of namespace Image
+
+#endif
@@ -0,0 +1,113 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "image/codecs/indeo/indeo_simd.h"
+
+#include <emmintrin.h>
+
+namespace {
+
+struct SSE2Ops {
+	/** 8 lanes in two halves. */
+	struct V {
+		__m128i lo, hi;
+	};
+
+	typedef __m128i W;
+
+	static FORCEINLINE V make(__m128i lo, __m128i hi) {
+		V v;
+		v.lo = lo;
+		v.hi = hi;
+		return v;
+	}
+
+	static FORCEINLINE void transpose4(__m128i &r0, __m128i &r1, __m128i &r2, __m128i &r3) {
+		const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+		const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+		const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+		const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+		r0 = _mm_unpacklo_epi64(t0, t1);
+		r1 = _mm_unpackhi_epi64(t0, t1);
+		r2 = _mm_unpacklo_epi64(t2, t3);
+		r3 = _mm_unpackhi_epi64(t2, t3);
+	}
+
+	/** The low halves of 32 bit lanes, sign extended so that packing can't saturate. */
+	static FORCEINLINE __m128i truncate(__m128i a) {
+		return _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+	}
+
+	static FORCEINLINE V load(const int32 *p) {
+		return make(_mm_loadu_si128((const __m128i *)p), _mm_loadu_si128((const __m128i *)(p + 4)));
+	}
+
+	static FORCEINLINE V set1(int x) { return make(_mm_set1_epi32(x), _mm_set1_epi32(x)); }
+	static FORCEINLINE V add(V a, V b) { return make(_mm_add_epi32(a.lo, b.lo), _mm_add_epi32(a.hi, b.hi)); }
+	static FORCEINLINE V sub(V a, V b) { return make(_mm_sub_epi32(a.lo, b.lo), _mm_sub_epi32(a.hi, b.hi)); }
+	static FORCEINLINE V srai(V a, int n) { return make(_mm_srai_epi32(a.lo, n), _mm_srai_epi32(a.hi, n)); }
+	static FORCEINLINE V andv(V a, V b) { return make(_mm_and_si128(a.lo, b.lo), _mm_and_si128(a.hi, b.hi)); }
+
+	static FORCEINLINE void transpose(V *rows) {
+		transpose4(rows[0].lo, rows[1].lo, rows[2].lo, rows[3].lo);
+		transpose4(rows[0].hi, rows[1].hi, rows[2].hi, rows[3].hi);
+		transpose4(rows[4].lo, rows[5].lo, rows[6].lo, rows[7].lo);
+		transpose4(rows[4].hi, rows[5].hi, rows[6].hi, rows[7].hi);
+		for (int i = 0; i < 4; i++) {
+			const __m128i t = rows[i].hi;
+			rows[i].hi = rows[i + 4].lo;
+			rows[i + 4].lo = t;
+		}
+	}
+
+	static FORCEINLINE void storeWords(int16 *p, V v) {
+		_mm_storeu_si128((__m128i *)p, _mm_packs_epi32(truncate(v.lo), truncate(v.hi)));
+	}
+
+	static FORCEINLINE W load16(const int16 *p) { return _mm_loadu_si128((const __m128i *)p); }
+	static FORCEINLINE W load16x4(const int16 *p) { return _mm_loadl_epi64((const __m128i *)p); }
+	static FORCEINLINE void store16(int16 *p, W w) { _mm_storeu_si128((__m128i *)p, w); }
+	static FORCEINLINE void store16x4(int16 *p, W w) { _mm_storel_epi64((__m128i *)p, w); }
+	static FORCEINLINE W add16(W a, W b) { return _mm_add_epi16(a, b); }
+	static FORCEINLINE W srai16(W a, int n) { return _mm_srai_epi16(a, n); }
+	static FORCEINLINE W and16(W a, W b) { return _mm_and_si128(a, b); }
+	static FORCEINLINE W set16(int x) { return _mm_set1_epi16(x); }
+
+	static FORCEINLINE void storeBiased(uint8 *p, W w) {
+		const __m128i biased = _mm_adds_epi16(w, _mm_set1_epi16(128));
+		_mm_storel_epi64((__m128i *)p, _mm_packus_epi16(biased, biased));
+	}
+};
+
+} // End of anonymous namespace
+
+#include "image/codecs/indeo/indeo_simd_impl.h"
+
+namespace Image {
+namespace Indeo {
+
+void getIndeoSIMDProcsSSE2(IndeoSIMDProcs &procs) {
+	IndeoKernels<SSE2Ops>::getProcs(procs);
+}
+
+} // End of namespace Indeo
+} // End of namespace Image
@@ -454,7 +454,7 @@ int Indeo4Decoder::decodeBandHeader(IVIBandDesc *band) {
 	return 0;
 }
 
-int Indeo4Decoder::decodeMbInfo(IVIBandDesc *band, IVITile *tile) {
+int Indeo4Decoder::decodeMbInfo(GetBits *gb, IVIBandDesc *band, IVITile *tile) {
 	int x, y, mvX, mvY, mvDelta, offs, mbOffset, blksPerMb,
 		mvScale, mbTypeBits, s;
 	IVIMbInfo *mb, *refMb;
@@ -485,7 +485,7 @@ int Indeo4Decoder::decodeMbInfo(IVIBandDesc *band, IVITile *tile) {
 			mb->_bufOffs = mbOffset;
 			mb->_bMvX = mb->_bMvY = 0;
 
-			if (_ctx._gb->getBit()) {
+			if (gb->getBit()) {
 				if (_ctx._frameType == IVI4_FRAMETYPE_INTRA) {
 					warning("Empty macroblock in an INTRA picture!");
 					return -1;
@@ -495,7 +495,7 @@ int Indeo4Decoder::decodeMbInfo(IVIBandDesc *band, IVITile *tile) {
 
 				mb->_qDelta = 0;
 				if (!band->_plane && !band->_bandNum && _ctx._inQ) {
-					mb->_qDelta = _ctx._gb->getVLC2<1>(_ctx._mbVlc._tab->_table,
+					mb->_qDelta = gb->getVLC2<1>(_ctx._mbVlc._tab->_table,
 						IVI_VLC_BITS);
 					mb->_qDelta = IVI_TOSIGNED(mb->_qDelta);
 				}
@@ -523,17 +523,17 @@ int Indeo4Decoder::decodeMbInfo(IVIBandDesc *band, IVITile *tile) {
 					_ctx._frameType == IVI4_FRAMETYPE_INTRA1) {
 					mb->_type = 0; // mb_type is always INTRA for intra-frames
 				} else {
-					mb->_type = _ctx._gb->getBits(mbTypeBits);
+					mb->_type = gb->getBits(mbTypeBits);
 				}
 
-				mb->_cbp = _ctx._gb->getBits(blksPerMb);
+				mb->_cbp = gb->getBits(blksPerMb);
 
 				mb->_qDelta = 0;
 				if (band->_inheritQDelta) {
 					if (refMb) mb->_qDelta = refMb->_qDelta;
 				} else if (mb->_cbp || (!band->_plane && !band->_bandNum &&
 					_ctx._inQ)) {
-					mb->_qDelta = _ctx._gb->getVLC2<1>(_ctx._mbVlc._tab->_table,
+					mb->_qDelta = gb->getVLC2<1>(_ctx._mbVlc._tab->_table,
 						IVI_VLC_BITS);
 					mb->_qDelta = IVI_TOSIGNED(mb->_qDelta);
 				}
@@ -554,20 +554,20 @@ int Indeo4Decoder::decodeMbInfo(IVIBandDesc *band, IVITile *tile) {
 						}
 					} else {
 						// decode motion vector deltas
-						mvDelta = _ctx._gb->getVLC2<1>(_ctx._mbVlc._tab->_table,
+						mvDelta = gb->getVLC2<1>(_ctx._mbVlc._tab->_table,
 							IVI_VLC_BITS);
 						mvY += IVI_TOSIGNED(mvDelta);
-						mvDelta = _ctx._gb->getVLC2<1>(_ctx._mbVlc._tab->_table,
+						mvDelta = gb->getVLC2<1>(_ctx._mbVlc._tab->_table,
 							IVI_VLC_BITS);
 						mvX += IVI_TOSIGNED(mvDelta);
 						mb->_mvX = mvX;
 						mb->_mvY = mvY;
 						if (mb->_type == 3) {
-							mvDelta = _ctx._gb->getVLC2<1>(
+							mvDelta = gb->getVLC2<1>(
 								_ctx._mbVlc._tab->_table,
 								IVI_VLC_BITS);
 							mvY += IVI_TOSIGNED(mvDelta);
-							mvDelta = _ctx._gb->getVLC2<1>(
+							mvDelta = gb->getVLC2<1>(
 								_ctx._mbVlc._tab->_table,
 								IVI_VLC_BITS);
 							mvX += IVI_TOSIGNED(mvDelta);
@@ -602,7 +602,7 @@ int Indeo4Decoder::decodeMbInfo(IVIBandDesc *band, IVITile *tile) {
 		offs += row_offset;
 	}
 
-	_ctx._gb->align();
+	gb->align();
 	return 0;
 }
 
@@ -260,7 +260,7 @@ int Indeo5Decoder::decodeBandHeader(IVIBandDesc *band) {
 	return 0;
 }
 
-int Indeo5Decoder::decodeMbInfo(IVIBandDesc *band, IVITile *tile) {
+int Indeo5Decoder::decodeMbInfo(GetBits *gb, IVIBandDesc *band, IVITile *tile) {
 	int x, y, mvX, mvY, mvDelta, offs, mbOffset, mvScale, blksPerMb, s;
 	IVIMbInfo *mb, *refMb;
 	int rowOffset = band->_mbSize * band->_pitch;
@@ -291,7 +291,7 @@ int Indeo5Decoder::decodeMbInfo(IVIBandDesc *band, IVITile *tile) {
 			mb->_yPos = y;
 			mb->_bufOffs = mbOffset;
 
-			if (_ctx._gb->getBit()) {
+			if (gb->getBit()) {
 				if (_ctx._frameType == FRAMETYPE_INTRA) {
 					warning("Empty macroblock in an INTRA picture!");
 					return -1;
@@ -301,7 +301,7 @@ int Indeo5Decoder::decodeMbInfo(IVIBandDesc *band, IVITile *tile) {
 
 				mb->_qDelta = 0;
 				if (!band->_plane && !band->_bandNum && (_ctx._frameFlags & 8)) {
-					mb->_qDelta = _ctx._gb->getVLC2<1>(_ctx._mbVlc._tab->_table, IVI_VLC_BITS);
+					mb->_qDelta = gb->getVLC2<1>(_ctx._mbVlc._tab->_table, IVI_VLC_BITS);
 					mb->_qDelta = IVI_TOSIGNED(mb->_qDelta);
 				}
 
@@ -322,11 +322,11 @@ int Indeo5Decoder::decodeMbInfo(IVIBandDesc *band, IVITile *tile) {
 				} else if (_ctx._frameType == FRAMETYPE_INTRA) {
 					mb->_type = 0; // mb_type is always INTRA for intra-frames
 				} else {
-					mb->_type = _ctx._gb->getBit();
+					mb->_type = gb->getBit();
 				}
 
 				blksPerMb = band->_mbSize != band->_blkSize ? 4 : 1;
-				mb->_cbp = _ctx._gb->getBits(blksPerMb);
+				mb->_cbp = gb->getBits(blksPerMb);
 
 				mb->_qDelta = 0;
 				if (band->_qdeltaPresent) {
@@ -334,7 +334,7 @@ int Indeo5Decoder::decodeMbInfo(IVIBandDesc *band, IVITile *tile) {
 						if (refMb) mb->_qDelta = refMb->_qDelta;
 					} else if (mb->_cbp || (!band->_plane && !band->_bandNum &&
 						(_ctx._frameFlags & 8))) {
-						mb->_qDelta = _ctx._gb->getVLC2<1>(_ctx._mbVlc._tab->_table, IVI_VLC_BITS);
+						mb->_qDelta = gb->getVLC2<1>(_ctx._mbVlc._tab->_table, IVI_VLC_BITS);
 						mb->_qDelta = IVI_TOSIGNED(mb->_qDelta);
 					}
 				}
@@ -353,9 +353,9 @@ int Indeo5Decoder::decodeMbInfo(IVIBandDesc *band, IVITile *tile) {
 						}
 					} else {
 						// decode motion vector deltas
-						mvDelta = _ctx._gb->getVLC2<1>(_ctx._mbVlc._tab->_table, IVI_VLC_BITS);
+						mvDelta = gb->getVLC2<1>(_ctx._mbVlc._tab->_table, IVI_VLC_BITS);
 						mvY += IVI_TOSIGNED(mvDelta);
-						mvDelta = _ctx._gb->getVLC2<1>(_ctx._mbVlc._tab->_table, IVI_VLC_BITS);
+						mvDelta = gb->getVLC2<1>(_ctx._mbVlc._tab->_table, IVI_VLC_BITS);
 						mvX += IVI_TOSIGNED(mvDelta);
 						mb->_mvX = mvX;
 						mb->_mvY = mvY;
@@ -381,7 +381,7 @@ int Indeo5Decoder::decodeMbInfo(IVIBandDesc *band, IVITile *tile) {
 		offs += rowOffset;
 	}
 
-	_ctx._gb->align();
+	gb->align();
 
 	return 0;
 }
@@ -84,11 +84,12 @@ protected:
 	 *  Decode information (block type, cbp, quant delta, motion vector)
 	 *  for all macroblocks in the current tile.
 	 *
+	 *  @param[in,out] gb        the GetBit context
 	 *  @param[in,out] band      pointer to the band descriptor
 	 *  @param[in,out] tile      pointer to the tile descriptor
 	 *  @return        result code: 0 = OK, negative number = error
 	 */
-	virtual int decodeMbInfo(IVIBandDesc *band, IVITile *tile);
+	virtual int decodeMbInfo(GetBits *gb, IVIBandDesc *band, IVITile *tile);
 private:
 	/**
 	 *  Decode Indeo5 GOP (Group of pictures) header.
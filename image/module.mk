@@ -36,5 +36,22 @@ MODULE_OBJS += \
 	codecs/mpeg.o
 endif
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	codecs/indeo/indeo_sse2.o
+$(MODULE)/codecs/indeo/indeo_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	codecs/indeo/indeo_avx2.o
+$(MODULE)/codecs/indeo/indeo_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	codecs/indeo/indeo_neon.o
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
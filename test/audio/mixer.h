@@ -0,0 +1,226 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/decoders/raw.h"
+#include "audio/mixer_intern.h"
+
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/str.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class MixerTestSuite : public CxxTest::TestSuite
+{
+private:
+	static const int kSampleRate = 22050;
+	static const int kCallbackFrames = 512;
+
+	static Audio::SeekableAudioStream *makeShortStream(const int16 *samples, uint32 count) {
+		return Audio::makeRawStream((const byte *)samples, count * sizeof(int16), kSampleRate,
+		                            Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN, DisposeAfterUse::NO);
+	}
+
+	static void runCallback(Audio::MixerImpl &mixer, uint32 &worstMillis) {
+		int16 buffer[kCallbackFrames * 2];
+		const uint32 start = g_system->getMillis(true);
+		mixer.mixCallback((byte *)buffer, sizeof(buffer));
+		worstMillis = MAX(worstMillis, g_system->getMillis(true) - start);
+	}
+
+	// A stream which notes when it gets read after its owner gave it up
+	class StoppedStream : public Audio::AudioStream {
+	public:
+		StoppedStream() : _stopped(false), _readAfterStop(false) {}
+
+		int readBuffer(int16 *buffer, const int numSamples) {
+			if (Common::atomicLoad(&_stopped))
+				Common::atomicStore(&_readAfterStop, true);
+			for (int i = 0; i < numSamples; ++i)
+				buffer[i] = (int16)(i * 7);
+			return numSamples;
+		}
+
+		bool isStereo() const { return false; }
+		int getRate() const { return kSampleRate; }
+		bool endOfData() const { return false; }
+
+		bool _stopped;
+		bool _readAfterStop;
+	};
+
+	struct MixThread {
+		Audio::MixerImpl *mixer;
+		bool quit;
+	};
+
+	static void mixThreadProc(void *param) {
+		MixThread *thread = (MixThread *)param;
+		int16 buffer[kCallbackFrames * 2];
+		while (!Common::atomicLoad(&thread->quit))
+			thread->mixer->mixCallback((byte *)buffer, sizeof(buffer));
+	}
+
+public:
+	void test_many_short_streams() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		int16 samples[128];
+		for (int i = 0; i < ARRAYSIZE(samples); ++i)
+			samples[i] = (int16)(i * 200);
+
+		Audio::MixerImpl mixerImpl(kSampleRate);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		uint32 worstMillis = 0;
+		Audio::SoundHandle lastHandle;
+
+		for (int i = 0; i < 5000; ++i) {
+			Audio::SoundHandle handle;
+			mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, makeShortStream(samples, ARRAYSIZE(samples)),
+			                 -1, 200, (int8)((i % 255) - 127));
+			mixer.setChannelVolume(handle, (byte)i);
+			TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), (byte)i);
+
+			// Stop every third sound before it gets a chance to play
+			if (i % 3 == 0)
+				mixer.stopHandle(handle);
+			lastHandle = handle;
+
+			if (i % 8 == 7)
+				runCallback(mixerImpl, worstMillis);
+		}
+
+		// All sounds are shorter than a single callback
+		runCallback(mixerImpl, worstMillis);
+		runCallback(mixerImpl, worstMillis);
+		TS_ASSERT(!mixer.isSoundHandleActive(lastHandle));
+		TS_ASSERT(!mixer.hasActiveChannelOfType(Audio::Mixer::kSFXSoundType));
+
+		TS_TRACE(Common::String::format("worst mix callback time: %u ms", worstMillis).c_str());
+#endif
+	}
+
+	// Stopped channels the audio thread did not retire yet are limited, so
+	// that it can retire them without allocating memory
+	void test_stopped_channel_limit() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		int16 samples[128];
+		memset(samples, 0, sizeof(samples));
+
+		Audio::MixerImpl mixerImpl(kSampleRate);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		// Twice the 32 channels of the mixer may be waiting to be retired
+		Audio::SoundHandle handle;
+		for (int i = 0; i < 64; ++i) {
+			mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, makeShortStream(samples, ARRAYSIZE(samples)));
+			TS_ASSERT(mixer.isSoundHandleActive(handle));
+			mixer.stopHandle(handle);
+		}
+
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, makeShortStream(samples, ARRAYSIZE(samples)));
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+
+		uint32 worstMillis = 0;
+		runCallback(mixerImpl, worstMillis);
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, makeShortStream(samples, ARRAYSIZE(samples)));
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+#endif
+	}
+
+	void test_stop_and_delete_owned_stream() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		int16 samples[kSampleRate];
+		memset(samples, 0, sizeof(samples));
+
+		Audio::MixerImpl mixerImpl(kSampleRate);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		uint32 worstMillis = 0;
+		Audio::SoundHandle handle, permanentHandle;
+
+		// The caller keeps ownership of this stream
+		Audio::SeekableAudioStream *stream = makeShortStream(samples, ARRAYSIZE(samples));
+		mixer.playStream(Audio::Mixer::kMusicSoundType, &handle, stream, 42, 255, 0, DisposeAfterUse::NO);
+		mixer.playStream(Audio::Mixer::kSpeechSoundType, &permanentHandle, makeShortStream(samples, ARRAYSIZE(samples)),
+		                 -1, 255, 0, DisposeAfterUse::YES, true);
+		runCallback(mixerImpl, worstMillis);
+
+		TS_ASSERT(mixer.isSoundIDActive(42));
+		TS_ASSERT_EQUALS(mixer.getSoundID(handle), 42);
+
+		mixer.pauseHandle(handle, true);
+		runCallback(mixerImpl, worstMillis);
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+
+		mixer.stopAll();
+		delete stream;
+		runCallback(mixerImpl, worstMillis);
+
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT(mixer.isSoundHandleActive(permanentHandle));
+#endif
+	}
+
+	void test_stop_while_mixing_on_thread() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixerImpl(kSampleRate);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		MixThread mixThread;
+		mixThread.mixer = &mixerImpl;
+		mixThread.quit = false;
+		OSystem::ThreadRef thread = g_system->createThread(mixThreadProc, &mixThread);
+		if (!thread)
+			return;
+
+		// Streams the caller owns must not be read anymore once they are
+		// stopped, as callers delete them right away. They are only marked
+		// here, so that late reads are caught instead of crashing.
+		Common::Array<StoppedStream *> streams;
+		for (int batch = 0; batch < 200; ++batch) {
+			const int first = streams.size();
+			Audio::SoundHandle handles[8];
+			for (int i = 0; i < 8; ++i) {
+				streams.push_back(new StoppedStream());
+				mixer.playStream(Audio::Mixer::kSFXSoundType, &handles[i], streams.back(), first + i,
+				                 255, 0, DisposeAfterUse::NO);
+			}
+
+			// Let the streams play before they are stopped
+			g_system->delayMillis(1);
+
+			for (int i = 0; i < 8; ++i) {
+				if (i % 2)
+					mixer.stopID(first + i);
+				else
+					mixer.stopHandle(handles[i]);
+				Common::atomicStore(&streams[first + i]->_stopped, true);
+			}
+		}
+
+		Common::atomicStore(&mixThread.quit, true);
+		g_system->joinThread(thread);
+
+		bool readAfterStop = false;
+		for (uint i = 0; i < streams.size(); ++i) {
+			readAfterStop |= streams[i]->_readAfterStop;
+			delete streams[i];
+		}
+		TS_ASSERT(!readAfterStop);
+#endif
+	}
+};
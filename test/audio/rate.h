@@ -0,0 +1,195 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/rate.h"
+#include "audio/rate_intern.h"
+
+#include "common/array.h"
+#include "common/cpudetect.h"
+#include "common/str.h"
+#include "common/system.h"
+
+#include "helper.h"
+#include "../null_osystem.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	struct NamedProcs {
+		const char *name;
+		Audio::RateMixProcs procs;
+	};
+
+	Common::Array<NamedProcs> simdProcs() {
+		Common::Array<NamedProcs> list;
+		NamedProcs entry;
+#ifdef SCUMMVM_SSE2
+		if (Common::hasCpuFeature(Common::kCpuFeatureSSE2)) {
+			entry.name = "SSE2";
+			entry.procs.stereo = Audio::rateMixStereoSSE2;
+			entry.procs.mono = Audio::rateMixMonoSSE2;
+			list.push_back(entry);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (Common::hasCpuFeature(Common::kCpuFeatureAVX2)) {
+			entry.name = "AVX2";
+			entry.procs.stereo = Audio::rateMixStereoAVX2;
+			entry.procs.mono = Audio::rateMixMonoAVX2;
+			list.push_back(entry);
+		}
+#endif
+#ifdef SCUMMVM_NEON
+		if (Common::hasCpuFeature(Common::kCpuFeatureNEON)) {
+			entry.name = "NEON";
+			entry.procs.stereo = Audio::rateMixStereoNEON;
+			entry.procs.mono = Audio::rateMixMonoNEON;
+			list.push_back(entry);
+		}
+#endif
+		return list;
+	}
+
+	static void fillNoise(int16 *buf, int count, uint32 seed) {
+		// Include the extreme values, they exercise the saturation logic
+		for (int i = 0; i < count; ++i) {
+			seed = seed * 1103515245 + 12345;
+			switch (i % 7) {
+			case 0:
+				buf[i] = 32767;
+				break;
+			case 3:
+				buf[i] = -32768;
+				break;
+			default:
+				buf[i] = (int16)(seed >> 16);
+			}
+		}
+	}
+
+	void checkProc(const char *name, bool stereo, Audio::RateMixProc proc, Audio::RateMixProc reference) {
+		static const int kMaxFrames = 67;
+		static const Audio::st_volume_t volumes[] = { 0, 1, 127, 200, 255, 256 };
+
+		int16 in[kMaxFrames * 2];
+		int16 out[kMaxFrames * 2];
+		int16 expected[kMaxFrames * 2];
+		fillNoise(in, ARRAYSIZE(in), 1);
+
+		for (int frames = 0; frames <= kMaxFrames; ++frames) {
+			for (int v = 0; v < ARRAYSIZE(volumes); ++v) {
+				const Audio::st_volume_t vol0 = volumes[v];
+				const Audio::st_volume_t vol1 = volumes[ARRAYSIZE(volumes) - 1 - v];
+
+				fillNoise(out, ARRAYSIZE(out), frames + 2);
+				memcpy(expected, out, sizeof(out));
+
+				proc(out, in, frames, vol0, vol1);
+				reference(expected, in, frames, vol0, vol1);
+
+				if (memcmp(out, expected, sizeof(out)) != 0) {
+					TS_FAIL(Common::String::format("%s %s proc differs for %d frames, volumes %d/%d",
+					        name, stereo ? "stereo" : "mono", frames, vol0, vol1).c_str());
+					return;
+				}
+			}
+		}
+	}
+
+	int16 *convert(Audio::RateConverter *converter, int inRate, int outRate, bool stereo, int outFrames) {
+		Audio::SeekableAudioStream *stream = createSineStream<int16>(inRate, 1, 0, false, stereo);
+		int16 *out = new int16[outFrames * 2];
+		fillNoise(out, outFrames * 2, 3);
+
+		// Request odd amounts to exercise the buffer boundaries
+		int done = 0;
+		while (done < outFrames) {
+			const int request = MIN(outFrames - done, 333);
+			const int result = converter->flow(*stream, out + done * 2, request, 200, 256);
+			if (result == 0)
+				break;
+			done += result;
+		}
+
+		delete stream;
+		delete converter;
+		return out;
+	}
+
+	void checkConverter(int inRate, int outRate, bool stereo, bool reverseStereo) {
+		const int outFrames = outRate;
+
+		Common::setCpuFeatureMask(0);
+		int16 *expected = convert(Audio::makeRateConverter(inRate, outRate, stereo, reverseStereo), inRate, outRate, stereo, outFrames);
+		Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+		int16 *out = convert(Audio::makeRateConverter(inRate, outRate, stereo, reverseStereo), inRate, outRate, stereo, outFrames);
+
+		TS_ASSERT_EQUALS(memcmp(out, expected, outFrames * 2 * sizeof(int16)), 0);
+
+		delete[] expected;
+		delete[] out;
+	}
+
+public:
+	void test_mix_procs_bit_exact() {
+		const Audio::RateMixProcs generic = Audio::getGenericRateMixProcs();
+		const Common::Array<NamedProcs> list = simdProcs();
+
+		for (uint i = 0; i < list.size(); ++i) {
+			checkProc(list[i].name, true, list[i].procs.stereo, generic.stereo);
+			checkProc(list[i].name, false, list[i].procs.mono, generic.mono);
+		}
+	}
+
+	void test_copy_converter() {
+		checkConverter(22050, 22050, false, false);
+		checkConverter(22050, 22050, true, false);
+		checkConverter(22050, 22050, true, true);
+	}
+
+	void test_simple_converter() {
+		checkConverter(44100, 22050, false, false);
+		checkConverter(44100, 11025, true, false);
+		checkConverter(44100, 22050, true, true);
+	}
+
+	void test_linear_converter() {
+		checkConverter(11025, 44100, false, false);
+		checkConverter(22050, 48000, true, false);
+		checkConverter(48000, 44100, true, true);
+	}
+
+	void test_mix_procs_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		static const int kFrames = 4096;
+		static const int kIterations = 2000;
+
+		Common::Array<NamedProcs> list = simdProcs();
+		NamedProcs generic;
+		generic.name = "generic";
+		generic.procs = Audio::getGenericRateMixProcs();
+		list.insert_at(0, generic);
+
+		int16 *in = new int16[kFrames * 2];
+		int16 *out = new int16[kFrames * 2];
+		fillNoise(in, kFrames * 2, 5);
+
+		for (uint i = 0; i < list.size(); ++i) {
+			memset(out, 0, kFrames * 2 * sizeof(int16));
+
+			const uint32 start = g_system->getMillis();
+			for (int j = 0; j < kIterations; ++j)
+				list[i].procs.stereo(out, in, kFrames, 200, 128);
+			const uint32 elapsed = g_system->getMillis() - start;
+
+			if (elapsed > 0)
+				TS_TRACE(Common::String::format("%s stereo mix: %.1f Mframes/s", list[i].name, kFrames * (double)kIterations / elapsed / 1000.0).c_str());
+		}
+
+		delete[] in;
+		delete[] out;
+#endif
+	}
+};
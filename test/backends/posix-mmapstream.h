@@ -0,0 +1,150 @@
+#include <cxxtest/TestSuite.h>
+
+#include "backends/fs/posix/posix-iostream.h"
+#include "backends/fs/posix/posix-mmapstream.h"
+#include "common/file.h"
+#include "common/random.h"
+#include "common/substream.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class PosixMmapStreamTestSuite : public CxxTest::TestSuite
+{
+	public:
+	static const char *archivePath() { return "test/mmapstream.dat"; }
+	static const char *smallPath() { return "test/mmapstream-small.dat"; }
+
+	enum {
+		kResourceCount = 2048
+	};
+
+	// Write a synthetic archive, a table of offsets and sizes followed by
+	// resources of random size. Each resource is filled with its index.
+	static void writeArchive() {
+		Common::RandomSource rnd("mmapstream");
+		rnd.setSeed(1);
+
+		uint32 sizes[kResourceCount];
+		uint32 offset = 4 + kResourceCount * 8;
+		Common::DumpFile file;
+		TS_ASSERT(file.open(archivePath()));
+		file.writeUint32LE(kResourceCount);
+		for (int i = 0; i < kResourceCount; ++i) {
+			sizes[i] = 16 + rnd.getRandomNumber(4080);
+			file.writeUint32LE(offset);
+			file.writeUint32LE(sizes[i]);
+			offset += sizes[i];
+		}
+
+		byte buffer[4096];
+		for (int i = 0; i < kResourceCount; ++i) {
+			memset(buffer, i & 0xFF, sizes[i]);
+			file.write(buffer, sizes[i]);
+		}
+		file.close();
+	}
+
+	// The archive is 4 MB, so do not leave it in the build tree
+	static void removeFiles() {
+		remove(archivePath());
+		remove(smallPath());
+	}
+
+	// Load every resource the way engines do, through a substream of the
+	// archive which is read into a stream of its own
+	static bool loadResources(Common::SeekableReadStream *archive, const uint32 *order) {
+		bool valid = true;
+		for (int i = 0; i < kResourceCount; ++i) {
+			archive->seek(4 + order[i] * 8);
+			const uint32 offset = archive->readUint32LE();
+			const uint32 size = archive->readUint32LE();
+
+			Common::SafeSeekableSubReadStream sub(archive, offset, offset + size);
+			Common::SeekableReadStream *resource = sub.readStream(size);
+			valid &= (uint32)resource->size() == size;
+			valid &= resource->readByte() == (order[i] & 0xFF);
+			resource->seek(-1, SEEK_END);
+			valid &= resource->readByte() == (order[i] & 0xFF);
+			delete resource;
+		}
+		return valid;
+	}
+
+	static void shuffle(uint32 *order) {
+		Common::RandomSource rnd("mmapstream");
+		rnd.setSeed(2);
+		for (int i = 0; i < kResourceCount; ++i)
+			order[i] = i;
+		for (int i = kResourceCount - 1; i > 0; --i)
+			SWAP(order[i], order[rnd.getRandomNumber(i)]);
+	}
+
+	void test_resources_match() {
+		Common::install_null_g_system();
+		writeArchive();
+
+		uint32 order[kResourceCount];
+		shuffle(order);
+
+		Common::SeekableReadStream *mapped = PosixMmapStream::makeFromPath(archivePath());
+		TS_ASSERT(mapped);
+		TS_ASSERT(loadResources(mapped, order));
+
+		// Resources stay valid after the archive is closed
+		mapped->seek(4);
+		const uint32 offset = mapped->readUint32LE();
+		Common::SeekableReadStream *first = Common::SeekableSubReadStream(mapped, offset, offset + 16).readStream(16);
+		delete mapped;
+		TS_ASSERT_EQUALS(first->readByte(), 0);
+		delete first;
+
+		Common::SeekableReadStream *file = PosixIoStream::makeFromPath(archivePath(), false);
+		TS_ASSERT(file);
+		TS_ASSERT(loadResources(file, order));
+		delete file;
+
+		// Small files are read through stdio
+		Common::DumpFile small;
+		TS_ASSERT(small.open(smallPath()));
+		small.writeUint32LE(0x12345678);
+		small.close();
+		Common::SeekableReadStream *smallFile = PosixMmapStream::makeFromPath(smallPath());
+		TS_ASSERT(smallFile);
+		TS_ASSERT_EQUALS(smallFile->size(), 4);
+		TS_ASSERT_EQUALS(smallFile->readUint32LE(), 0x12345678u);
+		delete smallFile;
+		TS_ASSERT(!PosixMmapStream::makeFromPath("test/mmapstream-missing.dat"));
+
+		removeFiles();
+	}
+
+	void test_benchmark() {
+		Common::install_null_g_system();
+		writeArchive();
+
+		const int kPasses = 8;
+		uint32 order[kResourceCount];
+		shuffle(order);
+
+		uint32 times[2];
+		for (int mapped = 0; mapped < 2; ++mapped) {
+			const uint32 start = g_system->getMillis();
+			for (int pass = 0; pass < kPasses; ++pass) {
+				Common::SeekableReadStream *archive;
+				if (mapped)
+					archive = PosixMmapStream::makeFromPath(archivePath());
+				else
+					archive = PosixIoStream::makeFromPath(archivePath(), false);
+				loadResources(archive, order);
+				delete archive;
+			}
+			times[mapped] = MAX<uint32>(g_system->getMillis() - start, 1);
+		}
+
+		TS_TRACE(Common::String::format("Loading %d resources: %u ms with stdio, %u ms mapped",
+		                                kResourceCount * kPasses, times[0], times[1]).c_str());
+
+		removeFiles();
+	}
+};
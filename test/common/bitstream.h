@@ -2,6 +2,10 @@
 
 #include "common/bitstream.h"
 #include "common/memstream.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
 
 class BitStreamTestSuite : public CxxTest::TestSuite
 {
@@ -255,4 +259,160 @@ public:
 		tmpl_align_16<Common::MemoryReadStream, Common::BitStream16BELSB>();
 		tmpl_align_16<Common::BitStreamMemoryStream, Common::BitStreamMemory16BELSB>();
 	}
+
+private:
+	/**
+	 * Run the same random reads on a bit stream over a generic stream and
+	 * on one over memory, which is specialized, up to past their end.
+	 */
+	template<class BS, class MemoryBS>
+	void tmpl_memory_matches_generic(uint32 size) {
+		Common::RandomSource rnd("bitstream");
+		rnd.setSeed(size);
+
+		byte *contents = new byte[size];
+		for (uint32 i = 0; i < size; i++)
+			contents[i] = rnd.getRandomNumber(255);
+
+		Common::MemoryReadStream ms(contents, size);
+		Common::BitStreamMemoryStream bms(contents, size);
+		BS bs(ms);
+		MemoryBS mbs(bms);
+		TS_ASSERT_EQUALS(bs.size(), mbs.size());
+
+		int differences = 0;
+		while (bs.pos() < bs.size() + 64) {
+			const uint n = rnd.getRandomNumber(32);
+			switch (rnd.getRandomNumber(6)) {
+			case 0:
+				differences += bs.getBits(n) != mbs.getBits(n);
+				break;
+			case 1:
+				differences += bs.peekBits(n) != mbs.peekBits(n);
+				break;
+			case 2:
+				differences += bs.getBit() != mbs.getBit();
+				break;
+			case 3:
+				differences += bs.peekBit() != mbs.peekBit();
+				break;
+			case 4:
+				bs.skip(n * 3);
+				mbs.skip(n * 3);
+				break;
+			case 5:
+				bs.align();
+				mbs.align();
+				break;
+			default: {
+				uint32 x = n, y = n;
+				bs.addBit(x, n % 31);
+				mbs.addBit(y, n % 31);
+				differences += x != y;
+				break;
+			}
+			}
+
+			differences += bs.pos() != mbs.pos() || bs.eos() != mbs.eos();
+		}
+		TS_ASSERT_EQUALS(differences, 0);
+
+		bs.rewind();
+		mbs.rewind();
+		TS_ASSERT_EQUALS(bs.getBits(32), mbs.getBits(32));
+
+		delete[] contents;
+	}
+public:
+	void test_memory_matches_generic() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const uint32 sizes[] = { 4, 13, 300 };
+		for (int i = 0; i < ARRAYSIZE(sizes); i++) {
+			tmpl_memory_matches_generic<Common::BitStream8MSB, Common::BitStreamMemory8MSB>(sizes[i]);
+			tmpl_memory_matches_generic<Common::BitStream8LSB, Common::BitStreamMemory8LSB>(sizes[i]);
+			tmpl_memory_matches_generic<Common::BitStream16LEMSB, Common::BitStreamMemory16LEMSB>(sizes[i]);
+			tmpl_memory_matches_generic<Common::BitStream16LELSB, Common::BitStreamMemory16LELSB>(sizes[i]);
+			tmpl_memory_matches_generic<Common::BitStream16BEMSB, Common::BitStreamMemory16BEMSB>(sizes[i]);
+			tmpl_memory_matches_generic<Common::BitStream16BELSB, Common::BitStreamMemory16BELSB>(sizes[i]);
+			tmpl_memory_matches_generic<Common::BitStream32LEMSB, Common::BitStreamMemory32LEMSB>(sizes[i]);
+			tmpl_memory_matches_generic<Common::BitStream32LELSB, Common::BitStreamMemory32LELSB>(sizes[i]);
+			tmpl_memory_matches_generic<Common::BitStream32BEMSB, Common::BitStreamMemory32BEMSB>(sizes[i]);
+			tmpl_memory_matches_generic<Common::BitStream32BELSB, Common::BitStreamMemory32BELSB>(sizes[i]);
+		}
+#endif
+	}
+
+private:
+	/**
+	 * Read the buffer with the given reads, which are looked up by
+	 * peeking when they are negative, like a VLC decoder does.
+	 */
+	template<class BS>
+	static uint32 readAll(BS &bs, const Common::Array<int> &reads) {
+		uint32 sum = 0;
+		uint i = 0;
+		while (bs.pos() + 64 < bs.size()) {
+			const int n = reads[i++ % reads.size()];
+			if (n < 0) {
+				sum += bs.peekBits(-n);
+				bs.skip(-n / 2 + 1);
+			} else if (n == 1) {
+				sum += bs.getBit();
+			} else {
+				sum += bs.getBits(n);
+			}
+		}
+		return sum;
+	}
+
+	template<class BS, class MemoryBS>
+	void tmpl_benchmark(const char *name, int minBits, int maxBits, bool peek) {
+		const uint32 kSize = 4 << 20;
+		Common::RandomSource rnd("bitstream");
+		byte *contents = new byte[kSize];
+		for (uint32 i = 0; i < kSize; i++)
+			contents[i] = rnd.getRandomNumber(255);
+
+		Common::Array<int> reads;
+		for (int i = 0; i < 4096; i++) {
+			const int n = minBits + rnd.getRandomNumber(maxBits - minBits);
+			reads.push_back(peek && rnd.getRandomNumber(1) ? -n : n);
+		}
+
+		uint32 times[2];
+		uint32 sums[2];
+
+		uint32 start = g_system->getMillis();
+		Common::MemoryReadStream ms(contents, kSize);
+		BS bs(ms);
+		sums[0] = readAll(bs, reads);
+		times[0] = MAX<uint32>(g_system->getMillis() - start, 1);
+
+		start = g_system->getMillis();
+		Common::BitStreamMemoryStream bms(contents, kSize);
+		MemoryBS mbs(bms);
+		sums[1] = readAll(mbs, reads);
+		times[1] = MAX<uint32>(g_system->getMillis() - start, 1);
+
+		TS_ASSERT_EQUALS(sums[0], sums[1]);
+		TS_TRACE(Common::String::format("%s: %u Mbit/s generic, %u Mbit/s memory", name, kSize * 8 / 1000 / times[0], kSize * 8 / 1000 / times[1]).c_str());
+
+		delete[] contents;
+	}
+public:
+	// Reports the read speed for the bit layouts and read patterns of decoders
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		tmpl_benchmark<Common::BitStream32LELSB, Common::BitStreamMemory32LELSB>("Bink (32LELSB)", 1, 8, false);
+		tmpl_benchmark<Common::BitStream8LSB, Common::BitStreamMemory8LSB>("Indeo (8LSB, VLC)", 1, 13, true);
+		tmpl_benchmark<Common::BitStream32BEMSB, Common::BitStreamMemory32BEMSB>("SVQ1 (32BEMSB, VLC)", 1, 12, true);
+		tmpl_benchmark<Common::BitStream32LELSB, Common::BitStreamMemory32LELSB>("QDM2 (32LELSB)", 1, 16, true);
+		tmpl_benchmark<Common::BitStream8MSB, Common::BitStreamMemory8MSB>("MPEG audio (8MSB)", 1, 16, false);
+		tmpl_benchmark<Common::BitStream16LEMSB, Common::BitStreamMemory16LEMSB>("PSX (16LEMSB, VLC)", 1, 17, true);
+#endif
+	}
 };
@@ -2,6 +2,23 @@
 
 #include "common/memstream.h"
 #include "common/bufferedstream.h"
+#include "common/str.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+/** A stream over memory which takes some time for each read, like a slow disc. */
+class SlowReadStream : public Common::MemoryReadStream {
+	uint _delay;
+
+public:
+	SlowReadStream(const byte *data, uint32 size, uint delay) : Common::MemoryReadStream(data, size), _delay(delay) {}
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize) {
+		g_system->delayMillis(_delay);
+		return Common::MemoryReadStream::read(dataPtr, dataSize);
+	}
+};
 
 class BufferedSeekableReadStreamTestSuite : public CxxTest::TestSuite {
 	public:
@@ -91,4 +108,116 @@ class BufferedSeekableReadStreamTestSuite : public CxxTest::TestSuite {
 
 		delete &ssrs;
 	}
+
+	void test_prefetch_traverse() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+
+		Common::SeekableReadStream &ssrs
+			= *Common::wrapPrefetchingSeekableReadStream(&ms, 4, DisposeAfterUse::NO);
+
+		byte i, b;
+		for (i = 0; i < 10; ++i) {
+			TS_ASSERT(!ssrs.eos());
+
+			TS_ASSERT_EQUALS(i, ssrs.pos());
+
+			ssrs.read(&b, 1);
+			TS_ASSERT_EQUALS(i, b);
+		}
+
+		TS_ASSERT(!ssrs.eos());
+
+		TS_ASSERT_EQUALS((uint)0, ssrs.read(&b, 1));
+		TS_ASSERT(ssrs.eos());
+
+		delete &ssrs;
+#endif
+	}
+
+	void test_prefetch_seek() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const uint32 kSize = 10000;
+		byte *contents = new byte[kSize];
+		for (uint32 i = 0; i < kSize; ++i)
+			contents[i] = (byte)(i * 7 + (i >> 8));
+		Common::MemoryReadStream ms(contents, kSize);
+
+		Common::SeekableReadStream *ssrs = Common::wrapPrefetchingSeekableReadStream(&ms, 256, DisposeAfterUse::NO);
+		TS_ASSERT_EQUALS(ssrs->size(), (int32)kSize);
+
+		// Mix sequential reads with seeks inside, before and past the buffers
+		const int32 offsets[] = { 0, 100, 300, 255, 5000, 4999, 9990, 1024, 1023, 0, 7777, 9500 };
+		byte buffer[600];
+		for (uint i = 0; i < ARRAYSIZE(offsets); ++i) {
+			TS_ASSERT(ssrs->seek(offsets[i], SEEK_SET));
+			TS_ASSERT_EQUALS(ssrs->pos(), offsets[i]);
+
+			const uint32 expected = MIN<uint32>(sizeof(buffer), kSize - offsets[i]);
+			TS_ASSERT_EQUALS(ssrs->read(buffer, sizeof(buffer)), expected);
+			TS_ASSERT_SAME_DATA(buffer, contents + offsets[i], expected);
+			TS_ASSERT_EQUALS(ssrs->pos(), (int32)(offsets[i] + expected));
+		}
+		TS_ASSERT(ssrs->eos());
+
+		TS_ASSERT(ssrs->seek(-10, SEEK_END));
+		TS_ASSERT(!ssrs->eos());
+		TS_ASSERT_EQUALS(ssrs->readByte(), contents[kSize - 10]);
+		TS_ASSERT(ssrs->seek(-11, SEEK_CUR));
+		TS_ASSERT_EQUALS(ssrs->readByte(), contents[kSize - 20]);
+		TS_ASSERT(!ssrs->seek(1, SEEK_END));
+
+		delete ssrs;
+		delete[] contents;
+#endif
+	}
+
+	// Reads a slow stream while "decoding" each block for some time. The
+	// prefetching stream reads the next block meanwhile, so it should
+	// take about half the time of the plain buffered one.
+	void test_prefetch_throughput() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const uint32 kBlockSize = 4096;
+		const uint32 kBlocks = 16;
+		const uint kReadDelay = 5;
+		const uint kWorkDelay = 5;
+
+		byte *contents = new byte[kBlockSize * kBlocks];
+		for (uint32 i = 0; i < kBlockSize * kBlocks; ++i)
+			contents[i] = (byte)i;
+		byte *block = new byte[kBlockSize];
+
+		uint32 times[2];
+		for (int prefetch = 0; prefetch < 2; ++prefetch) {
+			SlowReadStream *slow = new SlowReadStream(contents, kBlockSize * kBlocks, kReadDelay);
+			const uint32 start = g_system->getMillis();
+			Common::SeekableReadStream *stream = prefetch ?
+				Common::wrapPrefetchingSeekableReadStream(slow, kBlockSize, DisposeAfterUse::YES) :
+				Common::wrapBufferedSeekableReadStream(slow, kBlockSize, DisposeAfterUse::YES);
+
+			for (uint32 i = 0; i < kBlocks; ++i) {
+				TS_ASSERT_EQUALS(stream->read(block, kBlockSize), kBlockSize);
+				TS_ASSERT_SAME_DATA(block, contents + i * kBlockSize, kBlockSize);
+				g_system->delayMillis(kWorkDelay);
+			}
+			TS_ASSERT_EQUALS(stream->read(block, 1), 0u);
+			TS_ASSERT(stream->eos());
+
+			delete stream;
+			times[prefetch] = MAX<uint32>(g_system->getMillis() - start, 1);
+		}
+
+		TS_TRACE(Common::String::format("%u blocks: %u ms buffered, %u ms prefetching", kBlocks, times[0], times[1]).c_str());
+
+		delete[] block;
+		delete[] contents;
+#endif
+	}
 };
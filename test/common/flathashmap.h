@@ -0,0 +1,241 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flathashmap.h"
+#include "common/hash-str.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		TS_ASSERT(container2.contains("FOO"));
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+		TS_ASSERT(!container2.contains("foo"));
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		container.erase(container.find(0));
+		TS_ASSERT(!container.empty());
+		container.erase(1);
+		container.erase(2);
+		container.erase(container.find(3));
+		TS_ASSERT(!container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+		TS_ASSERT_EQUALS(container.find(4), container.end());
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+		container[2] = 45;
+
+		const Common::FlatHashMap<int, int> &containerRef = container;
+
+		TS_ASSERT_EQUALS(containerRef[1], -1);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(0), 17);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(0, -10), 17);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17, -10), -10);
+
+		int out = 5;
+		TS_ASSERT(!containerRef.tryGetVal(17, out));
+		TS_ASSERT_EQUALS(out, 5);
+		TS_ASSERT(containerRef.tryGetVal(2, out));
+		TS_ASSERT_EQUALS(out, 45);
+	}
+
+	void test_copy() {
+		Common::FlatHashMap<int, Common::String> map1, container2;
+		map1[323] = "foo";
+		map1[7] = "bar";
+		map1.erase(7);
+		container2 = map1;
+		Common::FlatHashMap<int, Common::String> container3(container2);
+		map1[323] = "changed";
+		TS_ASSERT_EQUALS(container2[323], "foo");
+		TS_ASSERT_EQUALS(container3[323], "foo");
+		TS_ASSERT(!container3.contains(7));
+		TS_ASSERT_EQUALS(container3.size(), 1u);
+	}
+
+	void test_collision() {
+		// Keys which share their low bits used to collide in HashMap; here
+		// they check that erasing the middle of a probe sequence works.
+		Common::FlatHashMap<int, int> h;
+		for (int i = 0; i < 12; ++i)
+			h[i * 4096 + 5] = i;
+		for (int i = 0; i < 12; i += 2)
+			h.erase(i * 4096 + 5);
+		for (int i = 0; i < 12; ++i)
+			TS_ASSERT_EQUALS(h.contains(i * 4096 + 5), (i & 1) != 0);
+		for (int i = 0; i < 12; i += 2)
+			h[i * 4096 + 5] = i;
+		for (int i = 0; i < 12; ++i)
+			TS_ASSERT_EQUALS(h[i * 4096 + 5], i);
+	}
+
+	void test_iterator_erase() {
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 100; ++i)
+			container[i] = i * 2;
+
+		// Erasing the current entry must not disturb the iteration, just
+		// like with HashMap.
+		int visited = 0;
+		Common::FlatHashMap<int, int>::iterator i;
+		for (i = container.begin(); i != container.end(); ) {
+			TS_ASSERT_EQUALS(i->_value, i->_key * 2);
+			++visited;
+			if (i->_key % 3)
+				container.erase(i++);
+			else
+				++i;
+		}
+		TS_ASSERT_EQUALS(visited, 100);
+		TS_ASSERT_EQUALS(container.size(), 34u);
+
+		int found = 0;
+		Common::FlatHashMap<int, int>::const_iterator j;
+		const Common::FlatHashMap<int, int> &containerRef = container;
+		for (j = containerRef.begin(); j != containerRef.end(); ++j) {
+			TS_ASSERT_EQUALS(j->_key % 3, 0);
+			++found;
+		}
+		TS_ASSERT_EQUALS(found, 34);
+	}
+
+	void test_random_against_hashmap() {
+		Common::RandomSource rnd("flathashmap");
+		Common::HashMap<uint, uint> reference;
+		Common::FlatHashMap<uint, uint> container;
+
+		for (uint step = 0; step < 50000; ++step) {
+			const uint key = rnd.getRandomNumber(2047);
+			switch (rnd.getRandomNumber(3)) {
+			case 0:
+			case 1:
+				reference[key] = step;
+				container[key] = step;
+				break;
+			case 2:
+				reference.erase(key);
+				container.erase(key);
+				break;
+			default:
+				TS_ASSERT_EQUALS(container.contains(key), reference.contains(key));
+				TS_ASSERT_EQUALS(container.getValOrDefault(key, 0xFFFFFFFF), reference.getValOrDefault(key, 0xFFFFFFFF));
+				break;
+			}
+		}
+
+		TS_ASSERT_EQUALS(container.size(), reference.size());
+		for (Common::HashMap<uint, uint>::const_iterator i = reference.begin(); i != reference.end(); ++i)
+			TS_ASSERT_EQUALS(container.getVal(i->_key), i->_value);
+	}
+
+	// Capacity estimates follow the growth rules of both containers.
+	static uint hashMapMemory(uint count, uint nodeSize) {
+		uint capacity = 16;
+		for (uint size = 1; size <= count; ++size) {
+			if (size * 3 > capacity * 2)
+				capacity = capacity < 500 ? capacity * 4 : capacity * 2;
+		}
+		return capacity * sizeof(void *) + count * nodeSize;
+	}
+
+	static uint flatHashMapMemory(uint count, uint nodeSize) {
+		uint capacity = 16;
+		for (uint size = 1; size <= count; ++size) {
+			if (size * 4 > capacity * 3)
+				capacity *= 2;
+		}
+		return capacity * (nodeSize + 1);
+	}
+
+	template<class Map, class Key>
+	static void benchmark(const char *name, const Key *keys, uint count, uint (*memory)(uint, uint)) {
+		const int kRounds = 10;
+		uint32 insertTime = 0, lookupTime = 0, iterateTime = 0;
+		uint sum = 0;
+
+		for (int round = 0; round < kRounds; ++round) {
+			Map map;
+
+			uint32 start = g_system->getMillis();
+			for (uint i = 0; i < count; ++i)
+				map[keys[i]] = i;
+			insertTime += g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			for (int pass = 0; pass < 4; ++pass) {
+				for (uint i = 0; i < count; ++i)
+					sum += map.getValOrDefault(keys[(i * 40503) % count]);
+			}
+			lookupTime += g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			for (int pass = 0; pass < 4; ++pass) {
+				for (typename Map::const_iterator i = map.begin(); i != map.end(); ++i)
+					sum += i->_value;
+			}
+			iterateTime += g_system->getMillis() - start;
+		}
+
+		TS_ASSERT_DIFFERS(sum, 0u);
+		const uint nodeSize = sizeof(*Map().begin());
+		TS_TRACE(Common::String::format("%s: insert %u ms, lookup %u ms, iterate %u ms, ~%u KiB", name,
+		                                insertTime, lookupTime, iterateTime, memory(count, nodeSize) / 1024).c_str());
+	}
+
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const uint kCount = 20000;
+		Common::String *keys = new Common::String[kCount];
+		int *intKeys = new int[kCount];
+		for (uint i = 0; i < kCount; ++i) {
+			keys[i] = Common::String::format("key_%u", i * 2654435761u);
+			intKeys[i] = i * 7;
+		}
+
+		benchmark<Common::HashMap<Common::String, uint> >("HashMap<String>", keys, kCount, hashMapMemory);
+		benchmark<Common::FlatHashMap<Common::String, uint> >("FlatHashMap<String>", keys, kCount, flatHashMapMemory);
+		benchmark<Common::HashMap<int, uint> >("HashMap<int>", intKeys, kCount, hashMapMemory);
+		benchmark<Common::FlatHashMap<int, uint> >("FlatHashMap<int>", intKeys, kCount, flatHashMapMemory);
+
+		delete[] intKeys;
+		delete[] keys;
+#endif
+	}
+};
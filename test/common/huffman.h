@@ -2,6 +2,13 @@
 #include "common/huffman.h"
 #include "common/bitstream.h"
 #include "common/memstream.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "audio/decoders/wmadata.h"
+#include "video/binkdata.h"
+
+#include "../null_osystem.h"
 
 /**
 * A test suite for the Huffman decoder in common/huffman.h
@@ -94,4 +101,182 @@ class HuffmanTestSuite : public CxxTest::TestSuite {
 		TS_ASSERT_EQUALS(h.getSymbol(bs), expected[5]);
 		TS_ASSERT_EQUALS(h.getSymbol(bs), expected[6]);
 	}
+
+	/** Codes of a table, optionally reversed into the bit order of LSB first streams. */
+	struct CodeTable {
+		Common::Array<uint32> codes;
+		Common::Array<uint8> lengths;
+		Common::Array<uint64> weights; // Cumulative probabilities of the codes, scaled to 2^maxLength
+		uint8 maxLength;
+
+		CodeTable(const uint32 *c, const uint8 *l, uint count, bool reverse, bool canonical) : maxLength(0) {
+			for (uint i = 0; i < count; i++)
+				maxLength = MAX(maxLength, l[i]);
+
+			// Canonical codes replace the given ones when asked to, which
+			// needs the lengths in ascending order
+			uint32 next = 0;
+			uint8 lastLength = 0;
+			uint64 weight = 0;
+			for (uint i = 0; i < count; i++) {
+				uint32 code = c ? c[i] : 0;
+				if (canonical) {
+					next <<= l[i] - lastLength;
+					lastLength = l[i];
+					code = next++;
+				}
+				if (reverse)
+					code = Common::REVERSEBITS(code) >> (32 - l[i]);
+
+				weight += (uint64)1 << (maxLength - l[i]);
+				codes.push_back(code);
+				lengths.push_back(l[i]);
+				weights.push_back(weight);
+			}
+		}
+
+		uint pick(Common::RandomSource &rnd) const {
+			const uint64 r = (((uint64)rnd.getRandomNumber(0x7FFFFFFF) << 31) | rnd.getRandomNumber(0x7FFFFFFF)) % weights.back();
+			uint lo = 0, hi = weights.size() - 1;
+			while (lo < hi) {
+				const uint mid = (lo + hi) / 2;
+				if (weights[mid] > r)
+					hi = mid;
+				else
+					lo = mid + 1;
+			}
+			return lo;
+		}
+	};
+
+	/**
+	 * Encode count codes of the table, picked with the probabilities of
+	 * their lengths, into a buffer padded to whole 32-bit values.
+	 */
+	static byte *encode(const CodeTable &table, bool msb2lsb, uint count, Common::Array<uint32> &symbols, uint32 &size) {
+		Common::RandomSource rnd("huffman");
+		rnd.setSeed(count);
+
+		symbols.clear();
+		Common::Array<byte> data;
+		uint64 container = 0;
+		uint bits = 0;
+		for (uint i = 0; i < count; i++) {
+			const uint symbol = table.pick(rnd);
+			symbols.push_back(symbol);
+
+			const uint32 code = table.codes[symbol];
+			const uint8 length = table.lengths[symbol];
+			if (msb2lsb)
+				container = (container << length) | code;
+			else
+				container |= (uint64)code << bits;
+			bits += length;
+
+			while (bits >= 8) {
+				bits -= 8;
+				if (msb2lsb) {
+					data.push_back((byte)(container >> bits));
+				} else {
+					data.push_back((byte)container);
+					container >>= 8;
+				}
+			}
+		}
+		if (bits)
+			data.push_back(msb2lsb ? (byte)(container << (8 - bits)) : (byte)container);
+		while (data.size() % 4)
+			data.push_back(0);
+
+		size = data.size();
+		byte *buffer = (byte *)malloc(size);
+		memcpy(buffer, data.data(), size);
+		return buffer;
+	}
+
+	template<class BITSTREAM>
+	void checkTable(const CodeTable &table, bool msb2lsb) {
+		Common::Huffman<BITSTREAM> h(0, table.codes.size(), table.codes.data(), table.lengths.data());
+
+		Common::Array<uint32> expected;
+		uint32 size;
+		byte *data = encode(table, msb2lsb, 5000, expected, size);
+
+		Common::MemoryReadStream ms(data, size, DisposeAfterUse::YES);
+		BITSTREAM bits(ms);
+		int errors = 0;
+		for (uint i = 0; i < expected.size(); i++)
+			errors += h.getSymbol(bits) != expected[i];
+		TS_ASSERT_EQUALS(errors, 0);
+
+		bits.rewind();
+		Common::Array<uint16> symbols;
+		symbols.resize(expected.size());
+		h.getSymbols(bits, symbols.data(), 17);
+		h.getSymbols(bits, symbols.data() + 17, expected.size() - 17);
+		errors = 0;
+		for (uint i = 0; i < expected.size(); i++)
+			errors += symbols[i] != expected[i];
+		TS_ASSERT_EQUALS(errors, 0);
+	}
+
+	void test_long_codes() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Real tables with codes of up to 22 bits, read MSB first
+		checkTable<Common::BitStream8MSB>(CodeTable(Audio::coef2Huffcodes, Audio::coef2Huffbits, ARRAYSIZE(Audio::coef2Huffbits), false, false), true);
+		checkTable<Common::BitStream8MSB>(CodeTable(Audio::scaleHuffCodes, Audio::scaleHuffBits, ARRAYSIZE(Audio::scaleHuffBits), false, false), true);
+
+		// Canonical codes of up to 32 bits in both bit orders, and real
+		// codes with their bits reversed
+		const uint8 lengths[] = { 1, 3, 4, 6, 9, 10, 10, 13, 16, 17, 20, 24, 31, 32, 32 };
+		checkTable<Common::BitStream8MSB>(CodeTable(nullptr, lengths, ARRAYSIZE(lengths), false, true), true);
+		checkTable<Common::BitStream32LELSB>(CodeTable(nullptr, lengths, ARRAYSIZE(lengths), true, true), false);
+		checkTable<Common::BitStream32LELSB>(CodeTable(Audio::coef3Huffcodes, Audio::coef3Huffbits, ARRAYSIZE(Audio::coef3Huffbits), true, false), false);
+
+		// Short codes of Bink, read LSB first
+		for (int i = 0; i < 16; i++)
+			checkTable<Common::BitStream32LELSB>(CodeTable(Video::binkHuffmanCodes[i], Video::binkHuffmanLengths[i], 16, false, false), false);
+#endif
+	}
+
+	template<class BITSTREAM>
+	void benchmarkTable(const char *name, const CodeTable &table, bool msb2lsb) {
+		const uint kSymbols = 2000000;
+		Common::Array<uint32> expected;
+		uint32 size;
+		byte *data = encode(table, msb2lsb, kSymbols, expected, size);
+		Common::Array<uint32> symbols;
+		symbols.resize(kSymbols);
+
+		const uint32 start = g_system->getMillis();
+		Common::Huffman<BITSTREAM> h(0, table.codes.size(), table.codes.data(), table.lengths.data());
+		const uint32 built = g_system->getMillis();
+
+		Common::MemoryReadStream ms(data, size, DisposeAfterUse::YES);
+		BITSTREAM bits(ms);
+		for (uint i = 0; i < kSymbols; i++)
+			symbols[i] = h.getSymbol(bits);
+		const uint32 single = g_system->getMillis();
+
+		bits.rewind();
+		h.getSymbols(bits, symbols.data(), kSymbols);
+		const uint32 bulk = g_system->getMillis();
+
+		TS_TRACE(Common::String::format("%s: built in %u ms, %u Msymbols/s getSymbol(), %u Msymbols/s getSymbols()", name, built - start,
+		                                kSymbols / 1000 / MAX<uint32>(single - built, 1), kSymbols / 1000 / MAX<uint32>(bulk - single, 1)).c_str());
+	}
+
+	// Reports the decoding speed with the tables of WMA and Bink
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		benchmarkTable<Common::BitStream8MSB>("WMA coefficients 2", CodeTable(Audio::coef2Huffcodes, Audio::coef2Huffbits, ARRAYSIZE(Audio::coef2Huffbits), false, false), true);
+		benchmarkTable<Common::BitStream8MSB>("WMA coefficients 4", CodeTable(Audio::coef4Huffcodes, Audio::coef4Huffbits, ARRAYSIZE(Audio::coef4Huffbits), false, false), true);
+		benchmarkTable<Common::BitStream8MSB>("WMA scale factors", CodeTable(Audio::scaleHuffCodes, Audio::scaleHuffBits, ARRAYSIZE(Audio::scaleHuffBits), false, false), true);
+		benchmarkTable<Common::BitStream32LELSB>("Bink 15", CodeTable(Video::binkHuffmanCodes[15], Video::binkHuffmanLengths[15], 16, false, false), false);
+#endif
+	}
 };
@@ -1,6 +1,7 @@
 #include <cxxtest/TestSuite.h>
 
 #include "common/memstream.h"
+#include "common/substream.h"
 
 class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 	public:
@@ -104,4 +105,45 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	struct CountingDeleter {
+		int *count;
+
+		void operator()(const byte *data) {
+			++*count;
+			delete[] data;
+		}
+	};
+
+	void test_shared_substreams() {
+		int deleted = 0;
+		byte *contents = new byte[16];
+		for (int i = 0; i < 16; ++i)
+			contents[i] = i;
+
+		CountingDeleter deleter = { &deleted };
+		Common::SeekableReadStream *ms = new Common::SharedMemoryReadStream(Common::SharedPtr<const byte>(contents, deleter), contents, 16);
+		Common::SafeSeekableSubReadStream *sub = new Common::SafeSeekableSubReadStream(ms, 4, 12, DisposeAfterUse::YES);
+
+		// Substreams read from the shared memory without copying it
+		sub->seek(2);
+		Common::SeekableReadStream *data = sub->readStream(4);
+		TS_ASSERT_EQUALS(data->size(), 4);
+		TS_ASSERT_EQUALS(sub->pos(), 6);
+		TS_ASSERT_EQUALS(data->readByte(), 6);
+
+		// Reading past the end of the substream is clamped
+		Common::SeekableReadStream *tail = sub->readStream(8);
+		TS_ASSERT_EQUALS(tail->size(), 2);
+		TS_ASSERT(sub->eos());
+		TS_ASSERT_EQUALS(tail->readByte(), 10);
+		delete tail;
+
+		// The memory outlives the stream it was created with
+		delete sub;
+		TS_ASSERT_EQUALS(deleted, 0);
+		TS_ASSERT_EQUALS(data->readByte(), 7);
+		delete data;
+		TS_ASSERT_EQUALS(deleted, 1);
+	}
 };
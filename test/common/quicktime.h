@@ -0,0 +1,325 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/memstream.h"
+#include "common/quicktime.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class QuickTimeTestParser : public Common::QuickTimeParser {
+public:
+	using Common::QuickTimeParser::Track;
+
+	const Track &getTrack() const { return *_tracks[0]; }
+
+protected:
+	SampleDesc *readSampleDesc(Track *track, uint32 format, uint32 descSize) override { return nullptr; }
+};
+
+class QuickTimeTestSuite : public CxxTest::TestSuite {
+public:
+	typedef QuickTimeTestParser::Track Track;
+
+	class AtomWriter {
+	public:
+		AtomWriter() : _out(DisposeAfterUse::NO) {}
+
+		void begin(uint32 tag) {
+			_atoms.push_back(_out.pos());
+			_out.writeUint32BE(0);
+			_out.writeUint32BE(tag);
+		}
+
+		void end() {
+			const uint32 start = _atoms.back();
+			_atoms.pop_back();
+			WRITE_BE_UINT32(_out.getData() + start, _out.pos() - start);
+		}
+
+		// Version and flags, then the entry count and the entries
+		void table(uint32 tag, const Common::Array<uint32> &values, uint32 count) {
+			begin(tag);
+			_out.writeUint32BE(0);
+			_out.writeUint32BE(count);
+			for (uint i = 0; i < values.size(); i++)
+				_out.writeUint32BE(values[i]);
+			end();
+		}
+
+		Common::MemoryWriteStreamDynamic _out;
+
+	private:
+		Common::Array<uint32> _atoms;
+	};
+
+	// A video track with frames of varying durations in chunks of varying
+	// sizes, and a keyframe every few frames after the first ones
+	static Common::SeekableReadStream *createMovie(uint32 chunkCount, uint seed) {
+		Common::RandomSource rnd("quicktime");
+		rnd.setSeed(seed);
+
+		Common::Array<uint32> stsc, stco, stsz, stts, stss;
+		uint32 sampleCount = 0;
+		for (uint32 chunk = 0; chunk < chunkCount; ) {
+			const uint32 run = MIN<uint32>(1 + rnd.getRandomNumber(3), chunkCount - chunk);
+			const uint32 samples = 1 + rnd.getRandomNumber(7);
+			stsc.push_back(chunk + 1);
+			stsc.push_back(samples);
+			stsc.push_back(1);
+			chunk += run;
+			sampleCount += run * samples;
+		}
+
+		for (uint32 chunk = 0; chunk < chunkCount; chunk++)
+			stco.push_back(0x1000 + chunk * 0x100);
+
+		for (uint32 sample = 0; sample < sampleCount; sample++)
+			stsz.push_back(rnd.getRandomNumber(0xFF));
+
+		for (uint32 sample = 0; sample < sampleCount; ) {
+			const uint32 run = MIN<uint32>(1 + rnd.getRandomNumber(5), sampleCount - sample);
+			stts.push_back(run);
+			stts.push_back(100 + rnd.getRandomNumber(2900));
+			sample += run;
+		}
+
+		for (uint32 sample = 3; sample < sampleCount; sample += 1 + rnd.getRandomNumber(20))
+			stss.push_back(sample + 1);
+
+		AtomWriter writer;
+		writer.begin(MKTAG('m', 'o', 'o', 'v'));
+		writer.begin(MKTAG('t', 'r', 'a', 'k'));
+		writer.begin(MKTAG('m', 'd', 'i', 'a'));
+		writer.begin(MKTAG('h', 'd', 'l', 'r'));
+		writer._out.writeUint32BE(0);
+		writer._out.writeUint32BE(MKTAG('m', 'h', 'l', 'r'));
+		writer._out.writeUint32BE(MKTAG('v', 'i', 'd', 'e'));
+		writer._out.writeUint32BE(0);
+		writer._out.writeUint32BE(0);
+		writer._out.writeUint32BE(0);
+		writer.end();
+		writer.begin(MKTAG('m', 'i', 'n', 'f'));
+		writer.begin(MKTAG('s', 't', 'b', 'l'));
+		writer.table(MKTAG('s', 't', 't', 's'), stts, stts.size() / 2);
+		writer.table(MKTAG('s', 't', 's', 'c'), stsc, stsc.size() / 3);
+		writer.begin(MKTAG('s', 't', 's', 'z'));
+		writer._out.writeUint32BE(0);
+		writer._out.writeUint32BE(0); // sample size, 0 for a table
+		writer._out.writeUint32BE(sampleCount);
+		for (uint32 i = 0; i < sampleCount; i++)
+			writer._out.writeUint32BE(stsz[i]);
+		writer.end();
+		writer.table(MKTAG('s', 't', 'c', 'o'), stco, stco.size());
+		writer.table(MKTAG('s', 't', 's', 's'), stss, stss.size());
+		writer.end();
+		writer.end();
+		writer.end();
+		writer.end();
+		writer.end();
+
+		return new Common::MemoryReadStream(writer._out.getData(), writer._out.size(), DisposeAfterUse::YES);
+	}
+
+	// The linear scans the decoders used before the tables were indexed
+
+	static int32 linearSampleChunk(const Track &track, uint32 sample, uint32 &sampleInChunk, uint32 &descId) {
+		uint32 totalSampleCount = 0;
+		uint32 sampleToChunkIndex = 0;
+
+		for (uint32 i = 0; i < track.chunkCount; i++) {
+			if (sampleToChunkIndex < track.sampleToChunkCount && i >= track.sampleToChunk[sampleToChunkIndex].first)
+				sampleToChunkIndex++;
+
+			totalSampleCount += track.sampleToChunk[sampleToChunkIndex - 1].count;
+
+			if (totalSampleCount > sample) {
+				descId = track.sampleToChunk[sampleToChunkIndex - 1].id;
+				sampleInChunk = track.sampleToChunk[sampleToChunkIndex - 1].count - totalSampleCount + sample;
+				return i;
+			}
+		}
+
+		return -1;
+	}
+
+	static uint32 linearChunkSampleCount(const Track &track, uint32 chunk) {
+		uint32 sampleCount = 0;
+
+		for (uint32 i = 0; i < track.sampleToChunkCount; i++)
+			if (chunk >= track.sampleToChunk[i].first)
+				sampleCount = track.sampleToChunk[i].count;
+
+		return sampleCount;
+	}
+
+	static uint32 linearSampleDuration(const Track &track, uint32 sample) {
+		uint32 curFrameIndex = 0;
+		for (int32 i = 0; i < track.timeToSampleCount; i++) {
+			curFrameIndex += track.timeToSample[i].count;
+			if (sample < curFrameIndex)
+				return track.timeToSample[i].duration;
+		}
+
+		return 0;
+	}
+
+	static uint32 linearSampleTime(const Track &track, uint32 sample) {
+		uint32 curSample = 0;
+		uint32 time = 0;
+
+		for (int32 i = 0; i < track.timeToSampleCount; i++) {
+			uint32 sampleCount = track.timeToSample[i].count;
+
+			if (sample < curSample + sampleCount) {
+				time += (sample - curSample) * track.timeToSample[i].duration;
+				break;
+			}
+
+			time += track.timeToSample[i].count * track.timeToSample[i].duration;
+			curSample += sampleCount;
+		}
+
+		return time;
+	}
+
+	static uint32 linearSampleAtTime(const Track &track, uint32 time, uint32 &sampleTime) {
+		uint32 frameNum = 0;
+		sampleTime = 0;
+
+		for (int32 i = 0; i < track.timeToSampleCount; i++) {
+			uint32 duration = track.timeToSample[i].count * track.timeToSample[i].duration;
+
+			if (sampleTime + duration >= time) {
+				uint32 frameInc = (time - sampleTime) / track.timeToSample[i].duration;
+				frameNum += frameInc;
+				sampleTime += frameInc * track.timeToSample[i].duration;
+				break;
+			}
+
+			frameNum += track.timeToSample[i].count;
+			sampleTime += duration;
+		}
+
+		return frameNum;
+	}
+
+	static uint32 linearKeyframe(const Track &track, uint32 frame) {
+		for (int i = track.keyframeCount - 1; i >= 0; i--)
+			if (track.keyframes[i] <= frame)
+				return track.keyframes[i];
+
+		return frame;
+	}
+
+	void test_sample_tables() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		QuickTimeTestParser parser;
+		TS_ASSERT(parser.parseStream(createMovie(500, 1)));
+		const Track &track = parser.getTrack();
+		TS_ASSERT_EQUALS(track.chunkCount, 500u);
+		TS_ASSERT_EQUALS(track.sampleCount, track.frameCount);
+
+		for (uint32 sample = 0; sample <= track.frameCount; sample++) {
+			uint32 sampleInChunk = 0, descId = 0, linearSampleInChunk = 0, linearDescId = 0;
+			const int32 chunk = track.findSampleChunk(sample, sampleInChunk, descId);
+			TS_ASSERT_EQUALS(chunk, linearSampleChunk(track, sample, linearSampleInChunk, linearDescId));
+			if (chunk >= 0) {
+				TS_ASSERT_EQUALS(sampleInChunk, linearSampleInChunk);
+				TS_ASSERT_EQUALS(descId, linearDescId);
+				TS_ASSERT_EQUALS(track.timeToSample[track.findTimeToSample(sample)].duration, (int)linearSampleDuration(track, sample));
+			} else {
+				TS_ASSERT_EQUALS(track.findTimeToSample(sample), -1);
+			}
+
+			TS_ASSERT_EQUALS(track.getSampleTime(sample), linearSampleTime(track, sample));
+			TS_ASSERT_EQUALS(track.findKeyframe(sample), linearKeyframe(track, sample));
+		}
+
+		uint32 firstSample = 0;
+		for (uint32 chunk = 0; chunk <= track.chunkCount; chunk++) {
+			TS_ASSERT_EQUALS(track.getChunkFirstSample(chunk), firstSample);
+			if (chunk < track.chunkCount) {
+				TS_ASSERT_EQUALS(track.getChunkSampleCount(chunk), linearChunkSampleCount(track, chunk));
+				firstSample += linearChunkSampleCount(track, chunk);
+			}
+		}
+
+		// Times on sample boundaries, in between and past the end
+		const uint32 duration = track.getSampleTime(track.frameCount);
+		for (uint32 time = 0; time <= duration + 100; time += 37) {
+			uint32 sampleTime = 0, linearTime = 0;
+			TS_ASSERT_EQUALS(track.findSampleAtTime(time, sampleTime), linearSampleAtTime(track, time, linearTime));
+			TS_ASSERT_EQUALS(sampleTime, linearTime);
+		}
+		for (uint32 sample = 0; sample < track.frameCount; sample++) {
+			uint32 sampleTime = 0;
+			TS_ASSERT_EQUALS(track.findSampleAtTime(track.getSampleTime(sample), sampleTime), sample);
+		}
+#endif
+	}
+
+	// Opens a two hour long video of 30 frames per second, and seeks in it
+	// with the lookups of the decoders
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const int kOpens = 10;
+		const int kSeeks = 500;
+
+		Common::SeekableReadStream *movie = createMovie(48000, 2);
+		const int32 movieSize = movie->size();
+		byte *movieData = new byte[movieSize];
+		movie->read(movieData, movieSize);
+		delete movie;
+
+		uint32 start = g_system->getMillis();
+		for (int i = 0; i < kOpens; i++) {
+			QuickTimeTestParser parser;
+			parser.parseStream(new Common::MemoryReadStream(movieData, movieSize));
+		}
+		const uint32 openTime = g_system->getMillis() - start;
+
+		QuickTimeTestParser parser;
+		parser.parseStream(new Common::MemoryReadStream(movieData, movieSize));
+		const Track &track = parser.getTrack();
+		const uint32 duration = track.getSampleTime(track.frameCount);
+
+		// The indexed lookups are repeated to be measurable
+		Common::RandomSource rnd("quicktime");
+		const int repeats[2] = { 1, 1000 };
+		uint32 times[2];
+		uint32 checksum[2] = { 0, 0 };
+		for (int indexed = 0; indexed < 2; indexed++) {
+			start = g_system->getMillis();
+			for (int repeat = 0; repeat < repeats[indexed]; repeat++) {
+				rnd.setSeed(3);
+				checksum[indexed] = 0;
+				for (int i = 0; i < kSeeks; i++) {
+					const uint32 time = rnd.getRandomNumber(duration - 1);
+					uint32 sampleTime, sampleInChunk = 0, descId = 0;
+					if (indexed) {
+						const uint32 frame = track.findKeyframe(track.findSampleAtTime(time, sampleTime));
+						checksum[1] += frame + track.findSampleChunk(frame, sampleInChunk, descId) + sampleInChunk;
+					} else {
+						const uint32 frame = linearKeyframe(track, linearSampleAtTime(track, time, sampleTime));
+						checksum[0] += frame + linearSampleChunk(track, frame, sampleInChunk, descId) + sampleInChunk;
+					}
+				}
+			}
+			times[indexed] = g_system->getMillis() - start;
+		}
+		TS_ASSERT_EQUALS(checksum[0], checksum[1]);
+
+		TS_TRACE(Common::String::format("%u frames: open %u us, seek %u ns linear, %u ns indexed", track.frameCount,
+		                                openTime * 1000 / kOpens, times[0] * 1000000 / kSeeks,
+		                                times[1] * 1000000 / (kSeeks * repeats[1])).c_str());
+
+		delete[] movieData;
+#endif
+	}
+};
@@ -0,0 +1,385 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/array.h"
+#include "common/memstream.h"
+#include "common/random.h"
+#include "common/system.h"
+#include "common/unzip.h"
+#include "common/zlib.h"
+
+#include "../null_osystem.h"
+
+class ZipTestSuite : public CxxTest::TestSuite
+{
+	public:
+	struct Member {
+		Common::String name;
+		byte *data;
+		uint32 size;
+		bool compress;
+	};
+
+	// Compress data as raw deflate, which is the gzip data without its
+	// header and trailer. Returns false when zlib is not available.
+	static bool deflate(const byte *data, uint32 size, Common::Array<byte> &deflated, uint32 &crc) {
+		Common::MemoryWriteStreamDynamic *buffer = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		Common::WriteStream *gzip = Common::wrapCompressedWriteStream(buffer);
+		if (gzip == buffer) {
+			delete buffer;
+			return false;
+		}
+
+		gzip->write(data, size);
+		gzip->finalize();
+		const byte *gzipData = buffer->getData();
+		const uint32 gzipSize = buffer->size();
+		deflated.resize(gzipSize - 18);
+		memcpy(deflated.begin(), gzipData + 10, gzipSize - 18);
+		crc = READ_LE_UINT32(gzipData + gzipSize - 8);
+		delete gzip;
+		return true;
+	}
+
+	static void writeHeader(Common::WriteStream &out, bool central, uint16 method, uint32 crc, uint32 compressedSize, const Member &member, uint32 offset) {
+		out.writeUint32LE(central ? 0x02014b50 : 0x04034b50);
+		if (central)
+			out.writeUint16LE(20); // version made by
+		out.writeUint16LE(20);     // version needed
+		out.writeUint16LE(0);      // flags
+		out.writeUint16LE(method);
+		out.writeUint32LE(0);      // time and date
+		out.writeUint32LE(crc);
+		out.writeUint32LE(compressedSize);
+		out.writeUint32LE(member.size);
+		out.writeUint16LE(member.name.size());
+		out.writeUint16LE(0);      // extra field
+		if (central) {
+			out.writeUint16LE(0);  // comment
+			out.writeUint16LE(0);  // disk
+			out.writeUint16LE(0);  // internal attributes
+			out.writeUint32LE(0);  // external attributes
+			out.writeUint32LE(offset);
+		}
+		out.writeString(member.name);
+	}
+
+	// Build a zip archive with the given members in memory
+	static Common::SeekableReadStream *createZip(const Common::Array<Member> &members) {
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::NO);
+		Common::MemoryWriteStreamDynamic centralDir(DisposeAfterUse::YES);
+
+		for (uint i = 0; i < members.size(); ++i) {
+			const Member &member = members[i];
+			Common::Array<byte> deflated;
+			uint32 crc = 0;
+			const bool compressed = member.compress && deflate(member.data, member.size, deflated, crc);
+			if (!compressed) {
+				// Stored members are checked against the CRC too, it comes
+				// with the compressed data. Without zlib it is not checked.
+				deflate(member.data, member.size, deflated, crc);
+			}
+
+			const uint16 method = compressed ? 8 : 0;
+			const uint32 compressedSize = compressed ? deflated.size() : member.size;
+			writeHeader(centralDir, true, method, crc, compressedSize, member, out.pos());
+			writeHeader(out, false, method, crc, compressedSize, member, 0);
+			if (compressed)
+				out.write(deflated.begin(), deflated.size());
+			else
+				out.write(member.data, member.size);
+		}
+
+		const uint32 centralDirOffset = out.pos();
+		out.write(centralDir.getData(), centralDir.size());
+		out.writeUint32LE(0x06054b50);
+		out.writeUint16LE(0);
+		out.writeUint16LE(0);
+		out.writeUint16LE(members.size());
+		out.writeUint16LE(members.size());
+		out.writeUint32LE(centralDir.size());
+		out.writeUint32LE(centralDirOffset);
+		out.writeUint16LE(0);
+
+		return new Common::MemoryReadStream(out.getData(), out.size(), DisposeAfterUse::YES);
+	}
+
+	// Members which compress to about a third of their size
+	static void createMembers(Common::Array<Member> &members, int count, uint32 minSize, uint32 maxSize, bool compress) {
+		Common::RandomSource rnd("zip");
+		rnd.setSeed(members.size() + 1);
+
+		for (int i = 0; i < count; ++i) {
+			Member member;
+			member.name = Common::String::format("member%d-%u.dat", (int)members.size(), minSize);
+			member.size = minSize + rnd.getRandomNumber(maxSize - minSize);
+			member.data = new byte[member.size];
+			member.compress = compress;
+			for (uint32 j = 0; j < member.size; ++j)
+				member.data[j] = (j & 0x40) ? rnd.getRandomNumber(255) : (j / 64) & 0xFF;
+			members.push_back(member);
+		}
+	}
+
+	static void freeMembers(Common::Array<Member> &members) {
+		for (uint i = 0; i < members.size(); ++i)
+			delete[] members[i].data;
+		members.clear();
+	}
+
+	static bool matches(Common::SeekableReadStream *stream, const Member &member) {
+		if (!stream || stream->size() != (int32)member.size)
+			return false;
+
+		byte *data = new byte[member.size];
+		const bool valid = stream->read(data, member.size) == member.size && !memcmp(data, member.data, member.size);
+		delete[] data;
+		return valid;
+	}
+
+	void test_members_match() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::Array<Member> members;
+		createMembers(members, 8, 16, 4096, true);
+		createMembers(members, 2, 1024 * 1024, 2 * 1024 * 1024, true);
+		createMembers(members, 2, 300 * 1024, 600 * 1024, false);
+
+		Common::Archive *zip = Common::makeZipArchive(createZip(members));
+		TS_ASSERT(zip);
+
+		Common::ArchiveMemberList list;
+		TS_ASSERT_EQUALS(zip->listMembers(list), (int)members.size());
+
+		for (int pass = 0; pass < 2; ++pass) {
+			for (uint i = 0; i < members.size(); ++i) {
+				Common::SeekableReadStream *stream = zip->createReadStreamForMember(members[i].name);
+				TS_ASSERT(matches(stream, members[i]));
+				TS_ASSERT(stream && !stream->err());
+				delete stream;
+			}
+		}
+
+		// Big members can be read at the same time, seek around, and
+		// outlive their archive
+		const Member &big = members[8];
+		Common::SeekableReadStream *first = zip->createReadStreamForMember(big.name);
+		Common::SeekableReadStream *second = zip->createReadStreamForMember(big.name);
+		delete zip;
+
+		byte data[256];
+		TS_ASSERT(first->seek(1000));
+		TS_ASSERT_EQUALS(second->read(data, sizeof(data)), sizeof(data));
+		TS_ASSERT(!memcmp(data, big.data, sizeof(data)));
+		TS_ASSERT_EQUALS(first->read(data, sizeof(data)), sizeof(data));
+		TS_ASSERT(!memcmp(data, big.data + 1000, sizeof(data)));
+		TS_ASSERT(first->seek(-(int32)sizeof(data), SEEK_END));
+		TS_ASSERT_EQUALS(first->read(data, sizeof(data) * 2), sizeof(data));
+		TS_ASSERT(!memcmp(data, big.data + big.size - sizeof(data), sizeof(data)));
+		TS_ASSERT(first->eos());
+		TS_ASSERT(first->seek(10));
+		TS_ASSERT_EQUALS(first->readByte(), big.data[10]);
+		delete first;
+		delete second;
+
+		freeMembers(members);
+#endif
+	}
+
+	// Small members opened again come from the cache, the least recently
+	// opened ones are dropped from it first
+	void test_member_cache() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::Array<Member> members;
+		createMembers(members, 5, 1000, 1000, true);
+
+		Common::SeekableReadStream *zipData = createZip(members);
+		const int32 zipSize = zipData->size();
+		byte *zipBuffer = new byte[zipSize];
+		zipData->read(zipBuffer, zipSize);
+		delete zipData;
+
+		for (int cache = 0; cache < 2; ++cache) {
+			byte *buffer = new byte[zipSize];
+			memcpy(buffer, zipBuffer, zipSize);
+			Common::Archive *zip = Common::makeZipArchive(new Common::MemoryReadStream(buffer, zipSize), cache ? 4000 : 0);
+			TS_ASSERT(zip);
+
+			static const int opens[] = { 0, 1, 2, 3, 0, 4 };
+			for (int i = 0; i < ARRAYSIZE(opens); ++i) {
+				Common::SeekableReadStream *stream = zip->createReadStreamForMember(members[opens[i]].name);
+				TS_ASSERT(matches(stream, members[opens[i]]));
+				delete stream;
+			}
+
+			// Wipe the local headers and data, which only leaves what
+			// was cached readable
+			memset(buffer, 0, READ_LE_UINT32(buffer + zipSize - 6));
+
+			for (uint i = 0; i < members.size(); ++i) {
+				Common::SeekableReadStream *stream = zip->createReadStreamForMember(members[i].name);
+				TS_ASSERT_EQUALS(matches(stream, members[i]), cache && i != 1);
+				delete stream;
+			}
+
+			delete zip;
+			delete[] buffer;
+		}
+
+		delete[] zipBuffer;
+		freeMembers(members);
+#endif
+	}
+
+	// Big members are checked against their CRC like small ones
+	void test_big_member_crc() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::Array<Member> members;
+		createMembers(members, 1, 300 * 1024, 300 * 1024, false);
+
+		// Without zlib there is no CRC to check
+		Common::Array<byte> deflated;
+		uint32 crc;
+		if (!deflate(members[0].data, 16, deflated, crc)) {
+			freeMembers(members);
+			return;
+		}
+
+		// The data of the only stored member follows its local header
+		Common::SeekableReadStream *zipData = createZip(members);
+		const int32 zipSize = zipData->size();
+		byte *zipBuffer = (byte *)malloc(zipSize);
+		zipData->read(zipBuffer, zipSize);
+		delete zipData;
+		zipBuffer[30 + members[0].name.size() + members[0].size / 2] ^= 0xFF;
+
+		Common::Archive *zip = Common::makeZipArchive(new Common::MemoryReadStream(zipBuffer, zipSize, DisposeAfterUse::YES));
+		Common::SeekableReadStream *stream = zip->createReadStreamForMember(members[0].name);
+		TS_ASSERT(stream);
+		byte *data = new byte[members[0].size];
+		stream->read(data, members[0].size);
+		TS_ASSERT(stream->err());
+		delete[] data;
+		delete stream;
+		delete zip;
+
+		freeMembers(members);
+#endif
+	}
+
+	struct ThreadRead {
+		Common::SeekableReadStream *stream;
+		const Member *member;
+		bool valid;
+	};
+
+	static void readThread(void *param) {
+		ThreadRead *read = (ThreadRead *)param;
+		read->valid = true;
+		for (int pass = 0; pass < 4 && read->valid; ++pass) {
+			read->stream->seek(0);
+			read->valid = matches(read->stream, *read->member) && !read->stream->err();
+		}
+	}
+
+	// Big members may be read on other threads while the archive opens and
+	// reads other members
+	void test_big_member_thread() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::Array<Member> members;
+		createMembers(members, 8, 16, 4096, true);
+		createMembers(members, 1, 1024 * 1024, 1024 * 1024, true);
+		createMembers(members, 1, 300 * 1024, 300 * 1024, false);
+
+		Common::Archive *zip = Common::makeZipArchive(createZip(members), 16 * 1024);
+		ThreadRead reads[2];
+		OSystem::ThreadRef threads[2];
+		for (int i = 0; i < 2; ++i) {
+			reads[i].stream = zip->createReadStreamForMember(members[8 + i].name);
+			reads[i].member = &members[8 + i];
+			reads[i].valid = false;
+			threads[i] = g_system->createThread(readThread, &reads[i]);
+			if (!threads[i])
+				readThread(&reads[i]);
+		}
+
+		for (int pass = 0; pass < 20; ++pass) {
+			for (uint i = 0; i < 8; ++i) {
+				Common::SeekableReadStream *stream = zip->createReadStreamForMember(members[i].name);
+				TS_ASSERT(matches(stream, members[i]));
+				delete stream;
+			}
+		}
+
+		for (int i = 0; i < 2; ++i) {
+			if (threads[i])
+				g_system->joinThread(threads[i]);
+			TS_ASSERT(reads[i].valid);
+			delete reads[i].stream;
+		}
+		delete zip;
+
+		freeMembers(members);
+#endif
+	}
+
+	// Reports the time to open an archive and read its first member, and
+	// the time to read small members again and again
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const int kOpens = 40;
+		const int kRepeats = 20;
+		Common::Array<Member> members;
+		createMembers(members, 2000, 64, 8192, true);
+		createMembers(members, 1, 4 * 1024 * 1024, 4 * 1024 * 1024, true);
+
+		Common::SeekableReadStream *zipData = createZip(members);
+		const int32 zipSize = zipData->size();
+		byte *zipBuffer = new byte[zipSize];
+		zipData->read(zipBuffer, zipSize);
+		delete zipData;
+
+		uint32 start = g_system->getMillis();
+		for (int i = 0; i < kOpens; ++i) {
+			Common::Archive *zip = Common::makeZipArchive(new Common::MemoryReadStream(zipBuffer, zipSize));
+			delete zip->createReadStreamForMember(members[0].name);
+			delete zip;
+		}
+		const uint32 firstOpen = g_system->getMillis() - start;
+
+		Common::Archive *zip = Common::makeZipArchive(new Common::MemoryReadStream(zipBuffer, zipSize));
+		start = g_system->getMillis();
+		for (int repeat = 0; repeat < kRepeats; ++repeat) {
+			for (int i = 0; i < 50; ++i)
+				delete zip->createReadStreamForMember(members[i].name);
+		}
+		const uint32 repeatOpen = g_system->getMillis() - start;
+
+		// Opening the big member should not decompress all of it
+		start = g_system->getMillis();
+		for (int i = 0; i < kRepeats; ++i) {
+			Common::SeekableReadStream *stream = zip->createReadStreamForMember(members.back().name);
+			stream->readUint32LE();
+			delete stream;
+		}
+		const uint32 bigOpen = g_system->getMillis() - start;
+		delete zip;
+
+		TS_TRACE(Common::String::format("First open %u us, repeated open %u us, open of a 4 MB member %u us",
+		                                firstOpen * 1000 / kOpens,
+		                                repeatOpen * 1000 / (kRepeats * 50), bigOpen * 1000 / kRepeats).c_str());
+
+		delete[] zipBuffer;
+		freeMembers(members);
+#endif
+	}
+};
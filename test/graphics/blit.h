@@ -0,0 +1,249 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/cpudetect.h"
+#include "common/random.h"
+#include "common/system.h"
+#include "graphics/conversion.h"
+#include "graphics/managed_surface.h"
+
+#include "../null_osystem.h"
+
+class BlitTestSuite : public CxxTest::TestSuite {
+public:
+	enum BlitMode {
+		kBlitFrom,
+		kTransBlitFrom,
+		kTransBlitFromMaskOnly
+	};
+
+	static Graphics::PixelFormat rgb565() { return Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0); }
+	static Graphics::PixelFormat rgb555() { return Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0); }
+	static Graphics::PixelFormat argb1555() { return Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15); }
+	static Graphics::PixelFormat argb4444() { return Graphics::PixelFormat(2, 4, 4, 4, 4, 8, 4, 0, 12); }
+	static Graphics::PixelFormat argb8888() { return Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24); }
+	static Graphics::PixelFormat rgba8888() { return Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0); }
+	static Graphics::PixelFormat xrgb8888() { return Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0); }
+	static Graphics::PixelFormat bgr233() { return Graphics::PixelFormat(4, 3, 3, 2, 0, 0, 3, 6, 0); }
+
+	// Runs of transparent and opaque pixels between random ones, since the
+	// blitters handle those separately, and some pixels of the key color
+	static void fill(byte *pixels, int pitch, int width, int height, const Graphics::PixelFormat &format, uint32 key, uint seed) {
+		Common::RandomSource rnd("blit");
+		rnd.setSeed(seed);
+
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				uint32 color;
+				if (format.bytesPerPixel == 1) {
+					color = rnd.getRandomNumber(255);
+				} else {
+					const int run = (x / 5 + y) % 4;
+					const byte a = run == 0 ? 0 : (run == 1 ? 255 : rnd.getRandomNumber(255));
+					color = format.ARGBToColor(a, rnd.getRandomNumber(255), rnd.getRandomNumber(255), rnd.getRandomNumber(255));
+					if ((x + y) % 11 == 0)
+						color |= rnd.getRandomNumber(0xFFFF) << (x & 16);
+				}
+				if ((x / 3 + y * 7) % 5 == 0)
+					color = key;
+
+				byte *p = pixels + y * pitch + x * format.bytesPerPixel;
+				if (format.bytesPerPixel == 1)
+					*p = color;
+				else if (format.bytesPerPixel == 2)
+					*(uint16 *)p = color;
+				else
+					*(uint32 *)p = color;
+			}
+		}
+	}
+
+	static void createSource(Graphics::ManagedSurface &src, int width, int height, const Graphics::PixelFormat &format, uint32 key, bool paletteAlpha) {
+		src.create(width, height, format);
+		fill((byte *)src.getPixels(), src.pitch, width, height, format, key, width * 7 + height);
+
+		if (format.bytesPerPixel == 1) {
+			Common::RandomSource rnd("palette");
+			uint32 palette[256];
+			for (int i = 0; i < 256; i++)
+				palette[i] = rnd.getRandomNumber(0xFFFFFF) | ((paletteAlpha && i % 3 == 0 ? rnd.getRandomNumber(255) : 255) << 24);
+			src.setPalette(palette, 0, 256);
+		}
+	}
+
+	static void blit(Graphics::ManagedSurface &dest, const Graphics::ManagedSurface &src, const Common::Point &pos, BlitMode mode, uint32 key, uint srcAlpha) {
+		switch (mode) {
+		case kBlitFrom:
+			dest.blitFrom(src, pos);
+			break;
+		case kTransBlitFrom:
+			dest.transBlitFrom(src, pos, key, false, 0, srcAlpha);
+			break;
+		case kTransBlitFromMaskOnly:
+			dest.transBlitFrom(src, Common::Rect(0, 0, src.w, src.h), Common::Rect(pos.x, pos.y, pos.x + src.w, pos.y + src.h),
+			                   key, false, 0, srcAlpha, nullptr, true);
+			break;
+		}
+	}
+
+	void compareBlit(const char *name, const Graphics::PixelFormat &srcFormat, const Graphics::PixelFormat &dstFormat,
+	                 BlitMode mode, uint32 key, uint srcAlpha = 0xff, bool paletteAlpha = false) {
+		const int kWidth = 64;
+		const int kHeight = 12;
+		const Common::Point positions[] = { Common::Point(3, 2), Common::Point(-5, 1), Common::Point(30, 4) };
+
+		Graphics::ManagedSurface src;
+		createSource(src, 45, 7, srcFormat, key, paletteAlpha);
+
+		for (int i = 0; i < ARRAYSIZE(positions); i++) {
+			Graphics::ManagedSurface generic(kWidth, kHeight, dstFormat);
+			fill((byte *)generic.getPixels(), generic.pitch, kWidth, kHeight, dstFormat, 0, i);
+			Common::setCpuFeatureMask(0);
+			blit(generic, src, positions[i], mode, key, srcAlpha);
+
+			const uint32 features[] = { Common::kCpuFeatureSSE2, Common::kCpuFeatureAll };
+			for (int j = 0; j < 2; j++) {
+				Graphics::ManagedSurface simd(kWidth, kHeight, dstFormat);
+				fill((byte *)simd.getPixels(), simd.pitch, kWidth, kHeight, dstFormat, 0, i);
+				Common::setCpuFeatureMask(features[j]);
+				blit(simd, src, positions[i], mode, key, srcAlpha);
+
+				const int differences = memcmp(generic.getPixels(), simd.getPixels(), generic.pitch * kHeight);
+				if (differences) {
+					TS_TRACE(Common::String::format("%s at %d, %d", name, positions[i].x, positions[i].y).c_str());
+				}
+				TS_ASSERT_EQUALS(differences, 0);
+			}
+			Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+		}
+	}
+
+	void test_managed_surface_simd_matches_generic() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		compareBlit("RGB565 copy", rgb565(), rgb565(), kBlitFrom, 0);
+		compareBlit("RGB565 to ARGB8888", rgb565(), argb8888(), kBlitFrom, 0);
+		compareBlit("XRGB8888 to RGB555", xrgb8888(), rgb555(), kBlitFrom, 0);
+		compareBlit("ARGB8888 alpha", argb8888(), argb8888(), kBlitFrom, 0);
+		compareBlit("RGBA8888 alpha", rgba8888(), rgba8888(), kBlitFrom, 0);
+		compareBlit("ARGB4444 to RGB565", argb4444(), rgb565(), kBlitFrom, 0);
+		compareBlit("CLUT8 to RGB565", Graphics::PixelFormat::createFormatCLUT8(), rgb565(), kBlitFrom, 0);
+		compareBlit("CLUT8 to ARGB8888", Graphics::PixelFormat::createFormatCLUT8(), argb8888(), kBlitFrom, 0);
+		compareBlit("CLUT8 with alpha", Graphics::PixelFormat::createFormatCLUT8(), argb8888(), kBlitFrom, 0, 0xff, true);
+
+		compareBlit("RGB565 key", rgb565(), rgb565(), kTransBlitFrom, 0x1234);
+		compareBlit("XRGB8888 key", xrgb8888(), xrgb8888(), kTransBlitFrom, 0x00ABCDEF);
+		compareBlit("ARGB8888 RGB key", argb8888(), argb8888(), kTransBlitFrom, 0x80ABCDEF);
+		compareBlit("ARGB8888 key 0", argb8888(), argb8888(), kTransBlitFrom, 0);
+		compareBlit("ARGB8888 source alpha", argb8888(), argb8888(), kTransBlitFrom, 0x80ABCDEF, 100);
+		compareBlit("XRGB8888 source alpha", xrgb8888(), xrgb8888(), kTransBlitFrom, 0x00ABCDEF, 100);
+		compareBlit("RGBA8888 source alpha", rgba8888(), rgba8888(), kTransBlitFrom, 0xABCDEF80, 200);
+		compareBlit("CLUT8 key to RGB565", Graphics::PixelFormat::createFormatCLUT8(), rgb565(), kTransBlitFrom, 7);
+		compareBlit("CLUT8 key to ARGB8888", Graphics::PixelFormat::createFormatCLUT8(), argb8888(), kTransBlitFrom, 7);
+		compareBlit("RGB565 mask only", rgb565(), rgb565(), kTransBlitFromMaskOnly, 0x1234);
+		compareBlit("CLUT8 mask only", Graphics::PixelFormat::createFormatCLUT8(), xrgb8888(), kTransBlitFromMaskOnly, 7);
+#endif
+	}
+
+	void compareCrossBlit(const Graphics::PixelFormat &srcFormat, const Graphics::PixelFormat &dstFormat, int width, int height) {
+		const int srcPitch = width * srcFormat.bytesPerPixel + 6;
+		const int dstPitch = width * dstFormat.bytesPerPixel + 8;
+		byte *src = new byte[srcPitch * height];
+		byte *generic = new byte[dstPitch * height];
+		byte *simd = new byte[dstPitch * height];
+		fill(src, srcPitch, width, height, srcFormat, 0, width + height);
+		memset(generic, 0, dstPitch * height);
+
+		Common::setCpuFeatureMask(0);
+		TS_ASSERT(Graphics::crossBlit(generic, src, dstPitch, srcPitch, width, height, dstFormat, srcFormat));
+
+		const uint32 features[] = { Common::kCpuFeatureSSE2, Common::kCpuFeatureAll };
+		for (int i = 0; i < 2; i++) {
+			memset(simd, 0, dstPitch * height);
+			Common::setCpuFeatureMask(features[i]);
+			TS_ASSERT(Graphics::crossBlit(simd, src, dstPitch, srcPitch, width, height, dstFormat, srcFormat));
+			TS_ASSERT_EQUALS(memcmp(generic, simd, dstPitch * height), 0);
+
+			// In place, the way Surface::convertToInPlace() does it
+			const int inPlacePitch = width * MAX(srcFormat.bytesPerPixel, dstFormat.bytesPerPixel);
+			byte *buffer = new byte[inPlacePitch * height];
+			for (int y = 0; y < height; y++)
+				memcpy(buffer + y * width * srcFormat.bytesPerPixel, src + y * srcPitch, width * srcFormat.bytesPerPixel);
+			TS_ASSERT(Graphics::crossBlit(buffer, buffer, width * dstFormat.bytesPerPixel, width * srcFormat.bytesPerPixel, width, height, dstFormat, srcFormat));
+
+			int differences = 0;
+			for (int y = 0; y < height; y++)
+				differences += memcmp(buffer + y * width * dstFormat.bytesPerPixel, generic + y * dstPitch, width * dstFormat.bytesPerPixel) != 0;
+			TS_ASSERT_EQUALS(differences, 0);
+			delete[] buffer;
+		}
+		Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+
+		delete[] simd;
+		delete[] generic;
+		delete[] src;
+	}
+
+	void test_crossblit_simd_matches_generic() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const Graphics::PixelFormat formats[] = { rgb565(), rgb555(), argb1555(), argb4444(), argb8888(), rgba8888(), xrgb8888(), bgr233() };
+		for (int i = 0; i < ARRAYSIZE(formats); i++) {
+			for (int j = 0; j < ARRAYSIZE(formats); j++) {
+				if (i == j)
+					continue;
+				compareCrossBlit(formats[i], formats[j], 37, 5);
+				compareCrossBlit(formats[i], formats[j], 3, 2);
+			}
+		}
+#endif
+	}
+
+	// Reports the throughput of the blitters in megapixels per second
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const int kWidth = 320;
+		const int kHeight = 200;
+		const int kFrames = 50;
+
+		struct Benchmark {
+			const char *name;
+			Graphics::PixelFormat srcFormat, dstFormat;
+			BlitMode mode;
+			uint srcAlpha;
+		};
+		const Benchmark benchmarks[] = {
+			{ "RGB565 to ARGB8888", rgb565(), argb8888(), kBlitFrom, 0xff },
+			{ "CLUT8 to ARGB8888", Graphics::PixelFormat::createFormatCLUT8(), argb8888(), kBlitFrom, 0xff },
+			{ "CLUT8 key to RGB565", Graphics::PixelFormat::createFormatCLUT8(), rgb565(), kTransBlitFrom, 0xff },
+			{ "RGB565 key", rgb565(), rgb565(), kTransBlitFrom, 0xff },
+			{ "ARGB8888 alpha", argb8888(), argb8888(), kBlitFrom, 0xff },
+			{ "XRGB8888 source alpha", xrgb8888(), xrgb8888(), kTransBlitFrom, 128 }
+		};
+
+		for (int i = 0; i < ARRAYSIZE(benchmarks); i++) {
+			const Benchmark &benchmark = benchmarks[i];
+			Graphics::ManagedSurface src, dest(kWidth, kHeight, benchmark.dstFormat);
+			createSource(src, kWidth, kHeight, benchmark.srcFormat, 7, false);
+
+			uint32 times[2];
+			for (int simd = 0; simd < 2; ++simd) {
+				Common::setCpuFeatureMask(simd ? Common::kCpuFeatureAll : 0);
+				const uint32 start = g_system->getMillis();
+				for (int frame = 0; frame < kFrames; ++frame)
+					blit(dest, src, Common::Point(0, 0), benchmark.mode, 7, benchmark.srcAlpha);
+				times[simd] = MAX<uint32>(g_system->getMillis() - start, 1);
+			}
+
+			const uint32 pixels = kWidth * kHeight * kFrames;
+			TS_TRACE(Common::String::format("%s: %u Mpixels/s generic, %u Mpixels/s SIMD", benchmark.name,
+			                                pixels / 1000 / times[0], pixels / 1000 / times[1]).c_str());
+		}
+
+		Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+#endif
+	}
+};
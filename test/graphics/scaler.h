@@ -0,0 +1,165 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/cpudetect.h"
+#include "common/random.h"
+#include "common/system.h"
+#include "graphics/pixelformat.h"
+#include "graphics/scaler.h"
+
+#include "../null_osystem.h"
+
+class ScalerTestSuite : public CxxTest::TestSuite
+{
+	public:
+	struct ScalerEntry {
+		const char *name;
+		ScalerProc *proc;
+		int factor;
+		bool needsWidthMultipleOf4; // The MMX Scale2x code only handles those
+	};
+
+	static const ScalerEntry *scalers() {
+		static const ScalerEntry entries[] = {
+			{ "Normal2x", Normal2x, 2, false },
+			{ "Normal3x", Normal3x, 3, false },
+			{ "AdvMame2x", AdvMame2x, 2, true },
+			{ "AdvMame3x", AdvMame3x, 3, false },
+			{ "2xSaI", _2xSaI, 2, false },
+			{ "SuperEagle", SuperEagle, 2, false },
+#ifdef USE_HQ_SCALERS
+			{ "HQ2x", HQ2x, 2, false },
+			{ "HQ3x", HQ3x, 3, false },
+#endif
+			{ nullptr, nullptr, 0, false }
+		};
+		return entries;
+	}
+
+	// Source pixels with a border of 2 pixels, since the scalers read the
+	// neighbourhood of each pixel. Few colors make the edge detection of
+	// the scalers take all their paths, gradients exercise interpolation.
+	static uint16 *createSource(int bitFormat, int width, int height, uint32 &pitch, uint seed) {
+		const Graphics::PixelFormat format = bitFormat == 565 ? Graphics::createPixelFormat<565>() : Graphics::createPixelFormat<555>();
+		Common::RandomSource rnd("scaler");
+		rnd.setSeed(seed);
+
+		uint16 palette[6];
+		for (int i = 0; i < 6; ++i)
+			palette[i] = format.RGBToColor(rnd.getRandomNumber(255), rnd.getRandomNumber(255), rnd.getRandomNumber(255));
+
+		const int w = width + 4;
+		const int h = height + 4;
+		uint16 *buffer = new uint16[w * h];
+		for (int y = 0; y < h; ++y) {
+			for (int x = 0; x < w; ++x) {
+				uint16 color;
+				if (x > w / 2 && y > h / 2)
+					color = format.RGBToColor(x * 7, y * 11, (x + y) * 3);
+				else if ((x / 3 + y / 2) & 1)
+					color = palette[rnd.getRandomNumber(5)];
+				else
+					color = palette[(x / 4 + y) % 3];
+				buffer[y * w + x] = color;
+			}
+		}
+
+		pitch = w * sizeof(uint16);
+		return buffer;
+	}
+
+	static void scale(const ScalerEntry &scaler, const uint16 *source, uint32 srcPitch, uint16 *dest, int width, int height) {
+		const uint32 dstPitch = width * scaler.factor * sizeof(uint16);
+		scaler.proc((const uint8 *)source + 2 * srcPitch + 2 * sizeof(uint16), srcPitch, (uint8 *)dest, dstPitch, width, height);
+	}
+
+	void compareScalers(int bitFormat, int width, int height) {
+		uint32 pitch;
+		uint16 *source = createSource(bitFormat, width, height, pitch, width * height);
+
+		for (const ScalerEntry *scaler = scalers(); scaler->name; ++scaler) {
+			if (scaler->needsWidthMultipleOf4 && width % 4)
+				continue;
+
+			const int size = width * height * scaler->factor * scaler->factor;
+			uint16 *generic = new uint16[size];
+			uint16 *simd = new uint16[size];
+			memset(generic, 0, size * sizeof(uint16));
+
+			Common::setCpuFeatureMask(0);
+			InitScalers(bitFormat);
+			scale(*scaler, source, pitch, generic, width, height);
+
+			const uint32 features[] = { Common::kCpuFeatureSSE2, Common::kCpuFeatureAll };
+			for (int i = 0; i < 2; ++i) {
+				memset(simd, 0xFF, size * sizeof(uint16));
+				Common::setCpuFeatureMask(features[i]);
+				InitScalers(bitFormat);
+				scale(*scaler, source, pitch, simd, width, height);
+
+				int differences = 0;
+				for (int j = 0; j < size; ++j)
+					differences += generic[j] != simd[j];
+				if (differences) {
+					TS_TRACE(Common::String::format("%s in %d format, %dx%d", scaler->name, bitFormat, width, height).c_str());
+				}
+				TS_ASSERT_EQUALS(differences, 0);
+			}
+			Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+
+			delete[] simd;
+			delete[] generic;
+		}
+
+		delete[] source;
+		DestroyScalers();
+	}
+
+	void test_simd_scalers_match_generic() {
+		const int bitFormats[] = { 565, 555 };
+		for (int i = 0; i < 2; ++i) {
+			compareScalers(bitFormats[i], 84, 20);
+			compareScalers(bitFormats[i], 157, 9);
+			compareScalers(bitFormats[i], 5, 3);
+		}
+	}
+
+	// Reports the throughput of every scaler in source megapixels per second
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const int kWidth = 320;
+		const int kHeight = 200;
+		const int kFrames = 40;
+		const int bitFormats[] = { 565, 555 };
+
+		for (int format = 0; format < 2; ++format) {
+			uint32 pitch;
+			uint16 *source = createSource(bitFormats[format], kWidth, kHeight, pitch, 1);
+			uint16 *dest = new uint16[kWidth * kHeight * 9];
+
+			for (const ScalerEntry *scaler = scalers(); scaler->name; ++scaler) {
+				uint32 times[2];
+				for (int simd = 0; simd < 2; ++simd) {
+					Common::setCpuFeatureMask(simd ? Common::kCpuFeatureAll : 0);
+					InitScalers(bitFormats[format]);
+					const uint32 start = g_system->getMillis();
+					for (int frame = 0; frame < kFrames; ++frame)
+						scale(*scaler, source, pitch, dest, kWidth, kHeight);
+					times[simd] = MAX<uint32>(g_system->getMillis() - start, 1);
+				}
+
+				const uint32 pixels = kWidth * kHeight * kFrames;
+				TS_TRACE(Common::String::format("%s %d: %u Mpixels/s generic, %u Mpixels/s SIMD", scaler->name, bitFormats[format],
+				                                pixels / 1000 / times[0], pixels / 1000 / times[1]).c_str());
+			}
+
+			delete[] dest;
+			delete[] source;
+		}
+
+		Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+		DestroyScalers();
+#endif
+	}
+};
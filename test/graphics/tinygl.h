@@ -0,0 +1,292 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/cpudetect.h"
+#include "common/random.h"
+#include "common/system.h"
+#include "graphics/surface.h"
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zgl.h"
+
+#include "../null_osystem.h"
+
+class TinyGLTestSuite : public CxxTest::TestSuite
+{
+	public:
+	static const int kWidth = 640;
+	static const int kHeight = 480;
+
+	Graphics::Surface _sprite;
+
+	void createSprite() {
+		_sprite.create(32, 32, Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24));
+		for (int y = 0; y < _sprite.h; y++) {
+			for (int x = 0; x < _sprite.w; x++) {
+				const uint8 a = (x + y) & 1 ? 0x80 : (x < 4 ? 0 : 0xFF);
+				*(uint32 *)_sprite.getBasePtr(x, y) = _sprite.format.ARGBToColor(a, x * 8, y * 8, 0x40);
+			}
+		}
+	}
+
+	// Draws a frame mixing everything the tiled renderer has to handle:
+	// clears, smooth and flat triangles, strips, lines, blended geometry,
+	// plain blits and scaled blits, which cannot be split into bands.
+	void drawFrame(uint seed, Graphics::BlitImage *image) {
+		Common::RandomSource rnd("tinygl");
+		rnd.setSeed(seed);
+
+		tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglOrtho(0, kWidth, kHeight, 0, -1, 1);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+		tglEnable(TGL_DEPTH_TEST);
+
+		for (int i = 0; i < 300; i++) {
+			tglShadeModel(i & 1 ? TGL_SMOOTH : TGL_FLAT);
+			if (i % 7 == 0) {
+				tglEnable(TGL_BLEND);
+				tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+			}
+			tglBegin(i % 5 == 0 ? TGL_TRIANGLE_STRIP : TGL_TRIANGLES);
+			for (int v = 0; v < 3 + (i % 5 == 0); v++) {
+				tglColor4f(rnd.getRandomNumber(255) / 255.0f, rnd.getRandomNumber(255) / 255.0f,
+				           rnd.getRandomNumber(255) / 255.0f, 0.5f);
+				tglVertex3f(rnd.getRandomNumberRng(-50, kWidth + 50), rnd.getRandomNumberRng(-50, kHeight + 50),
+				            rnd.getRandomNumber(100) / 100.0f - 0.5f);
+			}
+			tglEnd();
+			tglDisable(TGL_BLEND);
+
+			if (i % 25 == 0) {
+				tglBegin(TGL_LINES);
+				tglColor3f(1.0f, 1.0f, 1.0f);
+				tglVertex3f(rnd.getRandomNumber(kWidth), rnd.getRandomNumber(kHeight), 0.0f);
+				tglVertex3f(rnd.getRandomNumber(kWidth), rnd.getRandomNumber(kHeight), 0.0f);
+				tglEnd();
+			}
+
+			if (i % 30 == 0) {
+				Graphics::BlitTransform transform(rnd.getRandomNumberRng(-16, kWidth), rnd.getRandomNumberRng(-16, kHeight));
+				if (i % 60 == 0)
+					transform.scale(70, 45);
+				tglEnable(TGL_BLEND);
+				Graphics::tglBlit(image, transform);
+				tglDisable(TGL_BLEND);
+			}
+		}
+	}
+
+	uint32 renderFrames(byte *pixels, bool tiled, int threadCount, bool dirtyRects, int frames) {
+		Graphics::PixelBuffer buffer(Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24), pixels);
+		TinyGL::FrameBuffer *fb = new TinyGL::FrameBuffer(kWidth, kHeight, buffer);
+		TinyGL::glInit(fb, 256);
+		tglEnableDirtyRects(dirtyRects);
+		tglEnableTiledRendering(tiled, threadCount);
+
+		Graphics::BlitImage *image = Graphics::tglGenBlitImage();
+		Graphics::tglUploadBlitImage(image, _sprite, 0, false);
+
+		uint32 time = 0;
+		for (int frame = 0; frame < frames; frame++) {
+			drawFrame(frame, image);
+			const uint32 start = g_system->getMillis();
+			TinyGL::tglPresentBuffer();
+			time += g_system->getMillis() - start;
+		}
+
+		Graphics::tglDeleteBlitImage(image);
+		TinyGL::glClose();
+		delete fb;
+		return time;
+	}
+
+	void compareTiled(bool dirtyRects) {
+		const int size = kWidth * kHeight * 4;
+		byte *serial = new byte[size];
+		byte *tiled = new byte[size];
+
+		// Render the same frames twice so that dirty rects replay partial frames
+		// Use several threads even on single CPU machines to test the tiling
+		renderFrames(serial, false, 0, dirtyRects, 3);
+		renderFrames(tiled, true, 4, dirtyRects, 3);
+
+		int differences = 0;
+		for (int i = 0; i < size; i++) {
+			if (serial[i] != tiled[i])
+				differences++;
+		}
+		TS_ASSERT_EQUALS(differences, 0);
+
+		delete[] tiled;
+		delete[] serial;
+	}
+
+	void test_tiled_matches_serial() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		createSprite();
+		compareTiled(false);
+		compareTiled(true);
+		_sprite.free();
+#endif
+	}
+
+	// Draws a frame with the states Grim and Myst 3 use: lit textured
+	// geometry with alpha testing and blending, depth only passes and
+	// projected shadows.
+	void drawSpanFrame(uint seed, TGLuint *textures, byte *shadowMask) {
+		Common::RandomSource rnd("tinygl");
+		rnd.setSeed(seed);
+
+		tglClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglFrustum(-1.0f, 1.0f, -0.75f, 0.75f, 1.0f, 100.0f);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+		tglEnable(TGL_DEPTH_TEST);
+		tglDepthFunc(seed & 1 ? TGL_LEQUAL : TGL_LESS);
+
+		memset(shadowMask, 0, kWidth * kHeight);
+		tglSetShadowMaskBuf(shadowMask);
+		tglSetShadowColor(20, 30, 40);
+
+		for (int i = 0; i < 200; i++) {
+			const int kind = rnd.getRandomNumber(9);
+			tglShadeModel(rnd.getRandomBit() ? TGL_SMOOTH : TGL_FLAT);
+
+			if (kind < 5) {
+				tglEnable(TGL_TEXTURE_2D);
+				tglBindTexture(TGL_TEXTURE_2D, textures[kind & 1]);
+			}
+			if (kind == 1 || kind == 5) {
+				tglEnable(TGL_ALPHA_TEST);
+				tglAlphaFunc(kind == 1 ? TGL_GEQUAL : TGL_GREATER, 0.5f);
+			}
+			if (kind == 2 || kind == 6) {
+				tglEnable(TGL_BLEND);
+				tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+			}
+			if (kind == 3)
+				tglDepthMask(TGL_FALSE);
+			if (kind == 7)
+				tglColorMask(TGL_FALSE, TGL_FALSE, TGL_FALSE, TGL_FALSE);
+			if (kind == 8)
+				tglEnable(TGL_SHADOW_MASK_MODE);
+			if (kind == 9)
+				tglEnable(TGL_SHADOW_MODE);
+
+			tglBegin(TGL_TRIANGLES);
+			for (int v = 0; v < 3; v++) {
+				tglColor4f(rnd.getRandomNumber(255) / 255.0f, rnd.getRandomNumber(255) / 255.0f,
+				           rnd.getRandomNumber(255) / 255.0f, rnd.getRandomNumber(255) / 255.0f);
+				tglTexCoord2f(rnd.getRandomNumber(300) / 100.0f, rnd.getRandomNumber(300) / 100.0f);
+				const float z = -1.5f - rnd.getRandomNumber(3000) / 100.0f;
+				tglVertex3f((rnd.getRandomNumber(300) / 100.0f - 1.5f) * -z, (rnd.getRandomNumber(200) / 100.0f - 1.0f) * -z, z);
+			}
+			tglEnd();
+
+			tglDisable(TGL_TEXTURE_2D);
+			tglDisable(TGL_ALPHA_TEST);
+			tglDisable(TGL_BLEND);
+			tglDepthMask(TGL_TRUE);
+			tglColorMask(TGL_TRUE, TGL_TRUE, TGL_TRUE, TGL_TRUE);
+			tglDisable(TGL_SHADOW_MASK_MODE);
+			tglDisable(TGL_SHADOW_MODE);
+		}
+	}
+
+	uint32 renderSpanFrames(byte *pixels, uint32 cpuFeatures, int frames) {
+		// The span kernel is picked when the frame buffer is created
+		Common::setCpuFeatureMask(cpuFeatures);
+		Graphics::PixelBuffer buffer(Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24), pixels);
+		TinyGL::FrameBuffer *fb = new TinyGL::FrameBuffer(kWidth, kHeight, buffer);
+		Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+		TinyGL::glInit(fb, 256);
+
+		TGLuint textures[2];
+		byte *texels = new byte[64 * 64 * 4];
+		for (int i = 0; i < 64 * 64; i++) {
+			texels[i * 4 + 0] = i * 7;
+			texels[i * 4 + 1] = i >> 4;
+			texels[i * 4 + 2] = i * 13 + 5;
+			texels[i * 4 + 3] = (i & 64) ? 255 : i * 3;
+		}
+		tglGenTextures(2, textures);
+		for (int i = 0; i < 2; i++) {
+			tglBindTexture(TGL_TEXTURE_2D, textures[i]);
+			tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MAG_FILTER, i ? TGL_LINEAR : TGL_NEAREST);
+			tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MIN_FILTER, i ? TGL_LINEAR : TGL_NEAREST);
+			tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_WRAP_S, TGL_REPEAT);
+			tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_WRAP_T, TGL_REPEAT);
+			tglTexImage2D(TGL_TEXTURE_2D, 0, 4, 64, 64, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texels);
+		}
+		delete[] texels;
+
+		byte *shadowMask = new byte[kWidth * kHeight];
+		uint32 time = 0;
+		for (int frame = 0; frame < frames; frame++) {
+			drawSpanFrame(frame, textures, shadowMask);
+			const uint32 start = g_system->getMillis();
+			TinyGL::tglPresentBuffer();
+			time += g_system->getMillis() - start;
+		}
+
+		tglDeleteTextures(2, textures);
+		TinyGL::glClose();
+		delete[] shadowMask;
+		delete fb;
+		return time;
+	}
+
+	void test_simd_spans_match_scalar() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const int size = kWidth * kHeight * 4;
+		byte *scalar = new byte[size];
+		byte *simd = new byte[size];
+		renderSpanFrames(scalar, 0, 4);
+
+		const uint32 features[] = { Common::kCpuFeatureSSE2, Common::kCpuFeatureAll };
+		for (int i = 0; i < ARRAYSIZE(features); i++) {
+			renderSpanFrames(simd, features[i], 4);
+			int differences = 0;
+			for (int j = 0; j < size; j++) {
+				if (scalar[j] != simd[j])
+					differences++;
+			}
+			TS_ASSERT_EQUALS(differences, 0);
+		}
+
+		delete[] simd;
+		delete[] scalar;
+#endif
+	}
+
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		createSprite();
+
+		const int kFrames = 20;
+		byte *pixels = new byte[kWidth * kHeight * 4];
+		const uint32 serialTime = renderFrames(pixels, false, 0, false, kFrames);
+		const uint32 tiledTime = renderFrames(pixels, true, 0, false, kFrames);
+		const uint32 scalarSpanTime = renderSpanFrames(pixels, 0, kFrames);
+		const uint32 simdSpanTime = renderSpanFrames(pixels, Common::kCpuFeatureAll, kFrames);
+		delete[] pixels;
+		_sprite.free();
+
+		TS_TRACE(Common::String::format("TinyGL %dx%d: %u ms per frame on one thread, %u ms tiled on %u CPUs",
+		                                kWidth, kHeight, serialTime / kFrames, tiledTime / kFrames, g_system->getCpuCount()).c_str());
+		TS_TRACE(Common::String::format("TinyGL %dx%d textured: %u ms per frame with scalar spans, %u ms with SIMD spans",
+		                                kWidth, kHeight, scalarSpanTime / kFrames, simdSpanTime / kFrames).c_str());
+#endif
+	}
+};
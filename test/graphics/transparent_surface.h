@@ -0,0 +1,146 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/cpudetect.h"
+#include "common/random.h"
+#include "common/system.h"
+#include "graphics/transparent_surface.h"
+
+#include "../null_osystem.h"
+
+class TransparentSurfaceTestSuite : public CxxTest::TestSuite {
+public:
+	// Runs of transparent and opaque pixels between random ones, since the
+	// blitters take shortcuts for those
+	static void fill(Graphics::Surface &surface, uint seed) {
+		Common::RandomSource rnd("transparent");
+		rnd.setSeed(seed);
+
+		for (int y = 0; y < surface.h; y++) {
+			uint32 *pixels = (uint32 *)surface.getBasePtr(0, y);
+			for (int x = 0; x < surface.w; x++) {
+				const int run = (x / 8 + y) % 4;
+				const uint32 a = run == 0 ? 0 : (run == 1 ? 255 : rnd.getRandomNumber(255));
+				pixels[x] = (rnd.getRandomNumber(0xFFFFFF) << 8) | a;
+			}
+		}
+	}
+
+	static void blit(Graphics::Surface &target, Graphics::TransparentSurface &sprite, const Common::Point &pos, int flipping, uint color, Graphics::TSpriteBlendMode blendMode) {
+		sprite.blit(target, pos.x, pos.y, flipping, nullptr, color, -1, -1, blendMode);
+	}
+
+	void compareBlit(Graphics::AlphaType alphaMode, Graphics::TSpriteBlendMode blendMode, uint color, int flipping) {
+		const Common::Point positions[] = { Common::Point(3, 2), Common::Point(-7, -3), Common::Point(40, 9) };
+
+		Graphics::TransparentSurface sprite;
+		sprite.create(45, 13, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fill(sprite, 45);
+		sprite.setAlphaMode(alphaMode);
+
+		for (int i = 0; i < ARRAYSIZE(positions); i++) {
+			Graphics::Surface generic, simd;
+			generic.create(64, 16, Graphics::TransparentSurface::getSupportedPixelFormat());
+			simd.create(64, 16, Graphics::TransparentSurface::getSupportedPixelFormat());
+			fill(generic, i);
+			Common::setCpuFeatureMask(0);
+			blit(generic, sprite, positions[i], flipping, color, blendMode);
+
+			const uint32 features[] = { Common::kCpuFeatureSSE2, Common::kCpuFeatureAll };
+			for (int j = 0; j < 2; j++) {
+				fill(simd, i);
+				Common::setCpuFeatureMask(features[j]);
+				blit(simd, sprite, positions[i], flipping, color, blendMode);
+
+				const int differences = memcmp(generic.getPixels(), simd.getPixels(), generic.pitch * generic.h);
+				if (differences) {
+					TS_TRACE(Common::String::format("Blend mode %d, alpha mode %d, color %08x, flipping %d at %d, %d",
+					                                blendMode, alphaMode, color, flipping, positions[i].x, positions[i].y).c_str());
+				}
+				TS_ASSERT_EQUALS(differences, 0);
+			}
+			Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+
+			simd.free();
+			generic.free();
+		}
+
+		sprite.free();
+	}
+
+	void test_simd_matches_generic() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const Graphics::TSpriteBlendMode blendModes[] = { Graphics::BLEND_NORMAL, Graphics::BLEND_ADDITIVE, Graphics::BLEND_SUBTRACTIVE, Graphics::BLEND_MULTIPLY };
+		const uint colors[] = { 0xFFFFFFFF, 0xC0FF4080, 0x80FFFFFF, 0xFF10FFF0 };
+		for (int flipping = 0; flipping < 4; flipping++) {
+			compareBlit(Graphics::ALPHA_OPAQUE, Graphics::BLEND_NORMAL, 0xFFFFFFFF, flipping);
+			compareBlit(Graphics::ALPHA_BINARY, Graphics::BLEND_NORMAL, 0xFFFFFFFF, flipping);
+			for (int mode = 0; mode < ARRAYSIZE(blendModes); mode++) {
+				for (int color = 0; color < ARRAYSIZE(colors); color++)
+					compareBlit(Graphics::ALPHA_FULL, blendModes[mode], colors[color], flipping);
+			}
+		}
+#endif
+	}
+
+	// Draws a scene of sprites with all the blend modes, and reports the
+	// throughput in megapixels per second
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const int kSprites = 200;
+		const int kFrames = 20;
+
+		Graphics::Surface target;
+		target.create(640, 480, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fill(target, 1);
+
+		Graphics::TransparentSurface sprite;
+		sprite.create(96, 96, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fill(sprite, 2);
+
+		struct Benchmark {
+			const char *name;
+			Graphics::AlphaType alphaMode;
+			Graphics::TSpriteBlendMode blendMode;
+			uint color;
+		};
+		const Benchmark benchmarks[] = {
+			{ "opaque", Graphics::ALPHA_OPAQUE, Graphics::BLEND_NORMAL, 0xFFFFFFFF },
+			{ "binary", Graphics::ALPHA_BINARY, Graphics::BLEND_NORMAL, 0xFFFFFFFF },
+			{ "alpha", Graphics::ALPHA_FULL, Graphics::BLEND_NORMAL, 0xFFFFFFFF },
+			{ "alpha tinted", Graphics::ALPHA_FULL, Graphics::BLEND_NORMAL, 0xC0FF8040 },
+			{ "additive", Graphics::ALPHA_FULL, Graphics::BLEND_ADDITIVE, 0xFFFFFFFF },
+			{ "subtractive tinted", Graphics::ALPHA_FULL, Graphics::BLEND_SUBTRACTIVE, 0xFF8080FF },
+			{ "multiply", Graphics::ALPHA_FULL, Graphics::BLEND_MULTIPLY, 0xFFFFFFFF }
+		};
+
+		for (int i = 0; i < ARRAYSIZE(benchmarks); i++) {
+			sprite.setAlphaMode(benchmarks[i].alphaMode);
+
+			uint32 times[2];
+			for (int simd = 0; simd < 2; ++simd) {
+				Common::setCpuFeatureMask(simd ? Common::kCpuFeatureAll : 0);
+				const uint32 start = g_system->getMillis();
+				for (int frame = 0; frame < kFrames; ++frame) {
+					for (int s = 0; s < kSprites; s++) {
+						const Common::Point pos((s * 97 + frame * 13) % 600 - 30, (s * 61 + frame * 7) % 440 - 30);
+						blit(target, sprite, pos, s % 4, benchmarks[i].color, benchmarks[i].blendMode);
+					}
+				}
+				times[simd] = MAX<uint32>(g_system->getMillis() - start, 1);
+			}
+
+			const uint32 pixels = 96 * 96 * kSprites * kFrames;
+			TS_TRACE(Common::String::format("%s: %u Mpixels/s generic, %u Mpixels/s SIMD", benchmarks[i].name,
+			                                pixels / 1000 / times[0], pixels / 1000 / times[1]).c_str());
+		}
+
+		Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+		sprite.free();
+		target.free();
+#endif
+	}
+};
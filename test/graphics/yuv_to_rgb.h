@@ -0,0 +1,168 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/cpudetect.h"
+#include "common/random.h"
+#include "common/system.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include "../null_osystem.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+public:
+	enum Conversion {
+		k444,
+		k420,
+		k420Alpha,
+		k410
+	};
+
+	// Planes with a spare row and column, which convert410() reads
+	struct Planes {
+		byte *y, *u, *v, *a;
+		int yPitch, uvPitch;
+
+		Planes(int width, int height, uint seed) {
+			Common::RandomSource rnd("yuv");
+			rnd.setSeed(seed);
+
+			yPitch = width + 3;
+			uvPitch = width + 5;
+			y = new byte[yPitch * height];
+			a = new byte[yPitch * height];
+			u = new byte[uvPitch * (height + 1)];
+			v = new byte[uvPitch * (height + 1)];
+
+			// Mostly random, with runs of the extremes which clamp
+			for (int i = 0; i < yPitch * height; i++) {
+				y[i] = (i / 7) % 5 == 0 ? ((i & 1) ? 255 : 0) : rnd.getRandomNumber(255);
+				a[i] = rnd.getRandomNumber(255);
+			}
+			for (int i = 0; i < uvPitch * (height + 1); i++) {
+				u[i] = (i / 3) % 4 == 0 ? ((i & 2) ? 255 : 0) : rnd.getRandomNumber(255);
+				v[i] = (i / 5) % 4 == 0 ? ((i & 1) ? 0 : 255) : rnd.getRandomNumber(255);
+			}
+		}
+
+		~Planes() {
+			delete[] y;
+			delete[] u;
+			delete[] v;
+			delete[] a;
+		}
+	};
+
+	static void convert(Conversion conversion, Graphics::Surface &dst, Graphics::YUVToRGBManager::LuminanceScale scale, const Planes &planes, int width, int height) {
+		switch (conversion) {
+		case k444:
+			YUVToRGBMan.convert444(&dst, scale, planes.y, planes.u, planes.v, width, height, planes.yPitch, planes.uvPitch);
+			break;
+		case k420:
+			YUVToRGBMan.convert420(&dst, scale, planes.y, planes.u, planes.v, width, height, planes.yPitch, planes.uvPitch);
+			break;
+		case k420Alpha:
+			YUVToRGBMan.convert420Alpha(&dst, scale, planes.y, planes.u, planes.v, planes.a, width, height, planes.yPitch, planes.uvPitch);
+			break;
+		case k410:
+			YUVToRGBMan.convert410(&dst, scale, planes.y, planes.u, planes.v, width, height, planes.yPitch, planes.uvPitch);
+			break;
+		}
+	}
+
+	void compareConversion(Conversion conversion, const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale, int width, int height) {
+		Planes planes(width, height, width * 31 + height);
+		Graphics::Surface generic, simd;
+		generic.create(width + 1, height, format);
+		simd.create(width + 1, height, format);
+		memset(generic.getPixels(), 0, generic.pitch * height);
+
+		Common::setCpuFeatureMask(0);
+		convert(conversion, generic, scale, planes, width, height);
+
+		const uint32 features[] = { Common::kCpuFeatureSSE2, Common::kCpuFeatureAll };
+		for (int i = 0; i < 2; i++) {
+			memset(simd.getPixels(), 0, simd.pitch * height);
+			Common::setCpuFeatureMask(features[i]);
+			convert(conversion, simd, scale, planes, width, height);
+
+			int differences = 0;
+			for (int y = 0; y < height; y++)
+				differences += memcmp(generic.getBasePtr(0, y), simd.getBasePtr(0, y), (width + 1) * format.bytesPerPixel) != 0;
+			if (differences) {
+				TS_TRACE(Common::String::format("Conversion %d to %s, scale %d, %dx%d", conversion, format.toString().c_str(), scale, width, height).c_str());
+			}
+			TS_ASSERT_EQUALS(differences, 0);
+		}
+		Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+
+		generic.free();
+		simd.free();
+	}
+
+	void test_simd_matches_tables() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0),
+			Graphics::PixelFormat(2, 4, 4, 4, 4, 8, 4, 0, 12),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 0)
+		};
+		const Conversion conversions[] = { k444, k420, k420Alpha, k410 };
+		const Graphics::YUVToRGBManager::LuminanceScale scales[] = { Graphics::YUVToRGBManager::kScaleFull, Graphics::YUVToRGBManager::kScaleITU };
+
+		for (int f = 0; f < ARRAYSIZE(formats); f++) {
+			for (int c = 0; c < ARRAYSIZE(conversions); c++) {
+				for (int s = 0; s < 2; s++) {
+					compareConversion(conversions[c], formats[f], scales[s], 64, 16);
+					compareConversion(conversions[c], formats[f], scales[s], 36, 12);
+					compareConversion(conversions[c], formats[f], scales[s], 4, 4);
+				}
+			}
+		}
+#endif
+	}
+
+	// Reports the conversion speed of full screen frames in frames per second
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const int kWidth = 640;
+		const int kHeight = 480;
+		const int kFrames = 20;
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+		const char *names[] = { "444", "420", "420 alpha", "410" };
+		Planes planes(kWidth, kHeight, 1);
+
+		for (int f = 0; f < ARRAYSIZE(formats); f++) {
+			Graphics::Surface dst;
+			dst.create(kWidth, kHeight, formats[f]);
+
+			for (int c = k444; c <= k410; c++) {
+				uint32 times[2];
+				for (int simd = 0; simd < 2; simd++) {
+					Common::setCpuFeatureMask(simd ? Common::kCpuFeatureAll : 0);
+					const uint32 start = g_system->getMillis();
+					for (int frame = 0; frame < kFrames; frame++)
+						convert((Conversion)c, dst, Graphics::YUVToRGBManager::kScaleITU, planes, kWidth, kHeight);
+					times[simd] = MAX<uint32>(g_system->getMillis() - start, 1);
+				}
+
+				TS_TRACE(Common::String::format("%s to %d bpp: %u fps tables, %u fps SIMD", names[c], formats[f].bytesPerPixel * 8,
+				                                kFrames * 1000 / times[0], kFrames * 1000 / times[1]).c_str());
+			}
+
+			dst.free();
+		}
+
+		Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+#endif
+	}
+};
@@ -0,0 +1,831 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/cpudetect.h"
+#include "common/memstream.h"
+#include "common/random.h"
+#include "common/str.h"
+#include "common/system.h"
+#include "graphics/surface.h"
+#include "image/codecs/indeo4.h"
+#include "image/codecs/indeo5.h"
+
+#include "../null_osystem.h"
+
+/**
+ * Builds synthetic Indeo 4 and Indeo 5 videos which go through tiles, wavelet
+ * bands, all macroblock types and inherited motion vectors, and checks the
+ * frames the decoders make of them against hashes of known good frames.
+ *
+ * The encoder keeps the same macroblock state as the decoder, so it knows
+ * which motion vectors the bands inherit from the first band, and only codes
+ * vectors which stay inside the reference buffers of all of them.
+ */
+class IndeoTestSuite : public CxxTest::TestSuite
+{
+	public:
+	/** Writes bits in the order the decoder reads them, the lowest bit of every byte first. */
+	struct BitWriter {
+		Common::Array<byte> data;
+		uint32 bits;
+
+		BitWriter() : bits(0) {}
+
+		void put(uint32 value, int n) {
+			for (int i = 0; i < n; i++, bits++) {
+				if (!(bits & 7))
+					data.push_back(0);
+				if ((value >> i) & 1)
+					data.back() |= 1 << (bits & 7);
+			}
+		}
+
+		void append(const BitWriter &other) {
+			for (uint32 i = 0; i < other.bits; i++)
+				put((other.data[i >> 3] >> (i & 7)) & 1, 1);
+		}
+
+		void align() {
+			while (bits & 7)
+				put(0, 1);
+		}
+	};
+
+	/** Gives access to the run-value tables, which are the same in both decoders. */
+	class RVMapDecoder : public Image::Indeo4Decoder {
+	public:
+		RVMapDecoder() : Image::Indeo4Decoder(16, 16, 32) {}
+
+		const Image::Indeo::RVMapDesc &getRVMap(int sel) const { return _ctx._rvmapTabs[sel]; }
+	};
+
+	struct HuffDesc {
+		int numRows;
+		uint8 xBits[16];
+	};
+
+	// The predefined block codebooks of the decoder, and a custom one
+	static const HuffDesc &blockDesc(int sel) {
+		static const HuffDesc descs[9] = {
+			{ 10, { 1, 2, 3, 4, 4, 7, 5, 5, 4, 1 } },
+			{ 11, { 2, 3, 4, 4, 4, 7, 5, 4, 3, 3, 2 } },
+			{ 12, { 2, 4, 5, 5, 5, 5, 6, 4, 4, 3, 1, 1 } },
+			{ 13, { 3, 3, 4, 4, 5, 6, 6, 4, 4, 3, 2, 1, 1 } },
+			{ 11, { 3, 4, 4, 5, 5, 5, 6, 5, 4, 2, 2 } },
+			{ 13, { 3, 4, 5, 5, 5, 5, 6, 4, 3, 3, 2, 1, 1 } },
+			{ 13, { 3, 4, 5, 5, 5, 6, 5, 4, 3, 3, 2, 1, 1 } },
+			{ 9,  { 3, 4, 4, 5, 5, 5, 6, 5, 5 } },
+			{ 8,  { 2, 3, 4, 5, 6, 7, 5, 4 } }
+		};
+		return descs[sel];
+	}
+
+	// The default macroblock codebook
+	static const HuffDesc &mbDesc() {
+		static const HuffDesc desc = { 12, { 0, 4, 4, 4, 3, 3, 2, 3, 2, 2, 2, 2 } };
+		return desc;
+	}
+
+	static void putSymbol(BitWriter &out, const HuffDesc &desc, uint sym) {
+		uint pos = 0;
+		for (int i = 0; i < desc.numRows; i++) {
+			const uint count = 1 << desc.xBits[i];
+			if (sym < pos + count) {
+				// The codes are read from their top bit on
+				const int notLastRow = i != desc.numRows - 1;
+				const int length = i + desc.xBits[i] + notLastRow;
+				const uint code = (((1 << i) - 1) << (desc.xBits[i] + notLastRow)) | (sym - pos);
+				for (int bit = length - 1; bit >= 0; bit--)
+					out.put((code >> bit) & 1, 1);
+				return;
+			}
+			pos += count;
+		}
+		TS_FAIL("Symbol outside of the codebook");
+	}
+
+	static void putSigned(BitWriter &out, int value) {
+		putSymbol(out, mbDesc(), value > 0 ? value * 2 - 1 : -value * 2);
+	}
+
+	static void putHuffDesc(BitWriter &out, int sel) {
+		out.put(MIN(sel, 7), 3);
+		if (sel >= 7) {
+			const HuffDesc &desc = blockDesc(sel);
+			out.put(desc.numRows, 4);
+			for (int i = 0; i < desc.numRows; i++)
+				out.put(desc.xBits[i], 4);
+		}
+	}
+
+	static uint32 randomValue(Common::RandomSource &rnd, uint32 max) {
+		return max ? rnd.getRandomNumber(max) : 0;
+	}
+
+	static int randomRange(Common::RandomSource &rnd, int min, int max) {
+		return min + (int)randomValue(rnd, max - min);
+	}
+
+	enum {
+		kIndeo4Intra = 0,
+		kIndeo4Intra1 = 1,
+		kIndeo4Inter = 2,
+		kIndeo4Bidir = 3
+	};
+
+	enum {
+		kIndeo5Intra = 0,
+		kIndeo5Inter = 1,
+		kIndeo5InterNoRef = 3
+	};
+
+	struct VideoParams {
+		bool isIndeo5;
+		int width;
+		int height;
+		int tileSize;
+		bool isScalable;
+		int frameCount;
+		int frameTypes[8];
+		uint32 seed;
+	};
+
+	struct Macroblock {
+		int x, y;
+		int type, cbp;
+		int mvX, mvY, bMvX, bMvY;
+	};
+
+	struct Tile {
+		int x, y, width, height;
+		Common::Array<Macroblock> mbs;
+	};
+
+	struct Band {
+		int plane, index;
+		int width, height, pitch, alignedHeight;
+		int mbSize, blkSize;
+		Common::Array<Tile> tiles;
+
+		// The coding of the current frame
+		int halfpel;
+		bool inheritMv, inheritQDelta, qdeltaPresent;
+		int globQuant;
+		int transform, scan, quantMat;
+		int blkTable;
+		bool codedBlkTable;
+		int rvmapSel;
+		Common::Array<int> corrections;
+		Image::Indeo::RVMapDesc rvmap;
+	};
+
+	/** Keeps the state of the decoder between the frames it builds. */
+	struct Encoder {
+		const VideoParams &params;
+		Common::RandomSource &rnd;
+		const RVMapDecoder &rvmaps;
+		Common::Array<Band> bands;
+
+		int frameType;
+		bool isIntra;
+		bool inQ;
+		int frameFlags;
+		int picBlkTable;
+
+		Encoder(const VideoParams &videoParams, Common::RandomSource &r, const RVMapDecoder &maps) : params(videoParams), rnd(r), rvmaps(maps),
+				frameType(0), isIntra(true), inQ(false), frameFlags(0), picBlkTable(7) {
+			const int lumaBands = params.isScalable ? 4 : 1;
+			for (int p = 0; p < 3; p++) {
+				const int numBands = p ? 1 : lumaBands;
+				const int planeWidth = p ? (params.width + 3) >> 2 : params.width;
+				const int planeHeight = p ? (params.height + 3) >> 2 : params.height;
+				const int align = p ? 8 : 16;
+
+				int tileWidth = params.tileSize ? params.tileSize : params.width;
+				int tileHeight = params.tileSize ? params.tileSize : params.height;
+				if (p) {
+					tileWidth = (tileWidth + 3) >> 2;
+					tileHeight = (tileHeight + 3) >> 2;
+				} else if (numBands == 4) {
+					tileWidth >>= 1;
+					tileHeight >>= 1;
+				}
+
+				for (int b = 0; b < numBands; b++) {
+					Band band = Band();
+					band.plane = p;
+					band.index = b;
+					band.width = numBands == 1 ? planeWidth : (planeWidth + 1) >> 1;
+					band.height = numBands == 1 ? planeHeight : (planeHeight + 1) >> 1;
+					band.pitch = (band.width + align - 1) & ~(align - 1);
+					band.alignedHeight = (band.height + align - 1) & ~(align - 1);
+					band.mbSize = p ? 4 : (params.isScalable ? 8 : 16);
+					band.blkSize = p ? 4 : 8;
+					band.halfpel = 0;
+
+					for (int y = 0; y < band.height; y += tileHeight) {
+						for (int x = 0; x < band.width; x += tileWidth) {
+							Tile tile;
+							tile.x = x;
+							tile.y = y;
+							tile.width = MIN(band.width - x, tileWidth);
+							tile.height = MIN(band.height - y, tileHeight);
+							for (int mbY = y; mbY < y + tile.height; mbY += band.mbSize) {
+								for (int mbX = x; mbX < x + tile.width; mbX += band.mbSize) {
+									Macroblock mb;
+									memset(&mb, 0, sizeof(mb));
+									mb.x = mbX;
+									mb.y = mbY;
+									tile.mbs.push_back(mb);
+								}
+							}
+							band.tiles.push_back(tile);
+						}
+					}
+					bands.push_back(band);
+				}
+			}
+		}
+
+		static int scaleMV(int mv, int mvScale) {
+			return mvScale ? (mv + (mv > 0) + (mvScale - 1)) >> mvScale : mv;
+		}
+
+		int mvScale(const Band &band) const {
+			return (bands[0].mbSize >> 3) - (band.mbSize >> 3);
+		}
+
+		static bool isValidMv(const Band &band, const Macroblock &mb, int mvX, int mvY) {
+			const int s = band.halfpel;
+			const int dx = mvX >> s;
+			const int dy = mvY >> s;
+			return mb.x + dx >= 0 && mb.x + dx + band.mbSize + (mvX & s) <= band.pitch &&
+				mb.y + dy >= 0 && mb.y + dy + band.mbSize + (mvY & s) <= band.alignedHeight;
+		}
+
+		/** Pick a vector for a macroblock of a band, valid in all bands which inherit it. */
+		void chooseMv(const Band &band, int t, int m, int &mvX, int &mvY) {
+			for (int attempt = 0; attempt < 8; attempt++) {
+				mvX = randomRange(rnd, -10, 10);
+				mvY = randomRange(rnd, -10, 10);
+				bool valid = isValidMv(band, band.tiles[t].mbs[m], mvX, mvY);
+				for (uint b = 1; valid && &band == &bands[0] && b < bands.size(); b++) {
+					if (bands[b].inheritMv)
+						valid = isValidMv(bands[b], bands[b].tiles[t].mbs[m], scaleMV(mvX, mvScale(bands[b])), scaleMV(mvY, mvScale(bands[b])));
+				}
+				if (valid)
+					return;
+			}
+			mvX = mvY = 0;
+		}
+
+		void chooseBandParams() {
+			for (uint b = 0; b < bands.size(); b++) {
+				Band &band = bands[b];
+				const bool isFirst = b == 0;
+
+				if (!params.isIndeo5)
+					band.halfpel = randomValue(rnd, 1);
+				else if (isIntra)
+					band.halfpel = band.plane == 2 ? bands[b - 1].halfpel : randomValue(rnd, 1);
+
+				band.inheritMv = !isFirst && randomValue(rnd, 2);
+				band.inheritQDelta = !isFirst && randomValue(rnd, 1);
+				band.qdeltaPresent = false;
+				if (params.isIndeo5) {
+					band.qdeltaPresent = randomValue(rnd, 1);
+					if (!band.qdeltaPresent)
+						band.inheritQDelta = true;
+					else if (isFirst)
+						band.inheritQDelta = false;
+				}
+				band.globQuant = randomRange(rnd, 0, 8);
+
+				if (band.blkSize == 8) {
+					static const int transforms[] = { 0, 0, 1, 2, 3, 4, 4, 5, 6 };
+					band.transform = transforms[randomValue(rnd, ARRAYSIZE(transforms) - 1)];
+					band.scan = randomValue(rnd, 1) ? randomValue(rnd, 4) : randomRange(rnd, 10, 14);
+					band.quantMat = randomValue(rnd, 14);
+				} else {
+					static const int transforms[] = { 10, 11, 11, 13, 14, 15, 16 };
+					band.transform = transforms[randomValue(rnd, ARRAYSIZE(transforms) - 1)];
+					band.scan = randomRange(rnd, 5, 9);
+					band.quantMat = randomRange(rnd, 15, 21);
+				}
+
+				band.codedBlkTable = randomValue(rnd, 1);
+				if (band.codedBlkTable) {
+					band.blkTable = randomValue(rnd, 7);
+					if (band.blkTable == 7)
+						band.blkTable = 8;
+				} else {
+					band.blkTable = params.isIndeo5 ? 7 : picBlkTable;
+				}
+
+				band.rvmapSel = randomValue(rnd, 8);
+				band.rvmap = rvmaps.getRVMap(band.rvmapSel);
+				band.corrections.clear();
+				const int numCorr = randomValue(rnd, 1) ? randomValue(rnd, 3) : 0;
+				for (int i = 0; i < numCorr; i++) {
+					const int idx1 = randomValue(rnd, 255);
+					const int idx2 = randomValue(rnd, 255);
+					band.corrections.push_back(idx1);
+					band.corrections.push_back(idx2);
+
+					Image::Indeo::RVMapDesc &rvmap = band.rvmap;
+					SWAP(rvmap._runtab[idx1], rvmap._runtab[idx2]);
+					SWAP(rvmap._valtab[idx1], rvmap._valtab[idx2]);
+					if (idx1 == rvmap._eobSym || idx2 == rvmap._eobSym)
+						rvmap._eobSym ^= idx1 ^ idx2;
+					if (idx1 == rvmap._escSym || idx2 == rvmap._escSym)
+						rvmap._escSym ^= idx1 ^ idx2;
+				}
+			}
+		}
+
+		void putCorrections(BitWriter &out, const Band &band) {
+			for (uint i = 0; i < band.corrections.size(); i++)
+				out.put(band.corrections[i], 8);
+		}
+
+		void encodeIndeo4Header(BitWriter &out) {
+			out.put(0x3FFF8, 18);
+			out.put(frameType, 3);
+			out.put(0, 4);
+
+			out.put(7, 3);
+			out.put(params.height, 16);
+			out.put(params.width, 16);
+			if (params.tileSize) {
+				out.put(1, 1);
+				out.put(params.tileSize / 32 - 1, 4);
+				out.put(params.tileSize / 32 - 1, 4);
+			} else {
+				out.put(0, 1);
+			}
+			out.put(0, 2);
+
+			if (params.isScalable) {
+				out.put(2, 2);
+				out.put(0xFF, 8);
+			} else {
+				out.put(3, 2);
+			}
+			out.put(3, 2);
+
+			out.put(0, 3);
+			out.put(picBlkTable != 7, 1);
+			if (picBlkTable != 7)
+				putHuffDesc(out, picBlkTable);
+			out.put(0, 2);
+			out.put(inQ, 1);
+			out.put(randomValue(rnd, 31), 5);
+			out.put(0, 4);
+			out.align();
+		}
+
+		void encodeIndeo4BandHeader(BitWriter &out, const Band &band) {
+			out.put(band.plane, 2);
+			out.put(band.index, 4);
+			out.put(0, 2);
+			out.put(band.halfpel, 2);
+			out.put(0, 1);
+			out.put(band.mbSize == 16 ? 0 : (band.mbSize == 8 ? 1 : 2), 2);
+			out.put(band.inheritMv, 1);
+			out.put(band.inheritQDelta, 1);
+			out.put(band.globQuant, 5);
+			out.put(0, 1);
+			out.put(band.transform, 5);
+			out.put(band.scan, 4);
+			out.put(band.quantMat, 5);
+
+			out.put(band.codedBlkTable, 1);
+			if (band.codedBlkTable)
+				putHuffDesc(out, band.blkTable);
+
+			out.put(band.rvmapSel != 8, 1);
+			if (band.rvmapSel != 8)
+				out.put(band.rvmapSel, 3);
+
+			out.put(!band.corrections.empty(), 1);
+			if (!band.corrections.empty()) {
+				out.put(band.corrections.size() / 2, 8);
+				putCorrections(out, band);
+			}
+			out.align();
+		}
+
+		void encodeIndeo5Header(BitWriter &out, int frameNum) {
+			out.put(0x1F, 5);
+			out.put(frameType, 3);
+			out.put(frameNum, 8);
+
+			if (isIntra) {
+				out.put(params.tileSize ? 0x40 : 0, 8);
+				if (params.tileSize)
+					out.put(params.tileSize == 64 ? 0 : (params.tileSize == 128 ? 1 : 2), 2);
+				out.put(params.isScalable, 2);
+				out.put(0, 1);
+				out.put(15, 4);
+				out.put(params.height, 13);
+				out.put(params.width, 13);
+
+				for (uint b = 0; b < bands.size() && bands[b].plane < 2; b++) {
+					out.put(bands[b].halfpel, 1);
+					out.put(bands[b].mbSize == bands[b].blkSize, 1);
+					out.put(bands[b].blkSize == 4, 1);
+					out.put(0, 3);
+				}
+				out.align();
+				out.put(0, 24);
+				out.align();
+			}
+
+			out.put(frameFlags, 8);
+			out.put(0, 3);
+			out.align();
+		}
+
+		void encodeIndeo5BandHeader(BitWriter &out, const Band &band) {
+			const int flags = (band.inheritMv ? 2 : 0) | (band.qdeltaPresent ? 4 : 0) |
+				(band.qdeltaPresent && band.inheritQDelta ? 8 : 0) | (band.corrections.empty() ? 0 : 0x10) |
+				(band.rvmapSel != 8 ? 0x40 : 0) | (band.codedBlkTable ? 0x80 : 0);
+			out.put(flags, 8);
+
+			if (!band.corrections.empty()) {
+				out.put(band.corrections.size() / 2, 8);
+				putCorrections(out, band);
+			}
+			if (band.rvmapSel != 8)
+				out.put(band.rvmapSel, 3);
+			if (band.codedBlkTable)
+				putHuffDesc(out, band.blkTable);
+
+			out.put(0, 1);
+			out.put(band.globQuant, 5);
+			out.align();
+		}
+
+		bool qDeltaForFirstBand(const Band &band) const {
+			return band.plane == 0 && band.index == 0 && (params.isIndeo5 ? (frameFlags & 8) != 0 : inQ);
+		}
+
+		void inheritMv(const Band &band, Macroblock &mb, const Macroblock &refMb) {
+			mb.mvX = scaleMV(refMb.mvX, mvScale(band));
+			mb.mvY = scaleMV(refMb.mvY, mvScale(band));
+		}
+
+		void encodeMbInfo(BitWriter &out, Band &band, int t) {
+			Tile &tile = band.tiles[t];
+			const bool isFirst = &band == &bands[0];
+			const int blksPerMb = band.mbSize != band.blkSize ? 4 : 1;
+			const bool isBidir = !params.isIndeo5 && frameType == kIndeo4Bidir;
+			int mvX = 0, mvY = 0;
+
+			for (uint m = 0; m < tile.mbs.size(); m++) {
+				Macroblock &mb = tile.mbs[m];
+				const Macroblock *refMb = isFirst ? nullptr : &bands[0].tiles[t].mbs[m];
+				if (!params.isIndeo5)
+					mb.bMvX = mb.bMvY = 0;
+
+				if (!isIntra && !randomValue(rnd, 5)) {
+					out.put(1, 1);
+					if (qDeltaForFirstBand(band))
+						putSigned(out, randomRange(rnd, -4, 4));
+
+					mb.type = 1;
+					mb.cbp = 0;
+					mb.mvX = mb.mvY = 0;
+					if (band.inheritMv && refMb)
+						inheritMv(band, mb, *refMb);
+					continue;
+				}
+
+				out.put(0, 1);
+				if (band.inheritMv && refMb) {
+					mb.type = refMb->type;
+				} else if (isIntra) {
+					mb.type = 0;
+				} else {
+					mb.type = randomValue(rnd, isBidir ? 3 : 2);
+					mb.type = MIN(mb.type, isBidir ? 3 : 1);
+					out.put(mb.type, isBidir ? 2 : 1);
+				}
+
+				mb.cbp = randomValue(rnd, (1 << blksPerMb) - 1);
+				if (mb.type == 0 && !randomValue(rnd, 2))
+					mb.cbp = (1 << blksPerMb) - 1;
+				out.put(mb.cbp, blksPerMb);
+
+				if (!params.isIndeo5 || band.qdeltaPresent) {
+					if (!band.inheritQDelta && (mb.cbp || qDeltaForFirstBand(band)))
+						putSigned(out, randomRange(rnd, -4, 4));
+				}
+
+				if (!mb.type) {
+					mb.mvX = mb.mvY = 0;
+					continue;
+				}
+
+				if (band.inheritMv && refMb) {
+					inheritMv(band, mb, *refMb);
+				} else {
+					int targetX, targetY;
+					chooseMv(band, t, m, targetX, targetY);
+					if (mb.type == 2 && !isValidMv(band, mb, -targetX, -targetY))
+						targetX = targetY = 0;
+					putSigned(out, targetY - mvY);
+					putSigned(out, targetX - mvX);
+					mvX = mb.mvX = targetX;
+					mvY = mb.mvY = targetY;
+
+					if (mb.type == 3) {
+						int backX = randomRange(rnd, -10, 10);
+						int backY = randomRange(rnd, -10, 10);
+						if (!isValidMv(band, mb, backX, backY))
+							backX = backY = 0;
+						putSigned(out, -backY - mvY);
+						putSigned(out, -backX - mvX);
+						mvX = -backX;
+						mvY = -backY;
+						mb.bMvX = backX;
+						mb.bMvY = backY;
+					}
+				}
+
+				if (mb.type == 2) {
+					mb.bMvX = -mb.mvX;
+					mb.bMvY = -mb.mvY;
+					mb.mvX = mb.mvY = 0;
+				}
+			}
+
+			out.align();
+		}
+
+		void encodeCoefficients(BitWriter &out, const Band &band) {
+			const Image::Indeo::RVMapDesc &rvmap = band.rvmap;
+			const HuffDesc &desc = blockDesc(band.blkTable);
+			const int numCoeffs = band.blkSize * band.blkSize;
+			const int count = 1 + randomValue(rnd, randomValue(rnd, 3) ? 4 : numCoeffs / 2);
+
+			int scanPos = -1;
+			for (int i = 0; i < count && scanPos < numCoeffs - 1; i++) {
+				bool coded = false;
+				for (int attempt = 0; attempt < 16 && !coded && randomValue(rnd, 3); attempt++) {
+					const int sym = randomValue(rnd, 255);
+					const int run = rvmap._runtab[sym];
+					if (sym == rvmap._eobSym || sym == rvmap._escSym || !rvmap._valtab[sym] ||
+						scanPos + run < 0 || scanPos + run >= numCoeffs)
+						continue;
+					putSymbol(out, desc, sym);
+					scanPos += run;
+					coded = true;
+				}
+
+				if (!coded) {
+					// Escapes code large values as well
+					const int run = 1 + randomValue(rnd, numCoeffs - 2 - scanPos);
+					const int value = 1 + randomValue(rnd, randomValue(rnd, 15) ? 24 : 4000);
+					putSymbol(out, desc, rvmap._escSym);
+					putSymbol(out, desc, run - 1);
+					putSymbol(out, desc, value & 63);
+					putSymbol(out, desc, value >> 6);
+					scanPos += run;
+				}
+			}
+
+			putSymbol(out, desc, rvmap._eobSym);
+		}
+
+		void encodeBlocks(BitWriter &out, const Band &band, const Tile &tile) {
+			const int numBlocks = band.mbSize != band.blkSize ? 4 : 1;
+			for (uint m = 0; m < tile.mbs.size(); m++) {
+				for (int blk = 0; blk < numBlocks; blk++) {
+					if (tile.mbs[m].cbp & (1 << blk))
+						encodeCoefficients(out, band);
+				}
+			}
+			out.align();
+		}
+
+		void processEmptyTile(Band &band, int t) {
+			Tile &tile = band.tiles[t];
+			const bool isFirst = &band == &bands[0];
+			for (uint m = 0; m < tile.mbs.size(); m++) {
+				Macroblock &mb = tile.mbs[m];
+				mb.type = 1;
+				mb.cbp = 0;
+				if (!band.qdeltaPresent && isFirst)
+					mb.mvX = mb.mvY = 0;
+				if (band.inheritMv && !isFirst)
+					inheritMv(band, mb, bands[0].tiles[t].mbs[m]);
+			}
+		}
+
+		void encodeTiles(BitWriter &out, Band &band) {
+			// Tile sizes count from the end of the last tile which was not empty
+			uint32 pos = out.bits;
+			for (uint t = 0; t < band.tiles.size(); t++) {
+				// The first band keeps its old vectors in empty tiles with quant deltas
+				const bool canBeEmpty = !isIntra && (!band.qdeltaPresent || &band != &bands[0]);
+				if (canBeEmpty && !randomValue(rnd, 6)) {
+					out.put(1, 1);
+					processEmptyTile(band, t);
+					continue;
+				}
+
+				BitWriter payload;
+				encodeMbInfo(payload, band, t);
+				encodeBlocks(payload, band, band.tiles[t]);
+
+				out.put(0, 1);
+				const uint32 start = out.bits;
+				uint32 size = (((start + 9 + 7) & ~7) + payload.bits - pos) / 8;
+				out.put(1, 1);
+				if (size < 255) {
+					out.put(size, 8);
+				} else {
+					size = (((start + 33 + 7) & ~7) + payload.bits - pos) / 8;
+					out.put(255, 8);
+					out.put(size, 24);
+				}
+				out.align();
+				out.append(payload);
+				pos = out.bits;
+			}
+			out.align();
+		}
+
+		void encodeFrame(int frameNum, BitWriter &out) {
+			frameType = params.frameTypes[frameNum];
+			if (params.isIndeo5) {
+				isIntra = frameType == kIndeo5Intra;
+				frameFlags = randomValue(rnd, 1) ? 8 : 0;
+			} else {
+				isIntra = frameType == kIndeo4Intra || frameType == kIndeo4Intra1;
+				inQ = randomValue(rnd, 1);
+				picBlkTable = randomValue(rnd, 2) ? 7 : randomValue(rnd, 6);
+			}
+			chooseBandParams();
+
+			if (params.isIndeo5)
+				encodeIndeo5Header(out, frameNum);
+			else
+				encodeIndeo4Header(out);
+
+			for (uint b = 0; b < bands.size(); b++) {
+				if (params.isIndeo5)
+					encodeIndeo5BandHeader(out, bands[b]);
+				else
+					encodeIndeo4BandHeader(out, bands[b]);
+				encodeTiles(out, bands[b]);
+			}
+
+			// Indeo 4 intra frames end with a version string
+			out.put(0, 16 * 8);
+		}
+	};
+
+	static uint32 hashSurface(const Graphics::Surface &surface) {
+		uint32 hash = 2166136261U;
+		for (int y = 0; y < surface.h; y++) {
+			const byte *row = (const byte *)surface.getBasePtr(0, y);
+			for (int x = 0; x < surface.w * surface.format.bytesPerPixel; x++)
+				hash = (hash ^ row[x]) * 16777619U;
+		}
+		return hash;
+	}
+
+	static void createFrames(const VideoParams &params, Common::Array<Common::Array<byte> > &frames) {
+		Common::RandomSource rnd("indeo");
+		rnd.setSeed(params.seed);
+
+		RVMapDecoder *rvmaps = new RVMapDecoder();
+		Encoder encoder(params, rnd, *rvmaps);
+
+		frames.resize(params.frameCount);
+		for (int i = 0; i < params.frameCount; i++) {
+			BitWriter out;
+			encoder.encodeFrame(i, out);
+			frames[i] = out.data;
+		}
+
+		delete rvmaps;
+	}
+
+	static Image::Codec *createDecoder(const VideoParams &params) {
+		if (params.isIndeo5)
+			return new Image::Indeo5Decoder(params.width, params.height, 32);
+		return new Image::Indeo4Decoder(params.width, params.height, 32);
+	}
+
+	static void decodeHashes(const VideoParams &params, Common::Array<uint32> &hashes) {
+		Common::Array<Common::Array<byte> > frames;
+		createFrames(params, frames);
+
+		Image::Codec *decoder = createDecoder(params);
+		hashes.clear();
+		for (uint i = 0; i < frames.size(); i++) {
+			Common::MemoryReadStream stream(&frames[i][0], frames[i].size());
+			const Graphics::Surface *frame = decoder->decodeFrame(stream);
+			TS_ASSERT(frame);
+			if (frame)
+				hashes.push_back(hashSurface(*frame));
+		}
+		delete decoder;
+	}
+
+	static const VideoParams *videos() {
+		static const VideoParams entries[] = {
+			{ false, 120, 72, 32,  false, 7, { kIndeo4Intra, kIndeo4Inter, kIndeo4Bidir, kIndeo4Inter, kIndeo4Intra1, kIndeo4Inter, kIndeo4Bidir }, 1 },
+			{ false, 120, 72, 32,  true,  5, { kIndeo4Intra, kIndeo4Inter, kIndeo4Inter, kIndeo4Bidir, kIndeo4Inter }, 2 },
+			{ false, 64,  48, 0,   false, 4, { kIndeo4Intra, kIndeo4Inter, kIndeo4Bidir, kIndeo4Inter }, 3 },
+			{ true,  120, 72, 64,  false, 5, { kIndeo5Intra, kIndeo5Inter, kIndeo5Inter, kIndeo5InterNoRef, kIndeo5Inter }, 4 },
+			{ true,  120, 72, 64,  true,  4, { kIndeo5Intra, kIndeo5Inter, kIndeo5Inter, kIndeo5Inter }, 5 },
+			{ true,  64,  48, 0,   false, 4, { kIndeo5Intra, kIndeo5Inter, kIndeo5InterNoRef, kIndeo5Inter }, 6 },
+			{ false, 0,   0,  0,   false, 0, { 0 }, 0 }
+		};
+		return entries;
+	}
+
+	void test_frames_match_reference() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		// The decoders take the format of the screen unless it is paletted
+		g_system->initSize(320, 200);
+
+		// Frames of the videos, as decoded before the decoders used SIMD or threads
+		static const uint32 reference[][8] = {
+			{ 0xA20181A0, 0xA4931BB2, 0x3938FD25, 0x4ABA506A, 0x9688F76A, 0xF65513D2, 0x263D09C2 },
+			{ 0x1DF13B2E, 0xF851E323, 0xF305F2F2, 0x3E677AF1, 0xC5A05ED5 },
+			{ 0x9A7C85BB, 0x07264F58, 0xE1B15B14, 0x0DA904E3 },
+			{ 0x244E4470, 0x6CACEF46, 0x5092D54B, 0xFBEC4703, 0xBE8BCD81 },
+			{ 0xC02E5572, 0x8531ABFD, 0x6B6F964F, 0xE6010ABD },
+			{ 0x37F95C00, 0xF42D4FFF, 0x1E52365C, 0x996408BE }
+		};
+
+		int i = 0;
+		for (const VideoParams *video = videos(); video->width; video++, i++) {
+			const uint32 features[] = { 0, Common::kCpuFeatureSSE2, Common::kCpuFeatureAll };
+			for (int j = 0; j < ARRAYSIZE(features); j++) {
+				Common::setCpuFeatureMask(features[j]);
+
+				Common::Array<uint32> hashes;
+				decodeHashes(*video, hashes);
+
+				TS_ASSERT_EQUALS(hashes.size(), (uint)video->frameCount);
+				for (uint k = 0; k < hashes.size(); k++) {
+					if (hashes[k] != reference[i][k])
+						TS_TRACE(Common::String::format("Video %d, frame %d, CPU features %x", i, k, features[j]).c_str());
+					TS_ASSERT_EQUALS(hashes[k], reference[i][k]);
+				}
+			}
+		}
+
+		Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+#endif
+	}
+
+	// Reports the decoding time per frame of both codecs, with and without SIMD
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		g_system->initSize(320, 200);
+
+		static const VideoParams benchmarks[] = {
+			{ false, 640, 480, 128, false, 6, { kIndeo4Intra, kIndeo4Inter, kIndeo4Inter, kIndeo4Bidir, kIndeo4Inter, kIndeo4Inter }, 7 },
+			{ true,  640, 480, 128, false, 6, { kIndeo5Intra, kIndeo5Inter, kIndeo5Inter, kIndeo5InterNoRef, kIndeo5Inter, kIndeo5Inter }, 8 }
+		};
+		const int kPasses = 5;
+
+		for (int i = 0; i < ARRAYSIZE(benchmarks); i++) {
+			Common::Array<Common::Array<byte> > frames;
+			createFrames(benchmarks[i], frames);
+
+			uint32 times[2];
+			for (int simd = 0; simd < 2; simd++) {
+				Common::setCpuFeatureMask(simd ? Common::kCpuFeatureAll : 0);
+				times[simd] = 0;
+				for (int pass = 0; pass < kPasses; pass++) {
+					Image::Codec *decoder = createDecoder(benchmarks[i]);
+					const uint32 start = g_system->getMillis();
+					for (uint f = 0; f < frames.size(); f++) {
+						Common::MemoryReadStream stream(&frames[f][0], frames[f].size());
+						decoder->decodeFrame(stream);
+					}
+					times[simd] += g_system->getMillis() - start;
+					delete decoder;
+				}
+			}
+
+			const uint32 frameCount = kPasses * frames.size();
+			TS_TRACE(Common::String::format("Indeo %d %dx%d: %u us/frame generic, %u us/frame SIMD",
+			                                benchmarks[i].isIndeo5 ? 5 : 4, benchmarks[i].width, benchmarks[i].height,
+			                                times[0] * 1000 / frameCount, times[1] * 1000 / frameCount).c_str());
+		}
+
+		Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+#endif
+	}
+};
@@ -5,7 +5,7 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/video/*.h $(srcdir)/test/image/*.h
 TEST_LIBS    :=
 
 ifdef POSIX
@@ -13,9 +13,14 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/posix/posix-fs-factory.o \
 	backends/fs/posix/posix-fs.o \
 	backends/fs/posix/posix-iostream.o \
+	backends/fs/posix/posix-mmapstream.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
 	backends/modular-backend.o
+ifdef HAS_PTHREADS
+TEST_LIBS += backends/mutex/pthread/pthread-mutex.o \
+	backends/threads/pthread/pthread-threads.o
+endif
 endif
 
 ifdef WIN32
@@ -27,7 +32,23 @@ TEST_LIBS += test/null_osystem.o \
 	backends/modular-backend.o
 endif
 
-TEST_LIBS +=	audio/libaudio.a math/libmath.a common/libcommon.a
+TESTS += $(srcdir)/test/graphics/blit.h
+TESTS += $(srcdir)/test/graphics/transparent_surface.h
+TESTS += $(srcdir)/test/graphics/yuv_to_rgb.h
+
+ifdef USE_TINYGL
+	TESTS += $(srcdir)/test/graphics/tinygl.h
+endif
+
+ifdef USE_SCALERS
+	TESTS += $(srcdir)/test/graphics/scaler.h
+endif
+
+ifdef HAS_MMAP
+	TESTS += $(srcdir)/test/backends/posix-mmapstream.h
+endif
+
+TEST_LIBS +=	video/libvideo.a image/libimage.a audio/libaudio.a graphics/libgraphics.a math/libmath.a common/libcommon.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
@@ -74,7 +95,7 @@ test/runner.cpp: $(TESTS)
 
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat
+	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/mmapstream.dat test/mmapstream-small.dat
 	-rmdir test/engine-data
 
 copy-dat:
@@ -0,0 +1,547 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/cpudetect.h"
+#include "common/math.h"
+#include "common/memstream.h"
+#include "common/random.h"
+#include "common/str.h"
+#include "common/system.h"
+#include "graphics/surface.h"
+#include "video/bink_decoder.h"
+
+#include "../null_osystem.h"
+
+/**
+ * Builds synthetic Bink videos which go through all block types, and checks
+ * the frames the decoder makes of them against hashes of known good frames.
+ *
+ * All bundles use the first Huffman tree, which codes raw nibbles, so the
+ * encoder only has to mirror the order in which the decoder reads the data.
+ */
+class BinkTestSuite : public CxxTest::TestSuite
+{
+	public:
+	/** Writes bits in the order the decoder reads them, the lowest bit of every byte first. */
+	struct BitWriter {
+		Common::Array<byte> data;
+		uint32 bits;
+
+		BitWriter() : bits(0) {}
+
+		void put(uint32 value, int n) {
+			for (int i = 0; i < n; i++, bits++) {
+				if (!(bits & 7))
+					data.push_back(0);
+				if ((value >> i) & 1)
+					data.back() |= 1 << (bits & 7);
+			}
+		}
+
+		void append(const BitWriter &other) {
+			for (uint32 i = 0; i < other.bits; i++)
+				put((other.data[i >> 3] >> (i & 7)) & 1, 1);
+		}
+
+		void align() {
+			while (bits & 31)
+				put(0, 1);
+		}
+	};
+
+	// The bundles, in the order the decoder reads them
+	enum {
+		kBlockTypes, kSubBlockTypes, kColors, kPattern, kXOff, kYOff, kIntraDC, kInterDC, kRun, kSourceCount
+	};
+
+	enum {
+		kBlockSkip, kBlockScaled, kBlockMotion, kBlockRun, kBlockResidue,
+		kBlockIntra, kBlockFill, kBlockInter, kBlockPattern, kBlockRaw
+	};
+
+	/** The bundle values a row of blocks uses, and the bits the blocks read themselves. */
+	struct Row {
+		Common::Array<int> values[kSourceCount];
+		BitWriter blockBits;
+	};
+
+	struct VideoParams {
+		uint32 id;
+		int width;
+		int height;
+		bool hasAlpha;
+		int frameCount;
+		uint32 seed;
+	};
+
+	static uint32 randomValue(Common::RandomSource &rnd, uint32 max) {
+		return max ? rnd.getRandomNumber(max) : 0;
+	}
+
+	static void encodeColors(Common::RandomSource &rnd, Row &row, int count) {
+		for (int i = 0; i < count; i++)
+			row.values[kColors].push_back(randomValue(rnd, 255));
+	}
+
+	static void encodeMotion(Common::RandomSource &rnd, Row &row, int blockX, int blockY, int blockWidth, int blockHeight) {
+		const int blocks[2] = { blockX, blockY };
+		const int sizes[2] = { blockWidth, blockHeight };
+		for (int i = 0; i < 2; i++) {
+			const int low = -MIN(15, blocks[i] * 8);
+			const int high = MIN(15, (sizes[i] - 1 - blocks[i]) * 8);
+			row.values[kXOff + i].push_back(low + (int)randomValue(rnd, high - low));
+		}
+	}
+
+	static void encodeRun(Common::RandomSource &rnd, Row &row) {
+		row.blockBits.put(randomValue(rnd, 15), 4);
+
+		int i = 0;
+		do {
+			const int run = 1 + randomValue(rnd, MIN(16, 64 - i) - 1);
+			i += run;
+			row.values[kRun].push_back(run - 1);
+
+			const bool fill = randomValue(rnd, 1);
+			row.blockBits.put(fill, 1);
+			encodeColors(rnd, row, fill ? 1 : run);
+		} while (i < 63);
+
+		if (i == 63)
+			encodeColors(rnd, row, 1);
+	}
+
+	static void encodeDCT(Common::RandomSource &rnd, Row &row, bool isIntra) {
+		if (isIntra)
+			row.values[kIntraDC].push_back(randomValue(rnd, 2047));
+		else
+			row.values[kInterDC].push_back((int)randomValue(rnd, 2046) - 1023);
+
+		// Code a few of the coefficients the list starts with
+		const int topBits = (int)randomValue(rnd, 3) - 1;
+		row.blockBits.put(topBits + 1, 4);
+
+		bool coded[3] = { false, false, false };
+		for (int bits = topBits; bits >= 0; bits--) {
+			row.blockBits.put(0, 3);
+
+			for (int i = 0; i < 3; i++) {
+				if (coded[i] || randomValue(rnd, 1)) {
+					if (!coded[i])
+						row.blockBits.put(0, 1);
+					continue;
+				}
+
+				row.blockBits.put(1, 1);
+				if (bits)
+					row.blockBits.put(randomValue(rnd, (1 << bits) - 1), bits);
+				row.blockBits.put(randomValue(rnd, 1), 1);
+				coded[i] = true;
+			}
+		}
+
+		row.blockBits.put(randomValue(rnd, 15), 4);
+	}
+
+	static void encodeResidue(Common::RandomSource &rnd, Row &row) {
+		row.blockBits.put(10, 7);
+		row.blockBits.put(0, 3);
+		row.blockBits.put(0, 3);
+
+		const bool coded = randomValue(rnd, 1);
+		row.blockBits.put(coded, 1);
+		if (coded) {
+			for (int i = 0; i < 4; i++) {
+				row.blockBits.put(0, 1);
+				row.blockBits.put(randomValue(rnd, 1), 1);
+			}
+		}
+	}
+
+	static void encodeScaled(Common::RandomSource &rnd, Row &row) {
+		static const int subTypes[5] = { kBlockRun, kBlockIntra, kBlockFill, kBlockPattern, kBlockRaw };
+		const int type = subTypes[randomValue(rnd, 4)];
+		row.values[kSubBlockTypes].push_back(type);
+
+		switch (type) {
+		case kBlockRun:
+			encodeRun(rnd, row);
+			break;
+		case kBlockIntra:
+			encodeDCT(rnd, row, true);
+			break;
+		case kBlockFill:
+			encodeColors(rnd, row, 1);
+			break;
+		case kBlockPattern:
+			encodeColors(rnd, row, 2);
+			for (int i = 0; i < 8; i++)
+				row.values[kPattern].push_back(randomValue(rnd, 255));
+			break;
+		default:
+			encodeColors(rnd, row, 64);
+			break;
+		}
+	}
+
+	static void putSigned(BitWriter &out, int value, int bits) {
+		out.put(ABS(value), bits);
+		if (value)
+			out.put(value < 0, 1);
+	}
+
+	static void putBundleValues(Common::RandomSource &rnd, BitWriter &out, int source, const Common::Array<int> &values) {
+		if (source == kIntraDC || source == kInterDC) {
+			if (source == kIntraDC)
+				out.put(values[0], 11);
+			else
+				putSigned(out, values[0], 10);
+
+			for (uint i = 1; i < values.size(); i += 8) {
+				const uint count = MIN<uint>(values.size() - i, 8);
+
+				int size = 0;
+				for (uint j = 0; j < count; j++) {
+					const int delta = ABS(values[i + j] - values[i + j - 1]);
+					size = MAX(size, delta ? Common::intLog2(delta) + 1 : 0);
+				}
+
+				out.put(size, 4);
+				if (size) {
+					for (uint j = 0; j < count; j++)
+						putSigned(out, values[i + j] - values[i + j - 1], size);
+				}
+			}
+			return;
+		}
+
+		if (source == kPattern) {
+			for (uint i = 0; i < values.size(); i++) {
+				out.put(values[i] & 0xF, 4);
+				out.put(values[i] >> 4, 4);
+			}
+			return;
+		}
+
+		bool same = true;
+		for (uint i = 1; i < values.size(); i++)
+			same = same && values[i] == values[0];
+		const bool fill = same && randomValue(rnd, 1);
+
+		out.put(fill, 1);
+		for (uint i = 0; i < (fill ? 1 : values.size()); i++) {
+			if (source == kColors) {
+				out.put(values[i] >> 4, 4);
+				out.put(values[i] & 0xF, 4);
+			} else if (source == kXOff || source == kYOff) {
+				putSigned(out, values[i], 4);
+			} else {
+				out.put(values[i], 4);
+			}
+		}
+	}
+
+	static void encodePlane(Common::RandomSource &rnd, BitWriter &out, const VideoParams &params, bool isChroma) {
+		const int blockWidth = isChroma ? (params.width + 15) >> 4 : (params.width + 7) >> 3;
+		const int blockHeight = isChroma ? (params.height + 15) >> 4 : (params.height + 7) >> 3;
+
+		Common::Array<Row> rows;
+		rows.resize(blockHeight);
+
+		Common::Array<bool> scaled;
+		scaled.resize(blockWidth);
+
+		for (int y = 0; y < blockHeight; y++) {
+			Row &row = rows[y];
+
+			for (int x = 0; x < blockWidth; x++) {
+				// The lower half of a 16x16 block only repeats its type
+				if (y & 1) {
+					if (scaled[x]) {
+						row.values[kBlockTypes].push_back(kBlockScaled);
+						scaled[x] = false;
+						x++;
+						continue;
+					}
+				}
+
+				int type;
+				do {
+					type = randomValue(rnd, 9);
+				} while (type == kBlockScaled && ((y & 1) || x + 1 >= blockWidth || y + 1 >= blockHeight));
+				row.values[kBlockTypes].push_back(type);
+
+				switch (type) {
+				case kBlockSkip:
+					break;
+				case kBlockScaled:
+					encodeScaled(rnd, row);
+					scaled[x] = true;
+					x++;
+					break;
+				case kBlockMotion:
+					encodeMotion(rnd, row, x, y, blockWidth, blockHeight);
+					break;
+				case kBlockRun:
+					encodeRun(rnd, row);
+					break;
+				case kBlockResidue:
+					encodeMotion(rnd, row, x, y, blockWidth, blockHeight);
+					encodeResidue(rnd, row);
+					break;
+				case kBlockIntra:
+					encodeDCT(rnd, row, true);
+					break;
+				case kBlockFill:
+					encodeColors(rnd, row, 1);
+					break;
+				case kBlockInter:
+					encodeMotion(rnd, row, x, y, blockWidth, blockHeight);
+					encodeDCT(rnd, row, false);
+					break;
+				case kBlockPattern:
+					encodeColors(rnd, row, 2);
+					for (int i = 0; i < 8; i++)
+						row.values[kPattern].push_back(randomValue(rnd, 255));
+					break;
+				default:
+					encodeColors(rnd, row, 64);
+					break;
+				}
+			}
+		}
+
+		// Lengths of the value counts, as the decoder computes them
+		const int countWidth = MAX(isChroma ? params.width >> 1 : params.width, 8);
+		const int colorBlocks = isChroma ? (params.width + 15) >> 4 : (params.width + 7) >> 3;
+		int countLengths[kSourceCount];
+		countLengths[kBlockTypes] = Common::intLog2((countWidth >> 3) + 511) + 1;
+		countLengths[kSubBlockTypes] = Common::intLog2(((countWidth + 7) >> 4) + 511) + 1;
+		countLengths[kColors] = Common::intLog2(colorBlocks * 64 + 511) + 1;
+		countLengths[kPattern] = Common::intLog2((colorBlocks << 3) + 511) + 1;
+		countLengths[kXOff] = countLengths[kYOff] = countLengths[kBlockTypes];
+		countLengths[kIntraDC] = countLengths[kInterDC] = countLengths[kBlockTypes];
+		countLengths[kRun] = Common::intLog2(colorBlocks * 48 + 511) + 1;
+
+		// The Huffman trees of the bundles, all raw nibbles
+		for (int i = 0; i < kSourceCount; i++) {
+			if (i == kColors)
+				out.put(0, 16 * 4);
+			if (i != kIntraDC && i != kInterDC)
+				out.put(0, 4);
+		}
+
+		// A bundle reads new values when the ones it read before are used up,
+		// so rows which don't use it get the values of the next row which does
+		uint decoded[kSourceCount] = { 0 };
+		uint used[kSourceCount] = { 0 };
+		bool ended[kSourceCount] = { false };
+		for (int y = 0; y < blockHeight; y++) {
+			for (int source = 0; source < kSourceCount; source++) {
+				if (!ended[source] && decoded[source] == used[source]) {
+					int next = y;
+					while (next < blockHeight && rows[next].values[source].empty())
+						next++;
+
+					const uint count = next < blockHeight ? rows[next].values[source].size() : 0;
+					TS_ASSERT_LESS_THAN(count, 1U << countLengths[source]);
+					out.put(count, countLengths[source]);
+
+					if (count)
+						putBundleValues(rnd, out, source, rows[next].values[source]);
+					else
+						ended[source] = true;
+					decoded[source] += count;
+				}
+
+				used[source] += rows[y].values[source].size();
+			}
+
+			out.append(rows[y].blockBits);
+		}
+
+		out.align();
+	}
+
+	static void putUint32LE(Common::Array<byte> &data, uint32 offset, uint32 value) {
+		if (data.size() < offset + 4)
+			data.resize(offset + 4);
+		WRITE_LE_UINT32(&data[offset], value);
+	}
+
+	/**
+	 * Build a video with a single video track. The BIKi chroma offset of
+	 * the given frame points at garbage after the chroma planes.
+	 */
+	static Common::SeekableReadStream *createVideo(const VideoParams &params, int badChromaOffsetFrame = -1) {
+		Common::RandomSource rnd("bink");
+		rnd.setSeed(params.seed);
+
+		const uint32 headerSize = 44 + 4 * params.frameCount;
+		Common::Array<byte> file;
+		file.resize(headerSize);
+
+		uint32 largestFrame = 0;
+		for (int frame = 0; frame < params.frameCount; frame++) {
+			BitWriter packet;
+
+			// BIKi videos start the sections of the packet with their size
+			if (params.hasAlpha) {
+				BitWriter alpha;
+				encodePlane(rnd, alpha, params, false);
+				if (params.id == MKTAG('B', 'I', 'K', 'i'))
+					packet.put(4 + alpha.bits / 8, 32);
+				packet.append(alpha);
+			}
+
+			BitWriter luma, chroma;
+			encodePlane(rnd, luma, params, false);
+			encodePlane(rnd, chroma, params, true);
+			encodePlane(rnd, chroma, params, true);
+
+			const bool badChromaOffset = frame == badChromaOffsetFrame;
+			if (params.id == MKTAG('B', 'I', 'K', 'i'))
+				packet.put(packet.bits / 8 + 4 + luma.bits / 8 + (badChromaOffset ? chroma.bits / 8 : 0), 32);
+			packet.append(luma);
+			packet.append(chroma);
+			if (badChromaOffset)
+				packet.put(0xFFFFFFFF, 32);
+
+			putUint32LE(file, 44 + 4 * frame, file.size() | (frame == 0 ? 1 : 0));
+			for (uint i = 0; i < packet.data.size(); i++)
+				file.push_back(packet.data[i]);
+			largestFrame = MAX<uint32>(largestFrame, packet.data.size());
+		}
+
+		WRITE_BE_UINT32(&file[0], params.id);
+		putUint32LE(file, 4, file.size() - 8);
+		putUint32LE(file, 8, params.frameCount);
+		putUint32LE(file, 12, largestFrame);
+		putUint32LE(file, 16, 0);
+		putUint32LE(file, 20, params.width);
+		putUint32LE(file, 24, params.height);
+		putUint32LE(file, 28, 25);
+		putUint32LE(file, 32, 1);
+		putUint32LE(file, 36, params.hasAlpha ? 0x00100000 : 0);
+		putUint32LE(file, 40, 0);
+
+		byte *data = (byte *)malloc(file.size());
+		memcpy(data, &file[0], file.size());
+		return new Common::MemoryReadStream(data, file.size(), DisposeAfterUse::YES);
+	}
+
+	static uint32 hashSurface(const Graphics::Surface &surface) {
+		uint32 hash = 2166136261U;
+		for (int y = 0; y < surface.h; y++) {
+			const byte *row = (const byte *)surface.getBasePtr(0, y);
+			for (int x = 0; x < surface.w * surface.format.bytesPerPixel; x++)
+				hash = (hash ^ row[x]) * 16777619U;
+		}
+		return hash;
+	}
+
+	static void decodeHashes(const VideoParams &params, Common::Array<uint32> &hashes, int badChromaOffsetFrame = -1) {
+		Video::BinkDecoder decoder;
+		decoder.setDefaultHighColorFormat(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		TS_ASSERT(decoder.loadStream(createVideo(params, badChromaOffsetFrame)));
+		decoder.start();
+
+		hashes.clear();
+		for (int i = 0; i < params.frameCount; i++) {
+			const Graphics::Surface *frame = decoder.decodeNextFrame();
+			TS_ASSERT(frame);
+			if (frame)
+				hashes.push_back(hashSurface(*frame));
+		}
+	}
+
+	void test_frames_match_reference() {
+#if defined(USE_BINK) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// BIKi videos go through decoding the chroma planes at the same
+		// time as the luma plane, from the second frame on
+		static const VideoParams videos[] = {
+			{ MKTAG('B', 'I', 'K', 'i'), 70, 38, false, 5, 1 },
+			{ MKTAG('B', 'I', 'K', 'i'), 48, 32, true,  4, 2 },
+			{ MKTAG('B', 'I', 'K', 'f'), 56, 24, false, 4, 3 },
+			{ MKTAG('B', 'I', 'K', 'h'), 40, 48, true,  3, 4 }
+		};
+
+		// Frames of the videos, as decoded before the decoder used SIMD or threads
+		static const uint32 reference[][5] = {
+			{ 0x1BA03630, 0x0E9E945E, 0x9743EAD4, 0x3E29D956, 0x07BDD710 },
+			{ 0x1CB7975E, 0x2F150CCB, 0x26048137, 0xA247E8B5 },
+			{ 0x9E0E7A50, 0x8CCCAFA3, 0xE29E6B0A, 0x09407AAF },
+			{ 0x59306FBF, 0x814FCD63, 0xCDC63F9C }
+		};
+
+		for (int i = 0; i < ARRAYSIZE(videos); i++) {
+			const uint32 features[] = { 0, Common::kCpuFeatureSSE2, Common::kCpuFeatureAll };
+			for (int j = 0; j < ARRAYSIZE(features); j++) {
+				Common::setCpuFeatureMask(features[j]);
+
+				Common::Array<uint32> hashes;
+				decodeHashes(videos[i], hashes);
+
+				TS_ASSERT_EQUALS(hashes.size(), (uint)videos[i].frameCount);
+				for (uint k = 0; k < hashes.size(); k++) {
+					if (hashes[k] != reference[i][k])
+						TS_TRACE(Common::String::format("Video %d, frame %d, CPU features %x", i, k, features[j]).c_str());
+					TS_ASSERT_EQUALS(hashes[k], reference[i][k]);
+				}
+			}
+		}
+
+		Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+#endif
+	}
+
+	// A chroma offset which turns out wrong is not fatal, the chroma planes
+	// are decoded again after the luma plane
+	void test_bad_chroma_offset() {
+#if defined(USE_BINK) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const VideoParams video = { MKTAG('B', 'I', 'K', 'i'), 70, 38, false, 5, 1 };
+		static const uint32 reference[] = { 0x1BA03630, 0x0E9E945E, 0x9743EAD4, 0x3E29D956, 0x07BDD710 };
+
+		Common::Array<uint32> hashes;
+		decodeHashes(video, hashes, 2);
+
+		TS_ASSERT_EQUALS(hashes.size(), (uint)video.frameCount);
+		for (uint i = 0; i < hashes.size(); i++)
+			TS_ASSERT_EQUALS(hashes[i], reference[i]);
+#endif
+	}
+
+	// Reports how many frames of a 640x480 video are decoded per second
+	void test_benchmark() {
+#if defined(USE_BINK) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const VideoParams video = { MKTAG('B', 'I', 'K', 'i'), 640, 480, false, 12, 5 };
+
+		uint32 times[2];
+		for (int simd = 0; simd < 2; simd++) {
+			Common::setCpuFeatureMask(simd ? Common::kCpuFeatureAll : 0);
+
+			Video::BinkDecoder decoder;
+			decoder.setDefaultHighColorFormat(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+			TS_ASSERT(decoder.loadStream(createVideo(video)));
+			decoder.start();
+
+			const uint32 start = g_system->getMillis();
+			for (int i = 0; i < video.frameCount; i++)
+				decoder.decodeNextFrame();
+			times[simd] = MAX<uint32>(g_system->getMillis() - start, 1);
+		}
+
+		TS_TRACE(Common::String::format("%u fps generic, %u fps SIMD, %u threads",
+		                                video.frameCount * 1000 / times[0], video.frameCount * 1000 / times[1],
+		                                MIN<uint>(g_system->getCpuCount(), 2)).c_str());
+
+		Common::setCpuFeatureMask(Common::kCpuFeatureAll);
+#endif
+	}
+};
@@ -0,0 +1,174 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/str.h"
+#include "common/system.h"
+#include "graphics/surface.h"
+#include "video/video_decoder.h"
+
+#include "../null_osystem.h"
+
+/**
+ * A video of 8x8 frames filled with their frame number, which takes the
+ * given time in ms to decode each frame.
+ */
+class TestVideoDecoder : public Video::VideoDecoder {
+public:
+	bool loadStream(Common::SeekableReadStream *stream) { return false; }
+
+	void load(int frameCount, const uint *costs, uint costCount) {
+		close();
+		addTrack(new TestVideoTrack(frameCount, costs, costCount));
+		findNextVideoTrack();
+	}
+
+private:
+	class TestVideoTrack : public FixedRateVideoTrack {
+	public:
+		TestVideoTrack(int frameCount, const uint *costs, uint costCount) :
+				_curFrame(-1), _frameCount(frameCount), _costs(costs), _costCount(costCount) {
+			_surface.create(8, 8, Graphics::PixelFormat::createFormatCLUT8());
+		}
+
+		~TestVideoTrack() { _surface.free(); }
+
+		uint16 getWidth() const { return _surface.w; }
+		uint16 getHeight() const { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const { return _surface.format; }
+		int getCurFrame() const { return _curFrame; }
+		int getFrameCount() const { return _frameCount; }
+
+		bool isSeekable() const { return true; }
+		bool seek(const Audio::Timestamp &time) {
+			_curFrame = getFrameAtTime(time) - 1;
+			return true;
+		}
+
+		const Graphics::Surface *decodeNextFrame() {
+			_curFrame++;
+			if (_costCount)
+				g_system->delayMillis(_costs[_curFrame % _costCount]);
+			memset(_surface.getPixels(), _curFrame, _surface.w * _surface.h);
+			return &_surface;
+		}
+
+	protected:
+		Common::Rational getFrameRate() const { return 50; }
+
+	private:
+		int _curFrame;
+		int _frameCount;
+		const uint *_costs;
+		uint _costCount;
+		Graphics::Surface _surface;
+	};
+};
+
+class VideoDecoderTestSuite : public CxxTest::TestSuite {
+public:
+	struct ReplayStats {
+		uint frames;
+		uint droppedFrames;
+		uint32 decodeTimes[4]; // Median, 90th and 99th percentile, maximum
+	};
+
+	/**
+	 * Play a video in real time like an engine would, without showing it.
+	 * A frame counts as dropped when the next one is due as soon as it was
+	 * decoded, so it would not have been on the screen.
+	 */
+	static ReplayStats replay(Video::VideoDecoder &decoder) {
+		Common::Array<uint32> decodeTimes;
+		ReplayStats stats;
+		stats.droppedFrames = 0;
+
+		decoder.start();
+		while (!decoder.endOfVideo()) {
+			if (decoder.needsUpdate()) {
+				const uint32 start = g_system->getMillis();
+				decoder.decodeNextFrame();
+				decodeTimes.push_back(g_system->getMillis() - start);
+
+				if (decoder.needsUpdate())
+					stats.droppedFrames++;
+			}
+
+			g_system->delayMillis(1);
+		}
+		decoder.stop();
+
+		stats.frames = decodeTimes.size();
+		Common::sort(decodeTimes.begin(), decodeTimes.end());
+		const uint percentiles[] = { 50, 90, 99, 100 };
+		for (int i = 0; i < 4; i++)
+			stats.decodeTimes[i] = decodeTimes.empty() ? 0 : decodeTimes[(decodeTimes.size() - 1) * percentiles[i] / 100];
+
+		return stats;
+	}
+
+	void test_decode_ahead() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		TestVideoDecoder decoder;
+		decoder.setDecodeAhead(3);
+		decoder.load(20, nullptr, 0);
+
+		for (int i = 0; i < 10; i++) {
+			const Graphics::Surface *frame = decoder.decodeNextFrame();
+			TS_ASSERT(frame);
+			TS_ASSERT_EQUALS(*(const byte *)frame->getPixels(), i);
+			TS_ASSERT_EQUALS(decoder.getCurFrame(), i);
+			TS_ASSERT(!decoder.endOfVideo());
+		}
+
+		// Seeking drops the frames decoded ahead
+		TS_ASSERT(decoder.seekToFrame(15));
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 14);
+		TS_ASSERT_EQUALS(*(const byte *)decoder.decodeNextFrame()->getPixels(), 15);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 15);
+
+		TS_ASSERT(decoder.rewind());
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), -1);
+
+		int frames = 0;
+		while (!decoder.endOfVideo()) {
+			const Graphics::Surface *frame = decoder.decodeNextFrame();
+			TS_ASSERT(frame);
+			TS_ASSERT_EQUALS(*(const byte *)frame->getPixels(), frames);
+			frames++;
+		}
+		TS_ASSERT_EQUALS(frames, 20);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 19);
+
+		TS_ASSERT(!decoder.setReverse(true));
+		decoder.close();
+#endif
+	}
+
+	// Plays 50 fps videos where every 8th frame takes longer to decode
+	// than it may be shown, reporting decode times and dropped frames
+	void test_replay() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const uint costs[] = { 8, 8, 8, 8, 8, 8, 8, 40 };
+		const int kFrames = 64;
+
+		for (uint ahead = 0; ahead <= 4; ahead += 4) {
+			TestVideoDecoder decoder;
+			decoder.setDecodeAhead(ahead);
+			decoder.load(kFrames, costs, ARRAYSIZE(costs));
+
+			const ReplayStats stats = replay(decoder);
+			TS_ASSERT_EQUALS(stats.frames, (uint)kFrames);
+			TS_TRACE(Common::String::format("%u frames ahead: %u of %u frames dropped, decode time median %u ms, 90%% %u ms, 99%% %u ms, max %u ms",
+			                                ahead, stats.droppedFrames, stats.frames,
+			                                stats.decodeTimes[0], stats.decodeTimes[1], stats.decodeTimes[2], stats.decodeTimes[3]).c_str());
+
+			decoder.close();
+		}
+#endif
+	}
+};
@@ -0,0 +1,97 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "video/bink_simd.h"
+
+#include <immintrin.h>
+
+namespace {
+
+struct AVX2Ops {
+	typedef __m256i V;
+
+	/** The low bytes of the lanes, in the low 8 bytes. */
+	static FORCEINLINE __m128i lowBytes(V v) {
+		const V masked = _mm256_and_si256(v, _mm256_set1_epi32(0xFF));
+		const __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(masked), _mm256_extracti128_si256(masked, 1));
+		return _mm_packus_epi16(words, words);
+	}
+
+	static FORCEINLINE V load(const int32 *p) { return _mm256_loadu_si256((const __m256i *)p); }
+	static FORCEINLINE V set1(int x) { return _mm256_set1_epi32(x); }
+	static FORCEINLINE V add(V a, V b) { return _mm256_add_epi32(a, b); }
+	static FORCEINLINE V sub(V a, V b) { return _mm256_sub_epi32(a, b); }
+	static FORCEINLINE V mullo(V a, V b) { return _mm256_mullo_epi32(a, b); }
+	static FORCEINLINE V srai(V a, int n) { return _mm256_srai_epi32(a, n); }
+
+	static FORCEINLINE void transpose(V *rows) {
+		V t[8], u[8];
+		for (int i = 0; i < 8; i += 2) {
+			t[i] = _mm256_unpacklo_epi32(rows[i], rows[i + 1]);
+			t[i + 1] = _mm256_unpackhi_epi32(rows[i], rows[i + 1]);
+		}
+		for (int i = 0; i < 8; i += 4) {
+			u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+			u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+			u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+			u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+		}
+		for (int i = 0; i < 4; i++) {
+			rows[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+			rows[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+		}
+	}
+
+	static FORCEINLINE void storeBytes(byte *p, V v) {
+		_mm_storel_epi64((__m128i *)p, lowBytes(v));
+	}
+
+	static FORCEINLINE void addBytes(byte *p, V v) {
+		_mm_storel_epi64((__m128i *)p, _mm_add_epi8(_mm_loadl_epi64((const __m128i *)p), lowBytes(v)));
+	}
+
+	static FORCEINLINE void storeBytesScaled(byte *p, uint32 pitch, V v) {
+		const __m128i bytes = lowBytes(v);
+		const __m128i doubled = _mm_unpacklo_epi8(bytes, bytes);
+		_mm_storeu_si128((__m128i *)p, doubled);
+		_mm_storeu_si128((__m128i *)(p + pitch), doubled);
+	}
+
+	static FORCEINLINE void scaleBytes(byte *p, uint32 pitch, const byte *src) {
+		const __m128i bytes = _mm_loadl_epi64((const __m128i *)src);
+		const __m128i doubled = _mm_unpacklo_epi8(bytes, bytes);
+		_mm_storeu_si128((__m128i *)p, doubled);
+		_mm_storeu_si128((__m128i *)(p + pitch), doubled);
+	}
+};
+
+} // End of anonymous namespace
+
+#include "video/bink_simd_impl.h"
+
+namespace Video {
+
+void getBinkSIMDProcsAVX2(BinkSIMDProcs &procs) {
+	BinkKernels<AVX2Ops>::getProcs(procs);
+}
+
+} // End of namespace Video
@@ -38,7 +38,9 @@
 #include "common/huffman.h"
 #include "common/rdft.h"
 #include "common/dct.h"
+#include "common/cpudetect.h"
 #include "common/system.h"
+#include "common/workerpool.h"
 
 #include "graphics/yuv_to_rgb.h"
 #include "graphics/surface.h"
@@ -136,6 +138,7 @@ bool BinkDecoder::loadStream(Common::SeekableReadStream *stream) {
 		if (i != 0)
 			_frames[i - 1].size = _frames[i].offset - _frames[i - 1].offset;
 
+		_frames[i].data = 0;
 		_frames[i].bits = 0;
 	}
 
@@ -200,16 +203,21 @@ void BinkDecoder::readNextPacket() {
 		}
 	}
 
-	uint32 videoPacketStart = _bink->pos();
-	uint32 videoPacketEnd   = _bink->pos() + frameSize;
+	// The packet is read into memory, so that the planes can be read
+	// straight out of it, and at the same time
+	byte *videoData = (byte *)malloc(frameSize);
+	if (_bink->read(videoData, frameSize) != frameSize)
+		error("Bink video packet went out of bounds");
 
-	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-			videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
+	frame.data = new Common::BitStreamMemoryStream(videoData, frameSize, DisposeAfterUse::YES);
+	frame.bits = new Common::BitStreamMemory32LELSB(frame.data);
 
 	videoTrack->decodePacket(frame);
 
 	delete frame.bits;
 	frame.bits = 0;
+	delete frame.data;
+	frame.data = 0;
 }
 
 VideoDecoder::AudioTrack *BinkDecoder::getAudioTrack(int index) {
@@ -222,11 +230,12 @@ VideoDecoder::AudioTrack *BinkDecoder::getAudioTrack(int index) {
 	return (AudioTrack *)track;
 }
 
-BinkDecoder::VideoFrame::VideoFrame() : bits(0) {
+BinkDecoder::VideoFrame::VideoFrame() : data(0), bits(0) {
 }
 
 BinkDecoder::VideoFrame::~VideoFrame() {
 	delete bits;
+	delete data;
 }
 
 
@@ -242,6 +251,30 @@ BinkDecoder::AudioInfo::~AudioInfo() {
 	delete dct;
 }
 
+/** Get the SIMD block functions for the CPU. */
+static void getSIMDProcs(BinkSIMDProcs &procs) {
+	memset(&procs, 0, sizeof(procs));
+
+#ifdef SCUMMVM_AVX2
+	if (Common::hasCpuFeature(Common::kCpuFeatureAVX2)) {
+		getBinkSIMDProcsAVX2(procs);
+		return;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (Common::hasCpuFeature(Common::kCpuFeatureSSE2)) {
+		getBinkSIMDProcsSSE2(procs);
+		return;
+	}
+#endif
+#ifdef SCUMMVM_NEON
+	if (Common::hasCpuFeature(Common::kCpuFeatureNEON)) {
+		getBinkSIMDProcsNEON(procs);
+		return;
+	}
+#endif
+}
+
 BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const Graphics::PixelFormat &format, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id) :
 		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id) {
 	_curFrame = -1;
@@ -249,25 +282,40 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 	for (int i = 0; i < 16; i++)
 		_huffman[i] = 0;
 
-	for (int i = 0; i < kSourceMAX; i++) {
-		_bundles[i].countLength = 0;
+	for (int p = 0; p < 2; p++) {
+		PlaneContext &plane = _planeContexts[p];
 
-		_bundles[i].huffman.index = 0;
-		for (int j = 0; j < 16; j++)
-			_bundles[i].huffman.symbols[j] = j;
+		plane.bits = 0;
+		plane.speculative = false;
+		plane.failed = false;
 
-		_bundles[i].data     = 0;
-		_bundles[i].dataEnd  = 0;
-		_bundles[i].curDec   = 0;
-		_bundles[i].curPtr   = 0;
-	}
+		for (int i = 0; i < kSourceMAX; i++) {
+			plane.bundles[i].countLength = 0;
 
-	for (int i = 0; i < 16; i++) {
-		_colHighHuffman[i].index = 0;
-		for (int j = 0; j < 16; j++)
-			_colHighHuffman[i].symbols[j] = j;
+			plane.bundles[i].huffman.index = 0;
+			for (int j = 0; j < 16; j++)
+				plane.bundles[i].huffman.symbols[j] = j;
+
+			plane.bundles[i].data     = 0;
+			plane.bundles[i].dataEnd  = 0;
+			plane.bundles[i].curDec   = 0;
+			plane.bundles[i].curPtr   = 0;
+		}
+
+		for (int i = 0; i < 16; i++) {
+			plane.colHighHuffman[i].index = 0;
+			for (int j = 0; j < 16; j++)
+				plane.colHighHuffman[i].symbols[j] = j;
+		}
+
+		plane.colLastVal = 0;
 	}
 
+	_chromaOffset = kChromaOffsetUnknown;
+	_workerPool = new Common::WorkerPool(MIN<uint>(g_system->getCpuCount(), 2));
+
+	getSIMDProcs(_simd);
+
 	// Make the surface even-sized:
 	_surfaceHeight = height;
 	_surfaceWidth = width;
@@ -312,7 +360,10 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 	memset(_oldPlanes[2],   0, _uvBlockWidth * 8 * _uvBlockHeight * 8);
 	memset(_oldPlanes[3], 255, _yBlockWidth  * 8 * _yBlockHeight  * 8);
 
-	initBundles();
+	// The luma context decodes all planes when they are decoded one after
+	// another, the chroma context only decodes the chroma planes
+	initBundles(_planeContexts[0], _yBlockWidth * _yBlockHeight);
+	initBundles(_planeContexts[1], _uvBlockWidth * _uvBlockHeight);
 	initHuffman();
 }
 
@@ -322,7 +373,10 @@ BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
 		delete[] _oldPlanes[i]; _oldPlanes[i] = 0;
 	}
 
-	deinitBundles();
+	delete _workerPool;
+
+	deinitBundles(_planeContexts[0]);
+	deinitBundles(_planeContexts[1]);
 
 	for (int i = 0; i < 16; i++) {
 		delete _huffman[i];
@@ -473,25 +527,65 @@ bool BinkDecoder::BinkVideoTrack::rewind() {
 void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	assert(frame.bits);
 
+	PlaneContext &luma = _planeContexts[0];
+	luma.bits = frame.bits;
+
 	if (_hasAlpha) {
 		if (_id == kBIKiID)
 			frame.bits->skip(32);
 
-		decodePlane(frame, 3, false);
+		decodePlane(luma, 3, false);
 	}
 
+	uint32 chromaOffset = 0;
 	if (_id == kBIKiID)
-		frame.bits->skip(32);
-
-	for (int i = 0; i < 3; i++) {
-		int planeIdx = ((i == 0) || !_swapPlanes) ? i : (i ^ 3);
-
-		decodePlane(frame, planeIdx, i != 0);
-
-		if (frame.bits->pos() >= frame.bits->size())
-			break;
+		chromaOffset = frame.bits->getBits(32);
+
+	// BIKi stores the offset of the chroma planes before the luma plane.
+	// Once it matched where the luma plane actually ended, the chroma
+	// planes are decoded from there, at the same time as the luma plane.
+	const uint32 offsetEnd = frame.bits->pos() / 8;
+	const uint32 chromaStart = chromaOffset + (_chromaOffset == kChromaOffsetRelative ? offsetEnd : 0);
+	bool chromaDecoded = false;
+
+	if ((_chromaOffset == kChromaOffsetAbsolute || _chromaOffset == kChromaOffsetRelative) &&
+	    chromaStart > offsetEnd && chromaStart < (uint32)frame.data->size() && !(chromaStart & 3)) {
+		Common::BitStreamMemoryStream chromaData(frame.data->getData() + chromaStart, frame.data->size() - chromaStart);
+		Common::BitStreamMemory32LELSB chromaBits(chromaData);
+		_planeContexts[1].bits = &chromaBits;
+
+		// The offset is only known to be right once the luma plane ended
+		// there, so bad chroma data is not fatal before that
+		_planeContexts[1].speculative = true;
+		_planeContexts[1].failed = false;
+
+		_workerPool->run(decodePlanesJob, this, 2);
+
+		_planeContexts[1].bits = 0;
+		_planeContexts[1].speculative = false;
+
+		chromaDecoded = !_planeContexts[1].failed && frame.bits->pos() / 8 == chromaStart;
+		if (!chromaDecoded) {
+			warning("Bink chroma planes don't start at their offset, decoding the planes one after another");
+			_chromaOffset = kChromaOffsetInvalid;
+		}
+	} else {
+		decodePlane(luma, 0, false);
+
+		if (_id == kBIKiID && _chromaOffset == kChromaOffsetUnknown) {
+			const uint32 lumaEnd = frame.bits->pos() / 8;
+			if (lumaEnd == chromaOffset)
+				_chromaOffset = kChromaOffsetAbsolute;
+			else if (lumaEnd == offsetEnd + chromaOffset)
+				_chromaOffset = kChromaOffsetRelative;
+			else
+				_chromaOffset = kChromaOffsetInvalid;
+		}
 	}
 
+	if (!chromaDecoded && frame.bits->pos() < frame.bits->size())
+		decodeChromaPlanes(luma);
+
 	// Convert the YUV data we have to our format
 	// The width used here is the surface-width, and not the video-width
 	// to allow for odd-sized videos.
@@ -512,7 +606,27 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	_curFrame++;
 }
 
-void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
+void BinkDecoder::BinkVideoTrack::decodePlanesJob(void *param, uint job) {
+	BinkVideoTrack *track = (BinkVideoTrack *)param;
+
+	if (job == 0)
+		track->decodePlane(track->_planeContexts[0], 0, false);
+	else
+		track->decodeChromaPlanes(track->_planeContexts[1]);
+}
+
+void BinkDecoder::BinkVideoTrack::decodeChromaPlanes(PlaneContext &plane) {
+	for (int i = 1; i < 3; i++) {
+		int planeIdx = _swapPlanes ? (i ^ 3) : i;
+
+		decodePlane(plane, planeIdx, true);
+
+		if (plane.failed || plane.bits->pos() >= plane.bits->size())
+			break;
+	}
+}
+
+void BinkDecoder::BinkVideoTrack::decodePlane(PlaneContext &plane, int planeIdx, bool isChroma) {
 	uint32 blockWidth  = isChroma ? _uvBlockWidth  : _yBlockWidth;
 	uint32 blockHeight = isChroma ? _uvBlockHeight : _yBlockHeight;
 	uint32 width       = blockWidth  * 8;
@@ -520,7 +634,7 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 
 	DecodeContext ctx;
 
-	ctx.video     = &video;
+	ctx.plane     = &plane;
 	ctx.planeIdx  = planeIdx;
 	ctx.destStart = _curPlanes[planeIdx];
 	ctx.destEnd   = _curPlanes[planeIdx] + width * height;
@@ -538,27 +652,33 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 	}
 
 	for (int i = 0; i < kSourceMAX; i++) {
-		_bundles[i].countLength = _bundles[i].countLengths[isChroma ? 1 : 0];
+		plane.bundles[i].countLength = plane.bundles[i].countLengths[isChroma ? 1 : 0];
 
-		readBundle(video, (Source) i);
+		readBundle(plane, (Source) i);
 	}
 
+	if (plane.failed)
+		return;
+
 	for (ctx.blockY = 0; ctx.blockY < blockHeight; ctx.blockY++) {
-		readBlockTypes  (video, _bundles[kSourceBlockTypes]);
-		readBlockTypes  (video, _bundles[kSourceSubBlockTypes]);
-		readColors      (video, _bundles[kSourceColors]);
-		readPatterns    (video, _bundles[kSourcePattern]);
-		readMotionValues(video, _bundles[kSourceXOff]);
-		readMotionValues(video, _bundles[kSourceYOff]);
-		readDCS         (video, _bundles[kSourceIntraDC], kDCStartBits, false);
-		readDCS         (video, _bundles[kSourceInterDC], kDCStartBits, true);
-		readRuns        (video, _bundles[kSourceRun]);
+		readBlockTypes  (plane, plane.bundles[kSourceBlockTypes]);
+		readBlockTypes  (plane, plane.bundles[kSourceSubBlockTypes]);
+		readColors      (plane, plane.bundles[kSourceColors]);
+		readPatterns    (plane, plane.bundles[kSourcePattern]);
+		readMotionValues(plane, plane.bundles[kSourceXOff]);
+		readMotionValues(plane, plane.bundles[kSourceYOff]);
+		readDCS         (plane, plane.bundles[kSourceIntraDC], kDCStartBits, false);
+		readDCS         (plane, plane.bundles[kSourceInterDC], kDCStartBits, true);
+		readRuns        (plane, plane.bundles[kSourceRun]);
+
+		if (plane.failed)
+			return;
 
 		ctx.dest = ctx.destStart + 8 * ctx.blockY * ctx.pitch;
 		ctx.prev = ctx.prevStart + 8 * ctx.blockY * ctx.pitch;
 
 		for (ctx.blockX = 0; ctx.blockX < blockWidth; ctx.blockX++, ctx.dest += 8, ctx.prev += 8) {
-			BlockType blockType = (BlockType) getBundleValue(kSourceBlockTypes);
+			BlockType blockType = (BlockType) getBundleValue(plane, kSourceBlockTypes);
 
 			// 16x16 block type on odd line means part of the already decoded block, so skip it
 			if ((ctx.blockY & 1) && (blockType == kBlockScaled)) {
@@ -573,6 +693,9 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 				blockSkip(ctx);
 				break;
 			case kBlockScaled:
+				// A 16x16 block can't start in the last row or column
+				if (((ctx.blockX + 1 >= blockWidth) || (ctx.blockY + 1 >= blockHeight)) && failPlane(plane))
+					return;
 				blockScaled(ctx);
 				break;
 			case kBlockMotion:
@@ -600,35 +723,48 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 				blockRaw(ctx);
 				break;
 			default:
+				if (failPlane(plane))
+					return;
 				error("Unknown block type: %d", blockType);
 			}
 
+			if (plane.failed)
+				return;
+
 		}
 
 	}
 
-	if (video.bits->pos() & 0x1F) // next plane data starts at 32-bit boundary
-		video.bits->skip(32 - (video.bits->pos() & 0x1F));
+	if (plane.bits->pos() & 0x1F) // next plane data starts at 32-bit boundary
+		plane.bits->skip(32 - (plane.bits->pos() & 0x1F));
 
 }
 
-void BinkDecoder::BinkVideoTrack::readBundle(VideoFrame &video, Source source) {
+bool BinkDecoder::BinkVideoTrack::failPlane(PlaneContext &plane) {
+	if (!plane.speculative)
+		return false;
+
+	plane.failed = true;
+	return true;
+}
+
+void BinkDecoder::BinkVideoTrack::readBundle(PlaneContext &plane, Source source) {
 	if (source == kSourceColors) {
 		for (int i = 0; i < 16; i++)
-			readHuffman(video, _colHighHuffman[i]);
+			readHuffman(plane, plane.colHighHuffman[i]);
 
-		_colLastVal = 0;
+		plane.colLastVal = 0;
 	}
 
 	if ((source != kSourceIntraDC) && (source != kSourceInterDC))
-		readHuffman(video, _bundles[source].huffman);
+		readHuffman(plane, plane.bundles[source].huffman);
 
-	_bundles[source].curDec = _bundles[source].data;
-	_bundles[source].curPtr = _bundles[source].data;
+	plane.bundles[source].curDec = plane.bundles[source].data;
+	plane.bundles[source].curPtr = plane.bundles[source].data;
 }
 
-void BinkDecoder::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffman) {
-	huffman.index = video.bits->getBits(4);
+void BinkDecoder::BinkVideoTrack::readHuffman(PlaneContext &plane, Huffman &huffman) {
+	huffman.index = plane.bits->getBits(4);
 
 	if (huffman.index == 0) {
 		// The first tree always gives raw nibbles
@@ -640,13 +776,19 @@ void BinkDecoder::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffma
 
 	byte hasSymbol[16];
 
-	if (video.bits->getBit()) {
+	if (plane.bits->getBit()) {
 		// Symbol selection
 		memset(hasSymbol, 0, 16);
 
-		uint8 length = video.bits->getBits(3);
+		uint8 length = plane.bits->getBits(3);
 		for (int i = 0; i <= length; i++) {
-			huffman.symbols[i] = video.bits->getBits(4);
+			huffman.symbols[i] = plane.bits->getBits(4);
+			if (hasSymbol[huffman.symbols[i]]) {
+				if (failPlane(plane))
+					return;
+				error("Duplicate Huffman symbol %d", huffman.symbols[i]);
+			}
+
 			hasSymbol[huffman.symbols[i]] = 1;
 		}
 
@@ -662,7 +804,7 @@ void BinkDecoder::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffma
 	byte tmp1[16], tmp2[16];
 	byte *in = tmp1, *out = tmp2;
 
-	uint8 depth = video.bits->getBits(2);
+	uint8 depth = plane.bits->getBits(2);
 
 	for (int i = 0; i < 16; i++)
 		in[i] = i;
@@ -671,7 +813,7 @@ void BinkDecoder::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffma
 		int size = 1 << i;
 
 		for (int j = 0; j < 16; j += (size << 1))
-			mergeHuffmanSymbols(video, out + j, in + j, size);
+			mergeHuffmanSymbols(plane, out + j, in + j, size);
 
 		SWAP(in, out);
 	}
@@ -679,12 +821,12 @@ void BinkDecoder::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffma
 	memcpy(huffman.symbols, in, 16);
 }
 
-void BinkDecoder::BinkVideoTrack::mergeHuffmanSymbols(VideoFrame &video, byte *dst, const byte *src, int size) {
+void BinkDecoder::BinkVideoTrack::mergeHuffmanSymbols(PlaneContext &plane, byte *dst, const byte *src, int size) {
 	const byte *src2  = src + size;
 	int size2 = size;
 
 	do {
-		if (!video.bits->getBit()) {
+		if (!plane.bits->getBit()) {
 			*dst++ = *src++;
 			size--;
 		} else {
@@ -701,14 +843,10 @@ void BinkDecoder::BinkVideoTrack::mergeHuffmanSymbols(VideoFrame &video, byte *d
 		*dst++ = *src2++;
 }
 
-void BinkDecoder::BinkVideoTrack::initBundles() {
-	uint32 bw     = (_surface.w + 7) >> 3;
-	uint32 bh     = (_surface.h + 7) >> 3;
-	uint32 blocks = bw * bh;
-
+void BinkDecoder::BinkVideoTrack::initBundles(PlaneContext &plane, uint32 blocks) {
 	for (int i = 0; i < kSourceMAX; i++) {
-		_bundles[i].data    = new byte[blocks * 64];
-		_bundles[i].dataEnd = _bundles[i].data + blocks * 64;
+		plane.bundles[i].data    = new byte[blocks * 64];
+		plane.bundles[i].dataEnd = plane.bundles[i].data + blocks * 64;
 	}
 
 	uint32 cbw[2] = { (uint32)((_surface.w + 7) >> 3), (uint32)((_surface.w  + 15) >> 4) };
@@ -718,51 +856,51 @@ void BinkDecoder::BinkVideoTrack::initBundles() {
 	for (int i = 0; i < 2; i++) {
 		int width = MAX<uint32>(cw[i], 8);
 
-		_bundles[kSourceBlockTypes   ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
-		_bundles[kSourceSubBlockTypes].countLengths[i] = Common::intLog2(((width + 7) >> 4) + 511) + 1;
-		_bundles[kSourceColors       ].countLengths[i] = Common::intLog2((cbw[i])     * 64  + 511) + 1;
-		_bundles[kSourceIntraDC      ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
-		_bundles[kSourceInterDC      ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
-		_bundles[kSourceXOff         ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
-		_bundles[kSourceYOff         ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
-		_bundles[kSourcePattern      ].countLengths[i] = Common::intLog2((cbw[i]      << 3) + 511) + 1;
-		_bundles[kSourceRun          ].countLengths[i] = Common::intLog2((cbw[i])     * 48  + 511) + 1;
+		plane.bundles[kSourceBlockTypes   ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		plane.bundles[kSourceSubBlockTypes].countLengths[i] = Common::intLog2(((width + 7) >> 4) + 511) + 1;
+		plane.bundles[kSourceColors       ].countLengths[i] = Common::intLog2((cbw[i])     * 64  + 511) + 1;
+		plane.bundles[kSourceIntraDC      ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		plane.bundles[kSourceInterDC      ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		plane.bundles[kSourceXOff         ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		plane.bundles[kSourceYOff         ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		plane.bundles[kSourcePattern      ].countLengths[i] = Common::intLog2((cbw[i]      << 3) + 511) + 1;
+		plane.bundles[kSourceRun          ].countLengths[i] = Common::intLog2((cbw[i])     * 48  + 511) + 1;
 	}
 }
 
-void BinkDecoder::BinkVideoTrack::deinitBundles() {
+void BinkDecoder::BinkVideoTrack::deinitBundles(PlaneContext &plane) {
 	for (int i = 0; i < kSourceMAX; i++)
-		delete[] _bundles[i].data;
+		delete[] plane.bundles[i].data;
 }
 
 void BinkDecoder::BinkVideoTrack::initHuffman() {
 	for (int i = 0; i < 16; i++)
-		_huffman[i] = new Common::Huffman<Common::BitStream32LELSB>(binkHuffmanLengths[i][15], 16, binkHuffmanCodes[i], binkHuffmanLengths[i]);
+		_huffman[i] = new Common::Huffman<Common::BitStreamMemory32LELSB>(binkHuffmanLengths[i][15], 16, binkHuffmanCodes[i], binkHuffmanLengths[i]);
 }
 
-byte BinkDecoder::BinkVideoTrack::getHuffmanSymbol(VideoFrame &video, Huffman &huffman) {
-	return huffman.symbols[_huffman[huffman.index]->getSymbol(*video.bits)];
+byte BinkDecoder::BinkVideoTrack::getHuffmanSymbol(PlaneContext &plane, Huffman &huffman) {
+	return huffman.symbols[_huffman[huffman.index]->getSymbol(*plane.bits)];
 }
 
-int32 BinkDecoder::BinkVideoTrack::getBundleValue(Source source) {
+int32 BinkDecoder::BinkVideoTrack::getBundleValue(PlaneContext &plane, Source source) {
 	if ((source < kSourceXOff) || (source == kSourceRun))
-		return *_bundles[source].curPtr++;
+		return *plane.bundles[source].curPtr++;
 
 	if ((source == kSourceXOff) || (source == kSourceYOff))
-		return (int8) *_bundles[source].curPtr++;
+		return (int8) *plane.bundles[source].curPtr++;
 
-	int16 ret = *((int16 *) _bundles[source].curPtr);
+	int16 ret = *((int16 *) plane.bundles[source].curPtr);
 
-	_bundles[source].curPtr += 2;
+	plane.bundles[source].curPtr += 2;
 
 	return ret;
 }
 
-uint32 BinkDecoder::BinkVideoTrack::readBundleCount(VideoFrame &video, Bundle &bundle) {
+uint32 BinkDecoder::BinkVideoTrack::readBundleCount(PlaneContext &plane, Bundle &bundle) {
 	if (!bundle.curDec || (bundle.curDec > bundle.curPtr))
 		return 0;
 
-	uint32 n = video.bits->getBits(bundle.countLength);
+	uint32 n = plane.bits->getBits(bundle.countLength);
 	if (n == 0)
 		bundle.curDec = 0;
 
@@ -786,19 +924,22 @@ void BinkDecoder::BinkVideoTrack::blockScaledSkip(DecodeContext &ctx) {
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledRun(DecodeContext &ctx) {
-	const uint8 *scan = binkPatterns[ctx.video->bits->getBits(4)];
+	const uint8 *scan = binkPatterns[ctx.plane->bits->getBits(4)];
 
 	int i = 0;
 	do {
-		int run = getBundleValue(kSourceRun) + 1;
+		int run = getBundleValue(*ctx.plane, kSourceRun) + 1;
 
 		i += run;
-		if (i > 64)
+		if (i > 64) {
+			if (failPlane(*ctx.plane))
+				return;
 			error("Run went out of bounds");
+		}
 
-		if (ctx.video->bits->getBit()) {
+		if (ctx.plane->bits->getBit()) {
 
-			byte v = getBundleValue(kSourceColors);
+			byte v = getBundleValue(*ctx.plane, kSourceColors);
 			for (int j = 0; j < run; j++, scan++)
 				ctx.dest[ctx.coordScaledMap1[*scan]] =
 				ctx.dest[ctx.coordScaledMap2[*scan]] =
@@ -810,7 +951,7 @@ void BinkDecoder::BinkVideoTrack::blockScaledRun(DecodeContext &ctx) {
 				ctx.dest[ctx.coordScaledMap1[*scan]] =
 				ctx.dest[ctx.coordScaledMap2[*scan]] =
 				ctx.dest[ctx.coordScaledMap3[*scan]] =
-				ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(kSourceColors);
+				ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(*ctx.plane, kSourceColors);
 
 	} while (i < 63);
 
@@ -818,16 +959,21 @@ void BinkDecoder::BinkVideoTrack::blockScaledRun(DecodeContext &ctx) {
 		ctx.dest[ctx.coordScaledMap1[*scan]] =
 		ctx.dest[ctx.coordScaledMap2[*scan]] =
 		ctx.dest[ctx.coordScaledMap3[*scan]] =
-		ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(kSourceColors);
+		ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(*ctx.plane, kSourceColors);
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
 	int32 block[64];
 	memset(block, 0, 64 * sizeof(int32));
 
-	block[0] = getBundleValue(kSourceIntraDC);
+	block[0] = getBundleValue(*ctx.plane, kSourceIntraDC);
 
-	readDCTCoeffs(*ctx.video, block, true);
+	readDCTCoeffs(*ctx.plane, block, true);
+
+	if (_simd.idctPutScaled) {
+		_simd.idctPutScaled(ctx.dest, ctx.pitch, block);
+		return;
+	}
 
 	IDCT(block);
 
@@ -843,7 +989,7 @@ void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledFill(DecodeContext &ctx) {
-	byte v = getBundleValue(kSourceColors);
+	byte v = getBundleValue(*ctx.plane, kSourceColors);
 
 	byte *dest = ctx.dest;
 	for (int i = 0; i < 16; i++, dest += ctx.pitch)
@@ -854,12 +1000,25 @@ void BinkDecoder::BinkVideoTrack::blockScaledPattern(DecodeContext &ctx) {
 	byte col[2];
 
 	for (int i = 0; i < 2; i++)
-		col[i] = getBundleValue(kSourceColors);
+		col[i] = getBundleValue(*ctx.plane, kSourceColors);
+
+	if (_simd.putScaled) {
+		byte pixels[64];
+		for (int j = 0; j < 8; j++) {
+			byte v = getBundleValue(*ctx.plane, kSourcePattern);
+
+			for (int i = 0; i < 8; i++, v >>= 1)
+				pixels[j * 8 + i] = col[v & 1];
+		}
+
+		_simd.putScaled(ctx.dest, ctx.pitch, pixels, 8);
+		return;
+	}
 
 	byte *dest1 = ctx.dest;
 	byte *dest2 = ctx.dest + ctx.pitch;
 	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
-		byte v = getBundleValue(kSourcePattern);
+		byte v = getBundleValue(*ctx.plane, kSourcePattern);
 
 		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2, v >>= 1)
 			dest1[0] = dest1[1] = dest2[0] = dest2[1] = col[v & 1];
@@ -867,22 +1026,28 @@ void BinkDecoder::BinkVideoTrack::blockScaledPattern(DecodeContext &ctx) {
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledRaw(DecodeContext &ctx) {
+	if (_simd.putScaled) {
+		_simd.putScaled(ctx.dest, ctx.pitch, ctx.plane->bundles[kSourceColors].curPtr, 8);
+		ctx.plane->bundles[kSourceColors].curPtr += 64;
+		return;
+	}
+
 	byte row[8];
 
 	byte *dest1 = ctx.dest;
 	byte *dest2 = ctx.dest + ctx.pitch;
 	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
-		memcpy(row, _bundles[kSourceColors].curPtr, 8);
+		memcpy(row, ctx.plane->bundles[kSourceColors].curPtr, 8);
 
 		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
 			dest1[0] = dest1[1] = dest2[0] = dest2[1] = row[i];
 
-		_bundles[kSourceColors].curPtr += 8;
+		ctx.plane->bundles[kSourceColors].curPtr += 8;
 	}
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaled(DecodeContext &ctx) {
-	BlockType blockType = (BlockType) getBundleValue(kSourceSubBlockTypes);
+	BlockType blockType = (BlockType) getBundleValue(*ctx.plane, kSourceSubBlockTypes);
 
 	switch (blockType) {
 	case kBlockRun:
@@ -901,6 +1066,8 @@ void BinkDecoder::BinkVideoTrack::blockScaled(DecodeContext &ctx) {
 		blockScaledRaw(ctx);
 		break;
 	default:
+		if (failPlane(*ctx.plane))
+			return;
 		error("Invalid 16x16 block type: %d", blockType);
 	}
 
@@ -910,54 +1077,60 @@ void BinkDecoder::BinkVideoTrack::blockScaled(DecodeContext &ctx) {
 }
 
 void BinkDecoder::BinkVideoTrack::blockMotion(DecodeContext &ctx) {
-	int8 xOff = getBundleValue(kSourceXOff);
-	int8 yOff = getBundleValue(kSourceYOff);
+	int8 xOff = getBundleValue(*ctx.plane, kSourceXOff);
+	int8 yOff = getBundleValue(*ctx.plane, kSourceYOff);
 
 	byte *dest = ctx.dest;
 	byte *prev = ctx.prev + yOff * ((int32) ctx.pitch) + xOff;
-	if ((prev < ctx.prevStart) || (prev > ctx.prevEnd))
+	if ((prev < ctx.prevStart) || (prev > ctx.prevEnd)) {
+		if (failPlane(*ctx.plane))
+			return;
 		error("Copy out of bounds (%d | %d)", ctx.blockX * 8 + xOff, ctx.blockY * 8 + yOff);
+	}
 
 	for (int j = 0; j < 8; j++, dest += ctx.pitch, prev += ctx.pitch)
 		memcpy(dest, prev, 8);
 }
 
 void BinkDecoder::BinkVideoTrack::blockRun(DecodeContext &ctx) {
-	const uint8 *scan = binkPatterns[ctx.video->bits->getBits(4)];
+	const uint8 *scan = binkPatterns[ctx.plane->bits->getBits(4)];
 
 	int i = 0;
 	do {
-		int run = getBundleValue(kSourceRun) + 1;
+		int run = getBundleValue(*ctx.plane, kSourceRun) + 1;
 
 		i += run;
-		if (i > 64)
+		if (i > 64) {
+			if (failPlane(*ctx.plane))
+				return;
 			error("Run went out of bounds");
+		}
 
-		if (ctx.video->bits->getBit()) {
+		if (ctx.plane->bits->getBit()) {
 
-			byte v = getBundleValue(kSourceColors);
+			byte v = getBundleValue(*ctx.plane, kSourceColors);
 			for (int j = 0; j < run; j++)
 				ctx.dest[ctx.coordMap[*scan++]] = v;
 
 		} else
 			for (int j = 0; j < run; j++)
-				ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(kSourceColors);
+				ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(*ctx.plane, kSourceColors);
 
 	} while (i < 63);
 
 	if (i == 63)
-		ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(kSourceColors);
+		ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(*ctx.plane, kSourceColors);
 }
 
 void BinkDecoder::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
 	blockMotion(ctx);
 
-	byte v = ctx.video->bits->getBits(7);
+	byte v = ctx.plane->bits->getBits(7);
 
 	int16 block[64];
 	memset(block, 0, 64 * sizeof(int16));
 
-	readResidue(*ctx.video, block, v);
+	readResidue(*ctx.plane, block, v);
 
 	byte  *dst = ctx.dest;
 	int16 *src = block;
@@ -970,15 +1143,15 @@ void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
 	int32 block[64];
 	memset(block, 0, 64 * sizeof(int32));
 
-	block[0] = getBundleValue(kSourceIntraDC);
+	block[0] = getBundleValue(*ctx.plane, kSourceIntraDC);
 
-	readDCTCoeffs(*ctx.video, block, true);
+	readDCTCoeffs(*ctx.plane, block, true);
 
 	IDCTPut(ctx, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx) {
-	byte v = getBundleValue(kSourceColors);
+	byte v = getBundleValue(*ctx.plane, kSourceColors);
 
 	byte *dest = ctx.dest;
 	for (int i = 0; i < 8; i++, dest += ctx.pitch)
@@ -991,9 +1164,9 @@ void BinkDecoder::BinkVideoTrack::blockInter(DecodeContext &ctx) {
 	int32 block[64];
 	memset(block, 0, 64 * sizeof(int32));
 
-	block[0] = getBundleValue(kSourceInterDC);
+	block[0] = getBundleValue(*ctx.plane, kSourceInterDC);
 
-	readDCTCoeffs(*ctx.video, block, false);
+	readDCTCoeffs(*ctx.plane, block, false);
 
 	IDCTAdd(ctx, block);
 }
@@ -1002,11 +1175,11 @@ void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
 	byte col[2];
 
 	for (int i = 0; i < 2; i++)
-		col[i] = getBundleValue(kSourceColors);
+		col[i] = getBundleValue(*ctx.plane, kSourceColors);
 
 	byte *dest = ctx.dest;
 	for (int i = 0; i < 8; i++, dest += ctx.pitch - 8) {
-		byte v = getBundleValue(kSourcePattern);
+		byte v = getBundleValue(*ctx.plane, kSourcePattern);
 
 		for (int j = 0; j < 8; j++, v >>= 1)
 			*dest++ = col[v & 1];
@@ -1015,47 +1188,53 @@ void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
 
 void BinkDecoder::BinkVideoTrack::blockRaw(DecodeContext &ctx) {
 	byte *dest = ctx.dest;
-	byte *data = _bundles[kSourceColors].curPtr;
+	byte *data = ctx.plane->bundles[kSourceColors].curPtr;
 	for (int i = 0; i < 8; i++, dest += ctx.pitch, data += 8)
 		memcpy(dest, data, 8);
 
-	_bundles[kSourceColors].curPtr += 64;
+	ctx.plane->bundles[kSourceColors].curPtr += 64;
 }
 
-void BinkDecoder::BinkVideoTrack::readRuns(VideoFrame &video, Bundle &bundle) {
-	uint32 n = readBundleCount(video, bundle);
+void BinkDecoder::BinkVideoTrack::readRuns(PlaneContext &plane, Bundle &bundle) {
+	uint32 n = readBundleCount(plane, bundle);
 	if (n == 0)
 		return;
 
 	byte *decEnd = bundle.curDec + n;
-	if (decEnd > bundle.dataEnd)
+	if (decEnd > bundle.dataEnd) {
+		if (failPlane(plane))
+			return;
 		error("Run value went out of bounds");
+	}
 
-	if (video.bits->getBit()) {
-		byte v = video.bits->getBits(4);
+	if (plane.bits->getBit()) {
+		byte v = plane.bits->getBits(4);
 
 		memset(bundle.curDec, v, n);
 		bundle.curDec += n;
 
 	} else
 		while (bundle.curDec < decEnd)
-			*bundle.curDec++ = getHuffmanSymbol(video, bundle.huffman);
+			*bundle.curDec++ = getHuffmanSymbol(plane, bundle.huffman);
 }
 
-void BinkDecoder::BinkVideoTrack::readMotionValues(VideoFrame &video, Bundle &bundle) {
-	uint32 n = readBundleCount(video, bundle);
+void BinkDecoder::BinkVideoTrack::readMotionValues(PlaneContext &plane, Bundle &bundle) {
+	uint32 n = readBundleCount(plane, bundle);
 	if (n == 0)
 		return;
 
 	byte *decEnd = bundle.curDec + n;
-	if (decEnd > bundle.dataEnd)
+	if (decEnd > bundle.dataEnd) {
+		if (failPlane(plane))
+			return;
 		error("Too many motion values");
+	}
 
-	if (video.bits->getBit()) {
-		byte v = video.bits->getBits(4);
+	if (plane.bits->getBit()) {
+		byte v = plane.bits->getBits(4);
 
 		if (v) {
-			int sign = -(int)video.bits->getBit();
+			int sign = -(int)plane.bits->getBit();
 			v = (v ^ sign) - sign;
 		}
 
@@ -1066,10 +1245,10 @@ void BinkDecoder::BinkVideoTrack::readMotionValues(VideoFrame &video, Bundle &bu
 	}
 
 	do {
-		byte v = getHuffmanSymbol(video, bundle.huffman);
+		byte v = getHuffmanSymbol(plane, bundle.huffman);
 
 		if (v) {
-			int sign = -(int)video.bits->getBit();
+			int sign = -(int)plane.bits->getBit();
 			v = (v ^ sign) - sign;
 		}
 
@@ -1079,17 +1258,20 @@ void BinkDecoder::BinkVideoTrack::readMotionValues(VideoFrame &video, Bundle &bu
 }
 
 const uint8 rleLens[4] = { 4, 8, 12, 32 };
-void BinkDecoder::BinkVideoTrack::readBlockTypes(VideoFrame &video, Bundle &bundle) {
-	uint32 n = readBundleCount(video, bundle);
+void BinkDecoder::BinkVideoTrack::readBlockTypes(PlaneContext &plane, Bundle &bundle) {
+	uint32 n = readBundleCount(plane, bundle);
 	if (n == 0)
 		return;
 
 	byte *decEnd = bundle.curDec + n;
-	if (decEnd > bundle.dataEnd)
+	if (decEnd > bundle.dataEnd) {
+		if (failPlane(plane))
+			return;
 		error("Too many block type values");
+	}
 
-	if (video.bits->getBit()) {
-		byte v = video.bits->getBits(4);
+	if (plane.bits->getBit()) {
+		byte v = plane.bits->getBits(4);
 
 		memset(bundle.curDec, v, n);
 
@@ -1100,7 +1282,7 @@ void BinkDecoder::BinkVideoTrack::readBlockTypes(VideoFrame &video, Bundle &bund
 	byte last = 0;
 	do {
 
-		byte v = getHuffmanSymbol(video, bundle.huffman);
+		byte v = getHuffmanSymbol(plane, bundle.huffman);
 
 		if (v < 12) {
 			last = v;
@@ -1116,39 +1298,45 @@ void BinkDecoder::BinkVideoTrack::readBlockTypes(VideoFrame &video, Bundle &bund
 	} while (bundle.curDec < decEnd);
 }
 
-void BinkDecoder::BinkVideoTrack::readPatterns(VideoFrame &video, Bundle &bundle) {
-	uint32 n = readBundleCount(video, bundle);
+void BinkDecoder::BinkVideoTrack::readPatterns(PlaneContext &plane, Bundle &bundle) {
+	uint32 n = readBundleCount(plane, bundle);
 	if (n == 0)
 		return;
 
 	byte *decEnd = bundle.curDec + n;
-	if (decEnd > bundle.dataEnd)
+	if (decEnd > bundle.dataEnd) {
+		if (failPlane(plane))
+			return;
 		error("Too many pattern values");
+	}
 
 	byte v;
 	while (bundle.curDec < decEnd) {
-		v  = getHuffmanSymbol(video, bundle.huffman);
-		v |= getHuffmanSymbol(video, bundle.huffman) << 4;
+		v  = getHuffmanSymbol(plane, bundle.huffman);
+		v |= getHuffmanSymbol(plane, bundle.huffman) << 4;
 		*bundle.curDec++ = v;
 	}
 }
 
 
-void BinkDecoder::BinkVideoTrack::readColors(VideoFrame &video, Bundle &bundle) {
-	uint32 n = readBundleCount(video, bundle);
+void BinkDecoder::BinkVideoTrack::readColors(PlaneContext &plane, Bundle &bundle) {
+	uint32 n = readBundleCount(plane, bundle);
 	if (n == 0)
 		return;
 
 	byte *decEnd = bundle.curDec + n;
-	if (decEnd > bundle.dataEnd)
+	if (decEnd > bundle.dataEnd) {
+		if (failPlane(plane))
+			return;
 		error("Too many color values");
+	}
 
-	if (video.bits->getBit()) {
-		_colLastVal = getHuffmanSymbol(video, _colHighHuffman[_colLastVal]);
+	if (plane.bits->getBit()) {
+		plane.colLastVal = getHuffmanSymbol(plane, plane.colHighHuffman[plane.colLastVal]);
 
 		byte v;
-		v = getHuffmanSymbol(video, bundle.huffman);
-		v = (_colLastVal << 4) | v;
+		v = getHuffmanSymbol(plane, bundle.huffman);
+		v = (plane.colLastVal << 4) | v;
 
 		if (_id != kBIKiID) {
 			int sign = ((int8) v) >> 7;
@@ -1163,11 +1351,11 @@ void BinkDecoder::BinkVideoTrack::readColors(VideoFrame &video, Bundle &bundle)
 	}
 
 	while (bundle.curDec < decEnd) {
-		_colLastVal = getHuffmanSymbol(video, _colHighHuffman[_colLastVal]);
+		plane.colLastVal = getHuffmanSymbol(plane, plane.colHighHuffman[plane.colLastVal]);
 
 		byte v;
-		v = getHuffmanSymbol(video, bundle.huffman);
-		v = (_colLastVal << 4) | v;
+		v = getHuffmanSymbol(plane, bundle.huffman);
+		v = (plane.colLastVal << 4) | v;
 
 		if (_id != kBIKiID) {
 			int sign = ((int8) v) >> 7;
@@ -1178,16 +1366,16 @@ void BinkDecoder::BinkVideoTrack::readColors(VideoFrame &video, Bundle &bundle)
 	}
 }
 
-void BinkDecoder::BinkVideoTrack::readDCS(VideoFrame &video, Bundle &bundle, int startBits, bool hasSign) {
-	uint32 length = readBundleCount(video, bundle);
+void BinkDecoder::BinkVideoTrack::readDCS(PlaneContext &plane, Bundle &bundle, int startBits, bool hasSign) {
+	uint32 length = readBundleCount(plane, bundle);
 	if (length == 0)
 		return;
 
 	int16 *dest = (int16 *) bundle.curDec;
 
-	int32 v = video.bits->getBits(startBits - (hasSign ? 1 : 0));
+	int32 v = plane.bits->getBits(startBits - (hasSign ? 1 : 0));
 	if (v && hasSign) {
-		int sign = -(int)video.bits->getBit();
+		int sign = -(int)plane.bits->getBit();
 		v = (v ^ sign) - sign;
 	}
 
@@ -1197,22 +1385,25 @@ void BinkDecoder::BinkVideoTrack::readDCS(VideoFrame &video, Bundle &bundle, int
 	for (uint32 i = 0; i < length; i += 8) {
 		uint32 length2 = MIN<uint32>(length - i, 8);
 
-		byte bSize = video.bits->getBits(4);
+		byte bSize = plane.bits->getBits(4);
 
 		if (bSize) {
 
 			for (uint32 j = 0; j < length2; j++) {
-				int16 v2 = video.bits->getBits(bSize);
+				int16 v2 = plane.bits->getBits(bSize);
 				if (v2) {
-					int sign = -(int)video.bits->getBit();
+					int sign = -(int)plane.bits->getBit();
 					v2 = (v2 ^ sign) - sign;
 				}
 
 				v += v2;
 				*dest++ = v;
 
-				if ((v < -32768) || (v > 32767))
+				if ((v < -32768) || (v > 32767)) {
+					if (failPlane(plane))
+						return;
 					error("DC value went out of bounds: %d", v);
+				}
 			}
 
 		} else
@@ -1224,7 +1415,7 @@ void BinkDecoder::BinkVideoTrack::readDCS(VideoFrame &video, Bundle &bundle, int
 }
 
 /** Reads 8x8 block of DCT coefficients. */
-void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block, bool isIntra) {
+void BinkDecoder::BinkVideoTrack::readDCTCoeffs(PlaneContext &plane, int32 *block, bool isIntra) {
 	int coefCount = 0;
 	int coefIdx[64];
 
@@ -1239,13 +1430,13 @@ void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block,
 	coefList[listEnd] = 2;  modeList[listEnd++] = 3;
 	coefList[listEnd] = 3;  modeList[listEnd++] = 3;
 
-	int bits = video.bits->getBits(4) - 1;
+	int bits = plane.bits->getBits(4) - 1;
 	for (int mask = 1 << bits; bits >= 0; mask >>= 1, bits--) {
 		int listPos = listStart;
 
 		while (listPos < listEnd) {
 
-			if (!(modeList[listPos] | coefList[listPos]) || !video.bits->getBit()) {
+			if (!(modeList[listPos] | coefList[listPos]) || !plane.bits->getBit()) {
 				listPos++;
 				continue;
 			}
@@ -1264,17 +1455,17 @@ void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block,
 					modeList[listPos++] = 0;
 				}
 				for (int i = 0; i < 4; i++, ccoef++) {
-					if (video.bits->getBit()) {
+					if (plane.bits->getBit()) {
 						coefList[--listStart] = ccoef;
 						modeList[  listStart] = 3;
 					} else {
 						int t;
 						if (!bits) {
-							t = 1 - (video.bits->getBit() << 1);
+							t = 1 - (plane.bits->getBit() << 1);
 						} else {
-							t = video.bits->getBits(bits) | mask;
+							t = plane.bits->getBits(bits) | mask;
 
-							int sign = -(int)video.bits->getBit();
+							int sign = -(int)plane.bits->getBit();
 							t = (t ^ sign) - sign;
 						}
 						block[binkScan[ccoef]] = t;
@@ -1295,11 +1486,11 @@ void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block,
 			case 3:
 				int t;
 				if (!bits) {
-					t = 1 - (video.bits->getBit() << 1);
+					t = 1 - (plane.bits->getBit() << 1);
 				} else {
-					t = video.bits->getBits(bits) | mask;
+					t = plane.bits->getBits(bits) | mask;
 
-					int sign = -(int)video.bits->getBit();
+					int sign = -(int)plane.bits->getBit();
 					t = (t ^ sign) - sign;
 				}
 				block[binkScan[ccoef]] = t;
@@ -1314,7 +1505,7 @@ void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block,
 		}
 	}
 
-	uint8 quantIdx = video.bits->getBits(4);
+	uint8 quantIdx = plane.bits->getBits(4);
 	const int32 *quant = isIntra ? binkIntraQuant[quantIdx] : binkInterQuant[quantIdx];
 	block[0] = (block[0] * quant[0]) >> 11;
 
@@ -1326,7 +1517,7 @@ void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block,
 }
 
 /** Reads 8x8 block with residue after motion compensation. */
-void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, int masksCount) {
+void BinkDecoder::BinkVideoTrack::readResidue(PlaneContext &plane, int16 *block, int masksCount) {
 	int nzCoeff[64];
 	int nzCoeffCount = 0;
 
@@ -1339,10 +1530,10 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 	coefList[listEnd] = 44; modeList[listEnd++] = 0;
 	coefList[listEnd] =  0; modeList[listEnd++] = 2;
 
-	for (int mask = 1 << video.bits->getBits(3); mask; mask >>= 1) {
+	for (int mask = 1 << plane.bits->getBits(3); mask; mask >>= 1) {
 
 		for (int i = 0; i < nzCoeffCount; i++) {
-			if (!video.bits->getBit())
+			if (!plane.bits->getBit())
 				continue;
 			if (block[nzCoeff[i]] < 0)
 				block[nzCoeff[i]] -= mask;
@@ -1356,7 +1547,7 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 		int listPos = listStart;
 		while (listPos < listEnd) {
 
-			if (!(coefList[listPos] | modeList[listPos]) || !video.bits->getBit()) {
+			if (!(coefList[listPos] | modeList[listPos]) || !plane.bits->getBit()) {
 				listPos++;
 				continue;
 			}
@@ -1376,13 +1567,13 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 				}
 
 				for (int i = 0; i < 4; i++, ccoef++) {
-					if (video.bits->getBit()) {
+					if (plane.bits->getBit()) {
 						coefList[--listStart] = ccoef;
 						modeList[  listStart] = 3;
 					} else {
 						nzCoeff[nzCoeffCount++] = binkScan[ccoef];
 
-						int sign = -(int)video.bits->getBit();
+						int sign = -(int)plane.bits->getBit();
 						block[binkScan[ccoef]] = (mask ^ sign) - sign;
 
 						masksCount--;
@@ -1405,7 +1596,7 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 				{
 					nzCoeff[nzCoeffCount++] = binkScan[ccoef];
 
-					int sign = -(int)video.bits->getBit();
+					int sign = -(int)plane.bits->getBit();
 					block[binkScan[ccoef]] = (mask ^ sign) - sign;
 
 					coefList[listPos]   = 0;
@@ -1486,6 +1677,11 @@ void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
 }
 
 void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
+	if (_simd.idctAdd) {
+		_simd.idctAdd(ctx.dest, ctx.pitch, block);
+		return;
+	}
+
 	int i, j;
 
 	IDCT(block);
@@ -1496,6 +1692,11 @@ void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
 }
 
 void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
+	if (_simd.idctPut) {
+		_simd.idctPut(ctx.dest, ctx.pitch, block);
+		return;
+	}
+
 	int i;
 	int32 temp[64];
 	for (i = 0; i < 8; i++)
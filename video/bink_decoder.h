@@ -36,6 +36,7 @@
 #include "common/rational.h"
 
 #include "video/video_decoder.h"
+#include "video/bink_simd.h"
 
 #include "graphics/surface.h"
 
@@ -51,6 +52,7 @@ class Huffman;
 
 class RDFT;
 class DCT;
+class WorkerPool;
 }
 
 namespace Graphics {
@@ -138,7 +140,8 @@ private:
 		uint32 offset;
 		uint32 size;
 
-		Common::BitStream32LELSB *bits;
+		Common::BitStreamMemoryStream *data; ///< The video packet, while it is decoded.
+		Common::BitStreamMemory32LELSB *bits;
 
 		VideoFrame();
 		~VideoFrame();
@@ -166,9 +169,11 @@ private:
 		Common::Rational getFrameRate() const override { return _frameRate; }
 
 	private:
+		struct PlaneContext;
+
 		/** A decoder state. */
 		struct DecodeContext {
-			VideoFrame *video;
+			PlaneContext *plane;
 
 			uint32 planeIdx;
 
@@ -239,6 +244,37 @@ private:
 			byte *curPtr; ///< Pointer to the data that wasn't yet read.
 		};
 
+		/**
+		 * The bit stream planes are read from, and the bundles decoding them.
+		 * Planes which are decoded at the same time each need their own.
+		 */
+		struct PlaneContext {
+			Common::BitStreamMemory32LELSB *bits;
+
+			Bundle bundles[kSourceMAX]; ///< Bundles for decoding all data types.
+
+			/** Huffman codebooks to use for decoding high nibbles in color data types. */
+			Huffman colHighHuffman[16];
+			/** Value of the last decoded high nibble in color data types. */
+			int colLastVal;
+
+			/**
+			 * Whether the planes are decoded from an offset which is not
+			 * known to be right yet, where bad data is not fatal.
+			 */
+			bool speculative;
+			/** Whether speculative decoding ran into bad data. */
+			bool failed;
+		};
+
+		/** How the offset of the chroma planes in BIKi packets is stored. */
+		enum ChromaOffset {
+			kChromaOffsetUnknown,  ///< Not seen yet, the planes are decoded one after another.
+			kChromaOffsetInvalid,  ///< Doesn't match the actual offset.
+			kChromaOffsetAbsolute, ///< Relative to the packet start.
+			kChromaOffsetRelative  ///< Relative to the end of the offset.
+		};
+
 		int _curFrame;
 		int _frameCount;
 
@@ -253,14 +289,15 @@ private:
 
 		Common::Rational _frameRate;
 
-		Bundle _bundles[kSourceMAX]; ///< Bundles for decoding all data types.
+		/** The contexts of the luma (and alpha) plane and of the chroma planes. */
+		PlaneContext _planeContexts[2];
 
-		Common::Huffman<Common::BitStream32LELSB> *_huffman[16]; ///< The 16 Huffman codebooks used in Bink decoding.
+		Common::Huffman<Common::BitStreamMemory32LELSB> *_huffman[16]; ///< The 16 Huffman codebooks used in Bink decoding.
 
-		/** Huffman codebooks to use for decoding high nibbles in color data types. */
-		Huffman _colHighHuffman[16];
-		/** Value of the last decoded high nibble in color data types. */
-		int _colLastVal;
+		Common::WorkerPool *_workerPool; ///< Decodes the luma and the chroma planes at the same time.
+		ChromaOffset _chromaOffset;
+
+		BinkSIMDProcs _simd; ///< SIMD block functions, nullptr where there are none.
 
 		uint32 _yBlockWidth;   ///< Width of the Y plane in blocks
 		uint32 _yBlockHeight;  ///< Height of the Y plane in blocks
@@ -270,32 +307,42 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
-		/** Initialize the bundles. */
-		void initBundles();
-		/** Deinitialize the bundles. */
-		void deinitBundles();
+		/** Initialize the bundles of a plane context, with room for the given number of blocks. */
+		void initBundles(PlaneContext &plane, uint32 blocks);
+		/** Deinitialize the bundles of a plane context. */
+		void deinitBundles(PlaneContext &plane);
 
 		/** Initialize the Huffman decoders. */
 		void initHuffman();
 
+		/** Decode the luma plane or the chroma planes, as a job of the worker pool. */
+		static void decodePlanesJob(void *param, uint job);
+		/** Decode the chroma planes. */
+		void decodeChromaPlanes(PlaneContext &plane);
 		/** Decode a plane. */
-		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
+		void decodePlane(PlaneContext &plane, int planeIdx, bool isChroma);
+
+		/**
+		 * Called on bad data. Returns true when decoding the plane can be
+		 * given up on without an error, because it is speculative.
+		 */
+		bool failPlane(PlaneContext &plane);
 
 		/** Read/Initialize a bundle for decoding a plane. */
-		void readBundle(VideoFrame &video, Source source);
+		void readBundle(PlaneContext &plane, Source source);
 
 		/** Read the symbols for a Huffman code. */
-		void readHuffman(VideoFrame &video, Huffman &huffman);
+		void readHuffman(PlaneContext &plane, Huffman &huffman);
 		/** Merge two Huffman symbol lists. */
-		void mergeHuffmanSymbols(VideoFrame &video, byte *dst, const byte *src, int size);
+		void mergeHuffmanSymbols(PlaneContext &plane, byte *dst, const byte *src, int size);
 
 		/** Read and translate a symbol out of a Huffman code. */
-		byte getHuffmanSymbol(VideoFrame &video, Huffman &huffman);
+		byte getHuffmanSymbol(PlaneContext &plane, Huffman &huffman);
 
 		/** Get a direct value out of a bundle. */
-		int32 getBundleValue(Source source);
+		int32 getBundleValue(PlaneContext &plane, Source source);
 		/** Read a count value out of a bundle. */
-		uint32 readBundleCount(VideoFrame &video, Bundle &bundle);
+		uint32 readBundleCount(PlaneContext &plane, Bundle &bundle);
 
 		// Handle the block types
 		void blockSkip         (DecodeContext &ctx);
@@ -316,14 +363,14 @@ private:
 		void blockRaw          (DecodeContext &ctx);
 
 		// Read the bundles
-		void readRuns        (VideoFrame &video, Bundle &bundle);
-		void readMotionValues(VideoFrame &video, Bundle &bundle);
-		void readBlockTypes  (VideoFrame &video, Bundle &bundle);
-		void readPatterns    (VideoFrame &video, Bundle &bundle);
-		void readColors      (VideoFrame &video, Bundle &bundle);
-		void readDCS         (VideoFrame &video, Bundle &bundle, int startBits, bool hasSign);
-		void readDCTCoeffs   (VideoFrame &video, int32 *block, bool isIntra);
-		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
+		void readRuns        (PlaneContext &plane, Bundle &bundle);
+		void readMotionValues(PlaneContext &plane, Bundle &bundle);
+		void readBlockTypes  (PlaneContext &plane, Bundle &bundle);
+		void readPatterns    (PlaneContext &plane, Bundle &bundle);
+		void readColors      (PlaneContext &plane, Bundle &bundle);
+		void readDCS         (PlaneContext &plane, Bundle &bundle, int startBits, bool hasSign);
+		void readDCTCoeffs   (PlaneContext &plane, int32 *block, bool isIntra);
+		void readResidue     (PlaneContext &plane, int16 *block, int masksCount);
 
 		// Bink video IDCT
 		void IDCT(int32 *block);
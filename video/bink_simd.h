@@ -0,0 +1,60 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef VIDEO_BINK_SIMD_H
+#define VIDEO_BINK_SIMD_H
+
+#include "common/scummsys.h"
+
+namespace Video {
+
+/**
+ * Block functions of the Bink video decoder. Each one has the same
+ * result as the generic code it replaces, including the truncation of
+ * the IDCT output to bytes.
+ */
+struct BinkSIMDProcs {
+	/** Store the IDCT of a block, like IDCTPut(). */
+	void (*idctPut)(byte *dest, uint32 pitch, const int32 *block);
+	/** Add the IDCT of a block to the pixels, like IDCTAdd(). */
+	void (*idctAdd)(byte *dest, uint32 pitch, const int32 *block);
+	/** Store the IDCT of a block with every pixel doubled in both directions, like blockScaledIntra(). */
+	void (*idctPutScaled)(byte *dest, uint32 pitch, const int32 *block);
+	/** Store 8x8 pixels with every pixel doubled in both directions. */
+	void (*putScaled)(byte *dest, uint32 pitch, const byte *src, uint32 srcPitch);
+};
+
+#ifdef SCUMMVM_SSE2
+void getBinkSIMDProcsSSE2(BinkSIMDProcs &procs);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void getBinkSIMDProcsAVX2(BinkSIMDProcs &procs);
+#endif
+
+#ifdef SCUMMVM_NEON
+void getBinkSIMDProcsNEON(BinkSIMDProcs &procs);
+#endif
+
+} // End of namespace Video
+
+#endif
@@ -0,0 +1,141 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * The SIMD block functions of the Bink decoder, written once against a
+ * small set of vector operations. Each bink_*.cpp file defines those
+ * operations for its instruction set and includes this file, which must
+ * not be included anywhere else: it is compiled with different code
+ * generation flags every time.
+ *
+ * An Ops class provides, for vectors V of 8 signed 32 bit lanes:
+ *   load(), set1(), add(), sub(), mullo() (the low half of the product),
+ *   srai(), transpose() which transposes 8 vectors as an 8x8 matrix,
+ *   storeBytes() and addBytes() which store resp. add the low bytes of
+ *   the lanes to 8 pixels, storeBytesScaled() which stores every low byte
+ *   twice to two rows, and scaleBytes() which does the same with 8 bytes.
+ *
+ * The IDCT works on 32 bit lanes, like the generic code, so it wraps and
+ * truncates exactly the same way.
+ */
+
+#ifndef VIDEO_BINK_SIMD_IMPL_H
+#define VIDEO_BINK_SIMD_IMPL_H
+
+#include "video/bink_simd.h"
+
+namespace Video {
+
+template<class Ops>
+struct BinkKernels {
+	typedef typename Ops::V V;
+
+	static FORCEINLINE V mulShift(V a, int m) {
+		return Ops::srai(Ops::mullo(a, Ops::set1(m)), 11);
+	}
+
+	/** IDCT_TRANSFORM on 8 columns or rows at once. */
+	static FORCEINLINE void transform(const V *s, V *d) {
+		const V a0 = Ops::add(s[0], s[4]);
+		const V a1 = Ops::sub(s[0], s[4]);
+		const V a2 = Ops::add(s[2], s[6]);
+		const V a3 = mulShift(Ops::sub(s[2], s[6]), 2896);
+		const V a4 = Ops::add(s[5], s[3]);
+		const V a5 = Ops::sub(s[5], s[3]);
+		const V a6 = Ops::add(s[1], s[7]);
+		const V a7 = Ops::sub(s[1], s[7]);
+		const V b0 = Ops::add(a4, a6);
+		const V b1 = mulShift(Ops::add(a5, a7), 3784);
+		const V b2 = Ops::add(Ops::sub(mulShift(a5, -5352), b0), b1);
+		const V b3 = Ops::sub(mulShift(Ops::sub(a6, a4), 2896), b2);
+		const V b4 = Ops::sub(Ops::add(mulShift(a7, 2217), b3), b1);
+
+		const V c0 = Ops::add(a0, a2);
+		const V c1 = Ops::sub(Ops::add(a1, a3), a2);
+		const V c2 = Ops::add(Ops::sub(a1, a3), a2);
+		const V c3 = Ops::sub(a0, a2);
+		d[0] = Ops::add(c0, b0);
+		d[1] = Ops::add(c1, b2);
+		d[2] = Ops::add(c2, b3);
+		d[3] = Ops::sub(c3, b4);
+		d[4] = Ops::add(c3, b4);
+		d[5] = Ops::sub(c2, b3);
+		d[6] = Ops::sub(c1, b2);
+		d[7] = Ops::sub(c0, b0);
+	}
+
+	/**
+	 * The IDCT of a block, as 8 rows of output values. The columns are
+	 * transformed first, then the transposed rows, like IDCT() does.
+	 */
+	static FORCEINLINE void idct(const int32 *block, V *rows) {
+		V src[8], temp[8];
+		for (int i = 0; i < 8; i++)
+			src[i] = Ops::load(block + i * 8);
+
+		transform(src, temp);
+		Ops::transpose(temp);
+		transform(temp, rows);
+
+		const V round = Ops::set1(0x7F);
+		for (int i = 0; i < 8; i++)
+			rows[i] = Ops::srai(Ops::add(rows[i], round), 8);
+		Ops::transpose(rows);
+	}
+
+	static void idctPut(byte *dest, uint32 pitch, const int32 *block) {
+		V rows[8];
+		idct(block, rows);
+		for (int i = 0; i < 8; i++, dest += pitch)
+			Ops::storeBytes(dest, rows[i]);
+	}
+
+	static void idctAdd(byte *dest, uint32 pitch, const int32 *block) {
+		V rows[8];
+		idct(block, rows);
+		for (int i = 0; i < 8; i++, dest += pitch)
+			Ops::addBytes(dest, rows[i]);
+	}
+
+	static void idctPutScaled(byte *dest, uint32 pitch, const int32 *block) {
+		V rows[8];
+		idct(block, rows);
+		for (int i = 0; i < 8; i++, dest += pitch * 2)
+			Ops::storeBytesScaled(dest, pitch, rows[i]);
+	}
+
+	static void putScaled(byte *dest, uint32 pitch, const byte *src, uint32 srcPitch) {
+		for (int i = 0; i < 8; i++, dest += pitch * 2, src += srcPitch)
+			Ops::scaleBytes(dest, pitch, src);
+	}
+
+	static void getProcs(BinkSIMDProcs &procs) {
+		procs.idctPut = idctPut;
+		procs.idctAdd = idctAdd;
+		procs.idctPutScaled = idctPutScaled;
+		procs.putScaled = putScaled;
+	}
+};
+
+} // End of namespace Video
+
+#endif
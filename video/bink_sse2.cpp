@@ -0,0 +1,122 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "video/bink_simd.h"
+
+#include <emmintrin.h>
+
+namespace {
+
+struct SSE2Ops {
+	/** 8 lanes in two halves. */
+	struct V {
+		__m128i lo, hi;
+	};
+
+	static FORCEINLINE V make(__m128i lo, __m128i hi) {
+		V v;
+		v.lo = lo;
+		v.hi = hi;
+		return v;
+	}
+
+	/** The low half of the products of 32 bit lanes, which SSE2 has no instruction for. */
+	static FORCEINLINE __m128i mullo32(__m128i a, __m128i b) {
+		const __m128i even = _mm_mul_epu32(a, b);
+		const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	}
+
+	static FORCEINLINE void transpose4(__m128i &r0, __m128i &r1, __m128i &r2, __m128i &r3) {
+		const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+		const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+		const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+		const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+		r0 = _mm_unpacklo_epi64(t0, t1);
+		r1 = _mm_unpackhi_epi64(t0, t1);
+		r2 = _mm_unpacklo_epi64(t2, t3);
+		r3 = _mm_unpackhi_epi64(t2, t3);
+	}
+
+	/** The low bytes of the lanes, in the low 8 bytes. */
+	static FORCEINLINE __m128i lowBytes(V v) {
+		const __m128i mask = _mm_set1_epi32(0xFF);
+		const __m128i words = _mm_packs_epi32(_mm_and_si128(v.lo, mask), _mm_and_si128(v.hi, mask));
+		return _mm_packus_epi16(words, words);
+	}
+
+	static FORCEINLINE V load(const int32 *p) {
+		return make(_mm_loadu_si128((const __m128i *)p), _mm_loadu_si128((const __m128i *)(p + 4)));
+	}
+
+	static FORCEINLINE V set1(int x) { return make(_mm_set1_epi32(x), _mm_set1_epi32(x)); }
+	static FORCEINLINE V add(V a, V b) { return make(_mm_add_epi32(a.lo, b.lo), _mm_add_epi32(a.hi, b.hi)); }
+	static FORCEINLINE V sub(V a, V b) { return make(_mm_sub_epi32(a.lo, b.lo), _mm_sub_epi32(a.hi, b.hi)); }
+	static FORCEINLINE V mullo(V a, V b) { return make(mullo32(a.lo, b.lo), mullo32(a.hi, b.hi)); }
+	static FORCEINLINE V srai(V a, int n) { return make(_mm_srai_epi32(a.lo, n), _mm_srai_epi32(a.hi, n)); }
+
+	static FORCEINLINE void transpose(V *rows) {
+		transpose4(rows[0].lo, rows[1].lo, rows[2].lo, rows[3].lo);
+		transpose4(rows[0].hi, rows[1].hi, rows[2].hi, rows[3].hi);
+		transpose4(rows[4].lo, rows[5].lo, rows[6].lo, rows[7].lo);
+		transpose4(rows[4].hi, rows[5].hi, rows[6].hi, rows[7].hi);
+		for (int i = 0; i < 4; i++) {
+			const __m128i t = rows[i].hi;
+			rows[i].hi = rows[i + 4].lo;
+			rows[i + 4].lo = t;
+		}
+	}
+
+	static FORCEINLINE void storeBytes(byte *p, V v) {
+		_mm_storel_epi64((__m128i *)p, lowBytes(v));
+	}
+
+	static FORCEINLINE void addBytes(byte *p, V v) {
+		_mm_storel_epi64((__m128i *)p, _mm_add_epi8(_mm_loadl_epi64((const __m128i *)p), lowBytes(v)));
+	}
+
+	static FORCEINLINE void storeBytesScaled(byte *p, uint32 pitch, V v) {
+		const __m128i bytes = lowBytes(v);
+		const __m128i doubled = _mm_unpacklo_epi8(bytes, bytes);
+		_mm_storeu_si128((__m128i *)p, doubled);
+		_mm_storeu_si128((__m128i *)(p + pitch), doubled);
+	}
+
+	static FORCEINLINE void scaleBytes(byte *p, uint32 pitch, const byte *src) {
+		const __m128i bytes = _mm_loadl_epi64((const __m128i *)src);
+		const __m128i doubled = _mm_unpacklo_epi8(bytes, bytes);
+		_mm_storeu_si128((__m128i *)p, doubled);
+		_mm_storeu_si128((__m128i *)(p + pitch), doubled);
+	}
+};
+
+} // End of anonymous namespace
+
+#include "video/bink_simd_impl.h"
+
+namespace Video {
+
+void getBinkSIMDProcsSSE2(BinkSIMDProcs &procs) {
+	BinkKernels<SSE2Ops>::getProcs(procs);
+}
+
+} // End of namespace Video
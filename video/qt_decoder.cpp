@@ -86,10 +86,6 @@ void QuickTimeDecoder::close() {
 const Graphics::Surface *QuickTimeDecoder::decodeNextFrame() {
 	const Graphics::Surface *frame = VideoDecoder::decodeNextFrame();
 
-	// Update audio buffers too
-	// (needs to be done after we find the next track)
-	updateAudioBuffer();
-
 	// We have to initialize the scaled surface
 	if (frame && (_scaleFactorX != 1 || _scaleFactorY != 1)) {
 		if (!_scaledSurface) {
@@ -235,6 +231,12 @@ void QuickTimeDecoder::init() {
 	}
 }
 
+void QuickTimeDecoder::afterFrameDecoded() {
+	// Update audio buffers too
+	// (needs to be done after we find the next track)
+	updateAudioBuffer();
+}
+
 void QuickTimeDecoder::updateAudioBuffer() {
 	// Updates the audio buffers for all audio tracks
 	for (TrackListIterator it = getTrackListBegin(); it != getTrackListEnd(); it++)
@@ -615,24 +617,8 @@ Common::Rational QuickTimeDecoder::VideoTrackHandler::getScaledHeight() const {
 
 Common::SeekableReadStream *QuickTimeDecoder::VideoTrackHandler::getNextFramePacket(uint32 &descId) {
 	// First, we have to track down which chunk holds the sample and which sample in the chunk contains the frame we are looking for.
-	int32 totalSampleCount = 0;
-	int32 sampleInChunk = 0;
-	int32 actualChunk = -1;
-	uint32 sampleToChunkIndex = 0;
-
-	for (uint32 i = 0; i < _parent->chunkCount; i++) {
-		if (sampleToChunkIndex < _parent->sampleToChunkCount && i >= _parent->sampleToChunk[sampleToChunkIndex].first)
-			sampleToChunkIndex++;
-
-		totalSampleCount += _parent->sampleToChunk[sampleToChunkIndex - 1].count;
-
-		if (totalSampleCount > _curFrame) {
-			actualChunk = i;
-			descId = _parent->sampleToChunk[sampleToChunkIndex - 1].id;
-			sampleInChunk = _parent->sampleToChunk[sampleToChunkIndex - 1].count - totalSampleCount + _curFrame;
-			break;
-		}
-	}
+	uint32 sampleInChunk = 0;
+	const int32 actualChunk = _parent->findSampleChunk(_curFrame, sampleInChunk, descId);
 
 	if (actualChunk < 0)
 		error("Could not find data for frame %d", _curFrame);
@@ -642,7 +628,7 @@ Common::SeekableReadStream *QuickTimeDecoder::VideoTrackHandler::getNextFramePac
 	stream->seek(_parent->chunkOffsets[actualChunk]);
 
 	// Then, if the chunk holds more than one frame, seek to where the frame we want is located
-	for (int32 i = _curFrame - sampleInChunk; i < _curFrame; i++) {
+	for (int32 i = _curFrame - (int32)sampleInChunk; i < _curFrame; i++) {
 		if (_parent->sampleSize != 0)
 			stream->skip(_parent->sampleSize);
 		else
@@ -659,27 +645,17 @@ Common::SeekableReadStream *QuickTimeDecoder::VideoTrackHandler::getNextFramePac
 }
 
 uint32 QuickTimeDecoder::VideoTrackHandler::getFrameDuration() {
-	uint32 curFrameIndex = 0;
-	for (int32 i = 0; i < _parent->timeToSampleCount; i++) {
-		curFrameIndex += _parent->timeToSample[i].count;
-		if ((uint32)_curFrame < curFrameIndex) {
-			// Ok, now we have what duration this frame has.
-			return _parent->timeToSample[i].duration;
-		}
-	}
+	const int32 index = _parent->findTimeToSample(_curFrame);
 
 	// This should never occur
-	error("Cannot find duration for frame %d", _curFrame);
-	return 0;
+	if (index < 0)
+		error("Cannot find duration for frame %d", _curFrame);
+
+	return _parent->timeToSample[index].duration;
 }
 
 uint32 QuickTimeDecoder::VideoTrackHandler::findKeyFrame(uint32 frame) const {
-	for (int i = _parent->keyframeCount - 1; i >= 0; i--)
-		if (_parent->keyframes[i] <= frame)
-			return _parent->keyframes[i];
-
-	// If none found, we'll assume the requested frame is a key frame
-	return frame;
+	return _parent->findKeyframe(frame);
 }
 
 void QuickTimeDecoder::VideoTrackHandler::enterNewEditList(bool bufferFrames) {
@@ -691,32 +667,18 @@ void QuickTimeDecoder::VideoTrackHandler::enterNewEditList(bool bufferFrames) {
 		return;
 
 	uint32 mediaTime = _parent->editList[_curEdit].mediaTime;
-	uint32 frameNum = 0;
 	uint32 totalDuration = 0;
 	_durationOverride = -1;
 
 	// Track down where the mediaTime is in the media
 	// This is basically time -> frame mapping
 	// Note that this code uses first frame = 0
-	for (int32 i = 0; i < _parent->timeToSampleCount; i++) {
-		uint32 duration = _parent->timeToSample[i].count * _parent->timeToSample[i].duration;
+	uint32 frameNum = _parent->findSampleAtTime(mediaTime, totalDuration);
 
-		if (totalDuration + duration >= mediaTime) {
-			uint32 frameInc = (mediaTime - totalDuration) / _parent->timeToSample[i].duration;
-			frameNum += frameInc;
-			totalDuration += frameInc * _parent->timeToSample[i].duration;
-
-			// If we didn't get to the exact media time, mark an override for
-			// the time.
-			if (totalDuration != mediaTime)
-				_durationOverride = totalDuration + _parent->timeToSample[i].duration - mediaTime;
-
-			break;
-		}
-
-		frameNum += _parent->timeToSample[i].count;
-		totalDuration += duration;
-	}
+	// If we didn't get to the exact media time, mark an override for
+	// the time.
+	if (frameNum < _parent->frameCount && totalDuration != mediaTime)
+		_durationOverride = totalDuration + _parent->timeToSample[_parent->findTimeToSample(frameNum)].duration - mediaTime;
 
 	if (bufferFrames) {
 		// Track down the keyframe
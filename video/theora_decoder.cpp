@@ -261,6 +261,10 @@ TheoraDecoder::TheoraVideoTrack::TheoraVideoTrack(const Graphics::PixelFormat &f
 
 	_surface.create(theoraInfo.frame_width, theoraInfo.frame_height, format);
 
+	// Frames may get converted on the decode-ahead thread, which must only
+	// read the lookup table
+	YUVToRGBMan.initLookup(format, Graphics::YUVToRGBManager::kScaleITU);
+
 	// Set up a display surface
 	_displaySurface.init(theoraInfo.pic_width, theoraInfo.pic_height, _surface.pitch,
 	                    _surface.getBasePtr(theoraInfo.pic_x, theoraInfo.pic_y), format);
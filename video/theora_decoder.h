@@ -54,6 +54,11 @@ namespace Video {
 /**
  *
  * Decoder for Theora videos.
+ *
+ * Packet decoding, post-processing and the RGB conversion all happen in
+ * readNextPacket(), so they can be moved to a separate thread with
+ * VideoDecoder::setDecodeAhead().
+ *
  * Video decoder used in engines:
  *  - pegasus
  *  - sword25
@@ -25,14 +25,27 @@
 #include "audio/audiostream.h"
 #include "audio/mixer.h" // for kMaxChannelVolume
 
+#include "common/debug.h"
 #include "common/rational.h"
 #include "common/file.h"
 #include "common/system.h"
 
 #include "graphics/palette.h"
+#include "graphics/surface.h"
 
 namespace Video {
 
+/** A frame decoded ahead, with the state of the decoder after decoding it. */
+struct VideoDecoder::DecodedFrame {
+	Graphics::Surface surface;
+	bool hasSurface;
+	uint32 startTime;
+	int curFrame;
+	bool dirtyPalette;
+	byte palette[256 * 3];
+	uint32 decodeTime;
+};
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -50,6 +63,16 @@ VideoDecoder::VideoDecoder() {
 	_mainAudioTrack = 0;
 	_canSetDither = true;
 
+	_decodeAheadFrames = 0;
+	_decodedFrames = 0;
+	_decodedFrameSlots = 0;
+	_decodedHead = _decodedTail = _decodedCount = 0;
+	_shownFrameSlot = -1;
+	_shownFrame = -1;
+	_decodeAheadDone = _decodeAheadQuit = false;
+	_decodeAheadThread = 0;
+	_freeFrameSlots = _framesReady = 0;
+
 	// Find the best format for output
 	_defaultHighColorFormat = g_system->getScreenFormat();
 
@@ -57,7 +80,15 @@ VideoDecoder::VideoDecoder() {
 		_defaultHighColorFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0);
 }
 
+VideoDecoder::~VideoDecoder() {
+	stopDecodeAhead();
+	freeDecodedFrames();
+}
+
 void VideoDecoder::close() {
+	discardDecodedFrames();
+	freeDecodedFrames();
+
 	if (isPlaying())
 		stop();
 
@@ -188,12 +219,27 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_needsUpdate = false;
 	_canSetDither = false;
 
+	if (_shownFrameSlot >= 0) {
+		// The caller is done with the frame returned last time
+		_shownFrameSlot = -1;
+		if (_decodeAheadThread)
+			g_system->postSemaphore(_freeFrameSlots);
+	}
+
+	if (_decodeAheadFrames && !isDecodingAhead() && !_decodeAheadDone)
+		startDecodeAhead();
+
+	if (isDecodingAhead())
+		return takeDecodedFrame();
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
 	// any frame available for us to display.
-	if (!_nextVideoTrack)
+	if (!_nextVideoTrack) {
+		afterFrameDecoded();
 		return 0;
+	}
 
 	const Graphics::Surface *frame = _nextVideoTrack->decodeNextFrame();
 
@@ -204,6 +250,7 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 
 	// Look for the next video track here for the next decode.
 	findNextVideoTrack();
+	afterFrameDecoded();
 
 	return frame;
 }
@@ -213,6 +260,10 @@ bool VideoDecoder::setReverse(bool reverse) {
 	if (reverse && hasAudio())
 		return false;
 
+	// Frames are only decoded ahead forwards
+	if (reverse && (_decodeAheadFrames || isDecodingAhead()))
+		return false;
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
@@ -233,6 +284,13 @@ const byte *VideoDecoder::getPalette() {
 }
 
 int VideoDecoder::getCurFrame() const {
+	if (isDecodingAhead())
+		return _shownFrame;
+
+	return getTrackCurFrame();
+}
+
+int VideoDecoder::getTrackCurFrame() const {
 	int32 frame = -1;
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
@@ -274,13 +332,25 @@ uint32 VideoDecoder::getTime() const {
 }
 
 uint32 VideoDecoder::getTimeToNextFrame() const {
-	if (endOfVideo() || _needsUpdate || !_nextVideoTrack)
+	if (endOfVideo() || _needsUpdate)
 		return 0;
 
+	uint32 nextFrameStartTime;
+	bool isReversed = false;
+
+	const DecodedFrame *decodedFrame = peekDecodedFrame();
+	if (decodedFrame) {
+		nextFrameStartTime = decodedFrame->startTime;
+	} else if (_nextVideoTrack) {
+		nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+		isReversed = _nextVideoTrack->isReversed();
+	} else {
+		return 0;
+	}
+
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
 
-	if (_nextVideoTrack->isReversed()) {
+	if (isReversed) {
 		// For reversed videos, we need to handle the time difference the opposite way.
 		if (nextFrameStartTime >= currentTime)
 			return 0;
@@ -296,9 +366,17 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 }
 
 bool VideoDecoder::endOfVideo() const {
+	// The video tracks may be ahead of the frames returned so far
+	const DecodedFrame *decodedFrame = peekDecodedFrame();
+	if (decodedFrame && !(isPlaying() && _endTimeSet && decodedFrame->startTime >= (uint)_endTime.msecs()))
+		return false;
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		const Track *track = *it;
 
+		if (decodedFrame && track->getTrackType() == Track::kTrackTypeVideo)
+			continue;
+
 		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
 		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
@@ -323,6 +401,8 @@ bool VideoDecoder::rewind() {
 	if (!isRewindable())
 		return false;
 
+	discardDecodedFrames();
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
@@ -357,6 +437,8 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (!isSeekable())
 		return false;
 
+	discardDecodedFrames();
+
 	// Stop all tracks so they can be seeked
 	if (isPlaying())
 		stopAudio();
@@ -760,6 +842,8 @@ bool VideoDecoder::addStreamFileTrack(const Common::String &baseName) {
 	if (!isVideoLoaded())
 		return false;
 
+	stopDecodeAhead();
+
 	StreamFileAudioTrack *track = new StreamFileAudioTrack(getSoundType());
 
 	bool result = track->loadFromFile(baseName);
@@ -784,6 +868,8 @@ bool VideoDecoder::setAudioTrack(int index) {
 	if (_mainAudioTrack == audioTrack)
 		return true;
 
+	stopDecodeAhead();
+
 	_mainAudioTrack->setMute(true);
 	audioTrack->setMute(false);
 	_mainAudioTrack = audioTrack;
@@ -803,6 +889,10 @@ uint VideoDecoder::getAudioTrackCount() const {
 void VideoDecoder::setEndTime(const Audio::Timestamp &endTime) {
 	Audio::Timestamp startTime = 0;
 
+	// The decoding thread may have stopped at the previous end time
+	stopDecodeAhead();
+	_decodeAheadDone = false;
+
 	if (isPlaying()) {
 		startTime = getTime();
 		stopAudio();
@@ -918,6 +1008,10 @@ bool VideoDecoder::hasFramesLeft() const {
 	// This is similar to endOfVideo(), except it doesn't take Audio into account (and returns true if not the end of the video)
 	// This is only used for needsUpdate() atm so that setEndTime() works properly
 	// And unlike endOfVideoTracks(), this takes into account _endTime
+	const DecodedFrame *decodedFrame = peekDecodedFrame();
+	if (decodedFrame)
+		return !(isPlaying() && _endTimeSet && decodedFrame->startTime >= (uint)_endTime.msecs());
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() != Track::kTrackTypeVideo)
 			continue;
@@ -958,4 +1052,200 @@ void VideoDecoder::eraseTrack(Track *track) {
 	}
 }
 
+void VideoDecoder::setDecodeAhead(uint frames) {
+	// Frames decoded already are still returned, the ring is resized once
+	// they are gone
+	stopDecodeAhead();
+	_decodeAheadFrames = frames;
+}
+
+void VideoDecoder::decodeAheadProc(void *param) {
+	VideoDecoder *decoder = (VideoDecoder *)param;
+
+	while (true) {
+		g_system->waitSemaphore(decoder->_freeFrameSlots);
+		if (decoder->_decodeAheadQuit)
+			break;
+
+		const bool decoded = decoder->decodeFrameAhead(decoder->_decodedFrames[decoder->_decodedTail]);
+
+		{
+			Common::StackLock lock(decoder->_decodedFramesMutex);
+			if (decoded) {
+				decoder->_decodedTail = (decoder->_decodedTail + 1) % decoder->_decodedFrameSlots;
+				decoder->_decodedCount++;
+			} else {
+				decoder->_decodeAheadDone = true;
+			}
+		}
+
+		g_system->postSemaphore(decoder->_framesReady);
+		if (!decoded)
+			break;
+	}
+}
+
+bool VideoDecoder::decodeFrameAhead(DecodedFrame &frame) {
+	if (!_nextVideoTrack || endOfVideoTracks())
+		return false;
+
+	// This is what getTimeToNextFrame() would have looked at before the
+	// frame was decoded
+	frame.startTime = _nextVideoTrack->getNextFrameStartTime();
+	if (_endTimeSet && frame.startTime >= (uint)_endTime.msecs())
+		return false;
+
+	const uint32 decodeStart = g_system->getMillis();
+	readNextPacket();
+
+	if (!_nextVideoTrack) {
+		afterFrameDecoded();
+		return false;
+	}
+
+	const Graphics::Surface *surface = _nextVideoTrack->decodeNextFrame();
+
+	frame.hasSurface = surface != 0;
+	if (surface) {
+		if (frame.surface.w != surface->w || frame.surface.h != surface->h || frame.surface.format != surface->format) {
+			frame.surface.free();
+			frame.surface.create(surface->w, surface->h, surface->format);
+		}
+
+		for (int y = 0; y < surface->h; y++)
+			memcpy(frame.surface.getBasePtr(0, y), surface->getBasePtr(0, y), surface->w * surface->format.bytesPerPixel);
+	}
+	frame.decodeTime = g_system->getMillis() - decodeStart;
+
+	frame.dirtyPalette = _nextVideoTrack->hasDirtyPalette();
+	if (frame.dirtyPalette)
+		memcpy(frame.palette, _nextVideoTrack->getPalette(), sizeof(frame.palette));
+
+	findNextVideoTrack();
+	afterFrameDecoded();
+
+	frame.curFrame = getTrackCurFrame();
+	return true;
+}
+
+void VideoDecoder::startDecodeAhead() {
+	// Nothing was decoded ahead at this point, so the tracks are up to date
+	if (!_nextVideoTrack || _nextVideoTrack->isReversed())
+		return;
+
+	if (_decodedFrameSlots != _decodeAheadFrames + 1) {
+		freeDecodedFrames();
+		_decodedFrameSlots = _decodeAheadFrames + 1;
+		_decodedFrames = new DecodedFrame[_decodedFrameSlots];
+	}
+
+	_decodedHead = _decodedTail = 0;
+	_shownFrame = getTrackCurFrame();
+	_decodeAheadQuit = false;
+
+	// One slot stays with the caller until the next decodeNextFrame() call
+	_freeFrameSlots = g_system->createSemaphore(_decodedFrameSlots);
+	_framesReady = g_system->createSemaphore(0);
+	if (_freeFrameSlots && _framesReady)
+		_decodeAheadThread = g_system->createThread(decodeAheadProc, this);
+
+	if (!_decodeAheadThread) {
+		// No thread support, decode on demand
+		if (_freeFrameSlots)
+			g_system->deleteSemaphore(_freeFrameSlots);
+		if (_framesReady)
+			g_system->deleteSemaphore(_framesReady);
+		_freeFrameSlots = _framesReady = 0;
+		_decodeAheadFrames = 0;
+	}
+}
+
+void VideoDecoder::stopDecodeAhead() {
+	if (!_decodeAheadThread)
+		return;
+
+	_decodeAheadQuit = true;
+	g_system->postSemaphore(_freeFrameSlots);
+	g_system->joinThread(_decodeAheadThread);
+	g_system->deleteSemaphore(_freeFrameSlots);
+	g_system->deleteSemaphore(_framesReady);
+	_decodeAheadThread = 0;
+	_freeFrameSlots = _framesReady = 0;
+}
+
+void VideoDecoder::discardDecodedFrames() {
+	stopDecodeAhead();
+	_decodedHead = _decodedTail = _decodedCount = 0;
+	_shownFrameSlot = -1;
+	_decodeAheadDone = false;
+}
+
+void VideoDecoder::freeDecodedFrames() {
+	for (uint i = 0; i < _decodedFrameSlots; i++)
+		_decodedFrames[i].surface.free();
+
+	delete[] _decodedFrames;
+	_decodedFrames = 0;
+	_decodedFrameSlots = 0;
+}
+
+bool VideoDecoder::isDecodingAhead() const {
+	if (_decodeAheadThread)
+		return true;
+
+	Common::StackLock lock(_decodedFramesMutex);
+	return _decodedCount != 0;
+}
+
+const VideoDecoder::DecodedFrame *VideoDecoder::peekDecodedFrame() const {
+	if (!_decodeAheadThread)
+		return _decodedCount ? &_decodedFrames[_decodedHead] : 0;
+
+	// Wait for the thread to decode the next frame, or to reach the end
+	while (true) {
+		{
+			Common::StackLock lock(_decodedFramesMutex);
+			if (_decodedCount)
+				return &_decodedFrames[_decodedHead];
+			if (_decodeAheadDone)
+				return 0;
+		}
+
+		g_system->waitSemaphore(_framesReady);
+	}
+}
+
+const Graphics::Surface *VideoDecoder::takeDecodedFrame() {
+	const uint32 waitStart = g_system->getMillis();
+	const DecodedFrame *frame = peekDecodedFrame();
+
+	if (!frame) {
+		// Every decoded frame was returned, so the tracks are in sync again
+		stopDecodeAhead();
+		return 0;
+	}
+
+	uint queued;
+	{
+		Common::StackLock lock(_decodedFramesMutex);
+		_shownFrameSlot = _decodedHead;
+		_decodedHead = (_decodedHead + 1) % _decodedFrameSlots;
+		queued = --_decodedCount;
+	}
+
+	_shownFrame = frame->curFrame;
+
+	// A caller which had to wait means the thread fell behind
+	debugC(1, kDebugLevelVideoDecoder, "Frame %d: decoded in %u ms, waited %u ms, %u of %u frames queued",
+	       frame->curFrame, frame->decodeTime, g_system->getMillis() - waitStart, queued, _decodedFrameSlots - 1);
+
+	if (frame->dirtyPalette) {
+		memcpy(_decodedPalette, frame->palette, sizeof(_decodedPalette));
+		_palette = _decodedPalette;
+		_dirtyPalette = true;
+	}
+
+	return frame->hasSurface ? &frame->surface : 0;
+}
+
 } // End of namespace Video
@@ -26,6 +26,7 @@
 #include "audio/mixer.h"
 #include "audio/timestamp.h"	// TODO: Move this to common/ ?
 #include "common/array.h"
+#include "common/mutex.h"
 #include "common/rational.h"
 #include "common/str.h"
 #include "graphics/pixelformat.h"
@@ -52,7 +53,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -396,6 +397,26 @@ public:
 	 */
 	bool setDitheringPalette(const byte *palette);
 
+	/**
+	 * Decode frames ahead on a separate thread.
+	 *
+	 * With a non-zero count, a thread decodes up to that many frames ahead
+	 * of the one returned by decodeNextFrame(), so that an expensive frame
+	 * does not make the video miss the display time of the following ones.
+	 * getTimeToNextFrame(), endOfVideo() and getCurFrame() keep reporting
+	 * the state of the frames returned so far, so the audio/video sync,
+	 * seek() and rewind() work as before.
+	 *
+	 * Decoding ahead only works forwards: setReverse(true) fails while it is
+	 * enabled. When the backend has no thread support, frames are decoded on
+	 * demand.
+	 *
+	 * Unlike most settings, this one is kept across close().
+	 *
+	 * @param frames The number of frames to decode ahead, 0 to turn it off
+	 */
+	void setDecodeAhead(uint frames);
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -836,6 +857,18 @@ protected:
 	 */
 	virtual void readNextPacket() {}
 
+	/**
+	 * Called after each frame was decoded, once the next video track was found.
+	 * It is also called when readNextPacket() left no video track to decode
+	 * from, so audio can still be queued.
+	 *
+	 * When decoding ahead, this runs on the decoding thread, like readNextPacket()
+	 * and the functions of the video tracks. A subclass which needs to touch its
+	 * stream or tracks for each frame must do so here rather than in
+	 * decodeNextFrame().
+	 */
+	virtual void afterFrameDecoded() {}
+
 	/**
 	 * Define a track to be used by this class.
 	 *
@@ -974,6 +1007,33 @@ private:
 	Audio::Mixer::SoundType _soundType;
 
 	AudioTrack *_mainAudioTrack;
+
+	// Decoding ahead, the ring of decoded frames and its thread. The thread
+	// owns the tracks while it runs, the frame counters are guarded by the
+	// mutex.
+	struct DecodedFrame;
+	uint _decodeAheadFrames;
+	DecodedFrame *_decodedFrames;
+	uint _decodedFrameSlots;
+	uint _decodedHead, _decodedTail, _decodedCount;
+	int _shownFrameSlot;
+	int _shownFrame;
+	bool _decodeAheadDone, _decodeAheadQuit;
+	byte _decodedPalette[256 * 3];
+	OSystem::ThreadRef _decodeAheadThread;
+	OSystem::SemaphoreRef _freeFrameSlots, _framesReady;
+	mutable Common::Mutex _decodedFramesMutex;
+
+	static void decodeAheadProc(void *param);
+	bool decodeFrameAhead(DecodedFrame &frame);
+	void startDecodeAhead();
+	void stopDecodeAhead();
+	void discardDecodedFrames();
+	void freeDecodedFrames();
+	bool isDecodingAhead() const;
+	const DecodedFrame *peekDecodedFrame() const;
+	const Graphics::Surface *takeDecodedFrame();
+	int getTrackCurFrame() const;
 };
 
 } // End of namespace Video